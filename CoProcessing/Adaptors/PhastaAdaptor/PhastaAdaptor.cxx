@@ -26,8 +26,12 @@
 #include "vtkFieldData.h"
 #include "vtkPointData.h"
 #include "vtkPoints.h"
+#include "vtkSOADataArray.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <cstdlib>
+#include <cstring>
+
 extern "C" void createpointsandallocatecells(
   int* numPoints, double* coordsArray, int* numCells)
 {
@@ -39,15 +43,12 @@ extern "C" void createpointsandallocatecells(
 
   vtkUnstructuredGrid* Grid = vtkUnstructuredGrid::New();
   vtkPoints* nodePoints = vtkPoints::New();
-  vtkDoubleArray* coords = vtkDoubleArray::New();
+  // The coordinates are used in place: the grid is kept for the following
+  // time steps (see vtkCPAdaptorAPI::NeedToCreateGrid()) and Phasta's
+  // coordinates array lives as long as the simulation.
+  vtkSOADataArray* coords = vtkSOADataArray::New();
   coords->SetNumberOfComponents(3);
-  coords->SetNumberOfTuples(*numPoints);
-  for(int i=0;i<*numPoints;i++) 
-    {
-    double tuple[3] = {coordsArray[i], coordsArray[i+*numPoints], 
-                       coordsArray[i+*numPoints*2]};
-    coords->SetTupleValue(i, tuple);
-    }
+  coords->SetComponentArrays(coordsArray, *numPoints, *numPoints);
   nodePoints->SetData(coords);
   coords->Delete();
   Grid->SetPoints(nodePoints);
@@ -132,20 +133,16 @@ extern "C" void addfields(
     return;
     }
   vtkIdType NumberOfNodes = UnstructuredGrid->GetNumberOfPoints();
-  // now add numerical field data
+  // now add numerical field data. The arrays use dofArray in place, which
+  // Phasta overwrites at the next time step: releasefields() removes them
+  // after coprocessing.
   //velocity
   if(idd->IsFieldNeeded("velocity"))
     {
-    vtkDoubleArray* velocity = vtkDoubleArray::New();
+    vtkSOADataArray* velocity = vtkSOADataArray::New();
     velocity->SetName("velocity");
     velocity->SetNumberOfComponents(3);
-    velocity->SetNumberOfTuples(NumberOfNodes);
-    for (vtkIdType idx=0; idx<NumberOfNodes; idx++)
-      {
-      velocity->SetTuple3(idx, dofArray[idx],
-                          dofArray[idx+ *nshg],
-                          dofArray[idx+ *nshg*2]);
-      }
+    velocity->SetComponentArrays(dofArray, NumberOfNodes, *nshg);
     UnstructuredGrid->GetPointData()->AddArray(velocity);
     velocity->Delete();
     }
@@ -171,3 +168,47 @@ extern "C" void addfields(
     temperature->Delete();
     }
 }
+
+extern "C" void releasefields()
+{
+  vtkCPInputDataDescription* idd =
+    vtkCPAdaptorAPI::GetCoProcessorData()->GetInputDescriptionByName("input");
+  vtkUnstructuredGrid* UnstructuredGrid =
+    vtkUnstructuredGrid::SafeDownCast(idd->GetGrid());
+  if(!UnstructuredGrid)
+    {
+    return;
+    }
+  vtkPointData* pointData = UnstructuredGrid->GetPointData();
+  const char* names[3] = { "velocity", "pressure", "temperature" };
+  for(int i=0;i<3;i++)
+    {
+    vtkDataArray* array = pointData->GetArray(names[i]);
+    if(!array)
+      {
+      continue;
+      }
+    array->Register(NULL);
+    pointData->RemoveArray(names[i]);
+    // Still referenced, e.g. by a filter output or a cache kept for the
+    // next time steps: copy the values out of dofArray.
+    if(array->GetReferenceCount() > 1)
+      {
+      if(vtkSOADataArray* soa = vtkSOADataArray::SafeDownCast(array))
+        {
+        // GetVoidPointer() copies the values to the array's own storage.
+        soa->GetVoidPointer(0);
+        }
+      else if(vtkDoubleArray* doubleArray = vtkDoubleArray::SafeDownCast(array))
+        {
+        vtkIdType size = doubleArray->GetNumberOfTuples() *
+          doubleArray->GetNumberOfComponents();
+        double* values =
+          static_cast<double*>(malloc(size * sizeof(double)));
+        memcpy(values, doubleArray->GetPointer(0), size * sizeof(double));
+        doubleArray->SetArray(values, size, 0);
+        }
+      }
+    array->UnRegister(NULL);
+    }
+}
@@ -67,5 +67,8 @@ c  Inside addfields we check to see if we really need the field or not
 
       call coprocess()
 
+c  The fields use Y in place: do not keep them past this time step
+      call releasefields()
+
       return
       end
@@ -0,0 +1,163 @@
+// Tests that vtkCPExtractWriter writes the data of all the ranks to the
+// files of their aggregators, in the background or not, and that the
+// quantized arrays read back are within their error bounds.
+#include <vtkArrayQuantizer.h>
+#include <vtkCPExtractWriter.h>
+#include <vtkCPProcessor.h>
+#include <vtkDataArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkImageData.h>
+#include <vtkMultiBlockDataSet.h>
+#include <vtkMultiProcessController.h>
+#include <vtkPointData.h>
+#include <vtkSmartPointer.h>
+#include <vtkXMLMultiBlockDataReader.h>
+
+#include <vtksys/SystemTools.hxx>
+
+#include <cmath>
+#include <sstream>
+#include <string>
+
+namespace
+{
+  // Returns the image of rank, with a Pressure and a Temperature array.
+  vtkSmartPointer<vtkImageData> NewImage(int rank)
+  {
+    vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+    image->SetExtent(0, 9, 0, 9, 10*rank, 10*rank + 9);
+    vtkSmartPointer<vtkDoubleArray> pressure =
+      vtkSmartPointer<vtkDoubleArray>::New();
+    pressure->SetName("Pressure");
+    pressure->SetNumberOfTuples(image->GetNumberOfPoints());
+    vtkSmartPointer<vtkDoubleArray> temperature =
+      vtkSmartPointer<vtkDoubleArray>::New();
+    temperature->SetName("Temperature");
+    temperature->SetNumberOfTuples(image->GetNumberOfPoints());
+    for(vtkIdType i=0;i<image->GetNumberOfPoints();i++)
+      {
+      double point[3];
+      image->GetPoint(i, point);
+      pressure->SetValue(i, 100*rank + sin(point[0]) * point[2]);
+      temperature->SetValue(i, 300 + point[1]);
+      }
+    image->GetPointData()->AddArray(pressure);
+    image->GetPointData()->AddArray(temperature);
+    return image;
+  }
+
+  // Reads the first block of the given file, i.e. the data of the
+  // aggregator, and checks it against image.
+  bool CheckFile(const std::string& fileName, vtkImageData* image)
+  {
+    vtkSmartPointer<vtkXMLMultiBlockDataReader> reader =
+      vtkSmartPointer<vtkXMLMultiBlockDataReader>::New();
+    reader->SetFileName(fileName.c_str());
+    vtkSmartPointer<vtkArrayQuantizer> decoder =
+      vtkSmartPointer<vtkArrayQuantizer>::New();
+    decoder->SetInputConnection(reader->GetOutputPort());
+    decoder->DecodeOn();
+    decoder->Update();
+    vtkMultiBlockDataSet* blocks =
+      vtkMultiBlockDataSet::SafeDownCast(decoder->GetOutputDataObject(0));
+    vtkDataSet* block = blocks && blocks->GetNumberOfBlocks() > 0 ?
+      vtkDataSet::SafeDownCast(blocks->GetBlock(0)) : NULL;
+    if(!block || block->GetNumberOfPoints() != image->GetNumberOfPoints())
+      {
+      vtkGenericWarningMacro("Failed to read " << fileName.c_str());
+      return false;
+      }
+
+    const int points = vtkDataObject::FIELD_ASSOCIATION_POINTS;
+    double bound = vtkArrayQuantizer::GetErrorBound(block, points, "Pressure");
+    vtkDataArray* pressure = block->GetPointData()->GetArray("Pressure");
+    vtkDataArray* temperature = block->GetPointData()->GetArray("Temperature");
+    if(bound <= 0 || !pressure || !temperature ||
+       vtkArrayQuantizer::GetErrorBound(block, points, "Temperature") != -1)
+      {
+      vtkGenericWarningMacro("Wrong arrays in " << fileName.c_str());
+      return false;
+      }
+    for(vtkIdType i=0;i<image->GetNumberOfPoints();i++)
+      {
+      if(fabs(pressure->GetTuple1(i) -
+              image->GetPointData()->GetArray("Pressure")->GetTuple1(i)) >
+         bound * (1 + 1e-9) ||
+         temperature->GetTuple1(i) !=
+         image->GetPointData()->GetArray("Temperature")->GetTuple1(i))
+        {
+        vtkGenericWarningMacro("Wrong values in " << fileName.c_str());
+        return false;
+        }
+      }
+    return true;
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  vtkSmartPointer<vtkCPProcessor> processor =
+    vtkSmartPointer<vtkCPProcessor>::New();
+  processor->Initialize();
+  vtkMultiProcessController* controller =
+    vtkMultiProcessController::GetGlobalController();
+  int rank = controller ? controller->GetLocalProcessId() : 0;
+  int numberOfRanks = controller ? controller->GetNumberOfProcesses() : 1;
+
+  std::string directory = argc > 1 ? argv[1] : ".";
+  std::string fileName =
+    directory + "/CoProcessingTestExtractWriter_%t.vtm";
+  vtkSmartPointer<vtkImageData> image = NewImage(rank);
+
+  vtkSmartPointer<vtkCPExtractWriter> writer =
+    vtkSmartPointer<vtkCPExtractWriter>::New();
+  writer->SetFileName(fileName.c_str());
+  writer->SetArrayNumberOfBits("Pressure", 10);
+
+  int retVal = 0;
+  // the first time step is written in the background by one aggregator
+  // per host, the second one synchronously by every rank.
+  for(vtkIdType timeStep=0;timeStep<2;timeStep++)
+    {
+    if(timeStep == 1)
+      {
+      writer->AsynchronousOff();
+      writer->SetNumberOfRanksPerAggregator(1);
+      }
+    if(writer->Write(image, timeStep) == 0 || writer->WaitForWrite() == 0)
+      {
+      vtkGenericWarningMacro("Failed to write time step " << timeStep);
+      retVal = 1;
+      continue;
+      }
+    if(timeStep == 1 && (writer->GetNumberOfAggregators() != numberOfRanks ||
+                         writer->GetAggregatorIndex() != rank))
+      {
+      vtkGenericWarningMacro("Wrong aggregators.");
+      retVal = 1;
+      }
+
+    std::ostringstream baseName;
+    baseName << directory << "/CoProcessingTestExtractWriter_" << timeStep;
+    if(rank == 0 &&
+       !vtksys::SystemTools::FileExists((baseName.str() + ".pvd").c_str()))
+      {
+      vtkGenericWarningMacro("The collection file was not written.");
+      retVal = 1;
+      }
+    // the first block of the file of an aggregator is its own data.
+    std::ostringstream aggregatorFileName;
+    aggregatorFileName << baseName.str() << "_"
+                       << writer->GetAggregatorIndex() << ".vtm";
+    if((rank == 0 || timeStep == 1) &&
+       !CheckFile(aggregatorFileName.str(), image))
+      {
+      retVal = 1;
+      }
+    }
+
+  writer = NULL;
+  processor->Finalize();
+
+  return retVal;
+}
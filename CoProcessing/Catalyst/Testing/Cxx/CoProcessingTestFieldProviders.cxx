@@ -0,0 +1,202 @@
+// Tests that the fields registered with a provider are only converted when
+// a pipeline accesses them and that their conversion statistics are
+// reported after CoProcess().
+#include <vtkCellData.h>
+#include <vtkCPDataDescription.h>
+#include <vtkCPInputDataDescription.h>
+#include <vtkCPPipeline.h>
+#include <vtkCPProcessor.h>
+#include <vtkDataArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkImageData.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkSmartPointer.h>
+
+#include <string>
+
+namespace
+{
+  // Fills array with the index of each tuple times the number of calls.
+  void ProvideField(vtkDataSet*, const char*, vtkDoubleArray* array,
+                    void* clientData)
+  {
+    int* numberOfCalls = static_cast<int*>(clientData);
+    (*numberOfCalls)++;
+    for(vtkIdType i=0;i<array->GetNumberOfTuples();i++)
+      {
+      for(int j=0;j<array->GetNumberOfComponents();j++)
+        {
+        array->SetComponent(i, j, i * (*numberOfCalls));
+        }
+      }
+  }
+
+  class vtkCPTestPipeline : public vtkCPPipeline
+  {
+  public:
+    vtkTypeMacro(vtkCPTestPipeline,vtkCPPipeline);
+    static vtkCPTestPipeline* New();
+
+    virtual int RequestDataDescription(vtkCPDataDescription* dataDescription)
+    {
+      vtkCPInputDataDescription* inputDescription =
+        dataDescription->GetInputDescriptionByName("input");
+      inputDescription->AddPointField("velocity");
+      inputDescription->AddPointField("pressure");
+      inputDescription->AddCellField("density");
+      return 1;
+    }
+
+    // Only accesses the values of the velocity.
+    virtual int CoProcess(vtkCPDataDescription* dataDescription)
+    {
+      vtkDataSet* grid = vtkDataSet::SafeDownCast(
+        dataDescription->GetInputDescriptionByName("input")->GetGrid());
+      vtkDataArray* velocity = grid->GetPointData()->GetArray("velocity");
+      vtkDataArray* pressure = grid->GetPointData()->GetArray("pressure");
+      vtkDataArray* density = grid->GetCellData()->GetArray("density");
+      if(!velocity || !pressure || !density ||
+         velocity->GetNumberOfComponents() != 3 ||
+         velocity->GetNumberOfTuples() != grid->GetNumberOfPoints() ||
+         density->GetNumberOfTuples() != grid->GetNumberOfCells())
+        {
+        vtkErrorMacro("Provided fields are missing or have a bad size.");
+        return 0;
+        }
+      double range[2];
+      velocity->GetRange(range, 1);
+      this->VelocityMaximum = range[1];
+      // Keep the arrays, as the output of a filter would.
+      this->KeptVelocity = velocity;
+      this->KeptDensity = density;
+      return 1;
+    }
+
+    double VelocityMaximum;
+    vtkSmartPointer<vtkDataArray> KeptVelocity;
+    vtkSmartPointer<vtkDataArray> KeptDensity;
+
+  protected:
+    vtkCPTestPipeline() { this->VelocityMaximum = 0; }
+    virtual ~vtkCPTestPipeline() {}
+
+  private:
+    vtkCPTestPipeline(const vtkCPTestPipeline&); // Not implemented
+    void operator=(const vtkCPTestPipeline&); // Not implemented
+  };
+
+  vtkStandardNewMacro(vtkCPTestPipeline);
+}
+
+int main()
+{
+  vtkSmartPointer<vtkCPProcessor> processor =
+    vtkSmartPointer<vtkCPProcessor>::New();
+  processor->Initialize();
+
+  vtkSmartPointer<vtkCPTestPipeline> pipeline =
+    vtkSmartPointer<vtkCPTestPipeline>::New();
+  processor->AddPipeline(pipeline);
+
+  vtkSmartPointer<vtkImageData> grid = vtkSmartPointer<vtkImageData>::New();
+  grid->SetDimensions(10, 10, 10);
+
+  // The pressure is given by the adaptor and must not be replaced.
+  vtkSmartPointer<vtkDoubleArray> pressure =
+    vtkSmartPointer<vtkDoubleArray>::New();
+  pressure->SetName("pressure");
+  pressure->SetNumberOfTuples(grid->GetNumberOfPoints());
+  pressure->FillComponent(0, 1.);
+  grid->GetPointData()->AddArray(pressure);
+
+  int velocityCalls = 0;
+  int pressureCalls = 0;
+  int densityCalls = 0;
+  int retVal = 0;
+  for(vtkIdType timeStep=0;timeStep<3;timeStep++)
+    {
+    vtkSmartPointer<vtkCPDataDescription> dataDescription =
+      vtkSmartPointer<vtkCPDataDescription>::New();
+    dataDescription->AddInput("input");
+    dataDescription->SetTimeData(timeStep * 0.1, timeStep);
+    vtkCPInputDataDescription* inputDescription =
+      dataDescription->GetInputDescriptionByName("input");
+    inputDescription->AddPointFieldProvider(
+      "velocity", 3, ProvideField, &velocityCalls);
+    inputDescription->AddPointFieldProvider(
+      "pressure", 1, ProvideField, &pressureCalls);
+    inputDescription->AddCellFieldProvider(
+      "density", 1, ProvideField, &densityCalls);
+    if(processor->RequestDataDescription(dataDescription) == 0)
+      {
+      vtkGenericWarningMacro("No coprocessing requested.");
+      return 1;
+      }
+    inputDescription->SetGrid(grid);
+    if(processor->CoProcess(dataDescription) == 0)
+      {
+      vtkGenericWarningMacro("Co-processing problem.");
+      return 1;
+      }
+
+    // The velocity is converted once per time step and the density is
+    // never converted.
+    double expectedMaximum =
+      (grid->GetNumberOfPoints() - 1) * (timeStep + 1);
+    if(velocityCalls != timeStep + 1 || pressureCalls != 0 ||
+       densityCalls != 0 || pipeline->VelocityMaximum != expectedMaximum)
+      {
+      vtkGenericWarningMacro("Bad number of conversions at time step "
+                             << timeStep);
+      retVal = 1;
+      }
+
+    // The provided fields were removed from the grid.
+    if(grid->GetPointData()->GetArray("velocity") ||
+       grid->GetCellData()->GetArray("density") ||
+       grid->GetPointData()->GetArray("pressure") != pressure.GetPointer())
+      {
+      vtkGenericWarningMacro("Provided fields were not removed.");
+      retVal = 1;
+      }
+
+    // The arrays kept by the pipeline keep the converted values, and the
+    // others are empty: the providers are not called anymore, even when
+    // the values are accessed.
+    pipeline->KeptDensity->GetVoidPointer(0);
+    if(pipeline->KeptVelocity->GetNumberOfTuples() !=
+       grid->GetNumberOfPoints() ||
+       pipeline->KeptVelocity->GetComponent(1, 0) != timeStep + 1 ||
+       pipeline->KeptDensity->GetNumberOfTuples() != 0 ||
+       densityCalls != 0 || velocityCalls != timeStep + 1)
+      {
+      vtkGenericWarningMacro("Removed fields still use their providers.");
+      retVal = 1;
+      }
+
+    if(inputDescription->GetNumberOfProvidedFields() != 2)
+      {
+      vtkGenericWarningMacro("Wrong number of provided fields.");
+      retVal = 1;
+      continue;
+      }
+    for(unsigned int i=0;i<2;i++)
+      {
+      std::string name = inputDescription->GetProvidedFieldName(i);
+      vtkIdType expectedSize = name == "velocity" ?
+        static_cast<vtkIdType>(3*sizeof(double)*grid->GetNumberOfPoints()) : 0;
+      if((name != "velocity" && name != "density") ||
+         inputDescription->GetProvidedFieldConversionSize(i) != expectedSize ||
+         inputDescription->GetProvidedFieldConversionTime(i) < 0)
+        {
+        vtkGenericWarningMacro("Wrong statistics for " << name);
+        retVal = 1;
+        }
+      }
+    }
+
+  processor->Finalize();
+
+  return retVal;
+}
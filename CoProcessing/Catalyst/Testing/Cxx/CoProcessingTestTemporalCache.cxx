@@ -0,0 +1,263 @@
+// Tests that the temporal cache of vtkCPProcessor keeps the last time steps
+// of the selected fields, even when no pipeline needs them, so that a
+// triggered pipeline can access the time steps before the trigger. Also
+// checks that the cached field is requested when the output is forced, that
+// the time steps share the points and cells that were not modified, and
+// that a rank without a grid caches an empty time step.
+#include <vtkCellArray.h>
+#include <vtkCPDataDescription.h>
+#include <vtkCPInputDataDescription.h>
+#include <vtkCPPipeline.h>
+#include <vtkCPProcessor.h>
+#include <vtkCPTemporalCache.h>
+#include <vtkDataArray.h>
+#include <vtkDataSet.h>
+#include <vtkDoubleArray.h>
+#include <vtkImageData.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+
+namespace
+{
+  const vtkIdType TriggerTimeStep = 6;
+
+  // Checks the cache when the trigger time step is reached.
+  class vtkCPTestPipeline : public vtkCPPipeline
+  {
+  public:
+    vtkTypeMacro(vtkCPTestPipeline,vtkCPPipeline);
+    static vtkCPTestPipeline* New();
+
+    virtual int RequestDataDescription(vtkCPDataDescription* dataDescription)
+    {
+      return dataDescription->GetTimeStep() == TriggerTimeStep ? 1 : 0;
+    }
+
+    virtual int CoProcess(vtkCPDataDescription* dataDescription)
+    {
+      this->Triggered = true;
+      vtkCPTemporalCache* cache = dataDescription->GetTemporalCache();
+      if(!cache || cache->GetNumberOfCachedTimeSteps() != 3)
+        {
+        vtkErrorMacro("The cache does not have the last 3 time steps.");
+        return 0;
+        }
+      for(int i=0;i<3;i++)
+        {
+        vtkIdType timeStep = TriggerTimeStep - 2 + i;
+        vtkDataSet* grid = vtkDataSet::SafeDownCast(cache->GetCachedGrid(i));
+        if(cache->GetCachedTimeStep(i) != timeStep ||
+           cache->GetCachedTime(i) != timeStep * 0.1 || !grid ||
+           grid->GetNumberOfPoints() != 1000)
+          {
+          vtkErrorMacro("Wrong time step " << i << " in the cache.");
+          return 0;
+          }
+        vtkDataArray* pressure = grid->GetPointData()->GetArray("pressure");
+        if(!pressure || grid->GetPointData()->GetArray("velocity"))
+          {
+          vtkErrorMacro("Wrong fields in the cache.");
+          return 0;
+          }
+        for(vtkIdType j=0;j<grid->GetNumberOfPoints();j++)
+          {
+          if(pressure->GetTuple1(j) != j * timeStep)
+            {
+            vtkErrorMacro("Wrong pressure for time step " << timeStep);
+            return 0;
+            }
+          }
+        }
+      return 1;
+    }
+
+    bool Triggered;
+
+  protected:
+    vtkCPTestPipeline() { this->Triggered = false; }
+    virtual ~vtkCPTestPipeline() {}
+
+  private:
+    vtkCPTestPipeline(const vtkCPTestPipeline&); // Not implemented
+    void operator=(const vtkCPTestPipeline&); // Not implemented
+  };
+
+  vtkStandardNewMacro(vtkCPTestPipeline);
+}
+
+int main()
+{
+  vtkSmartPointer<vtkCPProcessor> processor =
+    vtkSmartPointer<vtkCPProcessor>::New();
+  processor->Initialize();
+
+  vtkSmartPointer<vtkCPTestPipeline> pipeline =
+    vtkSmartPointer<vtkCPTestPipeline>::New();
+  processor->AddPipeline(pipeline);
+
+  vtkSmartPointer<vtkCPTemporalCache> cache =
+    vtkSmartPointer<vtkCPTemporalCache>::New();
+  cache->SetNumberOfTimeSteps(3);
+  cache->AddPointField("pressure");
+  cache->CompressOn();
+  processor->SetTemporalCache(cache);
+
+  vtkSmartPointer<vtkImageData> grid = vtkSmartPointer<vtkImageData>::New();
+  grid->SetDimensions(10, 10, 10);
+  vtkSmartPointer<vtkDoubleArray> pressure =
+    vtkSmartPointer<vtkDoubleArray>::New();
+  pressure->SetName("pressure");
+  pressure->SetNumberOfTuples(grid->GetNumberOfPoints());
+  grid->GetPointData()->AddArray(pressure);
+  vtkSmartPointer<vtkDoubleArray> velocity =
+    vtkSmartPointer<vtkDoubleArray>::New();
+  velocity->SetName("velocity");
+  velocity->SetNumberOfComponents(3);
+  velocity->SetNumberOfTuples(grid->GetNumberOfPoints());
+  velocity->FillComponent(0, 1.);
+  velocity->FillComponent(1, 2.);
+  velocity->FillComponent(2, 3.);
+  grid->GetPointData()->AddArray(velocity);
+
+  int retVal = 0;
+  vtkSmartPointer<vtkCPDataDescription> dataDescription =
+    vtkSmartPointer<vtkCPDataDescription>::New();
+  dataDescription->AddInput("input");
+  for(vtkIdType timeStep=0;timeStep<=TriggerTimeStep;timeStep++)
+    {
+    dataDescription->SetTimeData(timeStep * 0.1, timeStep);
+    vtkCPInputDataDescription* inputDescription =
+      dataDescription->GetInputDescriptionByName("input");
+    // the cached field is needed at every time step.
+    if(processor->RequestDataDescription(dataDescription) == 0 ||
+       !inputDescription->IsFieldNeeded("pressure") ||
+       inputDescription->IsFieldNeeded("velocity"))
+      {
+      vtkGenericWarningMacro("The cached field was not requested at time step "
+                             << timeStep);
+      return 1;
+      }
+    // the simulation overwrites its arrays at every time step.
+    for(vtkIdType i=0;i<grid->GetNumberOfPoints();i++)
+      {
+      pressure->SetValue(i, i * timeStep);
+      }
+    inputDescription->SetGrid(grid);
+    if(processor->CoProcess(dataDescription) == 0)
+      {
+      vtkGenericWarningMacro("Co-processing problem.");
+      retVal = 1;
+      }
+    }
+  if(!pipeline->Triggered)
+    {
+    vtkGenericWarningMacro("The triggered pipeline did not run.");
+    retVal = 1;
+    }
+
+  // with a memory limit smaller than a time step, only the last one is
+  // kept.
+  cache->SetMemoryLimit(1);
+  dataDescription->SetTimeData((TriggerTimeStep + 1) * 0.1, TriggerTimeStep + 1);
+  processor->RequestDataDescription(dataDescription);
+  dataDescription->GetInputDescriptionByName("input")->SetGrid(grid);
+  processor->CoProcess(dataDescription);
+  if(cache->GetNumberOfCachedTimeSteps() != 1 ||
+     cache->GetCachedTimeStep(0) != TriggerTimeStep + 1)
+    {
+    vtkGenericWarningMacro("The memory limit was not applied.");
+    retVal = 1;
+    }
+
+  // the cached field is also requested when the output is forced.
+  cache->SetMemoryLimit(0);
+  processor->RemoveAllPipelines();
+  vtkCPInputDataDescription* inputDescription =
+    dataDescription->GetInputDescriptionByName("input");
+  vtkIdType timeStep = TriggerTimeStep + 2;
+  dataDescription->SetTimeData(timeStep * 0.1, timeStep);
+  dataDescription->ForceOutputOn();
+  if(processor->RequestDataDescription(dataDescription) == 0 ||
+     !inputDescription->IsFieldNeeded("pressure"))
+    {
+    vtkGenericWarningMacro("The cached field was not requested when the "
+                           "output was forced.");
+    retVal = 1;
+    }
+  inputDescription->SetGrid(grid);
+  processor->CoProcess(dataDescription);
+
+  // the points and cells are copied again only when they are modified.
+  cache->Clear();
+  cache->CompressOff();
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  points->InsertNextPoint(0, 0, 0);
+  points->InsertNextPoint(1, 0, 0);
+  points->InsertNextPoint(0, 1, 0);
+  vtkSmartPointer<vtkCellArray> polys = vtkSmartPointer<vtkCellArray>::New();
+  vtkIdType triangle[3] = { 0, 1, 2 };
+  polys->InsertNextCell(3, triangle);
+  vtkSmartPointer<vtkPolyData> polyData = vtkSmartPointer<vtkPolyData>::New();
+  polyData->SetPoints(points);
+  polyData->SetPolys(polys);
+  vtkSmartPointer<vtkDoubleArray> polyPressure =
+    vtkSmartPointer<vtkDoubleArray>::New();
+  polyPressure->SetName("pressure");
+  polyPressure->SetNumberOfTuples(3);
+  polyData->GetPointData()->AddArray(polyPressure);
+  for(int i=0;i<3;i++)
+    {
+    timeStep++;
+    if(i == 2)
+      {
+      points->SetPoint(0, 1, 1, 1);
+      points->Modified();
+      }
+    polyPressure->FillComponent(0, i);
+    dataDescription->SetTimeData(timeStep * 0.1, timeStep);
+    processor->RequestDataDescription(dataDescription);
+    inputDescription->SetGrid(polyData);
+    processor->CoProcess(dataDescription);
+    }
+  vtkPolyData* cached[3];
+  for(int i=0;i<3;i++)
+    {
+    cached[i] = vtkPolyData::SafeDownCast(cache->GetCachedGrid(i));
+    if(!cached[i] || cached[i]->GetNumberOfCells() != 1 ||
+       cached[i]->GetPointData()->GetArray("pressure")->GetTuple1(0) != i)
+      {
+      vtkGenericWarningMacro("Wrong polydata time step " << i
+                             << " in the cache.");
+      return 1;
+      }
+    }
+  if(cached[0]->GetPoints() == points ||
+     cached[0]->GetPoints() != cached[1]->GetPoints() ||
+     cached[0]->GetPolys() != cached[1]->GetPolys() ||
+     cached[2]->GetPoints() == cached[1]->GetPoints() ||
+     cached[1]->GetPoint(0)[0] != 0 || cached[2]->GetPoint(0)[0] != 1)
+    {
+    vtkGenericWarningMacro("The unmodified points and cells are not shared.");
+    retVal = 1;
+    }
+
+  // a rank without a grid caches an empty time step.
+  timeStep++;
+  dataDescription->SetTimeData(timeStep * 0.1, timeStep);
+  processor->RequestDataDescription(dataDescription);
+  inputDescription->SetGrid(NULL);
+  if(processor->CoProcess(dataDescription) == 0 ||
+     cache->GetNumberOfCachedTimeSteps() != 3 ||
+     cache->GetCachedTimeStep(2) != timeStep || cache->GetCachedGrid(2))
+    {
+    vtkGenericWarningMacro("No empty time step was cached without a grid.");
+    retVal = 1;
+    }
+
+  processor->Finalize();
+
+  return retVal;
+}
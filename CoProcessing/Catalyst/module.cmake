@@ -1,6 +1,8 @@
 vtk_module(vtkPVCatalyst
   DEPENDS
+    vtkIOXML
     vtkPVServerManagerApplication
+    vtkPVVTKExtensionsDefault
 
   TEST_DEPENDS
     vtkPVCatalystTestDriver
@@ -18,6 +18,7 @@
 #include "vtkCompositeDataIterator.h"
 #include "vtkCompositeDataSet.h"
 #include "vtkCPInputDataDescription.h"
+#include "vtkCPTemporalCache.h"
 #include "vtkDataObject.h"
 #include "vtkDataSet.h"
 #include "vtkFieldData.h"
@@ -38,6 +39,7 @@ public:
 };
 
 vtkCxxSetObjectMacro(vtkCPDataDescription, UserData, vtkFieldData);
+vtkCxxSetObjectMacro(vtkCPDataDescription, TemporalCache, vtkCPTemporalCache);
 vtkStandardNewMacro(vtkCPDataDescription);
 //----------------------------------------------------------------------------
 vtkCPDataDescription::vtkCPDataDescription()
@@ -47,6 +49,7 @@ vtkCPDataDescription::vtkCPDataDescription()
   this->IsTimeDataSet = false;
   this->ForceOutput = false;
   this->UserData = NULL;
+  this->TemporalCache = NULL;
 
   this->Internals = new vtkInternals();
 }
@@ -55,6 +58,7 @@ vtkCPDataDescription::vtkCPDataDescription()
 vtkCPDataDescription::~vtkCPDataDescription()
 {
   this->SetUserData(NULL);
+  this->SetTemporalCache(NULL);
   delete this->Internals;
   this->Internals = 0;
 }
@@ -206,4 +210,12 @@ void vtkCPDataDescription::PrintSelf(ostream& os, vtkIndent indent)
     {
     os << indent << "UserData: (NULL)\n";
     }
+  if(this->TemporalCache)
+    {
+    os << indent << "TemporalCache: " << this->TemporalCache << "\n";
+    }
+  else
+    {
+    os << indent << "TemporalCache: (NULL)\n";
+    }
 }
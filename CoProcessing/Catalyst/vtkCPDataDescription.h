@@ -20,6 +20,7 @@
 
 class vtkFieldData;
 class vtkCPInputDataDescription;
+class vtkCPTemporalCache;
 
 /// @ingroup CoProcessing
 /// This class provides the description of the data for the coprocessor
@@ -96,6 +97,11 @@ public:
   /// adaptor to the coprocessing pipelines.
   vtkGetObjectMacro(UserData, vtkFieldData);
 
+  /// The cache of the previous time steps of vtkCPProcessor, if any. It is
+  /// set by vtkCPProcessor before calling the pipelines.
+  void SetTemporalCache(vtkCPTemporalCache* cache);
+  vtkGetObjectMacro(TemporalCache, vtkCPTemporalCache);
+
 //BTX
 protected:
   vtkCPDataDescription();
@@ -125,6 +131,9 @@ private:
   /// it can store a wide variety of data types which are all python wrapped.
   vtkFieldData* UserData;
 
+  /// The cache of the previous time steps set by vtkCPProcessor.
+  vtkCPTemporalCache* TemporalCache;
+
   class vtkInternals;
   vtkInternals* Internals;
 //ETX
@@ -0,0 +1,397 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkCPExtractWriter.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkCPExtractWriter.h"
+
+#include "vtkArrayQuantizer.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkMultiProcessController.h"
+#include "vtkMultiThreader.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkXMLMultiBlockDataWriter.h"
+#include "vtkZLibDataCompressor.h"
+
+#include <vtksys/ios/sstream>
+#include <vtksys/SystemInformation.hxx>
+#include <vtksys/SystemTools.hxx>
+
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+  const int VTK_CP_EXTRACT_WRITER_TAG = 9120;
+  const int VTK_CP_HOST_NAME_LENGTH = 256;
+}
+
+class vtkCPExtractWriter::vtkInternals
+{
+public:
+  vtkInternals() : ComputedController(NULL), ComputedRanksPerAggregator(-1),
+    Aggregator(0), ThreadId(-1), WriteSucceeded(true)
+    {
+    }
+
+  // The settings the aggregators were computed for.
+  vtkMultiProcessController* ComputedController;
+  int ComputedRanksPerAggregator;
+
+  // The rank this rank sends its data to, and the ranks that send their
+  // data to this one when it is an aggregator.
+  int Aggregator;
+  std::vector<int> Members;
+
+  // The write in progress.
+  vtkSmartPointer<vtkXMLMultiBlockDataWriter> Writer;
+  int ThreadId;
+  bool WriteSucceeded;
+
+  static VTK_THREAD_RETURN_TYPE WriteThread(void* calldata)
+    {
+    vtkMultiThreader::ThreadInfo* info =
+      reinterpret_cast<vtkMultiThreader::ThreadInfo*>(calldata);
+    static_cast<vtkCPExtractWriter*>(info->UserData)->WritePieces();
+    return VTK_THREAD_RETURN_VALUE;
+    }
+};
+
+vtkStandardNewMacro(vtkCPExtractWriter);
+vtkCxxSetObjectMacro(vtkCPExtractWriter, Controller, vtkMultiProcessController);
+
+//----------------------------------------------------------------------------
+vtkCPExtractWriter::vtkCPExtractWriter()
+{
+  this->FileName = NULL;
+  this->CompressionLevel = 1;
+  this->NumberOfRanksPerAggregator = 0;
+  this->Asynchronous = 1;
+  this->Controller = NULL;
+  this->Quantizer = vtkArrayQuantizer::New();
+  this->Threader = vtkMultiThreader::New();
+  this->AggregatorIndex = -1;
+  this->NumberOfAggregators = 0;
+  this->Internals = new vtkInternals;
+}
+
+//----------------------------------------------------------------------------
+vtkCPExtractWriter::~vtkCPExtractWriter()
+{
+  this->WaitForWrite();
+  this->SetFileName(NULL);
+  this->SetController(NULL);
+  this->Quantizer->Delete();
+  this->Threader->Delete();
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+void vtkCPExtractWriter::SetArrayNumberOfBits(const char* name, int numberOfBits)
+{
+  this->Quantizer->SetArrayNumberOfBits(name, numberOfBits);
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkCPExtractWriter::SetArrayErrorBound(const char* name, double errorBound)
+{
+  this->Quantizer->SetArrayErrorBound(name, errorBound);
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkCPExtractWriter::SetArrayFloat16(const char* name)
+{
+  this->Quantizer->SetArrayFloat16(name);
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkCPExtractWriter::RemoveAllArrays()
+{
+  this->Quantizer->RemoveAllArrays();
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkCPExtractWriter::UpdateAggregators()
+{
+  vtkMultiProcessController* controller = this->Controller?
+    this->Controller : vtkMultiProcessController::GetGlobalController();
+  if (this->NumberOfAggregators > 0 &&
+    this->Internals->ComputedController == controller &&
+    this->Internals->ComputedRanksPerAggregator ==
+    this->NumberOfRanksPerAggregator)
+    {
+    return;
+    }
+  this->Internals->ComputedController = controller;
+  this->Internals->ComputedRanksPerAggregator =
+    this->NumberOfRanksPerAggregator;
+
+  int rank = controller? controller->GetLocalProcessId() : 0;
+  int numberOfRanks = controller? controller->GetNumberOfProcesses() : 1;
+
+  // aggregators[r] is the rank rank r sends its data to.
+  std::vector<int> aggregators(numberOfRanks, 0);
+  if (this->NumberOfRanksPerAggregator > 0)
+    {
+    for (int r=0; r < numberOfRanks; r++)
+      {
+      aggregators[r] = r - r % this->NumberOfRanksPerAggregator;
+      }
+    }
+  else if (numberOfRanks > 1)
+    {
+    vtksys::SystemInformation systemInformation;
+    systemInformation.RunOSCheck();
+    std::vector<char> hostName(VTK_CP_HOST_NAME_LENGTH, 0);
+    const char* name = systemInformation.GetHostname();
+    strncpy(&hostName[0], name? name : "", VTK_CP_HOST_NAME_LENGTH - 1);
+    std::vector<char> hostNames(VTK_CP_HOST_NAME_LENGTH * numberOfRanks, 0);
+    controller->AllGather(&hostName[0], &hostNames[0],
+      VTK_CP_HOST_NAME_LENGTH);
+    // the aggregator of a host is its first rank.
+    for (int r=0; r < numberOfRanks; r++)
+      {
+      for (int s=0; s <= r; s++)
+        {
+        if (strncmp(&hostNames[s * VTK_CP_HOST_NAME_LENGTH],
+            &hostNames[r * VTK_CP_HOST_NAME_LENGTH],
+            VTK_CP_HOST_NAME_LENGTH) == 0)
+          {
+          aggregators[r] = s;
+          break;
+          }
+        }
+      }
+    }
+
+  this->Internals->Aggregator = aggregators[rank];
+  this->Internals->Members.clear();
+  this->AggregatorIndex = 0;
+  this->NumberOfAggregators = 0;
+  for (int r=0; r < numberOfRanks; r++)
+    {
+    if (aggregators[r] == r)
+      {
+      if (r < aggregators[rank])
+        {
+        this->AggregatorIndex++;
+        }
+      this->NumberOfAggregators++;
+      }
+    else if (aggregators[r] == rank)
+      {
+      this->Internals->Members.push_back(r);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkCPExtractWriter::Write(vtkDataObject* data, vtkIdType timeStep)
+{
+  int success = this->WaitForWrite();
+  if (!this->FileName || !this->FileName[0])
+    {
+    vtkErrorMacro("FileName is not set.");
+    return 0;
+    }
+
+  this->UpdateAggregators();
+  vtkMultiProcessController* controller = this->Controller?
+    this->Controller : vtkMultiProcessController::GetGlobalController();
+  int rank = controller? controller->GetLocalProcessId() : 0;
+
+  // reduce the precision of the arrays. The aggregator keeps a deep copy
+  // when writing in the background, as the simulation may change the data
+  // once Write() returns.
+  vtkSmartPointer<vtkDataObject> piece;
+  if (data)
+    {
+    this->Quantizer->SetInputData(data);
+    this->Quantizer->Update();
+    vtkDataObject* output = this->Quantizer->GetOutputDataObject(0);
+    piece.TakeReference(output->NewInstance());
+    if (this->Asynchronous && this->Internals->Aggregator == rank)
+      {
+      piece->DeepCopy(output);
+      }
+    else
+      {
+      piece->ShallowCopy(output);
+      }
+    this->Quantizer->SetInputData(NULL);
+    }
+  else
+    {
+    // the aggregator still expects a piece from this rank.
+    vtkErrorMacro("No data to write.");
+    piece = vtkSmartPointer<vtkPolyData>::New();
+    success = 0;
+    }
+
+  if (this->Internals->Aggregator != rank)
+    {
+    if (!controller->Send(piece, this->Internals->Aggregator,
+        VTK_CP_EXTRACT_WRITER_TAG))
+      {
+      vtkErrorMacro("Failed to send the data to rank "
+        << this->Internals->Aggregator << ".");
+      success = 0;
+      }
+    return success;
+    }
+
+  vtkNew<vtkMultiBlockDataSet> pieces;
+  pieces->SetNumberOfBlocks(
+    static_cast<unsigned int>(this->Internals->Members.size() + 1));
+  pieces->SetBlock(0, piece);
+  for (size_t cc=0; cc < this->Internals->Members.size(); cc++)
+    {
+    vtkDataObject* received = controller->ReceiveDataObject(
+      this->Internals->Members[cc], VTK_CP_EXTRACT_WRITER_TAG);
+    if (!received)
+      {
+      vtkErrorMacro("Failed to receive the data of rank "
+        << this->Internals->Members[cc] << ".");
+      success = 0;
+      continue;
+      }
+    pieces->SetBlock(static_cast<unsigned int>(cc + 1), received);
+    received->Delete();
+    }
+
+  // <FileName> without extension and with the time step.
+  std::string baseName = this->FileName;
+  vtksys::ios::ostringstream step;
+  step << timeStep;
+  for (size_t pos = baseName.find("%t"); pos != std::string::npos;
+    pos = baseName.find("%t", pos))
+    {
+    baseName.replace(pos, 2, step.str());
+    }
+  size_t extension = baseName.rfind('.');
+  size_t directory = baseName.find_last_of("/\\");
+  if (extension != std::string::npos &&
+    (directory == std::string::npos || extension > directory))
+    {
+    baseName.erase(extension);
+    }
+
+  vtksys::ios::ostringstream fileName;
+  fileName << baseName << "_" << this->AggregatorIndex << ".vtm";
+  this->Internals->Writer =
+    vtkSmartPointer<vtkXMLMultiBlockDataWriter>::New();
+  this->Internals->Writer->SetFileName(fileName.str().c_str());
+  this->Internals->Writer->SetInputData(pieces.GetPointer());
+  this->Internals->Writer->SetDataModeToAppended();
+  this->Internals->Writer->EncodeAppendedDataOff();
+  if (this->CompressionLevel > 0)
+    {
+    vtkNew<vtkZLibDataCompressor> compressor;
+    compressor->SetCompressionLevel(this->CompressionLevel);
+    this->Internals->Writer->SetCompressor(compressor.GetPointer());
+    }
+  else
+    {
+    this->Internals->Writer->SetCompressor(NULL);
+    }
+
+  if (rank == 0 && !this->WriteCollection(baseName.c_str()))
+    {
+    success = 0;
+    }
+
+  if (this->Asynchronous)
+    {
+    this->Internals->ThreadId = this->Threader->SpawnThread(
+      &vtkInternals::WriteThread, this);
+    }
+  else
+    {
+    this->WritePieces();
+    success = success && this->Internals->WriteSucceeded;
+    }
+  return success;
+}
+
+//----------------------------------------------------------------------------
+void vtkCPExtractWriter::WritePieces()
+{
+  this->Internals->WriteSucceeded =
+    this->Internals->Writer && this->Internals->Writer->Write() != 0;
+}
+
+//----------------------------------------------------------------------------
+bool vtkCPExtractWriter::WriteCollection(const char* baseName)
+{
+  std::string collectionName = std::string(baseName) + ".pvd";
+  ofstream collection(collectionName.c_str());
+  if (!collection)
+    {
+    vtkErrorMacro("Failed to open " << collectionName.c_str() << ".");
+    return false;
+    }
+
+  // the parts are relative to the collection file.
+  std::string name = vtksys::SystemTools::GetFilenameName(baseName);
+  collection << "<?xml version=\"1.0\"?>\n"
+    << "<VTKFile type=\"Collection\" version=\"0.1\">\n"
+    << "  <Collection>\n";
+  for (int cc=0; cc < this->NumberOfAggregators; cc++)
+    {
+    collection << "    <DataSet part=\"" << cc << "\" file=\""
+      << name.c_str() << "_" << cc << ".vtm\"/>\n";
+    }
+  collection << "  </Collection>\n"
+    << "</VTKFile>\n";
+  return collection.good();
+}
+
+//----------------------------------------------------------------------------
+int vtkCPExtractWriter::WaitForWrite()
+{
+  if (this->Internals->ThreadId >= 0)
+    {
+    this->Threader->TerminateThread(this->Internals->ThreadId);
+    this->Internals->ThreadId = -1;
+    }
+  // release the pieces written.
+  this->Internals->Writer = NULL;
+  int success = this->Internals->WriteSucceeded? 1 : 0;
+  this->Internals->WriteSucceeded = true;
+  return success;
+}
+
+//----------------------------------------------------------------------------
+void vtkCPExtractWriter::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "FileName: "
+    << (this->FileName? this->FileName : "(none)") << endl;
+  os << indent << "CompressionLevel: " << this->CompressionLevel << endl;
+  os << indent << "NumberOfRanksPerAggregator: "
+    << this->NumberOfRanksPerAggregator << endl;
+  os << indent << "Asynchronous: " << this->Asynchronous << endl;
+  os << indent << "Controller: " << this->Controller << endl;
+  os << indent << "AggregatorIndex: " << this->AggregatorIndex << endl;
+  os << indent << "NumberOfAggregators: " << this->NumberOfAggregators << endl;
+  os << indent << "Quantizer: " << endl;
+  this->Quantizer->PrintSelf(os, indent.GetNextIndent());
+}
@@ -0,0 +1,144 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkCPExtractWriter.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#ifndef vtkCPExtractWriter_h
+#define vtkCPExtractWriter_h
+
+#include "vtkObject.h"
+#include "vtkPVCatalystModule.h" // For windows import/export of shared libraries
+
+class vtkArrayQuantizer;
+class vtkDataObject;
+class vtkMultiProcessController;
+class vtkMultiThreader;
+
+/// @ingroup CoProcessing
+/// Writes the extracts of co-processing pipelines with reduced precision
+/// and compression, in the background.
+///
+/// The arrays can be quantized to a number of bits or to an error bound, or
+/// converted to half precision floating point numbers (see
+/// vtkArrayQuantizer). The error bound of each array is stored in the field
+/// data of the files. The data is then compressed with zlib, at the
+/// compression level set.
+///
+/// The ranks are split in groups, by default one per host, of which the
+/// first rank is the aggregator: the other ranks send their (quantized) data
+/// to it, and it writes all of it as a multiblock dataset to
+/// <FileName>_<aggregator>.vtm. The first rank also writes <FileName>.pvd,
+/// which lists the files of all the aggregators as its parts. When
+/// Asynchronous is on, the aggregators write in a thread, so that Write()
+/// returns once the data is sent and copied, and the next call to Write()
+/// waits for the previous write to finish.
+///
+/// It can be used by vtkCPPipeline subclasses, or in Python scripts through
+/// coprocessing.CoProcessor.CreateExtractWriter().
+class VTKPVCATALYST_EXPORT vtkCPExtractWriter : public vtkObject
+{
+public:
+  static vtkCPExtractWriter* New();
+  vtkTypeMacro(vtkCPExtractWriter, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  /// Name of the files to write without extension, in which %t is replaced
+  /// by the time step. An extension, if any, is removed.
+  vtkSetStringMacro(FileName);
+  vtkGetStringMacro(FileName);
+
+  /// Quantize the point and cell arrays with the given name to
+  /// numberOfBits bits.
+  void SetArrayNumberOfBits(const char* name, int numberOfBits);
+
+  /// Quantize the point and cell arrays with the given name to the
+  /// smallest number of bits for which the error is at most errorBound.
+  void SetArrayErrorBound(const char* name, double errorBound);
+
+  /// Convert the point and cell arrays with the given name to half
+  /// precision floating point numbers.
+  void SetArrayFloat16(const char* name);
+
+  /// Write all the arrays at full precision. This is the default.
+  void RemoveAllArrays();
+
+  /// Level of the zlib compression, from 1 (fastest) to 9 (smallest), or 0
+  /// to write uncompressed files. 1 by default.
+  vtkSetClampMacro(CompressionLevel, int, 0, 9);
+  vtkGetMacro(CompressionLevel, int);
+
+  /// Number of consecutive ranks that send their data to the same
+  /// aggregator, or 0 for the ranks running on the same host. 0 by default.
+  vtkSetClampMacro(NumberOfRanksPerAggregator, int, 0, VTK_INT_MAX);
+  vtkGetMacro(NumberOfRanksPerAggregator, int);
+
+  /// When on, the aggregators write in a thread. On by default.
+  vtkSetMacro(Asynchronous, int);
+  vtkGetMacro(Asynchronous, int);
+  vtkBooleanMacro(Asynchronous, int);
+
+  /// The controller of the ranks that write. The global controller is used
+  /// if it is NULL.
+  void SetController(vtkMultiProcessController* controller);
+  vtkGetObjectMacro(Controller, vtkMultiProcessController);
+
+  /// Write data, a dataset or a composite dataset, for the given time step.
+  /// It must be called on all ranks, with an empty dataset on the ranks
+  /// that have no data. Returns 0 if it failed, or if the previous
+  /// asynchronous write did.
+  int Write(vtkDataObject* data, vtkIdType timeStep);
+
+  /// Wait for the asynchronous write, if any, to finish. Returns 0 if it
+  /// failed.
+  int WaitForWrite();
+
+  /// The index of the aggregator of this rank, and the number of
+  /// aggregators, once Write() was called.
+  vtkGetMacro(AggregatorIndex, int);
+  vtkGetMacro(NumberOfAggregators, int);
+
+protected:
+  vtkCPExtractWriter();
+  ~vtkCPExtractWriter();
+
+  /// Computes the aggregator of each rank.
+  void UpdateAggregators();
+
+  /// Writes the pieces received by this aggregator. It is called in the
+  /// thread when Asynchronous is on.
+  void WritePieces();
+
+  /// Writes the collection file listing the files of all the aggregators.
+  bool WriteCollection(const char* baseName);
+
+  char* FileName;
+  int CompressionLevel;
+  int NumberOfRanksPerAggregator;
+  int Asynchronous;
+  vtkMultiProcessController* Controller;
+  vtkArrayQuantizer* Quantizer;
+  vtkMultiThreader* Threader;
+  int AggregatorIndex;
+  int NumberOfAggregators;
+
+private:
+  vtkCPExtractWriter(const vtkCPExtractWriter&); // Not implemented
+  void operator=(const vtkCPExtractWriter&); // Not implemented
+
+  class vtkInternals;
+  vtkInternals* Internals;
+  //BTX
+  friend class vtkInternals;
+  //ETX
+};
+
+#endif
@@ -0,0 +1,303 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkCPInTransitProcessor.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkCPInTransitProcessor.h"
+
+#include "vtkCPDataDescription.h"
+#include "vtkCPInputDataDescription.h"
+#include "vtkCPInTransitReceiver.h"
+#include "vtkMultiProcessController.h"
+#include "vtkMultiThreader.h"
+#include "vtkObjectFactory.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkSocketCommunicator.h"
+#include "vtkTimerLog.h"
+
+#include <vtksys/SystemTools.hxx>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+class vtkCPInTransitProcessor::vtkInternals
+{
+public:
+  vtkInternals() : ThreadId(-1), SendSucceeded(true) {}
+
+  vtkSmartPointer<vtkSocketCommunicator> Communicator;
+  vtkSmartPointer<vtkMultiThreader> Threader;
+  int ThreadId;
+  bool SendSucceeded;
+
+  // The message sent by the thread, see
+  // vtkCPInTransitReceiver::ProcessTimeStep().
+  int Header[3];
+  double Time;
+  vtkIdType TimeStep;
+  std::string Names;
+  std::vector<int> Extents;
+  std::vector<vtkSmartPointer<vtkDataObject> > Grids;
+
+  static VTK_THREAD_RETURN_TYPE SendThread(void* calldata)
+    {
+    vtkMultiThreader::ThreadInfo* info =
+      reinterpret_cast<vtkMultiThreader::ThreadInfo*>(calldata);
+    static_cast<vtkCPInTransitProcessor*>(info->UserData)->SendMessage();
+    return VTK_THREAD_RETURN_VALUE;
+    }
+};
+
+vtkStandardNewMacro(vtkCPInTransitProcessor);
+
+//----------------------------------------------------------------------------
+vtkCPInTransitProcessor::vtkCPInTransitProcessor()
+{
+  this->ConnectionFileName = NULL;
+  this->ConnectionTimeout = 60;
+  this->Frequency = 1;
+  this->Internals = new vtkInternals;
+  this->Internals->Threader = vtkSmartPointer<vtkMultiThreader>::New();
+}
+
+//----------------------------------------------------------------------------
+vtkCPInTransitProcessor::~vtkCPInTransitProcessor()
+{
+  this->WaitForSend();
+  if(this->Internals->Communicator)
+    {
+    this->Internals->Communicator->CloseConnection();
+    }
+  delete this->Internals;
+  this->SetConnectionFileName(NULL);
+}
+
+//----------------------------------------------------------------------------
+int vtkCPInTransitProcessor::Initialize()
+{
+  if(!this->Superclass::Initialize())
+    {
+    return 0;
+    }
+  if(this->Internals->Communicator)
+    {
+    return 1;
+    }
+  if(!this->ConnectionFileName)
+    {
+    vtkErrorMacro("ConnectionFileName is not set.");
+    return 0;
+    }
+
+  // the staging job may start after the simulation.
+  double start = vtkTimerLog::GetUniversalTime();
+  while(!vtksys::SystemTools::FileExists(this->ConnectionFileName))
+    {
+    if(vtkTimerLog::GetUniversalTime() - start > this->ConnectionTimeout)
+      {
+      vtkErrorMacro("Timed out waiting for " << this->ConnectionFileName);
+      return 0;
+      }
+    vtksys::SystemTools::Delay(100);
+    }
+  int numberOfStagingRanks = 0;
+  std::vector<std::string> hostNames;
+  std::vector<int> ports;
+  ifstream connectionFile(this->ConnectionFileName);
+  connectionFile >> numberOfStagingRanks;
+  for(int i=0;i<numberOfStagingRanks && connectionFile;i++)
+    {
+    std::string hostName;
+    int port = 0;
+    connectionFile >> hostName >> port;
+    hostNames.push_back(hostName);
+    ports.push_back(port);
+    }
+  if(numberOfStagingRanks < 1 || !connectionFile)
+    {
+    vtkErrorMacro("Failed to read " << this->ConnectionFileName);
+    return 0;
+    }
+
+  vtkMultiProcessController* controller =
+    vtkMultiProcessController::GetGlobalController();
+  int hello[2];
+  hello[0] = controller ? controller->GetLocalProcessId() : 0;
+  hello[1] = controller ? controller->GetNumberOfProcesses() : 1;
+  int target = hello[0] % numberOfStagingRanks;
+  vtkSmartPointer<vtkSocketCommunicator> communicator =
+    vtkSmartPointer<vtkSocketCommunicator>::New();
+  if(!communicator->ConnectTo(const_cast<char*>(hostNames[target].c_str()),
+                              ports[target]) ||
+     !communicator->Send(hello, 2, 1, vtkCPInTransitReceiver::HELLO_TAG))
+    {
+    vtkErrorMacro("Failed to connect to " << hostNames[target].c_str()
+                  << ":" << ports[target]);
+    return 0;
+    }
+  this->Internals->Communicator = communicator;
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+bool vtkCPInTransitProcessor::IsSendNeeded(
+  vtkCPDataDescription* dataDescription)
+{
+  return this->Internals->Communicator &&
+    (dataDescription->GetForceOutput() ||
+     dataDescription->GetTimeStep() % this->Frequency == 0);
+}
+
+//----------------------------------------------------------------------------
+int vtkCPInTransitProcessor::RequestDataDescription(
+  vtkCPDataDescription* dataDescription)
+{
+  int doCoProcessing = this->Superclass::RequestDataDescription(dataDescription);
+  if(!dataDescription || !this->IsSendNeeded(dataDescription))
+    {
+    return doCoProcessing;
+    }
+  for(unsigned int i=0;i<dataDescription->GetNumberOfInputDescriptions();i++)
+    {
+    dataDescription->GetInputDescription(i)->AllFieldsOn();
+    dataDescription->GetInputDescription(i)->GenerateMeshOn();
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkCPInTransitProcessor::CoProcess(vtkCPDataDescription* dataDescription)
+{
+  if(!dataDescription)
+    {
+    vtkWarningMacro("DataDescription is NULL.");
+    return 0;
+    }
+  int success = 1;
+  if(this->IsSendNeeded(dataDescription))
+    {
+    success = this->WaitForSend();
+
+    // copy the grids, as the simulation may change them once this returns.
+    vtkInternals* internals = this->Internals;
+    unsigned int numberOfInputs =
+      dataDescription->GetNumberOfInputDescriptions();
+    internals->Names.clear();
+    internals->Extents.resize(6 * numberOfInputs);
+    internals->Grids.clear();
+    for(unsigned int i=0;i<numberOfInputs;i++)
+      {
+      vtkCPInputDataDescription* inputDescription =
+        dataDescription->GetInputDescription(i);
+      inputDescription->AddProvidedFields();
+      internals->Names += dataDescription->GetInputDescriptionName(i);
+      internals->Names += "\n";
+      inputDescription->GetWholeExtent(&internals->Extents[6 * i]);
+      vtkDataObject* grid = inputDescription->GetGrid();
+      vtkSmartPointer<vtkDataObject> copy;
+      if(grid)
+        {
+        copy.TakeReference(grid->NewInstance());
+        copy->DeepCopy(grid);
+        }
+      else
+        {
+        copy = vtkSmartPointer<vtkPolyData>::New();
+        }
+      internals->Grids.push_back(copy);
+      }
+    internals->Header[0] = static_cast<int>(numberOfInputs);
+    internals->Header[1] = dataDescription->GetForceOutput() ? 1 : 0;
+    internals->Header[2] = static_cast<int>(internals->Names.size());
+    internals->Time = dataDescription->GetTime();
+    internals->TimeStep = dataDescription->GetTimeStep();
+    internals->ThreadId = internals->Threader->SpawnThread(
+      &vtkInternals::SendThread, this);
+    }
+  return this->Superclass::CoProcess(dataDescription) && success;
+}
+
+//----------------------------------------------------------------------------
+void vtkCPInTransitProcessor::SendMessage()
+{
+  vtkInternals* internals = this->Internals;
+  vtkSocketCommunicator* communicator = internals->Communicator;
+  const int headerTag = vtkCPInTransitReceiver::HEADER_TAG;
+  bool success = communicator->Send(internals->Header, 3, 1, headerTag) != 0;
+  if(internals->Header[0] >= 0)
+    {
+    success = success &&
+      communicator->Send(&internals->Time, 1, 1, headerTag) &&
+      communicator->Send(&internals->TimeStep, 1, 1, headerTag) &&
+      (internals->Names.empty() ||
+       communicator->Send(internals->Names.c_str(), internals->Header[2],
+                          1, headerTag)) &&
+      (internals->Extents.empty() ||
+       communicator->Send(&internals->Extents[0],
+                          static_cast<vtkIdType>(internals->Extents.size()),
+                          1, headerTag));
+    for(size_t i=0;i<internals->Grids.size() && success;i++)
+      {
+      success = communicator->Send(internals->Grids[i], 1,
+                                   vtkCPInTransitReceiver::DATA_TAG) != 0;
+      }
+    }
+  internals->SendSucceeded = success;
+}
+
+//----------------------------------------------------------------------------
+int vtkCPInTransitProcessor::WaitForSend()
+{
+  if(this->Internals->ThreadId >= 0)
+    {
+    this->Internals->Threader->TerminateThread(this->Internals->ThreadId);
+    this->Internals->ThreadId = -1;
+    }
+  this->Internals->Grids.clear();
+  int success = this->Internals->SendSucceeded ? 1 : 0;
+  if(!success)
+    {
+    vtkErrorMacro("Failed to send the grids to the staging job.");
+    }
+  this->Internals->SendSucceeded = true;
+  return success;
+}
+
+//----------------------------------------------------------------------------
+int vtkCPInTransitProcessor::Finalize()
+{
+  int success = this->WaitForSend();
+  if(this->Internals->Communicator)
+    {
+    this->Internals->Header[0] = -1;
+    this->Internals->Header[1] = 0;
+    this->Internals->Header[2] = 0;
+    this->SendMessage();
+    success = this->WaitForSend() && success;
+    this->Internals->Communicator->CloseConnection();
+    this->Internals->Communicator = NULL;
+    }
+  return this->Superclass::Finalize() && success;
+}
+
+//----------------------------------------------------------------------------
+void vtkCPInTransitProcessor::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "ConnectionFileName: "
+     << (this->ConnectionFileName ? this->ConnectionFileName : "(NULL)")
+     << "\n";
+  os << indent << "ConnectionTimeout: " << this->ConnectionTimeout << "\n";
+  os << indent << "Frequency: " << this->Frequency << "\n";
+}
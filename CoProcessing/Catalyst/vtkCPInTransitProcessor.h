@@ -0,0 +1,95 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkCPInTransitProcessor.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#ifndef vtkCPInTransitProcessor_h
+#define vtkCPInTransitProcessor_h
+
+#include "vtkCPProcessor.h"
+
+/// @ingroup CoProcessing
+/// A vtkCPProcessor that sends the grids of the simulation to a staging
+/// job, where vtkCPInTransitReceiver runs the co-processing pipelines, so
+/// that the filtering does not run on the simulation ranks.
+///
+/// Initialize() waits for the staging job to write ConnectionFileName and
+/// connects rank r of the simulation to rank r % N of the N ranks of the
+/// staging job. Every Frequency time steps, or when the output is forced,
+/// all the fields of all the inputs are requested, and CoProcess() copies
+/// the grids and sends them in a thread: it returns once they are copied,
+/// and the next send waits for the previous one to finish. The pipelines
+/// added to this processor, if any, still run on the simulation ranks.
+class VTKPVCATALYST_EXPORT vtkCPInTransitProcessor : public vtkCPProcessor
+{
+public:
+  static vtkCPInTransitProcessor* New();
+  vtkTypeMacro(vtkCPInTransitProcessor, vtkCPProcessor);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  /// The file written by vtkCPInTransitReceiver with the host names and
+  /// ports of the staging ranks.
+  vtkSetStringMacro(ConnectionFileName);
+  vtkGetStringMacro(ConnectionFileName);
+
+  /// How long Initialize() waits for the connection file, in seconds. 60
+  /// by default.
+  vtkSetClampMacro(ConnectionTimeout, double, 0, VTK_DOUBLE_MAX);
+  vtkGetMacro(ConnectionTimeout, double);
+
+  /// The grids are sent every Frequency time steps. 1 by default.
+  vtkSetClampMacro(Frequency, int, 1, VTK_INT_MAX);
+  vtkGetMacro(Frequency, int);
+
+  /// Initialize the co-processor and connect to the staging job. Returns 1
+  /// if successful and 0 otherwise.
+  virtual int Initialize();
+
+  /// Requests all the fields of all the inputs when the grids are sent.
+  virtual int RequestDataDescription(vtkCPDataDescription* dataDescription);
+
+  /// Sends the grids to the staging job when needed, then runs the local
+  /// pipelines.
+  virtual int CoProcess(vtkCPDataDescription* dataDescription);
+
+  /// Wait for the grids sent to be received. Returns 0 if the send failed.
+  int WaitForSend();
+
+  /// Tells the staging job that the simulation is done.
+  virtual int Finalize();
+
+protected:
+  vtkCPInTransitProcessor();
+  virtual ~vtkCPInTransitProcessor();
+
+  /// Returns true if the grids are sent at this time step.
+  bool IsSendNeeded(vtkCPDataDescription* dataDescription);
+
+  /// Sends the message prepared by CoProcess(). It is called in the thread.
+  void SendMessage();
+
+  char* ConnectionFileName;
+  double ConnectionTimeout;
+  int Frequency;
+
+private:
+  vtkCPInTransitProcessor(const vtkCPInTransitProcessor&); // Not implemented
+  void operator=(const vtkCPInTransitProcessor&); // Not implemented
+
+  class vtkInternals;
+  vtkInternals* Internals;
+  //BTX
+  friend class vtkInternals;
+  //ETX
+};
+
+#endif
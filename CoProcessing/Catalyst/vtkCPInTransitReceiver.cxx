@@ -0,0 +1,419 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkCPInTransitReceiver.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkCPInTransitReceiver.h"
+
+#include "vtkClientSocket.h"
+#include "vtkCommunicator.h"
+#include "vtkCPDataDescription.h"
+#include "vtkCPInputDataDescription.h"
+#include "vtkCPProcessor.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkMultiProcessController.h"
+#include "vtkObjectFactory.h"
+#include "vtkServerSocket.h"
+#include "vtkSmartPointer.h"
+#include "vtkSocketCommunicator.h"
+
+#include <vtksys/SystemInformation.hxx>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+  const int VTK_CP_HOST_NAME_LENGTH = 256;
+
+  // A simulation rank connected to this rank.
+  struct vtkCPSender
+    {
+    int Rank;
+    vtkSmartPointer<vtkSocketCommunicator> Communicator;
+    bool operator<(const vtkCPSender& other) const
+      {
+      return this->Rank < other.Rank;
+      }
+    };
+}
+
+class vtkCPInTransitReceiver::vtkInternals
+{
+public:
+  vtkSmartPointer<vtkServerSocket> ServerSocket;
+  std::vector<vtkCPSender> Senders;
+};
+
+vtkStandardNewMacro(vtkCPInTransitReceiver);
+vtkCxxSetObjectMacro(vtkCPInTransitReceiver, Processor, vtkCPProcessor);
+
+//----------------------------------------------------------------------------
+vtkCPInTransitReceiver::vtkCPInTransitReceiver()
+{
+  this->ConnectionFileName = NULL;
+  this->HostName = NULL;
+  this->Processor = NULL;
+  this->NumberOfSimulationRanks = 0;
+  this->Internals = new vtkInternals;
+}
+
+//----------------------------------------------------------------------------
+vtkCPInTransitReceiver::~vtkCPInTransitReceiver()
+{
+  for(size_t i=0;i<this->Internals->Senders.size();i++)
+    {
+    this->Internals->Senders[i].Communicator->CloseConnection();
+    }
+  delete this->Internals;
+  this->SetConnectionFileName(NULL);
+  this->SetHostName(NULL);
+  this->SetProcessor(NULL);
+}
+
+//----------------------------------------------------------------------------
+int vtkCPInTransitReceiver::GetNumberOfSenders()
+{
+  return static_cast<int>(this->Internals->Senders.size());
+}
+
+//----------------------------------------------------------------------------
+bool vtkCPInTransitReceiver::AcceptConnection()
+{
+  vtkClientSocket* socket = this->Internals->ServerSocket->WaitForConnection();
+  if(!socket)
+    {
+    vtkErrorMacro("Failed to get a connection.");
+    return false;
+    }
+  vtkCPSender sender;
+  sender.Communicator = vtkSmartPointer<vtkSocketCommunicator>::New();
+  sender.Communicator->SetSocket(socket);
+  socket->Delete();
+  int hello[2];
+  if(!sender.Communicator->ServerSideHandshake() ||
+     !sender.Communicator->Receive(hello, 2, 1, HELLO_TAG))
+    {
+    vtkErrorMacro("Failed to receive the rank of a simulation process.");
+    return false;
+    }
+  sender.Rank = hello[0];
+  this->NumberOfSimulationRanks = hello[1];
+  this->Internals->Senders.push_back(sender);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+int vtkCPInTransitReceiver::Initialize()
+{
+  if(!this->ConnectionFileName)
+    {
+    vtkErrorMacro("ConnectionFileName is not set.");
+    return 0;
+    }
+  vtkMultiProcessController* controller =
+    vtkMultiProcessController::GetGlobalController();
+  int rank = controller ? controller->GetLocalProcessId() : 0;
+  int numberOfRanks = controller ? controller->GetNumberOfProcesses() : 1;
+
+  // the system picks the port.
+  this->Internals->ServerSocket = vtkSmartPointer<vtkServerSocket>::New();
+  int port = -1;
+  if(this->Internals->ServerSocket->CreateServer(0) == 0)
+    {
+    port = this->Internals->ServerSocket->GetServerPort();
+    }
+  std::vector<char> hostName(VTK_CP_HOST_NAME_LENGTH, 0);
+  if(this->HostName)
+    {
+    strncpy(&hostName[0], this->HostName, VTK_CP_HOST_NAME_LENGTH - 1);
+    }
+  else
+    {
+    vtksys::SystemInformation systemInformation;
+    systemInformation.RunOSCheck();
+    const char* name = systemInformation.GetHostname();
+    strncpy(&hostName[0], name ? name : "localhost",
+            VTK_CP_HOST_NAME_LENGTH - 1);
+    }
+
+  std::vector<char> hostNames(hostName);
+  std::vector<int> ports(1, port);
+  if(numberOfRanks > 1)
+    {
+    hostNames.resize(VTK_CP_HOST_NAME_LENGTH * numberOfRanks);
+    ports.resize(numberOfRanks);
+    controller->Gather(&hostName[0], &hostNames[0],
+                       VTK_CP_HOST_NAME_LENGTH, 0);
+    controller->Gather(&port, &ports[0], 1, 0);
+    }
+
+  int success = 1;
+  if(rank == 0)
+    {
+    // the simulation waits for the file to exist, so it is only renamed to
+    // ConnectionFileName once complete.
+    std::string temporaryName = std::string(this->ConnectionFileName) + ".tmp";
+    ofstream connectionFile(temporaryName.c_str());
+    connectionFile << numberOfRanks << "\n";
+    for(int i=0;i<numberOfRanks;i++)
+      {
+      connectionFile << &hostNames[i * VTK_CP_HOST_NAME_LENGTH] << " "
+                     << ports[i] << "\n";
+      success = success && ports[i] > 0;
+      }
+    connectionFile.close();
+    if(!success || !connectionFile ||
+       rename(temporaryName.c_str(), this->ConnectionFileName) != 0)
+      {
+      vtkErrorMacro("Failed to write " << this->ConnectionFileName);
+      success = 0;
+      }
+    }
+  if(numberOfRanks > 1)
+    {
+    controller->Broadcast(&success, 1, 0);
+    }
+  if(!success)
+    {
+    return 0;
+    }
+
+  // the first connection gives the number of simulation ranks. Simulation
+  // rank 0 always connects to this rank 0.
+  if(rank == 0 && !this->AcceptConnection())
+    {
+    this->NumberOfSimulationRanks = -1;
+    }
+  if(numberOfRanks > 1)
+    {
+    controller->Broadcast(&this->NumberOfSimulationRanks, 1, 0);
+    }
+  if(this->NumberOfSimulationRanks < 0)
+    {
+    return 0;
+    }
+  int numberOfSenders = 0;
+  for(int i=rank;i<this->NumberOfSimulationRanks;i+=numberOfRanks)
+    {
+    numberOfSenders++;
+    }
+  int accepted = 1;
+  while(accepted &&
+        static_cast<int>(this->Internals->Senders.size()) < numberOfSenders)
+    {
+    accepted = this->AcceptConnection() ? 1 : 0;
+    }
+  std::sort(this->Internals->Senders.begin(), this->Internals->Senders.end());
+  this->Internals->ServerSocket = NULL;
+
+  // the ports are closed: the file must not be used by another simulation.
+  // All the ranks fail if one of them failed to accept a connection.
+  success = accepted;
+  if(numberOfRanks > 1)
+    {
+    controller->AllReduce(&accepted, &success, 1, vtkCommunicator::MIN_OP);
+    }
+  if(rank == 0)
+    {
+    remove(this->ConnectionFileName);
+    }
+  return success;
+}
+
+//----------------------------------------------------------------------------
+int vtkCPInTransitReceiver::ProcessTimeStep()
+{
+  if(!this->Processor)
+    {
+    vtkErrorMacro("Processor is not set.");
+    return -1;
+    }
+  vtkMultiProcessController* controller =
+    vtkMultiProcessController::GetGlobalController();
+  int numberOfRanks = controller ? controller->GetNumberOfProcesses() : 1;
+  std::vector<vtkCPSender>& senders = this->Internals->Senders;
+
+  // every sender sends the same header: the number of inputs (or -1 when
+  // the simulation finalizes), whether the output is forced and the length
+  // of the input names, followed by the time, the time step, the input
+  // names and their whole extents. The header of rank 0 is used by all the
+  // ranks, as some may have no sender.
+  bool success = true;
+  int header[3] = { -1, 0, 0 };
+  double time = 0;
+  vtkIdType timeStep = 0;
+  std::vector<char> names;
+  std::vector<int> extents;
+  int received = 1;
+  for(size_t i=0;i<senders.size();i++)
+    {
+    vtkSocketCommunicator* communicator = senders[i].Communicator;
+    if(!communicator->Receive(header, 3, 1, HEADER_TAG))
+      {
+      vtkErrorMacro("Failed to receive from rank " << senders[i].Rank);
+      received = 0;
+      break;
+      }
+    if(header[0] < 0)
+      {
+      continue;
+      }
+    names.resize(header[2] + 1, 0);
+    extents.resize(6 * header[0] + 1, 0);
+    success = communicator->Receive(&time, 1, 1, HEADER_TAG) &&
+      communicator->Receive(&timeStep, 1, 1, HEADER_TAG) &&
+      (header[2] == 0 ||
+       communicator->Receive(&names[0], header[2], 1, HEADER_TAG)) &&
+      (header[0] == 0 ||
+       communicator->Receive(&extents[0], 6 * header[0], 1, HEADER_TAG)) &&
+      success;
+    }
+  // all the ranks stop if one of them failed to receive a header, instead
+  // of waiting for it in the broadcasts.
+  if(numberOfRanks > 1)
+    {
+    int localReceived = received;
+    controller->AllReduce(&localReceived, &received, 1,
+                          vtkCommunicator::MIN_OP);
+    }
+  if(!received)
+    {
+    return -1;
+    }
+  if(numberOfRanks > 1)
+    {
+    controller->Broadcast(header, 3, 0);
+    if(header[0] >= 0)
+      {
+      names.resize(header[2] + 1, 0);
+      extents.resize(6 * header[0] + 1, 0);
+      controller->Broadcast(&time, 1, 0);
+      controller->Broadcast(&timeStep, 1, 0);
+      if(header[2] > 0)
+        {
+        controller->Broadcast(&names[0], header[2], 0);
+        }
+      if(header[0] > 0)
+        {
+        controller->Broadcast(&extents[0], 6 * header[0], 0);
+        }
+      }
+    }
+  if(header[0] < 0)
+    {
+    return 0;
+    }
+
+  vtkSmartPointer<vtkCPDataDescription> dataDescription =
+    vtkSmartPointer<vtkCPDataDescription>::New();
+  std::vector<std::string> inputNames;
+  std::string name;
+  for(int i=0;i<header[2];i++)
+    {
+    if(names[i] == '\n')
+      {
+      inputNames.push_back(name);
+      name.clear();
+      }
+    else
+      {
+      name += names[i];
+      }
+    }
+  for(size_t i=0;i<inputNames.size();i++)
+    {
+    dataDescription->AddInput(inputNames[i].c_str());
+    }
+  dataDescription->SetTimeData(time, timeStep);
+  dataDescription->SetForceOutput(header[1] != 0);
+
+  // the grids are received whether or not the pipelines need them.
+  std::vector<vtkSmartPointer<vtkDataObject> > grids;
+  for(size_t i=0;i<inputNames.size();i++)
+    {
+    vtkSmartPointer<vtkMultiBlockDataSet> blocks =
+      vtkSmartPointer<vtkMultiBlockDataSet>::New();
+    blocks->SetNumberOfBlocks(static_cast<unsigned int>(senders.size()));
+    for(size_t j=0;j<senders.size();j++)
+      {
+      vtkDataObject* grid =
+        senders[j].Communicator->ReceiveDataObject(1, DATA_TAG);
+      if(!grid)
+        {
+        vtkErrorMacro("Failed to receive " << inputNames[i].c_str()
+                      << " from rank " << senders[j].Rank);
+        success = false;
+        continue;
+        }
+      blocks->SetBlock(static_cast<unsigned int>(j), grid);
+      grid->Delete();
+      }
+    if(this->NumberOfSimulationRanks == numberOfRanks && blocks->GetBlock(0))
+      {
+      grids.push_back(blocks->GetBlock(0));
+      }
+    else
+      {
+      grids.push_back(blocks.GetPointer());
+      }
+    }
+
+  if(this->Processor->RequestDataDescription(dataDescription))
+    {
+    for(size_t i=0;i<inputNames.size();i++)
+      {
+      vtkCPInputDataDescription* inputDescription =
+        dataDescription->GetInputDescription(static_cast<unsigned int>(i));
+      inputDescription->SetWholeExtent(&extents[6 * i]);
+      inputDescription->SetGrid(grids[i]);
+      }
+    success = this->Processor->CoProcess(dataDescription) && success;
+    }
+  // all the ranks stop at the same time step on errors.
+  int status = success ? 1 : 0;
+  if(numberOfRanks > 1)
+    {
+    int localStatus = status;
+    controller->AllReduce(&localStatus, &status, 1, vtkCommunicator::MIN_OP);
+    }
+  return status ? 1 : -1;
+}
+
+//----------------------------------------------------------------------------
+int vtkCPInTransitReceiver::Run()
+{
+  int result;
+  while((result = this->ProcessTimeStep()) == 1)
+    {
+    }
+  return result == 0 ? 1 : 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkCPInTransitReceiver::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "ConnectionFileName: "
+     << (this->ConnectionFileName ? this->ConnectionFileName : "(NULL)")
+     << "\n";
+  os << indent << "HostName: "
+     << (this->HostName ? this->HostName : "(NULL)") << "\n";
+  os << indent << "Processor: " << this->Processor << "\n";
+  os << indent << "NumberOfSimulationRanks: "
+     << this->NumberOfSimulationRanks << "\n";
+  os << indent << "NumberOfSenders: " << this->GetNumberOfSenders() << "\n";
+}
@@ -0,0 +1,106 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkCPInTransitReceiver.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#ifndef vtkCPInTransitReceiver_h
+#define vtkCPInTransitReceiver_h
+
+#include "vtkObject.h"
+#include "vtkPVCatalystModule.h" // For windows import/export of shared libraries
+
+class vtkCPProcessor;
+
+/// @ingroup CoProcessing
+/// Runs the co-processing pipelines of a simulation in a separate staging
+/// job (e.g. pvbatch), on the grids sent by vtkCPInTransitProcessor.
+///
+/// Like vtkMPIMToNSocketConnection, the M ranks of the simulation are
+/// connected to the N ranks of the staging job with sockets: each staging
+/// rank opens a server socket, the first one writes the host names and
+/// ports of all of them to ConnectionFileName, and simulation rank r
+/// connects to staging rank r % N. For every time step sent, the grids the
+/// staging ranks receive are given to the pipelines of Processor: a
+/// vtkMultiBlockDataSet with one block per simulation rank connected, or the
+/// grid itself when M equals N.
+///
+/// The connection file has the number of staging ranks on its first line,
+/// followed by the host name and port of each staging rank.
+class VTKPVCATALYST_EXPORT vtkCPInTransitReceiver : public vtkObject
+{
+public:
+  static vtkCPInTransitReceiver* New();
+  vtkTypeMacro(vtkCPInTransitReceiver, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  /// The tags of the messages sent by vtkCPInTransitProcessor.
+  enum
+    {
+    HELLO_TAG = 9301,
+    HEADER_TAG = 9302,
+    DATA_TAG = 9303
+    };
+
+  /// The file to write the host names and ports to connect to into.
+  vtkSetStringMacro(ConnectionFileName);
+  vtkGetStringMacro(ConnectionFileName);
+
+  /// The host name the simulation ranks connect to. The name of the host
+  /// is used if it is NULL, the default.
+  vtkSetStringMacro(HostName);
+  vtkGetStringMacro(HostName);
+
+  /// The processor running the pipelines.
+  void SetProcessor(vtkCPProcessor* processor);
+  vtkGetObjectMacro(Processor, vtkCPProcessor);
+
+  /// Write the connection file and wait for all the simulation ranks to
+  /// connect. It must be called on all the staging ranks. Returns 1 if
+  /// successful and 0 otherwise, on all the ranks if one of them failed.
+  int Initialize();
+
+  /// Receive a time step and run the pipelines on it. It must be called on
+  /// all the staging ranks. Returns 1 if a time step was processed, 0 if
+  /// the simulation finalized and -1 on errors, on all the ranks if one of
+  /// them failed.
+  int ProcessTimeStep();
+
+  /// Process the time steps until the simulation finalizes. Returns 1 if
+  /// successful and 0 otherwise.
+  int Run();
+
+  /// The number of ranks of the simulation, and of those connected to this
+  /// rank, once initialized.
+  vtkGetMacro(NumberOfSimulationRanks, int);
+  int GetNumberOfSenders();
+
+protected:
+  vtkCPInTransitReceiver();
+  virtual ~vtkCPInTransitReceiver();
+
+  /// Accepts a connection and adds it to the senders.
+  bool AcceptConnection();
+
+  char* ConnectionFileName;
+  char* HostName;
+  vtkCPProcessor* Processor;
+  int NumberOfSimulationRanks;
+
+private:
+  vtkCPInTransitReceiver(const vtkCPInTransitReceiver&); // Not implemented
+  void operator=(const vtkCPInTransitReceiver&); // Not implemented
+
+  class vtkInternals;
+  vtkInternals* Internals;
+};
+
+#endif
@@ -17,10 +17,14 @@
 #include "vtkCellData.h"
 #include "vtkCompositeDataIterator.h"
 #include "vtkCompositeDataSet.h"
+#include "vtkCPLazyDataArray.h"
 #include "vtkDataSet.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkSmartPointer.h"
+#include "vtkWeakPointer.h"
 
+#include <map>
 #include <vector>
 #include <string>
 #include <algorithm>
@@ -31,6 +35,56 @@ public:
   typedef std::vector<std::string> FieldType;
   FieldType PointFields;
   FieldType CellFields;
+
+  struct ProviderType
+    {
+    FieldProvider Provider;
+    void* ClientData;
+    int NumberOfComponents;
+    };
+  typedef std::map<std::string, ProviderType> ProvidersType;
+  ProvidersType PointProviders;
+  ProvidersType CellProviders;
+
+  // Lazy arrays added to the point or cell data of the grid.
+  struct ProvidedArrayType
+    {
+    vtkSmartPointer<vtkCPLazyDataArray> Array;
+    vtkWeakPointer<vtkFieldData> Attributes;
+    };
+  std::vector<ProvidedArrayType> ProvidedArrays;
+
+  struct StatisticsType
+    {
+    std::string Name;
+    double ConversionTime;
+    vtkIdType ConversionSize;
+    };
+  std::vector<StatisticsType> Statistics;
+
+  void AddProvidedFields(vtkCPInputDataDescription* self, vtkDataSet* dataSet,
+    vtkFieldData* attributes, const ProvidersType& providers,
+    vtkIdType numberOfTuples)
+    {
+    ProvidersType::const_iterator iter;
+    for (iter = providers.begin(); iter != providers.end(); ++iter)
+      {
+      const char* fieldName = iter->first.c_str();
+      if (!self->IsFieldNeeded(fieldName) || attributes->GetArray(fieldName))
+        {
+        continue;
+        }
+      ProvidedArrayType provided;
+      provided.Array = vtkSmartPointer<vtkCPLazyDataArray>::New();
+      provided.Array->SetName(fieldName);
+      provided.Array->SetProvider(iter->second.Provider,
+        iter->second.ClientData, dataSet, iter->second.NumberOfComponents,
+        numberOfTuples);
+      provided.Attributes = attributes;
+      attributes->AddArray(provided.Array);
+      this->ProvidedArrays.push_back(provided);
+      }
+    }
 };
 
 vtkStandardNewMacro(vtkCPInputDataDescription);
@@ -78,6 +132,167 @@ void vtkCPInputDataDescription::AddCellField(const char* fieldName)
   this->Internals->CellFields.push_back(fieldName);
 }
 
+//----------------------------------------------------------------------------
+void vtkCPInputDataDescription::AddPointFieldProvider(const char* fieldName,
+  int numberOfComponents, FieldProvider provider, void* clientData)
+{
+  if (!fieldName || !provider || numberOfComponents < 1)
+    {
+    vtkErrorMacro("Invalid field provider.");
+    return;
+    }
+  vtkInternals::ProviderType& info =
+    this->Internals->PointProviders[fieldName];
+  info.Provider = provider;
+  info.ClientData = clientData;
+  info.NumberOfComponents = numberOfComponents;
+}
+
+//----------------------------------------------------------------------------
+void vtkCPInputDataDescription::AddCellFieldProvider(const char* fieldName,
+  int numberOfComponents, FieldProvider provider, void* clientData)
+{
+  if (!fieldName || !provider || numberOfComponents < 1)
+    {
+    vtkErrorMacro("Invalid field provider.");
+    return;
+    }
+  vtkInternals::ProviderType& info =
+    this->Internals->CellProviders[fieldName];
+  info.Provider = provider;
+  info.ClientData = clientData;
+  info.NumberOfComponents = numberOfComponents;
+}
+
+//----------------------------------------------------------------------------
+void vtkCPInputDataDescription::RemoveAllFieldProviders()
+{
+  this->Internals->PointProviders.clear();
+  this->Internals->CellProviders.clear();
+}
+
+//----------------------------------------------------------------------------
+void vtkCPInputDataDescription::AddProvidedFields()
+{
+  if (this->Grid == 0 || (this->Internals->PointProviders.empty() &&
+      this->Internals->CellProviders.empty()))
+    {
+    return;
+    }
+
+  std::vector<vtkDataSet*> dataSets;
+  vtkCompositeDataSet* composite =
+    vtkCompositeDataSet::SafeDownCast(this->Grid);
+  if (composite)
+    {
+    vtkCompositeDataIterator* iter = composite->NewIterator();
+    iter->SkipEmptyNodesOn();
+    for(iter->GoToFirstItem();!iter->IsDoneWithTraversal();iter->GoToNextItem())
+      {
+      vtkDataSet* dataSet = vtkDataSet::SafeDownCast(iter->GetDataSet());
+      if (dataSet)
+        {
+        dataSets.push_back(dataSet);
+        }
+      }
+    iter->Delete();
+    }
+  else if (vtkDataSet::SafeDownCast(this->Grid))
+    {
+    dataSets.push_back(vtkDataSet::SafeDownCast(this->Grid));
+    }
+
+  for (size_t cc=0; cc < dataSets.size(); cc++)
+    {
+    vtkDataSet* dataSet = dataSets[cc];
+    this->Internals->AddProvidedFields(this, dataSet, dataSet->GetPointData(),
+      this->Internals->PointProviders, dataSet->GetNumberOfPoints());
+    this->Internals->AddProvidedFields(this, dataSet, dataSet->GetCellData(),
+      this->Internals->CellProviders, dataSet->GetNumberOfCells());
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkCPInputDataDescription::RemoveProvidedFields()
+{
+  this->Internals->Statistics.clear();
+  std::vector<vtkInternals::ProvidedArrayType>::iterator iter;
+  for (iter = this->Internals->ProvidedArrays.begin();
+    iter != this->Internals->ProvidedArrays.end(); ++iter)
+    {
+    vtkCPLazyDataArray* array = iter->Array;
+    std::vector<vtkInternals::StatisticsType>::iterator stats;
+    for (stats = this->Internals->Statistics.begin();
+      stats != this->Internals->Statistics.end() &&
+      stats->Name != array->GetName(); ++stats)
+      {
+      }
+    if (stats == this->Internals->Statistics.end())
+      {
+      vtkInternals::StatisticsType newStats;
+      newStats.Name = array->GetName();
+      newStats.ConversionTime = 0;
+      newStats.ConversionSize = 0;
+      stats = this->Internals->Statistics.insert(stats, newStats);
+      }
+    stats->ConversionTime += array->GetConversionTime();
+    stats->ConversionSize += array->GetConversionSize();
+
+    // Only remove the array if the adaptor did not replace it.
+    if (iter->Attributes &&
+      iter->Attributes->GetArray(array->GetName()) == array)
+      {
+      iter->Attributes->RemoveArray(array->GetName());
+      }
+    // The array may still be referenced, e.g. by the output of a filter:
+    // make sure that the provider is not called after this time step.
+    array->DetachProvider();
+    }
+  this->Internals->ProvidedArrays.clear();
+}
+
+//----------------------------------------------------------------------------
+unsigned int vtkCPInputDataDescription::GetNumberOfProvidedFields()
+{
+  return static_cast<unsigned int>(this->Internals->Statistics.size());
+}
+
+//----------------------------------------------------------------------------
+const char* vtkCPInputDataDescription::GetProvidedFieldName(
+  unsigned int fieldIndex)
+{
+  if (fieldIndex >= this->GetNumberOfProvidedFields())
+    {
+    vtkWarningMacro("Bad FieldIndex " << fieldIndex);
+    return 0;
+    }
+  return this->Internals->Statistics[fieldIndex].Name.c_str();
+}
+
+//----------------------------------------------------------------------------
+double vtkCPInputDataDescription::GetProvidedFieldConversionTime(
+  unsigned int fieldIndex)
+{
+  if (fieldIndex >= this->GetNumberOfProvidedFields())
+    {
+    vtkWarningMacro("Bad FieldIndex " << fieldIndex);
+    return 0;
+    }
+  return this->Internals->Statistics[fieldIndex].ConversionTime;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCPInputDataDescription::GetProvidedFieldConversionSize(
+  unsigned int fieldIndex)
+{
+  if (fieldIndex >= this->GetNumberOfProvidedFields())
+    {
+    vtkWarningMacro("Bad FieldIndex " << fieldIndex);
+    return 0;
+    }
+  return this->Internals->Statistics[fieldIndex].ConversionSize;
+}
+
 //----------------------------------------------------------------------------
 unsigned int vtkCPInputDataDescription::GetNumberOfFields()
 {
@@ -240,4 +455,13 @@ void vtkCPInputDataDescription::PrintSelf(ostream& os, vtkIndent indent)
      << this->WholeExtent[1] << " " << this->WholeExtent[2] << " "
      << this->WholeExtent[3] << " " << this->WholeExtent[4] << " "
      << this->WholeExtent[5] << "\n";
+  os << indent << "FieldProviders: "
+     << this->Internals->PointProviders.size() +
+        this->Internals->CellProviders.size() << "\n";
+  for (unsigned int cc=0; cc < this->GetNumberOfProvidedFields(); cc++)
+    {
+    os << indent << "ProvidedField " << this->GetProvidedFieldName(cc)
+       << ": " << this->GetProvidedFieldConversionTime(cc) << " s, "
+       << this->GetProvidedFieldConversionSize(cc) << " bytes\n";
+    }
 }
@@ -17,6 +17,7 @@
 
 class vtkDataObject;
 class vtkDataSet;
+class vtkDoubleArray;
 class vtkFieldData;
 
 #include "vtkObject.h"
@@ -95,6 +96,54 @@ public:
   vtkSetVector6Macro(WholeExtent, int);
   vtkGetVector6Macro(WholeExtent, int);
 
+  //BTX
+  // Description:
+  // Function computing the values of the field fieldName of dataSet into
+  // array, which already has the number of components given when the
+  // provider was added and one tuple per point or cell of dataSet.
+  typedef void (*FieldProvider)(vtkDataSet* dataSet, const char* fieldName,
+    vtkDoubleArray* array, void* clientData);
+
+  // Description:
+  // Register a provider for a point or cell field with numberOfComponents
+  // components. When the field is needed and missing from the grid,
+  // CoProcess() adds a vtkCPLazyDataArray to the grid (or to each of its
+  // blocks) that calls the provider when a filter first accesses its values,
+  // so that the adaptor only converts the fields that are actually used.
+  // Providers are kept until RemoveAllFieldProviders() is called, and
+  // clientData must remain valid as long as they are registered.
+  void AddPointFieldProvider(const char* fieldName, int numberOfComponents,
+    FieldProvider provider, void* clientData);
+  void AddCellFieldProvider(const char* fieldName, int numberOfComponents,
+    FieldProvider provider, void* clientData);
+  //ETX
+  void RemoveAllFieldProviders();
+
+  // Description:
+  // Add to the grid the needed fields that have a provider and that the grid
+  // does not have. Called by vtkCPProcessor::CoProcess() before each
+  // pipeline is executed.
+  void AddProvidedFields();
+
+  // Description:
+  // Remove the fields added by AddProvidedFields() from the grid and record
+  // the time taken to convert them and their size. Their providers are
+  // detached, so arrays still referenced elsewhere keep the values computed
+  // so far and never call the providers again. Called by
+  // vtkCPProcessor::CoProcess() once the pipelines were executed.
+  void RemoveProvidedFields();
+
+  // Description:
+  // Statistics of the fields added to the grid during the last CoProcess(),
+  // i.e. until the last call to RemoveProvidedFields(): the time in seconds
+  // taken by the providers and the size in bytes of the values they
+  // computed, summed over the blocks of the grid. Both are 0 for the fields
+  // that no filter accessed.
+  unsigned int GetNumberOfProvidedFields();
+  const char* GetProvidedFieldName(unsigned int fieldIndex);
+  double GetProvidedFieldConversionTime(unsigned int fieldIndex);
+  vtkIdType GetProvidedFieldConversionSize(unsigned int fieldIndex);
+
 //BTX
 protected:
   vtkCPInputDataDescription();
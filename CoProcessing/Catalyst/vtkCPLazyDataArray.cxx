@@ -0,0 +1,108 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkCPLazyDataArray.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkCPLazyDataArray.h"
+
+#include "vtkDataSet.h"
+#include "vtkDoubleArray.h"
+#include "vtkObjectFactory.h"
+#include "vtkTimerLog.h"
+
+vtkStandardNewMacro(vtkCPLazyDataArray);
+//----------------------------------------------------------------------------
+vtkCPLazyDataArray::vtkCPLazyDataArray()
+{
+  this->Provider = NULL;
+  this->ClientData = NULL;
+  this->ConversionTime = 0;
+  this->ConversionSize = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkCPLazyDataArray::~vtkCPLazyDataArray()
+{
+}
+
+//----------------------------------------------------------------------------
+void vtkCPLazyDataArray::Initialize()
+{
+  this->Provider = NULL;
+  this->ClientData = NULL;
+  this->DataSet = NULL;
+  this->ConversionTime = 0;
+  this->ConversionSize = 0;
+  this->Superclass::Initialize();
+}
+
+//----------------------------------------------------------------------------
+void vtkCPLazyDataArray::DetachProvider()
+{
+  this->Provider = NULL;
+  this->ClientData = NULL;
+  this->DataSet = NULL;
+  if (!this->Fallback)
+    {
+    this->Size = 0;
+    this->MaxId = -1;
+    this->DataChanged();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkCPLazyDataArray::SetProvider(
+  vtkCPInputDataDescription::FieldProvider provider, void* clientData,
+  vtkDataSet* dataSet, int numberOfComponents, vtkIdType numberOfTuples)
+{
+  this->Initialize();
+  this->SetNumberOfComponents(numberOfComponents);
+  this->Provider = provider;
+  this->ClientData = clientData;
+  this->DataSet = dataSet;
+  this->Size = numberOfTuples * this->NumberOfComponents;
+  this->MaxId = this->Size - 1;
+  this->DataChanged();
+}
+
+//----------------------------------------------------------------------------
+void vtkCPLazyDataArray::FillFallback(vtkDoubleArray* array)
+{
+  if (!this->Provider)
+    {
+    return;
+    }
+  vtkTimerLog::MarkStartEvent("Materialize field");
+  double start = vtkTimerLog::GetUniversalTime();
+  (*this->Provider)(this->DataSet, this->GetName(), array, this->ClientData);
+  this->ConversionTime = vtkTimerLog::GetUniversalTime() - start;
+  vtkTimerLog::MarkEndEvent("Materialize field");
+  if (array->GetNumberOfTuples() != this->GetNumberOfTuples() ||
+    array->GetNumberOfComponents() != this->NumberOfComponents)
+    {
+    vtkWarningMacro("The provider of " << (this->GetName()? this->GetName() :
+        "(none)") << " changed the size of the array.");
+    }
+  this->ConversionSize = static_cast<vtkIdType>(
+    array->GetNumberOfTuples() * array->GetNumberOfComponents() *
+    sizeof(double));
+}
+
+//----------------------------------------------------------------------------
+void vtkCPLazyDataArray::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Provider: " << (this->Provider? "set" : "(none)") << endl;
+  os << indent << "Materialized: " << this->IsMaterialized() << endl;
+  os << indent << "ConversionTime: " << this->ConversionTime << endl;
+  os << indent << "ConversionSize: " << this->ConversionSize << endl;
+}
@@ -0,0 +1,86 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkCPLazyDataArray.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#ifndef vtkCPLazyDataArray_h
+#define vtkCPLazyDataArray_h
+
+#include "vtkPVDelegatingDataArray.h"
+#include "vtkCPInputDataDescription.h" // for FieldProvider
+#include "vtkPVCatalystModule.h" // needed for exports
+#include "vtkWeakPointer.h" // for the data set
+
+class vtkDataSet;
+
+/// @ingroup CoProcessing
+/// Double array whose values are only computed, by a field provider of
+/// vtkCPInputDataDescription, when they are first accessed. The number of
+/// components and tuples are known beforehand, so that filters can look at
+/// the arrays of the grid without computing any of them.
+///
+/// The first access to the values calls the provider to fill the fallback
+/// vtkDoubleArray of vtkPVDelegatingDataArray, to which the array then
+/// delegates everything. The time taken by the provider and the size of the
+/// values are recorded. Arrays created with NewInstance() have no provider
+/// and behave as a vtkDoubleArray.
+class VTKPVCATALYST_EXPORT vtkCPLazyDataArray : public vtkPVDelegatingDataArray
+{
+public:
+  static vtkCPLazyDataArray* New();
+  vtkTypeMacro(vtkCPLazyDataArray, vtkPVDelegatingDataArray);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  //BTX
+  /// Set the provider that computes the values of the field of dataSet,
+  /// which has numberOfTuples tuples of numberOfComponents values. The name
+  /// of the array is used as the name of the field.
+  void SetProvider(vtkCPInputDataDescription::FieldProvider provider,
+    void* clientData, vtkDataSet* dataSet, int numberOfComponents,
+    vtkIdType numberOfTuples);
+  //ETX
+
+  /// Returns 1 if the values were computed.
+  int IsMaterialized() { return this->Fallback? 1 : 0; }
+
+  /// Time in seconds taken by the provider, and size in bytes of the values
+  /// it computed. Both are 0 until the values are first accessed.
+  vtkGetMacro(ConversionTime, double);
+  vtkGetMacro(ConversionSize, vtkIdType);
+
+  /// Release the provider and the values.
+  void Initialize();
+
+  /// Drop the provider, which must not be called anymore, e.g. because the
+  /// simulation data it reads is no longer valid. Values already computed
+  /// are kept. If they were not, the array becomes empty.
+  void DetachProvider();
+
+protected:
+  vtkCPLazyDataArray();
+  ~vtkCPLazyDataArray();
+
+  /// Computes the values with the provider.
+  virtual void FillFallback(vtkDoubleArray* fallback);
+
+  vtkCPInputDataDescription::FieldProvider Provider;
+  void* ClientData;
+  vtkWeakPointer<vtkDataSet> DataSet;
+  double ConversionTime;
+  vtkIdType ConversionSize;
+
+private:
+  vtkCPLazyDataArray(const vtkCPLazyDataArray&); // Not implemented
+  void operator=(const vtkCPLazyDataArray&); // Not implemented
+};
+
+#endif
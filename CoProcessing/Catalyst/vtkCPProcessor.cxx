@@ -16,7 +16,9 @@
 
 #include "vtkCPCxxHelper.h"
 #include "vtkCPDataDescription.h"
+#include "vtkCPInputDataDescription.h"
 #include "vtkCPPipeline.h"
+#include "vtkCPTemporalCache.h"
 #include "vtkObjectFactory.h"
 #include "vtkSmartPointer.h"
 #include "vtkSMIntVectorProperty.h"
@@ -35,12 +37,14 @@ struct vtkCPProcessorInternals
 
 
 vtkStandardNewMacro(vtkCPProcessor);
+vtkCxxSetObjectMacro(vtkCPProcessor, TemporalCache, vtkCPTemporalCache);
 
 //----------------------------------------------------------------------------
 vtkCPProcessor::vtkCPProcessor()
 {
   this->Internal = new vtkCPProcessorInternals;
   this->InitializationHelper = NULL;
+  this->TemporalCache = NULL;
 }
 
 //----------------------------------------------------------------------------
@@ -57,6 +61,8 @@ vtkCPProcessor::~vtkCPProcessor()
     this->InitializationHelper->Delete();
     this->InitializationHelper = NULL;
     }
+
+  this->SetTemporalCache(NULL);
 }
 
 //----------------------------------------------------------------------------
@@ -156,19 +162,35 @@ int vtkCPProcessor::RequestDataDescription(
     vtkWarningMacro("DataDescription is NULL.");
     return 0;
     }
+  dataDescription->SetTemporalCache(this->TemporalCache);
+  int doCoProcessing = 0;
   if(dataDescription->GetForceOutput() == true)
     {
-    return 1;
+    doCoProcessing = 1;
     }
-
-  dataDescription->ResetInputDescriptions();
-  int doCoProcessing = 0;
-  for(vtkCPProcessorInternals::PipelineListIterator iter =
-        this->Internal->Pipelines.begin();
-      iter!=this->Internal->Pipelines.end();iter++)
+  else
+    {
+    dataDescription->ResetInputDescriptions();
+    for(vtkCPProcessorInternals::PipelineListIterator iter =
+          this->Internal->Pipelines.begin();
+        iter!=this->Internal->Pipelines.end();iter++)
+      {
+      if(iter->GetPointer()->RequestDataDescription(dataDescription))
+        {
+        doCoProcessing = 1;
+        }
+      }
+    }
+  // the cached input is needed at every time step, also when the output
+  // is forced.
+  if(this->TemporalCache && this->TemporalCache->GetNumberOfTimeSteps() > 0)
     {
-    if(iter->GetPointer()->RequestDataDescription(dataDescription))
+    vtkCPInputDataDescription* inputDescription =
+      dataDescription->GetInputDescriptionByName(
+        this->TemporalCache->GetInputName());
+    if(inputDescription)
       {
+      this->TemporalCache->RequestFields(inputDescription);
       doCoProcessing = 1;
       }
     }
@@ -183,7 +205,27 @@ int vtkCPProcessor::CoProcess(vtkCPDataDescription* dataDescription)
     vtkWarningMacro("DataDescription is NULL.");
     return 0;
     }
+  unsigned int numberOfInputs = dataDescription->GetNumberOfInputDescriptions();
   int success = 1;
+  dataDescription->SetTemporalCache(this->TemporalCache);
+  if(this->TemporalCache && this->TemporalCache->GetNumberOfTimeSteps() > 0)
+    {
+    vtkCPInputDataDescription* inputDescription =
+      dataDescription->GetInputDescriptionByName(
+        this->TemporalCache->GetInputName());
+    // the ranks without a grid add an empty time step: the memory limit
+    // is agreed upon by all the ranks.
+    if(inputDescription)
+      {
+      inputDescription->AddProvidedFields();
+      if(!this->TemporalCache->AddTimeStep(inputDescription->GetGrid(),
+                                           dataDescription->GetTime(),
+                                           dataDescription->GetTimeStep()))
+        {
+        success = 0;
+        }
+      }
+    }
   for(vtkCPProcessorInternals::PipelineListIterator iter =
         this->Internal->Pipelines.begin();
       iter!=this->Internal->Pipelines.end();iter++)
@@ -191,12 +233,22 @@ int vtkCPProcessor::CoProcess(vtkCPDataDescription* dataDescription)
     if(dataDescription->GetForceOutput() == true ||
        iter->GetPointer()->RequestDataDescription(dataDescription))
       {
+      // the fields that have a provider are only converted when the
+      // pipeline accesses them.
+      for(unsigned int i=0;i<numberOfInputs;i++)
+        {
+        dataDescription->GetInputDescription(i)->AddProvidedFields();
+        }
       if(!iter->GetPointer()->CoProcess(dataDescription))
         {
         success = 0;
         }
       }
     }
+  for(unsigned int i=0;i<numberOfInputs;i++)
+    {
+    dataDescription->GetInputDescription(i)->RemoveProvidedFields();
+    }
   // we want to reset everything here to make sure that new information
   // is properly passed in the next time.
   dataDescription->ResetAll();
@@ -214,4 +266,5 @@ int vtkCPProcessor::Finalize()
 void vtkCPProcessor::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "TemporalCache: " << this->TemporalCache << "\n";
 }
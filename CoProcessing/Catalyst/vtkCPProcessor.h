@@ -21,6 +21,7 @@
 struct vtkCPProcessorInternals;
 class vtkCPDataDescription;
 class vtkCPPipeline;
+class vtkCPTemporalCache;
 
 /// @defgroup CoProcessing ParaView CoProcessing
 /// The CoProcessing library is designed to be called from parallel 
@@ -74,6 +75,14 @@ public:
   virtual void RemovePipeline(vtkCPPipeline* pipeline);
   virtual void RemoveAllPipelines();
 
+  /// Set the cache of the last time steps of an input, for pipelines
+  /// triggered by an event to process the time steps before it. When its
+  /// NumberOfTimeSteps is not 0, the input is requested at every time step
+  /// and added to the cache before the pipelines run. The pipelines access
+  /// it with vtkCPDataDescription::GetTemporalCache(). NULL by default.
+  virtual void SetTemporalCache(vtkCPTemporalCache* cache);
+  vtkGetObjectMacro(TemporalCache, vtkCPTemporalCache);
+
   /// Initialize the co-processor. Returns 1 if successful and 0
   /// otherwise.
   virtual int Initialize();
@@ -110,6 +119,7 @@ private:
 
   vtkCPProcessorInternals* Internal;
   vtkObject* InitializationHelper;
+  vtkCPTemporalCache* TemporalCache;
 };
 
 #endif
@@ -0,0 +1,624 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkCPTemporalCache.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkCPTemporalCache.h"
+
+#include "vtkBitArray.h"
+#include "vtkCellData.h"
+#include "vtkCommunicator.h"
+#include "vtkCPInputDataDescription.h"
+#include "vtkCompositeDataIterator.h"
+#include "vtkCompositeDataSet.h"
+#include "vtkDataArray.h"
+#include "vtkDataSet.h"
+#include "vtkDataSetAttributes.h"
+#include "vtkFieldData.h"
+#include "vtkMultiProcessController.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkRectilinearGrid.h"
+#include "vtkSmartPointer.h"
+#include "vtkStructuredGrid.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkUnstructuredGrid.h"
+#include "vtkZLibDataCompressor.h"
+
+#include <deque>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace
+{
+  const int vtkCPTemporalCacheAssociations[2] = {
+    vtkDataObject::FIELD_ASSOCIATION_POINTS,
+    vtkDataObject::FIELD_ASSOCIATION_CELLS };
+
+  // Appends the objects holding the points and cells of dataSet. Datasets
+  // without any, such as image data, are not shared between time steps.
+  void vtkCPTemporalCacheGetGeometry(vtkDataSet* dataSet,
+                                     std::vector<vtkObject*>& objects)
+  {
+  if(vtkPolyData* polyData = vtkPolyData::SafeDownCast(dataSet))
+    {
+    objects.push_back(polyData->GetPoints());
+    objects.push_back(polyData->GetVerts());
+    objects.push_back(polyData->GetLines());
+    objects.push_back(polyData->GetPolys());
+    objects.push_back(polyData->GetStrips());
+    }
+  else if(vtkUnstructuredGrid* unstructuredGrid =
+          vtkUnstructuredGrid::SafeDownCast(dataSet))
+    {
+    objects.push_back(unstructuredGrid->GetPoints());
+    objects.push_back(unstructuredGrid->GetCells());
+    objects.push_back(unstructuredGrid->GetCellTypesArray());
+    objects.push_back(unstructuredGrid->GetCellLocationsArray());
+    }
+  else if(vtkStructuredGrid* structuredGrid =
+          vtkStructuredGrid::SafeDownCast(dataSet))
+    {
+    objects.push_back(structuredGrid->GetPoints());
+    }
+  else if(vtkRectilinearGrid* rectilinearGrid =
+          vtkRectilinearGrid::SafeDownCast(dataSet))
+    {
+    objects.push_back(rectilinearGrid->GetXCoordinates());
+    objects.push_back(rectilinearGrid->GetYCoordinates());
+    objects.push_back(rectilinearGrid->GetZCoordinates());
+    }
+  }
+}
+
+class vtkCPTemporalCache::vtkInternals
+{
+public:
+  // A compressed field of a dataset.
+  struct CompressedArray
+    {
+    int Association;
+    int Attribute;
+    std::string Name;
+    int DataType;
+    int NumberOfComponents;
+    vtkIdType NumberOfTuples;
+    size_t Size;
+    vtkSmartPointer<vtkUnsignedCharArray> Data;
+    };
+  typedef std::vector<CompressedArray> CompressedArrays;
+
+  // A cached time step: the grid with the uncompressed fields, and the
+  // compressed fields of each dataset by flat index.
+  struct TimeStep
+    {
+    double Time;
+    vtkIdType Step;
+    vtkSmartPointer<vtkDataObject> Grid;
+    std::map<unsigned int, CompressedArrays> Arrays;
+    unsigned long Size;
+    };
+
+  // The copy of the points and cells of a dataset last cached, with the
+  // objects and modification times they were copied from, so that the time
+  // steps in which they did not change share the copy.
+  struct Geometry
+    {
+    std::vector<vtkObject*> Objects;
+    std::vector<unsigned long> MTimes;
+    vtkSmartPointer<vtkDataSet> Copy;
+    };
+
+  std::set<std::string> PointFields;
+  std::set<std::string> CellFields;
+  std::deque<TimeStep> TimeSteps;
+  // the geometries by flat index.
+  std::map<unsigned int, Geometry> Geometries;
+
+  // The grid last returned by GetCachedGrid(), with decompressed fields.
+  vtkSmartPointer<vtkDataObject> DecompressedGrid;
+
+  vtkSmartPointer<vtkZLibDataCompressor> Compressor;
+
+  bool IsCached(int association, const char* name)
+    {
+    if(this->PointFields.empty() && this->CellFields.empty())
+      {
+      return true;
+      }
+    std::set<std::string>& fields =
+      association == vtkDataObject::FIELD_ASSOCIATION_POINTS ?
+      this->PointFields : this->CellFields;
+    return name && fields.find(name) != fields.end();
+    }
+
+  vtkDataSet* Copy(vtkDataSet* dataSet, unsigned int index, bool compress,
+                   CompressedArrays& arrays, unsigned long& sharedSize);
+  void Decompress(vtkDataSet* dataSet, const CompressedArrays& arrays);
+};
+
+vtkStandardNewMacro(vtkCPTemporalCache);
+vtkCxxSetObjectMacro(vtkCPTemporalCache, Controller, vtkMultiProcessController);
+
+//----------------------------------------------------------------------------
+vtkCPTemporalCache::vtkCPTemporalCache()
+{
+  this->InputName = NULL;
+  this->SetInputName("input");
+  this->NumberOfTimeSteps = 0;
+  this->MemoryLimit = 0;
+  this->Compress = 0;
+  this->Controller = NULL;
+  this->Internals = new vtkInternals;
+  this->Internals->Compressor = vtkSmartPointer<vtkZLibDataCompressor>::New();
+}
+
+//----------------------------------------------------------------------------
+vtkCPTemporalCache::~vtkCPTemporalCache()
+{
+  this->SetInputName(NULL);
+  this->SetController(NULL);
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+void vtkCPTemporalCache::AddPointField(const char* fieldName)
+{
+  if(fieldName)
+    {
+    this->Internals->PointFields.insert(fieldName);
+    this->Modified();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkCPTemporalCache::AddCellField(const char* fieldName)
+{
+  if(fieldName)
+    {
+    this->Internals->CellFields.insert(fieldName);
+    this->Modified();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkCPTemporalCache::RemoveAllFields()
+{
+  this->Internals->PointFields.clear();
+  this->Internals->CellFields.clear();
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+bool vtkCPTemporalCache::IsPointFieldCached(const char* fieldName)
+{
+  return this->Internals->IsCached(
+    vtkDataObject::FIELD_ASSOCIATION_POINTS, fieldName);
+}
+
+//----------------------------------------------------------------------------
+bool vtkCPTemporalCache::IsCellFieldCached(const char* fieldName)
+{
+  return this->Internals->IsCached(
+    vtkDataObject::FIELD_ASSOCIATION_CELLS, fieldName);
+}
+
+//----------------------------------------------------------------------------
+void vtkCPTemporalCache::RequestFields(
+  vtkCPInputDataDescription* inputDescription)
+{
+  if(!inputDescription)
+    {
+    return;
+    }
+  inputDescription->GenerateMeshOn();
+  if(this->Internals->PointFields.empty() &&
+     this->Internals->CellFields.empty())
+    {
+    inputDescription->AllFieldsOn();
+    return;
+    }
+  std::set<std::string>::iterator iter;
+  for(iter=this->Internals->PointFields.begin();
+      iter!=this->Internals->PointFields.end();iter++)
+    {
+    if(!inputDescription->IsFieldNeeded(iter->c_str()))
+      {
+      inputDescription->AddPointField(iter->c_str());
+      }
+    }
+  for(iter=this->Internals->CellFields.begin();
+      iter!=this->Internals->CellFields.end();iter++)
+    {
+    if(!inputDescription->IsFieldNeeded(iter->c_str()))
+      {
+      inputDescription->AddCellField(iter->c_str());
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// Returns a deep copy of dataSet with the cached fields only. When
+// compressing, the data arrays are compressed in arrays instead. The points
+// and cells are shared with the previous copy of the dataset at index if
+// they were not modified since, in which case their size is returned in
+// sharedSize.
+vtkDataSet* vtkCPTemporalCache::vtkInternals::Copy(
+  vtkDataSet* dataSet, unsigned int index, bool compress,
+  CompressedArrays& arrays, unsigned long& sharedSize)
+{
+  // strip a shallow copy so that the input is not modified.
+  vtkSmartPointer<vtkDataSet> stripped;
+  stripped.TakeReference(dataSet->NewInstance());
+  stripped->ShallowCopy(dataSet);
+  for(int i=0;i<2;i++)
+    {
+    int association = vtkCPTemporalCacheAssociations[i];
+    vtkDataSetAttributes* attributes = stripped->GetAttributes(
+      association == vtkDataObject::FIELD_ASSOCIATION_POINTS ?
+      vtkDataObject::POINT : vtkDataObject::CELL);
+    for(int j=attributes->GetNumberOfArrays()-1;j>=0;j--)
+      {
+      vtkAbstractArray* array = attributes->GetAbstractArray(j);
+      if(!this->IsCached(association, array->GetName()))
+        {
+        attributes->RemoveArray(j);
+        continue;
+        }
+      vtkDataArray* dataArray = vtkDataArray::SafeDownCast(array);
+      if(!compress || !dataArray || vtkBitArray::SafeDownCast(dataArray) ||
+         dataArray->GetNumberOfTuples() == 0)
+        {
+        continue;
+        }
+      CompressedArray compressed;
+      compressed.Association = association;
+      compressed.Attribute = attributes->IsArrayAnAttribute(j);
+      compressed.Name = dataArray->GetName() ? dataArray->GetName() : "";
+      compressed.DataType = dataArray->GetDataType();
+      compressed.NumberOfComponents = dataArray->GetNumberOfComponents();
+      compressed.NumberOfTuples = dataArray->GetNumberOfTuples();
+      compressed.Size = static_cast<size_t>(compressed.NumberOfTuples) *
+        compressed.NumberOfComponents * dataArray->GetDataTypeSize();
+      compressed.Data.TakeReference(this->Compressor->Compress(
+          static_cast<unsigned char*>(dataArray->GetVoidPointer(0)),
+          compressed.Size));
+      if(!compressed.Data)
+        {
+        continue;
+        }
+      arrays.push_back(compressed);
+      attributes->RemoveArray(j);
+      }
+    }
+
+  sharedSize = 0;
+  std::vector<vtkObject*> objects;
+  vtkCPTemporalCacheGetGeometry(dataSet, objects);
+  std::vector<unsigned long> mtimes;
+  for(size_t i=0;i<objects.size();i++)
+    {
+    mtimes.push_back(objects[i] ? objects[i]->GetMTime() : 0);
+    }
+  Geometry& geometry = this->Geometries[index];
+  vtkStructuredGrid* structuredGrid = vtkStructuredGrid::SafeDownCast(dataSet);
+  bool shared = !objects.empty() && geometry.Copy &&
+    geometry.Copy->GetDataObjectType() == dataSet->GetDataObjectType() &&
+    geometry.Objects == objects && geometry.MTimes == mtimes;
+  if(shared && structuredGrid)
+    {
+    int dimensions[3];
+    int copyDimensions[3];
+    structuredGrid->GetDimensions(dimensions);
+    vtkStructuredGrid::SafeDownCast(geometry.Copy)->GetDimensions(
+      copyDimensions);
+    shared = dimensions[0] == copyDimensions[0] &&
+      dimensions[1] == copyDimensions[1] && dimensions[2] == copyDimensions[2];
+    }
+  if(!shared)
+    {
+    // deep copy the points and cells only.
+    vtkSmartPointer<vtkDataSet> structure;
+    structure.TakeReference(dataSet->NewInstance());
+    structure->CopyStructure(dataSet);
+    geometry.Copy.TakeReference(dataSet->NewInstance());
+    geometry.Copy->DeepCopy(structure);
+    geometry.Objects = objects;
+    geometry.MTimes = mtimes;
+    }
+  else
+    {
+    sharedSize = geometry.Copy->GetActualMemorySize();
+    }
+
+  vtkDataSet* copy = dataSet->NewInstance();
+  copy->CopyStructure(geometry.Copy);
+  copy->GetPointData()->DeepCopy(stripped->GetPointData());
+  copy->GetCellData()->DeepCopy(stripped->GetCellData());
+  copy->GetFieldData()->DeepCopy(stripped->GetFieldData());
+  if(objects.empty())
+    {
+    // nothing to share with the next time step.
+    geometry.Copy = NULL;
+    }
+  return copy;
+}
+
+//----------------------------------------------------------------------------
+// Adds the decompressed arrays to dataSet.
+void vtkCPTemporalCache::vtkInternals::Decompress(
+  vtkDataSet* dataSet, const CompressedArrays& arrays)
+{
+  for(size_t i=0;i<arrays.size();i++)
+    {
+    const CompressedArray& compressed = arrays[i];
+    vtkSmartPointer<vtkDataArray> array;
+    array.TakeReference(vtkDataArray::CreateDataArray(compressed.DataType));
+    array->SetName(compressed.Name.c_str());
+    array->SetNumberOfComponents(compressed.NumberOfComponents);
+    array->SetNumberOfTuples(compressed.NumberOfTuples);
+    this->Compressor->Uncompress(
+      compressed.Data->GetPointer(0),
+      static_cast<size_t>(compressed.Data->GetNumberOfTuples()),
+      static_cast<unsigned char*>(array->GetVoidPointer(0)), compressed.Size);
+    vtkDataSetAttributes* attributes = dataSet->GetAttributes(
+      compressed.Association == vtkDataObject::FIELD_ASSOCIATION_POINTS ?
+      vtkDataObject::POINT : vtkDataObject::CELL);
+    attributes->AddArray(array);
+    if(compressed.Attribute >= 0)
+      {
+      attributes->SetActiveAttribute(
+        compressed.Name.c_str(), compressed.Attribute);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkCPTemporalCache::AddTimeStep(
+  vtkDataObject* grid, double time, vtkIdType timeStep)
+{
+  if(this->NumberOfTimeSteps == 0)
+    {
+    return 1;
+    }
+  std::deque<vtkInternals::TimeStep>& timeSteps = this->Internals->TimeSteps;
+  this->Internals->DecompressedGrid = NULL;
+
+  // the time step given again, e.g. when the output is forced, replaces
+  // the one cached.
+  if(!timeSteps.empty() && timeSteps.back().Step == timeStep)
+    {
+    timeSteps.pop_back();
+    }
+  // a rank without a grid caches an empty time step, so that all the ranks
+  // cache the same time steps.
+  timeSteps.push_back(vtkInternals::TimeStep());
+  vtkInternals::TimeStep& cached = timeSteps.back();
+  cached.Time = time;
+  cached.Step = timeStep;
+  cached.Size = 0;
+
+  int success = 1;
+  vtkCompositeDataSet* composite = vtkCompositeDataSet::SafeDownCast(grid);
+  if(grid && !vtkDataSet::SafeDownCast(grid) && !composite)
+    {
+    vtkErrorMacro("Cannot cache a grid of type "
+                  << grid->GetClassName() << ".");
+    success = 0;
+    }
+  else if(grid)
+    {
+    unsigned long compressedSize = 0;
+    unsigned long sharedSize = 0;
+    if(composite)
+      {
+      cached.Grid.TakeReference(composite->NewInstance());
+      vtkCompositeDataSet* cachedComposite =
+        vtkCompositeDataSet::SafeDownCast(cached.Grid);
+      cachedComposite->CopyStructure(composite);
+      vtkSmartPointer<vtkCompositeDataIterator> iter;
+      iter.TakeReference(composite->NewIterator());
+      for(iter->InitTraversal();!iter->IsDoneWithTraversal();
+          iter->GoToNextItem())
+        {
+        vtkDataSet* dataSet =
+          vtkDataSet::SafeDownCast(iter->GetCurrentDataObject());
+        if(!dataSet)
+          {
+          continue;
+          }
+        unsigned int index = iter->GetCurrentFlatIndex();
+        unsigned long blockSharedSize = 0;
+        vtkDataSet* copy = this->Internals->Copy(
+          dataSet, index, this->Compress != 0, cached.Arrays[index],
+          blockSharedSize);
+        sharedSize += blockSharedSize;
+        cachedComposite->SetDataSet(iter, copy);
+        copy->Delete();
+        }
+      }
+    else
+      {
+      cached.Grid.TakeReference(this->Internals->Copy(
+          vtkDataSet::SafeDownCast(grid), 0, this->Compress != 0,
+          cached.Arrays[0], sharedSize));
+      }
+    for(std::map<unsigned int, vtkInternals::CompressedArrays>::iterator
+          iter=cached.Arrays.begin();iter!=cached.Arrays.end();iter++)
+      {
+      for(size_t i=0;i<iter->second.size();i++)
+        {
+        compressedSize += static_cast<unsigned long>(
+          iter->second[i].Data->GetActualMemorySize());
+        }
+      }
+    // the shared points and cells are counted in the time step that copied
+    // them.
+    unsigned long gridSize = cached.Grid->GetActualMemorySize();
+    cached.Size = (gridSize > sharedSize ? gridSize - sharedSize : 0) +
+      compressedSize;
+    }
+
+  while(static_cast<int>(timeSteps.size()) > this->NumberOfTimeSteps)
+    {
+    timeSteps.pop_front();
+    }
+
+  if(this->MemoryLimit > 0)
+    {
+    // the number of oldest time steps to remove to fit in the limit.
+    int numberToRemove = 0;
+    unsigned long size = this->GetActualMemorySize();
+    while(size > this->MemoryLimit &&
+          numberToRemove + 1 < static_cast<int>(timeSteps.size()))
+      {
+      size -= timeSteps[numberToRemove].Size;
+      numberToRemove++;
+      }
+    vtkMultiProcessController* controller = this->Controller ?
+      this->Controller : vtkMultiProcessController::GetGlobalController();
+    if(controller && controller->GetNumberOfProcesses() > 1)
+      {
+      int localNumberToRemove = numberToRemove;
+      controller->AllReduce(&localNumberToRemove, &numberToRemove, 1,
+                            vtkCommunicator::MAX_OP);
+      }
+    for(int i=0;i<numberToRemove && timeSteps.size() > 1;i++)
+      {
+      timeSteps.pop_front();
+      }
+    }
+  return success;
+}
+
+//----------------------------------------------------------------------------
+void vtkCPTemporalCache::Clear()
+{
+  this->Internals->TimeSteps.clear();
+  this->Internals->Geometries.clear();
+  this->Internals->DecompressedGrid = NULL;
+}
+
+//----------------------------------------------------------------------------
+int vtkCPTemporalCache::GetNumberOfCachedTimeSteps()
+{
+  return static_cast<int>(this->Internals->TimeSteps.size());
+}
+
+//----------------------------------------------------------------------------
+double vtkCPTemporalCache::GetCachedTime(int index)
+{
+  if(index < 0 || index >= this->GetNumberOfCachedTimeSteps())
+    {
+    vtkErrorMacro("Bad time step index " << index << ".");
+    return 0;
+    }
+  return this->Internals->TimeSteps[index].Time;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCPTemporalCache::GetCachedTimeStep(int index)
+{
+  if(index < 0 || index >= this->GetNumberOfCachedTimeSteps())
+    {
+    vtkErrorMacro("Bad time step index " << index << ".");
+    return 0;
+    }
+  return this->Internals->TimeSteps[index].Step;
+}
+
+//----------------------------------------------------------------------------
+vtkDataObject* vtkCPTemporalCache::GetCachedGrid(int index)
+{
+  if(index < 0 || index >= this->GetNumberOfCachedTimeSteps())
+    {
+    vtkErrorMacro("Bad time step index " << index << ".");
+    return NULL;
+    }
+  vtkInternals::TimeStep& cached = this->Internals->TimeSteps[index];
+  if(!cached.Grid)
+    {
+    return NULL;
+    }
+  bool compressed = false;
+  for(std::map<unsigned int, vtkInternals::CompressedArrays>::iterator
+        iter=cached.Arrays.begin();iter!=cached.Arrays.end();iter++)
+    {
+    compressed = compressed || !iter->second.empty();
+    }
+  if(!compressed)
+    {
+    return cached.Grid;
+    }
+
+  // decompress in shallow copies of the cached datasets.
+  vtkSmartPointer<vtkDataObject>& output = this->Internals->DecompressedGrid;
+  output.TakeReference(cached.Grid->NewInstance());
+  vtkCompositeDataSet* composite =
+    vtkCompositeDataSet::SafeDownCast(cached.Grid);
+  if(!composite)
+    {
+    output->ShallowCopy(cached.Grid);
+    this->Internals->Decompress(
+      vtkDataSet::SafeDownCast(output), cached.Arrays[0]);
+    return output;
+    }
+  vtkCompositeDataSet* outputComposite =
+    vtkCompositeDataSet::SafeDownCast(output);
+  outputComposite->CopyStructure(composite);
+  vtkSmartPointer<vtkCompositeDataIterator> iter;
+  iter.TakeReference(composite->NewIterator());
+  for(iter->InitTraversal();!iter->IsDoneWithTraversal();iter->GoToNextItem())
+    {
+    vtkDataSet* dataSet =
+      vtkDataSet::SafeDownCast(iter->GetCurrentDataObject());
+    if(!dataSet)
+      {
+      continue;
+      }
+    vtkSmartPointer<vtkDataSet> copy;
+    copy.TakeReference(dataSet->NewInstance());
+    copy->ShallowCopy(dataSet);
+    this->Internals->Decompress(
+      copy, cached.Arrays[iter->GetCurrentFlatIndex()]);
+    outputComposite->SetDataSet(iter, copy);
+    }
+  return output;
+}
+
+//----------------------------------------------------------------------------
+unsigned long vtkCPTemporalCache::GetActualMemorySize()
+{
+  unsigned long size = 0;
+  for(size_t i=0;i<this->Internals->TimeSteps.size();i++)
+    {
+    size += this->Internals->TimeSteps[i].Size;
+    }
+  return size;
+}
+
+//----------------------------------------------------------------------------
+void vtkCPTemporalCache::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "InputName: "
+     << (this->InputName ? this->InputName : "(NULL)") << "\n";
+  os << indent << "NumberOfTimeSteps: " << this->NumberOfTimeSteps << "\n";
+  os << indent << "MemoryLimit: " << this->MemoryLimit << "\n";
+  os << indent << "Compress: " << this->Compress << "\n";
+  os << indent << "Controller: " << this->Controller << "\n";
+  os << indent << "NumberOfCachedTimeSteps: "
+     << this->GetNumberOfCachedTimeSteps() << "\n";
+}
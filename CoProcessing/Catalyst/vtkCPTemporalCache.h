@@ -0,0 +1,131 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkCPTemporalCache.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#ifndef vtkCPTemporalCache_h
+#define vtkCPTemporalCache_h
+
+#include "vtkObject.h"
+#include "vtkPVCatalystModule.h" // For windows import/export of shared libraries
+
+class vtkCPInputDataDescription;
+class vtkDataObject;
+class vtkMultiProcessController;
+
+/// @ingroup CoProcessing
+/// A ring buffer of the last time steps of a simulation input, so that
+/// pipelines triggered by an event can process or write the time steps
+/// that preceded it.
+///
+/// When set on vtkCPProcessor, the input named InputName is requested at
+/// every time step, with the selected fields, and a copy of it is added to
+/// the cache before the pipelines run. The pipelines access the cache with
+/// vtkCPDataDescription::GetTemporalCache(); the current time step is the
+/// last one cached.
+///
+/// The points and cells of a dataset are only copied again when they were
+/// modified, or replaced, since the previous time step: otherwise the time
+/// steps share them.
+///
+/// The fields can be compressed with zlib, and the oldest time steps are
+/// removed when the cache holds more than NumberOfTimeSteps time steps or
+/// uses more than MemoryLimit. The time steps removed because of the memory
+/// limit are agreed upon by all the ranks, so that every rank caches the
+/// same time steps.
+class VTKPVCATALYST_EXPORT vtkCPTemporalCache : public vtkObject
+{
+public:
+  static vtkCPTemporalCache* New();
+  vtkTypeMacro(vtkCPTemporalCache, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  /// Name of the input to cache. "input" by default.
+  vtkSetStringMacro(InputName);
+  vtkGetStringMacro(InputName);
+
+  /// Add a point or cell field to cache. All the fields are cached if
+  /// none is added.
+  void AddPointField(const char* fieldName);
+  void AddCellField(const char* fieldName);
+  void RemoveAllFields();
+
+  /// Returns true if the point or cell field is cached.
+  bool IsPointFieldCached(const char* fieldName);
+  bool IsCellFieldCached(const char* fieldName);
+
+  /// The maximum number of time steps kept, or 0 to turn the cache
+  /// off. 0 by default.
+  vtkSetClampMacro(NumberOfTimeSteps, int, 0, VTK_INT_MAX);
+  vtkGetMacro(NumberOfTimeSteps, int);
+
+  /// The maximum memory used by the cache on a rank, in kibibytes, or 0 for
+  /// no limit. The last time step is kept even if it uses more. 0 by
+  /// default.
+  vtkSetMacro(MemoryLimit, unsigned long);
+  vtkGetMacro(MemoryLimit, unsigned long);
+
+  /// When on, the fields are compressed with zlib. Off by default.
+  vtkSetMacro(Compress, int);
+  vtkGetMacro(Compress, int);
+  vtkBooleanMacro(Compress, int);
+
+  /// The controller used to agree on the time steps to remove because of
+  /// the memory limit. The global controller is used if it is NULL.
+  void SetController(vtkMultiProcessController* controller);
+  vtkGetObjectMacro(Controller, vtkMultiProcessController);
+
+  /// Mark the mesh and the cached fields as needed in inputDescription.
+  void RequestFields(vtkCPInputDataDescription* inputDescription);
+
+  /// Add a copy of grid, with the selected fields only, for the given time.
+  /// grid is NULL on the ranks without a grid at this time step, which
+  /// then cache an empty time step. When MemoryLimit is set, it must be
+  /// called on all the ranks. Returns 1 if successful and 0 otherwise.
+  int AddTimeStep(vtkDataObject* grid, double time, vtkIdType timeStep);
+
+  /// Remove all the time steps.
+  void Clear();
+
+  /// The number of time steps in the cache, from the oldest (0) to the
+  /// newest.
+  int GetNumberOfCachedTimeSteps();
+  double GetCachedTime(int index);
+  vtkIdType GetCachedTimeStep(int index);
+
+  /// Returns the grid of the time step at the given index, or NULL if the
+  /// rank had no grid at that time step. It is valid until the next call
+  /// to GetCachedGrid() or AddTimeStep(), and must not be modified.
+  vtkDataObject* GetCachedGrid(int index);
+
+  /// Returns the memory used by the cache, in kibibytes.
+  unsigned long GetActualMemorySize();
+
+protected:
+  vtkCPTemporalCache();
+  virtual ~vtkCPTemporalCache();
+
+  char* InputName;
+  int NumberOfTimeSteps;
+  unsigned long MemoryLimit;
+  int Compress;
+  vtkMultiProcessController* Controller;
+
+private:
+  vtkCPTemporalCache(const vtkCPTemporalCache&); // Not implemented
+  void operator=(const vtkCPTemporalCache&); // Not implemented
+
+  class vtkInternals;
+  vtkInternals* Internals;
+};
+
+#endif
@@ -0,0 +1,663 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    BenchmarkCatalyst.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Measures the overhead of Catalyst for every combination of grid type,
+// grid size, pipeline and output frequency, with the grid builders of the
+// test driver standing in for the simulation, and writes the results as
+// JSON so that they can be compared between ParaView versions.
+//
+// Each rank builds a grid of size^3 points. The pipelines are coprocessing
+// scripts written to --directory:
+//  slice    updates a slice through the center of the grid
+//  contour  updates a contour of the Pressure at the middle of its range
+//  image    renders the slice and writes it as a PNG image
+//  writer   writes the slice with the parallel XML polydata writer
+// which output every frequency time steps.
+//
+// For each time step, the time taken by the adaptor (building the grid and
+// its fields), by vtkCPProcessor::RequestDataDescription() and by
+// vtkCPProcessor::CoProcess() is the maximum over the ranks. The I/O time,
+// measured by the scripts around WriteData() and WriteImages(), is part of
+// the CoProcess() time. The peak memory is the largest memory used by a
+// rank after any time step. The number of ranks is the one the benchmark
+// is run with. Fails if a script did not coprocess the expected time steps.
+//
+// Usage:
+//  BenchmarkCatalyst [--steps N] [--grids uniform,unstructured,multiblock]
+//    [--sizes N,...] [--pipelines slice,contour,image,writer]
+//    [--frequencies N,...] [--directory path] [--output file.json]
+
+#include "vtkCellType.h"
+#include "vtkCommunicator.h"
+#include "vtkCPBaseGridBuilder.h"
+#include "vtkCPDataDescription.h"
+#include "vtkCPInputDataDescription.h"
+#include "vtkCPLinearScalarFieldFunction.h"
+#include "vtkCPMultiBlockGridBuilder.h"
+#include "vtkCPNodalFieldBuilder.h"
+#include "vtkCPProcessor.h"
+#include "vtkCPPythonScriptPipeline.h"
+#include "vtkCPUniformGridBuilder.h"
+#include "vtkCPUnstructuredGridBuilder.h"
+#include "vtkDataSet.h"
+#include "vtkDoubleArray.h"
+#include "vtkFieldData.h"
+#include "vtkImageData.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkMultiProcessController.h"
+#include "vtkPoints.h"
+#include "vtkPythonInterpreter.h"
+#include "vtkSmartPointer.h"
+#include "vtkTimerLog.h"
+
+#include "vtkPVConfig.h"
+#ifdef PARAVIEW_USE_MPI
+# define MPICH_SKIP_MPICXX
+# include "vtkMPI.h"
+#endif
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <vtksys/ios/fstream>
+#include <vtksys/ios/sstream>
+#include <vtksys/SystemInformation.hxx>
+
+namespace
+{
+  // The timings of a time step, in seconds.
+  enum
+    {
+    ADAPTOR = 0,
+    REQUEST_DATA_DESCRIPTION,
+    COPROCESS,
+    IO,
+    NUMBER_OF_TIMINGS
+    };
+  const char* TimingNames[NUMBER_OF_TIMINGS] =
+    { "adaptor", "request_data_description", "coprocess", "io" };
+
+  // Splits a comma separated list.
+  std::vector<std::string> Split(const char* list)
+    {
+    std::vector<std::string> values;
+    std::string value;
+    vtksys_ios::istringstream stream(list);
+    while (std::getline(stream, value, ','))
+      {
+      if (!value.empty())
+        {
+        values.push_back(value);
+        }
+      }
+    return values;
+    }
+
+  std::vector<int> SplitIntegers(const char* list)
+    {
+    std::vector<std::string> values = Split(list);
+    std::vector<int> integers;
+    for (size_t cc=0; cc < values.size(); cc++)
+      {
+      integers.push_back(atoi(values[cc].c_str()));
+      }
+    return integers;
+    }
+
+  bool Contains(const char* const* names, const std::string& name)
+    {
+    for (; *names; names++)
+      {
+      if (name == *names)
+        {
+        return true;
+        }
+      }
+    return false;
+    }
+
+  // Returns a field builder for the nodal Pressure field of
+  // vtkPVCustomTestDriver.
+  vtkCPNodalFieldBuilder* NewFieldBuilder()
+    {
+    vtkCPLinearScalarFieldFunction* fieldFunction =
+      vtkCPLinearScalarFieldFunction::New();
+    fieldFunction->SetConstant(2.);
+    fieldFunction->SetTimeMultiplier(100);
+    fieldFunction->SetXMultiplier(23.);
+    fieldFunction->SetYMultiplier(15.);
+    fieldFunction->SetZMultiplier(8.);
+    vtkCPNodalFieldBuilder* fieldBuilder = vtkCPNodalFieldBuilder::New();
+    fieldBuilder->SetArrayName("Pressure");
+    fieldBuilder->SetTensorFieldFunction(fieldFunction);
+    fieldFunction->Delete();
+    return fieldBuilder;
+    }
+
+  vtkCPUniformGridBuilder* NewUniformGridBuilder(
+    int dimensions[3], double origin[3])
+    {
+    vtkCPUniformGridBuilder* gridBuilder = vtkCPUniformGridBuilder::New();
+    gridBuilder->SetDimensions(dimensions);
+    double spacing[3] = {1, 1, 1};
+    gridBuilder->SetSpacing(spacing);
+    gridBuilder->SetOrigin(origin);
+    vtkCPNodalFieldBuilder* fieldBuilder = NewFieldBuilder();
+    gridBuilder->SetFieldBuilder(fieldBuilder);
+    fieldBuilder->Delete();
+    return gridBuilder;
+    }
+
+  // Returns a builder for a grid of size^3 points, of the given type, next
+  // to the grids of the other ranks along x.
+  vtkCPBaseGridBuilder* NewGridBuilder(
+    const std::string& type, int size, int rank)
+    {
+    double origin[3] = {static_cast<double>(rank * (size - 1)), 0, 0};
+    if (type == "uniform")
+      {
+      int dimensions[3] = {size, size, size};
+      return NewUniformGridBuilder(dimensions, origin);
+      }
+    if (type == "multiblock")
+      {
+      // two blocks on top of each other.
+      vtkCPMultiBlockGridBuilder* gridBuilder =
+        vtkCPMultiBlockGridBuilder::New();
+      int dimensions[3] = {size, size, size / 2};
+      for (int cc=0; cc < 2; cc++)
+        {
+        vtkCPUniformGridBuilder* blockBuilder =
+          NewUniformGridBuilder(dimensions, origin);
+        gridBuilder->AddGridBuilder(blockBuilder);
+        blockBuilder->Delete();
+        origin[2] += size / 2 - 1;
+        }
+      return gridBuilder;
+      }
+
+    // hexahedra between the points of the uniform grid.
+    vtkCPUnstructuredGridBuilder* gridBuilder =
+      vtkCPUnstructuredGridBuilder::New();
+    vtkPoints* points = vtkPoints::New();
+    points->SetNumberOfPoints(size * size * size);
+    vtkIdType id = 0;
+    for (int k=0; k < size; k++)
+      {
+      for (int j=0; j < size; j++)
+        {
+        for (int i=0; i < size; i++)
+          {
+          points->SetPoint(id++, origin[0] + i, j, k);
+          }
+        }
+      }
+    gridBuilder->SetPoints(points);
+    points->Delete();
+    gridBuilder->Allocate((size - 1) * (size - 1) * (size - 1));
+    for (int k=0; k < size - 1; k++)
+      {
+      for (int j=0; j < size - 1; j++)
+        {
+        for (int i=0; i < size - 1; i++)
+          {
+          vtkIdType first = i + size * (j + size * k);
+          vtkIdType hexahedron[8] = {first, first + 1, first + 1 + size,
+            first + size, first + size * size, first + 1 + size * size,
+            first + 1 + size + size * size, first + size + size * size};
+          gridBuilder->InsertNextCell(VTK_HEXAHEDRON, 8, hexahedron);
+          }
+        }
+      }
+    vtkCPNodalFieldBuilder* fieldBuilder = NewFieldBuilder();
+    gridBuilder->SetFieldBuilder(fieldBuilder);
+    fieldBuilder->Delete();
+    return gridBuilder;
+    }
+
+  // Writes the coprocessing script moduleName.py of the given pipeline. The
+  // script stores the time taken by its I/O in the IOTime array of the user
+  // data, and deletes its proxies when Finalize() is called. Only the first
+  // rank writes it: the others wait for it in the barrier of the caller.
+  std::string WriteScript(const std::string& directory,
+    const std::string& moduleName, const std::string& pipeline,
+    int frequency, int rank)
+    {
+    std::string fileName = directory + "/" + moduleName + ".py";
+    if (rank != 0)
+      {
+      return fileName;
+      }
+    std::string outputName = directory + "/" + moduleName + "_%t";
+    vtksys_ios::ofstream script(fileName.c_str());
+    script
+      << "import time\n"
+      << "from paraview import coprocessing\n"
+      << "from paraview import servermanager\n"
+      << "from paraview import simple\n"
+      << "class CoProcessor(coprocessing.CoProcessor):\n"
+      << "  def CreatePipeline(self, datadescription):\n"
+      << "    input = self.CreateProducer(datadescription, 'input')\n";
+    if (pipeline == "contour")
+      {
+      script
+        << "    pressure = input.PointData['Pressure'].GetRange()\n"
+        << "    self.Filter = simple.Contour(Input=input,\n"
+        << "      ContourBy=['POINTS', 'Pressure'],\n"
+        << "      Isosurfaces=[0.5 * (pressure[0] + pressure[1])])\n";
+      }
+    else
+      {
+      script
+        << "    bounds = input.GetDataInformation().GetBounds()\n"
+        << "    self.Filter = simple.Slice(Input=input)\n"
+        << "    self.Filter.SliceType.Origin = [0.5 * (bounds[0] + bounds[1]),\n"
+        << "      0.5 * (bounds[2] + bounds[3]), 0.5 * (bounds[4] + bounds[5])]\n"
+        << "    self.Filter.SliceType.Normal = [0, 0, 1]\n";
+      }
+    if (pipeline == "image")
+      {
+      script
+        << "    view = self.CreateView(simple.CreateRenderView, r'"
+        << outputName << ".png', " << frequency << ", 1, 1, 400, 400)\n"
+        << "    simple.Show(self.Filter, view)\n";
+      }
+    else if (pipeline == "writer")
+      {
+      script
+        << "    simple.SetActiveSource(self.Filter)\n"
+        << "    self.CreateWriter(simple.XMLPPolyDataWriter, r'"
+        << outputName << ".pvtp', " << frequency << ")\n";
+      }
+    script
+      << "coprocessor = CoProcessor()\n"
+      << "coprocessor.SetUpdateFrequencies({'input': [" << frequency << "]})\n"
+      << "def GetUpdateFrequencies():\n"
+      << "  return coprocessor.GetUpdateFrequencies()\n"
+      << "def RequestDataDescription(datadescription):\n"
+      << "  coprocessor.LoadRequestedData(datadescription)\n"
+      << "def DoCoProcessing(datadescription):\n"
+      << "  coprocessor.UpdateProducers(datadescription)\n"
+      << "  coprocessor.Filter.UpdatePipeline(datadescription.GetTime())\n"
+      << "  start = time.time()\n"
+      << "  coprocessor.WriteData(datadescription)\n"
+      << "  coprocessor.WriteImages(datadescription)\n"
+      << "  datadescription.GetUserData().GetArray('IOTime').SetValue(0,\n"
+      << "    time.time() - start)\n"
+      << "def NextProxyToDelete():\n"
+      << "  iter = servermanager.vtkSMProxyIterator()\n"
+      << "  iter.SetSession(servermanager.ActiveConnection.Session)\n"
+      << "  iter.Begin()\n"
+      << "  while not iter.IsAtEnd():\n"
+      << "    group = iter.GetGroup()\n"
+      << "    proxy = servermanager._getPyProxy(iter.GetProxy())\n"
+      << "    iter.Next()\n"
+      << "    if proxy != None and group.find('prototypes') == -1 and \\\n"
+      << "      group != 'timekeeper' and group.find('pq_helper_proxies') == -1:\n"
+      << "      return proxy\n"
+      << "  return None\n"
+      << "def Finalize():\n"
+      << "  global coprocessor\n"
+      << "  coprocessor = None\n"
+      << "  proxy = NextProxyToDelete()\n"
+      << "  while proxy != None:\n"
+      << "    simple.Delete(proxy)\n"
+      << "    proxy = NextProxyToDelete()\n";
+    return fileName;
+    }
+
+  // The results of a configuration.
+  struct Run
+    {
+    std::string Grid;
+    int Size;
+    std::string Pipeline;
+    int Frequency;
+    vtkIdType NumberOfPoints;
+    vtkIdType NumberOfCells;
+    int NumberOfOutputs;
+    double PeakMemory;
+    // NUMBER_OF_TIMINGS values per time step.
+    std::vector<double> Timings;
+    };
+
+  // Runs processor with the script of the given pipeline for numberOfSteps
+  // time steps and returns false if it failed.
+  bool RunConfiguration(vtkCPProcessor* processor, Run& run,
+    int numberOfSteps, const std::string& directory)
+    {
+    vtkMultiProcessController* controller =
+      vtkMultiProcessController::GetGlobalController();
+    int rank = controller->GetLocalProcessId();
+
+    vtksys_ios::ostringstream moduleName;
+    moduleName << "BenchmarkCatalyst_" << run.Grid << "_" << run.Size << "_"
+               << run.Pipeline << "_" << run.Frequency;
+    std::string fileName = WriteScript(directory, moduleName.str(),
+      run.Pipeline, run.Frequency, rank);
+    // no rank imports the script before it is completely written.
+    controller->Barrier();
+    vtkSmartPointer<vtkCPPythonScriptPipeline> pipeline =
+      vtkSmartPointer<vtkCPPythonScriptPipeline>::New();
+    if (!pipeline->Initialize(fileName.c_str()))
+      {
+      return false;
+      }
+    processor->AddPipeline(pipeline);
+
+    vtkSmartPointer<vtkCPBaseGridBuilder> gridBuilder;
+    gridBuilder.TakeReference(NewGridBuilder(run.Grid, run.Size, rank));
+    vtkSmartPointer<vtkDoubleArray> ioTime =
+      vtkSmartPointer<vtkDoubleArray>::New();
+    ioTime->SetName("IOTime");
+    ioTime->SetNumberOfTuples(1);
+    vtkSmartPointer<vtkFieldData> userData =
+      vtkSmartPointer<vtkFieldData>::New();
+    userData->AddArray(ioTime);
+
+    vtkSmartPointer<vtkTimerLog> timer = vtkSmartPointer<vtkTimerLog>::New();
+    vtksys::SystemInformation systemInformation;
+    std::vector<double> timings(NUMBER_OF_TIMINGS * numberOfSteps, 0.);
+    double peakMemory = 0;
+    int numberOfOutputs = 0;
+    vtkIdType numberOfPoints = 0;
+    vtkIdType numberOfCells = 0;
+    bool success = true;
+    for (int step=0; step < numberOfSteps; step++)
+      {
+      double* stepTimings = &timings[NUMBER_OF_TIMINGS * step];
+      vtkSmartPointer<vtkCPDataDescription> dataDescription =
+        vtkSmartPointer<vtkCPDataDescription>::New();
+      double time = static_cast<double>(step) / numberOfSteps;
+      dataDescription->SetTimeData(time, step);
+      dataDescription->AddInput("input");
+      dataDescription->SetUserData(userData);
+
+      timer->StartTimer();
+      int doCoProcessing = processor->RequestDataDescription(dataDescription);
+      timer->StopTimer();
+      stepTimings[REQUEST_DATA_DESCRIPTION] = timer->GetElapsedTime();
+
+      if (doCoProcessing)
+        {
+        timer->StartTimer();
+        vtkCPInputDataDescription* inputDescription =
+          dataDescription->GetInputDescriptionByName("input");
+        int builtNewGrid = 0;
+        vtkDataObject* grid = gridBuilder->GetGrid(step, time, builtNewGrid);
+        inputDescription->SetGrid(grid);
+        int extent[6] = {0, 0, 0, 0, 0, 0};
+        if (vtkImageData* image = vtkImageData::SafeDownCast(grid))
+          {
+          image->GetExtent(extent);
+          }
+        for (int cc=0; cc < 3; cc++)
+          {
+          extent[2*cc] = -extent[2*cc];
+          }
+        int wholeExtent[6];
+        controller->AllReduce(extent, wholeExtent, 6, vtkCommunicator::MAX_OP);
+        for (int cc=0; cc < 3; cc++)
+          {
+          wholeExtent[2*cc] = -wholeExtent[2*cc];
+          }
+        inputDescription->SetWholeExtent(wholeExtent);
+        timer->StopTimer();
+        stepTimings[ADAPTOR] = timer->GetElapsedTime();
+
+        if (vtkDataSet* dataSet = vtkDataSet::SafeDownCast(grid))
+          {
+          numberOfPoints = dataSet->GetNumberOfPoints();
+          numberOfCells = dataSet->GetNumberOfCells();
+          }
+        else if (vtkMultiBlockDataSet* multiBlock =
+          vtkMultiBlockDataSet::SafeDownCast(grid))
+          {
+          numberOfPoints = multiBlock->GetNumberOfPoints();
+          numberOfCells = 0;
+          for (unsigned int cc=0; cc < multiBlock->GetNumberOfBlocks(); cc++)
+            {
+            if (vtkDataSet* block =
+              vtkDataSet::SafeDownCast(multiBlock->GetBlock(cc)))
+              {
+              numberOfCells += block->GetNumberOfCells();
+              }
+            }
+          }
+
+        ioTime->SetValue(0, -1);
+        timer->StartTimer();
+        if (!processor->CoProcess(dataDescription))
+          {
+          success = false;
+          }
+        timer->StopTimer();
+        stepTimings[COPROCESS] = timer->GetElapsedTime();
+        if (ioTime->GetValue(0) >= 0)
+          {
+          stepTimings[IO] = ioTime->GetValue(0);
+          numberOfOutputs++;
+          }
+        }
+      peakMemory = std::max(peakMemory,
+        static_cast<double>(systemInformation.GetProcMemoryUsed()));
+      }
+
+    processor->RemovePipeline(pipeline);
+    vtksys_ios::ostringstream finalize;
+    finalize << "import " << moduleName.str() << "\n"
+             << moduleName.str() << ".Finalize()\n";
+    vtkPythonInterpreter::RunSimpleString(finalize.str().c_str());
+
+    // the slowest rank gives the time of a step.
+    run.Timings.resize(timings.size());
+    controller->Reduce(&timings[0], &run.Timings[0],
+      static_cast<vtkIdType>(timings.size()), vtkCommunicator::MAX_OP, 0);
+    controller->Reduce(&peakMemory, &run.PeakMemory, 1,
+      vtkCommunicator::MAX_OP, 0);
+    double localCounts[2] = {static_cast<double>(numberOfPoints),
+      static_cast<double>(numberOfCells)};
+    double counts[2] = {0, 0};
+    controller->Reduce(localCounts, counts, 2, vtkCommunicator::SUM_OP, 0);
+    run.NumberOfPoints = static_cast<vtkIdType>(counts[0]);
+    run.NumberOfCells = static_cast<vtkIdType>(counts[1]);
+    run.NumberOfOutputs = numberOfOutputs;
+
+    int expectedOutputs = (numberOfSteps + run.Frequency - 1) / run.Frequency;
+    int localFailure = (success && numberOfOutputs == expectedOutputs)? 0 : 1;
+    int failure = 0;
+    controller->AllReduce(&localFailure, &failure, 1, vtkCommunicator::MAX_OP);
+    return failure == 0;
+    }
+
+  void WriteResults(ostream& os, const std::vector<Run>& runs,
+    int numberOfRanks, int numberOfSteps)
+    {
+    os << "{\n"
+       << "  \"paraview_version\": \"" << PARAVIEW_VERSION_FULL << "\",\n"
+       << "  \"ranks\": " << numberOfRanks << ",\n"
+       << "  \"steps\": " << numberOfSteps << ",\n"
+       << "  \"runs\": [";
+    for (size_t cc=0; cc < runs.size(); cc++)
+      {
+      const Run& run = runs[cc];
+      os << (cc? "," : "") << "\n    {\n"
+         << "      \"grid\": \"" << run.Grid << "\",\n"
+         << "      \"size\": " << run.Size << ",\n"
+         << "      \"points\": " << run.NumberOfPoints << ",\n"
+         << "      \"cells\": " << run.NumberOfCells << ",\n"
+         << "      \"pipeline\": \"" << run.Pipeline << "\",\n"
+         << "      \"frequency\": " << run.Frequency << ",\n"
+         << "      \"outputs\": " << run.NumberOfOutputs << ",\n"
+         << "      \"peak_memory_kib\": " << run.PeakMemory << ",\n";
+      for (int timing=0; timing < NUMBER_OF_TIMINGS; timing++)
+        {
+        double total = 0;
+        double maximum = 0;
+        for (int step=0; step < numberOfSteps; step++)
+          {
+          double value = run.Timings[NUMBER_OF_TIMINGS * step + timing];
+          total += value;
+          maximum = std::max(maximum, value);
+          }
+        os << "      \"" << TimingNames[timing] << "\": {\"total\": "
+           << total << ", \"mean\": " << total / numberOfSteps
+           << ", \"max\": " << maximum << "},\n";
+        }
+      os << "      \"per_step\": [";
+      for (int step=0; step < numberOfSteps; step++)
+        {
+        os << (step? "," : "") << "\n        {\"step\": " << step;
+        for (int timing=0; timing < NUMBER_OF_TIMINGS; timing++)
+          {
+          os << ", \"" << TimingNames[timing] << "\": "
+             << run.Timings[NUMBER_OF_TIMINGS * step + timing];
+          }
+        os << "}";
+        }
+      os << "\n      ]\n    }";
+      }
+    os << "\n  ]\n}\n";
+    }
+}
+
+//----------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+  int numberOfSteps = 10;
+  std::vector<std::string> grids = Split("uniform,unstructured,multiblock");
+  std::vector<int> sizes = SplitIntegers("32,64");
+  std::vector<std::string> pipelines = Split("slice,contour,image,writer");
+  std::vector<int> frequencies = SplitIntegers("1,5");
+  std::string directory = ".";
+  std::string output = "BenchmarkCatalyst.json";
+  for (int cc=1; cc < argc; cc++)
+    {
+    if (strcmp(argv[cc], "--steps") == 0 && cc+1 < argc)
+      {
+      numberOfSteps = atoi(argv[++cc]);
+      }
+    else if (strcmp(argv[cc], "--grids") == 0 && cc+1 < argc)
+      {
+      grids = Split(argv[++cc]);
+      }
+    else if (strcmp(argv[cc], "--sizes") == 0 && cc+1 < argc)
+      {
+      sizes = SplitIntegers(argv[++cc]);
+      }
+    else if (strcmp(argv[cc], "--pipelines") == 0 && cc+1 < argc)
+      {
+      pipelines = Split(argv[++cc]);
+      }
+    else if (strcmp(argv[cc], "--frequencies") == 0 && cc+1 < argc)
+      {
+      frequencies = SplitIntegers(argv[++cc]);
+      }
+    else if (strcmp(argv[cc], "--directory") == 0 && cc+1 < argc)
+      {
+      directory = argv[++cc];
+      }
+    else if (strcmp(argv[cc], "--output") == 0 && cc+1 < argc)
+      {
+      output = argv[++cc];
+      }
+    }
+
+  const char* gridTypes[] = {"uniform", "unstructured", "multiblock", 0};
+  const char* pipelineTypes[] = {"slice", "contour", "image", "writer", 0};
+  bool valid = numberOfSteps > 0;
+  for (size_t cc=0; cc < grids.size(); cc++)
+    {
+    valid = valid && Contains(gridTypes, grids[cc]);
+    }
+  for (size_t cc=0; cc < sizes.size(); cc++)
+    {
+    valid = valid && sizes[cc] >= 4;
+    }
+  for (size_t cc=0; cc < pipelines.size(); cc++)
+    {
+    valid = valid && Contains(pipelineTypes, pipelines[cc]);
+    }
+  for (size_t cc=0; cc < frequencies.size(); cc++)
+    {
+    valid = valid && frequencies[cc] > 0;
+    }
+  if (!valid)
+    {
+    cerr << "ERROR: bad arguments. --steps and --frequencies must be "
+         << "positive and --sizes at least 4." << endl;
+    return EXIT_FAILURE;
+    }
+#ifdef PARAVIEW_USE_MPI
+  MPI_Init(&argc, &argv);
+#endif
+
+  int return_value = EXIT_SUCCESS;
+  vtkCPProcessor* processor = vtkCPProcessor::New();
+  processor->Initialize();
+  vtkMultiProcessController* controller =
+    vtkMultiProcessController::GetGlobalController();
+  std::vector<Run> runs;
+  for (size_t grid=0; grid < grids.size(); grid++)
+    {
+    for (size_t size=0; size < sizes.size(); size++)
+      {
+      for (size_t pipeline=0; pipeline < pipelines.size(); pipeline++)
+        {
+        for (size_t frequency=0; frequency < frequencies.size(); frequency++)
+          {
+          Run run;
+          run.Grid = grids[grid];
+          run.Size = sizes[size];
+          run.Pipeline = pipelines[pipeline];
+          run.Frequency = frequencies[frequency];
+          if (!RunConfiguration(processor, run, numberOfSteps, directory))
+            {
+            cerr << "ERROR: " << run.Pipeline << " pipeline failed for the "
+                 << run.Grid << " grid of size " << run.Size
+                 << " with frequency " << run.Frequency << "." << endl;
+            return_value = EXIT_FAILURE;
+            }
+          runs.push_back(run);
+          }
+        }
+      }
+    }
+
+  if (controller->GetLocalProcessId() == 0)
+    {
+    vtksys_ios::ofstream file(output.c_str());
+    WriteResults(file, runs, controller->GetNumberOfProcesses(),
+      numberOfSteps);
+    if (!file)
+      {
+      cerr << "ERROR: cannot write " << output << "." << endl;
+      return_value = EXIT_FAILURE;
+      }
+    else
+      {
+      cout << "Results of " << runs.size() << " configurations written to "
+           << output << endl;
+      }
+    }
+
+  processor->Finalize();
+  processor->Delete();
+#ifdef PARAVIEW_USE_MPI
+  MPI_Finalize();
+#endif
+  return return_value;
+}
@@ -0,0 +1,187 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    BenchmarkRequestDataDescription.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Runs vtkPVCustomTestDriver for a number of time steps with two
+// coprocessing scripts that output every --frequency time steps, one that
+// declares its update frequencies with GetUpdateFrequencies() and one that
+// does not, and reports the time taken per time step by each. Fails if the
+// scripts did not coprocess the same time steps.
+//
+// The scripts are written to --directory, along with the lists of the time
+// steps they coprocessed.
+//
+// Usage:
+//  BenchmarkRequestDataDescription [--steps N] [--frequency N]
+//    [--directory path]
+
+#include "vtkPVCustomTestDriver.h"
+#include "vtkTimerLog.h"
+
+#include "vtkPVConfig.h"
+#ifdef PARAVIEW_USE_MPI
+# define MPICH_SKIP_MPICXX
+# include "vtkMPI.h"
+#endif
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <vtksys/ios/fstream>
+
+namespace
+{
+  // Writes the coprocessing script moduleName.py, which appends the time
+  // steps it coprocesses to moduleName.steps.
+  std::string WriteScript(const std::string& directory,
+    const std::string& moduleName, int frequency, bool declare)
+    {
+    std::string fileName = directory + "/" + moduleName + ".py";
+    vtksys_ios::ofstream script(fileName.c_str());
+    script
+      << "from paraview import coprocessing\n"
+      << "class CoProcessor(coprocessing.CoProcessor):\n"
+      << "  def CreatePipeline(self, datadescription):\n"
+      << "    pass\n"
+      << "coprocessor = CoProcessor()\n"
+      << "coprocessor.SetUpdateFrequencies({'input': [" << frequency << "]})\n"
+      << "steps = open(r'" << directory << "/" << moduleName
+      << ".steps', 'w')\n"
+      << "def RequestDataDescription(datadescription):\n"
+      << "  coprocessor.LoadRequestedData(datadescription)\n"
+      << "def DoCoProcessing(datadescription):\n"
+      << "  steps.write('%d\\n' % datadescription.GetTimeStep())\n"
+      << "  steps.flush()\n";
+    if (declare)
+      {
+      script
+        << "def GetUpdateFrequencies():\n"
+        << "  return coprocessor.GetUpdateFrequencies()\n";
+      }
+    return fileName;
+    }
+
+  // Returns the time steps listed in moduleName.steps.
+  std::vector<int> ReadSteps(const std::string& directory,
+    const std::string& moduleName)
+    {
+    std::string fileName = directory + "/" + moduleName + ".steps";
+    vtksys_ios::ifstream file(fileName.c_str());
+    std::vector<int> steps;
+    int step;
+    while (file >> step)
+      {
+      steps.push_back(step);
+      }
+    return steps;
+    }
+
+  // Runs the driver for the given number of time steps and returns the time
+  // it took per time step, or -1 on failure.
+  double Run(vtkPVCustomTestDriver* driver, int numberOfSteps)
+    {
+    driver->SetNumberOfTimeSteps(numberOfSteps);
+    driver->SetStartTime(0);
+    driver->SetEndTime(1);
+
+    vtkTimerLog* timer = vtkTimerLog::New();
+    timer->StartTimer();
+    int errors = driver->Run();
+    timer->StopTimer();
+    double timePerStep = timer->GetElapsedTime() / numberOfSteps;
+    timer->Delete();
+    return errors? -1 : timePerStep;
+    }
+}
+
+//----------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+  int numberOfSteps = 10000;
+  int frequency = 100;
+  std::string directory = ".";
+  for (int cc=1; cc < argc; cc++)
+    {
+    if (strcmp(argv[cc], "--steps") == 0 && cc+1 < argc)
+      {
+      numberOfSteps = atoi(argv[++cc]);
+      }
+    else if (strcmp(argv[cc], "--frequency") == 0 && cc+1 < argc)
+      {
+      frequency = atoi(argv[++cc]);
+      }
+    else if (strcmp(argv[cc], "--directory") == 0 && cc+1 < argc)
+      {
+      directory = argv[++cc];
+      }
+    }
+  if (numberOfSteps < 1 || frequency < 1)
+    {
+    cerr << "ERROR: --steps and --frequency must be positive." << endl;
+    return EXIT_FAILURE;
+    }
+#ifdef PARAVIEW_USE_MPI
+  MPI_Init(&argc, &argv);
+#endif
+
+  // Both drivers are created first since ParaView is finalized when the
+  // last one is deleted.
+  const char* moduleName = "BenchmarkRequestDataDescriptionScript";
+  const char* declaredModuleName =
+    "BenchmarkRequestDataDescriptionDeclaredScript";
+  vtkPVCustomTestDriver* driver = vtkPVCustomTestDriver::New();
+  vtkPVCustomTestDriver* declaredDriver = vtkPVCustomTestDriver::New();
+  double time = -1;
+  double declaredTime = -1;
+  if (driver->Initialize(WriteScript(
+        directory, moduleName, frequency, false).c_str()) &&
+    declaredDriver->Initialize(WriteScript(
+        directory, declaredModuleName, frequency, true).c_str()))
+    {
+    time = Run(driver, numberOfSteps);
+    declaredTime = Run(declaredDriver, numberOfSteps);
+    }
+  driver->Finalize();
+  declaredDriver->Finalize();
+  driver->Delete();
+  declaredDriver->Delete();
+
+  cout << "Time steps: " << numberOfSteps
+       << " (output every " << frequency << ")" << endl
+       << "  RequestDataDescription in Python: "
+       << time * 1e6 << " us/step" << endl
+       << "  Declared update frequencies: "
+       << declaredTime * 1e6 << " us/step" << endl;
+
+  int return_value = EXIT_SUCCESS;
+  std::vector<int> steps = ReadSteps(directory, moduleName);
+  if (time < 0 || declaredTime < 0)
+    {
+    cerr << "ERROR: failed to run the coprocessing scripts." << endl;
+    return_value = EXIT_FAILURE;
+    }
+  else if (steps.size() !=
+    static_cast<size_t>((numberOfSteps + frequency - 1) / frequency) ||
+    steps != ReadSteps(directory, declaredModuleName))
+    {
+    cerr << "ERROR: the scripts did not coprocess the same time steps."
+         << endl;
+    return_value = EXIT_FAILURE;
+    }
+
+#ifdef PARAVIEW_USE_MPI
+  MPI_Finalize();
+#endif
+  return return_value;
+}
@@ -0,0 +1,62 @@
+# CoProcessing in transit test expects the following arguments to be passed
+# to cmake using -DFoo=BAR arguments.
+
+# COPROCESSING_TEST_DRIVER  -- path to CoProcessingInTransitDriver
+# COPROCESSING_STAGING_EXECUTABLE -- path to pvbatch
+# COPROCESSING_STAGING_SCRIPT -- python script run by pvbatch
+# COPROCESSING_TEST_SCRIPT  -- co-processing script run by the staging job
+# COPROCESSING_TEST_DIR     -- path to temporary dir
+
+# MPIEXEC
+# MPIEXEC_NUMPROC_FLAG
+# MPIEXEC_PREFLAGS
+# SIMULATION_NUMPROCS
+# STAGING_NUMPROCS
+
+set(connection_file "${COPROCESSING_TEST_DIR}/CPInTransitConnection.txt")
+
+# remove result files generated by the test, and the connection file of a
+# staging job that did not run to the end.
+file(REMOVE "${connection_file}")
+foreach(step 0 2 4)
+  file(REMOVE "${COPROCESSING_TEST_DIR}/CPInTransit${step}.vtm")
+endforeach()
+
+if(NOT EXISTS "${COPROCESSING_TEST_DRIVER}")
+  message(FATAL_ERROR "'${COPROCESSING_TEST_DRIVER}' does not exist")
+endif()
+
+# the commands of execute_process run at the same time: the simulation waits
+# for the staging job to write the connection file.
+message("Executing :
+    ${MPIEXEC} ${MPIEXEC_NUMPROC_FLAG} ${STAGING_NUMPROCS} ${MPIEXEC_PREFLAGS}
+    \"${COPROCESSING_STAGING_EXECUTABLE}\" --symmetric
+    \"${COPROCESSING_STAGING_SCRIPT}\" \"${connection_file}\"
+    \"${COPROCESSING_TEST_SCRIPT}\"
+  and
+    ${MPIEXEC} ${MPIEXEC_NUMPROC_FLAG} ${SIMULATION_NUMPROCS} ${MPIEXEC_PREFLAGS}
+    \"${COPROCESSING_TEST_DRIVER}\" \"${connection_file}\" 5")
+execute_process(
+  COMMAND
+    ${MPIEXEC} ${MPIEXEC_NUMPROC_FLAG} ${STAGING_NUMPROCS} ${MPIEXEC_PREFLAGS}
+    "${COPROCESSING_STAGING_EXECUTABLE}" --symmetric
+    "${COPROCESSING_STAGING_SCRIPT}" "${connection_file}"
+    "${COPROCESSING_TEST_SCRIPT}"
+  COMMAND
+    ${MPIEXEC} ${MPIEXEC_NUMPROC_FLAG} ${SIMULATION_NUMPROCS} ${MPIEXEC_PREFLAGS}
+    "${COPROCESSING_TEST_DRIVER}" "${connection_file}" 5
+  WORKING_DIRECTORY ${COPROCESSING_TEST_DIR}
+  RESULTS_VARIABLE rv
+  TIMEOUT 300)
+
+foreach(result ${rv})
+  if(NOT result EQUAL 0)
+    message(FATAL_ERROR "Test executable return values were ${rv}")
+  endif()
+endforeach()
+
+foreach(step 0 2 4)
+  if(NOT EXISTS "${COPROCESSING_TEST_DIR}/CPInTransit${step}.vtm")
+    message(FATAL_ERROR "'${COPROCESSING_TEST_DIR}/CPInTransit${step}.vtm' was not created")
+  endif()
+endforeach()
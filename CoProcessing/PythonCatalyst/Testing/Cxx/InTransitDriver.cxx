@@ -0,0 +1,78 @@
+// A simulation that sends its grid to a staging job with
+// vtkCPInTransitProcessor. Each rank has a slab of an image with a Pressure
+// point field. It takes the connection file written by the staging job and
+// the number of time steps as arguments.
+#include <vtkCPDataDescription.h>
+#include <vtkCPInputDataDescription.h>
+#include <vtkCPInTransitProcessor.h>
+#include <vtkDoubleArray.h>
+#include <vtkImageData.h>
+#include <vtkMultiProcessController.h>
+#include <vtkPointData.h>
+#include <vtkSmartPointer.h>
+
+#include <cstdlib>
+
+int main(int argc, char* argv[])
+{
+  if(argc != 3)
+    {
+    cerr << "Usage: " << argv[0]
+         << " <connection file> <number of time steps>" << endl;
+    return 1;
+    }
+
+  vtkSmartPointer<vtkCPInTransitProcessor> processor =
+    vtkSmartPointer<vtkCPInTransitProcessor>::New();
+  processor->SetConnectionFileName(argv[1]);
+  if(!processor->Initialize())
+    {
+    return 1;
+    }
+  vtkMultiProcessController* controller =
+    vtkMultiProcessController::GetGlobalController();
+  int rank = controller ? controller->GetLocalProcessId() : 0;
+  int numberOfRanks = controller ? controller->GetNumberOfProcesses() : 1;
+
+  vtkSmartPointer<vtkImageData> grid = vtkSmartPointer<vtkImageData>::New();
+  grid->SetExtent(0, 10, 0, 10, 10*rank, 10*rank + 10);
+  vtkSmartPointer<vtkDoubleArray> pressure =
+    vtkSmartPointer<vtkDoubleArray>::New();
+  pressure->SetName("Pressure");
+  pressure->SetNumberOfTuples(grid->GetNumberOfPoints());
+  grid->GetPointData()->AddArray(pressure);
+
+  int retVal = 0;
+  int numberOfTimeSteps = atoi(argv[2]);
+  for(int timeStep=0;timeStep<numberOfTimeSteps;timeStep++)
+    {
+    double time = timeStep * 0.1;
+    for(vtkIdType i=0;i<grid->GetNumberOfPoints();i++)
+      {
+      double point[3];
+      grid->GetPoint(i, point);
+      pressure->SetValue(i, point[2] + time);
+      }
+    vtkSmartPointer<vtkCPDataDescription> dataDescription =
+      vtkSmartPointer<vtkCPDataDescription>::New();
+    dataDescription->AddInput("input");
+    dataDescription->SetTimeData(time, timeStep);
+    if(processor->RequestDataDescription(dataDescription))
+      {
+      vtkCPInputDataDescription* inputDescription =
+        dataDescription->GetInputDescriptionByName("input");
+      inputDescription->SetGrid(grid);
+      inputDescription->SetWholeExtent(0, 10, 0, 10, 0, 10*numberOfRanks);
+      if(!processor->CoProcess(dataDescription))
+        {
+        retVal = 1;
+        }
+      }
+    }
+
+  if(!processor->Finalize())
+    {
+    retVal = 1;
+    }
+  return retVal;
+}
@@ -0,0 +1,28 @@
+# The pipeline run by InTransitStaging.py: it checks the grids received from
+# the simulation ranks and writes them every 2 time steps.
+from vtkIOXMLPython import vtkXMLMultiBlockDataWriter
+
+def RequestDataDescription(datadescription):
+  if datadescription.GetTimeStep() % 2 == 0:
+    datadescription.GetInputDescriptionByName("input").AllFieldsOn()
+    datadescription.GetInputDescriptionByName("input").GenerateMeshOn()
+
+def DoCoProcessing(datadescription):
+  timestep = datadescription.GetTimeStep()
+  grid = datadescription.GetInputDescriptionByName("input").GetGrid()
+  # the only staging rank receives a block from each of the 2 simulation
+  # ranks.
+  if not grid.IsA("vtkMultiBlockDataSet") or grid.GetNumberOfBlocks() != 2:
+    raise RuntimeError, "Wrong number of grids received at time step %d" % timestep
+
+  # each simulation rank sends a slab of 11x11x11 points.
+  for i in range(grid.GetNumberOfBlocks()):
+    block = grid.GetBlock(i)
+    if not block or block.GetNumberOfPoints() != 1331 or \
+       not block.GetPointData().GetArray("Pressure"):
+      raise RuntimeError, "Wrong grid received at time step %d" % timestep
+
+  writer = vtkXMLMultiBlockDataWriter()
+  writer.SetInputData(grid)
+  writer.SetFileName('CPInTransit%d.vtm' % timestep)
+  writer.Write()
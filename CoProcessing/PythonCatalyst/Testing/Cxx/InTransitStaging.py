@@ -0,0 +1,26 @@
+# Runs the co-processing pipeline of a Python script on the grids sent by
+# InTransitDriver. It is run with pvbatch --symmetric.
+import sys
+if len(sys.argv) != 3:
+    print "command is 'pvbatch --symmetric <python staging code> <connection file> <script name>'"
+    sys.exit(1)
+import paraview
+paraview.options.batch = True
+paraview.options.symmetric = True
+import vtkPVCatalystPython
+import vtkPVPythonCatalystPython
+
+pipeline = vtkPVPythonCatalystPython.vtkCPPythonScriptPipeline()
+if not pipeline.Initialize(sys.argv[2]):
+    print 'Cannot initialize the pipeline of ', sys.argv[2]
+    sys.exit(1)
+processor = vtkPVCatalystPython.vtkCPProcessor()
+processor.AddPipeline(pipeline)
+
+receiver = vtkPVCatalystPython.vtkCPInTransitReceiver()
+receiver.SetConnectionFileName(sys.argv[1])
+receiver.SetProcessor(processor)
+if not receiver.Initialize() or not receiver.Run():
+    print 'In transit co-processing failed.'
+    sys.exit(1)
+processor.Finalize()
@@ -12,15 +12,19 @@
      PURPOSE.  See the above copyright notice for more information.
 
 =========================================================================*/
+#include "vtkPython.h" // python first
 #include "vtkCPPythonScriptPipeline.h"
 
 #include "vtkCPDataDescription.h"
+#include "vtkCPInputDataDescription.h"
 #include "vtkDataObject.h"
+#include "vtkMultiProcessController.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkProcessModule.h"
 #include "vtkPVConfig.h"
 #include "vtkPVPythonOptions.h"
+#include "vtkPythonImportBroadcaster.h"
 #include "vtkPythonInterpreter.h"
 #include "vtkSMObject.h"
 #include "vtkSMProxyManager.h"
@@ -28,7 +32,9 @@
 // for PARAVIEW_INSTALL_DIR and PARAVIEW_BINARY_DIR variables
 #include "vtkCPPythonScriptPipelineConfig.h"
 
+#include <map>
 #include <string>
+#include <vector>
 #include <vtksys/SystemTools.hxx>
 #include <vtksys/ios/sstream>
 
@@ -38,6 +44,20 @@ extern "C" {
 
 namespace
 {
+  bool BroadcastImports =
+    vtksys::SystemTools::GetEnv("PV_BROADCAST_PYTHON_IMPORTS") != NULL;
+
+  //----------------------------------------------------------------------------
+  // Returns the controller to broadcast Python modules with, or NULL if each
+  // process imports them from the file system.
+  vtkMultiProcessController* GetBroadcastController()
+    {
+    vtkMultiProcessController* controller =
+      vtkMultiProcessController::GetGlobalController();
+    return (BroadcastImports && controller &&
+      controller->GetNumberOfProcesses() > 1)? controller : NULL;
+    }
+
   //----------------------------------------------------------------------------
   void InitializePython()
     {
@@ -69,6 +89,14 @@ namespace
 
     vtkPythonInterpreter::Initialize();
 
+    if (vtkMultiProcessController* controller = GetBroadcastController())
+      {
+      vtkNew<vtkPythonImportBroadcaster> broadcaster;
+      broadcaster->SetController(controller);
+      broadcaster->AddPackage("paraview");
+      broadcaster->Broadcast();
+      }
+
     vtksys_ios::ostringstream loadPythonModules;
     loadPythonModules
       << "import sys\n"
@@ -86,23 +114,51 @@ namespace
     }
 }
 
+//****************************************************************************
+class vtkCPPythonScriptPipeline::vtkInternals
+{
+public:
+  vtkInternals() : FrequenciesDeclared(false) {}
+
+  // Set when the script declared its update frequencies.
+  bool FrequenciesDeclared;
+  // Maps the input names to their update frequencies.
+  std::map<std::string, std::vector<vtkIdType> > Frequencies;
+};
+
 vtkStandardNewMacro(vtkCPPythonScriptPipeline);
 //----------------------------------------------------------------------------
 vtkCPPythonScriptPipeline::vtkCPPythonScriptPipeline()
 {
   this->PythonScriptName = 0;
+  this->Internals = new vtkInternals();
 }
 
 //----------------------------------------------------------------------------
 vtkCPPythonScriptPipeline::~vtkCPPythonScriptPipeline()
 {
   this->SetPythonScriptName(0);
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+void vtkCPPythonScriptPipeline::SetBroadcastImports(bool broadcast)
+{
+  BroadcastImports = broadcast;
+}
+
+//----------------------------------------------------------------------------
+bool vtkCPPythonScriptPipeline::GetBroadcastImports()
+{
+  return BroadcastImports;
 }
 
 //----------------------------------------------------------------------------
 int vtkCPPythonScriptPipeline::Initialize(const char* fileName)
 {
-  if(vtksys::SystemTools::FileExists(fileName) == 0)
+  // When broadcasting, only the root process looks for the file.
+  vtkMultiProcessController* controller = GetBroadcastController();
+  if(!controller && vtksys::SystemTools::FileExists(fileName) == 0)
     {
     vtkErrorMacro("Could not find file " << fileName);
     return 0;
@@ -110,6 +166,18 @@ int vtkCPPythonScriptPipeline::Initialize(const char* fileName)
 
   InitializePython();
 
+  if (controller)
+    {
+    vtkNew<vtkPythonImportBroadcaster> broadcaster;
+    broadcaster->SetController(controller);
+    broadcaster->AddModuleFile(fileName);
+    if (!broadcaster->Broadcast())
+      {
+      vtkErrorMacro("Could not read file " << fileName);
+      return 0;
+      }
+    }
+
   // for now do not check on filename extension:
   //vtksys::SystemTools::GetFilenameLastExtension(FileName) == ".py" == 0)
 
@@ -125,9 +193,117 @@ int vtkCPPythonScriptPipeline::Initialize(const char* fileName)
     << "import " << fileNameName << "\n";
 
   vtkPythonInterpreter::RunSimpleString(loadPythonModules.str().c_str());
+  this->ReadUpdateFrequencies();
   return 1;
 }
 
+//----------------------------------------------------------------------------
+bool vtkCPPythonScriptPipeline::ReadUpdateFrequencies()
+{
+  this->Internals->FrequenciesDeclared = false;
+  this->Internals->Frequencies.clear();
+
+  PyObject* module = PyImport_ImportModule(this->PythonScriptName);
+  if (!module)
+    {
+    // the import error was already reported by Initialize().
+    PyErr_Clear();
+    return false;
+    }
+  PyObject* frequencies = NULL;
+  if (PyObject_HasAttrString(module, "GetUpdateFrequencies"))
+    {
+    frequencies = PyObject_CallMethod(module,
+      const_cast<char*>("GetUpdateFrequencies"), NULL);
+    if (!frequencies)
+      {
+      PyErr_Print();
+      }
+    }
+  Py_DECREF(module);
+  if (!frequencies)
+    {
+    return false;
+    }
+  if (frequencies == Py_None)
+    {
+    Py_DECREF(frequencies);
+    return false;
+    }
+
+  // Frequencies that are not positive integers make the script be called
+  // at every time step, so that it reports the errors as it used to.
+  bool valid = PyDict_Check(frequencies) != 0;
+  Py_ssize_t pos = 0;
+  PyObject* key;
+  PyObject* value;
+  while (valid && PyDict_Next(frequencies, &pos, &key, &value))
+    {
+    PyObject* values = PySequence_Fast(value, "");
+    if (!values || !PyString_Check(key))
+      {
+      Py_XDECREF(values);
+      valid = false;
+      break;
+      }
+    std::vector<vtkIdType>& inputFrequencies =
+      this->Internals->Frequencies[PyString_AsString(key)];
+    for (Py_ssize_t cc=0;
+      valid && cc < PySequence_Fast_GET_SIZE(values); cc++)
+      {
+      long frequency = PyInt_AsLong(PySequence_Fast_GET_ITEM(values, cc));
+      valid = (frequency > 0);
+      inputFrequencies.push_back(static_cast<vtkIdType>(frequency));
+      }
+    Py_DECREF(values);
+    }
+  Py_DECREF(frequencies);
+
+  if (!valid)
+    {
+    PyErr_Clear();
+    this->Internals->Frequencies.clear();
+    vtkWarningMacro("GetUpdateFrequencies() of " << this->PythonScriptName
+      << " must return a dictionary of lists of positive integers. "
+      "The script will be called at every time step.");
+    return false;
+    }
+  this->Internals->FrequenciesDeclared = true;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkCPPythonScriptPipeline::IsScriptRequestNeeded(
+  vtkCPDataDescription* dataDescription)
+{
+  if (!this->Internals->FrequenciesDeclared ||
+    dataDescription->GetForceOutput())
+    {
+    return true;
+    }
+
+  vtkIdType timeStep = dataDescription->GetTimeStep();
+  for (unsigned int cc=0;
+    cc < dataDescription->GetNumberOfInputDescriptions(); cc++)
+    {
+    std::map<std::string, std::vector<vtkIdType> >::const_iterator iter =
+      this->Internals->Frequencies.find(
+        dataDescription->GetInputDescriptionName(cc));
+    if (iter == this->Internals->Frequencies.end())
+      {
+      continue;
+      }
+    for (size_t kk=0; kk < iter->second.size(); kk++)
+      {
+      if (timeStep % iter->second[kk] == 0)
+        {
+        return true;
+        }
+      }
+    }
+  return false;
+}
+
 //----------------------------------------------------------------------------
 int vtkCPPythonScriptPipeline::RequestDataDescription(
   vtkCPDataDescription* dataDescription)
@@ -138,6 +314,19 @@ int vtkCPPythonScriptPipeline::RequestDataDescription(
     return 0;
     }
 
+  if (!this->IsScriptRequestNeeded(dataDescription))
+    {
+    // Same requests as CoProcessor.LoadRequestedData() makes when none of
+    // the inputs is needed at this time step.
+    for (unsigned int cc=0;
+      cc < dataDescription->GetNumberOfInputDescriptions(); cc++)
+      {
+      dataDescription->GetInputDescription(cc)->AllFieldsOff();
+      dataDescription->GetInputDescription(cc)->GenerateMeshOff();
+      }
+    return dataDescription->GetIfAnyGridNecessary()? 1: 0;
+    }
+
   InitializePython();
 
   // check the script to see if it should be run...
@@ -203,4 +392,20 @@ void vtkCPPythonScriptPipeline::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
   os << indent << "PythonScriptName: " << this->PythonScriptName << "\n";
+  os << indent << "UpdateFrequencies:";
+  if (!this->Internals->FrequenciesDeclared)
+    {
+    os << " (not declared)";
+    }
+  std::map<std::string, std::vector<vtkIdType> >::const_iterator iter;
+  for (iter = this->Internals->Frequencies.begin();
+    iter != this->Internals->Frequencies.end(); ++iter)
+    {
+    os << " " << iter->first << ":";
+    for (size_t cc=0; cc < iter->second.size(); cc++)
+      {
+      os << (cc? "," : "") << iter->second[cc];
+      }
+    }
+  os << "\n";
 }
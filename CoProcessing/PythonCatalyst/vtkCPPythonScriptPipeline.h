@@ -26,6 +26,14 @@ class vtkCPDataDescription;
 /// script.  This class only does operations with respect to the script
 /// and uses the name of the script as the module to hide its definitions
 /// from other python modules.
+///
+/// If the script defines a GetUpdateFrequencies() function, e.g. as scripts
+/// exported with paraview.cpexport do, it is called once by Initialize(). It
+/// must return a dictionary that maps input names to lists of frequencies,
+/// the same as the one given to CoProcessor.SetUpdateFrequencies(). The
+/// frequencies are then checked in C++ by RequestDataDescription() and the
+/// script is only called for the time steps where one of the inputs is
+/// needed.
 class VTKPVPYTHONCATALYST_EXPORT vtkCPPythonScriptPipeline : public vtkCPPipeline
 {
 public:
@@ -44,11 +52,24 @@ public:
   /// it fills in the FieldNames array that the coprocessor requires
   /// in order to fulfill all the coprocessing requests for this
   /// TimeStep/Time combination.
+  /// When the script declared its update frequencies and none of them
+  /// matches the time step, all inputs are turned off without calling
+  /// the script.
   virtual int RequestDataDescription(vtkCPDataDescription* dataDescription);
 
   /// Execute the pipeline. Returns 1 for success and 0 for failure.
   virtual int CoProcess(vtkCPDataDescription* dataDescription);
 
+  /// When on, the root process reads the paraview Python package and the
+  /// coprocessing scripts and broadcasts them to all the other processes,
+  /// which import them from memory instead of from the file system (see
+  /// vtkPythonImportBroadcaster). Initialize() must then be called on all
+  /// processes. Off by default, unless the PV_BROADCAST_PYTHON_IMPORTS
+  /// environment variable is set. Must be set before the first pipeline is
+  /// initialized for the paraview package to be broadcast.
+  static void SetBroadcastImports(bool broadcast);
+  static bool GetBroadcastImports();
+
 protected:
   vtkCPPythonScriptPipeline();
   virtual ~vtkCPPythonScriptPipeline();
@@ -60,6 +81,16 @@ protected:
   vtkSetStringMacro(PythonScriptName);
   vtkGetStringMacro(PythonScriptName);
 
+  /// Calls the GetUpdateFrequencies() function of the script, if any, and
+  /// stores the frequencies it returns. Returns true if the script declared
+  /// them.
+  bool ReadUpdateFrequencies();
+
+  /// Returns true if the script needs to be called for the time step of
+  /// dataDescription, i.e. unless it declared its update frequencies and
+  /// none of the inputs of dataDescription is needed at that time step.
+  bool IsScriptRequestNeeded(vtkCPDataDescription* dataDescription);
+
 private:
   vtkCPPythonScriptPipeline(const vtkCPPythonScriptPipeline&); // Not implemented
   void operator=(const vtkCPPythonScriptPipeline&); // Not implemented
@@ -67,6 +98,9 @@ private:
   /// The name of the python script (without the path or extension)
   /// that is used as the namespace of the functions of the script.
   char* PythonScriptName;
+
+  class vtkInternals;
+  vtkInternals* Internals;
 };
 
 #endif
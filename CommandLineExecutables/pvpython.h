@@ -20,8 +20,10 @@ extern "C" {
 
 #include "vtkInitializationHelper.h"
 #include "vtkMultiProcessController.h"
+#include "vtkNew.h"
 #include "vtkProcessModule.h"
 #include "vtkPVPythonOptions.h"
+#include "vtkPythonImportBroadcaster.h"
 #include "vtkPythonInterpreter.h"
 #include "vtkSMSession.h"
 
@@ -108,6 +110,16 @@ namespace ParaViewPython {
       // Start interpretor
       vtkPythonInterpreter::Initialize();
 
+      // In symmetric mode all processes run the script: let the root process
+      // read the paraview package and the others import it from memory.
+      if (pm->GetSymmetricMPIMode() && pm->GetNumberOfLocalPartitions() > 1)
+        {
+        vtkNew<vtkPythonImportBroadcaster> broadcaster;
+        broadcaster->SetController(pm->GetGlobalController());
+        broadcaster->AddPackage("paraview");
+        broadcaster->Broadcast();
+        }
+
       ret_val = vtkPythonInterpreter::PyMain(static_cast<int>(pythonArgs.size()), &*pythonArgs.begin());
 
       // Free python args
@@ -0,0 +1,219 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    BenchmarkTCPNetworkAccessManager.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Drives a number of simulated client connections through
+// vtkTCPNetworkAccessManager::ProcessEvents() and reports the message
+// throughput and the worst latency seen by the small messages. One of the
+// connections periodically sends large messages, which must not hold up the
+// other connections.
+//
+// With --port 0, a free port is picked.
+//
+// Usage:
+//  BenchmarkTCPNetworkAccessManager [--connections N] [--messages M]
+//                                   [--port P]
+
+#include "vtkMultiProcessController.h"
+#include "vtkMultiThreader.h"
+#include "vtkNew.h"
+#include "vtkServerSocket.h"
+#include "vtkSmartPointer.h"
+#include "vtkTCPNetworkAccessManager.h"
+#include "vtkTimerLog.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <vtksys/SystemTools.hxx>
+#include <vtksys/ios/sstream>
+
+namespace
+{
+  const int BENCHMARK_RMI_TAG = 8778;
+  const int LARGE_MESSAGE_SIZE = 8*1024*1024;
+  const int SMALL_MESSAGE_SIZE = 256;
+
+  struct BenchmarkState
+    {
+    int NumberOfConnections;
+    int NumberOfMessages;
+    int Port;
+
+    // updated by the server (main) thread.
+    int MessagesReceived;
+    double MaxLatency;
+    volatile bool Done;
+    };
+
+  // Small messages carry the time they were sent.
+  void MessageReceived(void* localArg, void* remoteArg, int remoteArgLength,
+    int)
+    {
+    BenchmarkState* state = static_cast<BenchmarkState*>(localArg);
+    state->MessagesReceived++;
+    if (remoteArgLength == SMALL_MESSAGE_SIZE)
+      {
+      double sent;
+      memcpy(&sent, remoteArg, sizeof(double));
+      double latency = vtkTimerLog::GetUniversalTime() - sent;
+      state->MaxLatency =
+        latency > state->MaxLatency? latency : state->MaxLatency;
+      }
+    }
+
+  VTK_THREAD_RETURN_TYPE ClientThread(void* arg)
+    {
+    vtkMultiThreader::ThreadInfo* info =
+      static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+    BenchmarkState* state = static_cast<BenchmarkState*>(info->UserData);
+
+    vtkNew<vtkTCPNetworkAccessManager> manager;
+    vtksys_ios::ostringstream url;
+    url << "tcp://localhost:" << state->Port << "?timeout=60";
+
+    std::vector<vtkSmartPointer<vtkMultiProcessController> > controllers;
+    for (int cc=0; cc < state->NumberOfConnections; cc++)
+      {
+      vtkMultiProcessController* controller =
+        manager->NewConnection(url.str().c_str());
+      if (!controller)
+        {
+        state->Done = true;
+        return VTK_THREAD_RETURN_VALUE;
+        }
+      controllers.push_back(controller);
+      controller->FastDelete();
+      }
+
+    std::vector<char> small(SMALL_MESSAGE_SIZE, 0);
+    std::vector<char> large(LARGE_MESSAGE_SIZE, 0);
+    for (int msg=0; msg < state->NumberOfMessages; msg++)
+      {
+      for (int cc=0; cc < state->NumberOfConnections; cc++)
+        {
+        if (cc == 0 && (msg % 10) == 0)
+          {
+          controllers[cc]->TriggerRMI(1, &large[0], LARGE_MESSAGE_SIZE,
+            BENCHMARK_RMI_TAG);
+          }
+        else
+          {
+          double now = vtkTimerLog::GetUniversalTime();
+          memcpy(&small[0], &now, sizeof(double));
+          controllers[cc]->TriggerRMI(1, &small[0], SMALL_MESSAGE_SIZE,
+            BENCHMARK_RMI_TAG);
+          }
+        }
+      }
+
+    // keep the connections open until the server has read everything.
+    while (!state->Done)
+      {
+      vtksys::SystemTools::Delay(10);
+      }
+    return VTK_THREAD_RETURN_VALUE;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+  BenchmarkState state;
+  state.NumberOfConnections = 16;
+  state.NumberOfMessages = 100;
+  state.Port = 11199;
+  state.MessagesReceived = 0;
+  state.MaxLatency = 0.0;
+  state.Done = false;
+  for (int cc=1; cc + 1 < argc; cc++)
+    {
+    if (strcmp(argv[cc], "--connections") == 0)
+      {
+      state.NumberOfConnections = atoi(argv[++cc]);
+      }
+    else if (strcmp(argv[cc], "--messages") == 0)
+      {
+      state.NumberOfMessages = atoi(argv[++cc]);
+      }
+    else if (strcmp(argv[cc], "--port") == 0)
+      {
+      state.Port = atoi(argv[++cc]);
+      }
+    }
+
+  if (state.Port == 0)
+    {
+    vtkNew<vtkServerSocket> socket;
+    if (socket->CreateServer(0) != 0)
+      {
+      cerr << "ERROR: failed to find a free port." << endl;
+      return EXIT_FAILURE;
+      }
+    state.Port = socket->GetServerPort();
+    socket->CloseSocket();
+    }
+
+  vtkNew<vtkMultiThreader> threader;
+  int threadId = threader->SpawnThread(ClientThread, &state);
+
+  vtkNew<vtkTCPNetworkAccessManager> manager;
+  vtksys_ios::ostringstream url;
+  url << "tcp://localhost:" << state.Port << "?listen=true&multiple=true";
+
+  std::vector<vtkSmartPointer<vtkMultiProcessController> > controllers;
+  for (int cc=0; cc < state.NumberOfConnections && !state.Done; cc++)
+    {
+    vtkMultiProcessController* controller =
+      manager->NewConnection(url.str().c_str());
+    if (controller)
+      {
+      controller->AddRMICallback(MessageReceived, &state, BENCHMARK_RMI_TAG);
+      controllers.push_back(controller);
+      controller->FastDelete();
+      }
+    }
+
+  const int expected = state.NumberOfConnections * state.NumberOfMessages;
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  int status = 0;
+  while (status >= 0 && state.MessagesReceived < expected &&
+    static_cast<int>(controllers.size()) == state.NumberOfConnections)
+    {
+    status = manager->ProcessEvents(1000);
+    timer->StopTimer();
+    if (timer->GetElapsedTime() > 300)
+      {
+      break;
+      }
+    }
+  timer->StopTimer();
+  state.Done = true;
+  threader->TerminateThread(threadId);
+
+  cout << "Connections: " << state.NumberOfConnections << endl
+       << "Messages received: " << state.MessagesReceived << " of "
+       << expected << endl
+       << "Time: " << timer->GetElapsedTime() << " s" << endl
+       << "Messages per second: "
+       << state.MessagesReceived / (timer->GetElapsedTime() + 1e-9) << endl
+       << "Max latency (small messages): " << state.MaxLatency << " s"
+       << endl;
+
+  if (state.MessagesReceived != expected)
+    {
+    cerr << "ERROR: not all messages were received." << endl;
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+}
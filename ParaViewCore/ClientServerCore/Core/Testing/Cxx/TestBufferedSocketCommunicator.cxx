@@ -0,0 +1,257 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestBufferedSocketCommunicator.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Sends an RMI with an argument much larger than the socket buffers to a
+// vtkPVBufferedSocketCommunicator, pausing half-way through the argument.
+// Checks that ReceiveAvailable() returns without blocking while the RMI is
+// incomplete, that ProcessRMIs() then gets the reassembled argument, and
+// that the message sent after the RMI is left in the socket.
+
+#include "vtkByteSwap.h"
+#include "vtkClientSocket.h"
+#include "vtkMultiProcessController.h"
+#include "vtkMultiThreader.h"
+#include "vtkNew.h"
+#include "vtkPVBufferedSocketCommunicator.h"
+#include "vtkServerSocket.h"
+#include "vtkSocketCommunicator.h"
+#include "vtkSocketController.h"
+#include "vtkTimerLog.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <vtksys/SystemTools.hxx>
+
+namespace
+{
+  const int TEST_RMI_TAG = 8779;
+  const int TEST_MESSAGE_TAG = 8780;
+  const int ARGUMENT_SIZE = 32*1024*1024;
+  const int FIRST_PART_SIZE = ARGUMENT_SIZE / 2;
+
+  char ValueAt(int index)
+    {
+    return static_cast<char>((index * 7) % 253);
+    }
+
+  struct SenderState
+    {
+    int Port;
+    int Errors;
+    volatile bool SendRest;
+    };
+
+  struct ReceiverState
+    {
+    int Calls;
+    int ArgumentLength;
+    bool ArgumentValid;
+    };
+
+  void RMICallback(void* localArg, void* remoteArg, int remoteArgLength, int)
+    {
+    ReceiverState* state = static_cast<ReceiverState*>(localArg);
+    state->Calls++;
+    state->ArgumentLength = remoteArgLength;
+    state->ArgumentValid = true;
+    const char* arg = static_cast<const char*>(remoteArg);
+    for (int cc=0; cc < remoteArgLength; cc++)
+      {
+      if (arg[cc] != ValueAt(cc))
+        {
+        state->ArgumentValid = false;
+        break;
+        }
+      }
+    }
+
+  // Sends a message the way vtkSocketCommunicator does: the tag, the length
+  // in bytes, then the data, here without the end of the data.
+  bool SendPartialMessage(vtkSocket* socket, int tag, const void* data,
+    int length, int sent)
+    {
+    int header[2] = { tag, length };
+    return socket->Send(header, sizeof(header)) != 0 &&
+      socket->Send(data, sent) != 0;
+    }
+
+  VTK_THREAD_RETURN_TYPE Send(void* calldata)
+    {
+    vtkMultiThreader::ThreadInfo* info =
+      reinterpret_cast<vtkMultiThreader::ThreadInfo*>(calldata);
+    SenderState* state = static_cast<SenderState*>(info->UserData);
+
+    vtkNew<vtkSocketCommunicator> communicator;
+    if (!communicator->ConnectTo(const_cast<char*>("localhost"), state->Port))
+      {
+      cerr << "ERROR: failed to connect." << endl;
+      state->Errors++;
+      return VTK_THREAD_RETURN_VALUE;
+      }
+    vtkNew<vtkSocketController> controller;
+    controller->SetCommunicator(communicator.GetPointer());
+    vtkSocket* socket = communicator->GetSocket();
+
+    // the trigger message, as sent by vtkMultiProcessController::TriggerRMI()
+    // for an argument that does not fit in it.
+    int trigger[128];
+    memset(trigger, 0, sizeof(trigger));
+    trigger[0] = TEST_RMI_TAG;
+    trigger[1] = ARGUMENT_SIZE;
+    trigger[2] = 0;
+    trigger[3] = 0;
+    vtkByteSwap::SwapLERange(trigger, 4);
+    std::vector<char> argument(ARGUMENT_SIZE);
+    for (int cc=0; cc < ARGUMENT_SIZE; cc++)
+      {
+      argument[cc] = ValueAt(cc);
+      }
+    if (!SendPartialMessage(socket, vtkMultiProcessController::RMI_TAG,
+        trigger, sizeof(trigger), sizeof(trigger)) ||
+      !SendPartialMessage(socket, vtkMultiProcessController::RMI_ARG_TAG,
+        &argument[0], ARGUMENT_SIZE, FIRST_PART_SIZE))
+      {
+      cerr << "ERROR: failed to send the first part of the RMI." << endl;
+      state->Errors++;
+      }
+
+    // the receiver must be able to go on without the rest of the RMI.
+    while (!state->SendRest)
+      {
+      vtksys::SystemTools::Delay(10);
+      }
+    int value = 42;
+    if (!socket->Send(&argument[FIRST_PART_SIZE],
+        ARGUMENT_SIZE - FIRST_PART_SIZE) ||
+      !controller->Send(&value, 1, 1, TEST_MESSAGE_TAG))
+      {
+      cerr << "ERROR: failed to send the rest of the RMI." << endl;
+      state->Errors++;
+      }
+    return VTK_THREAD_RETURN_VALUE;
+    }
+}
+
+//----------------------------------------------------------------------------
+int main(int, char**)
+{
+  vtkNew<vtkServerSocket> serverSocket;
+  if (serverSocket->CreateServer(0) != 0)
+    {
+    cerr << "ERROR: failed to create a server socket." << endl;
+    return EXIT_FAILURE;
+    }
+  SenderState senderState;
+  senderState.Port = serverSocket->GetServerPort();
+  senderState.Errors = 0;
+  senderState.SendRest = false;
+  vtkNew<vtkMultiThreader> threader;
+  int threadId = threader->SpawnThread(&Send, &senderState);
+
+  vtkClientSocket* socket = serverSocket->WaitForConnection(60000);
+  vtkNew<vtkPVBufferedSocketCommunicator> communicator;
+  communicator->SetSocket(socket);
+  if (socket)
+    {
+    socket->Delete();
+    }
+  if (!socket || !communicator->ServerSideHandshake())
+    {
+    cerr << "ERROR: the sender did not connect." << endl;
+    senderState.SendRest = true;
+    threader->TerminateThread(threadId);
+    return EXIT_FAILURE;
+    }
+  vtkNew<vtkSocketController> controller;
+  controller->SetCommunicator(communicator.GetPointer());
+  ReceiverState receiverState;
+  receiverState.Calls = 0;
+  receiverState.ArgumentLength = 0;
+  receiverState.ArgumentValid = false;
+  controller->AddRMICallback(RMICallback, &receiverState, TEST_RMI_TAG);
+
+  int errors = 0;
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+
+  // The first part is larger than the socket buffers, so the sender only
+  // gets through it while we read. If ReceiveAvailable() waited for the rest
+  // of the RMI, the sender would never be told to send it.
+  const vtkIdType firstPartLength = static_cast<vtkIdType>(
+    128*sizeof(int) + 2*sizeof(int) + FIRST_PART_SIZE);
+  int status = 0;
+  while (status == 0 && communicator->GetBufferedSize() < firstPartLength)
+    {
+    status = communicator->ReceiveAvailable();
+    timer->StopTimer();
+    if (timer->GetElapsedTime() > 120)
+      {
+      break;
+      }
+    }
+  if (status != 0 || communicator->HasBufferedRMI() ||
+    communicator->GetBufferedSize() != firstPartLength)
+    {
+    cerr << "ERROR: incomplete RMI reported with status " << status
+         << " and " << communicator->GetBufferedSize() << " bytes buffered."
+         << endl;
+    errors++;
+    }
+
+  senderState.SendRest = true;
+  while (status == 0)
+    {
+    status = communicator->ReceiveAvailable();
+    timer->StopTimer();
+    if (timer->GetElapsedTime() > 120)
+      {
+      break;
+      }
+    }
+  if (status != 1 || !communicator->HasBufferedRMI())
+    {
+    cerr << "ERROR: the RMI was not completed, status " << status << endl;
+    errors++;
+    }
+  else if (controller->ProcessRMIs(1, 1) !=
+    vtkMultiProcessController::RMI_NO_ERROR)
+    {
+    cerr << "ERROR: failed to process the RMI." << endl;
+    errors++;
+    }
+  if (receiverState.Calls != 1 ||
+    receiverState.ArgumentLength != ARGUMENT_SIZE ||
+    !receiverState.ArgumentValid)
+    {
+    cerr << "ERROR: the RMI argument was not reassembled." << endl;
+    errors++;
+    }
+  if (communicator->GetBufferedSize() != 0)
+    {
+    cerr << "ERROR: data past the RMI was buffered." << endl;
+    errors++;
+    }
+
+  int value = 0;
+  if (!controller->Receive(&value, 1, 1, TEST_MESSAGE_TAG) || value != 42)
+    {
+    cerr << "ERROR: the message after the RMI was lost." << endl;
+    errors++;
+    }
+
+  threader->TerminateThread(threadId);
+  communicator->CloseConnection();
+  return (errors + senderState.Errors) == 0? EXIT_SUCCESS : EXIT_FAILURE;
+}
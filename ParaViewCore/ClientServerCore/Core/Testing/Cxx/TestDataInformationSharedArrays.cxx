@@ -0,0 +1,128 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestDataInformationSharedArrays.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Collects vtkPVDataInformation for multiblocks with enough blocks to be
+// processed on several threads, where the blocks are different datasets
+// sharing the same points and point and cell arrays, and checks the bounds
+// and ranges, also after the shared arrays are modified.
+
+#include "vtkCellData.h"
+#include "vtkDoubleArray.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkMultiThreader.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPVArrayInformation.h"
+#include "vtkPVDataInformation.h"
+#include "vtkPVDataSetAttributesInformation.h"
+
+#include <cstdlib>
+
+#define TEST_ASSERT(condition) \
+  if (!(condition)) \
+    { \
+    cerr << "ERROR: failed at line " << __LINE__ << ": " #condition << endl; \
+    return EXIT_FAILURE; \
+    }
+
+namespace
+{
+  const int NUMBER_OF_BLOCKS = 256;
+  const int NUMBER_OF_POINTS = 1001;
+
+  // Fills the shared arrays. The points span [0, scale] along x and the
+  // point array values [-scale, scale].
+  void Fill(vtkPoints* points, vtkDoubleArray* pointArray,
+    vtkDoubleArray* cellArray, double scale)
+    {
+    for (vtkIdType cc=0; cc < NUMBER_OF_POINTS; cc++)
+      {
+      double t = static_cast<double>(cc) / (NUMBER_OF_POINTS - 1);
+      points->SetPoint(cc, scale * t, 1, 2);
+      pointArray->SetTuple3(cc, scale * (2 * t - 1), 0, 0);
+      }
+    cellArray->SetTuple1(0, scale);
+    points->Modified();
+    pointArray->Modified();
+    cellArray->Modified();
+    }
+
+  bool CheckRange(vtkPVDataSetAttributesInformation* info, const char* name,
+    int component, double min, double max)
+    {
+    vtkPVArrayInformation* array = info->GetArrayInformation(name);
+    if (!array)
+      {
+      return false;
+      }
+    double* range = array->GetComponentRange(component);
+    return range[0] == min && range[1] == max;
+    }
+}
+
+//----------------------------------------------------------------------------
+int main(int, char**)
+{
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(4);
+
+  vtkNew<vtkPoints> points;
+  points->SetNumberOfPoints(NUMBER_OF_POINTS);
+  vtkNew<vtkDoubleArray> pointArray;
+  pointArray->SetName("PointValues");
+  pointArray->SetNumberOfComponents(3);
+  pointArray->SetNumberOfTuples(NUMBER_OF_POINTS);
+  vtkNew<vtkDoubleArray> cellArray;
+  cellArray->SetName("CellValues");
+  cellArray->SetNumberOfTuples(1);
+  Fill(points.GetPointer(), pointArray.GetPointer(), cellArray.GetPointer(), 1);
+
+  vtkNew<vtkMultiBlockDataSet> blocks;
+  blocks->SetNumberOfBlocks(NUMBER_OF_BLOCKS);
+  for (unsigned int cc=0; cc < NUMBER_OF_BLOCKS; cc++)
+    {
+    vtkNew<vtkPolyData> block;
+    block->SetPoints(points.GetPointer());
+    block->Allocate(1);
+    vtkIdType ids[2] = { 0, NUMBER_OF_POINTS - 1 };
+    block->InsertNextCell(VTK_LINE, 2, ids);
+    block->GetPointData()->AddArray(pointArray.GetPointer());
+    block->GetCellData()->AddArray(cellArray.GetPointer());
+    blocks->SetBlock(cc, block.GetPointer());
+    }
+
+  for (int scale=1; scale <= 3; scale++)
+    {
+    if (scale > 1)
+      {
+      Fill(points.GetPointer(), pointArray.GetPointer(),
+        cellArray.GetPointer(), scale);
+      }
+    vtkNew<vtkPVDataInformation> info;
+    info->CopyFromObject(blocks.GetPointer());
+    TEST_ASSERT(info->GetNumberOfPoints() == NUMBER_OF_BLOCKS * NUMBER_OF_POINTS);
+    double* bounds = info->GetBounds();
+    TEST_ASSERT(bounds[0] == 0 && bounds[1] == scale);
+    TEST_ASSERT(bounds[2] == 1 && bounds[3] == 1);
+    TEST_ASSERT(bounds[4] == 2 && bounds[5] == 2);
+    TEST_ASSERT(CheckRange(info->GetPointDataInformation(), "PointValues",
+        0, -scale, scale));
+    TEST_ASSERT(CheckRange(info->GetPointDataInformation(), "PointValues",
+        -1, 0, scale));
+    TEST_ASSERT(CheckRange(info->GetCellDataInformation(), "CellValues",
+        0, scale, scale));
+    }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,269 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestSelectionOfInterest.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Tests vtkPVCompositeDataPipeline::SELECTION_OF_INTEREST() with a reader
+// that honours it: the reader re-executes when the selection it read is
+// edited in place or no longer requested, and vtkPVExtractArraysOverTime
+// passes its selection to the reader without updating it out of the
+// pipeline pass, and extracts the right values.
+
+#include "vtkCellArray.h"
+#include "vtkDataArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkDummyController.h"
+#include "vtkIdTypeArray.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPoints.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataAlgorithm.h"
+#include "vtkPVCompositeDataPipeline.h"
+#include "vtkPVExtractArraysOverTime.h"
+#include "vtkSelection.h"
+#include "vtkSelectionNode.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTable.h"
+
+#include <cstdlib>
+#include <set>
+
+#define TEST_ASSERT(condition) \
+  if (!(condition)) \
+    { \
+    cerr << "ERROR: failed at line " << __LINE__ << ": " #condition << endl; \
+    return EXIT_FAILURE; \
+    }
+
+// A reader of 100 points over 5 time steps, with global ids and a Value
+// point array of 10 * id + time. When the selection of interest selects
+// global ids of points, only these points are read.
+class vtkSelectionOfInterestReader : public vtkPolyDataAlgorithm
+{
+public:
+  static vtkSelectionOfInterestReader* New();
+  vtkTypeMacro(vtkSelectionOfInterestReader, vtkPolyDataAlgorithm);
+
+  int Executions;
+  int SelectedExecutions;
+
+protected:
+  vtkSelectionOfInterestReader()
+    {
+    this->SetNumberOfInputPorts(0);
+    this->Executions = 0;
+    this->SelectedExecutions = 0;
+    }
+
+  virtual int RequestInformation(vtkInformation*, vtkInformationVector**,
+                                 vtkInformationVector* outputVector)
+    {
+    vtkInformation* outInfo = outputVector->GetInformationObject(0);
+    double times[5] = { 0, 1, 2, 3, 4 };
+    double range[2] = { 0, 4 };
+    outInfo->Set(vtkStreamingDemandDrivenPipeline::TIME_STEPS(), times, 5);
+    outInfo->Set(vtkStreamingDemandDrivenPipeline::TIME_RANGE(), range, 2);
+    return 1;
+    }
+
+  virtual int RequestData(vtkInformation*, vtkInformationVector**,
+                          vtkInformationVector* outputVector)
+    {
+    vtkInformation* outInfo = outputVector->GetInformationObject(0);
+    vtkPolyData* output = vtkPolyData::GetData(outInfo);
+    double time = 0;
+    if (outInfo->Has(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEP()))
+      {
+      time = outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEP());
+      }
+    this->Executions++;
+
+    std::set<vtkIdType> selected;
+    vtkSelection* selection = vtkSelection::SafeDownCast(
+      outInfo->Get(vtkPVCompositeDataPipeline::SELECTION_OF_INTEREST()));
+    for (unsigned int cc=0; selection && cc < selection->GetNumberOfNodes(); cc++)
+      {
+      vtkSelectionNode* node = selection->GetNode(cc);
+      vtkIdTypeArray* ids =
+        vtkIdTypeArray::SafeDownCast(node->GetSelectionList());
+      if (node->GetFieldType() != vtkSelectionNode::POINT ||
+        node->GetContentType() != vtkSelectionNode::GLOBALIDS || !ids)
+        {
+        selection = NULL;
+        break;
+        }
+      for (vtkIdType kk=0; kk < ids->GetNumberOfTuples(); kk++)
+        {
+        selected.insert(ids->GetValue(kk));
+        }
+      }
+
+    vtkNew<vtkPoints> points;
+    vtkNew<vtkCellArray> verts;
+    vtkNew<vtkIdTypeArray> globalIds;
+    globalIds->SetName("GlobalIds");
+    vtkNew<vtkDoubleArray> values;
+    values->SetName("Value");
+    for (vtkIdType id=0; id < 100; id++)
+      {
+      if (selection && selected.find(id) == selected.end())
+        {
+        continue;
+        }
+      vtkIdType pointId = points->InsertNextPoint(id, 0, 0);
+      verts->InsertNextCell(1, &pointId);
+      globalIds->InsertNextValue(id);
+      values->InsertNextValue(10 * id + time);
+      }
+    output->SetPoints(points.GetPointer());
+    output->SetVerts(verts.GetPointer());
+    output->GetPointData()->SetGlobalIds(globalIds.GetPointer());
+    output->GetPointData()->AddArray(values.GetPointer());
+    output->GetInformation()->Set(vtkDataObject::DATA_TIME_STEP(), time);
+    if (selection)
+      {
+      output->GetInformation()->Set(
+        vtkPVCompositeDataPipeline::SELECTION_OF_INTEREST(), selection);
+      this->SelectedExecutions++;
+      }
+    return 1;
+    }
+
+private:
+  vtkSelectionOfInterestReader(const vtkSelectionOfInterestReader&); // Not implemented
+  void operator=(const vtkSelectionOfInterestReader&); // Not implemented
+};
+
+vtkStandardNewMacro(vtkSelectionOfInterestReader);
+
+namespace
+{
+  // Returns true if the table of each selected id has the values of the
+  // reader for all the time steps.
+  bool CheckValues(vtkDataObject* output, vtkIdType* ids, int numberOfIds)
+    {
+    vtkMultiBlockDataSet* tables = vtkMultiBlockDataSet::SafeDownCast(output);
+    if (!tables ||
+      static_cast<int>(tables->GetNumberOfBlocks()) != numberOfIds)
+      {
+      return false;
+      }
+    std::set<vtkIdType> found;
+    for (unsigned int block=0; block < tables->GetNumberOfBlocks(); block++)
+      {
+      vtkTable* table = vtkTable::SafeDownCast(tables->GetBlock(block));
+      vtkDataArray* globalIds = table? vtkDataArray::SafeDownCast(
+        table->GetColumnByName("GlobalIds")) : NULL;
+      vtkDataArray* values = table? vtkDataArray::SafeDownCast(
+        table->GetColumnByName("Value")) : NULL;
+      if (!globalIds || !values || values->GetNumberOfTuples() != 5)
+        {
+        return false;
+        }
+      vtkIdType id = static_cast<vtkIdType>(globalIds->GetTuple1(0));
+      found.insert(id);
+      for (vtkIdType time=0; time < 5; time++)
+        {
+        if (values->GetTuple1(time) != 10 * id + time)
+          {
+          return false;
+          }
+        }
+      }
+    for (int cc=0; cc < numberOfIds; cc++)
+      {
+      if (found.find(ids[cc]) == found.end())
+        {
+        return false;
+        }
+      }
+    return true;
+    }
+}
+
+//----------------------------------------------------------------------------
+int main(int, char**)
+{
+  vtkNew<vtkDummyController> controller;
+  vtkMultiProcessController::SetGlobalController(controller.GetPointer());
+  vtkNew<vtkPVCompositeDataPipeline> prototype;
+  vtkAlgorithm::SetDefaultExecutivePrototype(prototype.GetPointer());
+
+  vtkNew<vtkSelection> selection;
+  vtkNew<vtkSelectionNode> node;
+  node->SetFieldType(vtkSelectionNode::POINT);
+  node->SetContentType(vtkSelectionNode::GLOBALIDS);
+  vtkNew<vtkIdTypeArray> ids;
+  ids->InsertNextValue(3);
+  ids->InsertNextValue(42);
+  node->SetSelectionList(ids.GetPointer());
+  selection->AddNode(node.GetPointer());
+
+  // The reader re-executes when the selection is edited in place and when
+  // it is no longer requested.
+  vtkNew<vtkSelectionOfInterestReader> reader;
+  vtkInformation* outInfo = reader->GetOutputInformation(0);
+  outInfo->Set(vtkPVCompositeDataPipeline::SELECTION_OF_INTEREST(),
+    selection.GetPointer());
+  reader->Update();
+  TEST_ASSERT(reader->Executions == 1 && reader->SelectedExecutions == 1);
+  TEST_ASSERT(reader->GetOutput()->GetNumberOfPoints() == 2);
+  reader->Update();
+  TEST_ASSERT(reader->Executions == 1);
+  ids->SetValue(1, 7);
+  ids->Modified();
+  node->Modified();
+  reader->Update();
+  TEST_ASSERT(reader->Executions == 2 && reader->SelectedExecutions == 2);
+  TEST_ASSERT(reader->GetOutput()->GetPointData()->GetGlobalIds()->
+    GetTuple1(1) == 7);
+  outInfo->Remove(vtkPVCompositeDataPipeline::SELECTION_OF_INTEREST());
+  reader->Update();
+  TEST_ASSERT(reader->Executions == 3 && reader->SelectedExecutions == 2);
+  TEST_ASSERT(reader->GetOutput()->GetNumberOfPoints() == 100);
+
+  // The first pass reads the first time step completely: the selection is
+  // only produced along with it. The next ones read the selected points.
+  vtkNew<vtkPVExtractArraysOverTime> extractor;
+  extractor->SetInputConnection(0, reader->GetOutputPort());
+  extractor->SetInputData(1, selection.GetPointer());
+  int selectedExecutions = reader->SelectedExecutions;
+  extractor->Update();
+  TEST_ASSERT(reader->SelectedExecutions == selectedExecutions + 4);
+  vtkIdType expected[2] = { 3, 7 };
+  TEST_ASSERT(CheckValues(extractor->GetOutputDataObject(0), expected, 2));
+
+  int executions = reader->Executions;
+  selectedExecutions = reader->SelectedExecutions;
+  extractor->Modified();
+  extractor->Update();
+  TEST_ASSERT(reader->Executions == executions + 5);
+  TEST_ASSERT(reader->SelectedExecutions == selectedExecutions + 5);
+  TEST_ASSERT(CheckValues(extractor->GetOutputDataObject(0), expected, 2));
+
+  // Editing the selection in place gives the values of the new selection.
+  ids->SetValue(0, 55);
+  ids->Modified();
+  node->Modified();
+  extractor->Update();
+  expected[0] = 55;
+  TEST_ASSERT(CheckValues(extractor->GetOutputDataObject(0), expected, 2));
+
+  vtkAlgorithm::SetDefaultExecutivePrototype(NULL);
+  vtkMultiProcessController::SetGlobalController(NULL);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,310 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVBufferedSocketCommunicator.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPVBufferedSocketCommunicator.h"
+
+#include "vtkAbstractArray.h"
+#include "vtkByteSwap.h"
+#include "vtkMultiProcessController.h"
+#include "vtkObjectFactory.h"
+#include "vtkSocket.h"
+
+#include <cstring>
+#include <deque>
+#include <vector>
+
+#if !defined(_WIN32)
+# define PARAVIEW_HAS_NONBLOCKING_RECEIVE
+# include <cerrno>
+# include <sys/socket.h>
+# include <sys/types.h>
+#endif
+
+namespace
+{
+  // vtkSocketCommunicator frames each message with an int tag followed by
+  // an int length (in bytes).
+  const int HEADER_SIZE = static_cast<int>(2*sizeof(int));
+
+  // Size of the RMI trigger message sent by
+  // vtkMultiProcessController::TriggerRMI(), and the size of the arguments
+  // packed in it. Larger arguments are sent in a separate message.
+  const int TRIGGER_MESSAGE_LENGTH = 128;
+  const int INLINE_ARGUMENT_SIZE =
+    static_cast<int>((TRIGGER_MESSAGE_LENGTH - 4)*sizeof(int));
+}
+
+class vtkPVBufferedSocketCommunicator::vtkInternals
+{
+public:
+  struct vtkMessage
+    {
+    int Tag;
+    std::vector<char> Data;
+    };
+
+  // Messages received completely.
+  std::deque<vtkMessage> Messages;
+
+  // The message being received.
+  int Header[2];
+  int HeaderReceived;
+  std::vector<char> Payload;
+  size_t PayloadReceived;
+
+  vtkInternals() : HeaderReceived(0), PayloadReceived(0) {}
+
+  // Returns true if the messages at the head of the queue make up a
+  // complete RMI. Anything else than a trigger message at the head is
+  // reported as complete, ProcessRMIs() will deal with it.
+  bool IsRMIComplete(bool swap)
+    {
+    if (this->Messages.size() == 0)
+      {
+      return false;
+      }
+    vtkMessage& trigger = this->Messages.front();
+    if (trigger.Tag != vtkMultiProcessController::RMI_TAG ||
+      trigger.Data.size() < 2*sizeof(int))
+      {
+      return true;
+      }
+    int argLength;
+    memcpy(&argLength, &trigger.Data[sizeof(int)], sizeof(int));
+    if (swap)
+      {
+      vtkByteSwap::SwapVoidRange(&argLength, 1, sizeof(int));
+      }
+    // the header of the trigger message is sent in little-endian form.
+    vtkByteSwap::SwapLE(&argLength);
+    return argLength < INLINE_ARGUMENT_SIZE || this->Messages.size() >= 2;
+    }
+};
+
+vtkStandardNewMacro(vtkPVBufferedSocketCommunicator);
+//----------------------------------------------------------------------------
+vtkPVBufferedSocketCommunicator::vtkPVBufferedSocketCommunicator()
+{
+  this->Internals = new vtkInternals();
+}
+
+//----------------------------------------------------------------------------
+vtkPVBufferedSocketCommunicator::~vtkPVBufferedSocketCommunicator()
+{
+  delete this->Internals;
+  this->Internals = NULL;
+}
+
+//----------------------------------------------------------------------------
+int vtkPVBufferedSocketCommunicator::ReceiveAvailable()
+{
+  vtkSocket* socket = this->GetSocket();
+  if (!socket || !socket->GetConnected())
+    {
+    return -1;
+    }
+  if (this->HasBufferredMessages())
+    {
+    // messages buffered by vtkSocketCommunicator on a tag mismatch came
+    // first; let ProcessRMIs() receive them.
+    return 1;
+    }
+#ifdef PARAVIEW_HAS_NONBLOCKING_RECEIVE
+  return this->ReadMessages(false);
+#else
+  return 1;
+#endif
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVBufferedSocketCommunicator::HasBufferedRMI()
+{
+  return this->Internals->IsRMIComplete(
+    this->GetSwapBytesInReceivedData() != 0);
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkPVBufferedSocketCommunicator::GetBufferedSize()
+{
+  vtkInternals* internals = this->Internals;
+  vtkIdType size = internals->HeaderReceived +
+    static_cast<vtkIdType>(internals->PayloadReceived);
+  for (size_t cc=0; cc < internals->Messages.size(); cc++)
+    {
+    size += static_cast<vtkIdType>(internals->Messages[cc].Data.size());
+    }
+  return size;
+}
+
+//----------------------------------------------------------------------------
+int vtkPVBufferedSocketCommunicator::ReadMessages(bool blocking)
+{
+  vtkInternals* internals = this->Internals;
+  bool swap = this->GetSwapBytesInReceivedData() != 0;
+  vtkSocket* socket = this->GetSocket();
+  while (!internals->IsRMIComplete(swap))
+    {
+    if (!socket || !socket->GetConnected())
+      {
+      return -1;
+      }
+
+    // read the rest of the header, or of the payload, but nothing past the
+    // end of the message.
+    char* destination;
+    size_t size;
+    if (internals->HeaderReceived < HEADER_SIZE)
+      {
+      destination = reinterpret_cast<char*>(internals->Header) +
+        internals->HeaderReceived;
+      size = static_cast<size_t>(HEADER_SIZE - internals->HeaderReceived);
+      }
+    else
+      {
+      destination = &internals->Payload[internals->PayloadReceived];
+      size = internals->Payload.size() - internals->PayloadReceived;
+      }
+
+    size_t received = 0;
+    if (blocking)
+      {
+      if (socket->Receive(destination, static_cast<int>(size), 1) !=
+        static_cast<int>(size))
+        {
+        return -1;
+        }
+      received = size;
+      }
+    else
+      {
+#ifdef PARAVIEW_HAS_NONBLOCKING_RECEIVE
+      ssize_t result = recv(socket->GetSocketDescriptor(), destination, size,
+        MSG_DONTWAIT);
+      if (result == 0)
+        {
+        // the other end closed the connection.
+        return -1;
+        }
+      if (result < 0)
+        {
+        return (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)?
+          0 : -1;
+        }
+      received = static_cast<size_t>(result);
+#else
+      return 1;
+#endif
+      }
+
+    if (internals->HeaderReceived < HEADER_SIZE)
+      {
+      internals->HeaderReceived += static_cast<int>(received);
+      if (internals->HeaderReceived < HEADER_SIZE)
+        {
+        continue;
+        }
+      if (swap)
+        {
+        vtkByteSwap::SwapVoidRange(internals->Header, 2, sizeof(int));
+        }
+      if (internals->Header[1] < 0)
+        {
+        vtkErrorMacro("Invalid message length " << internals->Header[1]);
+        return -1;
+        }
+      internals->Payload.resize(static_cast<size_t>(internals->Header[1]));
+      internals->PayloadReceived = 0;
+      }
+    else
+      {
+      internals->PayloadReceived += received;
+      }
+
+    if (internals->PayloadReceived == internals->Payload.size())
+      {
+      internals->Messages.push_back(vtkInternals::vtkMessage());
+      internals->Messages.back().Tag = internals->Header[0];
+      internals->Messages.back().Data.swap(internals->Payload);
+      internals->HeaderReceived = 0;
+      internals->PayloadReceived = 0;
+      }
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkPVBufferedSocketCommunicator::ReceiveVoidArray(void* data,
+  vtkIdType length, int type, int remoteHandle, int tag)
+{
+  vtkInternals* internals = this->Internals;
+  if (internals->HeaderReceived == 0 && internals->Messages.size() == 0)
+    {
+    return this->Superclass::ReceiveVoidArray(data, length, type,
+      remoteHandle, tag);
+    }
+
+  // The messages in the socket come after the buffered RMI, so complete it
+  // before anything else is read.
+  if (this->ReadMessages(true) < 0)
+    {
+    return 0;
+    }
+
+  std::deque<vtkInternals::vtkMessage>::iterator iter;
+  for (iter = internals->Messages.begin(); iter != internals->Messages.end();
+    ++iter)
+    {
+    if (iter->Tag == tag)
+      {
+      break;
+      }
+    }
+  if (iter == internals->Messages.end())
+    {
+    // the buffered RMI will be processed later, as if it had been buffered
+    // by vtkSocketCommunicator on a tag mismatch.
+    return this->Superclass::ReceiveVoidArray(data, length, type,
+      remoteHandle, tag);
+    }
+
+  int typeSize = vtkAbstractArray::GetDataTypeSize(type);
+  if (typeSize <= 0)
+    {
+    typeSize = 1;
+    }
+  size_t size = static_cast<size_t>(length) * static_cast<size_t>(typeSize);
+  if (size > iter->Data.size())
+    {
+    size = iter->Data.size();
+    }
+  if (size > 0)
+    {
+    memcpy(data, &iter->Data[0], size);
+    }
+  if (typeSize > 1 && this->GetSwapBytesInReceivedData())
+    {
+    vtkByteSwap::SwapVoidRange(data, static_cast<int>(size/typeSize),
+      typeSize);
+    }
+  this->Count = static_cast<vtkIdType>(size/typeSize);
+  internals->Messages.erase(iter);
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVBufferedSocketCommunicator::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "BufferedSize: " << this->GetBufferedSize() << endl;
+}
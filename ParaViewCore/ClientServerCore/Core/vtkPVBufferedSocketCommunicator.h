@@ -0,0 +1,89 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVBufferedSocketCommunicator.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkPVBufferedSocketCommunicator - socket communicator that receives
+// RMIs without blocking.
+// .SECTION Description
+// vtkPVBufferedSocketCommunicator is the communicator used for the
+// connections created by vtkTCPNetworkAccessManager. ReceiveAvailable()
+// reads whatever has arrived of the next RMI (the trigger message and, for
+// large arguments, the argument message) without blocking, and keeps it in a
+// buffer for the connection until the RMI is complete. ProcessRMIs() on the
+// controller then receives the RMI from that buffer instead of the socket.
+// This way, a connection sending a large message does not block the others
+// while it arrives, whatever the size of the socket's receive buffer.
+//
+// Only the bytes of the RMI are read ahead: messages sent after it, which
+// the RMI callback may receive itself, are left in the socket. When a
+// message is received while an RMI is partially buffered, the RMI is first
+// completed with blocking reads so the order of the messages is preserved.
+// .SECTION Caveats
+// Non-blocking reads are only supported on POSIX platforms. Elsewhere,
+// ReceiveAvailable() always reports the RMI as complete and ProcessRMIs()
+// reads it from the socket, blocking until it has arrived.
+
+#ifndef __vtkPVBufferedSocketCommunicator_h
+#define __vtkPVBufferedSocketCommunicator_h
+
+#include "vtkPVClientServerCoreCoreModule.h" //needed for exports
+#include "vtkSocketCommunicator.h"
+
+class VTKPVCLIENTSERVERCORECORE_EXPORT vtkPVBufferedSocketCommunicator :
+  public vtkSocketCommunicator
+{
+public:
+  static vtkPVBufferedSocketCommunicator* New();
+  vtkTypeMacro(vtkPVBufferedSocketCommunicator, vtkSocketCommunicator);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Reads the part of the next RMI that has arrived, without blocking.
+  // Returns 1 if the RMI is complete and can be processed, 0 if the rest
+  // has yet to arrive and -1 if the connection was closed or failed.
+  int ReceiveAvailable();
+
+  // Description:
+  // Returns true if a complete RMI is waiting in the buffer.
+  bool HasBufferedRMI();
+
+  // Description:
+  // Returns the number of bytes currently held in the buffer.
+  vtkIdType GetBufferedSize();
+
+  // Description:
+  // Overridden to receive the messages of a buffered RMI from the buffer.
+  virtual int ReceiveVoidArray(void* data, vtkIdType length, int type,
+    int remoteHandle, int tag);
+
+//BTX
+protected:
+  vtkPVBufferedSocketCommunicator();
+  ~vtkPVBufferedSocketCommunicator();
+
+  // Description:
+  // Reads messages into the buffer until the RMI at its head is complete.
+  // When blocking is false, stops when no more data is available. Returns
+  // 1 when the RMI is complete, 0 if not and -1 on error.
+  int ReadMessages(bool blocking);
+
+private:
+  vtkPVBufferedSocketCommunicator(const vtkPVBufferedSocketCommunicator&); // Not implemented
+  void operator=(const vtkPVBufferedSocketCommunicator&); // Not implemented
+
+  class vtkInternals;
+  vtkInternals* Internals;
+//ETX
+};
+
+#endif
@@ -204,6 +204,10 @@ void vtkPVCompositeDataInformation::CopyFromObject(vtkObject* object)
   iter->SkipEmptyNodesOff();
 
   // vtkTimerLog::MarkStartEvent("Copying information from composite data");
+  // Information for non-composite children is collected together at the end
+  // so that it can use cached information and multiple threads.
+  std::vector<vtkDataObject*> leaves;
+  std::vector<vtkPVDataInformation*> leafInfos;
   unsigned int index=0;
   for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem(), index++)
     {
@@ -212,7 +216,15 @@ void vtkPVCompositeDataInformation::CopyFromObject(vtkObject* object)
     if (curDO)
       {
       childInfo = vtkSmartPointer<vtkPVDataInformation>::New();
-      childInfo->CopyFromObject(curDO);
+      if (curDO->IsA("vtkCompositeDataSet"))
+        {
+        childInfo->CopyFromObject(curDO);
+        }
+      else
+        {
+        leaves.push_back(curDO);
+        leafInfos.push_back(childInfo);
+        }
       }
     this->Internal->ChildrenInformation.resize(index+1);
     this->Internal->ChildrenInformation[index].Info = childInfo;
@@ -226,6 +238,11 @@ void vtkPVCompositeDataInformation::CopyFromObject(vtkObject* object)
         }
       }
     }
+  if (leaves.size() > 0)
+    {
+    vtkPVDataInformation::CopyFromLeaves(&leaves[0], &leafInfos[0],
+      static_cast<int>(leaves.size()));
+    }
   // vtkTimerLog::MarkEndEvent("Copying information from composite data");
 }
 
@@ -244,7 +261,6 @@ void vtkPVCompositeDataInformation::CopyFromAMR(vtkUniformGridAMR* amr)
 
   // we use this to "simulate" a composite tree from AMR
   vtkNew<vtkMultiPieceDataSet> tempMultiPiece;
-  vtkNew<vtkPVDataInformation> tempDSInfo;
 
   for (unsigned int level=0; level < num_levels; level++)
     {
@@ -255,15 +271,32 @@ void vtkPVCompositeDataInformation::CopyFromAMR(vtkUniformGridAMR* amr)
     levelInfo->CopyFromCompositeDataSetInitialize(tempMultiPiece.GetPointer());
 
     // now fill up levelInfo with meta-data about arrays.
+    std::vector<vtkDataObject*> datasets;
     for (unsigned int idx=0; idx < num_datasets; idx++)
       {
       vtkUniformGrid* dataset = amr->GetDataSet(level, idx);
       if (dataset)
         {
-        tempDSInfo->CopyFromObject(dataset);
-        levelInfo->AddInformation(tempDSInfo.GetPointer(), 1);
+        datasets.push_back(dataset);
         }
       }
+    std::vector<vtkSmartPointer<vtkPVDataInformation> > datasetInfos(
+      datasets.size());
+    std::vector<vtkPVDataInformation*> datasetInfoPointers(datasets.size());
+    for (size_t idx=0; idx < datasets.size(); idx++)
+      {
+      datasetInfos[idx] = vtkSmartPointer<vtkPVDataInformation>::New();
+      datasetInfoPointers[idx] = datasetInfos[idx];
+      }
+    if (datasets.size() > 0)
+      {
+      vtkPVDataInformation::CopyFromLeaves(&datasets[0],
+        &datasetInfoPointers[0], static_cast<int>(datasets.size()));
+      }
+    for (size_t idx=0; idx < datasets.size(); idx++)
+      {
+      levelInfo->AddInformation(datasetInfos[idx], 1);
+      }
     levelInfo->CopyFromCompositeDataSetFinalize(tempMultiPiece.GetPointer());
     this->Internal->ChildrenInformation[level].Info = levelInfo.GetPointer();
     }
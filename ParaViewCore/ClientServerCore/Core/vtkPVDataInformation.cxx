@@ -27,35 +27,126 @@
 #include "vtkDataObjectTypes.h"
 #include "vtkDataSet.h"
 #include "vtkExecutive.h"
+#include "vtkFieldData.h"
 #include "vtkGenericDataSet.h"
 #include "vtkGraph.h"
 #include "vtkImageData.h"
 #include "vtkInformation.h"
+#include "vtkInformationObjectBaseKey.h"
 #include "vtkPVInstantiator.h"
 #include "vtkMath.h"
 #include "vtkMultiProcessController.h"
+#include "vtkMultiPieceDataSet.h"
+#include "vtkMultiThreader.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPointSet.h"
 #include "vtkPVArrayInformation.h"
 #include "vtkPVDataInformationHelper.h"
 #include "vtkPVCompositeDataInformation.h"
 #include "vtkPVDataSetAttributesInformation.h"
 #include "vtkRectilinearGrid.h"
 #include "vtkSelection.h"
+#include "vtkSmartPointer.h"
 #include "vtkStructuredGrid.h"
 #include "vtkTable.h"
 #include "vtkUniformGrid.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkMultiProcessStream.h"
+#include "vtkNew.h"
 
 #include <vector>
 #include <map>
+#include <set>
 #include <string>
 
 vtkStandardNewMacro(vtkPVDataInformation);
+vtkInformationKeyMacro(vtkPVDataInformation, CACHED_DATA_INFORMATION, ObjectBase);
 
 std::map<std::string, std::string> helpers;
 
+namespace
+{
+  // Leaves are only split among threads when each thread gets at least this
+  // many leaves to process.
+  const int MIN_LEAVES_PER_THREAD = 16;
+
+  struct vtkCopyFromLeavesWork
+    {
+    vtkDataObject** Leaves;
+    vtkPVDataInformation** Infos;
+    std::vector<int> Indices; // leaves for which information is collected.
+    };
+
+  VTK_THREAD_RETURN_TYPE vtkCopyFromLeavesThread(void* arg)
+    {
+    vtkMultiThreader::ThreadInfo* threadInfo =
+      static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+    vtkCopyFromLeavesWork* work =
+      static_cast<vtkCopyFromLeavesWork*>(threadInfo->UserData);
+    int count = static_cast<int>(work->Indices.size());
+    for (int cc = threadInfo->ThreadID; cc < count;
+      cc += threadInfo->NumberOfThreads)
+      {
+      int index = work->Indices[cc];
+      work->Infos[index]->CopyFromObject(work->Leaves[index]);
+      }
+    return VTK_THREAD_RETURN_VALUE;
+    }
+
+  // vtkDataArray::GetRange() and vtkPoints::GetBounds() cache their result
+  // in the array, which is not thread safe. Different leaves may share
+  // arrays or points, so these are computed before the leaves are split
+  // among threads, which then only read the cached values.
+  void vtkComputeLeafRanges(vtkDataObject* leaf,
+    std::set<vtkDataArray*>& arrays, std::set<vtkPoints*>& points)
+    {
+    std::vector<vtkDataArray*> leafArrays;
+    vtkPoints* leafPoints = NULL;
+    if (vtkPointSet* ps = vtkPointSet::SafeDownCast(leaf))
+      {
+      leafPoints = ps->GetPoints();
+      }
+    else if (vtkGraph* graph = vtkGraph::SafeDownCast(leaf))
+      {
+      leafPoints = graph->GetPoints();
+      }
+    if (leafPoints && points.insert(leafPoints).second)
+      {
+      double bounds[6];
+      leafPoints->GetBounds(bounds);
+      leafArrays.push_back(leafPoints->GetData());
+      }
+    for (int type=0; type < vtkDataObject::NUMBER_OF_ATTRIBUTE_TYPES; type++)
+      {
+      vtkFieldData* fd = leaf->GetAttributesAsFieldData(type);
+      for (int cc=0; fd && cc < fd->GetNumberOfArrays(); cc++)
+        {
+        leafArrays.push_back(fd->GetArray(cc));
+        }
+      }
+
+    double range[2];
+    for (size_t cc=0; cc < leafArrays.size(); cc++)
+      {
+      vtkDataArray* array = leafArrays[cc];
+      if (!array || !arrays.insert(array).second)
+        {
+        continue;
+        }
+      if (array->GetNumberOfComponents() > 1)
+        {
+        array->GetRange(range, -1);
+        }
+      for (int comp=0; comp < array->GetNumberOfComponents(); comp++)
+        {
+        array->GetRange(range, comp);
+        }
+      }
+    }
+}
+
 //----------------------------------------------------------------------------
 vtkPVDataInformation::vtkPVDataInformation()
 {
@@ -90,6 +181,7 @@ vtkPVDataInformation::vtkPVDataInformation()
 
   this->PortNumber = -1;
   this->SortArrays = true;
+  this->Lightweight = false;
 }
 
 //----------------------------------------------------------------------------
@@ -119,14 +211,15 @@ vtkPVDataInformation::~vtkPVDataInformation()
 //----------------------------------------------------------------------------
 void vtkPVDataInformation::CopyParametersToStream(vtkMultiProcessStream& str)
 {
-  str << 828792 << this->PortNumber;
+  str << 828792 << this->PortNumber << (this->Lightweight? 1 : 0);
 }
 
 //----------------------------------------------------------------------------
 void vtkPVDataInformation::CopyParametersFromStream(vtkMultiProcessStream& str)
 {
-  int magic_number;
-  str >> magic_number >> this->PortNumber;
+  int magic_number, lightweight;
+  str >> magic_number >> this->PortNumber >> lightweight;
+  this->Lightweight = (lightweight != 0);
   if (magic_number != 828792)
     {
     vtkErrorMacro("Magic number mismatch.");
@@ -140,6 +233,7 @@ void vtkPVDataInformation::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os,indent);
 
   os << indent << "PortNumber: " << this->PortNumber << endl;
+  os << indent << "Lightweight: " << this->Lightweight << endl;
   os << indent << "DataSetType: " << this->DataSetType << endl;
   os << indent << "CompositeDataSetType: " << this->CompositeDataSetType << endl;
   os << indent << "NumberOfPoints: " << this->NumberOfPoints << endl;
@@ -299,26 +393,131 @@ void vtkPVDataInformation::DeepCopy(vtkPVDataInformation *dataInfo,
   this->TimeSpan[0] = timespan[0];
   this->TimeSpan[1] = timespan[1];
   this->SetTimeLabel(dataInfo->GetTimeLabel());
+  this->Time = dataInfo->GetTime();
+  this->HasTime = dataInfo->GetHasTime();
 }
 
 //----------------------------------------------------------------------------
 void vtkPVDataInformation::AddFromMultiPieceDataSet(vtkCompositeDataSet* data)
 {
+  std::vector<vtkDataObject*> leaves;
   vtkCompositeDataIterator* iter = data->NewIterator();
   for(iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
     {
     vtkDataObject* dobj = iter->GetCurrentDataObject();
     if (dobj)
       {
-      vtkPVDataInformation* dinf = vtkPVDataInformation::New();
-      dinf->CopyFromObject(dobj);
-      dinf->SetDataClassName(dobj->GetClassName());
-      dinf->DataSetType = dobj->GetDataObjectType();
-      this->AddInformation(dinf, /*addingParts=*/ 1);
-      dinf->FastDelete();
+      leaves.push_back(dobj);
       }
     }
   iter->Delete();
+
+  int count = static_cast<int>(leaves.size());
+  std::vector<vtkSmartPointer<vtkPVDataInformation> > infos(count);
+  std::vector<vtkPVDataInformation*> infoPointers(count);
+  for (int cc=0; cc < count; cc++)
+    {
+    infos[cc] = vtkSmartPointer<vtkPVDataInformation>::New();
+    infos[cc]->SortArrays = this->SortArrays;
+    infoPointers[cc] = infos[cc];
+    }
+  if (count > 0)
+    {
+    vtkPVDataInformation::CopyFromLeaves(&leaves[0], &infoPointers[0], count);
+    }
+
+  for (int cc=0; cc < count; cc++)
+    {
+    vtkPVDataInformation* dinf = infos[cc];
+    dinf->SetDataClassName(leaves[cc]->GetClassName());
+    dinf->DataSetType = leaves[cc]->GetDataObjectType();
+    this->AddInformation(dinf, /*addingParts=*/ 1);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkPVDataInformation::CopyFromLeaves(vtkDataObject** leaves,
+  vtkPVDataInformation** infos, int count)
+{
+  vtkCopyFromLeavesWork work;
+  work.Leaves = leaves;
+  work.Infos = infos;
+
+  // The same block may appear more than once in a composite dataset. It is
+  // processed once, also since threads must not touch the same data object.
+  std::map<vtkDataObject*, int> firstOccurrence;
+  std::vector<std::pair<int, int> > duplicates;
+  for (int cc=0; cc < count; cc++)
+    {
+    vtkDataObject* leaf = leaves[cc];
+    if (!leaf)
+      {
+      continue;
+      }
+    std::pair<std::map<vtkDataObject*, int>::iterator, bool> inserted =
+      firstOccurrence.insert(std::pair<vtkDataObject*, int>(leaf, cc));
+    if (!inserted.second)
+      {
+      duplicates.push_back(std::pair<int, int>(cc, inserted.first->second));
+      continue;
+      }
+
+    vtkPVDataInformation* cached = vtkPVDataInformation::SafeDownCast(
+      leaf->GetInformation()->Get(
+        vtkPVDataInformation::CACHED_DATA_INFORMATION()));
+    if (cached && cached->GetMTime() > leaf->GetMTime() &&
+      cached->SortArrays == infos[cc]->SortArrays)
+      {
+      infos[cc]->DeepCopy(cached, false);
+      }
+    else
+      {
+      work.Indices.push_back(cc);
+      }
+    }
+
+  int numberOfThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  int maxThreads = static_cast<int>(work.Indices.size()) / MIN_LEAVES_PER_THREAD;
+  numberOfThreads = numberOfThreads < maxThreads? numberOfThreads : maxThreads;
+  if (numberOfThreads > 1)
+    {
+    std::set<vtkDataArray*> arrays;
+    std::set<vtkPoints*> points;
+    for (size_t cc=0; cc < work.Indices.size(); cc++)
+      {
+      vtkComputeLeafRanges(leaves[work.Indices[cc]], arrays, points);
+      }
+    vtkNew<vtkMultiThreader> threader;
+    threader->SetNumberOfThreads(numberOfThreads);
+    threader->SetSingleMethod(vtkCopyFromLeavesThread, &work);
+    threader->SingleMethodExecute();
+    }
+  else
+    {
+    for (size_t cc=0; cc < work.Indices.size(); cc++)
+      {
+      infos[work.Indices[cc]]->CopyFromObject(leaves[work.Indices[cc]]);
+      }
+    }
+
+  // Cache a copy of the newly collected information on the leaves. A copy is
+  // needed since the information returned may be modified by the caller, e.g.
+  // when merging information from other processes.
+  for (size_t cc=0; cc < work.Indices.size(); cc++)
+    {
+    int index = work.Indices[cc];
+    vtkNew<vtkPVDataInformation> cached;
+    cached->SortArrays = infos[index]->SortArrays;
+    cached->DeepCopy(infos[index], false);
+    cached->Modified();
+    leaves[index]->GetInformation()->Set(
+      vtkPVDataInformation::CACHED_DATA_INFORMATION(), cached.GetPointer());
+    }
+
+  for (size_t cc=0; cc < duplicates.size(); cc++)
+    {
+    infos[duplicates[cc].first]->DeepCopy(infos[duplicates[cc].second], false);
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -348,6 +547,24 @@ void vtkPVDataInformation::CopyFromCompositeDataSetFinalize(
 //----------------------------------------------------------------------------
 void vtkPVDataInformation::CopyFromCompositeDataSet(vtkCompositeDataSet* data)
 {
+  if (this->Lightweight)
+    {
+    // Don't collect information about the individual blocks, simply
+    // accumulate information from all leaves.
+    this->Initialize();
+    this->CompositeDataInformation->DataIsComposite = 1;
+    vtkMultiPieceDataSet* mpDS = vtkMultiPieceDataSet::SafeDownCast(data);
+    if (mpDS)
+      {
+      this->CompositeDataInformation->DataIsMultiPiece = 1;
+      this->CompositeDataInformation->SetNumberOfPieces(
+        mpDS->GetNumberOfPieces());
+      }
+    this->AddFromMultiPieceDataSet(data);
+    this->CopyFromCompositeDataSetFinalize(data);
+    return;
+    }
+
   this->CopyFromCompositeDataSetInitialize(data);
 
   unsigned int numDataSets = this->CompositeDataInformation->GetNumberOfChildren();
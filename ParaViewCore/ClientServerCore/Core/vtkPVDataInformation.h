@@ -37,6 +37,7 @@ class vtkDataSet;
 class vtkGenericDataSet;
 class vtkGraph;
 class vtkInformation;
+class vtkInformationObjectBaseKey;
 class vtkPVArrayInformation;
 class vtkPVCompositeDataInformation;
 class vtkPVDataSetAttributesInformation;
@@ -202,6 +203,25 @@ public:
   vtkGetMacro(SortArrays, bool);
   void SetSortArrays(bool);
 
+  // Description:
+  // When set, information about the individual blocks of a composite dataset
+  // is not collected i.e. GetCompositeDataInformation() only reports whether
+  // the data is composite but has no children. The summary information
+  // (bounds, arrays, counts etc.) is still computed from all the leaves. This
+  // is much cheaper for composite datasets with a large number of blocks and
+  // can be used when the block hierarchy is not needed. Like PortNumber,
+  // this can be set on the client-side before gathering the information.
+  // Off by default.
+  vtkSetMacro(Lightweight, bool);
+  vtkGetMacro(Lightweight, bool);
+  vtkBooleanMacro(Lightweight, bool);
+
+  // Description:
+  // Key used to cache the information collected for a leaf block of a
+  // composite dataset in the block's vtkInformation. The cached information
+  // is reused as long as the block has not been modified since.
+  static vtkInformationObjectBaseKey* CACHED_DATA_INFORMATION();
+
 protected:
   vtkPVDataInformation();
   ~vtkPVDataInformation();
@@ -219,6 +239,14 @@ protected:
   void CopyFromSelection(vtkSelection* selection);
   void CopyCommonMetaData(vtkDataObject*, vtkInformation*);
 
+  // Description:
+  // Fills infos[i] with information about leaves[i] for the given
+  // non-composite data objects. Information cached on a leaf using
+  // CACHED_DATA_INFORMATION() is reused when still valid, the rest is
+  // collected using multiple threads when there are enough leaves.
+  static void CopyFromLeaves(vtkDataObject** leaves,
+    vtkPVDataInformation** infos, int count);
+
   static vtkPVDataInformationHelper *FindHelper(const char *classname);
 
   // Data information collected from remote processes.
@@ -264,6 +292,7 @@ private:
 
   int PortNumber;
   bool SortArrays;
+  bool Lightweight;
 };
 
 #endif
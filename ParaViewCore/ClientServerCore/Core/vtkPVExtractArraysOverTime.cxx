@@ -14,9 +14,19 @@
 =========================================================================*/
 #include "vtkPVExtractArraysOverTime.h"
 
+#include "vtkDataObject.h"
+#include "vtkDemandDrivenPipeline.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkMultiProcessController.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
+#include "vtkPVCompositeDataPipeline.h"
 #include "vtkPVExtractSelection.h"
+#include "vtkSelection.h"
+#include "vtkSelectionNode.h"
+#include "vtkSmartPointer.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
 
 vtkStandardNewMacro(vtkPVExtractArraysOverTime);
 
@@ -25,6 +35,8 @@ vtkPVExtractArraysOverTime::vtkPVExtractArraysOverTime()
 {
   vtkNew<vtkPVExtractSelection> se;
   this->SetSelectionExtractor(se.GetPointer());
+  this->DistributeTimeSteps = false;
+  this->NumberOfTimeStepGroups = 2;
 }
 
 //----------------------------------------------------------------------------
@@ -32,8 +44,156 @@ vtkPVExtractArraysOverTime::~vtkPVExtractArraysOverTime()
 {
 }
 
+//----------------------------------------------------------------------------
+bool vtkPVExtractArraysOverTime::UseDistributedTimeSteps(vtkSelection* selection)
+{
+  if (!this->DistributeTimeSteps || !selection || !this->Controller ||
+    this->Controller->GetNumberOfProcesses() <= 1)
+    {
+    return false;
+    }
+
+  for (unsigned int cc=0; cc < selection->GetNumberOfNodes(); cc++)
+    {
+    vtkSelectionNode* node = selection->GetNode(cc);
+    if (node && node->GetContentType() == vtkSelectionNode::INDICES)
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+int vtkPVExtractArraysOverTime::GetNumberOfGroups()
+{
+  int numProcs = this->Controller->GetNumberOfProcesses();
+  return this->NumberOfTimeStepGroups < numProcs?
+    this->NumberOfTimeStepGroups : numProcs;
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVExtractArraysOverTime::IsLocalTimeStep(int index)
+{
+  int groups = this->GetNumberOfGroups();
+  return (index % groups) == (this->Controller->GetLocalProcessId() % groups);
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVExtractArraysOverTime::IsSelectionUpToDate(vtkSelection* selection)
+{
+  // The selection input is updated after the data input, so when it has
+  // changed, the selection at hand is the previous one until the data of the
+  // current time step is produced.
+  vtkDemandDrivenPipeline* executive =
+    vtkDemandDrivenPipeline::SafeDownCast(this->GetInputExecutive(1, 0));
+  return executive &&
+    selection->GetUpdateTime() > executive->GetPipelineMTime() &&
+    selection->GetUpdateTime() > selection->GetMTime();
+}
+
+//----------------------------------------------------------------------------
+int vtkPVExtractArraysOverTime::RequestUpdateExtent(
+  vtkInformation* request,
+  vtkInformationVector** inputVector,
+  vtkInformationVector* outputVector)
+{
+  if (!this->Superclass::RequestUpdateExtent(request, inputVector, outputVector))
+    {
+    return 0;
+    }
+
+  // Pass the selection upstream when it is the one the time steps are
+  // extracted with; otherwise, this time step is read completely.
+  vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+  vtkSelection* selection = vtkSelection::GetData(inputVector[1], 0);
+  if (selection && selection->GetNumberOfNodes() > 0 &&
+    this->IsSelectionUpToDate(selection))
+    {
+    inInfo->Set(vtkPVCompositeDataPipeline::SELECTION_OF_INTEREST(), selection);
+    }
+  else
+    {
+    inInfo->Remove(vtkPVCompositeDataPipeline::SELECTION_OF_INTEREST());
+    }
+
+  if (!this->UseDistributedTimeSteps(selection))
+    {
+    return 1;
+    }
+
+  // Each process requests its piece of the dataset split among its group.
+  // The ghost levels requested downstream are kept.
+  int numProcs = this->Controller->GetNumberOfProcesses();
+  int myId = this->Controller->GetLocalProcessId();
+  int groups = this->GetNumberOfGroups();
+  int group = myId % groups;
+  inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_PIECE_NUMBER(),
+    myId / groups);
+  inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_PIECES(),
+    (numProcs - group + groups - 1) / groups);
+
+  // For time steps processed by other groups, request the nearest local
+  // time step instead, so that the upstream pipeline does not execute for
+  // the skipped time steps.
+  double* inTimes = inInfo->Get(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+  if (inTimes && !this->IsLocalTimeStep(this->CurrentTimeIndex))
+    {
+    int next = this->CurrentTimeIndex +
+      (group - this->CurrentTimeIndex % groups + groups) % groups;
+    int index = (next < this->NumberOfTimeSteps)? next : next - groups;
+    if (index >= 0)
+      {
+      inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEP(),
+        inTimes[index]);
+      }
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkPVExtractArraysOverTime::RequestData(
+  vtkInformation* request,
+  vtkInformationVector** inputVector,
+  vtkInformationVector* outputVector)
+{
+  vtkSelection* selection = vtkSelection::GetData(inputVector[1], 0);
+  if (!this->UseDistributedTimeSteps(selection) ||
+    this->IsLocalTimeStep(this->CurrentTimeIndex))
+    {
+    return this->Superclass::RequestData(request, inputVector, outputVector);
+    }
+
+  // This time step is processed by another group. Let the superclass see
+  // an empty dataset so nothing is extracted here; the values are added when
+  // the results from all processes are gathered.
+  vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+  vtkSmartPointer<vtkDataObject> input = inInfo->Get(vtkDataObject::DATA_OBJECT());
+  if (!input)
+    {
+    return this->Superclass::RequestData(request, inputVector, outputVector);
+    }
+
+  vtkSmartPointer<vtkDataObject> empty;
+  empty.TakeReference(input->NewInstance());
+  double* inTimes = inInfo->Get(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+  if (inTimes)
+    {
+    empty->GetInformation()->Set(vtkDataObject::DATA_TIME_STEP(),
+      inTimes[this->CurrentTimeIndex]);
+    }
+
+  inInfo->Set(vtkDataObject::DATA_OBJECT(), empty);
+  int retVal = this->Superclass::RequestData(request, inputVector, outputVector);
+  inInfo->Set(vtkDataObject::DATA_OBJECT(), input);
+  return retVal;
+}
+
 //----------------------------------------------------------------------------
 void vtkPVExtractArraysOverTime::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
+  os << indent << "DistributeTimeSteps: " << this->DistributeTimeSteps << endl;
+  os << indent << "NumberOfTimeStepGroups: "
+     << this->NumberOfTimeStepGroups << endl;
 }
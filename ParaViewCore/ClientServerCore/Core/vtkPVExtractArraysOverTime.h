@@ -18,6 +18,16 @@
 // that overrides the default SelectionExtractor with a vtkPVExtractSelection
 // instance.
 // This enables query selections to be extracted at each time step.
+//
+// The selection is also passed upstream as the selection of interest (see
+// vtkPVCompositeDataPipeline::SELECTION_OF_INTEREST()) so that readers
+// supporting it only read the selected elements for each time step.
+//
+// When DistributeTimeSteps is enabled, the processes are split into
+// NumberOfTimeStepGroups groups and time steps are distributed among the
+// groups in a round-robin fashion. The processes of a group each request
+// their piece of the dataset, but only for the time steps assigned to the
+// group, and the results are gathered on the root node as usual.
 // .SECTION See Also
 // vtkExtractArraysOverTime
 // vtkPExtractArraysOverTime
@@ -28,6 +38,8 @@
 #include "vtkPVClientServerCoreCoreModule.h" // For export macro
 #include "vtkPExtractArraysOverTime.h"
 
+class vtkSelection;
+
 class VTKPVCLIENTSERVERCORECORE_EXPORT vtkPVExtractArraysOverTime : public vtkPExtractArraysOverTime
 {
 public:
@@ -35,10 +47,61 @@ public:
   vtkTypeMacro(vtkPVExtractArraysOverTime,vtkPExtractArraysOverTime);
   void PrintSelf(ostream& os, vtkIndent indent);
 
+  // Description:
+  // When set, each time step is processed by a single group of processes, in
+  // a round-robin fashion, instead of every process updating its piece for
+  // every time step. The processes of a group request the pieces of the
+  // dataset split among the group, so this works best with readers that
+  // honour the selection of interest. It is ignored for index based
+  // selections, since the indices are only valid for the piece they were
+  // selected on, and requires that the upstream pipeline does not
+  // communicate between processes. Off by default.
+  vtkSetMacro(DistributeTimeSteps, bool);
+  vtkGetMacro(DistributeTimeSteps, bool);
+  vtkBooleanMacro(DistributeTimeSteps, bool);
+
+  // Description:
+  // The number of groups of processes the time steps are distributed among
+  // when DistributeTimeSteps is set. Process i belongs to group
+  // i % NumberOfTimeStepGroups. It is clamped to the number of processes.
+  // 2 by default.
+  vtkSetClampMacro(NumberOfTimeStepGroups, int, 1, VTK_INT_MAX);
+  vtkGetMacro(NumberOfTimeStepGroups, int);
+
 protected:
   vtkPVExtractArraysOverTime();
   ~vtkPVExtractArraysOverTime();
 
+  virtual int RequestUpdateExtent(vtkInformation* request,
+                                  vtkInformationVector** inputVector,
+                                  vtkInformationVector* outputVector);
+  virtual int RequestData(vtkInformation* request,
+                          vtkInformationVector** inputVector,
+                          vtkInformationVector* outputVector);
+
+  // Description:
+  // Returns true if time steps are to be distributed among processes for the
+  // given selection.
+  bool UseDistributedTimeSteps(vtkSelection* selection);
+
+  // Description:
+  // Returns the number of groups the processes are split into when
+  // distributing time steps.
+  int GetNumberOfGroups();
+
+  // Description:
+  // Returns true if the time step at the given index is processed by the
+  // group of this process when distributing time steps.
+  bool IsLocalTimeStep(int index);
+
+  // Description:
+  // Returns true if the selection on the second input was produced by the
+  // current pipeline, i.e. it is not about to be updated.
+  bool IsSelectionUpToDate(vtkSelection* selection);
+
+  bool DistributeTimeSteps;
+  int NumberOfTimeStepGroups;
+
 private:
   vtkPVExtractArraysOverTime(const vtkPVExtractArraysOverTime&);  // Not implemented.
   void operator=(const vtkPVExtractArraysOverTime&);  // Not implemented.
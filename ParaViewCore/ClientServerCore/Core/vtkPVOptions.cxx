@@ -63,6 +63,7 @@ vtkPVOptions::vtkPVOptions()
 
   this->RenderServerMode = 0;
   this->SymmetricMPIMode = 0;
+  this->NumberOfTimeCompartments = 1;
 
   this->TellVersion = 0;
 
@@ -236,6 +237,13 @@ void vtkPVOptions::Initialize()
     "When specified, the python script is processed symmetrically on all processes.",
     vtkPVOptions::PVBATCH);
 
+  this->AddArgument("--time-compartments", 0,
+    &this->NumberOfTimeCompartments,
+    "When specified with a value greater than 1, processes are split into "
+    "that many groups and animation frames are rendered by the groups in "
+    "parallel. The number of processes must be a multiple of this value.",
+    vtkPVOptions::PVBATCH);
+
   this->AddBooleanArgument("--enable-streaming", 0, &this->EnableStreaming,
     "EXPERIMENTAL: When specified, view-based streaming is enabled for certain "
     "views and representation types.",
@@ -285,6 +293,11 @@ int vtkPVOptions::PostProcess(int, const char* const*)
       break;
     }
 
+  if (this->NumberOfTimeCompartments < 1)
+    {
+    this->NumberOfTimeCompartments = 1;
+    }
+
   if ( this->TileDimensions[0] > 0 || this->TileDimensions[1] > 0 )
     {
     if ( this->TileDimensions[0] <= 0 )
@@ -409,6 +422,8 @@ void vtkPVOptions::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "LogFileName: "
     << (this->LogFileName? this->LogFileName : "(none)") << endl;
   os << indent << "SymmetricMPIMode: " << this->SymmetricMPIMode << endl;
+  os << indent << "NumberOfTimeCompartments: "
+     << this->NumberOfTimeCompartments << endl;
   os << indent << "ServerURL: "
      << (this->ServerURL? this->ServerURL : "(none)") << endl;
   os << indent << "EnableStreaming:" <<
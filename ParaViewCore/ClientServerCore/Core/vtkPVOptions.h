@@ -105,6 +105,15 @@ public:
   vtkGetMacro(SymmetricMPIMode, int);
   vtkSetMacro(SymmetricMPIMode, int);
 
+  // Description:
+  // Number of time compartments requested for time-parallel animation
+  // saving. This is applicable only to PVBATCH type of processes. When greater
+  // than 1, the MPI processes are split into that many groups of consecutive
+  // ranks and each group renders an interleaved subset of the animation
+  // frames. Default is 1 i.e. all processes work on every frame.
+  vtkGetMacro(NumberOfTimeCompartments, int);
+  vtkSetMacro(NumberOfTimeCompartments, int);
+
   // Description:
   // Should this run print the version numbers and exit.
   vtkGetMacro(TellVersion, int);
@@ -197,6 +206,8 @@ protected:
 
   int SymmetricMPIMode;
 
+  int NumberOfTimeCompartments;
+
   // Command Option for loading state file(Bug #5711)
   vtkSetStringMacro(StateFileName);
   char* StateFileName;
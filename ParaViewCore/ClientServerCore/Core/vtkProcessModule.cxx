@@ -54,6 +54,8 @@ bool vtkProcessModule::FinalizePython = false;
 
 vtkSmartPointer<vtkProcessModule> vtkProcessModule::Singleton;
 vtkSmartPointer<vtkMultiProcessController> vtkProcessModule::GlobalController;
+vtkSmartPointer<vtkMultiProcessController>
+vtkProcessModule::TimeCompartmentController;
 
 //----------------------------------------------------------------------------
 bool vtkProcessModule::Initialize(ProcessTypes type, int &argc, char** &argv)
@@ -206,6 +208,7 @@ bool vtkProcessModule::Finalize()
   // it's really stored with a weak pointer.  We set it to null anyways
   // in case it gets changed later to reference counting the pointer
   vtkMultiProcessController::SetGlobalController(NULL);
+  vtkProcessModule::TimeCompartmentController = NULL;
   vtkProcessModule::GlobalController->Finalize(/*finalizedExternally*/1);
   vtkProcessModule::GlobalController = NULL;
 
@@ -257,6 +260,8 @@ vtkProcessModule::vtkProcessModule()
   this->MaxSessionId = 0;
   this->ReportInterpreterErrors = true;
   this->SymmetricMPIMode = false;
+  this->TimeCompartmentId = 0;
+  this->NumberOfTimeCompartments = 1;
   this->MultipleSessionsSupport = false; // Set MULTI-SERVER to false as DEFAULT
   this->EventCallDataSessionId = 0;
 
@@ -437,7 +442,60 @@ void vtkProcessModule::SetOptions(vtkPVOptions* options)
     {
     this->SetSymmetricMPIMode(
       options->GetSymmetricMPIMode() != 0);
+    if (vtkProcessModule::ProcessType == PROCESS_BATCH &&
+      options->GetNumberOfTimeCompartments() > 1 &&
+      this->NumberOfTimeCompartments == 1)
+      {
+      this->InitializeTimeCompartments(
+        options->GetNumberOfTimeCompartments());
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+bool vtkProcessModule::InitializeTimeCompartments(int count)
+{
+  vtkMultiProcessController* controller = vtkProcessModule::GlobalController;
+  int numProcs = controller? controller->GetNumberOfProcesses() : 1;
+  if (count <= 1 || numProcs <= 1)
+    {
+    return true;
+    }
+
+  if (count > numProcs)
+    {
+    vtkWarningMacro("Cannot create " << count << " time compartments with "
+      << numProcs << " processes. Using " << numProcs << " instead.");
+    count = numProcs;
+    }
+  if (numProcs % count != 0)
+    {
+    vtkErrorMacro("Number of processes (" << numProcs << ") must be an "
+      "integer multiple of the number of time compartments (" << count
+      << "). Time compartments will not be used.");
+    return false;
+    }
+
+  // Consecutive ranks are grouped together so that each compartment is as
+  // local as possible e.g. ranks on the same node render the same frame.
+  int compartmentSize = numProcs / count;
+  int rank = controller->GetLocalProcessId();
+  int compartmentId = rank / compartmentSize;
+
+  vtkMultiProcessController* subController =
+    controller->PartitionController(compartmentId, rank % compartmentSize);
+  if (!subController)
+    {
+    vtkErrorMacro("Failed to partition the global controller. "
+      "Time compartments will not be used.");
+    return false;
     }
+  vtkProcessModule::TimeCompartmentController.TakeReference(subController);
+  vtkMultiProcessController::SetGlobalController(subController);
+
+  this->TimeCompartmentId = compartmentId;
+  this->NumberOfTimeCompartments = count;
+  return true;
 }
 
 //----------------------------------------------------------------------------
@@ -496,4 +554,7 @@ void vtkProcessModule::PrintSelf(ostream& os, vtkIndent indent)
     {
     os << indent << "Options: " << "(null)" << endl;
     }
+  os << indent << "TimeCompartmentId: " << this->TimeCompartmentId << endl;
+  os << indent << "NumberOfTimeCompartments: "
+     << this->NumberOfTimeCompartments << endl;
 }
@@ -206,6 +206,16 @@ public:
   // implies that satellites process same code as the root node. This is
   // applicable only for PROCESS_BATCH.
   vtkGetMacro(SymmetricMPIMode, bool);
+
+  // Description:
+  // Returns the time compartment this process belongs to and the total number
+  // of time compartments. Time compartments are set up for PROCESS_BATCH when
+  // vtkPVOptions::GetNumberOfTimeCompartments() is greater than 1. In that
+  // case, the global controller is partitioned into groups of consecutive
+  // ranks and GetGlobalController() returns the controller for the group this
+  // process belongs to. Defaults to 0 and 1 respectively.
+  vtkGetMacro(TimeCompartmentId, int);
+  vtkGetMacro(NumberOfTimeCompartments, int);
 //BTX
 protected:
   vtkProcessModule();
@@ -213,6 +223,11 @@ protected:
 
   vtkSetMacro(SymmetricMPIMode, bool);
 
+  // Description:
+  // Partitions the global controller into \c count time compartments. Called
+  // in SetOptions(). Returns false if the processes could not be partitioned.
+  bool InitializeTimeCompartments(int count);
+
   // Description:
   // Push/Pop the active session.
   void PushActiveSession(vtkSession*);
@@ -260,8 +275,15 @@ private:
   static vtkSmartPointer<vtkProcessModule> Singleton;
   static vtkSmartPointer<vtkMultiProcessController> GlobalController;
 
+  // Controller for the time compartment, if any. When set, this is the
+  // controller returned by vtkMultiProcessController::GetGlobalController().
+  static vtkSmartPointer<vtkMultiProcessController> TimeCompartmentController;
+
   bool SymmetricMPIMode;
 
+  int TimeCompartmentId;
+  int NumberOfTimeCompartments;
+
   bool MultipleSessionsSupport;
 
   vtkIdType EventCallDataSessionId;
@@ -0,0 +1,321 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPythonImportBroadcaster.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPython.h" // python first
+#include "vtkPythonImportBroadcaster.h"
+
+#include "vtkMultiProcessController.h"
+#include "vtkObjectFactory.h"
+#include "vtkPythonInterpreter.h"
+#include "vtkTimerLog.h"
+
+#include <vector>
+#include <vtksys/ios/sstream>
+
+namespace
+{
+  // Returns str as a Python string literal.
+  std::string vtkPythonQuote(const std::string& str)
+    {
+    std::string quoted = "'";
+    for (size_t cc=0; cc < str.size(); cc++)
+      {
+      if (str[cc] == '\\' || str[cc] == '\'')
+        {
+        quoted += '\\';
+        }
+      quoted += str[cc];
+      }
+    return quoted + "'";
+    }
+
+  // Runs code in a new namespace, in which the given variable is set to
+  // value (if not NULL). Returns the namespace (new reference), or NULL if
+  // the code raised an exception.
+  PyObject* vtkPythonRun(const std::string& code, const char* variable,
+    PyObject* value)
+    {
+    PyObject* globals = PyDict_New();
+    PyDict_SetItemString(globals, "__builtins__", PyEval_GetBuiltins());
+    if (variable && value)
+      {
+      PyDict_SetItemString(globals, variable, value);
+      }
+    PyObject* result = PyRun_String(code.c_str(), Py_file_input, globals,
+      globals);
+    if (!result)
+      {
+      PyErr_Print();
+      Py_DECREF(globals);
+      return NULL;
+      }
+    Py_DECREF(result);
+    return globals;
+    }
+
+  // Defines collect(packages, files), which returns the marshalled archive:
+  // a dictionary that maps each module name to (is_package, __file__,
+  // __path__, code). Modules with syntax errors are left out so that their
+  // import reports the error as usual.
+  const char* vtkCollectSource =
+    "import imp, marshal, os\n"
+    "def collect(packages, files):\n"
+    "  modules = {}\n"
+    "  def add(name, is_package, file_name, path):\n"
+    "    source = open(file_name, 'rU').read()\n"
+    "    try:\n"
+    "      code = compile(source + '\\n', file_name, 'exec')\n"
+    "    except SyntaxError:\n"
+    "      return\n"
+    "    modules[name] = (is_package, file_name, path, code)\n"
+    "  extensions = tuple([s[0] for s in imp.get_suffixes()\n"
+    "    if s[2] == imp.C_EXTENSION])\n"
+    "  for package in packages:\n"
+    "    f, directory, description = imp.find_module(package)\n"
+    "    if f:\n"
+    "      f.close()\n"
+    "    if description[2] == imp.PY_SOURCE:\n"
+    "      add(package, False, directory, None)\n"
+    "      continue\n"
+    "    if description[2] != imp.PKG_DIRECTORY:\n"
+    "      continue\n"
+    "    for root, dirs, names in os.walk(directory):\n"
+    "      if '__init__.py' not in names:\n"
+    "        del dirs[:]\n"
+    "        continue\n"
+    "      prefix = package + root[len(directory):].replace(os.sep, '.')\n"
+    // Packages only keep their directory in __path__ when it has extension
+    // modules: otherwise every implicit relative import (e.g. "import os"
+    // in a package module) would look for files in it first.
+    "      path = []\n"
+    "      if [n for n in names if n.endswith(extensions)]:\n"
+    "        path = [root]\n"
+    "      for name in names:\n"
+    "        base, ext = os.path.splitext(name)\n"
+    "        if ext != '.py':\n"
+    "          continue\n"
+    "        if base == '__init__':\n"
+    "          add(prefix, True, os.path.join(root, name), path)\n"
+    "        else:\n"
+    "          add(prefix + '.' + base, False, os.path.join(root, name), None)\n"
+    "  for file_name in files:\n"
+    "    name = os.path.splitext(os.path.basename(file_name))[0]\n"
+    "    add(name, False, os.path.abspath(file_name), None)\n"
+    "  return marshal.dumps(modules)\n";
+
+  // Defines the importer in the "_paraview_import_broadcaster" module and
+  // adds it at the front of sys.meta_path, unless this was done already.
+  // Then adds the modules of the archive to it.
+  const char* vtkInstallSource =
+    "import imp, sys\n"
+    "name = '_paraview_import_broadcaster'\n"
+    "if name not in sys.modules:\n"
+    "  module = imp.new_module(name)\n"
+    "  exec '''\n"
+    "import imp, marshal, sys\n"
+    "class Importer(object):\n"
+    "  def __init__(self):\n"
+    "    self.modules = {}\n"
+    "  def add(self, archive):\n"
+    "    self.modules.update(marshal.loads(archive))\n"
+    "  def find_module(self, fullname, path=None):\n"
+    "    if fullname in self.modules:\n"
+    "      return self\n"
+    "    return None\n"
+    "  def load_module(self, fullname):\n"
+    "    is_package, file_name, path, code = self.modules[fullname]\n"
+    "    module = sys.modules.setdefault(fullname, imp.new_module(fullname))\n"
+    "    module.__file__ = file_name\n"
+    "    module.__loader__ = self\n"
+    "    if is_package:\n"
+    "      module.__path__ = list(path)\n"
+    "      module.__package__ = fullname\n"
+    "    else:\n"
+    "      module.__package__ = fullname.rpartition('.')[0]\n"
+    "    try:\n"
+    "      exec code in module.__dict__\n"
+    "    except:\n"
+    "      del sys.modules[fullname]\n"
+    "      raise\n"
+    "    return module\n"
+    "importer = Importer()\n"
+    "''' in module.__dict__\n"
+    "  sys.modules[name] = module\n"
+    "  sys.meta_path.insert(0, module.importer)\n"
+    "sys.modules[name].importer.add(archive)\n";
+}
+
+//****************************************************************************
+class vtkPythonImportBroadcaster::vtkInternals
+{
+public:
+  std::vector<std::string> Packages;
+  std::vector<std::string> ModuleFiles;
+};
+
+vtkStandardNewMacro(vtkPythonImportBroadcaster);
+vtkCxxSetObjectMacro(vtkPythonImportBroadcaster, Controller,
+  vtkMultiProcessController);
+//----------------------------------------------------------------------------
+vtkPythonImportBroadcaster::vtkPythonImportBroadcaster()
+{
+  this->Controller = NULL;
+  this->SetController(vtkMultiProcessController::GetGlobalController());
+  this->ArchiveSize = 0;
+  this->Internals = new vtkInternals();
+}
+
+//----------------------------------------------------------------------------
+vtkPythonImportBroadcaster::~vtkPythonImportBroadcaster()
+{
+  this->SetController(NULL);
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+void vtkPythonImportBroadcaster::AddPackage(const char* name)
+{
+  if (name && *name)
+    {
+    this->Internals->Packages.push_back(name);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkPythonImportBroadcaster::AddModuleFile(const char* fileName)
+{
+  if (fileName && *fileName)
+    {
+    this->Internals->ModuleFiles.push_back(fileName);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkPythonImportBroadcaster::RemoveAllModules()
+{
+  this->Internals->Packages.clear();
+  this->Internals->ModuleFiles.clear();
+}
+
+//----------------------------------------------------------------------------
+int vtkPythonImportBroadcaster::Broadcast()
+{
+  if (!vtkPythonInterpreter::IsInitialized())
+    {
+    vtkErrorMacro("Python must be initialized before broadcasting modules.");
+    return 0;
+    }
+
+  vtkTimerLog::MarkStartEvent("vtkPythonImportBroadcaster::Broadcast");
+  vtkMultiProcessController* controller = this->Controller;
+  int rank = controller? controller->GetLocalProcessId() : 0;
+
+  // size is -1 when the root process failed to read the modules.
+  std::string archive;
+  vtkIdType size = -1;
+  if (rank == 0 && this->ReadArchive(archive))
+    {
+    size = static_cast<vtkIdType>(archive.size());
+    }
+  if (controller && controller->GetNumberOfProcesses() > 1)
+    {
+    controller->Broadcast(&size, 1, 0);
+    if (size > 0)
+      {
+      archive.resize(size);
+      controller->Broadcast(&archive[0], size, 0);
+      }
+    }
+
+  this->ArchiveSize = size > 0? size : 0;
+  bool status = size >= 0 && this->InstallArchive(archive);
+  vtkTimerLog::MarkEndEvent("vtkPythonImportBroadcaster::Broadcast");
+  return status? 1 : 0;
+}
+
+//----------------------------------------------------------------------------
+bool vtkPythonImportBroadcaster::ReadArchive(std::string& archive)
+{
+  vtksys_ios::ostringstream code;
+  code << vtkCollectSource << "archive = collect([";
+  for (size_t cc=0; cc < this->Internals->Packages.size(); cc++)
+    {
+    code << vtkPythonQuote(this->Internals->Packages[cc]) << ", ";
+    }
+  code << "], [";
+  for (size_t cc=0; cc < this->Internals->ModuleFiles.size(); cc++)
+    {
+    code << vtkPythonQuote(this->Internals->ModuleFiles[cc]) << ", ";
+    }
+  code << "])\n";
+
+  PyObject* globals = vtkPythonRun(code.str(), NULL, NULL);
+  if (!globals)
+    {
+    vtkErrorMacro("Failed to read the Python modules to broadcast.");
+    return false;
+    }
+
+  char* buffer;
+  Py_ssize_t length;
+  PyObject* result = PyDict_GetItemString(globals, "archive"); // borrowed.
+  bool status = result &&
+    PyString_AsStringAndSize(result, &buffer, &length) == 0;
+  if (status)
+    {
+    archive.assign(buffer, static_cast<size_t>(length));
+    }
+  else
+    {
+    PyErr_Clear();
+    }
+  Py_DECREF(globals);
+  return status;
+}
+
+//----------------------------------------------------------------------------
+bool vtkPythonImportBroadcaster::InstallArchive(const std::string& archive)
+{
+  PyObject* value = PyString_FromStringAndSize(archive.c_str(),
+    static_cast<Py_ssize_t>(archive.size()));
+  PyObject* globals = vtkPythonRun(vtkInstallSource, "archive", value);
+  Py_DECREF(value);
+  if (!globals)
+    {
+    vtkErrorMacro("Failed to install the broadcast Python modules.");
+    return false;
+    }
+  Py_DECREF(globals);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkPythonImportBroadcaster::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Controller: " << this->Controller << endl;
+  os << indent << "ArchiveSize: " << this->ArchiveSize << endl;
+  os << indent << "Packages:";
+  for (size_t cc=0; cc < this->Internals->Packages.size(); cc++)
+    {
+    os << " " << this->Internals->Packages[cc];
+    }
+  os << endl;
+  os << indent << "ModuleFiles:";
+  for (size_t cc=0; cc < this->Internals->ModuleFiles.size(); cc++)
+    {
+    os << " " << this->Internals->ModuleFiles[cc];
+    }
+  os << endl;
+}
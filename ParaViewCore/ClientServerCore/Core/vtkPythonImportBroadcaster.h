@@ -0,0 +1,110 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPythonImportBroadcaster.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkPythonImportBroadcaster - imports Python modules on the root
+// process only.
+// .SECTION Description
+// When every process of a large parallel job imports the same Python modules,
+// every process looks for each module in every directory of sys.path, which
+// floods parallel file systems with stat and open calls.
+// vtkPythonImportBroadcaster reads the sources of the given packages and
+// module files on the root process only, compiles them there and broadcasts
+// the compiled code to all processes. There an importer added at the front of
+// sys.meta_path serves these modules from memory. Modules that are not in the
+// broadcast archive, such as compiled extension modules, are imported as
+// usual.
+//
+// Broadcast() is collective: it must be called on all processes of the
+// controller, after the Python interpreter has been initialized.
+// .SECTION See Also
+// vtkPythonInterpreter vtkPVPythonModule
+
+#ifndef __vtkPythonImportBroadcaster_h
+#define __vtkPythonImportBroadcaster_h
+
+#include "vtkPVClientServerCoreCoreModule.h" //needed for exports
+#include "vtkObject.h"
+#include <string> // for std::string
+
+class vtkMultiProcessController;
+
+class VTKPVCLIENTSERVERCORECORE_EXPORT vtkPythonImportBroadcaster : public vtkObject
+{
+public:
+  static vtkPythonImportBroadcaster* New();
+  vtkTypeMacro(vtkPythonImportBroadcaster, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Get/Set the controller used to broadcast the modules. Defaults to the
+  // global controller.
+  void SetController(vtkMultiProcessController*);
+  vtkGetObjectMacro(Controller, vtkMultiProcessController);
+
+  // Description:
+  // Add a top-level package (e.g. "paraview") to broadcast with all its
+  // modules and subpackages. The package is looked for in sys.path on the
+  // root process.
+  void AddPackage(const char* name);
+
+  // Description:
+  // Add a Python source file to broadcast. It is imported under the name of
+  // the file without the extension, e.g. "script" for "/path/to/script.py".
+  void AddModuleFile(const char* fileName);
+
+  // Description:
+  // Remove all packages and module files.
+  void RemoveAllModules();
+
+  // Description:
+  // Read the packages and module files on the root process, broadcast them
+  // and make them importable on all processes. Modules broadcast by earlier
+  // calls remain importable. Returns 1 on success and 0 if the root process
+  // could not read one of the packages or module files, in which case nothing
+  // is added.
+  int Broadcast();
+
+  // Description:
+  // Returns the size in bytes of the archive broadcast by the last call to
+  // Broadcast().
+  vtkGetMacro(ArchiveSize, vtkIdType);
+
+//BTX
+protected:
+  vtkPythonImportBroadcaster();
+  ~vtkPythonImportBroadcaster();
+
+  // Description:
+  // Reads and compiles the modules into a marshalled archive. Called on the
+  // root process only.
+  bool ReadArchive(std::string& archive);
+
+  // Description:
+  // Adds the modules of the archive to the importer, installing it first if
+  // needed.
+  bool InstallArchive(const std::string& archive);
+
+  vtkMultiProcessController* Controller;
+  vtkIdType ArchiveSize;
+
+private:
+  vtkPythonImportBroadcaster(const vtkPythonImportBroadcaster&); // Not implemented
+  void operator=(const vtkPythonImportBroadcaster&); // Not implemented
+
+  class vtkInternals;
+  vtkInternals* Internals;
+//ETX
+};
+
+#endif
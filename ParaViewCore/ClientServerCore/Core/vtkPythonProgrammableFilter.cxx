@@ -12,6 +12,7 @@
      PURPOSE.  See the above copyright notice for more information.
 
 =========================================================================*/
+#include "vtkPython.h" // python first
 #include "vtkPythonProgrammableFilter.h"
 
 #include "vtkCommand.h"
@@ -39,13 +40,164 @@ vtkStandardNewMacro(vtkPythonProgrammableFilter);
 
 typedef std::map<std::string, std::string> ParametersT;
 
+namespace
+{
+  // Returns the address of object as expected by the constructors of the
+  // Python wrappers of VTK objects.
+  std::string vtkPythonAddress(void* object)
+    {
+    char address[1024];
+    sprintf(address, "%p", object);
+    char* start = address;
+    if ((address[0] == '0') && ((address[1] == 'x') || address[1] == 'X'))
+      {
+      start += 2; //skip over "0x"
+      }
+    return start;
+    }
+}
+
 class vtkPythonProgrammableFilterImplementation
 {
 public:
+  vtkPythonProgrammableFilterImplementation() : Caller(NULL) {}
+  ~vtkPythonProgrammableFilterImplementation()
+    {
+    // Python is only finalized when the application exits, after which the
+    // cached objects must not be released.
+    if (!Py_IsInitialized())
+      {
+      return;
+      }
+    for (FunctionsT::iterator iter = this->Functions.begin();
+      iter != this->Functions.end(); ++iter)
+      {
+      Py_XDECREF(iter->second.Function);
+      }
+    Py_XDECREF(this->Caller);
+    }
+
+  // Returns the function called name defined by source (borrowed
+  // reference), which is only compiled if source changed since the last
+  // call. Returns NULL if source does not compile.
+  PyObject* GetFunction(const char* name, const std::string& source);
+
+  // Returns the Python function that wraps the inputs and output of the
+  // filter and calls the function compiled from the user script (borrowed
+  // reference).
+  PyObject* GetCaller();
+
   // Stores name-value parameters that will be passed to running scripts
   ParametersT Parameters;
+
+  // The value of PythonPath that was last added to sys.path.
+  std::string PythonPath;
+
+private:
+  struct FunctionT
+    {
+    std::string Source;
+    PyObject* Function;
+    };
+  typedef std::map<std::string, FunctionT> FunctionsT;
+  FunctionsT Functions;
+
+  PyObject* Caller;
 };
 
+//----------------------------------------------------------------------------
+PyObject* vtkPythonProgrammableFilterImplementation::GetFunction(
+  const char* name, const std::string& source)
+{
+  FunctionT& cached = this->Functions[name];
+  if (cached.Function && cached.Source == source)
+    {
+    return cached.Function;
+    }
+  Py_XDECREF(cached.Function);
+  cached.Function = NULL;
+  cached.Source.clear();
+
+  // The function is defined in __main__, along with the modules that the
+  // scripts may use, so that the scripts share their global variables.
+  // They are run separately so that the line numbers of the errors match
+  // the function.
+  const char* modules =
+    "from paraview import vtk\n"
+    "hasnumpy = True\n"
+    "try:\n"
+    "  from numpy import *\n"
+    "except ImportError:\n"
+    "  hasnumpy = False\n"
+    "if hasnumpy:\n"
+    "  from paraview.vtk import dataset_adapter\n"
+    "  from paraview.vtk.algorithms import *\n";
+  PyObject* globals = PyModule_GetDict(PyImport_AddModule("__main__"));
+  const char* codes[2] = { modules, source.c_str() };
+  for (int cc=0; cc < 2; cc++)
+    {
+    PyObject* result = PyRun_String(codes[cc], Py_file_input, globals,
+      globals);
+    if (!result)
+      {
+      PyErr_Print();
+      return NULL;
+      }
+    Py_DECREF(result);
+    }
+  cached.Function = PyDict_GetItemString(globals, name);
+  Py_XINCREF(cached.Function);
+  cached.Source = source;
+  return cached.Function;
+}
+
+//----------------------------------------------------------------------------
+PyObject* vtkPythonProgrammableFilterImplementation::GetCaller()
+{
+  if (this->Caller)
+    {
+    return this->Caller;
+    }
+
+  // All the inputs are wrapped in a single call, so that the interpreter is
+  // entered once per request whatever the number of inputs and blocks.
+  const char* code =
+    "from paraview import vtk\n"
+    "try:\n"
+    "  from paraview.vtk import dataset_adapter\n"
+    "except ImportError:\n"
+    "  dataset_adapter = None\n"
+    "def call(function, filterAddress, requestAddress, numberOfInputs):\n"
+    "  self = vtk.vtkProgrammableFilter(filterAddress)\n"
+    "  request = None\n"
+    "  if requestAddress:\n"
+    "    request = vtk.vtkInformation(requestAddress)\n"
+    "  inputs = None\n"
+    "  output = None\n"
+    "  if dataset_adapter:\n"
+    "    inputs = [dataset_adapter.WrapDataObject(\n"
+    "        self.GetInputDataObject(0, index))\n"
+    "      for index in range(numberOfInputs)]\n"
+    "    output = dataset_adapter.WrapDataObject(self.GetOutputDataObject(0))\n"
+    "  function(self, inputs, output, request)\n";
+
+  PyObject* globals = PyDict_New();
+  PyDict_SetItemString(globals, "__builtins__", PyEval_GetBuiltins());
+  PyObject* result = PyRun_String(code, Py_file_input, globals, globals);
+  if (!result)
+    {
+    PyErr_Print();
+    }
+  else
+    {
+    Py_DECREF(result);
+    this->Caller = PyDict_GetItemString(globals, "call");
+    Py_XINCREF(this->Caller);
+    }
+  Py_DECREF(globals);
+  return this->Caller;
+}
+
 //----------------------------------------------------------------------------
 vtkPythonProgrammableFilter::vtkPythonProgrammableFilter() :
   Implementation(new vtkPythonProgrammableFilterImplementation())
@@ -286,7 +438,7 @@ void vtkPythonProgrammableFilter::Exec(const char* script,
   vtkPythonInterpreter::Initialize();
 
   // Prepend the paths defined in PythonPath to sys.path
-  if (this->PythonPath)
+  if (this->PythonPath && this->Implementation->PythonPath != this->PythonPath)
     {
     std::string pathscript;
     pathscript += "import sys\n";
@@ -306,13 +458,9 @@ void vtkPythonProgrammableFilter::Exec(const char* script,
         vtkPythonInterpreter::RunSimpleString(pathscript.c_str());
         }
       }
+    this->Implementation->PythonPath = this->PythonPath;
     }
 
-  // Remove the function if it already exists
-  std::string cleanupScript = "try: del " + std::string(funcname) + "\n"
-                              "except NameError: pass\n";
-  vtkPythonInterpreter::RunSimpleString(cleanupScript.c_str());
-
   // Construct a script that defines a function
   std::string fscript;
   fscript  = "def ";
@@ -360,86 +508,37 @@ void vtkPythonProgrammableFilter::Exec(const char* script,
       }
     }
   fscript += "\n";
-  vtkPythonInterpreter::RunSimpleString(fscript.c_str());
-
-  std::string runscript;
-
-  runscript += "from paraview import vtk\n";
-  runscript += "from paraview import vtk\n";
-  runscript += "hasnumpy = True\n";
-  runscript += "try:\n";
-  runscript += "  from numpy import *\n";
-  runscript += "except ImportError:\n";
-  runscript += "  hasnumpy = False\n";
-  runscript += "if hasnumpy:\n";
-  runscript += "  from paraview.vtk import dataset_adapter\n";
-  runscript += "  from paraview.vtk.algorithms import *\n";
-
-  // Set self to point to this
-  char addrofthis[1024];
-  sprintf(addrofthis, "%p", this);
-  char *aplusthis = addrofthis;
-  if ((addrofthis[0] == '0') &&
-      ((addrofthis[1] == 'x') || addrofthis[1] == 'X'))
+
+  // The function is only compiled again when the script or the parameters
+  // changed.
+  PyObject* function = this->Implementation->GetFunction(funcname, fscript);
+  PyObject* caller = this->Implementation->GetCaller();
+  if (!function || !caller)
     {
-    aplusthis += 2; //skip over "0x"
+    return;
     }
 
-
-  // Call the function
-  runscript += "myarg = ";
-  runscript += "vtk.vtkProgrammableFilter('";
-  runscript += aplusthis;
-  runscript += "')\n";
-
   // pass in the request, but do some error checking first.
-  runscript += "request = ";
+  std::string requestAddress;
   if(this->Request)
     {
-    // Set pointer to request
-    char addrofrequest[1024];
-    sprintf(addrofrequest, "%p", this->Request);
-    char *aplusrequest = addrofrequest;
-    if ((addrofrequest[0] == '0') &&
-        ((addrofrequest[1] == 'x') || addrofrequest[1] == 'X'))
-      {
-      aplusrequest += 2; //skip over "0x"
-      }
-    runscript += "vtk.vtkInformation('";
-    runscript += aplusrequest;
-    runscript += "')\n";
+    requestAddress = vtkPythonAddress(this->Request);
     }
   else
     {
     vtkWarningMacro("Request is not set.");
-    runscript += "None\n";
     }
-  runscript += "if hasnumpy:\n";
-  runscript += "  inputs = []\n";
-  runscript += "  index = 0\n";
-  int numinps = this->GetNumberOfInputConnections(0);
-  for (int i=0; i<numinps; i++)
+
+  PyObject* result = PyObject_CallFunction(caller,
+    const_cast<char*>("Oszi"), function, vtkPythonAddress(this).c_str(),
+    this->Request? requestAddress.c_str() : NULL,
+    this->GetNumberOfInputConnections(0));
+  if (!result)
     {
-    runscript +=
-      "  inputs.append(dataset_adapter.WrapDataObject(myarg.GetInputDataObject(0, index)))\n";
-    runscript += "  index += 1\n";
+    PyErr_Print();
     }
-  runscript += "  output = dataset_adapter.WrapDataObject(myarg.GetOutputDataObject(0))\n";
-  runscript += "else:\n";
-  runscript += "  inputs = None\n";
-  runscript += "  output = None\n";
-
-  // Call the function
-  runscript += funcname;
-  runscript += "(myarg, inputs, output, request)\n";
-  runscript += "del inputs\n";
-  runscript += "del output\n";
-  runscript += "del myarg\n";
-  runscript += "del request\n";
-  runscript += "import gc\n";
-  runscript += "gc.collect()\n";
-
-  vtkPythonInterpreter::RunSimpleString(runscript.c_str());
+  Py_XDECREF(result);
+  PyGC_Collect();
 }
 
 //----------------------------------------------------------------------------
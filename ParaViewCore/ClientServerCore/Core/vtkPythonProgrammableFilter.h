@@ -34,6 +34,11 @@
 // call are defined as Python variables inside both scripts. This allows
 // the developer to keep the scripts the same but change their behaviour
 // using parameters.
+//
+// Each script is compiled into a function once, and only compiled again when
+// the script or the parameters change. All the inputs, including composite
+// datasets with any number of blocks, are passed to a single call of that
+// function.
 // .SECTION Caveat
 // Note that this algorithm sets the output extent translator to be
 // vtkOnePieceExtentTranslator. This means that all processes will ask
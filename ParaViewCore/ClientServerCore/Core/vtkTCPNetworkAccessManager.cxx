@@ -16,7 +16,9 @@
 
 #include "vtkClientSocket.h"
 #include "vtkCommand.h"
+#include "vtkMultiProcessController.h"
 #include "vtkObjectFactory.h"
+#include "vtkPVBufferedSocketCommunicator.h"
 #include "vtkServerSocket.h"
 #include "vtkSmartPointer.h"
 #include "vtkSocketCommunicator.h"
@@ -33,12 +35,23 @@
 #include <vtksys/ios/sstream>
 #include <vector>
 #include <map>
+#include <set>
+#include <cerrno>
+#include <cstring>
+
+#if defined(__linux__)
+# define PARAVIEW_USE_EPOLL
+# include <sys/epoll.h>
+# include <sys/ioctl.h>
+# include <unistd.h>
+#endif
 
 // set this to 1 if you want to generate a log file with all the raw socket
 // communication.
 #define GENERATE_DEBUG_LOG 0
 
-#define MAX_SOCKETS 256
+// Maximum number of ready sockets reported by a single wait.
+#define MAX_EVENTS 64
 
 class vtkTCPNetworkAccessManager::vtkInternals
 {
@@ -49,6 +62,155 @@ public:
   typedef std::map<int, vtkSmartPointer<vtkServerSocket> >
     MapToServerSockets;
   MapToServerSockets ServerSockets;
+
+  // Socket descriptors being watched by the event loop mapped to the
+  // controller or server socket they belong to. Entries are added when
+  // connections are created rather than rebuilt on every call to
+  // ProcessEvents().
+  typedef std::map<int, vtkWeakPointer<vtkObject> > MapOfWatchedObjects;
+  MapOfWatchedObjects WatchedObjects;
+
+  // Descriptors known to have unread data. With edge-triggered notification
+  // the kernel only reports new data, so connections that still have data
+  // after being serviced, or that were reported ready while peeking, are
+  // kept here.
+  std::set<int> PendingDescriptors;
+
+  int PollDescriptor;
+
+  vtkInternals()
+    {
+#ifdef PARAVIEW_USE_EPOLL
+    this->PollDescriptor = epoll_create(MAX_EVENTS);
+#else
+    this->PollDescriptor = -1;
+#endif
+    }
+
+  ~vtkInternals()
+    {
+#ifdef PARAVIEW_USE_EPOLL
+    if (this->PollDescriptor != -1)
+      {
+      close(this->PollDescriptor);
+      }
+#endif
+    }
+
+  void Watch(int fd, vtkObject* object, bool edge_triggered)
+    {
+    this->WatchedObjects[fd] = object;
+#ifdef PARAVIEW_USE_EPOLL
+    if (this->PollDescriptor != -1)
+      {
+      struct epoll_event event;
+      memset(&event, 0, sizeof(event));
+      event.events = EPOLLIN | (edge_triggered? EPOLLET : 0);
+      event.data.fd = fd;
+      if (epoll_ctl(this->PollDescriptor, EPOLL_CTL_ADD, fd, &event) != 0)
+        {
+        // the descriptor may have been reused after the earlier socket with
+        // the same number was closed without being unwatched.
+        epoll_ctl(this->PollDescriptor, EPOLL_CTL_MOD, fd, &event);
+        }
+      }
+#else
+    (void)edge_triggered;
+#endif
+    }
+
+  void Unwatch(int fd)
+    {
+    this->WatchedObjects.erase(fd);
+    this->PendingDescriptors.erase(fd);
+#ifdef PARAVIEW_USE_EPOLL
+    if (this->PollDescriptor != -1)
+      {
+      struct epoll_event event;
+      memset(&event, 0, sizeof(event));
+      epoll_ctl(this->PollDescriptor, EPOLL_CTL_DEL, fd, &event);
+      }
+#endif
+    }
+
+  // Returns the controller or server socket for the descriptor, if it is
+  // still alive and connected.
+  vtkObject* GetWatchedObject(int fd)
+    {
+    MapOfWatchedObjects::iterator iter = this->WatchedObjects.find(fd);
+    if (iter == this->WatchedObjects.end())
+      {
+      return NULL;
+      }
+    vtkObject* object = iter->second.GetPointer();
+    if (object == NULL)
+      {
+      this->Unwatch(fd);
+      }
+    return object;
+    }
+
+  // Waits for activity on the watched descriptors. Returns the number of
+  // ready descriptors, 0 on timeout and -1 on error.
+  int Wait(unsigned long timeout_msecs, std::vector<int>& ready)
+    {
+    ready.clear();
+#ifdef PARAVIEW_USE_EPOLL
+    if (this->PollDescriptor != -1)
+      {
+      struct epoll_event events[MAX_EVENTS];
+      int count = epoll_wait(this->PollDescriptor, events, MAX_EVENTS,
+        static_cast<int>(timeout_msecs));
+      if (count < 0)
+        {
+        // interrupted by a signal, pretend it was a timeout.
+        return errno == EINTR? 0 : -1;
+        }
+      for (int cc=0; cc < count; cc++)
+        {
+        ready.push_back(events[cc].data.fd);
+        }
+      return count;
+      }
+#endif
+    // Fallback for platforms without epoll. vtkSocket::SelectSockets() only
+    // reports a single ready socket.
+    std::vector<int> sockets;
+    MapOfWatchedObjects::iterator iter;
+    for (iter = this->WatchedObjects.begin();
+      iter != this->WatchedObjects.end(); ++iter)
+      {
+      sockets.push_back(iter->first);
+      }
+    if (sockets.size() == 0)
+      {
+      return -1;
+      }
+    int selected_index = -1;
+    int result = vtkSocket::SelectSockets(&sockets[0],
+      static_cast<int>(sockets.size()), timeout_msecs, &selected_index);
+    if (result > 0)
+      {
+      ready.push_back(sockets[selected_index]);
+      }
+    return result;
+    }
+
+  // Returns the number of bytes that can be read from the socket without
+  // blocking, or -1 if unknown.
+  static int GetBytesAvailable(int fd)
+    {
+#ifdef PARAVIEW_USE_EPOLL
+    int count = 0;
+    if (ioctl(fd, FIONREAD, &count) == 0)
+      {
+      return count;
+      }
+#else
+    (void)fd;
+#endif
+    return -1;
+    }
 };
 
 vtkStandardNewMacro(vtkTCPNetworkAccessManager);
@@ -169,29 +331,29 @@ int vtkTCPNetworkAccessManager::ProcessEvents(unsigned long timeout_msecs)
 int vtkTCPNetworkAccessManager::ProcessEventsInternal(
   unsigned long timeout_msecs, bool do_processing)
 {
-  int sockets_to_select[MAX_SOCKETS];
-  vtkObject* controller_or_server_socket[MAX_SOCKETS];
-
   vtkSocketController* ctrlWithBufferToEmpty = NULL;
   int size=0;
   vtkInternals::VectorOfControllers::iterator iter1;
   for (iter1 = this->Internals->Controllers.begin();
-    iter1 != this->Internals->Controllers.end(); ++iter1)
+    iter1 != this->Internals->Controllers.end();)
     {
     vtkSocketController* controller = iter1->GetPointer();
     if (!controller)
       {
-      // skip null controllers.
+      // forget about controllers that have been destroyed.
+      iter1 = this->Internals->Controllers.erase(iter1);
       continue;
       }
+    ++iter1;
     vtkSocketCommunicator* comm = vtkSocketCommunicator::SafeDownCast(
       controller->GetCommunicator());
     vtkSocket* socket = comm->GetSocket();
     if (socket && socket->GetConnected())
       {
-      sockets_to_select[size] = socket->GetSocketDescriptor();
-      controller_or_server_socket[size] = controller;
-      if(comm->HasBufferredMessages())
+      vtkPVBufferedSocketCommunicator* bufferedComm =
+        vtkPVBufferedSocketCommunicator::SafeDownCast(comm);
+      if (comm->HasBufferredMessages() ||
+        (bufferedComm && bufferedComm->HasBufferedRMI()))
         {
         ctrlWithBufferToEmpty = controller;
         if (!do_processing)
@@ -216,9 +378,6 @@ int vtkTCPNetworkAccessManager::ProcessEventsInternal(
     if (iter2->second.GetPointer() &&
       iter2->second.GetPointer()->GetConnected())
       {
-      sockets_to_select[size] =
-        iter2->second.GetPointer()->GetSocketDescriptor();
-      controller_or_server_socket[size] = iter2->second.GetPointer();
       size++;
       }
     }
@@ -235,54 +394,97 @@ int vtkTCPNetworkAccessManager::ProcessEventsInternal(
     return 1;
     }
 
-  int selected_index = -1;
-  int result = vtkSocket::SelectSockets(sockets_to_select, size,
-                                        timeout_msecs, &selected_index);
-  if (result <= 0)
+  // Connections known to have data are serviced first, without waiting.
+  std::vector<int> ready(this->Internals->PendingDescriptors.begin(),
+    this->Internals->PendingDescriptors.end());
+  this->Internals->PendingDescriptors.clear();
+  if (ready.size() == 0)
     {
-    return result;
+    int result = this->Internals->Wait(timeout_msecs, ready);
+    if (result <= 0)
+      {
+      return result;
+      }
     }
-  if (result > 0 && !do_processing)
+  if (!do_processing)
     {
     // we were told not to do any processing, so just let the caller know that
-    // we have events to process.
+    // we have events to process. Remember the ready sockets since they won't
+    // be reported again.
+    this->Internals->PendingDescriptors.insert(ready.begin(), ready.end());
     return 1;
     }
 
-  if (controller_or_server_socket[selected_index]->IsA("vtkServerSocket"))
-    {
-    vtkServerSocket* ss =
-      static_cast<vtkServerSocket*>(controller_or_server_socket[selected_index]);
-    int port= ss->GetServerPort();
-    this->InvokeEvent(vtkCommand::ConnectionCreatedEvent, &port);
-    return 1;
-    }
-  else
+  // Service every ready connection once, so that a busy connection does not
+  // starve the others.
+  bool processed = false;
+  bool quit = false;
+  for (size_t cc=0; cc < ready.size(); cc++)
     {
+    int fd = ready[cc];
+    vtkObject* object = this->Internals->GetWatchedObject(fd);
+    if (object == NULL)
+      {
+      continue;
+      }
+
+    if (object->IsA("vtkServerSocket"))
+      {
+      vtkServerSocket* ss = static_cast<vtkServerSocket*>(object);
+      int port= ss->GetServerPort();
+      this->InvokeEvent(vtkCommand::ConnectionCreatedEvent, &port);
+      processed = true;
+      continue;
+      }
+
     // We use smart pointer here to make sure the controller will live
     // during the whole ProcessRMIs call. As that call can release
     // the controller while executing.
     vtkSmartPointer<vtkMultiProcessController> controller =
-      vtkMultiProcessController::SafeDownCast(
-        controller_or_server_socket[selected_index]);
-    result = controller->ProcessRMIs(0, 1);
+      vtkMultiProcessController::SafeDownCast(object);
+    vtkSocketCommunicator* comm = vtkSocketCommunicator::SafeDownCast(
+        controller->GetCommunicator());
+    vtkPVBufferedSocketCommunicator* bufferedComm =
+      vtkPVBufferedSocketCommunicator::SafeDownCast(comm);
+    int status = bufferedComm? bufferedComm->ReceiveAvailable() : 1;
+    if (status == 0)
+      {
+      // the rest of the RMI has yet to arrive; we'll be notified when it
+      // does.
+      continue;
+      }
+
+    int result = status == 1?
+      controller->ProcessRMIs(0, 1) : vtkMultiProcessController::RMI_TAG_ERROR;
+    processed = true;
     if (result == vtkMultiProcessController::RMI_NO_ERROR)
       {
       // all's well.
-      return 1;
+      if (comm->GetSocket() && comm->GetSocket()->GetConnected() &&
+        (vtkInternals::GetBytesAvailable(fd) != 0 ||
+         (bufferedComm && bufferedComm->HasBufferedRMI())))
+        {
+        this->Internals->PendingDescriptors.insert(fd);
+        }
+      continue;
       }
 
     // Close cleanly the socket in error
-    vtkSocketCommunicator* comm = vtkSocketCommunicator::SafeDownCast(
-        controller->GetCommunicator());
+    this->Internals->Unwatch(fd);
     comm->CloseConnection();
 
     // Fire an event letting the world know that the connection was closed.
     this->InvokeEvent(vtkCommand::ConnectionClosedEvent, controller);
+    quit = quit || can_quit_if_error;
+    }
 
-    return can_quit_if_error ? -1 /* Quit */ :
-                                1 /* Pretend it's OK */;
+  if (quit)
+    {
+    return -1;
     }
+  // Pretend it's OK if a connection in error was closed. If all the ready
+  // connections had partial messages, report as a timeout.
+  return processed? 1 : 0;
 }
 
 //----------------------------------------------------------------------------
@@ -315,8 +517,10 @@ vtkMultiProcessController* vtkTCPNetworkAccessManager::ConnectToRemote(
     }
 
   vtkSocketController* controller = vtkSocketController::New();
-  vtkSocketCommunicator* comm = vtkSocketCommunicator::SafeDownCast(
-    controller->GetCommunicator());
+  vtkPVBufferedSocketCommunicator* comm =
+    vtkPVBufferedSocketCommunicator::New();
+  controller->SetCommunicator(comm);
+  comm->FastDelete();
 #if GENERATE_DEBUG_LOG
   vtksys_ios::ostringstream mystr;
   mystr << "/tmp/client."<< getpid() << ".log";
@@ -333,6 +537,7 @@ vtkMultiProcessController* vtkTCPNetworkAccessManager::ConnectToRemote(
     return NULL;
     }
   this->Internals->Controllers.push_back(controller);
+  this->Internals->Watch(cs->GetSocketDescriptor(), controller, true);
   return controller;
 }
 
@@ -356,6 +561,8 @@ vtkMultiProcessController* vtkTCPNetworkAccessManager::WaitForConnection(
       return NULL;
       }
     this->Internals->ServerSockets[port] = server_socket;
+    this->Internals->Watch(server_socket->GetSocketDescriptor(),
+      server_socket, false);
     server_socket->FastDelete();
     }
 
@@ -393,8 +600,10 @@ vtkMultiProcessController* vtkTCPNetworkAccessManager::WaitForConnection(
       }
 
     controller = vtkSocketController::New();
-    vtkSocketCommunicator* comm = vtkSocketCommunicator::SafeDownCast(
-      controller->GetCommunicator());
+    vtkPVBufferedSocketCommunicator* comm =
+      vtkPVBufferedSocketCommunicator::New();
+    controller->SetCommunicator(comm);
+    comm->FastDelete();
     comm->SetSocket(client_socket);
     client_socket->FastDelete();
     if (comm->Handshake()==0 ||
@@ -410,10 +619,15 @@ vtkMultiProcessController* vtkTCPNetworkAccessManager::WaitForConnection(
   if (controller)
     {
     this->Internals->Controllers.push_back(controller);
+    vtkSocketCommunicator* comm = vtkSocketCommunicator::SafeDownCast(
+      controller->GetCommunicator());
+    this->Internals->Watch(comm->GetSocket()->GetSocketDescriptor(),
+      controller, true);
     }
 
   if (once)
     {
+    this->Internals->Unwatch(server_socket->GetSocketDescriptor());
     server_socket->CloseSocket();
     this->Internals->ServerSockets.erase(port);
     }
@@ -17,6 +17,15 @@
 // vtkTCPNetworkAccessManager is a concrete implementation of
 // vtkNetworkAccessManager that uses tcp/ip sockets for communication between
 // processes. It supports urls that use "tcp" as their protocol specifier.
+//
+// Sockets for all connections are registered with the event loop as the
+// connections are created. On Linux, epoll is used to wait for activity,
+// which scales with the number of active connections rather than the total
+// number of connections. Other platforms use vtkSocket::SelectSockets().
+// Connections use vtkPVBufferedSocketCommunicator: on POSIX platforms, the
+// part of an RMI that has arrived is read without blocking and buffered for
+// the connection, and the RMI is only processed once it is complete, so that
+// a connection sending a large message does not block the others.
 
 #ifndef __vtkTCPNetworkAccessManager_h
 #define __vtkTCPNetworkAccessManager_h
@@ -76,7 +85,11 @@ public:
   virtual void AbortPendingConnection();
 
   // Description:
-  // Process any network activity.
+  // Process any network activity. Every connection with activity is
+  // serviced once per call. On Linux, sockets are monitored using epoll and a
+  // connection is not serviced until its next message has been completely
+  // received (unless the message is too large to be buffered by the kernel),
+  // so that slow or large transfers on one connection don't block the others.
   virtual int ProcessEvents(unsigned long timeout_msecs);
 
   // Description:
@@ -15,6 +15,8 @@
 #include "vtkPythonCalculator.h"
 
 #include "vtkCellData.h"
+#include "vtkCompositeDataIterator.h"
+#include "vtkCompositeDataSet.h"
 #include "vtkDataArray.h"
 #include "vtkDataObject.h"
 #include "vtkDataObjectTypes.h"
@@ -30,10 +32,43 @@
 #include <algorithm>
 #include <map>
 #include <string>
+#include <vtksys/ios/sstream>
 #include <vtksys/SystemTools.hxx>
 
 vtkStandardNewMacro(vtkPythonCalculator);
 
+namespace
+{
+  // Returns str as a Python string literal.
+  std::string vtkPythonQuote(const char* str)
+    {
+    std::string quoted = "'";
+    for (; str && *str; ++str)
+      {
+      switch (*str)
+        {
+        case '\\':
+        case '\'':
+          quoted += '\\';
+          quoted += *str;
+          break;
+        case '\n':
+          quoted += "\\n";
+          break;
+        case '\r':
+          quoted += "\\r";
+          break;
+        case '\t':
+          quoted += "\\t";
+          break;
+        default:
+          quoted += *str;
+        }
+      }
+    return quoted + "'";
+    }
+}
+
 //----------------------------------------------------------------------------
 vtkPythonCalculator::vtkPythonCalculator()
 {
@@ -100,191 +135,90 @@ void vtkPythonCalculator::ExecuteScript(void *arg)
 
 //----------------------------------------------------------------------------
 void vtkPythonCalculator::Exec(const char* expression,
-                               const char* funcname)
+                               const char* vtkNotUsed(funcname))
 {
   if (!expression)
     {
     return;
     }
 
-  vtkDataObject* firstInput = this->GetInputDataObject(0, 0);
-  vtkFieldData* fd = 0;
-  if (this->ArrayAssociation == vtkDataObject::FIELD_ASSOCIATION_POINTS)
-    {
-    vtkDataSet* ds = vtkDataSet::SafeDownCast(firstInput);
-    if (ds)
-      {
-      fd = ds->GetPointData();
-      }    
-    }
-  else if (this->ArrayAssociation == vtkDataObject::FIELD_ASSOCIATION_CELLS)
-    {
-    vtkDataSet* ds = vtkDataSet::SafeDownCast(firstInput);
-    if (ds)
-      {
-      fd = ds->GetCellData();
-      }        
-    }
-  if (!fd)
+  if (this->ArrayAssociation != vtkDataObject::FIELD_ASSOCIATION_POINTS &&
+    this->ArrayAssociation != vtkDataObject::FIELD_ASSOCIATION_CELLS)
     {
     vtkErrorMacro("Unexpected association value.");
     return;
     }
 
-  // Replace tabs with two spaces
-  std::string orgscript;
-  size_t len = strlen(expression);
-  for(size_t i=0; i< len; i++)
+  // Composite datasets are processed as a whole, so that the expression is
+  // evaluated by a single call to Python. The output blocks are created here.
+  vtkDataObject* input = this->GetInputDataObject(0, 0);
+  vtkDataObject* output = this->GetOutputDataObject(0);
+  vtkCompositeDataSet* compositeInput = vtkCompositeDataSet::SafeDownCast(input);
+  vtkCompositeDataSet* compositeOutput =
+    vtkCompositeDataSet::SafeDownCast(output);
+  if (compositeInput && compositeOutput)
     {
-    if (expression[i] == '\t')
+    compositeOutput->CopyStructure(compositeInput);
+    vtkCompositeDataIterator* iter = compositeInput->NewIterator();
+    iter->SkipEmptyNodesOn();
+    for (iter->InitTraversal(); !iter->IsDoneWithTraversal();
+      iter->GoToNextItem())
       {
-      orgscript += "  ";
-      }
-    else
-      {
-      orgscript.push_back(expression[i]);
-      }
-    }
-    
-  //size_t pos = orgscript.rfind("\n");
-    
-  // Construct a script that defines a function
-  std::string fscript;
-  fscript  = "def ";
-  fscript += funcname;
-
-  fscript += "(self, inputs):\n";
-  fscript += "  arrays = {}\n";
-  int narrays = fd->GetNumberOfArrays();
-  for (int i=0; i<narrays; i++)
-    {
-    const char* aname = fd->GetArray(i)->GetName();
-    if (aname)
-      {
-      fscript += "  import paraview\n";
-      fscript += "  name = paraview.make_name_valid(\"";
-      fscript += aname;
-      fscript += "\")\n";
-      fscript += "  if name:\n";
-      fscript += "    try:\n";
-      fscript += "      exec \"%s = inputs[0].";
-      if (this->ArrayAssociation == vtkDataObject::FIELD_ASSOCIATION_POINTS)
+      vtkDataSet* inputBlock =
+        vtkDataSet::SafeDownCast(iter->GetCurrentDataObject());
+      if (!inputBlock)
         {
-        fscript += "PointData['";
+        continue;
         }
-      else if (this->ArrayAssociation == vtkDataObject::FIELD_ASSOCIATION_CELLS)
+      vtkDataSet* outputBlock = inputBlock->NewInstance();
+      outputBlock->CopyStructure(inputBlock);
+      if (this->CopyArrays)
         {
-        fscript += "CellData['";
+        outputBlock->GetPointData()->PassData(inputBlock->GetPointData());
+        outputBlock->GetCellData()->PassData(inputBlock->GetCellData());
         }
-      fscript += aname;
-      fscript += "']\" % (name)\n";
-      fscript += "    except: pass\n";
-      fscript += "  arrays['";
-      fscript += aname;
-      fscript += "'] = inputs[0].";
-      if (this->ArrayAssociation == vtkDataObject::FIELD_ASSOCIATION_POINTS)
-        {
-        fscript += "PointData['";
-        }
-      else if (this->ArrayAssociation == vtkDataObject::FIELD_ASSOCIATION_CELLS)
-        {
-        fscript += "CellData['";
-        }
-      fscript += aname;
-      fscript += "']\n";
+      compositeOutput->SetDataSet(iter, outputBlock);
+      outputBlock->Delete();
       }
+    iter->Delete();
     }
-  fscript += "  try:\n";
-  fscript += "    points = inputs[0].Points\n";
-  fscript += "  except: pass\n";
-  
-  if (expression && strlen(expression) > 0)  
+  else
     {
-    fscript += "  retVal = ";
-    fscript += orgscript;
-    fscript += "\n";
-    fscript += "  if not isinstance(retVal, ndarray):\n";
-    fscript += "    retVal = retVal * ones((inputs[0].GetNumberOf";
-    if (this->ArrayAssociation == vtkDataObject::FIELD_ASSOCIATION_POINTS)
+    vtkDataSet* dsInput = vtkDataSet::SafeDownCast(input);
+    vtkDataSet* dsOutput = vtkDataSet::SafeDownCast(output);
+    if (!dsInput || !dsOutput)
       {
-      fscript += "Points(), 1))\n";
+      vtkErrorMacro("Unexpected input or output type.");
+      return;
       }
-    else if (this->ArrayAssociation == vtkDataObject::FIELD_ASSOCIATION_CELLS)
+    if (this->CopyArrays)
       {
-      fscript += "Cells(), 1))\n";
+      dsOutput->GetPointData()->PassData(dsInput->GetPointData());
+      dsOutput->GetCellData()->PassData(dsInput->GetCellData());
       }
-    fscript += "  return retVal\n";
     }
-  else
-    {
-    fscript += "  return None\n";
-    }
- 
-  // ensure Python is initialized.
-  vtkPythonInterpreter::Initialize();
-  vtkPythonInterpreter::RunSimpleString(fscript.c_str());
-
-  std::string runscript;
-  runscript += "import paraview\n";
-  runscript += "from paraview import vtk\n";
-  runscript += "from paraview.vtk import dataset_adapter\n";
-  runscript += "from numpy import *\n";
-  runscript += "from paraview.vtk.algorithms import *\n";
 
   // Set self to point to this
   char addrofthis[1024];
-  sprintf(addrofthis, "%p", this);    
-  char *aplus = addrofthis; 
-  if ((addrofthis[0] == '0') && 
+  sprintf(addrofthis, "%p", this);
+  char *aplus = addrofthis;
+  if ((addrofthis[0] == '0') &&
       ((addrofthis[1] == 'x') || addrofthis[1] == 'X'))
     {
     aplus += 2; //skip over "0x"
     }
-  
-  // Call the function
-  runscript += "myarg = ";
-  runscript += "vtk.vtkProgrammableFilter('";
-  runscript += aplus;
-  runscript += "')\n";
-  runscript += "inputs = []\n";
-  runscript += "index = 0\n";
-  int numinps = this->GetNumberOfInputConnections(0);
-  for (int i=0; i<numinps; i++)
-    {
-    runscript += 
-      "inputs.append(dataset_adapter.WrapDataObject(myarg.GetInputDataObject(0, index)))\n";
-    runscript += "index += 1\n";
-    }
-  runscript += "output = dataset_adapter.WrapDataObject(myarg.GetOutputDataObject(0))\n";
-  if (this->ArrayAssociation == vtkDataObject::FIELD_ASSOCIATION_POINTS)
-    {
-    runscript +=  "fd = output.PointData\n";
-    }
-  else if (this->ArrayAssociation == vtkDataObject::FIELD_ASSOCIATION_CELLS)
-    {
-    runscript += "fd = output.CellData\n";
-    }
-  if (this->CopyArrays)
-    {
-    runscript += "output.GetPointData().PassData(inputs[0].GetPointData().VTKObject)\n";
-    runscript += "output.GetCellData().PassData(inputs[0].GetCellData().VTKObject)\n";
-    }
-  runscript += "retVal = ";
-  runscript += funcname;
-  runscript += "(vtk.vtkProgrammableFilter('";
-  runscript += aplus;
-  runscript += "'), inputs)\n";
-  runscript += "if retVal is not None:\n";
-  runscript += "  fd.append(retVal, '";
-  runscript += this->GetArrayName();
-  runscript += "')\n";
-  runscript += "del myarg\n";
-  runscript += "del inputs\n";
-  runscript += "del fd\n";
-  runscript += "del retVal\n";
-  runscript += "del output\n";
-  
-  vtkPythonInterpreter::RunSimpleString(runscript.c_str());
+
+  // The paraview.calculator module keeps the compiled expressions.
+  vtksys_ios::ostringstream stream;
+  stream << "from paraview import calculator" << endl
+         << "calculator.execute('" << aplus << "', "
+         << vtkPythonQuote(expression) << ", "
+         << this->ArrayAssociation << ", "
+         << vtkPythonQuote(this->GetArrayName()) << ")" << endl;
+
+  // ensure Python is initialized.
+  vtkPythonInterpreter::Initialize();
+  vtkPythonInterpreter::RunSimpleString(stream.str().c_str());
 }
 
 //----------------------------------------------------------------------------
@@ -306,7 +240,11 @@ int vtkPythonCalculator::FillInputPortInformation(
     }
   if(port==0)
     {
+    // Composite datasets are accepted so that they are not processed block
+    // by block by the executive.
     info->Set(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkDataSet");
+    info->Append(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(),
+      "vtkCompositeDataSet");
     info->Set(vtkAlgorithm::INPUT_IS_REPEATABLE(), 1);
     info->Set(vtkAlgorithm::INPUT_IS_OPTIONAL(), 1);
     }
@@ -26,6 +26,11 @@
 // valid Python variable, it has to be accessed through a dictionary called
 // arrays (i.e. arrays['array_name']). The points can be accessed using the
 // points variable.
+//
+// The expression is compiled once by the paraview.calculator module. Composite
+// datasets are processed by a single call to Python: expressions that only
+// combine arrays element-wise are evaluated once on the arrays of all the
+// blocks, other expressions are evaluated for each block.
 
 #ifndef __vtkPythonCalculator_h
 #define __vtkPythonCalculator_h
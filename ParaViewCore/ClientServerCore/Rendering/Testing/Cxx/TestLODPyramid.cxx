@@ -0,0 +1,147 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestLODPyramid.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Tests that vtkPVLODPyramid builds its levels only when they are
+// requested, keeps them until the input changes, builds resolutions that
+// are not levels exactly, and gives the same decimation as
+// vtkQuadricClustering, also for blocks sharing their points and cells.
+
+#include "vtkMultiBlockDataSet.h"
+#include "vtkMultiThreader.h"
+#include "vtkNew.h"
+#include "vtkPolyData.h"
+#include "vtkPVLODPyramid.h"
+#include "vtkQuadricClustering.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+
+#include <cstdlib>
+
+#define TEST_ASSERT(condition) \
+  if (!(condition)) \
+    { \
+    cerr << "ERROR: failed at line " << __LINE__ << ": " #condition << endl; \
+    return EXIT_FAILURE; \
+    }
+
+namespace
+{
+  // Returns true if the block of the output has the decimation of the same
+  // block of the input by vtkQuadricClustering.
+  bool CheckBlock(vtkMultiBlockDataSet* input, vtkMultiBlockDataSet* output,
+    unsigned int block, int divisions)
+    {
+    vtkNew<vtkQuadricClustering> decimator;
+    decimator->SetUseInputPoints(1);
+    decimator->SetCopyCellData(1);
+    decimator->SetUseInternalTriangles(0);
+    decimator->SetNumberOfDivisions(divisions, divisions, divisions);
+    decimator->SetInputData(input->GetBlock(block));
+    decimator->Update();
+    vtkPolyData* expected = decimator->GetOutput();
+    vtkPolyData* result = vtkPolyData::SafeDownCast(output->GetBlock(block));
+    return result &&
+      result->GetNumberOfPoints() == expected->GetNumberOfPoints() &&
+      result->GetNumberOfCells() == expected->GetNumberOfCells() &&
+      result->GetNumberOfPoints() > 0;
+    }
+}
+
+//----------------------------------------------------------------------------
+int main(int, char**)
+{
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(4);
+
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(200);
+  sphere->SetPhiResolution(200);
+  sphere->Update();
+  vtkNew<vtkSphereSource> smallSphere;
+  smallSphere->SetCenter(2, 0, 0);
+  smallSphere->SetThetaResolution(50);
+  smallSphere->SetPhiResolution(50);
+  smallSphere->Update();
+  vtkNew<vtkPolyData> shared;
+  shared->ShallowCopy(sphere->GetOutput());
+
+  vtkNew<vtkMultiBlockDataSet> input;
+  input->SetBlock(0, sphere->GetOutput());
+  input->SetBlock(1, smallSphere->GetOutput());
+  input->SetBlock(2, shared.GetPointer());
+
+  vtkNew<vtkPVLODPyramid> pyramid;
+  pyramid->SetMaximumNumberOfDivisions(80);
+  pyramid->SetNumberOfLevels(4);
+  pyramid->SetCachingEnabled(false);
+  pyramid->SetInputData(input.GetPointer());
+
+  // only the requested level is built.
+  pyramid->SetLevel(2);
+  pyramid->Update();
+  TEST_ASSERT(pyramid->HasLevel(2));
+  TEST_ASSERT(!pyramid->HasLevel(0) && !pyramid->HasLevel(1) &&
+    !pyramid->HasLevel(3));
+  vtkMultiBlockDataSet* output = pyramid->GetOutput();
+  TEST_ASSERT(output->GetNumberOfBlocks() == 3);
+  for (unsigned int block=0; block < 3; block++)
+    {
+    TEST_ASSERT(CheckBlock(input.GetPointer(), output, block, 20));
+    }
+  vtkSmartPointer<vtkDataObject> level2 = output->GetBlock(0);
+
+  pyramid->SetLevel(0);
+  pyramid->Update();
+  TEST_ASSERT(pyramid->HasLevel(0) && pyramid->HasLevel(2));
+  TEST_ASSERT(!pyramid->HasLevel(1) && !pyramid->HasLevel(3));
+  output = pyramid->GetOutput();
+  for (unsigned int block=0; block < 3; block++)
+    {
+    TEST_ASSERT(CheckBlock(input.GetPointer(), output, block, 80));
+    }
+
+  // going back to a level reuses it.
+  pyramid->SetLevel(2);
+  pyramid->Update();
+  TEST_ASSERT(pyramid->GetOutput()->GetBlock(0) == level2);
+
+  // a resolution between two levels is built exactly, and kept.
+  pyramid->SetNumberOfDivisions(30);
+  pyramid->Update();
+  TEST_ASSERT(!pyramid->HasLevel(1) && !pyramid->HasLevel(3));
+  output = pyramid->GetOutput();
+  for (unsigned int block=0; block < 3; block++)
+    {
+    TEST_ASSERT(CheckBlock(input.GetPointer(), output, block, 30));
+    }
+  vtkSmartPointer<vtkDataObject> other = output->GetBlock(0);
+  pyramid->SetNumberOfDivisions(20);
+  pyramid->Update();
+  TEST_ASSERT(pyramid->GetOutput()->GetBlock(0) == level2);
+  pyramid->SetNumberOfDivisions(30);
+  pyramid->Update();
+  TEST_ASSERT(pyramid->GetOutput()->GetBlock(0) == other);
+  pyramid->SetNumberOfDivisions(0);
+
+  // changing the input discards the levels.
+  smallSphere->SetThetaResolution(60);
+  smallSphere->Update();
+  input->SetBlock(1, smallSphere->GetOutput());
+  input->Modified();
+  pyramid->Update();
+  TEST_ASSERT(pyramid->HasLevel(2) && !pyramid->HasLevel(0));
+  output = pyramid->GetOutput();
+  TEST_ASSERT(output->GetBlock(0) != level2);
+  TEST_ASSERT(CheckBlock(input.GetPointer(), output, 1, 20));
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,135 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPolyDataSplitterBlockPath.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Splits a nested multiblock with vtkPVPolyDataSplitter and checks that each
+// piece has the "vtkBlockPath" of the block it comes from, which is used to
+// apply block properties to streamed pieces, and that the path is kept by
+// the levels of vtkPVLODPyramid.
+
+#include "vtkFieldData.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkPolyData.h"
+#include "vtkPVLODPyramid.h"
+#include "vtkPVPolyDataSplitter.h"
+#include "vtkSphereSource.h"
+#include "vtkUnsignedIntArray.h"
+
+#include <cstdlib>
+
+#define TEST_ASSERT(condition) \
+  if (!(condition)) \
+    { \
+    cerr << "ERROR: failed at line " << __LINE__ << ": " #condition << endl; \
+    return EXIT_FAILURE; \
+    }
+
+namespace
+{
+  // Returns the path of the piece as flat indices, from the block up to the
+  // root, e.g. 421 for { 4, 2, 0 }, or -1 without a path.
+  int GetPath(vtkDataObject* piece)
+    {
+    vtkUnsignedIntArray* path = piece? vtkUnsignedIntArray::SafeDownCast(
+      piece->GetFieldData()->GetArray("vtkBlockPath")) : NULL;
+    if (!path)
+      {
+      return -1;
+      }
+    int result = 0;
+    for (vtkIdType cc=0; cc < path->GetNumberOfTuples(); cc++)
+      {
+      result = 10 * result + static_cast<int>(path->GetValue(cc));
+      }
+    return result;
+    }
+}
+
+//----------------------------------------------------------------------------
+int main(int, char**)
+{
+  // flat indices: 0 root, 1 big sphere, 2 nested multiblock, 3 empty block,
+  // 4 small sphere.
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(32);
+  sphere->SetPhiResolution(32);
+  sphere->Update();
+  vtkNew<vtkSphereSource> smallSphere;
+  smallSphere->SetCenter(2, 0, 0);
+  smallSphere->SetThetaResolution(4);
+  smallSphere->SetPhiResolution(4);
+  smallSphere->Update();
+  vtkNew<vtkFieldData> fieldData;
+  vtkNew<vtkUnsignedIntArray> other;
+  other->SetName("Other");
+  fieldData->AddArray(other.GetPointer());
+  smallSphere->GetOutput()->SetFieldData(fieldData.GetPointer());
+
+  vtkNew<vtkMultiBlockDataSet> nested;
+  nested->SetNumberOfBlocks(2);
+  nested->SetBlock(1, smallSphere->GetOutput());
+  vtkNew<vtkMultiBlockDataSet> input;
+  input->SetBlock(0, sphere->GetOutput());
+  input->SetBlock(1, nested.GetPointer());
+
+  vtkNew<vtkPVPolyDataSplitter> splitter;
+  splitter->SetMaximumNumberOfCells(100);
+  splitter->SetInputData(input.GetPointer());
+  splitter->Update();
+  vtkMultiBlockDataSet* output = splitter->GetOutput();
+
+  vtkIdType bigCells = 0;
+  int smallPieces = 0;
+  for (unsigned int cc=0; cc < output->GetNumberOfBlocks(); cc++)
+    {
+    vtkPolyData* piece = vtkPolyData::SafeDownCast(output->GetBlock(cc));
+    TEST_ASSERT(piece && piece->GetNumberOfCells() <= 100);
+    int path = GetPath(piece);
+    if (path == 10)
+      {
+      bigCells += piece->GetNumberOfCells();
+      }
+    else
+      {
+      TEST_ASSERT(path == 420);
+      TEST_ASSERT(piece->GetNumberOfCells() ==
+        smallSphere->GetOutput()->GetNumberOfCells());
+      TEST_ASSERT(piece->GetFieldData()->GetArray("Other") != NULL);
+      smallPieces++;
+      }
+    }
+  TEST_ASSERT(bigCells == sphere->GetOutput()->GetNumberOfCells());
+  TEST_ASSERT(smallPieces == 1);
+  TEST_ASSERT(output->GetNumberOfBlocks() > 2);
+
+  // the path is added to the pieces only, not to the input blocks.
+  TEST_ASSERT(GetPath(smallSphere->GetOutput()) == -1);
+  TEST_ASSERT(fieldData->GetNumberOfArrays() == 1);
+
+  // the decimated pieces keep their path.
+  vtkNew<vtkPVLODPyramid> pyramid;
+  pyramid->SetCachingEnabled(false);
+  pyramid->SetNumberOfLevels(2);
+  pyramid->SetLevel(1);
+  pyramid->SetInputConnection(splitter->GetOutputPort());
+  pyramid->Update();
+  vtkMultiBlockDataSet* levelOutput = pyramid->GetOutput();
+  TEST_ASSERT(levelOutput->GetNumberOfBlocks() == output->GetNumberOfBlocks());
+  for (unsigned int cc=0; cc < output->GetNumberOfBlocks(); cc++)
+    {
+    TEST_ASSERT(GetPath(levelOutput->GetBlock(cc)) ==
+      GetPath(output->GetBlock(cc)));
+    }
+  return EXIT_SUCCESS;
+}
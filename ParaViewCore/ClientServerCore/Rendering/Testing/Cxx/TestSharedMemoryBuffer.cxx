@@ -0,0 +1,207 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestSharedMemoryBuffer.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Sends buffers with vtkPVSharedMemoryBuffer::SendBuffer() over a socket
+// connection to a thread of the same process, and checks that
+// ReceiveBuffer() gives the same bytes, through shared memory for large
+// buffers and through the socket for small ones or when shared memory is
+// disabled. Finally, sends a polydata marshalled directly in the segment by
+// vtkPVDataMarshaller and checks that the receiver uses its points in place.
+
+#include "vtkClientSocket.h"
+#include "vtkMultiThreader.h"
+#include "vtkNew.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPVDataMarshaller.h"
+#include "vtkPVSharedMemoryBuffer.h"
+#include "vtkServerSocket.h"
+#include "vtkSmartPointer.h"
+#include "vtkSocketCommunicator.h"
+#include "vtkSocketController.h"
+#include "vtkSphereSource.h"
+
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+  const int TAG = 7741;
+
+  // The sizes of the buffers sent, and whether they are expected to be
+  // shared. The last ones are sent with shared memory disabled.
+  const vtkIdType SIZES[] = { 0, 100, 1024*1024, 3*1024*1024 + 17, 1024*1024 };
+  const int NUMBER_OF_BUFFERS = 5;
+  const int NUMBER_OF_SHARED_BUFFERS = 4;
+
+  char ValueAt(vtkIdType index, int buffer)
+    {
+    return static_cast<char>((index * 31 + buffer) % 251);
+    }
+
+  struct ReceiverState
+    {
+    int Port;
+    int Errors;
+    vtkIdType MarshalledLength;
+    vtkIdType NumberOfPoints;
+    };
+
+  VTK_THREAD_RETURN_TYPE Receive(void* calldata)
+    {
+    vtkMultiThreader::ThreadInfo* info =
+      reinterpret_cast<vtkMultiThreader::ThreadInfo*>(calldata);
+    ReceiverState* state = static_cast<ReceiverState*>(info->UserData);
+
+    vtkNew<vtkSocketCommunicator> communicator;
+    if (!communicator->ConnectTo(const_cast<char*>("localhost"), state->Port))
+      {
+      cerr << "ERROR: failed to connect." << endl;
+      state->Errors++;
+      return VTK_THREAD_RETURN_VALUE;
+      }
+    vtkNew<vtkSocketController> controller;
+    controller->SetCommunicator(communicator.GetPointer());
+
+    for (int cc=0; cc < NUMBER_OF_BUFFERS; cc++)
+      {
+      vtkSmartPointer<vtkPVSharedMemoryBuffer> buffer;
+      buffer.TakeReference(vtkPVSharedMemoryBuffer::ReceiveBuffer(
+          controller.GetPointer(), SIZES[cc], 1, TAG));
+      if (!buffer || buffer->GetSize() != SIZES[cc])
+        {
+        cerr << "ERROR: failed to receive buffer " << cc << endl;
+        state->Errors++;
+        continue;
+        }
+      bool shared = vtkPVSharedMemoryBuffer::IsSupported() &&
+        cc < NUMBER_OF_SHARED_BUFFERS &&
+        SIZES[cc] >= vtkPVSharedMemoryBuffer::GetSharedMemoryThreshold();
+      if (buffer->IsShared() != shared)
+        {
+        cerr << "ERROR: buffer " << cc << " shared: " << buffer->IsShared()
+             << " expected: " << shared << endl;
+        state->Errors++;
+        }
+      for (vtkIdType kk=0; kk < SIZES[cc]; kk++)
+        {
+        if (buffer->GetPointer()[kk] != ValueAt(kk, cc))
+          {
+          cerr << "ERROR: buffer " << cc << " differs at " << kk << endl;
+          state->Errors++;
+          break;
+          }
+        }
+      }
+
+    vtkSmartPointer<vtkPVSharedMemoryBuffer> buffer;
+    buffer.TakeReference(vtkPVSharedMemoryBuffer::ReceiveBuffer(
+        controller.GetPointer(), state->MarshalledLength, 1, TAG));
+    vtkSmartPointer<vtkDataObject> data;
+    if (buffer)
+      {
+      data.TakeReference(vtkPVDataMarshaller::Unmarshal(buffer->GetPointer(),
+          buffer->GetSize(), buffer));
+      }
+    vtkPolyData* pd = vtkPolyData::SafeDownCast(data);
+    if (!pd || pd->GetNumberOfPoints() != state->NumberOfPoints)
+      {
+      cerr << "ERROR: failed to receive the marshalled polydata." << endl;
+      state->Errors++;
+      }
+    else if (vtkPVSharedMemoryBuffer::IsSupported())
+      {
+      char* points = static_cast<char*>(pd->GetPoints()->GetVoidPointer(0));
+      if (!buffer->IsShared() || points < buffer->GetPointer() ||
+        points >= buffer->GetPointer() + buffer->GetSize())
+        {
+        cerr << "ERROR: the points are not used in the segment." << endl;
+        state->Errors++;
+        }
+      }
+    communicator->CloseConnection();
+    return VTK_THREAD_RETURN_VALUE;
+    }
+}
+
+//----------------------------------------------------------------------------
+int main(int, char**)
+{
+  vtkNew<vtkServerSocket> serverSocket;
+  if (serverSocket->CreateServer(0) != 0)
+    {
+    cerr << "ERROR: failed to create a server socket." << endl;
+    return EXIT_FAILURE;
+    }
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(100);
+  sphere->SetPhiResolution(100);
+  sphere->Update();
+  vtkNew<vtkPVDataMarshaller> marshaller;
+
+  ReceiverState state;
+  state.Port = serverSocket->GetServerPort();
+  state.Errors = 0;
+  state.MarshalledLength = marshaller->Prepare(sphere->GetOutput());
+  state.NumberOfPoints = sphere->GetOutput()->GetNumberOfPoints();
+  vtkNew<vtkMultiThreader> threader;
+  int threadId = threader->SpawnThread(&Receive, &state);
+
+  vtkClientSocket* socket = serverSocket->WaitForConnection(60000);
+  vtkNew<vtkSocketCommunicator> communicator;
+  communicator->SetSocket(socket);
+  if (socket)
+    {
+    socket->Delete();
+    }
+  if (!socket || !communicator->ServerSideHandshake())
+    {
+    cerr << "ERROR: the receiver did not connect." << endl;
+    threader->TerminateThread(threadId);
+    return EXIT_FAILURE;
+    }
+  vtkNew<vtkSocketController> controller;
+  controller->SetCommunicator(communicator.GetPointer());
+
+  int errors = 0;
+  for (int cc=0; cc < NUMBER_OF_BUFFERS; cc++)
+    {
+    vtkPVSharedMemoryBuffer::SetUseSharedMemory(cc < NUMBER_OF_SHARED_BUFFERS);
+    std::vector<char> data(SIZES[cc] + 1);
+    for (vtkIdType kk=0; kk < SIZES[cc]; kk++)
+      {
+      data[kk] = ValueAt(kk, cc);
+      }
+    if (!vtkPVSharedMemoryBuffer::SendBuffer(controller.GetPointer(),
+        &data[0], SIZES[cc], 1, TAG))
+      {
+      cerr << "ERROR: failed to send buffer " << cc << endl;
+      errors++;
+      }
+    }
+  vtkPVSharedMemoryBuffer::SetUseSharedMemory(true);
+  if (state.MarshalledLength <
+    vtkPVSharedMemoryBuffer::GetSharedMemoryThreshold() ||
+    !vtkPVSharedMemoryBuffer::SendBuffer(controller.GetPointer(),
+      &vtkPVDataMarshaller::WriteBufferCallback, marshaller.GetPointer(),
+      state.MarshalledLength, 1, TAG))
+    {
+    cerr << "ERROR: failed to send the marshalled polydata." << endl;
+    errors++;
+    }
+
+  threader->TerminateThread(threadId);
+  communicator->CloseConnection();
+  return (errors + state.Errors) == 0? EXIT_SUCCESS : EXIT_FAILURE;
+}
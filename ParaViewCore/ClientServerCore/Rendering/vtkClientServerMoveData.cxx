@@ -15,25 +15,64 @@
 #include "vtkClientServerMoveData.h"
 
 #include "vtkCharArray.h"
+#include "vtkCommunicator.h"
 #include "vtkDataObject.h"
 #include "vtkDataObjectTypes.h"
 #include "vtkGenericDataObjectReader.h"
 #include "vtkGenericDataObjectWriter.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMPIMoveData.h"
 #include "vtkMultiBlockDataSet.h"
 #include "vtkMultiProcessController.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPolyData.h"
 #include "vtkProcessModule.h"
+#include "vtkPVDataMarshaller.h"
 #include "vtkPVSession.h"
+#include "vtkPVSharedMemoryBuffer.h"
 #include "vtkSelection.h"
 #include "vtkSelectionSerializer.h"
+#include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkUnstructuredGrid.h"
 
 #include <vtksys/ios/sstream>
 
+namespace
+{
+  enum Transports
+    {
+    // vtkMultiProcessController::Send(vtkDataObject*,...).
+    SEND_DATA_OBJECT = 0,
+    // vtkCommunicator::MarshalDataObject() buffer, passed through
+    // vtkPVSharedMemoryBuffer.
+    SEND_MARSHALLED_BUFFER = 1,
+    // vtkPVDataMarshaller buffer, passed through vtkPVSharedMemoryBuffer.
+    SEND_RAW_BUFFER = 2
+    };
+
+  int vtkGetTransport(vtkDataObject* data)
+    {
+    if (data == NULL)
+      {
+      return SEND_DATA_OBJECT;
+      }
+    if (vtkMPIMoveData::GetUseRawMarshalling() &&
+      vtkPVDataMarshaller::CanMarshal(data))
+      {
+      return SEND_RAW_BUFFER;
+      }
+    if (!data->IsA("vtkCompositeDataSet") &&
+      vtkPVSharedMemoryBuffer::GetUseSharedMemory())
+      {
+      return SEND_MARSHALLED_BUFFER;
+      }
+    return SEND_DATA_OBJECT;
+    }
+}
+
 vtkStandardNewMacro(vtkClientServerMoveData);
 vtkCxxSetObjectMacro(vtkClientServerMoveData, Controller,
   vtkMultiProcessController);
@@ -227,8 +266,60 @@ int vtkClientServerMoveData::SendData(vtkDataObject* input,
       }
     }
 
-  return controller->Send(input, 1,
+  // Tell the client which transport to expect.
+  int transport = vtkGetTransport(input);
+  vtkSmartPointer<vtkCharArray> buffer;
+  vtkNew<vtkPVDataMarshaller> marshaller;
+  vtkIdType length = 0;
+  if (transport == SEND_RAW_BUFFER)
+    {
+    // The values are only copied when the buffer is sent, directly in the
+    // shared memory segment when it is used.
+    marshaller->SetCompressor(
+      vtkPVDataMarshaller::GetConnectionCompressor(controller));
+    length = marshaller->Prepare(input);
+    if (length < 0)
+      {
+      length = 0;
+      transport = SEND_DATA_OBJECT;
+      }
+    }
+  else if (transport == SEND_MARSHALLED_BUFFER)
+    {
+    buffer = vtkSmartPointer<vtkCharArray>::New();
+    if (vtkCommunicator::MarshalDataObject(input, buffer))
+      {
+      length = buffer->GetNumberOfTuples();
+      }
+    else
+      {
+      transport = SEND_DATA_OBJECT;
+      }
+    }
+  controller->Send(&transport, 1, 1,
+    vtkClientServerMoveData::TRANSMIT_DATA_OBJECT);
+  if (transport == SEND_DATA_OBJECT)
+    {
+    return controller->Send(input, 1,
+      vtkClientServerMoveData::TRANSMIT_DATA_OBJECT);
+    }
+
+  // The length is sent as 64 bits so that payloads of 2 GiB or more are not
+  // truncated.
+  vtkTypeInt64 header[2];
+  header[0] = input->GetDataObjectType();
+  header[1] = length;
+  controller->Send(header, 2, 1,
     vtkClientServerMoveData::TRANSMIT_DATA_OBJECT);
+  if (transport == SEND_RAW_BUFFER)
+    {
+    return vtkPVSharedMemoryBuffer::SendBuffer(controller,
+      &vtkPVDataMarshaller::WriteBufferCallback, marshaller.GetPointer(),
+      length, 1, vtkClientServerMoveData::TRANSMIT_DATA_OBJECT)? 1 : 0;
+    }
+  return vtkPVSharedMemoryBuffer::SendBuffer(controller,
+    buffer->GetPointer(0), length, 1,
+    vtkClientServerMoveData::TRANSMIT_DATA_OBJECT)? 1 : 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -259,8 +350,56 @@ vtkDataObject* vtkClientServerMoveData::ReceiveData(vtkMultiProcessController* c
     }
   else
     {
-    data = controller->ReceiveDataObject(
-      1, vtkClientServerMoveData::TRANSMIT_DATA_OBJECT);
+    int transport = SEND_DATA_OBJECT;
+    controller->Receive(&transport, 1, 1,
+      vtkClientServerMoveData::TRANSMIT_DATA_OBJECT);
+    if (transport == SEND_DATA_OBJECT)
+      {
+      return controller->ReceiveDataObject(
+        1, vtkClientServerMoveData::TRANSMIT_DATA_OBJECT);
+      }
+
+    vtkTypeInt64 header[2] = {0, 0};
+    controller->Receive(header, 2, 1,
+      vtkClientServerMoveData::TRANSMIT_DATA_OBJECT);
+    vtkIdType length = static_cast<vtkIdType>(header[1]);
+    if (length != header[1])
+      {
+      vtkErrorMacro("Cannot receive " << header[1] << " bytes with "
+        << sizeof(vtkIdType) * 8 << " bit ids.");
+      return NULL;
+      }
+    vtkSmartPointer<vtkPVSharedMemoryBuffer> buffer;
+    buffer.TakeReference(vtkPVSharedMemoryBuffer::ReceiveBuffer(controller,
+        length, 1, vtkClientServerMoveData::TRANSMIT_DATA_OBJECT));
+    if (buffer && transport == SEND_RAW_BUFFER)
+      {
+      // Arrays reference the (possibly shared) buffer directly and keep it
+      // alive.
+      data = vtkPVDataMarshaller::Unmarshal(buffer->GetPointer(), length,
+        buffer);
+      if (!data)
+        {
+        vtkErrorMacro("Failed to unmarshal data object.");
+        }
+      return data;
+      }
+
+    data = vtkDataObjectTypes::NewDataObject(static_cast<int>(header[0]));
+    if (!buffer || !data)
+      {
+      vtkErrorMacro("Failed to receive data object.");
+      if (data)
+        {
+        data->Delete();
+        }
+      return NULL;
+      }
+
+    // Unmarshal straight out of the (possibly shared) buffer.
+    vtkNew<vtkCharArray> wrapper;
+    wrapper->SetArray(buffer->GetPointer(), length, 1);
+    vtkCommunicator::UnMarshalDataObject(wrapper.GetPointer(), data);
     }
   return data;
 }
@@ -16,10 +16,12 @@
 
 #include "vtkAlgorithmOutput.h"
 #include "vtkBoundingBox.h"
+#include "vtkColor.h"
 #include "vtkCommand.h"
 #include "vtkCompositeDataDisplayAttributes.h"
 #include "vtkCompositeDataIterator.h"
 #include "vtkCompositePolyDataMapper2.h"
+#include "vtkFieldData.h"
 #include "vtkHardwareSelectionPolyDataPainter.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
@@ -30,25 +32,37 @@
 #include "vtkMultiProcessController.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
+#include "vtkPolyData.h"
 #include "vtkProperty.h"
 #include "vtkPVCacheKeeper.h"
 #include "vtkPVGeometryFilter.h"
 #include "vtkPVLODActor.h"
+#include "vtkPVLODPyramid.h"
+#include "vtkPVPolyDataSplitter.h"
 #include "vtkPVRenderView.h"
+#include "vtkPVStreamingMacros.h"
 #include "vtkPVTrivialProducer.h"
 #include "vtkPVUpdateSuppressor.h"
-#include "vtkQuadricClustering.h"
 #include "vtkRenderer.h"
 #include "vtkSelectionConverter.h"
 #include "vtkSelection.h"
 #include "vtkSelectionNode.h"
 #include "vtkShadowMapBakerPass.h"
+#include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkStreamingPriorityQueue.h"
+#include "vtkTimeStamp.h"
 #include "vtkTransform.h"
+#include "vtkUnsignedIntArray.h"
 #include "vtkUnstructuredGrid.h"
+#include "vtkWeakPointer.h"
 
 #include <vtksys/SystemTools.hxx>
 
+#include <algorithm>
+#include <map>
+#include <vector>
+
 //*****************************************************************************
 // This is used to convert a vtkPolyData to a vtkMultiBlockDataSet. If input is
 // vtkMultiBlockDataSet, then this is simply a pass-through filter. This makes
@@ -90,6 +104,95 @@ protected:
 };
 vtkStandardNewMacro(vtkGeometryRepresentationMultiBlockMaker);
 
+//*****************************************************************************
+class vtkGeometryRepresentation::vtkStreamingInternals
+{
+public:
+  vtkNew<vtkPVPolyDataSplitter> Splitter;
+  vtkNew<vtkPVLODPyramid> Coarsener;
+  vtkStreamingPriorityQueue PriorityQueue;
+
+  // Global index of the first piece generated on this process and total
+  // number of pieces on all processes. Streamed pieces are multiblocks with
+  // NumberOfPieces blocks, with only the blocks being streamed set.
+  unsigned int PieceOffset;
+  unsigned int NumberOfPieces;
+
+  // Number of streaming passes left. This is the same on all processes (the
+  // largest number of pieces on any process) so that all processes take
+  // part in every pass, delivering empty pieces once they are done.
+  int StreamingPassesLeft;
+
+  // Decimated version of all pieces, delivered before streaming. NULL when
+  // not streaming.
+  vtkSmartPointer<vtkMultiBlockDataSet> ProcessedData;
+
+  // Piece produced by the last StreamingUpdate().
+  vtkSmartPointer<vtkMultiBlockDataSet> ProcessedPiece;
+
+  // On the rendering processes, the delivered data with the blocks replaced
+  // by the pieces streamed so far.
+  vtkSmartPointer<vtkMultiBlockDataSet> RenderedData;
+
+  // Set when the geometry is regenerated. PrepareForStreaming() only splits
+  // the geometry when it changed on some process.
+  bool DataChanged;
+
+  vtkStreamingInternals() : PieceOffset(0), NumberOfPieces(0),
+    StreamingPassesLeft(0), DataChanged(false)
+    {
+    // The coarse version only needs one level of the pyramid.
+    this->Coarsener->SetNumberOfLevels(1);
+    this->Coarsener->SetMaximumNumberOfDivisions(16);
+    this->Coarsener->SetCachingEnabled(false);
+    }
+
+  void Reset()
+    {
+    this->PriorityQueue = vtkStreamingPriorityQueue();
+    this->PieceOffset = 0;
+    this->NumberOfPieces = 0;
+    this->StreamingPassesLeft = 0;
+    this->ProcessedData = NULL;
+    this->ProcessedPiece = NULL;
+    }
+};
+
+//*****************************************************************************
+// Block properties set on the representation, by the flat index of the blocks
+// of the input. They are applied to the mapper by UpdateBlockProperties().
+class vtkGeometryRepresentation::vtkBlockProperties
+{
+public:
+  std::map<unsigned int, bool> Visibilities;
+  std::map<unsigned int, vtkColor3d> Colors;
+  std::map<unsigned int, double> Opacities;
+
+  vtkTimeStamp ModifiedTime;
+  vtkTimeStamp AppliedTime;
+  vtkWeakPointer<vtkDataObject> AppliedData;
+  unsigned long AppliedDataMTime;
+
+  vtkBlockProperties() : AppliedDataMTime(0) { }
+
+  // Returns the entry of the first index of the path found in the map.
+  template <class T>
+  static const T* Find(const std::map<unsigned int, T>& map,
+    vtkUnsignedIntArray* path)
+    {
+    for (vtkIdType cc=0; cc < path->GetNumberOfTuples(); cc++)
+      {
+      typename std::map<unsigned int, T>::const_iterator iter =
+        map.find(path->GetValue(cc));
+      if (iter != map.end())
+        {
+        return &iter->second;
+        }
+      }
+    return NULL;
+    }
+};
+
 //*****************************************************************************
 
 
@@ -100,7 +203,7 @@ vtkGeometryRepresentation::vtkGeometryRepresentation()
   this->GeometryFilter = vtkPVGeometryFilter::New();
   this->CacheKeeper = vtkPVCacheKeeper::New();
   this->MultiBlockMaker = vtkGeometryRepresentationMultiBlockMaker::New();
-  this->Decimator = vtkQuadricClustering::New();
+  this->Decimator = vtkPVLODPyramid::New();
   this->LODOutlineFilter = vtkPVGeometryFilter::New();
 
   // setup the selection mapper so that we don't need to make any selection
@@ -145,6 +248,10 @@ vtkGeometryRepresentation::vtkGeometryRepresentation()
 
   vtkMath::UninitializeBounds(this->DataBounds);
 
+  this->StreamingPieceSize = 250000;
+  this->StreamingInternals = new vtkStreamingInternals();
+  this->BlockProperties = new vtkBlockProperties();
+
   this->SetupDefaults();
 }
 
@@ -162,15 +269,20 @@ vtkGeometryRepresentation::~vtkGeometryRepresentation()
   this->Actor->Delete();
   this->Property->Delete();
   this->SetColorArrayName(0);
+  delete this->StreamingInternals;
+  this->StreamingInternals = NULL;
+  delete this->BlockProperties;
+  this->BlockProperties = NULL;
 }
 
 //----------------------------------------------------------------------------
 void vtkGeometryRepresentation::SetupDefaults()
 {
-  this->Decimator->SetUseInputPoints(1);
-  this->Decimator->SetCopyCellData(1);
-  this->Decimator->SetUseInternalTriangles(0);
-  this->Decimator->SetNumberOfDivisions(10, 10, 10);
+  // Levels from 160 down to 10 divisions, covering the range of divisions
+  // LOD_RESOLUTION maps to.
+  this->Decimator->SetMaximumNumberOfDivisions(160);
+  this->Decimator->SetNumberOfLevels(5);
+  this->Decimator->SetLevel(4);
   
   this->LODOutlineFilter->SetUseOutline(1);
 
@@ -229,8 +341,23 @@ int vtkGeometryRepresentation::ProcessViewRequest(
     // to provide a place-holder dataset of the right type. This is essential
     // since the vtkPVRenderView uses the type specified to decide on the
     // delivery mechanism, among other things.
-    vtkPVRenderView::SetPiece(inInfo, this,
-      this->CacheKeeper->GetOutputDataObject(0));
+    // When streaming, the decimated version of the pieces is delivered first.
+    // This is where the processes agree on streaming: all processes take part
+    // in every update of the view, while they may not all execute the
+    // representation the same number of times.
+    this->PrepareForStreaming();
+    vtkStreamingInternals& streaming = *this->StreamingInternals;
+    if (streaming.ProcessedData)
+      {
+      vtkPVRenderView::SetPiece(inInfo, this, streaming.ProcessedData);
+      }
+    else
+      {
+      vtkPVRenderView::SetPiece(inInfo, this,
+        this->CacheKeeper->GetOutputDataObject(0));
+      }
+    vtkPVRenderView::SetStreamable(inInfo, this,
+      streaming.StreamingPassesLeft > 0);
 
     // Since we are rendering polydata, it can be redistributed when ordered
     // compositing is needed. So let the view know that it can feel free to
@@ -266,7 +393,8 @@ int vtkGeometryRepresentation::ProcessViewRequest(
       if (inInfo->Has(vtkPVRenderView::USE_OUTLINE_FOR_LOD()))
         {
         // HACK to ensure that when Decimator is next employed, it delivers a
-        // new geometry.
+        // new geometry. This doesn't regenerate the decimated geometry of
+        // the levels already built.
         this->Decimator->Modified();
 
         this->LODOutlineFilter->Update();
@@ -277,15 +405,18 @@ int vtkGeometryRepresentation::ProcessViewRequest(
         }
       else
         {
-        // HACK to ensure that when Decimator is next employed, it delivers a
-        // new geometry.
+        // HACK to ensure that when LODOutlineFilter is next employed, it
+        // delivers a new geometry.
         this->LODOutlineFilter->Modified();
 
+        // The decimated geometry of each level is kept until the data
+        // changes, so going back to a level already used is cheap. Other
+        // resolutions are built exactly as requested.
         if (inInfo->Has(vtkPVRenderView::LOD_RESOLUTION()))
           {
           int division = static_cast<int>(150 *
             inInfo->Get(vtkPVRenderView::LOD_RESOLUTION())) + 10;
-          this->Decimator->SetNumberOfDivisions(division, division, division);
+          this->Decimator->SetNumberOfDivisions(division);
           }
 
         this->Decimator->Update();
@@ -301,7 +432,17 @@ int vtkGeometryRepresentation::ProcessViewRequest(
     {
     vtkAlgorithmOutput* producerPort = vtkPVRenderView::GetPieceProducer(inInfo, this);
     vtkAlgorithmOutput* producerPortLOD = vtkPVRenderView::GetPieceProducerLOD(inInfo, this);
-    this->Mapper->SetInputConnection(0, producerPort);
+    if (this->StreamingInternals->RenderedData)
+      {
+      this->Mapper->SetInputDataObject(0, this->StreamingInternals->RenderedData);
+      this->UpdateBlockProperties(this->StreamingInternals->RenderedData);
+      }
+    else
+      {
+      this->Mapper->SetInputConnection(0, producerPort);
+      this->UpdateBlockProperties(producerPort->GetProducer()->
+        GetOutputDataObject(producerPort->GetIndex()));
+      }
     this->LODMapper->SetInputConnection(0, producerPortLOD);
 
     // This is called just before the vtk-level render. In this pass, we simply
@@ -311,6 +452,55 @@ int vtkGeometryRepresentation::ProcessViewRequest(
     this->Actor->SetEnableLOD(lod? 1 : 0);
     this->UpdateColoringParameters();
     }
+  else if (request_type == vtkPVRenderView::REQUEST_STREAMING_UPDATE())
+    {
+    double view_planes[24];
+    inInfo->Get(vtkPVRenderView::VIEW_PLANES(), view_planes);
+    if (this->StreamingUpdate(view_planes))
+      {
+      vtkPVRenderView::SetNextStreamedPiece(inInfo, this,
+        this->StreamingInternals->ProcessedPiece);
+      }
+    }
+  else if (request_type == vtkPVRenderView::REQUEST_PROCESS_STREAMED_PIECE())
+    {
+    vtkMultiBlockDataSet* piece = vtkMultiBlockDataSet::SafeDownCast(
+      vtkPVRenderView::GetCurrentStreamedPiece(inInfo, this));
+    vtkStreamingInternals& streaming = *this->StreamingInternals;
+    if (piece && !streaming.RenderedData)
+      {
+      vtkStreamingStatusMacro(<< this << ": cloning delivered data.");
+      vtkAlgorithmOutput* producerPort =
+        vtkPVRenderView::GetPieceProducer(inInfo, this);
+      vtkMultiBlockDataSet* delivered = vtkMultiBlockDataSet::SafeDownCast(
+        producerPort->GetProducer()->GetOutputDataObject(
+          producerPort->GetIndex()));
+      if (delivered)
+        {
+        // Shallow copy, so that replacing blocks does not affect the
+        // delivered data.
+        streaming.RenderedData = vtkSmartPointer<vtkMultiBlockDataSet>::New();
+        streaming.RenderedData->ShallowCopy(delivered);
+        }
+      }
+
+    // The delivered data may have been restructured e.g. when redistributed
+    // for ordered compositing, in which case the pieces cannot be merged.
+    if (piece && streaming.RenderedData &&
+      piece->GetNumberOfBlocks() == streaming.RenderedData->GetNumberOfBlocks())
+      {
+      vtkStreamingStatusMacro(<< this << ": received new piece.");
+      for (unsigned int cc=0; cc < piece->GetNumberOfBlocks(); cc++)
+        {
+        if (vtkDataObject* block = piece->GetBlock(cc))
+          {
+          streaming.RenderedData->SetBlock(cc, block);
+          }
+        }
+      this->Mapper->SetInputDataObject(0, streaming.RenderedData);
+      this->UpdateBlockProperties(streaming.RenderedData);
+      }
+    }
 
   return 1;
 }
@@ -381,6 +571,8 @@ int vtkGeometryRepresentation::RequestData(vtkInformation* request,
   // Pass caching information to the cache keeper.
   this->CacheKeeper->SetCachingEnabled(this->GetUseCache());
   this->CacheKeeper->SetCacheTime(this->GetCacheKey());
+  this->Decimator->SetCachingEnabled(this->GetUseCache());
+  this->Decimator->SetCacheTime(this->GetCacheKey());
 
   if (inputVector[0]->GetNumberOfInformationObjects()==1)
     {
@@ -409,6 +601,11 @@ int vtkGeometryRepresentation::RequestData(vtkInformation* request,
     }
   this->CacheKeeper->Update();
 
+  // The data changed, so whatever was streamed is no longer valid. The new
+  // geometry is split when the view next updates, in PrepareForStreaming().
+  this->StreamingInternals->RenderedData = NULL;
+  this->StreamingInternals->DataChanged = true;
+
   // Determine data bounds.
   vtkCompositeDataSet* cd = vtkCompositeDataSet::SafeDownCast(
     this->CacheKeeper->GetOutputDataObject(0));
@@ -440,6 +637,144 @@ bool vtkGeometryRepresentation::IsCached(double cache_key)
   return this->CacheKeeper->IsCached(cache_key);
 }
 
+//----------------------------------------------------------------------------
+void vtkGeometryRepresentation::PrepareForStreaming()
+{
+  vtkStreamingInternals& streaming = *this->StreamingInternals;
+
+  // Streaming is not supported when caching geometry for animation playback.
+  // These settings are the same on all processes, hence either all or none
+  // of them communicate below.
+  if (!vtkPVView::GetEnableStreaming() || this->GetUseCache() ||
+    this->StreamingPieceSize <= 0)
+    {
+    streaming.Reset();
+    streaming.DataChanged = false;
+    return;
+    }
+
+  // Only split the geometry again when it changed on some process.
+  vtkMultiProcessController* controller =
+    vtkMultiProcessController::GetGlobalController();
+  int numProcs = controller? controller->GetNumberOfProcesses() : 1;
+  int myId = controller? controller->GetLocalProcessId() : 0;
+  int changed = streaming.DataChanged? 1 : 0;
+  if (numProcs > 1)
+    {
+    int localChanged = changed;
+    controller->AllReduce(&localChanged, &changed, 1,
+      vtkCommunicator::MAX_OP);
+    }
+  streaming.DataChanged = false;
+  if (!changed)
+    {
+    return;
+    }
+  streaming.Reset();
+  streaming.RenderedData = NULL;
+
+  streaming.Splitter->SetMaximumNumberOfCells(this->StreamingPieceSize);
+  streaming.Splitter->SetInputData(this->CacheKeeper->GetOutputDataObject(0));
+  // The pieces are released once streamed, so always split again.
+  streaming.Splitter->Modified();
+  streaming.Splitter->Update();
+  vtkMultiBlockDataSet* pieces = streaming.Splitter->GetOutput();
+
+  // Exchange the number of pieces and cells with all processes to number the
+  // pieces globally and to decide whether streaming is worth it.
+  vtkIdType local[2] = { pieces->GetNumberOfBlocks(), 0 };
+  for (unsigned int cc=0; cc < pieces->GetNumberOfBlocks(); cc++)
+    {
+    local[1] += vtkPolyData::SafeDownCast(
+      pieces->GetBlock(cc))->GetNumberOfCells();
+    }
+
+  std::vector<vtkIdType> all(2*numProcs);
+  if (numProcs > 1)
+    {
+    controller->AllGather(local, &all[0], 2);
+    }
+  else
+    {
+    all[0] = local[0];
+    all[1] = local[1];
+    }
+
+  vtkIdType maxPieces = 0, totalPieces = 0, totalCells = 0, offset = 0;
+  for (int cc=0; cc < numProcs; cc++)
+    {
+    offset += (cc < myId)? all[2*cc] : 0;
+    totalPieces += all[2*cc];
+    totalCells += all[2*cc+1];
+    maxPieces = std::max(maxPieces, all[2*cc]);
+    }
+  if (totalCells <= this->StreamingPieceSize)
+    {
+    pieces->Initialize();
+    return;
+    }
+
+  streaming.PieceOffset = static_cast<unsigned int>(offset);
+  streaming.NumberOfPieces = static_cast<unsigned int>(totalPieces);
+  streaming.StreamingPassesLeft = static_cast<int>(maxPieces);
+
+  // Deliver a decimated version of all pieces first.
+  vtkNew<vtkMultiBlockDataSet> coarseInput;
+  coarseInput->SetNumberOfBlocks(streaming.NumberOfPieces);
+  for (unsigned int cc=0; cc < pieces->GetNumberOfBlocks(); cc++)
+    {
+    vtkPolyData* piece = vtkPolyData::SafeDownCast(pieces->GetBlock(cc));
+    coarseInput->SetBlock(streaming.PieceOffset + cc, piece);
+
+    vtkStreamingPriorityQueueItem item;
+    item.Identifier = streaming.PieceOffset + cc;
+    item.Bounds.SetBounds(piece->GetBounds());
+    item.Priority = static_cast<double>(piece->GetNumberOfCells());
+    streaming.PriorityQueue.push(item);
+    }
+  streaming.Coarsener->SetInputData(coarseInput.GetPointer());
+  streaming.Coarsener->Update();
+  streaming.ProcessedData = vtkSmartPointer<vtkMultiBlockDataSet>::New();
+  streaming.ProcessedData->ShallowCopy(streaming.Coarsener->GetOutput());
+  streaming.Coarsener->SetInputData(NULL);
+
+  vtkStreamingStatusMacro(<< this << ": streaming " << pieces->GetNumberOfBlocks()
+    << " of " << streaming.NumberOfPieces << " pieces.");
+}
+
+//----------------------------------------------------------------------------
+bool vtkGeometryRepresentation::StreamingUpdate(const double view_planes[24])
+{
+  vtkStreamingInternals& streaming = *this->StreamingInternals;
+  if (streaming.StreamingPassesLeft <= 0)
+    {
+    return false;
+    }
+  streaming.StreamingPassesLeft--;
+
+  double clamp_bounds[6];
+  vtkMath::UninitializeBounds(clamp_bounds);
+  streaming.PriorityQueue.UpdatePriorities(view_planes, clamp_bounds);
+
+  streaming.ProcessedPiece = vtkSmartPointer<vtkMultiBlockDataSet>::New();
+  streaming.ProcessedPiece->SetNumberOfBlocks(streaming.NumberOfPieces);
+  if (!streaming.PriorityQueue.empty())
+    {
+    unsigned int index = streaming.PriorityQueue.top().Identifier;
+    streaming.PriorityQueue.pop();
+    vtkStreamingStatusMacro(<< this << ": streaming piece " << index);
+    streaming.ProcessedPiece->SetBlock(index,
+      streaming.Splitter->GetOutput()->GetBlock(
+        index - streaming.PieceOffset));
+    }
+  if (streaming.StreamingPassesLeft == 0)
+    {
+    // All pieces have been streamed, release them.
+    streaming.Splitter->GetOutput()->Initialize();
+    }
+  return true;
+}
+
 //----------------------------------------------------------------------------
 vtkDataObject* vtkGeometryRepresentation::GetRenderedDataObject(int port)
 {
@@ -460,6 +795,7 @@ void vtkGeometryRepresentation::MarkModified()
     {
     // Cleanup caches when not using cache.
     this->CacheKeeper->RemoveAllCaches();
+    this->Decimator->RemoveAllCaches();
     }
   this->Superclass::MarkModified();
 }
@@ -620,6 +956,7 @@ void vtkGeometryRepresentation::SetVisibility(bool val)
 void vtkGeometryRepresentation::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "StreamingPieceSize: " << this->StreamingPieceSize << endl;
 }
 
 //****************************************************************************
@@ -798,25 +1135,31 @@ bool vtkGeometryRepresentation::GenerateMetaData(vtkInformation*,
 //----------------------------------------------------------------------------
 void vtkGeometryRepresentation::SetBlockVisibility(unsigned int index, bool visible)
 {
-  vtkCompositePolyDataMapper2::SafeDownCast(this->Mapper)->SetBlockVisibility(index, visible);
+  this->BlockProperties->Visibilities[index] = visible;
+  this->BlockProperties->ModifiedTime.Modified();
 }
 
 //----------------------------------------------------------------------------
 bool vtkGeometryRepresentation::GetBlockVisibility(unsigned int index) const
 {
-  return vtkCompositePolyDataMapper2::SafeDownCast(this->Mapper)->GetBlockVisibility(index);
+  std::map<unsigned int, bool>::const_iterator iter =
+    this->BlockProperties->Visibilities.find(index);
+  return iter != this->BlockProperties->Visibilities.end()?
+    iter->second : true;
 }
 
 //----------------------------------------------------------------------------
 void vtkGeometryRepresentation::RemoveBlockVisibility(unsigned int index, bool)
 {
-  vtkCompositePolyDataMapper2::SafeDownCast(this->Mapper)->RemoveBlockVisibility(index);
+  this->BlockProperties->Visibilities.erase(index);
+  this->BlockProperties->ModifiedTime.Modified();
 }
 
 //----------------------------------------------------------------------------
 void vtkGeometryRepresentation::RemoveBlockVisibilities()
 {
-  vtkCompositePolyDataMapper2::SafeDownCast(this->Mapper)->RemoveBlockVisibilites();
+  this->BlockProperties->Visibilities.clear();
+  this->BlockProperties->ModifiedTime.Modified();
 }
 
 //----------------------------------------------------------------------------
@@ -829,31 +1172,38 @@ void vtkGeometryRepresentation::SetBlockColor(unsigned int index, double r, doub
 //----------------------------------------------------------------------------
 void vtkGeometryRepresentation::SetBlockColor(unsigned int index, double *color)
 {
-  vtkCompositePolyDataMapper2::SafeDownCast(this->Mapper)->SetBlockColor(index, color);
+  this->BlockProperties->Colors[index] = vtkColor3d(color[0], color[1], color[2]);
+  this->BlockProperties->ModifiedTime.Modified();
 }
 
 //----------------------------------------------------------------------------
 double* vtkGeometryRepresentation::GetBlockColor(unsigned int index)
 {
-  return vtkCompositePolyDataMapper2::SafeDownCast(this->Mapper)->GetBlockColor(index);
+  std::map<unsigned int, vtkColor3d>::iterator iter =
+    this->BlockProperties->Colors.find(index);
+  return iter != this->BlockProperties->Colors.end()?
+    iter->second.GetData() : NULL;
 }
 
 //----------------------------------------------------------------------------
 void vtkGeometryRepresentation::RemoveBlockColor(unsigned int index)
 {
-  vtkCompositePolyDataMapper2::SafeDownCast(this->Mapper)->RemoveBlockColor(index);
+  this->BlockProperties->Colors.erase(index);
+  this->BlockProperties->ModifiedTime.Modified();
 }
 
 //----------------------------------------------------------------------------
 void vtkGeometryRepresentation::RemoveBlockColors()
 {
-  vtkCompositePolyDataMapper2::SafeDownCast(this->Mapper)->RemoveBlockColors();
+  this->BlockProperties->Colors.clear();
+  this->BlockProperties->ModifiedTime.Modified();
 }
 
 //----------------------------------------------------------------------------
 void vtkGeometryRepresentation::SetBlockOpacity(unsigned int index, double opacity)
 {
-  return vtkCompositePolyDataMapper2::SafeDownCast(this->Mapper)->SetBlockOpacity(index, opacity);
+  this->BlockProperties->Opacities[index] = opacity;
+  this->BlockProperties->ModifiedTime.Modified();
 }
 
 //----------------------------------------------------------------------------
@@ -868,17 +1218,103 @@ void vtkGeometryRepresentation::SetBlockOpacity(unsigned int index, double *opac
 //----------------------------------------------------------------------------
 double vtkGeometryRepresentation::GetBlockOpacity(unsigned int index)
 {
-  return vtkCompositePolyDataMapper2::SafeDownCast(this->Mapper)->GetBlockOpacity(index);
+  std::map<unsigned int, double>::const_iterator iter =
+    this->BlockProperties->Opacities.find(index);
+  return iter != this->BlockProperties->Opacities.end()? iter->second : 1.0;
 }
 
 //----------------------------------------------------------------------------
 void vtkGeometryRepresentation::RemoveBlockOpacity(unsigned int index)
 {
-  vtkCompositePolyDataMapper2::SafeDownCast(this->Mapper)->RemoveBlockOpacity(index);
+  this->BlockProperties->Opacities.erase(index);
+  this->BlockProperties->ModifiedTime.Modified();
 }
 
 //----------------------------------------------------------------------------
 void vtkGeometryRepresentation::RemoveBlockOpacities()
 {
-  vtkCompositePolyDataMapper2::SafeDownCast(this->Mapper)->RemoveBlockOpacities();
+  this->BlockProperties->Opacities.clear();
+  this->BlockProperties->ModifiedTime.Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkGeometryRepresentation::UpdateBlockProperties(vtkDataObject* rendered)
+{
+  vtkCompositePolyDataMapper2* mapper =
+    vtkCompositePolyDataMapper2::SafeDownCast(this->Mapper);
+  vtkBlockProperties& props = *this->BlockProperties;
+  if (!mapper || (props.AppliedTime > props.ModifiedTime &&
+      props.AppliedData == rendered &&
+      props.AppliedDataMTime == (rendered? rendered->GetMTime() : 0)))
+    {
+    return;
+    }
+  props.AppliedTime.Modified();
+  props.AppliedData = rendered;
+  props.AppliedDataMTime = rendered? rendered->GetMTime() : 0;
+
+  mapper->RemoveBlockVisibilites();
+  mapper->RemoveBlockColors();
+  mapper->RemoveBlockOpacities();
+
+  // Blocks of streamed data are pieces of the input blocks, which know the
+  // flat indices of the input block and its ancestors (see
+  // vtkPVPolyDataSplitter). Other blocks are the input blocks themselves.
+  bool streamed = false;
+  vtkCompositeDataSet* cd = vtkCompositeDataSet::SafeDownCast(rendered);
+  vtkSmartPointer<vtkCompositeDataIterator> iter;
+  if (cd)
+    {
+    iter.TakeReference(cd->NewIterator());
+    for (iter->InitTraversal(); !iter->IsDoneWithTraversal();
+      iter->GoToNextItem())
+      {
+      vtkUnsignedIntArray* path = vtkUnsignedIntArray::SafeDownCast(
+        iter->GetCurrentDataObject()->GetFieldData()->GetArray("vtkBlockPath"));
+      if (!path || path->GetNumberOfTuples() == 0)
+        {
+        continue;
+        }
+      streamed = true;
+      unsigned int index = iter->GetCurrentFlatIndex();
+      if (const bool* visibility = vtkBlockProperties::Find(
+          props.Visibilities, path))
+        {
+        mapper->SetBlockVisibility(index, *visibility);
+        }
+      if (const vtkColor3d* color = vtkBlockProperties::Find(
+          props.Colors, path))
+        {
+        double rgb[3] = { color->GetRed(), color->GetGreen(), color->GetBlue() };
+        mapper->SetBlockColor(index, rgb);
+        }
+      if (const double* opacity = vtkBlockProperties::Find(
+          props.Opacities, path))
+        {
+        mapper->SetBlockOpacity(index, *opacity);
+        }
+      }
+    }
+  if (streamed)
+    {
+    return;
+    }
+
+  std::map<unsigned int, bool>::iterator visibility;
+  for (visibility = props.Visibilities.begin();
+    visibility != props.Visibilities.end(); ++visibility)
+    {
+    mapper->SetBlockVisibility(visibility->first, visibility->second);
+    }
+  std::map<unsigned int, vtkColor3d>::iterator color;
+  for (color = props.Colors.begin(); color != props.Colors.end(); ++color)
+    {
+    mapper->SetBlockColor(color->first, color->second.GetData());
+    }
+  std::map<unsigned int, double>::iterator opacity;
+  for (opacity = props.Opacities.begin(); opacity != props.Opacities.end();
+    ++opacity)
+    {
+    mapper->SetBlockOpacity(opacity->first, opacity->second);
+    }
 }
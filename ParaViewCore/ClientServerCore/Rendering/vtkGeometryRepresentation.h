@@ -18,6 +18,14 @@
 // vtkGeometryRepresentation is a representation for showing polygon geometry.
 // It handles non-polygonal datasets by extracting external surfaces. One can
 // use this representation to show surface/wireframe/points/surface-with-edges.
+//
+// When streaming is enabled (vtkPVView::GetEnableStreaming()) and the surface
+// has more than StreamingPieceSize cells, it is split into spatially coherent
+// pieces (see vtkPVPolyDataSplitter). A decimated version of all the pieces is
+// delivered first. The pieces are then delivered and rendered one per
+// streaming pass, in the order given by their coverage of the view frustum.
+// The pieces know which input block they come from, so block properties
+// (e.g. SetBlockVisibility()) apply to them too.
 // .SECTION Thanks
 // The addition of a transformation matrix was supported by CEA/DIF 
 // Commissariat a l'Energie Atomique, Centre DAM Ile-De-France, Arpajon, France.
@@ -34,7 +42,7 @@ class vtkMapper;
 class vtkPVCacheKeeper;
 class vtkPVGeometryFilter;
 class vtkPVLODActor;
-class vtkQuadricClustering;
+class vtkPVLODPyramid;
 class vtkScalarsToColors;
 class vtkTexture;
 
@@ -138,6 +146,13 @@ public:
   vtkGetMacro(RequestGhostCellsIfNeeded, bool);
   vtkBooleanMacro(RequestGhostCellsIfNeeded, bool);
 
+  // Description:
+  // Get/Set the maximum number of cells in a streamed piece. Default is
+  // 250000. Only used when streaming is enabled. Set to 0 to never stream
+  // the geometry.
+  vtkSetClampMacro(StreamingPieceSize, vtkIdType, 0, VTK_ID_MAX);
+  vtkGetMacro(StreamingPieceSize, vtkIdType);
+
   //***************************************************************************
   // Forwarded to vtkPVGeometryFilter
   virtual void SetUseOutline(int);
@@ -263,10 +278,28 @@ protected:
   // Overridden to check with the vtkPVCacheKeeper to see if the key is cached.
   virtual bool IsCached(double cache_key);
 
+  // Description:
+  // Splits the geometry into pieces and sets up the priority queue used to
+  // stream them, if streaming is enabled and the geometry changed on any
+  // process since the last call. Called in the vtkPVView::REQUEST_UPDATE()
+  // pass, on all processes, since it communicates with the other processes
+  // when streaming is enabled.
+  void PrepareForStreaming();
+
+  // Description:
+  // Picks the next piece to stream using the view planes to update the
+  // priorities. Returns false when there are no more pieces to stream.
+  bool StreamingUpdate(const double view_planes[24]);
+
+  // Description:
+  // Passes the block properties to the mapper for the given rendered data,
+  // unless already done.
+  void UpdateBlockProperties(vtkDataObject* rendered);
+
   vtkAlgorithm* GeometryFilter;
   vtkAlgorithm* MultiBlockMaker;
   vtkPVCacheKeeper* CacheKeeper;
-  vtkQuadricClustering* Decimator;
+  vtkPVLODPyramid* Decimator;
   vtkPVGeometryFilter* LODOutlineFilter;
 
   vtkMapper* Mapper;
@@ -284,6 +317,7 @@ protected:
   bool AllowSpecularHighlightingWithScalarColoring;
   bool RequestGhostCellsIfNeeded;
   double DataBounds[6];
+  vtkIdType StreamingPieceSize;
 
 private:
   vtkGeometryRepresentation(const vtkGeometryRepresentation&); // Not implemented
@@ -292,6 +326,12 @@ private:
   friend class vtkSelectionRepresentation;
   char* DebugString;
   vtkSetStringMacro(DebugString);
+
+  class vtkStreamingInternals;
+  vtkStreamingInternals* StreamingInternals;
+
+  class vtkBlockProperties;
+  vtkBlockProperties* BlockProperties;
 //ETX
 };
 
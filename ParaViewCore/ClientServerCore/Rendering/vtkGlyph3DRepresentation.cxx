@@ -47,6 +47,10 @@ vtkGlyph3DRepresentation::vtkGlyph3DRepresentation()
 
   this->GlyphMapper->SetInterpolateScalarsBeforeMapping(0);
   this->LODGlyphMapper->SetInterpolateScalarsBeforeMapping(0);
+
+  // The glyphs are placed at the points of the delivered data, so it must
+  // never be replaced by the decimated version used for streaming.
+  this->StreamingPieceSize = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -30,6 +30,7 @@
 #include "vtkMultiBlockDataSet.h"
 #include "vtkMultiProcessController.h"
 #include "vtkMultiProcessControllerHelper.h"
+#include "vtkNew.h"
 #include "vtkNonOverlappingAMR.h"
 #include "vtkObjectFactory.h"
 #include "vtkOutlineFilter.h"
@@ -38,7 +39,9 @@
 #include "vtkPolyData.h"
 #include "vtkProcessModule.h"
 #include "vtkPVConfig.h"
+#include "vtkPVDataMarshaller.h"
 #include "vtkPVSession.h"
+#include "vtkPVSharedMemoryBuffer.h"
 #include "vtkSmartPointer.h"
 #include "vtkSocketCommunicator.h"
 #include "vtkSocketController.h"
@@ -47,6 +50,7 @@
 #include "vtkToolkits.h"
 #include "vtkUndirectedGraph.h"
 #include "vtkUnstructuredGrid.h"
+#include "vtkZLibDataCompressor.h"
 
 #include "vtk_zlib.h"
 #include <vtksys/ios/sstream>
@@ -60,6 +64,7 @@
 #include <vector>
 
 bool vtkMPIMoveData::UseZLibCompression = false;
+bool vtkMPIMoveData::UseRawMarshalling = true;
 
 namespace
 {
@@ -68,6 +73,23 @@ namespace
     {
     return vtkMultiProcessControllerHelper::MergePieces(pieces, result);
     }
+
+  // Sets the compressor of the raw marshaller for the given connection.
+  static void vtkMPIMoveDataSetUpMarshaller(vtkPVDataMarshaller* marshaller,
+    vtkObject* connection, bool useZLib)
+    {
+    vtkDataCompressor* compressor =
+      vtkPVDataMarshaller::GetConnectionCompressor(connection);
+    if (compressor)
+      {
+      marshaller->SetCompressor(compressor);
+      }
+    else if (useZLib)
+      {
+      vtkNew<vtkZLibDataCompressor> zlib;
+      marshaller->SetCompressor(zlib.GetPointer());
+      }
+    }
 };
 
 
@@ -171,6 +193,18 @@ bool vtkMPIMoveData::GetUseZLibCompression()
   return vtkMPIMoveData::UseZLibCompression;
 }
 
+//----------------------------------------------------------------------------
+void vtkMPIMoveData::SetUseRawMarshalling(bool b)
+{
+  vtkMPIMoveData::UseRawMarshalling = b;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMPIMoveData::GetUseRawMarshalling()
+{
+  return vtkMPIMoveData::UseRawMarshalling;
+}
+
 //----------------------------------------------------------------------------
 int vtkMPIMoveData::FillInputPortInformation(int, vtkInformation *info)
 {
@@ -793,7 +827,7 @@ void vtkMPIMoveData::DataServerSendToRenderServer(vtkDataObject* output)
   //int fixme;
   // We might be able to eliminate this marshal.
   this->ClearBuffer();
-  this->MarshalDataToBuffer(output);
+  this->MarshalDataToBuffer(output, this->MPIMToNSocketConnection);
 
   com->Send(&(this->NumberOfBuffers), 1, 1, 23480);
   com->Send(this->BufferLengths, this->NumberOfBuffers, 1, 23481);
@@ -852,7 +886,7 @@ void vtkMPIMoveData::DataServerZeroSendToRenderServerZero(vtkDataObject* data)
     //int fixme;
     // We might be able to eliminate this marshal.
     this->ClearBuffer();
-    this->MarshalDataToBuffer(data);
+    this->MarshalDataToBuffer(data, this->MPIMToNSocketConnection);
     com->Send(&(this->NumberOfBuffers), 1, 1, 23480);
     com->Send(this->BufferLengths, this->NumberOfBuffers, 1, 23481);
     com->Send(this->Buffers, this->BufferTotalLength, 1, 23482);
@@ -911,13 +945,37 @@ void vtkMPIMoveData::DataServerSendToClient(vtkDataObject* output)
     {
     vtkTimerLog::MarkStartEvent("Dataserver sending to client");
     this->ClearBuffer();
-    this->MarshalDataToBuffer(output);
+    if (vtkMPIMoveData::UseRawMarshalling &&
+      vtkPVDataMarshaller::CanMarshal(output))
+      {
+      // The values are copied directly in the buffer being sent, which is a
+      // shared memory segment when the client is on the same host, rather
+      // than in this->Buffers first.
+      vtkNew<vtkPVDataMarshaller> marshaller;
+      vtkMPIMoveDataSetUpMarshaller(marshaller.GetPointer(),
+        this->ClientDataServerSocketController,
+        vtkMPIMoveData::UseZLibCompression);
+      vtkIdType length = marshaller->Prepare(output);
+      int numberOfBuffers = 1;
+      this->ClientDataServerSocketController->Send(
+                                     &numberOfBuffers, 1, 1, 23490);
+      this->ClientDataServerSocketController->Send(&length, 1, 1, 23491);
+      vtkPVSharedMemoryBuffer::SendBuffer(
+        this->ClientDataServerSocketController,
+        &vtkPVDataMarshaller::WriteBufferCallback, marshaller.GetPointer(),
+        length, 1, 23492);
+      vtkTimerLog::MarkEndEvent("Dataserver sending to client");
+      return;
+      }
+    this->MarshalDataToBuffer(output, this->ClientDataServerSocketController);
     this->ClientDataServerSocketController->Send(
                                      &(this->NumberOfBuffers), 1, 1, 23490);
     this->ClientDataServerSocketController->Send(this->BufferLengths,
                                      this->NumberOfBuffers, 1, 23491);
-    this->ClientDataServerSocketController->Send(this->Buffers,
-                                     this->BufferTotalLength, 1, 23492);
+    // When the client is on the same host, this passes the buffer through
+    // shared memory instead of the socket.
+    vtkPVSharedMemoryBuffer::SendBuffer(this->ClientDataServerSocketController,
+      this->Buffers, this->BufferTotalLength, 1, 23492);
     this->ClearBuffer();
     vtkTimerLog::MarkEndEvent("Dataserver sending to client");
     }
@@ -947,10 +1005,24 @@ void vtkMPIMoveData::ClientReceiveFromDataServer(vtkDataObject* output)
     this->BufferOffsets[idx] = this->BufferTotalLength;
     this->BufferTotalLength += this->BufferLengths[idx];
     }
-  this->Buffers = new char[this->BufferTotalLength];
-  com->Receive(this->Buffers, this->BufferTotalLength,
-                                  1, 23492);
-  this->ReconstructDataFromBuffer(output);
+  vtkSmartPointer<vtkPVSharedMemoryBuffer> buffer;
+  buffer.TakeReference(vtkPVSharedMemoryBuffer::ReceiveBuffer(
+      this->ClientDataServerSocketController, this->BufferTotalLength,
+      1, 23492));
+  if (!buffer)
+    {
+    vtkErrorMacro("Failed to receive data from the data server.");
+    this->ClearBuffer();
+    output->Initialize();
+    return;
+    }
+
+  // The buffer is owned by vtkPVSharedMemoryBuffer (it may be mapped from the
+  // data server's memory), so don't let ClearBuffer() delete it. Arrays
+  // referencing the buffer keep it alive.
+  this->Buffers = buffer->GetPointer();
+  this->ReconstructDataFromBuffer(output, buffer);
+  this->Buffers = 0;
   this->ClearBuffer();
 }
 
@@ -1039,8 +1111,26 @@ void vtkMPIMoveData::ClearBuffer()
 }
 
 //-----------------------------------------------------------------------------
-void vtkMPIMoveData::MarshalDataToBuffer(vtkDataObject* data)
+void vtkMPIMoveData::MarshalDataToBuffer(vtkDataObject* data,
+  vtkObject* connection)
 {
+  if (vtkMPIMoveData::UseRawMarshalling &&
+    vtkPVDataMarshaller::CanMarshal(data))
+    {
+    vtkNew<vtkPVDataMarshaller> marshaller;
+    vtkMPIMoveDataSetUpMarshaller(marshaller.GetPointer(), connection,
+      vtkMPIMoveData::UseZLibCompression);
+    vtkIdType length = 0;
+    this->Buffers = marshaller->Marshal(data, length);
+    this->NumberOfBuffers = 1;
+    this->BufferLengths = new vtkIdType[1];
+    this->BufferLengths[0] = length;
+    this->BufferOffsets = new vtkIdType[1];
+    this->BufferOffsets[0] = 0;
+    this->BufferTotalLength = length;
+    return;
+    }
+
   vtkDataSet* dataSet = vtkDataSet::SafeDownCast(data);
   vtkImageData* imageData = vtkImageData::SafeDownCast(data);
   vtkGraph* graph = vtkGraph::SafeDownCast(data);
@@ -1124,7 +1214,8 @@ void vtkMPIMoveData::MarshalDataToBuffer(vtkDataObject* data)
 }
 
 //-----------------------------------------------------------------------------
-void vtkMPIMoveData::ReconstructDataFromBuffer(vtkDataObject* data)
+void vtkMPIMoveData::ReconstructDataFromBuffer(vtkDataObject* data,
+  vtkObjectBase* bufferOwner)
 {
   if (this->NumberOfBuffers == 0 || this->Buffers == 0)
     {
@@ -1135,11 +1226,48 @@ void vtkMPIMoveData::ReconstructDataFromBuffer(vtkDataObject* data)
   bool is_image_data = data->IsA("vtkImageData") != 0;
   std::vector<vtkSmartPointer<vtkDataObject> > pieces;
 
+  // Holds the buffer if we end up taking it over.
+  vtkSmartPointer<vtkObject> adoptedBuffer;
+  char* buffers = this->Buffers;
+
   for (int idx = 0; idx < this->NumberOfBuffers; ++idx)
     {
-    char* bufferArray = this->Buffers+this->BufferOffsets[idx];
+    char* bufferArray = buffers+this->BufferOffsets[idx];
     vtkIdType bufferLength = this->BufferLengths[idx];
 
+    if (vtkPVDataMarshaller::IsMarshalledData(bufferArray, bufferLength))
+      {
+      vtkSmartPointer<vtkDataObject> piece;
+      if (reinterpret_cast<size_t>(bufferArray) % 8 != 0)
+        {
+        // Pieces following a legacy-format piece may not be aligned. Arrays
+        // cannot reference such a buffer, so they are copied.
+        std::vector<double> aligned(static_cast<size_t>(bufferLength+7)/8);
+        memcpy(&aligned[0], bufferArray, static_cast<size_t>(bufferLength));
+        piece.TakeReference(vtkPVDataMarshaller::Unmarshal(
+            reinterpret_cast<char*>(&aligned[0]), bufferLength, NULL));
+        }
+      else
+        {
+        if (!bufferOwner)
+          {
+          // Take over the buffer so that the arrays can keep referencing it
+          // after ClearBuffer().
+          adoptedBuffer.TakeReference(
+            vtkPVDataMarshaller::NewBufferOwner(this->Buffers));
+          this->Buffers = 0;
+          bufferOwner = adoptedBuffer;
+          }
+        piece.TakeReference(vtkPVDataMarshaller::Unmarshal(
+            bufferArray, bufferLength, bufferOwner));
+        }
+      if (piece)
+        {
+        pieces.push_back(piece);
+        }
+      continue;
+      }
+
     char* realBuffer = 0;
     if (bufferLength > 4 && strncmp(bufferArray, "zlib", 4) == 0)
       {
@@ -96,6 +96,18 @@ public:
   static void SetUseZLibCompression(bool b);
   static bool GetUseZLibCompression();
 
+  // Description:
+  // When set to true (default), data types supported by vtkPVDataMarshaller
+  // are sent using its raw binary format instead of the legacy VTK file
+  // format. Reconstructing such data does not require any parsing and arrays
+  // reference the received buffer directly. Arrays are compressed using the
+  // compressor registered for the connection with
+  // vtkPVDataMarshaller::SetConnectionCompressor(), if any, otherwise using
+  // zlib when UseZLibCompression is set. As with UseZLibCompression, this only
+  // affects the data-sender processes.
+  static void SetUseRawMarshalling(bool b);
+  static bool GetUseRawMarshalling();
+
   // Description:
   // vtkMPIMoveData doesn't necessarily generate a valid output data on all the
   // involved processes (depending on the MoveMode and Server ivars). This
@@ -157,8 +169,17 @@ protected:
   vtkIdType  BufferTotalLength;
 
   void ClearBuffer();
-  void MarshalDataToBuffer(vtkDataObject* data);
-  void ReconstructDataFromBuffer(vtkDataObject* data);
+  // Description:
+  // connection is the controller/communicator the buffer will be sent over.
+  // It is used to look up the compressor to use.
+  void MarshalDataToBuffer(vtkDataObject* data, vtkObject* connection=NULL);
+
+  // Description:
+  // bufferOwner, when non-NULL, is an object keeping this->Buffers alive.
+  // Otherwise, if some of the data references this->Buffers, it is taken over
+  // and this->Buffers is set to NULL.
+  void ReconstructDataFromBuffer(vtkDataObject* data,
+    vtkObjectBase* bufferOwner=NULL);
 
   int MoveMode;
   int Server;
@@ -182,6 +203,7 @@ private:
   void operator=(const vtkMPIMoveData&); // Not implemented
 
   static bool UseZLibCompression;
+  static bool UseRawMarshalling;
 };
 
 #endif
@@ -0,0 +1,1094 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVDataMarshaller.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPVDataMarshaller.h"
+
+#include "vtkByteSwap.h"
+#include "vtkCallbackCommand.h"
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkDataArray.h"
+#include "vtkDataObjectTypes.h"
+#include "vtkFieldData.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageData.h"
+#include "vtkInformation.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkMultiPieceDataSet.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPVInstantiator.h"
+#include "vtkRectilinearGrid.h"
+#include "vtkSmartPointer.h"
+#include "vtkStructuredGrid.h"
+#include "vtkTimerLog.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkUnstructuredGrid.h"
+#include "vtkWeakPointer.h"
+#include "vtkZLibDataCompressor.h"
+
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace
+{
+  // The buffer starts with this magic string, followed by a byte-order mark,
+  // the size of vtkIdType on the sender and the total length.
+  const char MAGIC[8] = { 'v', 't', 'k', 'P', 'V', 'R', 'a', 'w' };
+  const vtkTypeUInt32 BYTE_ORDER_MARK = 0x01020304;
+  const vtkTypeUInt32 SWAPPED_BYTE_ORDER_MARK = 0x04030201;
+  const vtkIdType HEADER_SIZE = 24;
+
+  inline vtkIdType vtkAlign(vtkIdType offset)
+    {
+    return (offset + 7) & ~static_cast<vtkIdType>(7);
+    }
+
+  typedef std::map<vtkObject*, std::pair<vtkWeakPointer<vtkObject>,
+    vtkSmartPointer<vtkDataCompressor> > > MapOfConnectionCompressors;
+  static MapOfConnectionCompressors ConnectionCompressors;
+
+  void vtkReleaseBufferOwner(vtkObject*, unsigned long, void* clientdata,
+    void*)
+    {
+    static_cast<vtkObjectBase*>(clientdata)->UnRegister(NULL);
+    }
+
+  // Returns true if all arrays in the field data can be marshalled.
+  bool vtkCanMarshal(vtkFieldData* fd)
+    {
+    if (!fd)
+      {
+      return true;
+      }
+    for (int cc=0; cc < fd->GetNumberOfArrays(); cc++)
+      {
+      vtkAbstractArray* array = fd->GetAbstractArray(cc);
+      if (array && (!array->IsA("vtkDataArray") ||
+          array->GetDataType() == VTK_BIT))
+        {
+        return false;
+        }
+      }
+    return true;
+    }
+}
+
+//****************************************************************************
+class vtkPVDataMarshallerBufferOwner : public vtkObject
+{
+public:
+  static vtkPVDataMarshallerBufferOwner* New();
+  vtkTypeMacro(vtkPVDataMarshallerBufferOwner, vtkObject);
+  char* Buffer;
+
+protected:
+  vtkPVDataMarshallerBufferOwner() { this->Buffer = NULL; }
+  ~vtkPVDataMarshallerBufferOwner() { delete [] this->Buffer; }
+
+private:
+  vtkPVDataMarshallerBufferOwner(const vtkPVDataMarshallerBufferOwner&);
+  void operator=(const vtkPVDataMarshallerBufferOwner&);
+};
+vtkStandardNewMacro(vtkPVDataMarshallerBufferOwner);
+
+//****************************************************************************
+// Builds the buffer as a list of segments, so that array values are copied
+// exactly once, into the final buffer.
+class vtkPVDataMarshaller::vtkWriter
+{
+public:
+  struct vtkSegment
+    {
+    std::vector<char> Data;            // small, owned data.
+    const void* Pointer;               // or external data.
+    vtkIdType Size;
+    vtkSmartPointer<vtkObjectBase> Keep; // keeps external data alive.
+    };
+  std::vector<vtkSegment> Segments;
+  vtkIdType Length;
+  vtkDataCompressor* Compressor;
+  vtkIdType CompressionThreshold;
+
+  vtkWriter() : Length(0), Compressor(NULL), CompressionThreshold(0) {}
+
+  std::vector<char>& Small()
+    {
+    if (this->Segments.size() == 0 || this->Segments.back().Pointer != NULL)
+      {
+      this->Segments.push_back(vtkSegment());
+      this->Segments.back().Pointer = NULL;
+      this->Segments.back().Size = 0;
+      }
+    return this->Segments.back().Data;
+    }
+
+  void Write(const void* data, vtkIdType size)
+    {
+    std::vector<char>& small = this->Small();
+    const char* cdata = static_cast<const char*>(data);
+    small.insert(small.end(), cdata, cdata + size);
+    this->Length += size;
+    }
+
+  void WriteInt(int value)
+    {
+    vtkTypeInt32 val = static_cast<vtkTypeInt32>(value);
+    this->Write(&val, sizeof(val));
+    }
+
+  void WriteInt64(vtkTypeInt64 value)
+    {
+    this->Write(&value, sizeof(value));
+    }
+
+  void WriteString(const char* str)
+    {
+    int length = str? static_cast<int>(strlen(str)) : -1;
+    this->WriteInt(length);
+    if (length > 0)
+      {
+      this->Write(str, length);
+      }
+    }
+
+  void Pad()
+    {
+    static const char zeros[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    vtkIdType padding = vtkAlign(this->Length) - this->Length;
+    if (padding > 0)
+      {
+      this->Write(zeros, padding);
+      }
+    }
+
+  void WriteExternal(const void* data, vtkIdType size, vtkObjectBase* keep)
+    {
+    vtkSegment segment;
+    segment.Pointer = data;
+    segment.Size = size;
+    segment.Keep = keep;
+    this->Segments.push_back(segment);
+    this->Length += size;
+    }
+
+  void WriteArray(vtkDataArray* array)
+    {
+    if (!array)
+      {
+      this->WriteInt(-1);
+      return;
+      }
+    int numComps = array->GetNumberOfComponents();
+    vtkIdType rawSize = array->GetNumberOfTuples() * numComps *
+      array->GetDataTypeSize();
+
+    this->WriteInt(array->GetDataType());
+    this->WriteInt(array->GetDataTypeSize());
+    this->WriteInt(numComps);
+    this->WriteInt64(array->GetNumberOfTuples());
+    this->WriteString(array->GetName());
+    this->WriteInt(array->HasAComponentName()? 1 : 0);
+    if (array->HasAComponentName())
+      {
+      for (int cc=0; cc < numComps; cc++)
+        {
+        this->WriteString(array->GetComponentName(cc));
+        }
+      }
+
+    const void* values = array->GetVoidPointer(0);
+    vtkSmartPointer<vtkUnsignedCharArray> compressed;
+    if (this->Compressor && rawSize >= this->CompressionThreshold &&
+      rawSize > 0)
+      {
+      compressed.TakeReference(this->Compressor->Compress(
+          static_cast<const unsigned char*>(values),
+          static_cast<size_t>(rawSize)));
+      if (compressed && compressed->GetNumberOfTuples() >= rawSize)
+        {
+        // not worth it.
+        compressed = NULL;
+        }
+      }
+
+    if (compressed)
+      {
+      this->WriteString(this->Compressor->GetClassName());
+      this->WriteInt64(compressed->GetNumberOfTuples());
+      this->WriteInt64(rawSize);
+      this->Pad();
+      this->WriteExternal(compressed->GetPointer(0),
+        compressed->GetNumberOfTuples(), compressed);
+      }
+    else
+      {
+      this->WriteString(NULL);
+      this->WriteInt64(rawSize);
+      this->WriteInt64(rawSize);
+      this->Pad();
+      this->WriteExternal(values, rawSize, array);
+      }
+    this->Pad();
+    }
+
+  void WriteFieldData(vtkFieldData* fd)
+    {
+    vtkDataSetAttributes* dsa = vtkDataSetAttributes::SafeDownCast(fd);
+    int numArrays = fd? fd->GetNumberOfArrays() : 0;
+    this->WriteInt(numArrays);
+    for (int cc=0; cc < numArrays; cc++)
+      {
+      this->WriteInt(dsa? dsa->IsArrayAnAttribute(cc) : -1);
+      this->WriteArray(fd->GetArray(cc));
+      }
+    }
+
+  void WritePoints(vtkPoints* points)
+    {
+    this->WriteArray(points? points->GetData() : NULL);
+    }
+
+  void WriteCells(vtkCellArray* cells)
+    {
+    this->WriteInt64(cells? cells->GetNumberOfCells() : 0);
+    this->WriteArray(cells? cells->GetData() : NULL);
+    }
+
+  void WriteDataObject(vtkDataObject* data)
+    {
+    if (!data)
+      {
+      this->WriteInt(-1);
+      return;
+      }
+
+    int type = data->GetDataObjectType();
+    this->WriteInt(type);
+    this->WriteFieldData(data->GetFieldData());
+
+    if (vtkCompositeDataSet* cd = vtkCompositeDataSet::SafeDownCast(data))
+      {
+      vtkMultiBlockDataSet* mb = vtkMultiBlockDataSet::SafeDownCast(cd);
+      vtkMultiPieceDataSet* mp = vtkMultiPieceDataSet::SafeDownCast(cd);
+      unsigned int num = mb? mb->GetNumberOfBlocks() : mp->GetNumberOfPieces();
+      this->WriteInt(static_cast<int>(num));
+      for (unsigned int cc=0; cc < num; cc++)
+        {
+        vtkInformation* md = NULL;
+        if (mb && mb->HasMetaData(cc))
+          {
+          md = mb->GetMetaData(cc);
+          }
+        else if (mp && mp->HasMetaData(cc))
+          {
+          md = mp->GetMetaData(cc);
+          }
+        this->WriteString((md && md->Has(vtkCompositeDataSet::NAME()))?
+          md->Get(vtkCompositeDataSet::NAME()) : NULL);
+        this->WriteDataObject(mb? mb->GetBlock(cc) : mp->GetPiece(cc));
+        }
+      return;
+      }
+
+    vtkDataSet* ds = vtkDataSet::SafeDownCast(data);
+    if (vtkImageData* id = vtkImageData::SafeDownCast(data))
+      {
+      this->Write(id->GetExtent(), 6*sizeof(int));
+      this->Write(id->GetOrigin(), 3*sizeof(double));
+      this->Write(id->GetSpacing(), 3*sizeof(double));
+      }
+    else if (vtkRectilinearGrid* rg = vtkRectilinearGrid::SafeDownCast(data))
+      {
+      this->Write(rg->GetExtent(), 6*sizeof(int));
+      this->WriteArray(rg->GetXCoordinates());
+      this->WriteArray(rg->GetYCoordinates());
+      this->WriteArray(rg->GetZCoordinates());
+      }
+    else if (vtkStructuredGrid* sg = vtkStructuredGrid::SafeDownCast(data))
+      {
+      this->Write(sg->GetExtent(), 6*sizeof(int));
+      this->WritePoints(sg->GetPoints());
+      }
+    else if (vtkPolyData* pd = vtkPolyData::SafeDownCast(data))
+      {
+      this->WritePoints(pd->GetPoints());
+      this->WriteCells(pd->GetVerts());
+      this->WriteCells(pd->GetLines());
+      this->WriteCells(pd->GetPolys());
+      this->WriteCells(pd->GetStrips());
+      }
+    else if (vtkUnstructuredGrid* ug = vtkUnstructuredGrid::SafeDownCast(data))
+      {
+      this->WritePoints(ug->GetPoints());
+      this->WriteCells(ug->GetCells());
+      this->WriteArray(ug->GetCellTypesArray());
+      this->WriteArray(ug->GetCellLocationsArray());
+      }
+    this->WriteFieldData(ds->GetPointData());
+    this->WriteFieldData(ds->GetCellData());
+    }
+
+  // Copies the segments to buffer, which must hold vtkAlign(Length) bytes,
+  // zero-pads the end and fills in the total length.
+  void Flatten(char* buffer)
+    {
+    vtkIdType offset = 0;
+    for (size_t cc=0; cc < this->Segments.size(); cc++)
+      {
+      vtkSegment& segment = this->Segments[cc];
+      const void* ptr = segment.Pointer;
+      vtkIdType size = segment.Size;
+      if (!ptr)
+        {
+        ptr = segment.Data.size() > 0? &segment.Data[0] : NULL;
+        size = static_cast<vtkIdType>(segment.Data.size());
+        }
+      if (size > 0)
+        {
+        memcpy(buffer + offset, ptr, static_cast<size_t>(size));
+        }
+      offset += size;
+      }
+    memset(buffer + offset, 0,
+      static_cast<size_t>(vtkAlign(this->Length) - offset));
+    vtkTypeInt64 totalLength = vtkAlign(this->Length);
+    memcpy(buffer + 16, &totalLength, sizeof(totalLength));
+    }
+};
+
+//****************************************************************************
+class vtkPVDataMarshaller::vtkReader
+{
+public:
+  char* Buffer;
+  vtkIdType Length;
+  vtkIdType Position;
+  bool Swap;
+  int IdTypeSize;
+  vtkObjectBase* Owner;
+  bool Error;
+  std::map<std::string, vtkSmartPointer<vtkDataCompressor> > Compressors;
+
+  bool Read(void* data, vtkIdType size)
+    {
+    if (this->Error || this->Position + size > this->Length)
+      {
+      this->Error = true;
+      memset(data, 0, static_cast<size_t>(size));
+      return false;
+      }
+    memcpy(data, this->Buffer + this->Position, static_cast<size_t>(size));
+    this->Position += size;
+    return true;
+    }
+
+  int ReadInt()
+    {
+    vtkTypeInt32 value = 0;
+    this->Read(&value, sizeof(value));
+    if (this->Swap)
+      {
+      vtkByteSwap::SwapVoidRange(&value, 1, sizeof(value));
+      }
+    return static_cast<int>(value);
+    }
+
+  vtkTypeInt64 ReadInt64()
+    {
+    vtkTypeInt64 value = 0;
+    this->Read(&value, sizeof(value));
+    if (this->Swap)
+      {
+      vtkByteSwap::SwapVoidRange(&value, 1, sizeof(value));
+      }
+    return value;
+    }
+
+  void ReadInts(int* values, int count)
+    {
+    for (int cc=0; cc < count; cc++)
+      {
+      values[cc] = this->ReadInt();
+      }
+    }
+
+  void ReadDoubles(double* values, int count)
+    {
+    this->Read(values, count*sizeof(double));
+    if (this->Swap)
+      {
+      vtkByteSwap::SwapVoidRange(values, count, sizeof(double));
+      }
+    }
+
+  bool ReadString(std::string& str)
+    {
+    int length = this->ReadInt();
+    str.clear();
+    if (length > 0 && !this->Error)
+      {
+      if (this->Position + length > this->Length)
+        {
+        this->Error = true;
+        return false;
+        }
+      str.assign(this->Buffer + this->Position, length);
+      this->Position += length;
+      }
+    return length >= 0;
+    }
+
+  vtkDataCompressor* GetCompressor(const std::string& name)
+    {
+    vtkSmartPointer<vtkDataCompressor>& compressor = this->Compressors[name];
+    if (!compressor)
+      {
+      vtkObject* obj = vtkPVInstantiator::CreateInstance(name.c_str());
+      compressor = vtkDataCompressor::SafeDownCast(obj);
+      if (obj)
+        {
+        obj->Delete();
+        }
+      if (!compressor && name == "vtkZLibDataCompressor")
+        {
+        compressor = vtkSmartPointer<vtkZLibDataCompressor>::New();
+        }
+      }
+    return compressor;
+    }
+
+  vtkDataArray* ReadArray()
+    {
+    int dataType = this->ReadInt();
+    if (dataType == -1 || this->Error)
+      {
+      return NULL;
+      }
+    int elementSize = this->ReadInt();
+    int numComps = this->ReadInt();
+    vtkTypeInt64 numTuples = this->ReadInt64();
+    std::string name;
+    bool hasName = this->ReadString(name);
+    std::vector<std::string> componentNames;
+    std::vector<bool> hasComponentName;
+    if (this->ReadInt())
+      {
+      componentNames.resize(numComps);
+      hasComponentName.resize(numComps);
+      for (int cc=0; cc < numComps; cc++)
+        {
+        hasComponentName[cc] = this->ReadString(componentNames[cc]);
+        }
+      }
+    std::string codec;
+    this->ReadString(codec);
+    vtkTypeInt64 storedSize = this->ReadInt64();
+    vtkTypeInt64 rawSize = this->ReadInt64();
+    this->Position = vtkAlign(this->Position);
+    if (this->Error || numComps <= 0 ||
+      this->Position + storedSize > this->Length)
+      {
+      this->Error = true;
+      return NULL;
+      }
+    char* values = this->Buffer + this->Position;
+    this->Position = vtkAlign(this->Position + storedSize);
+
+    vtkDataArray* array = vtkDataArray::CreateDataArray(dataType);
+    if (!array)
+      {
+      this->Error = true;
+      return NULL;
+      }
+    array->SetNumberOfComponents(numComps);
+    if (hasName)
+      {
+      array->SetName(name.c_str());
+      }
+    for (size_t cc=0; cc < componentNames.size(); cc++)
+      {
+      if (hasComponentName[cc])
+        {
+        array->SetComponentName(static_cast<vtkIdType>(cc),
+          componentNames[cc].c_str());
+        }
+      }
+
+    vtkIdType numValues = static_cast<vtkIdType>(numTuples) * numComps;
+    bool convert = (elementSize != array->GetDataTypeSize());
+    if (convert && dataType != VTK_ID_TYPE)
+      {
+      // only vtkIdType may differ in size between processes.
+      array->Delete();
+      this->Error = true;
+      return NULL;
+      }
+    if (rawSize != static_cast<vtkTypeInt64>(numValues) * elementSize)
+      {
+      array->Delete();
+      this->Error = true;
+      return NULL;
+      }
+
+    std::vector<char> uncompressed;
+    if (!codec.empty())
+      {
+      vtkDataCompressor* compressor = this->GetCompressor(codec);
+      uncompressed.resize(static_cast<size_t>(rawSize));
+      if (!compressor || rawSize == 0 ||
+        compressor->Uncompress(reinterpret_cast<unsigned char*>(values),
+          static_cast<size_t>(storedSize),
+          reinterpret_cast<unsigned char*>(&uncompressed[0]),
+          static_cast<size_t>(rawSize)) != static_cast<size_t>(rawSize))
+        {
+        vtkGenericWarningMacro("Failed to uncompress array using " << codec);
+        array->Delete();
+        this->Error = true;
+        return NULL;
+        }
+      values = &uncompressed[0];
+      }
+    if (this->Swap && numValues > 0)
+      {
+      vtkByteSwap::SwapVoidRange(values, numValues, elementSize);
+      }
+
+    if (numValues == 0)
+      {
+      array->SetNumberOfTuples(0);
+      }
+    else if (convert)
+      {
+      array->SetNumberOfTuples(static_cast<vtkIdType>(numTuples));
+      vtkIdType* ids = static_cast<vtkIdType*>(array->GetVoidPointer(0));
+      for (vtkIdType cc=0; cc < numValues; cc++)
+        {
+        if (elementSize == 8)
+          {
+          vtkTypeInt64 id;
+          memcpy(&id, values + 8*cc, 8);
+          ids[cc] = static_cast<vtkIdType>(id);
+          }
+        else
+          {
+          vtkTypeInt32 id;
+          memcpy(&id, values + 4*cc, 4);
+          ids[cc] = static_cast<vtkIdType>(id);
+          }
+        }
+      }
+    else if (this->Owner && codec.empty())
+      {
+      // zero-copy: point into the buffer and keep the owner alive for as
+      // long as the array exists.
+      array->SetVoidArray(values, numValues, 1);
+      this->Owner->Register(NULL);
+      vtkCallbackCommand* observer = vtkCallbackCommand::New();
+      observer->SetCallback(vtkReleaseBufferOwner);
+      observer->SetClientData(this->Owner);
+      array->AddObserver(vtkCommand::DeleteEvent, observer);
+      observer->Delete();
+      }
+    else
+      {
+      array->SetNumberOfTuples(static_cast<vtkIdType>(numTuples));
+      memcpy(array->GetVoidPointer(0), values, static_cast<size_t>(rawSize));
+      }
+    return array;
+    }
+
+  void ReadFieldData(vtkFieldData* fd)
+    {
+    vtkDataSetAttributes* dsa = vtkDataSetAttributes::SafeDownCast(fd);
+    int numArrays = this->ReadInt();
+    for (int cc=0; cc < numArrays && !this->Error; cc++)
+      {
+      int attribute = this->ReadInt();
+      vtkDataArray* array = this->ReadArray();
+      if (!array)
+        {
+        continue;
+        }
+      if (fd)
+        {
+        int index = fd->AddArray(array);
+        if (dsa && attribute >= 0)
+          {
+          dsa->SetActiveAttribute(index, attribute);
+          }
+        }
+      array->Delete();
+      }
+    }
+
+  vtkPoints* ReadPoints()
+    {
+    vtkDataArray* array = this->ReadArray();
+    if (!array)
+      {
+      return NULL;
+      }
+    vtkPoints* points = vtkPoints::New(array->GetDataType());
+    points->SetData(array);
+    array->Delete();
+    return points;
+    }
+
+  vtkCellArray* ReadCells()
+    {
+    vtkIdType numCells = static_cast<vtkIdType>(this->ReadInt64());
+    vtkDataArray* array = this->ReadArray();
+    vtkIdTypeArray* ids = vtkIdTypeArray::SafeDownCast(array);
+    if (!ids)
+      {
+      if (array)
+        {
+        array->Delete();
+        this->Error = true;
+        }
+      return NULL;
+      }
+    vtkCellArray* cells = vtkCellArray::New();
+    cells->SetCells(numCells, ids);
+    ids->Delete();
+    return cells;
+    }
+
+  vtkDataObject* ReadDataObject()
+    {
+    int type = this->ReadInt();
+    if (type == -1 || this->Error)
+      {
+      return NULL;
+      }
+    vtkDataObject* data = vtkDataObjectTypes::NewDataObject(type);
+    if (!data)
+      {
+      this->Error = true;
+      return NULL;
+      }
+    this->ReadFieldData(data->GetFieldData());
+
+    if (vtkCompositeDataSet* cd = vtkCompositeDataSet::SafeDownCast(data))
+      {
+      vtkMultiBlockDataSet* mb = vtkMultiBlockDataSet::SafeDownCast(cd);
+      vtkMultiPieceDataSet* mp = vtkMultiPieceDataSet::SafeDownCast(cd);
+      unsigned int num = static_cast<unsigned int>(this->ReadInt());
+      if (this->Error || (!mb && !mp))
+        {
+        this->Error = true;
+        data->Delete();
+        return NULL;
+        }
+      if (mb)
+        {
+        mb->SetNumberOfBlocks(num);
+        }
+      else
+        {
+        mp->SetNumberOfPieces(num);
+        }
+      for (unsigned int cc=0; cc < num && !this->Error; cc++)
+        {
+        std::string name;
+        bool hasName = this->ReadString(name);
+        vtkDataObject* child = this->ReadDataObject();
+        if (mb)
+          {
+          mb->SetBlock(cc, child);
+          }
+        else
+          {
+          mp->SetPiece(cc, child);
+          }
+        if (hasName)
+          {
+          vtkInformation* md = mb? mb->GetMetaData(cc) : mp->GetMetaData(cc);
+          md->Set(vtkCompositeDataSet::NAME(), name.c_str());
+          }
+        if (child)
+          {
+          child->Delete();
+          }
+        }
+      return data;
+      }
+
+    vtkDataSet* ds = vtkDataSet::SafeDownCast(data);
+    int extent[6];
+    if (vtkImageData* id = vtkImageData::SafeDownCast(data))
+      {
+      double origin[3], spacing[3];
+      this->ReadInts(extent, 6);
+      this->ReadDoubles(origin, 3);
+      this->ReadDoubles(spacing, 3);
+      id->SetExtent(extent);
+      id->SetOrigin(origin);
+      id->SetSpacing(spacing);
+      }
+    else if (vtkRectilinearGrid* rg = vtkRectilinearGrid::SafeDownCast(data))
+      {
+      this->ReadInts(extent, 6);
+      rg->SetExtent(extent);
+      vtkDataArray* coords[3];
+      for (int cc=0; cc < 3; cc++)
+        {
+        coords[cc] = this->ReadArray();
+        }
+      rg->SetXCoordinates(coords[0]);
+      rg->SetYCoordinates(coords[1]);
+      rg->SetZCoordinates(coords[2]);
+      for (int cc=0; cc < 3; cc++)
+        {
+        if (coords[cc])
+          {
+          coords[cc]->Delete();
+          }
+        }
+      }
+    else if (vtkStructuredGrid* sg = vtkStructuredGrid::SafeDownCast(data))
+      {
+      this->ReadInts(extent, 6);
+      sg->SetExtent(extent);
+      vtkPoints* points = this->ReadPoints();
+      sg->SetPoints(points);
+      if (points)
+        {
+        points->Delete();
+        }
+      }
+    else if (vtkPolyData* pd = vtkPolyData::SafeDownCast(data))
+      {
+      vtkPoints* points = this->ReadPoints();
+      pd->SetPoints(points);
+      if (points)
+        {
+        points->Delete();
+        }
+      vtkCellArray* cells[4];
+      for (int cc=0; cc < 4; cc++)
+        {
+        cells[cc] = this->ReadCells();
+        }
+      pd->SetVerts(cells[0]);
+      pd->SetLines(cells[1]);
+      pd->SetPolys(cells[2]);
+      pd->SetStrips(cells[3]);
+      for (int cc=0; cc < 4; cc++)
+        {
+        if (cells[cc])
+          {
+          cells[cc]->Delete();
+          }
+        }
+      }
+    else if (vtkUnstructuredGrid* ug = vtkUnstructuredGrid::SafeDownCast(data))
+      {
+      vtkPoints* points = this->ReadPoints();
+      ug->SetPoints(points);
+      if (points)
+        {
+        points->Delete();
+        }
+      vtkCellArray* cells = this->ReadCells();
+      vtkDataArray* types = this->ReadArray();
+      vtkDataArray* locations = this->ReadArray();
+      if (cells && vtkUnsignedCharArray::SafeDownCast(types) &&
+        vtkIdTypeArray::SafeDownCast(locations))
+        {
+        ug->SetCells(vtkUnsignedCharArray::SafeDownCast(types),
+          vtkIdTypeArray::SafeDownCast(locations), cells);
+        }
+      if (cells)
+        {
+        cells->Delete();
+        }
+      if (types)
+        {
+        types->Delete();
+        }
+      if (locations)
+        {
+        locations->Delete();
+        }
+      }
+    else
+      {
+      this->Error = true;
+      data->Delete();
+      return NULL;
+      }
+    this->ReadFieldData(ds->GetPointData());
+    this->ReadFieldData(ds->GetCellData());
+    return data;
+    }
+};
+
+vtkStandardNewMacro(vtkPVDataMarshaller);
+vtkCxxSetObjectMacro(vtkPVDataMarshaller, Compressor, vtkDataCompressor);
+//----------------------------------------------------------------------------
+vtkPVDataMarshaller::vtkPVDataMarshaller()
+{
+  this->Compressor = NULL;
+  this->CompressionThreshold = 4096;
+  this->Writer = NULL;
+}
+
+//----------------------------------------------------------------------------
+vtkPVDataMarshaller::~vtkPVDataMarshaller()
+{
+  this->SetCompressor(NULL);
+  delete this->Writer;
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVDataMarshaller::CanMarshal(vtkDataObject* data)
+{
+  if (!data)
+    {
+    return true;
+    }
+  if (!vtkCanMarshal(data->GetFieldData()))
+    {
+    return false;
+    }
+
+  switch (data->GetDataObjectType())
+    {
+  case VTK_MULTIBLOCK_DATA_SET:
+    {
+    vtkMultiBlockDataSet* mb = vtkMultiBlockDataSet::SafeDownCast(data);
+    for (unsigned int cc=0; cc < mb->GetNumberOfBlocks(); cc++)
+      {
+      if (!vtkPVDataMarshaller::CanMarshal(mb->GetBlock(cc)))
+        {
+        return false;
+        }
+      }
+    return true;
+    }
+
+  case VTK_MULTIPIECE_DATA_SET:
+    {
+    vtkMultiPieceDataSet* mp = vtkMultiPieceDataSet::SafeDownCast(data);
+    for (unsigned int cc=0; cc < mp->GetNumberOfPieces(); cc++)
+      {
+      if (!vtkPVDataMarshaller::CanMarshal(mp->GetPiece(cc)))
+        {
+        return false;
+        }
+      }
+    return true;
+    }
+
+  case VTK_IMAGE_DATA:
+  case VTK_STRUCTURED_POINTS:
+  case VTK_RECTILINEAR_GRID:
+  case VTK_STRUCTURED_GRID:
+  case VTK_POLY_DATA:
+  case VTK_UNSTRUCTURED_GRID:
+    {
+    vtkDataSet* ds = vtkDataSet::SafeDownCast(data);
+    return vtkCanMarshal(ds->GetPointData()) &&
+      vtkCanMarshal(ds->GetCellData());
+    }
+    }
+  return false;
+}
+
+//----------------------------------------------------------------------------
+char* vtkPVDataMarshaller::Marshal(vtkDataObject* data, vtkIdType& length)
+{
+  length = this->Prepare(data);
+  if (length < 0)
+    {
+    length = 0;
+    return NULL;
+    }
+  char* buffer = new char[length];
+  this->WriteBuffer(buffer);
+  return buffer;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkPVDataMarshaller::Prepare(vtkDataObject* data)
+{
+  delete this->Writer;
+  this->Writer = NULL;
+  if (!vtkPVDataMarshaller::CanMarshal(data))
+    {
+    return -1;
+    }
+
+  vtkTimerLog::MarkStartEvent("Marshal data (raw)");
+  vtkWriter* writer = new vtkWriter();
+  writer->Compressor = this->Compressor;
+  writer->CompressionThreshold = this->CompressionThreshold;
+  writer->Write(MAGIC, sizeof(MAGIC));
+  vtkTypeUInt32 header[2] = { BYTE_ORDER_MARK, sizeof(vtkIdType) };
+  writer->Write(header, sizeof(header));
+  // placeholder for the total length, filled in by Flatten().
+  writer->WriteInt64(0);
+  writer->WriteDataObject(data);
+  vtkTimerLog::MarkEndEvent("Marshal data (raw)");
+  this->Writer = writer;
+  return vtkAlign(writer->Length);
+}
+
+//----------------------------------------------------------------------------
+void vtkPVDataMarshaller::WriteBuffer(char* buffer)
+{
+  if (!this->Writer)
+    {
+    vtkErrorMacro("Prepare() must be called before WriteBuffer().");
+    return;
+    }
+  vtkTimerLog::MarkStartEvent("Copy marshalled data");
+  this->Writer->Flatten(buffer);
+  vtkTimerLog::MarkEndEvent("Copy marshalled data");
+  delete this->Writer;
+  this->Writer = NULL;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVDataMarshaller::WriteBufferCallback(char* buffer, vtkIdType,
+  void* clientData)
+{
+  static_cast<vtkPVDataMarshaller*>(clientData)->WriteBuffer(buffer);
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVDataMarshaller::IsMarshalledData(const char* buffer,
+  vtkIdType length)
+{
+  return buffer && length >= HEADER_SIZE &&
+    memcmp(buffer, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+//----------------------------------------------------------------------------
+vtkDataObject* vtkPVDataMarshaller::Unmarshal(char* buffer, vtkIdType length,
+  vtkObjectBase* owner)
+{
+  if (!vtkPVDataMarshaller::IsMarshalledData(buffer, length))
+    {
+    return NULL;
+    }
+
+  vtkReader reader;
+  reader.Buffer = buffer;
+  reader.Length = length;
+  reader.Position = sizeof(MAGIC);
+  reader.Owner = owner;
+  reader.Error = false;
+
+  vtkTypeUInt32 header[2];
+  reader.Read(header, sizeof(header));
+  if (header[0] == SWAPPED_BYTE_ORDER_MARK)
+    {
+    reader.Swap = true;
+    vtkByteSwap::SwapVoidRange(header, 2, sizeof(vtkTypeUInt32));
+    }
+  else if (header[0] == BYTE_ORDER_MARK)
+    {
+    reader.Swap = false;
+    }
+  else
+    {
+    vtkGenericWarningMacro("Invalid byte order mark.");
+    return NULL;
+    }
+  reader.IdTypeSize = static_cast<int>(header[1]);
+  vtkTypeInt64 totalLength = reader.ReadInt64();
+  if (totalLength > length)
+    {
+    vtkGenericWarningMacro("Truncated buffer.");
+    return NULL;
+    }
+  reader.Length = static_cast<vtkIdType>(totalLength);
+
+  vtkTimerLog::MarkStartEvent("Unmarshal data (raw)");
+  vtkDataObject* data = reader.ReadDataObject();
+  vtkTimerLog::MarkEndEvent("Unmarshal data (raw)");
+  if (reader.Error)
+    {
+    vtkGenericWarningMacro("Failed to unmarshal data.");
+    if (data)
+      {
+      data->Delete();
+      }
+    return NULL;
+    }
+  return data;
+}
+
+//----------------------------------------------------------------------------
+vtkObject* vtkPVDataMarshaller::NewBufferOwner(char* buffer)
+{
+  vtkPVDataMarshallerBufferOwner* owner = vtkPVDataMarshallerBufferOwner::New();
+  owner->Buffer = buffer;
+  return owner;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVDataMarshaller::SetConnectionCompressor(vtkObject* connection,
+  vtkDataCompressor* compressor)
+{
+  if (!connection)
+    {
+    return;
+    }
+  if (compressor)
+    {
+    ConnectionCompressors[connection] = std::pair<vtkWeakPointer<vtkObject>,
+      vtkSmartPointer<vtkDataCompressor> >(connection, compressor);
+    }
+  else
+    {
+    ConnectionCompressors.erase(connection);
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkDataCompressor* vtkPVDataMarshaller::GetConnectionCompressor(
+  vtkObject* connection)
+{
+  MapOfConnectionCompressors::iterator iter =
+    ConnectionCompressors.find(connection);
+  if (iter == ConnectionCompressors.end())
+    {
+    return NULL;
+    }
+  if (iter->second.first.GetPointer() == NULL)
+    {
+    // the connection was destroyed, this entry belongs to an old object
+    // that happened to have the same address.
+    ConnectionCompressors.erase(iter);
+    return NULL;
+    }
+  return iter->second.second;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVDataMarshaller::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Compressor: " << this->Compressor << endl;
+  os << indent << "CompressionThreshold: " << this->CompressionThreshold
+     << endl;
+}
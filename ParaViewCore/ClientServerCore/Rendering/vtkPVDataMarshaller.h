@@ -0,0 +1,141 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVDataMarshaller.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkPVDataMarshaller - binary wire format used to deliver data.
+// .SECTION Description
+// vtkPVDataMarshaller serializes data objects into the native binary format
+// used by the data delivery filters (vtkMPIMoveData,
+// vtkClientServerMoveData). Unlike the legacy file format, the buffer is a
+// small header describing the structure of the data object and its arrays,
+// followed by the raw array values, each aligned to 8 bytes. Nothing needs to
+// be parsed when reconstructing the data: arrays that are not compressed
+// simply point into the received buffer.
+//
+// Image data, rectilinear grids, structured grids, polydata, unstructured
+// grids and multiblock/multipiece trees of these are supported, along with
+// their point, cell and field data. Use CanMarshal() to check if a data
+// object can be marshalled. All others have to go through the legacy format.
+//
+// Each array can be compressed using a vtkDataCompressor (e.g.
+// vtkZLibDataCompressor). The compressor class name is recorded for each
+// array, so the receiver does not need to be configured. The compressor to
+// use for a particular connection can be registered using
+// SetConnectionCompressor().
+// .SECTION See Also
+// vtkMPIMoveData vtkClientServerMoveData vtkDataCompressor
+
+#ifndef __vtkPVDataMarshaller_h
+#define __vtkPVDataMarshaller_h
+
+#include "vtkPVClientServerCoreRenderingModule.h" //needed for exports
+#include "vtkObject.h"
+
+class vtkDataCompressor;
+class vtkDataObject;
+
+class VTKPVCLIENTSERVERCORERENDERING_EXPORT vtkPVDataMarshaller : public vtkObject
+{
+public:
+  static vtkPVDataMarshaller* New();
+  vtkTypeMacro(vtkPVDataMarshaller, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Get/Set the compressor used for array values. When NULL (default),
+  // arrays are not compressed.
+  void SetCompressor(vtkDataCompressor*);
+  vtkGetObjectMacro(Compressor, vtkDataCompressor);
+
+  // Description:
+  // Arrays smaller than this size (in bytes) are never compressed. Default is
+  // 4096.
+  vtkSetMacro(CompressionThreshold, vtkIdType);
+  vtkGetMacro(CompressionThreshold, vtkIdType);
+
+  // Description:
+  // Returns true if the data object can be represented in this format.
+  static bool CanMarshal(vtkDataObject* data);
+
+  // Description:
+  // Serializes the data object. Returns a buffer allocated with new[], which
+  // the caller must delete, or NULL if the data cannot be marshalled. The
+  // length is always a multiple of 8 so that buffers can be concatenated
+  // without breaking the alignment of the arrays.
+  char* Marshal(vtkDataObject* data, vtkIdType& length);
+
+  // Description:
+  // Same as Marshal(), in two steps, for callers that provide the buffer
+  // (e.g. a shared memory segment). Prepare() collects the structure and the
+  // arrays of the data object and returns the length of the buffer, or -1 if
+  // the data cannot be marshalled. WriteBuffer() then writes the header and
+  // copies the array values to the given buffer, which must hold that many
+  // bytes. The data object must not be modified in between.
+  vtkIdType Prepare(vtkDataObject* data);
+  void WriteBuffer(char* buffer);
+
+//BTX
+  // Description:
+  // Calls WriteBuffer() on the marshaller passed as clientData. Matches
+  // vtkPVSharedMemoryBuffer::WriteCallback, so that the data is marshalled
+  // directly in the buffer being sent.
+  static void WriteBufferCallback(char* buffer, vtkIdType length,
+    void* clientData);
+//ETX
+
+  // Description:
+  // Returns true if the buffer has been generated by Marshal().
+  static bool IsMarshalledData(const char* buffer, vtkIdType length);
+
+  // Description:
+  // Reconstructs a data object from a buffer generated by Marshal(). Returns
+  // a new data object or NULL on error. The buffer must be 8-byte aligned.
+  // When owner is non-NULL, arrays that are not compressed are not copied;
+  // they reference the values in the buffer and hold a reference to owner
+  // until they are destroyed. owner must keep the buffer alive.
+  static vtkDataObject* Unmarshal(char* buffer, vtkIdType length,
+    vtkObjectBase* owner);
+
+  // Description:
+  // Returns a new object that takes over a buffer allocated with new[] and
+  // deletes it when destroyed. It can be used as the owner in Unmarshal().
+  static vtkObject* NewBufferOwner(char* buffer);
+
+  // Description:
+  // Set the compressor to use when sending data over the given connection
+  // (typically a socket controller or communicator). Pass NULL to remove it.
+  static void SetConnectionCompressor(vtkObject* connection,
+    vtkDataCompressor* compressor);
+  static vtkDataCompressor* GetConnectionCompressor(vtkObject* connection);
+
+//BTX
+protected:
+  vtkPVDataMarshaller();
+  ~vtkPVDataMarshaller();
+
+  vtkDataCompressor* Compressor;
+  vtkIdType CompressionThreshold;
+
+private:
+  vtkPVDataMarshaller(const vtkPVDataMarshaller&); // Not implemented
+  void operator=(const vtkPVDataMarshaller&); // Not implemented
+
+  class vtkWriter;
+  class vtkReader;
+
+  // Writer set up by Prepare(), used by WriteBuffer().
+  vtkWriter* Writer;
+//ETX
+};
+
+#endif
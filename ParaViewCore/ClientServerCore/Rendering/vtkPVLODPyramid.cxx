@@ -0,0 +1,394 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVLODPyramid.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPVLODPyramid.h"
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkCompositeDataIterator.h"
+#include "vtkFieldData.h"
+#include "vtkIdTypeArray.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkMultiThreader.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkQuadricClustering.h"
+#include "vtkSmartPointer.h"
+#include "vtkTimerLog.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <vector>
+
+namespace
+{
+  // One block decimated at one resolution.
+  struct vtkLODWorkItem
+    {
+    vtkPolyData* Source;
+    vtkPolyData* Input; // a copy of Source made with vtkNewSharedCopy().
+    vtkPolyData* Output;
+    int Divisions;
+    vtkIdType Cost;
+
+    bool operator<(const vtkLODWorkItem& other) const
+      {
+      // more expensive items first, for better load balancing.
+      return this->Cost > other.Cost;
+      }
+    };
+
+  // Returns a new cell array sharing the connectivity of the given one. It
+  // has its own traversal location, so that blocks sharing cell arrays can
+  // be traversed by several threads.
+  vtkCellArray* vtkShareCells(vtkCellArray* cells)
+    {
+    vtkCellArray* copy = vtkCellArray::New();
+    if (cells && cells->GetData())
+      {
+      copy->SetCells(cells->GetNumberOfCells(), cells->GetData());
+      }
+    return copy;
+    }
+
+  // Returns a new polydata sharing the points, arrays and connectivity of
+  // the given one, but nothing that is modified while traversing it. It is
+  // created before the blocks are decimated by several threads, since
+  // registering the shared objects is not thread safe either.
+  vtkPolyData* vtkNewSharedCopy(vtkPolyData* input)
+    {
+    vtkPolyData* copy = vtkPolyData::New();
+    copy->SetPoints(input->GetPoints());
+    copy->GetPointData()->ShallowCopy(input->GetPointData());
+    copy->GetCellData()->ShallowCopy(input->GetCellData());
+    vtkCellArray* cells[4] = {
+      vtkShareCells(input->GetVerts()), vtkShareCells(input->GetLines()),
+      vtkShareCells(input->GetPolys()), vtkShareCells(input->GetStrips()) };
+    copy->SetVerts(cells[0]);
+    copy->SetLines(cells[1]);
+    copy->SetPolys(cells[2]);
+    copy->SetStrips(cells[3]);
+    for (int cc=0; cc < 4; cc++)
+      {
+      cells[cc]->Delete();
+      }
+    return copy;
+    }
+
+  // Decimates with vtkQuadricClustering, configured as
+  // vtkGeometryRepresentation always did.
+  void vtkClusterPolyData(const vtkLODWorkItem& item)
+    {
+    vtkNew<vtkQuadricClustering> decimator;
+    decimator->SetUseInputPoints(1);
+    decimator->SetCopyCellData(1);
+    decimator->SetUseInternalTriangles(0);
+    decimator->SetNumberOfDivisions(
+      item.Divisions, item.Divisions, item.Divisions);
+    decimator->SetInputData(item.Input);
+    decimator->Update();
+    item.Output->ShallowCopy(decimator->GetOutput());
+    }
+
+  struct vtkLODWork
+    {
+    std::vector<vtkLODWorkItem> Items;
+    };
+
+  VTK_THREAD_RETURN_TYPE vtkLODPyramidThread(void* arg)
+    {
+    vtkMultiThreader::ThreadInfo* threadInfo =
+      static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+    vtkLODWork* work = static_cast<vtkLODWork*>(threadInfo->UserData);
+    size_t count = work->Items.size();
+    for (size_t cc = threadInfo->ThreadID; cc < count;
+      cc += threadInfo->NumberOfThreads)
+      {
+      vtkClusterPolyData(work->Items[cc]);
+      }
+    return VTK_THREAD_RETURN_VALUE;
+    }
+}
+
+//****************************************************************************
+class vtkPVLODPyramid::vtkInternals
+{
+public:
+  typedef std::vector<vtkSmartPointer<vtkMultiBlockDataSet> > VectorOfLevels;
+
+  struct Pyramid
+    {
+    VectorOfLevels Levels;
+
+    // Resolutions requested that are not one of the levels, by number of
+    // divisions.
+    std::map<int, vtkSmartPointer<vtkMultiBlockDataSet> > Others;
+    };
+
+  // Pyramids for cache times, when caching is enabled.
+  std::map<double, Pyramid> Cache;
+
+  // Pyramid for the current input, when caching is disabled.
+  Pyramid Current;
+  unsigned long CurrentInputMTime;
+
+  vtkInternals() : CurrentInputMTime(0) { }
+};
+
+vtkStandardNewMacro(vtkPVLODPyramid);
+//----------------------------------------------------------------------------
+vtkPVLODPyramid::vtkPVLODPyramid()
+{
+  this->NumberOfLevels = 5;
+  this->MaximumNumberOfDivisions = 160;
+  this->Level = 0;
+  this->NumberOfDivisions = 0;
+  this->CacheTime = 0.0;
+  this->CachingEnabled = true;
+  this->Internals = new vtkInternals();
+}
+
+//----------------------------------------------------------------------------
+vtkPVLODPyramid::~vtkPVLODPyramid()
+{
+  delete this->Internals;
+  this->Internals = NULL;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVLODPyramid::SetNumberOfLevels(int levels)
+{
+  levels = levels < 1? 1 : levels;
+  if (this->NumberOfLevels != levels)
+    {
+    this->NumberOfLevels = levels;
+    this->RemoveAllCaches();
+    this->Modified();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkPVLODPyramid::SetMaximumNumberOfDivisions(int divisions)
+{
+  divisions = divisions < 2? 2 : divisions;
+  if (this->MaximumNumberOfDivisions != divisions)
+    {
+    this->MaximumNumberOfDivisions = divisions;
+    this->RemoveAllCaches();
+    this->Modified();
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkPVLODPyramid::GetNumberOfDivisions(int level)
+{
+  int divisions = this->MaximumNumberOfDivisions;
+  for (int cc=0; cc < level && divisions > 2; cc++)
+    {
+    divisions /= 2;
+    }
+  return divisions < 2? 2 : divisions;
+}
+
+//----------------------------------------------------------------------------
+int vtkPVLODPyramid::GetLevelForNumberOfDivisions(int divisions)
+{
+  int best = 0;
+  double bestDistance = VTK_DOUBLE_MAX;
+  for (int level=0; level < this->NumberOfLevels; level++)
+    {
+    // levels are spaced logarithmically.
+    double distance = fabs(log(static_cast<double>(
+          this->GetNumberOfDivisions(level))) -
+      log(static_cast<double>(divisions > 1? divisions : 1)));
+    if (distance < bestDistance)
+      {
+      bestDistance = distance;
+      best = level;
+      }
+    }
+  return best;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVLODPyramid::RemoveAllCaches()
+{
+  this->Internals->Cache.clear();
+  this->Internals->Current = vtkInternals::Pyramid();
+  this->Internals->CurrentInputMTime = 0;
+
+  // this method should never mark the filter modified !!!
+}
+
+//----------------------------------------------------------------------------
+int vtkPVLODPyramid::RequestData(vtkInformation*,
+  vtkInformationVector** inputVector, vtkInformationVector* outputVector)
+{
+  vtkMultiBlockDataSet* input = vtkMultiBlockDataSet::GetData(inputVector[0], 0);
+  vtkMultiBlockDataSet* output = vtkMultiBlockDataSet::GetData(outputVector, 0);
+
+  vtkInternals::Pyramid* pyramid = NULL;
+  if (this->CachingEnabled)
+    {
+    pyramid = &this->Internals->Cache[this->CacheTime];
+    }
+  else
+    {
+    this->Internals->Cache.clear();
+    pyramid = &this->Internals->Current;
+    if (this->Internals->CurrentInputMTime != input->GetMTime())
+      {
+      *pyramid = vtkInternals::Pyramid();
+      this->Internals->CurrentInputMTime = input->GetMTime();
+      }
+    }
+
+  vtkInternals::VectorOfLevels& levels = pyramid->Levels;
+  levels.resize(this->NumberOfLevels);
+  int level = this->Level < this->NumberOfLevels?
+    this->Level : this->NumberOfLevels - 1;
+  if (this->NumberOfDivisions > 0)
+    {
+    level = this->GetLevelForNumberOfDivisions(this->NumberOfDivisions);
+    if (this->GetNumberOfDivisions(level) != this->NumberOfDivisions)
+      {
+      level = -1;
+      }
+    }
+
+  vtkMultiBlockDataSet* result = NULL;
+  if (level >= 0)
+    {
+    if (!levels[level])
+      {
+      levels[level].TakeReference(
+        this->BuildLevel(input, this->GetNumberOfDivisions(level)));
+      }
+    result = levels[level];
+    }
+  else
+    {
+    vtkSmartPointer<vtkMultiBlockDataSet>& other =
+      pyramid->Others[this->NumberOfDivisions];
+    if (!other)
+      {
+      other.TakeReference(this->BuildLevel(input, this->NumberOfDivisions));
+      }
+    result = other;
+    }
+  output->ShallowCopy(result);
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+vtkMultiBlockDataSet* vtkPVLODPyramid::BuildLevel(
+  vtkMultiBlockDataSet* input, int divisions)
+{
+  vtkTimerLog::MarkStartEvent("Build LOD level");
+
+  // Create the output structure, then decimate the blocks in parallel, one
+  // block per thread.
+  vtkMultiBlockDataSet* mb = vtkMultiBlockDataSet::New();
+  mb->CopyStructure(input);
+  vtkLODWork work;
+  vtkCompositeDataIterator* iter = input->NewIterator();
+  for (iter->InitTraversal(); !iter->IsDoneWithTraversal();
+    iter->GoToNextItem())
+    {
+    vtkPolyData* leaf = vtkPolyData::SafeDownCast(iter->GetCurrentDataObject());
+    vtkNew<vtkPolyData> pd;
+    mb->SetDataSet(iter, pd.GetPointer());
+    if (leaf && leaf->GetNumberOfPoints() > 0)
+      {
+      // GetBounds() caches the bounds in the points, which may be shared
+      // between blocks, so it is called here rather than by the threads.
+      double bounds[6];
+      leaf->GetBounds(bounds);
+      vtkLODWorkItem item;
+      item.Source = leaf;
+      item.Input = vtkNewSharedCopy(leaf);
+      item.Output = pd.GetPointer();
+      item.Divisions = divisions;
+      item.Cost = leaf->GetNumberOfPoints() + leaf->GetNumberOfCells();
+      work.Items.push_back(item);
+      }
+    }
+  iter->Delete();
+
+  std::stable_sort(work.Items.begin(), work.Items.end());
+  int numberOfThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  int maxThreads = static_cast<int>(work.Items.size());
+  numberOfThreads = numberOfThreads < maxThreads? numberOfThreads : maxThreads;
+  if (numberOfThreads > 1)
+    {
+    vtkNew<vtkMultiThreader> threader;
+    threader->SetNumberOfThreads(numberOfThreads);
+    threader->SetSingleMethod(vtkLODPyramidThread, &work);
+    threader->SingleMethodExecute();
+    }
+  else
+    {
+    for (size_t cc=0; cc < work.Items.size(); cc++)
+      {
+      vtkClusterPolyData(work.Items[cc]);
+      }
+    }
+
+  // The field data, such as the block paths of streamed pieces, is not
+  // passed by the decimation.
+  for (size_t cc=0; cc < work.Items.size(); cc++)
+    {
+    vtkLODWorkItem& item = work.Items[cc];
+    item.Output->GetFieldData()->ShallowCopy(item.Source->GetFieldData());
+    item.Input->Delete();
+    }
+  vtkTimerLog::MarkEndEvent("Build LOD level");
+  return mb;
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVLODPyramid::HasLevel(int level)
+{
+  vtkInternals::Pyramid* pyramid = &this->Internals->Current;
+  if (this->CachingEnabled)
+    {
+    std::map<double, vtkInternals::Pyramid>::iterator iter =
+      this->Internals->Cache.find(this->CacheTime);
+    if (iter == this->Internals->Cache.end())
+      {
+      return false;
+      }
+    pyramid = &iter->second;
+    }
+  return level >= 0 && level < static_cast<int>(pyramid->Levels.size()) &&
+    pyramid->Levels[level] != NULL;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVLODPyramid::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "NumberOfLevels: " << this->NumberOfLevels << endl;
+  os << indent << "MaximumNumberOfDivisions: "
+     << this->MaximumNumberOfDivisions << endl;
+  os << indent << "Level: " << this->Level << endl;
+  os << indent << "NumberOfDivisions: " << this->NumberOfDivisions << endl;
+  os << indent << "CacheTime: " << this->CacheTime << endl;
+  os << indent << "CachingEnabled: " << this->CachingEnabled << endl;
+}
@@ -0,0 +1,136 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVLODPyramid.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkPVLODPyramid - multi-resolution decimation used for LOD rendering.
+// .SECTION Description
+// vtkPVLODPyramid decimates the polydata blocks of a vtkMultiBlockDataSet at
+// several resolutions using vtkQuadricClustering (with UseInputPoints and
+// CopyCellData on). Level 0 uses MaximumNumberOfDivisions along each axis,
+// each following level halves the number of divisions. A level is built the
+// first time it is requested after the input changes. It is then kept, so
+// that going back to a level simply picks the already generated one. When
+// NumberOfDivisions is set to a resolution that is not one of the levels,
+// exactly that resolution is built, and kept like the levels.
+//
+// The blocks are decimated on multiple threads, one block per thread: a
+// dataset made of a single block is decimated on one thread, since
+// vtkQuadricClustering itself is serial.
+//
+// Like vtkPVCacheKeeper, the pyramids can be cached for several cache times
+// (flip-book animations): when CachingEnabled is true, the pyramid built for
+// CacheTime is kept until RemoveAllCaches() is called. When caching is
+// disabled, only the pyramid for the current input is kept.
+// .SECTION See Also
+// vtkGeometryRepresentation vtkPVCacheKeeper vtkQuadricClustering
+
+#ifndef __vtkPVLODPyramid_h
+#define __vtkPVLODPyramid_h
+
+#include "vtkPVClientServerCoreRenderingModule.h" //needed for exports
+#include "vtkMultiBlockDataSetAlgorithm.h"
+
+class vtkMultiBlockDataSet;
+
+class VTKPVCLIENTSERVERCORERENDERING_EXPORT vtkPVLODPyramid :
+  public vtkMultiBlockDataSetAlgorithm
+{
+public:
+  static vtkPVLODPyramid* New();
+  vtkTypeMacro(vtkPVLODPyramid, vtkMultiBlockDataSetAlgorithm);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Get/Set the number of levels in the pyramid. Default is 5. Changing this
+  // discards all generated levels.
+  void SetNumberOfLevels(int);
+  vtkGetMacro(NumberOfLevels, int);
+
+  // Description:
+  // Get/Set the number of divisions along each axis used for level 0.
+  // Default is 160. Changing this discards all generated levels.
+  void SetMaximumNumberOfDivisions(int);
+  vtkGetMacro(MaximumNumberOfDivisions, int);
+
+  // Description:
+  // Get/Set the level to produce. 0 is the finest level. Ignored when
+  // NumberOfDivisions is set.
+  vtkSetClampMacro(Level, int, 0, VTK_INT_MAX);
+  vtkGetMacro(Level, int);
+
+  // Description:
+  // Get/Set the number of divisions along each axis to produce. When it is
+  // the number of divisions of a level, that level is used, otherwise the
+  // blocks are decimated with exactly this number of divisions. 0 means the
+  // number of divisions of Level is used. Default is 0.
+  vtkSetClampMacro(NumberOfDivisions, int, 0, VTK_INT_MAX);
+  vtkGetMacro(NumberOfDivisions, int);
+
+  // Description:
+  // Returns the number of divisions used for the given level.
+  int GetNumberOfDivisions(int level);
+
+  // Description:
+  // Returns the level whose number of divisions is closest to the one given.
+  int GetLevelForNumberOfDivisions(int divisions);
+
+  // Description:
+  // Get/Set the current cache time.
+  vtkSetMacro(CacheTime, double);
+  vtkGetMacro(CacheTime, double);
+
+  // Description:
+  // Get/Set if caching is enabled. Default is true.
+  vtkSetMacro(CachingEnabled, bool);
+  vtkGetMacro(CachingEnabled, bool);
+  vtkBooleanMacro(CachingEnabled, bool);
+
+  // Description:
+  // Discards all generated pyramids. Does not mark the filter modified.
+  void RemoveAllCaches();
+
+  // Description:
+  // Returns true if the given level has been generated for the current cache
+  // time (or the last input, when caching is disabled).
+  bool HasLevel(int level);
+
+//BTX
+protected:
+  vtkPVLODPyramid();
+  ~vtkPVLODPyramid();
+
+  virtual int RequestData(vtkInformation* request,
+    vtkInformationVector** inputVector, vtkInformationVector* outputVector);
+
+  // Description:
+  // Decimates all the blocks of the input with the given number of divisions.
+  vtkMultiBlockDataSet* BuildLevel(vtkMultiBlockDataSet* input,
+    int divisions);
+
+  int NumberOfLevels;
+  int MaximumNumberOfDivisions;
+  int Level;
+  int NumberOfDivisions;
+  double CacheTime;
+  bool CachingEnabled;
+
+private:
+  vtkPVLODPyramid(const vtkPVLODPyramid&); // Not implemented
+  void operator=(const vtkPVLODPyramid&); // Not implemented
+
+  class vtkInternals;
+  vtkInternals* Internals;
+//ETX
+};
+
+#endif
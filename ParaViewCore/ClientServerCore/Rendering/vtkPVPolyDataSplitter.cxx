@@ -0,0 +1,355 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVPolyDataSplitter.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPVPolyDataSplitter.h"
+
+#include "vtkBoundingBox.h"
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkDataObjectTree.h"
+#include "vtkDataObjectTreeIterator.h"
+#include "vtkFieldData.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkTimerLog.h"
+#include "vtkUnsignedIntArray.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace
+{
+  // Provides random access to the cells of a vtkPolyData without building
+  // the cell links. Cell ids are numbered verts, lines, polys and then strips,
+  // as in vtkPolyData.
+  class vtkCellLocations
+  {
+  public:
+    vtkCellLocations(vtkPolyData* pd)
+      {
+      vtkCellArray* arrays[4] =
+        { pd->GetVerts(), pd->GetLines(), pd->GetPolys(), pd->GetStrips() };
+      this->FirstCell[0] = 0;
+      for (int cc=0; cc < 4; cc++)
+        {
+        this->Data[cc] = arrays[cc]->GetPointer();
+        this->FirstCell[cc+1] =
+          this->FirstCell[cc] + arrays[cc]->GetNumberOfCells();
+        }
+
+      this->Offsets.resize(this->FirstCell[4]);
+      for (int cc=0; cc < 4; cc++)
+        {
+        vtkIdType loc = 0;
+        for (vtkIdType cellId = this->FirstCell[cc];
+          cellId < this->FirstCell[cc+1]; cellId++)
+          {
+          this->Offsets[cellId] = loc;
+          loc += this->Data[cc][loc] + 1;
+          }
+        }
+      }
+
+    vtkIdType GetNumberOfCells() const
+      { return this->FirstCell[4]; }
+
+    int GetCellType(vtkIdType cellId) const
+      {
+      int type = 0;
+      while (cellId >= this->FirstCell[type+1])
+        {
+        type++;
+        }
+      return type;
+      }
+
+    // Returns the cell as (npts, id0, id1, ...).
+    const vtkIdType* GetCell(vtkIdType cellId, int type) const
+      { return this->Data[type] + this->Offsets[cellId]; }
+
+  private:
+    const vtkIdType* Data[4];
+    vtkIdType FirstCell[5];
+    std::vector<vtkIdType> Offsets;
+  };
+
+  class vtkCenterLess
+  {
+  public:
+    const double* Centers;
+    int Axis;
+    bool operator()(vtkIdType a, vtkIdType b) const
+      {
+      return this->Centers[3*a + this->Axis] < this->Centers[3*b + this->Axis];
+      }
+  };
+
+  typedef std::vector<std::pair<size_t, size_t> > VectorOfRanges;
+
+  // Recursively bisects ids[begin, end) at the median of the cell centers
+  // along the longest axis until each range has at most maxCells cells.
+  void vtkPartition(std::vector<vtkIdType>& ids, size_t begin, size_t end,
+    const double* centers, size_t maxCells, VectorOfRanges& ranges)
+    {
+    if (end - begin <= maxCells)
+      {
+      ranges.push_back(std::pair<size_t, size_t>(begin, end));
+      return;
+      }
+
+    vtkBoundingBox bbox;
+    for (size_t cc=begin; cc < end; cc++)
+      {
+      bbox.AddPoint(const_cast<double*>(centers + 3*ids[cc]));
+      }
+    double lengths[3];
+    bbox.GetLengths(lengths);
+
+    vtkCenterLess less;
+    less.Centers = centers;
+    less.Axis = 0;
+    for (int cc=1; cc < 3; cc++)
+      {
+      if (lengths[cc] > lengths[less.Axis])
+        {
+        less.Axis = cc;
+        }
+      }
+
+    size_t middle = begin + (end - begin) / 2;
+    std::nth_element(ids.begin() + begin, ids.begin() + middle,
+      ids.begin() + end, less);
+    vtkPartition(ids, begin, middle, centers, maxCells, ranges);
+    vtkPartition(ids, middle, end, centers, maxCells, ranges);
+    }
+
+  // Creates a new polydata with the given cells (sorted by id) of the input.
+  // pointMap must have an entry set to -1 for every input point; it is
+  // restored before returning.
+  vtkPolyData* vtkExtractCells(vtkPolyData* input,
+    const vtkCellLocations& locations, const vtkIdType* ids, vtkIdType numIds,
+    std::vector<vtkIdType>& pointMap)
+    {
+    vtkPolyData* output = vtkPolyData::New();
+    vtkPointData* inPD = input->GetPointData();
+    vtkCellData* inCD = input->GetCellData();
+    vtkPointData* outPD = output->GetPointData();
+    vtkCellData* outCD = output->GetCellData();
+    outCD->CopyAllocate(inCD, numIds);
+
+    vtkSmartPointer<vtkCellArray> cells[4];
+    std::vector<vtkIdType> usedPoints;
+    std::vector<vtkIdType> cellPoints;
+    for (vtkIdType cc=0; cc < numIds; cc++)
+      {
+      vtkIdType cellId = ids[cc];
+      int type = locations.GetCellType(cellId);
+      const vtkIdType* cell = locations.GetCell(cellId, type);
+      vtkIdType npts = cell[0];
+      cellPoints.resize(npts + 1);
+      for (vtkIdType kk=0; kk < npts; kk++)
+        {
+        vtkIdType ptId = cell[kk+1];
+        if (pointMap[ptId] < 0)
+          {
+          pointMap[ptId] = static_cast<vtkIdType>(usedPoints.size());
+          usedPoints.push_back(ptId);
+          }
+        cellPoints[kk] = pointMap[ptId];
+        }
+      if (!cells[type])
+        {
+        cells[type] = vtkSmartPointer<vtkCellArray>::New();
+        }
+      cells[type]->InsertNextCell(npts, &cellPoints[0]);
+      // ids are sorted, hence cells are added in the same order as in the
+      // input: verts, lines, polys and strips.
+      outCD->CopyData(inCD, cellId, cc);
+      }
+
+    vtkPoints* inPoints = input->GetPoints();
+    vtkPoints* outPoints = vtkPoints::New(inPoints->GetDataType());
+    vtkIdType numPoints = static_cast<vtkIdType>(usedPoints.size());
+    outPoints->SetNumberOfPoints(numPoints);
+    outPD->CopyAllocate(inPD, numPoints);
+    for (vtkIdType cc=0; cc < numPoints; cc++)
+      {
+      vtkIdType ptId = usedPoints[cc];
+      outPoints->SetPoint(cc, inPoints->GetPoint(ptId));
+      outPD->CopyData(inPD, ptId, cc);
+      pointMap[ptId] = -1;
+      }
+    output->SetPoints(outPoints);
+    outPoints->Delete();
+
+    if (cells[0]) { output->SetVerts(cells[0]); }
+    if (cells[1]) { output->SetLines(cells[1]); }
+    if (cells[2]) { output->SetPolys(cells[2]); }
+    if (cells[3]) { output->SetStrips(cells[3]); }
+    output->GetFieldData()->ShallowCopy(input->GetFieldData());
+    return output;
+    }
+}
+
+vtkStandardNewMacro(vtkPVPolyDataSplitter);
+//----------------------------------------------------------------------------
+vtkPVPolyDataSplitter::vtkPVPolyDataSplitter()
+{
+  this->MaximumNumberOfCells = 250000;
+}
+
+//----------------------------------------------------------------------------
+vtkPVPolyDataSplitter::~vtkPVPolyDataSplitter()
+{
+}
+
+//----------------------------------------------------------------------------
+int vtkPVPolyDataSplitter::RequestData(vtkInformation*,
+  vtkInformationVector** inputVector, vtkInformationVector* outputVector)
+{
+  vtkMultiBlockDataSet* input = vtkMultiBlockDataSet::GetData(inputVector[0], 0);
+  vtkMultiBlockDataSet* output = vtkMultiBlockDataSet::GetData(outputVector, 0);
+
+  vtkTimerLog::MarkStartEvent("Split polydata");
+  unsigned int flatIndex = 0;
+  std::vector<unsigned int> path;
+  this->SplitBlock(input, flatIndex, path, output);
+  vtkTimerLog::MarkEndEvent("Split polydata");
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVPolyDataSplitter::SplitBlock(vtkDataObject* block,
+  unsigned int& flatIndex, std::vector<unsigned int>& path,
+  vtkMultiBlockDataSet* output)
+{
+  // Flat indices are numbered in preorder, empty nodes included, as done by
+  // vtkDataObjectTreeIterator.
+  path.push_back(flatIndex++);
+  if (vtkDataObjectTree* tree = vtkDataObjectTree::SafeDownCast(block))
+    {
+    vtkSmartPointer<vtkDataObjectTreeIterator> iter;
+    iter.TakeReference(tree->NewTreeIterator());
+    iter->VisitOnlyLeavesOff();
+    iter->TraverseSubTreeOff();
+    iter->SkipEmptyNodesOff();
+    for (iter->InitTraversal(); !iter->IsDoneWithTraversal();
+      iter->GoToNextItem())
+      {
+      this->SplitBlock(iter->GetCurrentDataObject(), flatIndex, path, output);
+      }
+    }
+  else if (vtkPolyData* pd = vtkPolyData::SafeDownCast(block))
+    {
+    this->SplitPolyData(pd, path, output);
+    }
+  path.pop_back();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVPolyDataSplitter::SplitPolyData(vtkPolyData* pd,
+  const std::vector<unsigned int>& path, vtkMultiBlockDataSet* output)
+{
+  if (pd->GetNumberOfCells() == 0)
+    {
+    return;
+    }
+
+  // The block path, from the block to the root.
+  vtkNew<vtkUnsignedIntArray> blockPath;
+  blockPath->SetName("vtkBlockPath");
+  for (size_t cc=path.size(); cc > 0; cc--)
+    {
+    blockPath->InsertNextValue(path[cc-1]);
+    }
+
+  if (pd->GetNumberOfCells() <= this->MaximumNumberOfCells)
+    {
+    // Pass the block through, with its own field data for the block path.
+    vtkNew<vtkPolyData> piece;
+    piece->ShallowCopy(pd);
+    vtkNew<vtkFieldData> fd;
+    fd->ShallowCopy(pd->GetFieldData());
+    fd->AddArray(blockPath.GetPointer());
+    piece->SetFieldData(fd.GetPointer());
+    output->SetBlock(output->GetNumberOfBlocks(), piece.GetPointer());
+    return;
+    }
+
+  vtkCellLocations locations(pd);
+  vtkIdType numCells = locations.GetNumberOfCells();
+  vtkPoints* points = pd->GetPoints();
+
+  // Compute the cell centers.
+  std::vector<double> centers(3*numCells, 0.0);
+  for (vtkIdType cellId=0; cellId < numCells; cellId++)
+    {
+    const vtkIdType* cell = locations.GetCell(cellId,
+      locations.GetCellType(cellId));
+    double* center = &centers[3*cellId];
+    for (vtkIdType kk=0; kk < cell[0]; kk++)
+      {
+      double x[3];
+      points->GetPoint(cell[kk+1], x);
+      center[0] += x[0];
+      center[1] += x[1];
+      center[2] += x[2];
+      }
+    if (cell[0] > 0)
+      {
+      center[0] /= cell[0];
+      center[1] /= cell[0];
+      center[2] /= cell[0];
+      }
+    }
+
+  std::vector<vtkIdType> ids(numCells);
+  for (vtkIdType cellId=0; cellId < numCells; cellId++)
+    {
+    ids[cellId] = cellId;
+    }
+  VectorOfRanges ranges;
+  vtkPartition(ids, 0, ids.size(), &centers[0],
+    static_cast<size_t>(this->MaximumNumberOfCells), ranges);
+  std::vector<double>().swap(centers);
+
+  std::vector<vtkIdType> pointMap(pd->GetNumberOfPoints(), -1);
+  for (VectorOfRanges::iterator range = ranges.begin();
+    range != ranges.end(); ++range)
+    {
+    std::sort(ids.begin() + range->first, ids.begin() + range->second);
+    vtkPolyData* piece = vtkExtractCells(pd, locations,
+      &ids[range->first],
+      static_cast<vtkIdType>(range->second - range->first), pointMap);
+    piece->GetFieldData()->AddArray(blockPath.GetPointer());
+    output->SetBlock(output->GetNumberOfBlocks(), piece);
+    piece->Delete();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkPVPolyDataSplitter::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "MaximumNumberOfCells: " << this->MaximumNumberOfCells
+     << endl;
+}
@@ -0,0 +1,85 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVPolyDataSplitter.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkPVPolyDataSplitter - splits polydata into spatially coherent
+// pieces.
+// .SECTION Description
+// vtkPVPolyDataSplitter splits each polydata block of the input
+// vtkMultiBlockDataSet into pieces of at most MaximumNumberOfCells cells. The
+// cells are partitioned by recursively bisecting them at the median of their
+// centers along the longest axis (like a k-d tree), so each piece covers a
+// compact region of space. The output is a flat vtkMultiBlockDataSet with one
+// block per piece. Blocks that are small enough are passed through as is.
+//
+// Each piece only has the points used by its cells. Point and cell data is
+// copied; field data is shared with the input block. Each piece also gets a
+// "vtkBlockPath" field data array with the flat indices of the input block it
+// comes from and of all its ancestors, from the block up to the root. This
+// lets block properties, which are set using the flat indices of the input,
+// be applied to the pieces.
+//
+// This is used by vtkGeometryRepresentation to stream large surfaces.
+// .SECTION See Also
+// vtkGeometryRepresentation vtkStreamingPriorityQueue
+
+#ifndef __vtkPVPolyDataSplitter_h
+#define __vtkPVPolyDataSplitter_h
+
+#include "vtkPVClientServerCoreRenderingModule.h" //needed for exports
+#include "vtkMultiBlockDataSetAlgorithm.h"
+
+//BTX
+#include <vector> // needed for std::vector
+//ETX
+
+class vtkPolyData;
+
+class VTKPVCLIENTSERVERCORERENDERING_EXPORT vtkPVPolyDataSplitter :
+  public vtkMultiBlockDataSetAlgorithm
+{
+public:
+  static vtkPVPolyDataSplitter* New();
+  vtkTypeMacro(vtkPVPolyDataSplitter, vtkMultiBlockDataSetAlgorithm);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Get/Set the maximum number of cells in a piece. Default is 250000.
+  vtkSetClampMacro(MaximumNumberOfCells, vtkIdType, 1, VTK_ID_MAX);
+  vtkGetMacro(MaximumNumberOfCells, vtkIdType);
+
+//BTX
+protected:
+  vtkPVPolyDataSplitter();
+  ~vtkPVPolyDataSplitter();
+
+  virtual int RequestData(vtkInformation* request,
+    vtkInformationVector** inputVector, vtkInformationVector* outputVector);
+
+  // Description:
+  // Splits the polydata leaves of the block. flatIndex is the flat index of
+  // the block and path the flat indices of its ancestors.
+  void SplitBlock(vtkDataObject* block, unsigned int& flatIndex,
+    std::vector<unsigned int>& path, vtkMultiBlockDataSet* output);
+  void SplitPolyData(vtkPolyData* pd, const std::vector<unsigned int>& path,
+    vtkMultiBlockDataSet* output);
+
+  vtkIdType MaximumNumberOfCells;
+
+private:
+  vtkPVPolyDataSplitter(const vtkPVPolyDataSplitter&); // Not implemented
+  void operator=(const vtkPVPolyDataSplitter&); // Not implemented
+//ETX
+};
+
+#endif
@@ -163,6 +163,9 @@ vtkPVRenderView::vtkPVRenderView()
   this->LODRenderingThreshold = 0;
   this->LODResolution = 0.5;
   this->UseOutlineForLODRendering = false;
+  this->UseAdaptiveLODResolution = false;
+  this->LODLevelOffset = 0;
+  this->SuggestedLODLevelOffset = 0;
   this->UseLightKit = false;
   this->Interactor = 0;
   this->InteractorStyle = 0;
@@ -924,6 +927,20 @@ void vtkPVRenderView::Update()
 
   // Update decisions about lod-rendering and remote-rendering.
   this->UseLODForInteractiveRender = this->ShouldUseLODRendering(local_size);
+
+  // Pick the starting LOD level: one level coarser for every factor of 4 the
+  // geometry size exceeds 16 times the LOD threshold. The frame time measured
+  // during interactive renders refines it.
+  this->SuggestedLODLevelOffset = 0;
+  if (this->UseAdaptiveLODResolution && this->LODRenderingThreshold > 0)
+    {
+    double ratio = local_size / this->LODRenderingThreshold;
+    while (ratio >= 16 && this->SuggestedLODLevelOffset < 4)
+      {
+      ratio /= 4;
+      this->SuggestedLODLevelOffset++;
+      }
+    }
   this->UseDistributedRenderingForStillRender = this->ShouldUseDistributedRendering(local_size);
   if (!this->UseLODForInteractiveRender)
     {
@@ -972,7 +989,16 @@ void vtkPVRenderView::UpdateLOD()
 
   // Update LOD geometry.
 
-  this->RequestInformation->Set(LOD_RESOLUTION(), this->LODResolution);
+  // Each level offset halves the number of divisions the resolution maps to
+  // (see vtkGeometryRepresentation).
+  double divisions = 150 * this->LODResolution + 10;
+  for (int cc=0; cc < this->LODLevelOffset; cc++)
+    {
+    divisions /= 2;
+    }
+  double resolution = (divisions - 10) / 150;
+  this->RequestInformation->Set(LOD_RESOLUTION(),
+    resolution > 0? resolution : 0.0);
   if (this->UseOutlineForLODRendering)
     {
     this->RequestInformation->Set(USE_OUTLINE_FOR_LOD(), 1);
@@ -1139,7 +1165,14 @@ void vtkPVRenderView::Render(bool interactive, bool skip_rendering)
      in_tile_display_mode || in_cave_mode) &&
     vtkProcessModule::GetProcessType() != vtkProcessModule::PROCESS_DATA_SERVER)
     {
+    vtkNew<vtkTimerLog> timer;
+    timer->StartTimer();
     this->GetRenderWindow()->Render();
+    timer->StopTimer();
+    if (interactive && use_lod_rendering && this->UseAdaptiveLODResolution)
+      {
+      this->UpdateSuggestedLODLevelOffset(timer->GetElapsedTime());
+      }
     }
 
   if (!this->MakingSelection)
@@ -1152,6 +1185,28 @@ void vtkPVRenderView::Render(bool interactive, bool skip_rendering)
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkPVRenderView::UpdateSuggestedLODLevelOffset(double render_time)
+{
+  double rate = this->GetRenderWindow()->GetDesiredUpdateRate();
+  if (rate <= 0)
+    {
+    return;
+    }
+  double target_time = 1.0 / rate;
+  if (render_time > target_time && this->SuggestedLODLevelOffset < 4)
+    {
+    this->SuggestedLODLevelOffset++;
+    }
+  else if (render_time < target_time / 8 &&
+    this->SuggestedLODLevelOffset > 0)
+    {
+    // Each level has roughly 4 times the geometry of the next one. Leave some
+    // margin so that we don't keep switching back and forth.
+    this->SuggestedLODLevelOffset--;
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkPVRenderView::Deliver(int use_lod,
     unsigned int size, unsigned int *representation_ids)
@@ -179,6 +179,31 @@ public:
   vtkSetMacro(UseOutlineForLODRendering, bool);
   vtkGetMacro(UseOutlineForLODRendering, bool);
 
+  // Description:
+  // When set to true, the LOD resolution used for interactive renders adapts
+  // to the measured frame time: when an interactive LOD render takes longer
+  // than the desired frame time, the next LOD level (half the number of
+  // divisions) is suggested, and when renders are well below it, the finer
+  // level is suggested again, up to LODResolution. The starting level is
+  // based on how much the geometry size exceeds LODRenderingThreshold.
+  // Default is false.
+  // @CallOnAllProcessess
+  vtkSetMacro(UseAdaptiveLODResolution, bool);
+  vtkGetMacro(UseAdaptiveLODResolution, bool);
+
+  // Description:
+  // Get/Set the number of LOD levels below LODResolution to use in the next
+  // UpdateLOD(). Each level halves the number of divisions used for
+  // decimation. vtkSMRenderViewProxy sets this on all processes to the value
+  // returned by GetSuggestedLODLevelOffset() on the client.
+  vtkSetClampMacro(LODLevelOffset, int, 0, 4);
+  vtkGetMacro(LODLevelOffset, int);
+
+  // Description:
+  // Returns the LOD level offset suggested by the frame time of recent
+  // interactive renders. Always 0 unless UseAdaptiveLODResolution is true.
+  vtkGetMacro(SuggestedLODLevelOffset, int);
+
   // Description:
   // Passes the compressor configuration to the client-server synchronizer, if
   // any. This affects the image compression used to relay images back to the
@@ -548,6 +573,11 @@ protected:
   // Actual render method.
   virtual void Render(bool interactive, bool skip_rendering);
 
+  // Description:
+  // Updates SuggestedLODLevelOffset based on the time taken by an
+  // interactive LOD render.
+  void UpdateSuggestedLODLevelOffset(double render_time);
+
   // Description:
   // Returns true if distributed rendering should be used based on the geometry
   // size.
@@ -645,6 +675,9 @@ protected:
 
   double LODResolution;
   bool UseLightKit;
+  bool UseAdaptiveLODResolution;
+  int LODLevelOffset;
+  int SuggestedLODLevelOffset;
 
   bool UsedLODForLastRender;
   bool UseLODForInteractiveRender;
@@ -0,0 +1,395 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVSharedMemoryBuffer.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPVSharedMemoryBuffer.h"
+
+#include "vtkMultiProcessController.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkTimerLog.h"
+#include "vtkWeakPointer.h"
+
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+#include <vtksys/ios/sstream>
+
+#if !defined(_WIN32)
+# define PARAVIEW_HAS_POSIX_SHARED_MEMORY
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+bool vtkPVSharedMemoryBuffer::UseSharedMemory = true;
+vtkIdType vtkPVSharedMemoryBuffer::SharedMemoryThreshold = 64*1024;
+
+namespace
+{
+  enum TransportModes
+    {
+    SOCKET_TRANSPORT = 0,
+    SHARED_MEMORY_TRANSPORT = 1
+    };
+
+  // Controllers for which the remote process failed to map a segment i.e.
+  // the remote process is on a different host. Weak pointers are used to
+  // detect entries for controllers that have since been destroyed.
+  typedef std::map<vtkMultiProcessController*,
+    vtkWeakPointer<vtkMultiProcessController> > MapOfControllers;
+  static MapOfControllers RemoteControllers;
+
+  bool vtkIsRemoteController(vtkMultiProcessController* controller)
+    {
+    MapOfControllers::iterator iter = RemoteControllers.find(controller);
+    if (iter == RemoteControllers.end())
+      {
+      return false;
+      }
+    if (iter->second.GetPointer() == NULL)
+      {
+      RemoteControllers.erase(iter);
+      return false;
+      }
+    return true;
+    }
+}
+
+class vtkPVSharedMemoryBuffer::vtkInternals
+{
+public:
+  std::string Name;
+  std::vector<char> HeapBuffer;
+};
+
+vtkStandardNewMacro(vtkPVSharedMemoryBuffer);
+//----------------------------------------------------------------------------
+vtkPVSharedMemoryBuffer::vtkPVSharedMemoryBuffer()
+{
+  this->Pointer = NULL;
+  this->Size = 0;
+  this->FileDescriptor = -1;
+  this->Owner = false;
+  this->Internals = new vtkInternals();
+}
+
+//----------------------------------------------------------------------------
+vtkPVSharedMemoryBuffer::~vtkPVSharedMemoryBuffer()
+{
+  this->Release();
+  delete this->Internals;
+  this->Internals = NULL;
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVSharedMemoryBuffer::IsSupported()
+{
+#ifdef PARAVIEW_HAS_POSIX_SHARED_MEMORY
+  return true;
+#else
+  return false;
+#endif
+}
+
+//----------------------------------------------------------------------------
+void vtkPVSharedMemoryBuffer::SetUseSharedMemory(bool val)
+{
+  vtkPVSharedMemoryBuffer::UseSharedMemory = val;
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVSharedMemoryBuffer::GetUseSharedMemory()
+{
+  return vtkPVSharedMemoryBuffer::UseSharedMemory &&
+    vtkPVSharedMemoryBuffer::IsSupported();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVSharedMemoryBuffer::SetSharedMemoryThreshold(vtkIdType val)
+{
+  vtkPVSharedMemoryBuffer::SharedMemoryThreshold = val;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkPVSharedMemoryBuffer::GetSharedMemoryThreshold()
+{
+  return vtkPVSharedMemoryBuffer::SharedMemoryThreshold;
+}
+
+//----------------------------------------------------------------------------
+const char* vtkPVSharedMemoryBuffer::GetName()
+{
+  return this->Internals->Name.empty()? NULL : this->Internals->Name.c_str();
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVSharedMemoryBuffer::Allocate(vtkIdType size, bool shared)
+{
+  this->Release();
+  if (size <= 0)
+    {
+    return true;
+    }
+
+  if (!shared)
+    {
+    this->Internals->HeapBuffer.resize(static_cast<size_t>(size));
+    this->Pointer = &this->Internals->HeapBuffer[0];
+    this->Size = size;
+    return true;
+    }
+
+#ifdef PARAVIEW_HAS_POSIX_SHARED_MEMORY
+  static unsigned int counter = 0;
+  vtksys_ios::ostringstream name;
+  name << "/paraview-" << getpid() << "-" << counter++;
+
+  int fd = shm_open(name.str().c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd == -1)
+    {
+    vtkDebugMacro("Failed to create shared memory segment " << name.str());
+    return false;
+    }
+  if (ftruncate(fd, static_cast<off_t>(size)) != 0)
+    {
+    vtkDebugMacro("Failed to resize shared memory segment " << name.str());
+    close(fd);
+    shm_unlink(name.str().c_str());
+    return false;
+    }
+  void* ptr = mmap(NULL, static_cast<size_t>(size),
+    PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (ptr == MAP_FAILED)
+    {
+    vtkDebugMacro("Failed to map shared memory segment " << name.str());
+    close(fd);
+    shm_unlink(name.str().c_str());
+    return false;
+    }
+
+  this->Internals->Name = name.str();
+  this->FileDescriptor = fd;
+  this->Pointer = static_cast<char*>(ptr);
+  this->Size = size;
+  this->Owner = true;
+  return true;
+#else
+  return false;
+#endif
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVSharedMemoryBuffer::Map(const char* name, vtkIdType size)
+{
+  this->Release();
+  if (!name || size <= 0)
+    {
+    return false;
+    }
+
+#ifdef PARAVIEW_HAS_POSIX_SHARED_MEMORY
+  int fd = shm_open(name, O_RDWR, 0600);
+  if (fd == -1)
+    {
+    return false;
+    }
+
+  // Make sure we are looking at the segment we were told about and not some
+  // other one with the same name.
+  struct stat info;
+  if (fstat(fd, &info) != 0 || info.st_size != static_cast<off_t>(size))
+    {
+    close(fd);
+    return false;
+    }
+
+  void* ptr = mmap(NULL, static_cast<size_t>(size),
+    PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (ptr == MAP_FAILED)
+    {
+    close(fd);
+    return false;
+    }
+
+  this->Internals->Name = name;
+  this->FileDescriptor = fd;
+  this->Pointer = static_cast<char*>(ptr);
+  this->Size = size;
+  this->Owner = false;
+  return true;
+#else
+  return false;
+#endif
+}
+
+//----------------------------------------------------------------------------
+void vtkPVSharedMemoryBuffer::Unlink()
+{
+#ifdef PARAVIEW_HAS_POSIX_SHARED_MEMORY
+  if (this->Owner && !this->Internals->Name.empty())
+    {
+    shm_unlink(this->Internals->Name.c_str());
+    this->Owner = false;
+    }
+#endif
+}
+
+//----------------------------------------------------------------------------
+void vtkPVSharedMemoryBuffer::Release()
+{
+#ifdef PARAVIEW_HAS_POSIX_SHARED_MEMORY
+  if (this->FileDescriptor != -1)
+    {
+    this->Unlink();
+    munmap(this->Pointer, static_cast<size_t>(this->Size));
+    close(this->FileDescriptor);
+    this->FileDescriptor = -1;
+    }
+#endif
+  this->Internals->Name.clear();
+  std::vector<char>().swap(this->Internals->HeapBuffer);
+  this->Pointer = NULL;
+  this->Size = 0;
+  this->Owner = false;
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVSharedMemoryBuffer::SendBuffer(vtkMultiProcessController* controller,
+  const char* data, vtkIdType length, int remoteId, int tag)
+{
+  return vtkPVSharedMemoryBuffer::SendBuffer(controller, NULL,
+    const_cast<char*>(data), length, remoteId, tag);
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVSharedMemoryBuffer::SendBuffer(vtkMultiProcessController* controller,
+  WriteCallback callback, void* clientData, vtkIdType length,
+  int remoteId, int tag)
+{
+  // Without a callback, clientData is the data to send.
+  const char* data = callback? NULL : static_cast<const char*>(clientData);
+
+  vtkNew<vtkPVSharedMemoryBuffer> segment;
+  int mode = SOCKET_TRANSPORT;
+  if (vtkPVSharedMemoryBuffer::GetUseSharedMemory() &&
+    length >= vtkPVSharedMemoryBuffer::SharedMemoryThreshold &&
+    !vtkIsRemoteController(controller) &&
+    segment->Allocate(length, true))
+    {
+    mode = SHARED_MEMORY_TRANSPORT;
+    }
+
+  if (!controller->Send(&mode, 1, remoteId, tag))
+    {
+    return false;
+    }
+
+  if (mode == SHARED_MEMORY_TRANSPORT)
+    {
+    vtkTimerLog::MarkStartEvent("Copy to shared memory");
+    if (callback)
+      {
+      (*callback)(segment->GetPointer(), length, clientData);
+      }
+    else
+      {
+      memcpy(segment->GetPointer(), data, static_cast<size_t>(length));
+      }
+    vtkTimerLog::MarkEndEvent("Copy to shared memory");
+
+    std::string name = segment->GetName();
+    int nameLength = static_cast<int>(name.size()) + 1;
+    controller->Send(&nameLength, 1, remoteId, tag);
+    controller->Send(name.c_str(), nameLength, remoteId, tag);
+
+    int mapped = 0;
+    controller->Receive(&mapped, 1, remoteId, tag);
+    if (mapped)
+      {
+      // The receiver has mapped the segment, so we no longer need it.
+      return true;
+      }
+
+    // The receiver could not map the segment. It is probably on a different
+    // host. Don't bother trying again on this connection. The data is
+    // already written in the segment, so send it from there.
+    RemoteControllers[controller] = controller;
+    return controller->Send(segment->GetPointer(), length, remoteId, tag) != 0;
+    }
+
+  if (length == 0)
+    {
+    return true;
+    }
+  if (callback)
+    {
+    if (!segment->Allocate(length, false))
+      {
+      return false;
+      }
+    (*callback)(segment->GetPointer(), length, clientData);
+    data = segment->GetPointer();
+    }
+  return controller->Send(data, length, remoteId, tag) != 0;
+}
+
+//----------------------------------------------------------------------------
+vtkPVSharedMemoryBuffer* vtkPVSharedMemoryBuffer::ReceiveBuffer(
+  vtkMultiProcessController* controller, vtkIdType length,
+  int remoteId, int tag)
+{
+  int mode = SOCKET_TRANSPORT;
+  if (!controller->Receive(&mode, 1, remoteId, tag))
+    {
+    return NULL;
+    }
+
+  vtkPVSharedMemoryBuffer* buffer = vtkPVSharedMemoryBuffer::New();
+  if (mode == SHARED_MEMORY_TRANSPORT)
+    {
+    int nameLength = 0;
+    controller->Receive(&nameLength, 1, remoteId, tag);
+    std::vector<char> name(nameLength > 0? nameLength : 1, 0);
+    controller->Receive(&name[0], nameLength, remoteId, tag);
+    name.back() = 0;
+
+    int mapped = buffer->Map(&name[0], length)? 1 : 0;
+    controller->Send(&mapped, 1, remoteId, tag);
+    if (mapped)
+      {
+      return buffer;
+      }
+    }
+
+  if (!buffer->Allocate(length, false) ||
+    (length > 0 &&
+     !controller->Receive(buffer->GetPointer(), length, remoteId, tag)))
+    {
+    buffer->Delete();
+    return NULL;
+    }
+  return buffer;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVSharedMemoryBuffer::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Size: " << this->Size << endl;
+  os << indent << "Name: " << (this->GetName()? this->GetName() : "(none)")
+     << endl;
+  os << indent << "Shared: " << this->IsShared() << endl;
+}
@@ -0,0 +1,154 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVSharedMemoryBuffer.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkPVSharedMemoryBuffer - memory buffer that can be shared with
+// another process on the same host.
+// .SECTION Description
+// vtkPVSharedMemoryBuffer is a block of memory that is either allocated on the
+// heap or in a POSIX shared memory segment. Shared memory segments are
+// identified by name, which can be sent to another process on the same host
+// for it to map the same memory without copying.
+//
+// SendBuffer() and ReceiveBuffer() implement the transport used by the data
+// delivery filters (vtkMPIMoveData, vtkClientServerMoveData) to move
+// marshalled data between the server and client. When enabled, the sender
+// places the data in a shared memory segment and only sends the segment name
+// over the socket. This is not zero-copy: the sender still copies the values
+// once, into the segment. The delivery filters avoid a second copy by having
+// vtkPVDataMarshaller write directly into the segment (see the SendBuffer()
+// overload taking a callback), and the receiver uses the values in place. If the receiver cannot map the segment, e.g. because it
+// runs on a different host, it says so and the data is sent over the socket
+// instead. The outcome is remembered for the controller so the shared memory
+// path is not tried again for remote connections.
+// .SECTION Caveats
+// Shared memory is only supported on POSIX platforms. Elsewhere, SendBuffer()
+// and ReceiveBuffer() always use the socket.
+
+#ifndef __vtkPVSharedMemoryBuffer_h
+#define __vtkPVSharedMemoryBuffer_h
+
+#include "vtkPVClientServerCoreRenderingModule.h" //needed for exports
+#include "vtkObject.h"
+
+class vtkMultiProcessController;
+
+class VTKPVCLIENTSERVERCORERENDERING_EXPORT vtkPVSharedMemoryBuffer : public vtkObject
+{
+public:
+  static vtkPVSharedMemoryBuffer* New();
+  vtkTypeMacro(vtkPVSharedMemoryBuffer, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Allocates a buffer of the given size, releasing the current one, if any.
+  // When shared is true, the buffer is allocated in a new shared memory
+  // segment. Returns false on failure.
+  bool Allocate(vtkIdType size, bool shared);
+
+  // Description:
+  // Maps an existing shared memory segment created by another process.
+  // Returns false if the segment cannot be mapped.
+  bool Map(const char* name, vtkIdType size);
+
+  // Description:
+  // Removes the name of the shared memory segment, if this buffer created it.
+  // The memory remains mapped in all processes that have already mapped it
+  // and is freed when the last mapping is released.
+  void Unlink();
+
+  // Description:
+  // Unmaps/frees the buffer.
+  void Release();
+
+  // Description:
+  // Access the buffer.
+  char* GetPointer() { return this->Pointer; }
+  vtkIdType GetSize() { return this->Size; }
+
+  // Description:
+  // Returns the name of the shared memory segment, if any.
+  const char* GetName();
+
+  // Description:
+  // Returns true if the buffer is a mapped shared memory segment.
+  bool IsShared() { return this->FileDescriptor != -1; }
+
+  // Description:
+  // Returns true if shared memory is supported on this platform.
+  static bool IsSupported();
+
+  // Description:
+  // Enable/disable the shared memory transport used by SendBuffer(). Enabled
+  // by default on platforms where shared memory is supported. This value has
+  // any effect only on the data-sender processes.
+  static void SetUseSharedMemory(bool);
+  static bool GetUseSharedMemory();
+
+  // Description:
+  // Buffers smaller than this size (in bytes) are always sent over the socket.
+  // Default is 64 KB.
+  static void SetSharedMemoryThreshold(vtkIdType);
+  static vtkIdType GetSharedMemoryThreshold();
+
+  // Description:
+  // Sends length bytes to the remote process, using a shared memory segment
+  // when possible. The receiver must call ReceiveBuffer() with the same
+  // length and tag.
+  static bool SendBuffer(vtkMultiProcessController* controller,
+    const char* data, vtkIdType length, int remoteId, int tag);
+
+//BTX
+  // Description:
+  // Same as above, except that the data is not copied from an existing
+  // buffer: the callback is called once to write the length bytes directly
+  // in the shared memory segment, or in the buffer sent over the socket when
+  // the segment cannot be used.
+  typedef void (*WriteCallback)(char* buffer, vtkIdType length,
+    void* clientData);
+  static bool SendBuffer(vtkMultiProcessController* controller,
+    WriteCallback callback, void* clientData, vtkIdType length,
+    int remoteId, int tag);
+//ETX
+
+  // Description:
+  // Receives a buffer sent with SendBuffer(). Returns a new buffer which
+  // either maps the sender's shared memory segment or holds the data received
+  // over the socket. Returns NULL on failure.
+  static vtkPVSharedMemoryBuffer* ReceiveBuffer(
+    vtkMultiProcessController* controller, vtkIdType length,
+    int remoteId, int tag);
+
+//BTX
+protected:
+  vtkPVSharedMemoryBuffer();
+  ~vtkPVSharedMemoryBuffer();
+
+  char* Pointer;
+  vtkIdType Size;
+  int FileDescriptor;
+  bool Owner;
+
+private:
+  vtkPVSharedMemoryBuffer(const vtkPVSharedMemoryBuffer&); // Not implemented
+  void operator=(const vtkPVSharedMemoryBuffer&); // Not implemented
+
+  static bool UseSharedMemory;
+  static vtkIdType SharedMemoryThreshold;
+
+  class vtkInternals;
+  vtkInternals* Internals;
+//ETX
+};
+
+#endif
@@ -39,6 +39,7 @@ bool vtkSMOutputPort::UseStreaming = false;
 int vtkSMOutputPort::DefaultPass = 0;
 int vtkSMOutputPort::DefaultNumPasses = 0;
 double vtkSMOutputPort::DefaultResolution = 0;
+bool vtkSMOutputPort::UseLightweightDataInformation = false;
 //----------------------------------------------------------------------------
 vtkSMOutputPort::vtkSMOutputPort()
 {
@@ -123,6 +124,8 @@ void vtkSMOutputPort::GatherDataInformation()
   this->SourceProxy->GetSession()->PrepareProgress();
   this->DataInformation->Initialize();
   this->DataInformation->SetPortNumber(this->PortIndex);
+  this->DataInformation->SetLightweight(
+    vtkSMOutputPort::UseLightweightDataInformation);
   this->SourceProxy->GatherInformation(this->DataInformation);
   this->DataInformationValid = true;
   this->SourceProxy->GetSession()->CleanupPendingProgress();
@@ -226,6 +229,18 @@ void vtkSMOutputPort::SetUseStreaming(bool value)
   vtkSMOutputPort::UseStreaming = value;
 }
 
+//----------------------------------------------------------------------------
+void vtkSMOutputPort::SetUseLightweightDataInformation(bool value)
+{
+  vtkSMOutputPort::UseLightweightDataInformation = value;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSMOutputPort::GetUseLightweightDataInformation()
+{
+  return vtkSMOutputPort::UseLightweightDataInformation;
+}
+
 //----------------------------------------------------------------------------
 void vtkSMOutputPort::SetDefaultPiece(int dp, int dnp, double dr)
 {
@@ -87,6 +87,15 @@ public:
   // Streaming plugin uses this to specify the prototypical piece to update
   // the get information from.
   static void SetDefaultPiece(int dp, int dnp, double dr);
+
+  // Description:
+  // When on, the data information gathered by all output ports does not
+  // include information about individual blocks of composite datasets (see
+  // vtkPVDataInformation::SetLightweight()). Applications that don't show
+  // the block hierarchy can turn this on to speed up gathering information
+  // for composite datasets with many blocks. Off by default.
+  static void SetUseLightweightDataInformation(bool value);
+  static bool GetUseLightweightDataInformation();
 //BTX
 protected:
   vtkSMOutputPort();
@@ -136,6 +145,7 @@ protected:
   static int DefaultPass;
   static int DefaultNumPasses;
   static double DefaultResolution;
+  static bool UseLightweightDataInformation;
 
 private:
   vtkSMOutputPort(const vtkSMOutputPort&); // Not implemented
@@ -26,6 +26,34 @@
 
 #include <vtkNew.h>
 
+#include <map>
+#include <set>
+#include <string>
+
+namespace
+{
+  // Returns the serialized annotations of a proxy state.
+  std::string vtkGetAnnotations(const vtkSMMessage* state)
+    {
+    std::string annotations;
+    for (int cc=0; cc < state->ExtensionSize(ProxyState::annotation); cc++)
+      {
+      annotations +=
+        state->GetExtension(ProxyState::annotation, cc).SerializeAsString();
+      }
+    return annotations;
+    }
+
+  void vtkGetPropertyNames(const vtkSMMessage* state,
+    std::set<std::string>& names)
+    {
+    for (int cc=0; cc < state->ExtensionSize(ProxyState::property); cc++)
+      {
+      names.insert(state->GetExtension(ProxyState::property, cc).name());
+      }
+    }
+}
+
 vtkStandardNewMacro(vtkSMRemoteObjectUpdateUndoElement);
 vtkSetObjectImplementationMacro(vtkSMRemoteObjectUpdateUndoElement, ProxyLocator, vtkSMProxyLocator);
 //-----------------------------------------------------------------------------
@@ -34,6 +62,7 @@ vtkSMRemoteObjectUpdateUndoElement::vtkSMRemoteObjectUpdateUndoElement()
   this->ProxyLocator = NULL;
   this->AfterState   = new vtkSMMessage();
   this->BeforeState  = new vtkSMMessage();
+  this->DeltaEncoded = false;
 }
 
 //-----------------------------------------------------------------------------
@@ -52,6 +81,7 @@ void vtkSMRemoteObjectUpdateUndoElement::PrintSelf(ostream& os, vtkIndent indent
 {
   this->Superclass::PrintSelf(os, indent);
   os << indent << "GlobalId: " << this->GetGlobalId() << endl;
+  os << indent << "DeltaEncoded: " << this->DeltaEncoded << endl;
   os << indent << "Before state: " << endl;
   if(this->BeforeState) this->BeforeState->PrintDebugString();
   os << indent << "After state: " << endl;
@@ -104,16 +134,154 @@ void vtkSMRemoteObjectUpdateUndoElement::SetUndoRedoState(
 {
   this->BeforeState->Clear();
   this->AfterState->Clear();
-  if(before && after)
-    {
-    this->BeforeState->CopyFrom(*before);
-    this->AfterState->CopyFrom(*after);
-    }
-  else
+  this->DeltaEncoded = false;
+  if(!before || !after)
     {
     vtkErrorMacro( "Invalid SetUndoRedoState. "
                    << "At least one of the provided states is NULL.");
+    return;
     }
+
+  this->BeforeState->CopyFrom(*before);
+  this->AfterState->CopyFrom(*after);
+
+  // Only proxy states are delta encoded: the LoadState() of other remote
+  // objects (proxy manager, links...) expects a full state.
+  if (!before->HasExtension(ProxyState::xml_group) ||
+    !after->HasExtension(ProxyState::xml_group) ||
+    before->global_id() != after->global_id())
+    {
+    return;
+    }
+
+  // Drop the properties that did not change.
+  std::map<std::string, std::string> beforeValues;
+  std::map<std::string, std::string> afterValues;
+  for (int cc=0; cc < before->ExtensionSize(ProxyState::property); cc++)
+    {
+    const ProxyState_Property& prop =
+      before->GetExtension(ProxyState::property, cc);
+    beforeValues[prop.name()] = prop.SerializeAsString();
+    }
+  for (int cc=0; cc < after->ExtensionSize(ProxyState::property); cc++)
+    {
+    const ProxyState_Property& prop =
+      after->GetExtension(ProxyState::property, cc);
+    afterValues[prop.name()] = prop.SerializeAsString();
+    }
+
+  this->BeforeState->ClearExtension(ProxyState::property);
+  for (int cc=0; cc < before->ExtensionSize(ProxyState::property); cc++)
+    {
+    const ProxyState_Property& prop =
+      before->GetExtension(ProxyState::property, cc);
+    std::map<std::string, std::string>::iterator iter =
+      afterValues.find(prop.name());
+    if (iter == afterValues.end() || iter->second != beforeValues[prop.name()])
+      {
+      this->BeforeState->AddExtension(ProxyState::property)->CopyFrom(prop);
+      }
+    }
+  this->AfterState->ClearExtension(ProxyState::property);
+  for (int cc=0; cc < after->ExtensionSize(ProxyState::property); cc++)
+    {
+    const ProxyState_Property& prop =
+      after->GetExtension(ProxyState::property, cc);
+    std::map<std::string, std::string>::iterator iter =
+      beforeValues.find(prop.name());
+    if (iter == beforeValues.end() || iter->second != afterValues[prop.name()])
+      {
+      this->AfterState->AddExtension(ProxyState::property)->CopyFrom(prop);
+      }
+    }
+
+  // Drop the annotations if they did not change.
+  if (before->GetExtension(ProxyState::has_annotation) ==
+    after->GetExtension(ProxyState::has_annotation) &&
+    vtkGetAnnotations(before) == vtkGetAnnotations(after))
+    {
+    this->BeforeState->ClearExtension(ProxyState::annotation);
+    this->BeforeState->ClearExtension(ProxyState::has_annotation);
+    this->AfterState->ClearExtension(ProxyState::annotation);
+    this->AfterState->ClearExtension(ProxyState::has_annotation);
+    }
+
+  this->DeltaEncoded = true;
+}
+
+//-----------------------------------------------------------------------------
+void vtkSMRemoteObjectUpdateUndoElement::ApplyDelta(
+  const vtkSMMessage* delta, vtkSMMessage* state)
+{
+  std::map<std::string, int> propertyIndices;
+  for (int cc=0; cc < state->ExtensionSize(ProxyState::property); cc++)
+    {
+    propertyIndices[state->GetExtension(ProxyState::property, cc).name()] = cc;
+    }
+
+  for (int cc=0; cc < delta->ExtensionSize(ProxyState::property); cc++)
+    {
+    const ProxyState_Property& prop =
+      delta->GetExtension(ProxyState::property, cc);
+    std::map<std::string, int>::iterator iter =
+      propertyIndices.find(prop.name());
+    if (iter != propertyIndices.end())
+      {
+      state->MutableExtension(ProxyState::property, iter->second)->CopyFrom(
+        prop);
+      }
+    else
+      {
+      state->AddExtension(ProxyState::property)->CopyFrom(prop);
+      }
+    }
+
+  if (delta->GetExtension(ProxyState::has_annotation))
+    {
+    state->ClearExtension(ProxyState::annotation);
+    for (int cc=0; cc < delta->ExtensionSize(ProxyState::annotation); cc++)
+      {
+      state->AddExtension(ProxyState::annotation)->CopyFrom(
+        delta->GetExtension(ProxyState::annotation, cc));
+      }
+    state->SetExtension(ProxyState::has_annotation, true);
+    }
+}
+
+//-----------------------------------------------------------------------------
+bool vtkSMRemoteObjectUpdateUndoElement::Merge(vtkUndoElement* new_element)
+{
+  vtkSMRemoteObjectUpdateUndoElement* other =
+    vtkSMRemoteObjectUpdateUndoElement::SafeDownCast(new_element);
+  if (!other || !this->DeltaEncoded || !other->DeltaEncoded ||
+    this->GetSession() != other->GetSession() ||
+    this->GetGlobalId() != other->GetGlobalId() ||
+    this->AfterState->GetExtension(ProxyState::has_annotation) ||
+    other->AfterState->GetExtension(ProxyState::has_annotation))
+    {
+    return false;
+    }
+
+  // Only merge changes of the same properties so that undoing the merged
+  // element restores everything the older element would have restored.
+  std::set<std::string> names;
+  std::set<std::string> otherNames;
+  vtkGetPropertyNames(this->AfterState, names);
+  vtkGetPropertyNames(other->AfterState, otherNames);
+  if (names != otherNames)
+    {
+    return false;
+    }
+
+  this->AfterState->CopyFrom(*other->AfterState);
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+unsigned long vtkSMRemoteObjectUpdateUndoElement::GetMemorySize()
+{
+  return static_cast<unsigned long>(sizeof(*this) +
+    this->BeforeState->SpaceUsed() + this->AfterState->SpaceUsed());
 }
 //-----------------------------------------------------------------------------
 vtkTypeUInt32 vtkSMRemoteObjectUpdateUndoElement::GetGlobalId()
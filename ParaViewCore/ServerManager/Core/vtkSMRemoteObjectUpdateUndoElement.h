@@ -17,6 +17,16 @@
 // This class keeps the before and after state of the RemoteObject in the
 // vtkSMMessage form. It works with any proxy and RemoteObject. It is a very
 // generic undoElement.
+//
+// For proxies, only the part of the states that changed is kept: properties
+// (and annotations) that are identical in the before and after states are
+// dropped from both. vtkSMProxy::LoadState() only updates the properties
+// present in the state, so such delta states can be loaded as is. When a
+// full state is needed (to re-create a proxy), it is rebuilt from the latest
+// state of the proxy using ApplyDelta(). When vtkUndoStack coalesces
+// changes (see vtkUndoStack::CoalescingInterval), consecutive changes of the
+// same properties of a proxy are merged together with Merge(). The elements
+// are not Mergeable: vtkUndoSet::AddElement() never merges them.
 
 #ifndef __vtkSMRemoteObjectUpdateUndoElement_h
 #define __vtkSMRemoteObjectUpdateUndoElement_h
@@ -49,19 +59,40 @@ public:
   // Set ProxyLocator to use if any.
   virtual void SetProxyLocator(vtkSMProxyLocator*);
 
+  // Description:
+  // Merges the change of a more recent element into this one if both modify
+  // the same properties of the same proxy.
+  virtual bool Merge(vtkUndoElement* new_element);
+
+  // Description:
+  // Returns the number of bytes used by the before and after states.
+  virtual unsigned long GetMemorySize();
+
+  // Description:
+  // Returns true if BeforeState and AfterState only hold what differs
+  // between the two states.
+  vtkGetMacro(DeltaEncoded, bool);
+
 //BTX
 
   // Description:
-  // Set the state of the UndoElement
+  // Set the state of the UndoElement. Proxy states are delta encoded.
   virtual void SetUndoRedoState(const vtkSMMessage* before,
                                 const vtkSMMessage* after);
 
-  // Current full state of the UndoElement
+  // Current state of the UndoElement. These are partial states when
+  // DeltaEncoded is true.
   vtkSMMessage* BeforeState;
   vtkSMMessage* AfterState;
 
   virtual vtkTypeUInt32 GetGlobalId();
 
+  // Description:
+  // Overrides the properties (and annotations) of \c state with the ones
+  // present in \c delta. Used to rebuild a full state from a delta encoded
+  // BeforeState or AfterState and a full state of the same proxy.
+  static void ApplyDelta(const vtkSMMessage* delta, vtkSMMessage* state);
+
 protected:
   vtkSMRemoteObjectUpdateUndoElement();
   ~vtkSMRemoteObjectUpdateUndoElement();
@@ -70,6 +101,7 @@ protected:
   int UpdateState(const vtkSMMessage* state);
 
   vtkSMProxyLocator* ProxyLocator;
+  bool DeltaEncoded;
 
 private:
   vtkSMRemoteObjectUpdateUndoElement(const vtkSMRemoteObjectUpdateUndoElement&); // Not implemented.
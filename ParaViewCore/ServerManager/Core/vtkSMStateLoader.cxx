@@ -51,6 +51,24 @@ struct vtkSMStateLoaderInternals
   typedef std::map<int, VectorOfRegInfo> RegInfoMapType;
   RegInfoMapType RegistrationInformation;
   std::vector<vtkTypeUInt32> AlignedMappingIdTable;
+
+  // Index of the proxy elements in the state, by id.
+  typedef std::map<vtkTypeUInt32, vtkPVXMLElement*> ProxyElementsType;
+  ProxyElementsType ProxyElements;
+  bool ProxyElementsIndexed;
+
+  // Proxies created while loading the state, in the order in which they were
+  // created, when BulkCreateProxies is on.
+  typedef std::vector<std::pair<vtkTypeUInt32, vtkSmartPointer<vtkSMProxy> > >
+    VectorOfProxies;
+  VectorOfProxies CreatedProxies;
+  bool DeferProxyUpdates;
+
+  vtkSMStateLoaderInternals() :
+    KeepOriginalId(false), ProxyElementsIndexed(false),
+    DeferProxyUpdates(false)
+    {
+    }
 };
 
 //---------------------------------------------------------------------------
@@ -59,6 +77,7 @@ vtkSMStateLoader::vtkSMStateLoader()
   this->Internal = new vtkSMStateLoaderInternals;
   this->ServerManagerStateElement = 0;
   this->KeepIdMapping = 0;
+  this->BulkCreateProxies = false;
   this->ProxyLocator = vtkSMProxyLocator::New();
 }
 
@@ -187,6 +206,12 @@ void vtkSMStateLoader::CreatedNewProxy(vtkTypeUInt32 id, vtkSMProxy* proxy)
     proxy->SetGlobalID(id);
     }
 
+  if (this->Internal->DeferProxyUpdates)
+    {
+    this->Internal->CreatedProxies.push_back(
+      vtkSMStateLoaderInternals::VectorOfProxies::value_type(id, proxy));
+    return;
+    }
 
   proxy->UpdateVTKObjects();
   if (proxy->IsA("vtkSMSourceProxy"))
@@ -196,6 +221,34 @@ void vtkSMStateLoader::CreatedNewProxy(vtkTypeUInt32 id, vtkSMProxy* proxy)
   this->RegisterProxy(id, proxy);
 }
 
+//---------------------------------------------------------------------------
+void vtkSMStateLoader::ProcessCreatedProxies()
+{
+  // Proxies are created depth-first, hence a proxy always comes after the
+  // proxies it refers to.
+  vtkSMStateLoaderInternals::VectorOfProxies proxies;
+  proxies.swap(this->Internal->CreatedProxies);
+  this->Internal->DeferProxyUpdates = false;
+
+  vtkSMStateLoaderInternals::VectorOfProxies::iterator iter;
+  for (iter = proxies.begin(); iter != proxies.end(); ++iter)
+    {
+    iter->second->UpdateVTKObjects();
+    }
+  for (iter = proxies.begin(); iter != proxies.end(); ++iter)
+    {
+    vtkSMSourceProxy* source = vtkSMSourceProxy::SafeDownCast(iter->second);
+    if (source)
+      {
+      source->UpdatePipelineInformation();
+      }
+    }
+  for (iter = proxies.begin(); iter != proxies.end(); ++iter)
+    {
+    this->RegisterProxy(iter->first, iter->second);
+    }
+}
+
 //---------------------------------------------------------------------------
 void vtkSMStateLoader::RegisterProxy(vtkTypeUInt32 id, vtkSMProxy* proxy)
 {
@@ -231,8 +284,51 @@ void vtkSMStateLoader::RegisterProxyInternal(const char* group,
 //---------------------------------------------------------------------------
 vtkPVXMLElement* vtkSMStateLoader::LocateProxyElement(vtkTypeUInt32 id)
 {
-  return this->LocateProxyElementInternal(
-    this->ServerManagerStateElement, id);
+  if (!this->ServerManagerStateElement)
+    {
+    vtkErrorMacro("No root is defined. Cannot locate proxy element with id " 
+      << id);
+    return 0;
+    }
+
+  if (!this->Internal->ProxyElementsIndexed)
+    {
+    this->BuildProxyElementIndex(this->ServerManagerStateElement);
+    this->Internal->ProxyElementsIndexed = true;
+    }
+
+  vtkSMStateLoaderInternals::ProxyElementsType::iterator iter =
+    this->Internal->ProxyElements.find(id);
+  return (iter != this->Internal->ProxyElements.end())? iter->second : 0;
+}
+
+//---------------------------------------------------------------------------
+void vtkSMStateLoader::BuildProxyElementIndex(vtkPVXMLElement* root)
+{
+  // LocateProxyElementInternal() looks at the proxy elements directly under
+  // root before going into the nested elements, in order. Since elements
+  // already in the index are never replaced, adding them in the same order
+  // makes the index return the same element for duplicated ids.
+  unsigned int numElems = root->GetNumberOfNestedElements();
+  unsigned int i=0;
+  for (i=0; i<numElems; i++)
+    {
+    vtkPVXMLElement* currentElement = root->GetNestedElement(i);
+    vtkIdType currentId;
+    if (currentElement->GetName() &&
+      strcmp(currentElement->GetName(), "Proxy") == 0 &&
+      currentElement->GetScalarAttribute("id", &currentId))
+      {
+      this->Internal->ProxyElements.insert(
+        vtkSMStateLoaderInternals::ProxyElementsType::value_type(
+          static_cast<vtkTypeUInt32>(currentId), currentElement));
+      }
+    }
+
+  for (i=0; i<numElems; i++)
+    {
+    this->BuildProxyElementIndex(root->GetNestedElement(i));
+    }
 }
 
 //---------------------------------------------------------------------------
@@ -544,6 +640,10 @@ int vtkSMStateLoader::LoadStateInternal(vtkPVXMLElement* parent)
     }
 
   this->ServerManagerStateElement = rootElement;
+  this->Internal->ProxyElements.clear();
+  this->Internal->ProxyElementsIndexed = false;
+  this->Internal->CreatedProxies.clear();
+  this->Internal->DeferProxyUpdates = this->BulkCreateProxies;
 
   unsigned int numElems = rootElement->GetNumberOfNestedElements();
   unsigned int i;
@@ -587,6 +687,9 @@ int vtkSMStateLoader::LoadStateInternal(vtkPVXMLElement* parent)
         {
         if (!this->HandleProxyCollection(currentElement))
           {
+          this->ProcessCreatedProxies();
+          this->Internal->ProxyElements.clear();
+          this->Internal->ProxyElementsIndexed = false;
           return 0;
           }
         }
@@ -601,6 +704,8 @@ int vtkSMStateLoader::LoadStateInternal(vtkPVXMLElement* parent)
       }
     }
 
+  this->ProcessCreatedProxies();
+
   // If KeepIdMapping
   this->Internal->AlignedMappingIdTable.clear();
   if(this->KeepIdMapping != 0)
@@ -623,6 +728,8 @@ int vtkSMStateLoader::LoadStateInternal(vtkPVXMLElement* parent)
 
   // Clear internal data structures.
   this->Internal->RegistrationInformation.clear();
+  this->Internal->ProxyElements.clear();
+  this->Internal->ProxyElementsIndexed = false;
   this->ServerManagerStateElement = 0; 
   return 1;
 }
@@ -631,6 +738,7 @@ int vtkSMStateLoader::LoadStateInternal(vtkPVXMLElement* parent)
 void vtkSMStateLoader::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "BulkCreateProxies: " << this->BulkCreateProxies << endl;
 }
 
 //---------------------------------------------------------------------------
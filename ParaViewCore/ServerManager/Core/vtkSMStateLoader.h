@@ -16,6 +16,10 @@
 // .SECTION Description
 // vtkSMStateLoader can load server manager state from a given 
 // vtkPVXMLElement. This element is usually populated by a vtkPVXMLParser.
+//
+// The proxy elements in the state are indexed by id the first time one is
+// looked up, so resolving the proxies referenced by properties does not
+// require scanning the whole XML tree each time.
 // .SECTION See Also
 // vtkPVXMLParser vtkPVXMLElement
 
@@ -65,6 +69,16 @@ public:
   // [key, value, key, value, ...]
   // The array is kept internaly using a std::vector
   vtkTypeUInt32* GetMappingArray(int &size);
+
+  // Description:
+  // When on, the proxies created while loading the state are only pushed
+  // (UpdateVTKObjects()), updated (UpdatePipelineInformation()) and
+  // registered once all the proxies in the state have been created and have
+  // loaded their properties, instead of one at a time as each is created.
+  // Default is off.
+  vtkSetMacro(BulkCreateProxies, bool);
+  vtkGetMacro(BulkCreateProxies, bool);
+  vtkBooleanMacro(BulkCreateProxies, bool);
 protected:
   vtkSMStateLoader();
   ~vtkSMStateLoader();
@@ -81,6 +95,11 @@ protected:
   // We register all created proxies.
   virtual void CreatedNewProxy(vtkTypeUInt32 id, vtkSMProxy* proxy);
 
+  // Description:
+  // Pushes, updates and registers the proxies whose creation was deferred
+  // because BulkCreateProxies is on.
+  void ProcessCreatedProxies();
+
   // Description:
   // Overridden so that when new views are to be created, we create views
   // suitable for the connection. 
@@ -113,10 +132,16 @@ protected:
   virtual vtkPVXMLElement* LocateProxyElement(vtkTypeUInt32 id);
 
   // Description:
-  // Used by LocateProxyElement(). Recursively tries to locate the
-  // proxy state element for the proxy.
+  // Recursively tries to locate the proxy state element for the proxy.
+  // LocateProxyElement() uses an index built with BuildProxyElementIndex()
+  // instead, which returns the same elements.
   vtkPVXMLElement* LocateProxyElementInternal(vtkPVXMLElement* root, vtkTypeUInt32 id);
 
+  // Description:
+  // Adds the proxy elements under root to the id index, in the order in
+  // which LocateProxyElementInternal() would find them.
+  void BuildProxyElementIndex(vtkPVXMLElement* root);
+
   // Description:
   // Checks the root element for version. If failed, return false.
   virtual bool VerifyXMLVersion(vtkPVXMLElement* rootElement);
@@ -129,6 +154,7 @@ protected:
   vtkPVXMLElement* ServerManagerStateElement;
   vtkSMProxyLocator* ProxyLocator;
   int KeepIdMapping;
+  bool BulkCreateProxies;
 private:
   vtkSMStateLoader(const vtkSMStateLoader&); // Not implemented
   void operator=(const vtkSMStateLoader&); // Not implemented
@@ -54,12 +54,18 @@ public:
     this->UndoSetProxyLocator->UseSessionToLocateProxy(true);
     }
 
-  void FillLocatorWithUndoStates(vtkUndoSet* undoSet, bool useBeforeState)
+  // Returns false if the full state of a deleted proxy to re-create cannot
+  // be rebuilt from its delta encoded state.
+  bool FillLocatorWithUndoStates(vtkUndoSet* undoSet, bool useBeforeState)
     {
     this->UndoSetStateLocator->UnRegisterAllStates(false);
     int max = undoSet->GetNumberOfElements();
-    for (int cc=0; cc < max; ++cc)
+    // Undo goes through the elements backward and redo forward, so when an
+    // object is modified by several elements, the state registered last is
+    // the one the object ends up with.
+    for (int i=0; i < max; ++i)
       {
+      int cc = useBeforeState? (max - 1 - i) : i;
       vtkSMRemoteObjectUpdateUndoElement* elem =
           vtkSMRemoteObjectUpdateUndoElement::SafeDownCast(
               undoSet->GetElement(cc));
@@ -67,16 +73,31 @@ public:
       if(elem)
         {
         elem->SetProxyLocator(this->UndoSetProxyLocator.GetPointer());
-        if(useBeforeState)
+        const vtkSMMessage* state =
+          useBeforeState? elem->BeforeState : elem->AfterState;
+        vtkSMMessage fullState;
+        if (elem->GetDeltaEncoded() &&
+          this->UndoSetStateLocator->FindState(state->global_id(), &fullState))
+          {
+          // Rebuild the full state from the most recent state of the object
+          // (registered above or kept by the session's locator).
+          vtkSMRemoteObjectUpdateUndoElement::ApplyDelta(state, &fullState);
+          this->UndoSetStateLocator->RegisterState(&fullState);
+          }
+        else if (elem->GetDeltaEncoded() && (!elem->GetSession() ||
+            !elem->GetSession()->GetRemoteObject(state->global_id())))
           {
-          this->UndoSetStateLocator->RegisterState(elem->BeforeState);
+          // the proxy must be re-created, and a delta is not enough to do
+          // so.
+          return false;
           }
         else
           {
-          this->UndoSetStateLocator->RegisterState(elem->AfterState);
+          this->UndoSetStateLocator->RegisterState(state);
           }
         }
       }
+    return true;
     }
 
   void UpdateSessions(vtkUndoSet* undoSet)
@@ -160,7 +181,13 @@ int vtkSMUndoStack::Undo()
   // Hold remote objects refs while the UndoSet is processing
   vtkNew<vtkCollection> remoteObjectsCollection;
   this->FillWithRemoteObjects(this->GetNextUndoSet(), remoteObjectsCollection.GetPointer());
-  this->Internal->FillLocatorWithUndoStates(this->GetNextUndoSet(), true);
+  if (!this->Internal->FillLocatorWithUndoStates(this->GetNextUndoSet(), true))
+    {
+    vtkErrorMacro("Cannot undo. The full state of a deleted proxy is not "
+      "available.");
+    this->Internal->Clear();
+    return 0;
+    }
 
   int retValue = this->Superclass::Undo();
   this->Internal->Clear();
@@ -180,7 +207,13 @@ int vtkSMUndoStack::Redo()
   // Hold remote objects refs while the UndoSet is processing
   vtkNew<vtkCollection> remoteObjectsCollection;
   this->FillWithRemoteObjects(this->GetNextRedoSet(), remoteObjectsCollection.GetPointer());
-  this->Internal->FillLocatorWithUndoStates(this->GetNextRedoSet(), false);
+  if (!this->Internal->FillLocatorWithUndoStates(this->GetNextRedoSet(), false))
+    {
+    vtkErrorMacro("Cannot redo. The full state of a deleted proxy is not "
+      "available.");
+    this->Internal->Clear();
+    return 0;
+    }
 
   int retValue = this->Superclass::Redo();
   this->Internal->Clear();
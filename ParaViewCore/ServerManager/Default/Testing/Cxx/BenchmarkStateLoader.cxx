@@ -0,0 +1,140 @@
+/*=========================================================================
+
+Program:   ParaView
+Module:    BenchmarkStateLoader.cxx
+
+Copyright (c) Kitware, Inc.
+All rights reserved.
+See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Generates server manager states with 100, 1000 and 10000 proxies (up to
+// --max-proxies) and reports the time taken by vtkSMStateLoader to load them,
+// with and without BulkCreateProxies.
+//
+// Each state has a sphere source and shrink filters connected as a binary
+// tree, so most proxies refer to another proxy through their Input property.
+//
+// Usage:
+//  BenchmarkStateLoader [--max-proxies N]
+
+#include "vtkInitializationHelper.h"
+#include "vtkProcessModule.h"
+#include "vtkPVServerOptions.h"
+#include "vtkPVXMLElement.h"
+#include "vtkSmartPointer.h"
+#include "vtkSMPropertyHelper.h"
+#include "vtkSMProxy.h"
+#include "vtkSMProxyManager.h"
+#include "vtkSMSession.h"
+#include "vtkSMSessionProxyManager.h"
+#include "vtkSMStateLoader.h"
+#include "vtkTimerLog.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+  // Returns the state of a pipeline made of numberOfProxies proxies.
+  vtkPVXMLElement* GenerateState(vtkSMSessionProxyManager* pxm,
+    int numberOfProxies)
+    {
+    std::vector<vtkSmartPointer<vtkSMProxy> > proxies;
+    for (int cc=0; cc < numberOfProxies; cc++)
+      {
+      vtkSmartPointer<vtkSMProxy> proxy;
+      if (cc == 0)
+        {
+        proxy.TakeReference(pxm->NewProxy("sources", "SphereSource"));
+        }
+      else
+        {
+        proxy.TakeReference(pxm->NewProxy("filters", "ShrinkFilter"));
+        vtkSMPropertyHelper(proxy, "Input").Set(proxies[(cc-1)/2].GetPointer());
+        }
+      proxy->UpdateVTKObjects();
+
+      std::ostringstream name;
+      name << "Proxy" << cc;
+      pxm->RegisterProxy("sources", name.str().c_str(), proxy);
+      proxies.push_back(proxy);
+      }
+
+    vtkPVXMLElement* state = pxm->SaveXMLState();
+    pxm->UnRegisterProxies();
+    return state;
+    }
+
+  // Loads the state and returns the time it took, or -1 on failure.
+  double LoadState(vtkSMSessionProxyManager* pxm, vtkPVXMLElement* state,
+    int numberOfProxies, bool bulk)
+    {
+    vtkSmartPointer<vtkSMStateLoader> loader =
+      vtkSmartPointer<vtkSMStateLoader>::New();
+    loader->SetSessionProxyManager(pxm);
+    loader->SetBulkCreateProxies(bulk);
+
+    vtkSmartPointer<vtkTimerLog> timer = vtkSmartPointer<vtkTimerLog>::New();
+    timer->StartTimer();
+    pxm->LoadXMLState(state, loader);
+    timer->StopTimer();
+
+    bool valid = (pxm->GetNumberOfProxies("sources") ==
+      static_cast<unsigned int>(numberOfProxies));
+    pxm->UnRegisterProxies();
+    return valid? timer->GetElapsedTime() : -1.0;
+    }
+}
+
+//----------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+  int maxProxies = 10000;
+  for (int cc=1; cc < argc; cc++)
+    {
+    if (strcmp(argv[cc], "--max-proxies") == 0 && cc+1 < argc)
+      {
+      maxProxies = atoi(argv[++cc]);
+      }
+    }
+
+  vtkPVServerOptions* options = vtkPVServerOptions::New();
+  vtkInitializationHelper::Initialize(argc, argv,
+    vtkProcessModule::PROCESS_CLIENT, options);
+
+  int return_value = EXIT_SUCCESS;
+  vtkSMSession* session = vtkSMSession::New();
+  vtkSMSessionProxyManager* pxm =
+    vtkSMProxyManager::GetProxyManager()->GetSessionProxyManager(session);
+
+  for (int numberOfProxies = 100; numberOfProxies <= maxProxies;
+    numberOfProxies *= 10)
+    {
+    vtkSmartPointer<vtkPVXMLElement> state;
+    state.TakeReference(GenerateState(pxm, numberOfProxies));
+
+    double loadTime = LoadState(pxm, state, numberOfProxies, false);
+    double bulkLoadTime = LoadState(pxm, state, numberOfProxies, true);
+    cout << "Proxies: " << numberOfProxies << endl
+         << "  Load: " << loadTime << " s" << endl
+         << "  Load (BulkCreateProxies): " << bulkLoadTime << " s" << endl;
+    if (loadTime < 0 || bulkLoadTime < 0)
+      {
+      cerr << "ERROR: state with " << numberOfProxies
+           << " proxies was not loaded correctly." << endl;
+      return_value = EXIT_FAILURE;
+      }
+    }
+
+  session->Delete();
+  vtkInitializationHelper::Finalize();
+  options->Delete();
+  return return_value;
+}
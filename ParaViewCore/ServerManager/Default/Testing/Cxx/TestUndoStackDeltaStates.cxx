@@ -0,0 +1,313 @@
+/*=========================================================================
+
+Program:   ParaView
+Module:    TestUndoStackDeltaStates.cxx
+
+Copyright (c) Kitware, Inc.
+All rights reserved.
+See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkCallbackCommand.h"
+#include "vtkCommand.h"
+#include "vtkInitializationHelper.h"
+#include "vtkNew.h"
+#include "vtkProcessModule.h"
+#include "vtkPVServerOptions.h"
+#include "vtkSMMessage.h"
+#include "vtkSMPropertyHelper.h"
+#include "vtkSMProxy.h"
+#include "vtkSMProxyManager.h"
+#include "vtkSMRemoteObjectUpdateUndoElement.h"
+#include "vtkSMSession.h"
+#include "vtkSMSessionProxyManager.h"
+#include "vtkSMUndoStack.h"
+#include "vtkSMUndoStackBuilder.h"
+#include "vtkUndoSet.h"
+
+#define TEST_ASSERT(cond) \
+  if (!(cond)) \
+    { \
+    cerr << "ERROR: failed at line " << __LINE__ << ": " #cond << endl; \
+    return false; \
+    }
+
+namespace
+{
+  //---------------------------------------------------------------------------
+  void CountEvent(vtkObject*, unsigned long, void* clientdata, void*)
+    {
+    ++(*static_cast<int*>(clientdata));
+    }
+
+  //---------------------------------------------------------------------------
+  vtkSMRemoteObjectUpdateUndoElement* FindElement(vtkUndoSet* set,
+    vtkSMProxy* proxy)
+    {
+    for (int cc=0; set && cc < set->GetNumberOfElements(); cc++)
+      {
+      vtkSMRemoteObjectUpdateUndoElement* elem =
+        vtkSMRemoteObjectUpdateUndoElement::SafeDownCast(set->GetElement(cc));
+      if (elem && elem->GetGlobalId() == proxy->GetGlobalID())
+        {
+        return elem;
+        }
+      }
+    return NULL;
+    }
+
+  //---------------------------------------------------------------------------
+  void SetRadius(vtkSMUndoStackBuilder* builder, vtkSMProxy* proxy,
+    const char* label, double radius)
+    {
+    builder->Begin(label);
+    vtkSMPropertyHelper(proxy, "Radius").Set(radius);
+    proxy->UpdateVTKObjects();
+    builder->EndAndPushToStack();
+    }
+
+  //---------------------------------------------------------------------------
+  // Undo/redo of a property change only keeps the changed property.
+  bool TestDeltaEncoding(vtkSMSessionProxyManager* pxm,
+    vtkSMUndoStackBuilder* builder, vtkSMUndoStack* stack)
+    {
+    vtkSMProxy* sphere = pxm->NewProxy("sources", "SphereSource");
+    pxm->RegisterProxy("sources", "DeltaSphere", sphere);
+    sphere->Delete();
+    sphere->UpdateVTKObjects();
+
+    SetRadius(builder, sphere, "ChangeRadius", 1.2);
+    TEST_ASSERT(stack->GetNumberOfUndoSets() == 1);
+
+    vtkSMRemoteObjectUpdateUndoElement* elem =
+      FindElement(stack->GetNextUndoSet(), sphere);
+    TEST_ASSERT(elem != NULL);
+    TEST_ASSERT(elem->GetDeltaEncoded());
+    TEST_ASSERT(elem->AfterState->ExtensionSize(ProxyState::property) == 1);
+    TEST_ASSERT(elem->BeforeState->ExtensionSize(ProxyState::property) == 1);
+
+    TEST_ASSERT(stack->Undo() == 1);
+    sphere->UpdateVTKObjects();
+    TEST_ASSERT(vtkSMPropertyHelper(sphere, "Radius").GetAsDouble() == 0.5);
+
+    TEST_ASSERT(stack->Redo() == 1);
+    sphere->UpdateVTKObjects();
+    TEST_ASSERT(vtkSMPropertyHelper(sphere, "Radius").GetAsDouble() == 1.2);
+    return true;
+    }
+
+  //---------------------------------------------------------------------------
+  // Undoing the deletion of a proxy re-creates it with its latest state, and
+  // an undo that cannot rebuild the full state of a proxy fails.
+  bool TestProxyRecreation(vtkSMSession* session,
+    vtkSMSessionProxyManager* pxm, vtkSMUndoStackBuilder* builder,
+    vtkSMUndoStack* stack)
+    {
+    vtkSMProxy* sphere = pxm->NewProxy("sources", "SphereSource");
+    vtkTypeUInt32 id = sphere->GetGlobalID();
+    builder->Begin("CreateSphere");
+    pxm->RegisterProxy("sources", "DeletedSphere", sphere);
+    builder->EndAndPushToStack();
+    sphere->Delete();
+    sphere = NULL;
+
+    SetRadius(builder, pxm->GetProxy("sources", "DeletedSphere"),
+      "ChangeRadius", 2.5);
+
+    builder->Begin("DeleteSphere");
+    pxm->UnRegisterProxy("sources", "DeletedSphere");
+    builder->EndAndPushToStack();
+    TEST_ASSERT(pxm->GetProxy("sources", "DeletedSphere") == NULL);
+    TEST_ASSERT(session->GetRemoteObject(id) == NULL);
+
+    TEST_ASSERT(stack->Undo() == 1);
+    sphere = pxm->GetProxy("sources", "DeletedSphere");
+    TEST_ASSERT(sphere != NULL);
+    TEST_ASSERT(sphere->GetGlobalID() == id);
+    sphere->UpdateVTKObjects();
+    TEST_ASSERT(vtkSMPropertyHelper(sphere, "Radius").GetAsDouble() == 2.5);
+
+    TEST_ASSERT(stack->Redo() == 1);
+    TEST_ASSERT(pxm->GetProxy("sources", "DeletedSphere") == NULL);
+
+    // A delta encoded change of a proxy no state is known for.
+    vtkSMProxy* other = pxm->NewProxy("sources", "SphereSource");
+    other->UpdateVTKObjects();
+    vtkSMMessage before;
+    before.CopyFrom(*other->GetFullState());
+    vtkSMPropertyHelper(other, "Radius").Set(3.0);
+    other->UpdateVTKObjects();
+    vtkSMMessage after;
+    after.CopyFrom(*other->GetFullState());
+    other->Delete();
+    vtkTypeUInt32 unknownId = session->GetNextGlobalUniqueIdentifier();
+    before.set_global_id(unknownId);
+    after.set_global_id(unknownId);
+
+    vtkNew<vtkSMRemoteObjectUpdateUndoElement> elem;
+    elem->SetSession(session);
+    elem->SetUndoRedoState(&before, &after);
+    TEST_ASSERT(elem->GetDeltaEncoded());
+    vtkNew<vtkUndoSet> set;
+    set->AddElement(elem.GetPointer());
+
+    vtkNew<vtkSMUndoStack> failingStack;
+    failingStack->Push("ChangeUnknown", set.GetPointer());
+    int errors = 0;
+    vtkNew<vtkCallbackCommand> observer;
+    observer->SetCallback(&CountEvent);
+    observer->SetClientData(&errors);
+    failingStack->AddObserver(vtkCommand::ErrorEvent, observer.GetPointer());
+    TEST_ASSERT(failingStack->Undo() == 0);
+    TEST_ASSERT(errors == 1);
+    TEST_ASSERT(failingStack->GetNumberOfUndoSets() == 1);
+    return true;
+    }
+
+  //---------------------------------------------------------------------------
+  // The oldest sets are removed when the stack goes over MaximumMemorySize.
+  bool TestEviction(vtkSMSessionProxyManager* pxm,
+    vtkSMUndoStackBuilder* builder, vtkSMUndoStack* stack)
+    {
+    vtkSMProxy* sphere = pxm->NewProxy("sources", "SphereSource");
+    pxm->RegisterProxy("sources", "EvictedSphere", sphere);
+    sphere->Delete();
+    sphere->UpdateVTKObjects();
+
+    stack->Clear();
+    stack->SetStackDepth(100);
+    stack->SetMaximumMemorySize(1);
+    int removed = 0;
+    vtkNew<vtkCallbackCommand> observer;
+    observer->SetCallback(&CountEvent);
+    observer->SetClientData(&removed);
+    unsigned long tag = stack->AddObserver(
+      vtkUndoStack::UndoSetRemovedEvent, observer.GetPointer());
+
+    const int count = 50;
+    for (int cc=0; cc < count; cc++)
+      {
+      SetRadius(builder, sphere, "ChangeRadius", 1.0 + cc);
+      }
+    stack->RemoveObserver(tag);
+
+    unsigned int remaining = stack->GetNumberOfUndoSets();
+    TEST_ASSERT(remaining >= 1);
+    TEST_ASSERT(remaining < static_cast<unsigned int>(count));
+    TEST_ASSERT(removed + static_cast<int>(remaining) == count);
+    TEST_ASSERT(remaining == 1 || stack->GetActualMemorySize() <= 1);
+
+    // The most recent changes are the ones kept.
+    for (unsigned int cc=0; cc < remaining; cc++)
+      {
+      TEST_ASSERT(stack->Undo() == 1);
+      }
+    TEST_ASSERT(!stack->CanUndo());
+    sphere->UpdateVTKObjects();
+    TEST_ASSERT(vtkSMPropertyHelper(sphere, "Radius").GetAsDouble() ==
+      1.0 + count - 1 - remaining);
+
+    stack->Clear();
+    stack->SetStackDepth(10);
+    stack->SetMaximumMemorySize(65536);
+    return true;
+    }
+
+  //---------------------------------------------------------------------------
+  // Consecutive changes are merged only when coalescing is enabled.
+  bool TestCoalescing(vtkSMSessionProxyManager* pxm,
+    vtkSMUndoStackBuilder* builder, vtkSMUndoStack* stack)
+    {
+    vtkSMProxy* sphere = pxm->NewProxy("sources", "SphereSource");
+    pxm->RegisterProxy("sources", "CoalescedSphere", sphere);
+    sphere->Delete();
+    sphere->UpdateVTKObjects();
+
+    // Disabled: one set per change, even within a set built by hand.
+    stack->Clear();
+    stack->SetCoalescingInterval(0.0);
+    SetRadius(builder, sphere, "Drag", 1.0);
+    SetRadius(builder, sphere, "Drag", 2.0);
+    SetRadius(builder, sphere, "Drag", 3.0);
+    TEST_ASSERT(stack->GetNumberOfUndoSets() == 3);
+    stack->Clear();
+
+    vtkSMMessage state1;
+    state1.CopyFrom(*sphere->GetFullState());
+    vtkSMPropertyHelper(sphere, "Radius").Set(3.5);
+    sphere->UpdateVTKObjects();
+    vtkSMMessage state2;
+    state2.CopyFrom(*sphere->GetFullState());
+    vtkNew<vtkSMRemoteObjectUpdateUndoElement> elem1;
+    elem1->SetUndoRedoState(&state1, &state2);
+    vtkNew<vtkSMRemoteObjectUpdateUndoElement> elem2;
+    elem2->SetUndoRedoState(&state2, &state1);
+    vtkNew<vtkUndoSet> set;
+    set->AddElement(elem1.GetPointer());
+    set->AddElement(elem2.GetPointer());
+    TEST_ASSERT(set->GetNumberOfElements() == 2);
+    vtkSMPropertyHelper(sphere, "Radius").Set(3.0);
+    sphere->UpdateVTKObjects();
+    stack->Clear();
+
+    // Enabled: the changes are merged into a single set.
+    stack->SetCoalescingInterval(3600.0);
+    SetRadius(builder, sphere, "Drag", 4.0);
+    SetRadius(builder, sphere, "Drag", 5.0);
+    SetRadius(builder, sphere, "Drag", 6.0);
+    TEST_ASSERT(stack->GetNumberOfUndoSets() == 1);
+
+    // A different label starts a new set.
+    SetRadius(builder, sphere, "OtherChange", 7.0);
+    TEST_ASSERT(stack->GetNumberOfUndoSets() == 2);
+
+    TEST_ASSERT(stack->Undo() == 1);
+    TEST_ASSERT(stack->Undo() == 1);
+    sphere->UpdateVTKObjects();
+    TEST_ASSERT(vtkSMPropertyHelper(sphere, "Radius").GetAsDouble() == 3.0);
+    TEST_ASSERT(stack->Redo() == 1);
+    sphere->UpdateVTKObjects();
+    TEST_ASSERT(vtkSMPropertyHelper(sphere, "Radius").GetAsDouble() == 6.0);
+
+    stack->Clear();
+    stack->SetCoalescingInterval(0.0);
+    return true;
+    }
+}
+
+//----------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+  vtkPVServerOptions* options = vtkPVServerOptions::New();
+  vtkInitializationHelper::Initialize(argc, argv,
+    vtkProcessModule::PROCESS_CLIENT, options);
+
+  vtkSMSession* session = vtkSMSession::New();
+  vtkSMSessionProxyManager* pxm = session->GetSessionProxyManager();
+
+  vtkSMUndoStack* stack = vtkSMUndoStack::New();
+  vtkSMUndoStackBuilder* builder = vtkSMUndoStackBuilder::New();
+  builder->SetUndoStack(stack);
+  vtkSMProxyManager::GetProxyManager()->SetUndoStackBuilder(builder);
+
+  bool success = TestDeltaEncoding(pxm, builder, stack);
+  stack->Clear();
+  success = TestProxyRecreation(session, pxm, builder, stack) && success;
+  stack->Clear();
+  success = TestEviction(pxm, builder, stack) && success;
+  success = TestCoalescing(pxm, builder, stack) && success;
+
+  vtkSMProxyManager::GetProxyManager()->SetUndoStackBuilder(NULL);
+  builder->Delete();
+  stack->Delete();
+  session->Delete();
+
+  vtkInitializationHelper::Finalize();
+  options->Delete();
+
+  return success? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -216,6 +216,35 @@ def test1 (query, types=[], associations=[], debug=1) :
                 else : array = servermanager.Fetch(filter).GetCellData().GetArray("result")
                 if array : print_array(array, debug>2)
 
+# test2 checks that Python Calculator gives the same results for each block
+# of a composite dataset as for the dataset alone, both for expressions that
+# are evaluated once for all the blocks and for the others.
+def test2 (debug=1) :
+    # Normals[0] is the first normal of each block: the blocks must not be
+    # concatenated for it.
+    for expr in ["Normals[:,0] * 2 + mag(Normals)", "Normals[:,1] - max(Normals[:,1])",
+                 "Normals - Normals[0]"] :
+        if debug :
+           print ''
+           print '  PC', 'multiblock', expr
+           sys.stdout.flush()
+
+        spheres = [Sphere(Radius=1), Sphere(Radius=2, ThetaResolution=16)]
+        group = GroupDatasets(Input=spheres)
+        output = servermanager.Fetch(PythonCalculator(Input=group, Expression=expr))
+        for index in range(len(spheres)) :
+            expected = servermanager.Fetch(
+              PythonCalculator(Input=spheres[index], Expression=expr))
+            expected = expected.GetPointData().GetArray("result")
+            result = output.GetBlock(index).GetPointData().GetArray("result")
+            if not result or \
+               result.GetNumberOfTuples() != expected.GetNumberOfTuples() or \
+               result.GetNumberOfComponents() != expected.GetNumberOfComponents() :
+                raise SMPythonTesting.Error("Wrong result for block %d" % index)
+            for i in range(result.GetNumberOfTuples() * result.GetNumberOfComponents()) :
+                if abs(result.GetValue(i) - expected.GetValue(i)) > 1e-6 :
+                    raise SMPythonTesting.Error("Wrong result for block %d" % index)
+
 def main () :
     # The arguments should be quite self-explanatory. In cases where they are
     # not, additional comments will be given.
@@ -264,6 +293,8 @@ def main () :
     #test0('log10',          ['scalar', 'vector', 'tensor'], 1, ['point', 'cell'])
     #test0('norm',           ['scalar', 'vector'], 1, ['point', 'cell'])
 
+    test2()
+
 if __name__ == "__main__" :
    SMPythonTesting.ProcessCommandLineArguments()
    main()
@@ -324,6 +324,18 @@ void vtkSMAnimationScene::SetFramesPerTimestep(int val)
   this->AnimationPlayer->SetFramesPerTimestep(val);
 }
 
+//----------------------------------------------------------------------------
+void vtkSMAnimationScene::SetFrameStride(int val)
+{
+  this->AnimationPlayer->SetFrameStride(val);
+}
+
+//----------------------------------------------------------------------------
+void vtkSMAnimationScene::SetFrameOffset(int val)
+{
+  this->AnimationPlayer->SetFrameOffset(val);
+}
+
 //----------------------------------------------------------------------------
 void vtkSMAnimationScene::SetCacheLimit(unsigned long kbs)
 {
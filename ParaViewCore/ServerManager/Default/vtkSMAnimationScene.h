@@ -96,6 +96,8 @@ public:
   void SetNumberOfFrames(int val);
   void SetDuration(int val);
   void SetFramesPerTimestep(int val);
+  void SetFrameStride(int val);
+  void SetFrameOffset(int val);
 
 //BTX
 protected:
@@ -57,6 +57,12 @@ bool vtkSMAnimationSceneGeometryWriter::SaveInitialize(int vtkNotUsed(startCount
     return false;
     }
 
+  if (this->FrameStride > 1)
+    {
+    vtkErrorMacro("Geometry cannot be saved using time compartments.");
+    return false;
+    }
+
   assert("The session should be set by now" && this->Session);
 
   vtkSMSessionProxyManager* pxm = this->GetSessionProxyManager();
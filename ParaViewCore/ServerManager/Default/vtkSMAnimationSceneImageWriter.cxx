@@ -107,6 +107,14 @@ bool vtkSMAnimationSceneImageWriter::SaveInitialize(int startCount)
 
   this->UpdateImageSize();
 
+  if (this->MovieWriter && this->FrameStride > 1)
+    {
+    vtkErrorMacro("Movies cannot be written using time compartments. "
+      "Save the animation as a sequence of images instead.");
+    this->SetMovieWriter(0);
+    return false;
+    }
+
   if (this->MovieWriter)
     {
     this->MovieWriter->SetFileName(this->FileName);
@@ -119,7 +127,10 @@ bool vtkSMAnimationSceneImageWriter::SaveInitialize(int startCount)
 
   this->AnimationScene->SetOverrideStillRender(1);
 
-  this->FileCount = startCount;
+  // With time compartments, the frames played locally are interleaved with
+  // those of other compartments. Offset the file count so that the image
+  // file names match the ones from a serial save.
+  this->FileCount = startCount + this->FrameOffset;
 
 #if !defined(__APPLE__)
   // Iterate over all views and enable offscreen rendering. This avoid toggling
@@ -234,7 +245,8 @@ bool vtkSMAnimationSceneImageWriter::SaveFrame(double vtkNotUsed(time))
     this->ImageWriter->SetInputData(0);
 
     errcode = this->ImageWriter->GetErrorCode();
-    this->FileCount = (!errcode)? this->FileCount + 1 : this->FileCount;
+    this->FileCount = (!errcode)?
+      this->FileCount + this->FrameStride : this->FileCount;
 
     }
   else if (this->MovieWriter)
@@ -17,6 +17,7 @@
 #include "vtkAnimationCue.h"
 #include "vtkCommand.h"
 #include "vtkObjectFactory.h"
+#include "vtkProcessModule.h"
 #include "vtkSMAnimationScene.h"
 #include "vtkSMProxy.h"
 #include "vtkSMSession.h"
@@ -30,6 +31,8 @@ vtkSMAnimationSceneWriter::vtkSMAnimationSceneWriter()
   this->FileName = 0;
   this->SaveFailed = false;
   this->StartFileCount = 0;
+  this->FrameStride = 1;
+  this->FrameOffset = 0;
 
   this->PlaybackTimeWindow[0] = 1.0;
   this->PlaybackTimeWindow[1] = -1.0;
@@ -135,6 +138,14 @@ bool vtkSMAnimationSceneWriter::Save()
   int loop = this->AnimationScene->GetLoop();
   this->AnimationScene->SetLoop(0);
 
+  // In time-parallel mode, each time compartment only plays its own share of
+  // the frames.
+  vtkProcessModule* pm = vtkProcessModule::GetProcessModule();
+  this->FrameStride = pm? pm->GetNumberOfTimeCompartments() : 1;
+  this->FrameOffset = pm? pm->GetTimeCompartmentId() : 0;
+  this->AnimationScene->SetFrameStride(this->FrameStride);
+  this->AnimationScene->SetFrameOffset(this->FrameOffset);
+
   bool status = this->SaveInitialize(this->StartFileCount);
   bool caching = this->AnimationScene->GetCaching();
   this->AnimationScene->SetCaching(false);
@@ -162,6 +173,8 @@ bool vtkSMAnimationSceneWriter::Save()
   // Restore scene parameters, if changed.
   this->AnimationScene->SetLoop(loop);
   this->AnimationScene->SetCaching(caching);
+  this->AnimationScene->SetFrameStride(1);
+  this->AnimationScene->SetFrameOffset(0);
 
   return status && (!this->SaveFailed);
 }
@@ -17,6 +17,12 @@
 // .SECTION Description
 // vtkSMAnimationSceneWriter is an abstract superclass for writers
 // that can write animations out.
+//
+// When the process module has been set up with more than one time compartment
+// (see vtkProcessModule::GetNumberOfTimeCompartments()), Save() only plays the
+// frames assigned to the local compartment i.e. every N-th frame starting at
+// the compartment id. Subclasses can use FrameStride and FrameOffset to keep
+// the file numbering consistent with a serial save.
 
 #ifndef __vtkSMAnimationSceneWriter_h
 #define __vtkSMAnimationSceneWriter_h
@@ -95,6 +101,11 @@ protected:
   char* FileName;
   double PlaybackTimeWindow[2];
   int    StartFileCount;
+
+  // Frame interleaving used for the current save. Set in Save() from the
+  // process module's time compartments.
+  int FrameStride;
+  int FrameOffset;
 private:
   vtkSMAnimationSceneWriter(const vtkSMAnimationSceneWriter&); // Not implemented.
   void operator=(const vtkSMAnimationSceneWriter&); // Not implemented.
@@ -218,7 +218,15 @@ void vtkSMRenderViewProxy::UpdateLOD()
 {
   if (this->ObjectsCreated && this->NeedsUpdateLOD)
     {
+    vtkPVRenderView* rv = vtkPVRenderView::SafeDownCast(
+      this->GetClientSideObject());
     vtkClientServerStream stream;
+    // Use the same LOD level on all processes.
+    stream << vtkClientServerStream::Invoke
+           << VTKOBJECT(this)
+           << "SetLODLevelOffset"
+           << rv->GetSuggestedLODLevelOffset()
+           << vtkClientServerStream::End;
     stream << vtkClientServerStream::Invoke
            << VTKOBJECT(this)
            << "UpdateLOD"
@@ -275,7 +283,13 @@ vtkTypeUInt32 vtkSMRenderViewProxy::PreRender(bool interactive)
   if (interactive && rv->GetUseLODForInteractiveRender())
     {
     // for interactive renders, we need to determine if we are going to use LOD.
-    // If so, we may need to update the LOD geometries.
+    // If so, we may need to update the LOD geometries. They also need to be
+    // updated when the view suggests a different LOD level based on the frame
+    // time.
+    if (rv->GetSuggestedLODLevelOffset() != rv->GetLODLevelOffset())
+      {
+      this->NeedsUpdateLOD = true;
+      }
     this->UpdateLOD();
     }
   this->DeliveryManager->Deliver(interactive);
@@ -26,6 +26,8 @@ vtkAnimationPlayer::vtkAnimationPlayer()
   this->CurrentTime = 0;
   this->StopPlay = false;
   this->Loop = false;
+  this->FrameStride = 1;
+  this->FrameOffset = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -93,16 +95,33 @@ void vtkAnimationPlayer::Play()
     {
     this->StartLoop(starttime, endtime, playbackWindow);
     this->AnimationScene->Initialize();
-    double deltatime = 0.0;
+    double lasttime = this->CurrentTime;
+    int frame = 0;
+    bool ticked = false;
     while (!this->StopPlay && this->CurrentTime <= playbackWindow[1])
       {
-      this->AnimationScene->Tick(this->CurrentTime, deltatime, this->CurrentTime);
+      // Frames not assigned to this player (see FrameStride) are skipped
+      // without ticking the scene.
+      ticked = (frame % this->FrameStride) == this->FrameOffset;
+      if (ticked)
+        {
+        this->AnimationScene->Tick(this->CurrentTime,
+          this->CurrentTime - lasttime, this->CurrentTime);
+        lasttime = this->CurrentTime;
+        }
       double progress = (this->CurrentTime-playbackWindow[0])/(playbackWindow[1]-playbackWindow[0]);
       this->InvokeEvent(vtkCommand::ProgressEvent, &progress);
 
-      double nexttime = this->GetNextTime(this->CurrentTime);
-      deltatime = nexttime - this->CurrentTime;
-      this->CurrentTime = nexttime; 
+      this->CurrentTime = this->GetNextTime(this->CurrentTime);
+      frame++;
+      }
+
+    // When the last frame belongs to another player, the scene never gets
+    // the tick at the end time that ends it and its cues: end them here,
+    // without ticking, so that no frame is rendered.
+    if (!ticked && !this->StopPlay)
+      {
+      this->AnimationScene->Finalize();
       }
 
     // Finalize will get called when Tick() is called with time>=endtime on the
@@ -196,6 +215,8 @@ void vtkAnimationPlayer::GoToPrevious()
 void vtkAnimationPlayer::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "FrameStride: " << this->FrameStride << endl;
+  os << indent << "FrameOffset: " << this->FrameOffset << endl;
 }
 
 
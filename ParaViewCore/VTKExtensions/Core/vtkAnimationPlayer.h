@@ -55,6 +55,16 @@ public:
   vtkSetMacro(Loop, bool);
   vtkGetMacro(Loop, bool);
 
+  // Description:
+  // When playing, only every FrameStride-th frame starting with the frame at
+  // FrameOffset is ticked, the remaining frames are skipped. This makes it
+  // possible for multiple groups of processes to play interleaved subsets of
+  // the same animation. Default is 1 and 0 i.e. every frame is played.
+  vtkSetClampMacro(FrameStride, int, 1, VTK_INT_MAX);
+  vtkGetMacro(FrameStride, int);
+  vtkSetClampMacro(FrameOffset, int, 0, VTK_INT_MAX);
+  vtkGetMacro(FrameOffset, int);
+
   // Description:
   // Take the animation scene to next frame.
   void GoToNext();
@@ -96,6 +106,8 @@ private:
   bool StopPlay;
   bool Loop;
   double CurrentTime;
+  int FrameStride;
+  int FrameOffset;
 
 //ETX
 };
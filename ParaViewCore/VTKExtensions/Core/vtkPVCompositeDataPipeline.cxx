@@ -28,6 +28,7 @@ PURPOSE.  See the above copyright notice for more information.
 #include <assert.h>
 
 vtkStandardNewMacro(vtkPVCompositeDataPipeline);
+vtkInformationKeyMacro(vtkPVCompositeDataPipeline, SELECTION_OF_INTEREST, ObjectBase);
 //----------------------------------------------------------------------------
 vtkPVCompositeDataPipeline::vtkPVCompositeDataPipeline()
 {
@@ -88,6 +89,73 @@ void vtkPVCompositeDataPipeline::CopyDefaultInformation(
         }
       }
     }
+
+  if (request->Has(REQUEST_UPDATE_EXTENT()) &&
+    direction == vtkExecutive::RequestUpstream)
+    {
+    // Pass the selection of interest from the requesting output port to all
+    // inputs. Algorithms that need to change it (or add one) can do so in
+    // RequestUpdateExtent() since that is called after this method.
+    vtkInformation* outInfo = NULL;
+    if (request->Has(FROM_OUTPUT_PORT()))
+      {
+      int outputPort = request->Get(FROM_OUTPUT_PORT());
+      if (outputPort >= 0 && outputPort < outInfoVec->GetNumberOfInformationObjects())
+        {
+        outInfo = outInfoVec->GetInformationObject(outputPort);
+        }
+      }
+    for (int port = 0; port < this->GetNumberOfInputPorts(); ++port)
+      {
+      int num_connections = inInfoVec[port]->GetNumberOfInformationObjects();
+      for (int cc = 0; cc < num_connections; ++cc)
+        {
+        vtkInformation* inInfo = inInfoVec[port]->GetInformationObject(cc);
+        if (outInfo && outInfo->Has(SELECTION_OF_INTEREST()))
+          {
+          inInfo->CopyEntry(outInfo, SELECTION_OF_INTEREST());
+          }
+        else
+          {
+          inInfo->Remove(SELECTION_OF_INTEREST());
+          }
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkPVCompositeDataPipeline::NeedToExecuteData(int outputPort,
+  vtkInformationVector** inInfoVec, vtkInformationVector* outInfoVec)
+{
+  if (this->Superclass::NeedToExecuteData(outputPort, inInfoVec, outInfoVec))
+    {
+    return 1;
+    }
+
+  if (outputPort < 0)
+    {
+    return 0;
+    }
+
+  // If the data was produced for a selection of interest, it only contains
+  // part of the data. Re-execute if that is not what is being requested, or
+  // if the selection was modified since.
+  vtkInformation* outInfo = outInfoVec->GetInformationObject(outputPort);
+  vtkDataObject* dataObject = outInfo->Get(vtkDataObject::DATA_OBJECT());
+  vtkInformation* dataInfo = dataObject? dataObject->GetInformation() : NULL;
+  if (dataInfo && dataInfo->Has(SELECTION_OF_INTEREST()))
+    {
+    vtkObjectBase* selection = outInfo->Get(SELECTION_OF_INTEREST());
+    vtkDataObject* selectionData = vtkDataObject::SafeDownCast(
+      dataInfo->Get(SELECTION_OF_INTEREST()));
+    if (selection != selectionData ||
+      (selectionData && selectionData->GetMTime() > dataObject->GetUpdateTime()))
+      {
+      return 1;
+      }
+    }
+  return 0;
 }
 
 //----------------------------------------------------------------------------
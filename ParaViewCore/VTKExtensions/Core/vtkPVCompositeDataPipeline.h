@@ -21,6 +21,9 @@
 //     algorithms are passed along to the input vtkPVPostFilter, if one exists.
 //     vtkPVPostFilter is used to automatically extract components or generated
 //     derived arrays such as magnitude array for vectors.
+// \li Selection of interest :- SELECTION_OF_INTEREST() set on an input by a
+//     downstream algorithm during REQUEST_UPDATE_EXTENT is passed further
+//     upstream so that readers can limit reading to the selected elements.
 
 #ifndef __vtkPVCompositeDataPipeline_h
 #define __vtkPVCompositeDataPipeline_h
@@ -28,6 +31,8 @@
 #include "vtkCompositeDataPipeline.h"
 #include "vtkPVVTKExtensionsCoreModule.h" // needed for export macro
 
+class vtkInformationObjectBaseKey;
+
 class VTKPVVTKEXTENSIONSCORE_EXPORT vtkPVCompositeDataPipeline : public vtkCompositeDataPipeline
 {
 public:
@@ -35,6 +40,16 @@ public:
   vtkTypeMacro(vtkPVCompositeDataPipeline,vtkCompositeDataPipeline);
   void PrintSelf(ostream& os, vtkIndent indent);
 
+  // Description:
+  // Key used to request only the part of the data that is covered by a
+  // vtkSelection. It is set on the input information during
+  // REQUEST_UPDATE_EXTENT by algorithms that only need the selected elements,
+  // such as vtkPVExtractArraysOverTime. Readers may ignore it. Readers that
+  // honour it must set the same key with the selection on the information of
+  // the produced data object; this is used to re-execute the reader when the
+  // selection of interest is no longer requested.
+  static vtkInformationObjectBaseKey* SELECTION_OF_INTEREST();
+
 protected:
   vtkPVCompositeDataPipeline();
   ~vtkPVCompositeDataPipeline();
@@ -47,6 +62,13 @@ protected:
   // Remove update/whole extent when resetting pipeline information.
   virtual void ResetPipelineInformation(int port, vtkInformation*);
 
+  // Overridden to re-execute when the data was produced for a different
+  // selection of interest than the one currently requested, or for one that
+  // was modified since.
+  virtual int NeedToExecuteData(int outputPort,
+                                vtkInformationVector** inInfoVec,
+                                vtkInformationVector* outInfoVec);
+
 private:
   vtkPVCompositeDataPipeline(const vtkPVCompositeDataPipeline&);  // Not implemented.
   void operator=(const vtkPVCompositeDataPipeline&);  // Not implemented.
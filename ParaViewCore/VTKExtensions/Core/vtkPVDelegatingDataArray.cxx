@@ -0,0 +1,376 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVDelegatingDataArray.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPVDelegatingDataArray.h"
+
+#include "vtkDoubleArray.h"
+#include "vtkIdList.h"
+#include "vtkVariant.h"
+
+//----------------------------------------------------------------------------
+vtkPVDelegatingDataArray::vtkPVDelegatingDataArray()
+{
+  this->Fallback = NULL;
+}
+
+//----------------------------------------------------------------------------
+vtkPVDelegatingDataArray::~vtkPVDelegatingDataArray()
+{
+  if (this->Fallback)
+    {
+    this->Fallback->Delete();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkPVDelegatingDataArray::Initialize()
+{
+  if (this->Fallback)
+    {
+    this->Fallback->Delete();
+    this->Fallback = NULL;
+    }
+  this->Size = 0;
+  this->MaxId = -1;
+  this->DataChanged();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVDelegatingDataArray::SetNumberOfComponents(int number)
+{
+  int previous = this->NumberOfComponents;
+  this->Superclass::SetNumberOfComponents(number);
+  if (this->NumberOfComponents != previous)
+    {
+    this->Initialize();
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkDoubleArray* vtkPVDelegatingDataArray::GetFallback()
+{
+  if (!this->Fallback)
+    {
+    vtkDoubleArray* fallback = vtkDoubleArray::New();
+    fallback->SetName(this->GetName());
+    fallback->SetNumberOfComponents(this->NumberOfComponents);
+    fallback->SetNumberOfTuples(this->GetNumberOfTuples());
+    this->FillFallback(fallback);
+    this->Fallback = fallback;
+    this->UpdateSizeFromFallback();
+    }
+  return this->Fallback;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVDelegatingDataArray::UpdateSizeFromFallback()
+{
+  this->Size = this->Fallback->GetSize();
+  this->MaxId = this->Fallback->GetMaxId();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVDelegatingDataArray::GetTuple(vtkIdType i, double* tuple)
+{
+  this->GetFallback()->GetTuple(i, tuple);
+}
+
+//----------------------------------------------------------------------------
+double* vtkPVDelegatingDataArray::GetTuple(vtkIdType i)
+{
+  return this->GetFallback()->GetTuple(i);
+}
+
+//----------------------------------------------------------------------------
+double vtkPVDelegatingDataArray::GetComponent(vtkIdType i, int j)
+{
+  return this->GetFallback()->GetComponent(i, j);
+}
+
+//----------------------------------------------------------------------------
+void vtkPVDelegatingDataArray::ExportToVoidPointer(void* out_ptr)
+{
+  this->GetFallback()->ExportToVoidPointer(out_ptr);
+}
+
+//----------------------------------------------------------------------------
+void* vtkPVDelegatingDataArray::GetVoidPointer(vtkIdType id)
+{
+  return this->GetFallback()->GetVoidPointer(id);
+}
+
+//----------------------------------------------------------------------------
+double* vtkPVDelegatingDataArray::GetPointer(vtkIdType id)
+{
+  return this->GetFallback()->GetPointer(id);
+}
+
+//----------------------------------------------------------------------------
+void* vtkPVDelegatingDataArray::WriteVoidPointer(vtkIdType id, vtkIdType number)
+{
+  void* pointer = this->GetFallback()->WriteVoidPointer(id, number);
+  this->UpdateSizeFromFallback();
+  return pointer;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVDelegatingDataArray::SetVoidArray(void* array, vtkIdType size, int save)
+{
+  this->GetFallback()->SetVoidArray(array, size, save);
+  this->UpdateSizeFromFallback();
+}
+
+//----------------------------------------------------------------------------
+vtkArrayIterator* vtkPVDelegatingDataArray::NewIterator()
+{
+  return this->GetFallback()->NewIterator();
+}
+
+//----------------------------------------------------------------------------
+int vtkPVDelegatingDataArray::Allocate(vtkIdType sz, vtkIdType ext)
+{
+  int status = this->GetFallback()->Allocate(sz, ext);
+  this->UpdateSizeFromFallback();
+  return status;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVDelegatingDataArray::SetNumberOfTuples(vtkIdType number)
+{
+  this->GetFallback()->SetNumberOfTuples(number);
+  this->UpdateSizeFromFallback();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVDelegatingDataArray::SetTuple(vtkIdType i, vtkIdType j,
+  vtkAbstractArray* source)
+{
+  this->GetFallback()->SetTuple(i, j, source);
+}
+
+//----------------------------------------------------------------------------
+void vtkPVDelegatingDataArray::SetTuple(vtkIdType i, const float* tuple)
+{
+  this->GetFallback()->SetTuple(i, tuple);
+}
+
+//----------------------------------------------------------------------------
+void vtkPVDelegatingDataArray::SetTuple(vtkIdType i, const double* tuple)
+{
+  this->GetFallback()->SetTuple(i, tuple);
+}
+
+//----------------------------------------------------------------------------
+void vtkPVDelegatingDataArray::InsertTuple(vtkIdType i, vtkIdType j,
+  vtkAbstractArray* source)
+{
+  this->GetFallback()->InsertTuple(i, j, source);
+  this->UpdateSizeFromFallback();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVDelegatingDataArray::InsertTuple(vtkIdType i, const float* tuple)
+{
+  this->GetFallback()->InsertTuple(i, tuple);
+  this->UpdateSizeFromFallback();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVDelegatingDataArray::InsertTuple(vtkIdType i, const double* tuple)
+{
+  this->GetFallback()->InsertTuple(i, tuple);
+  this->UpdateSizeFromFallback();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVDelegatingDataArray::InsertTuples(vtkIdList* dstIds, vtkIdList* srcIds,
+  vtkAbstractArray* source)
+{
+  this->GetFallback()->InsertTuples(dstIds, srcIds, source);
+  this->UpdateSizeFromFallback();
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkPVDelegatingDataArray::InsertNextTuple(vtkIdType j,
+  vtkAbstractArray* source)
+{
+  vtkIdType id = this->GetFallback()->InsertNextTuple(j, source);
+  this->UpdateSizeFromFallback();
+  return id;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkPVDelegatingDataArray::InsertNextTuple(const float* tuple)
+{
+  vtkIdType id = this->GetFallback()->InsertNextTuple(tuple);
+  this->UpdateSizeFromFallback();
+  return id;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkPVDelegatingDataArray::InsertNextTuple(const double* tuple)
+{
+  vtkIdType id = this->GetFallback()->InsertNextTuple(tuple);
+  this->UpdateSizeFromFallback();
+  return id;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVDelegatingDataArray::InterpolateTuple(vtkIdType i, vtkIdList* ptIndices,
+  vtkAbstractArray* source, double* weights)
+{
+  this->GetFallback()->InterpolateTuple(i, ptIndices, source, weights);
+  this->UpdateSizeFromFallback();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVDelegatingDataArray::InterpolateTuple(vtkIdType i, vtkIdType id1,
+  vtkAbstractArray* source1, vtkIdType id2, vtkAbstractArray* source2,
+  double t)
+{
+  this->GetFallback()->InterpolateTuple(i, id1, source1, id2, source2, t);
+  this->UpdateSizeFromFallback();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVDelegatingDataArray::RemoveTuple(vtkIdType id)
+{
+  this->GetFallback()->RemoveTuple(id);
+  this->UpdateSizeFromFallback();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVDelegatingDataArray::RemoveFirstTuple()
+{
+  this->GetFallback()->RemoveFirstTuple();
+  this->UpdateSizeFromFallback();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVDelegatingDataArray::RemoveLastTuple()
+{
+  this->GetFallback()->RemoveLastTuple();
+  this->UpdateSizeFromFallback();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVDelegatingDataArray::Squeeze()
+{
+  if (this->Fallback)
+    {
+    this->Fallback->Squeeze();
+    this->UpdateSizeFromFallback();
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkPVDelegatingDataArray::Resize(vtkIdType numTuples)
+{
+  int status = this->GetFallback()->Resize(numTuples);
+  this->UpdateSizeFromFallback();
+  return status;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVDelegatingDataArray::DataChanged()
+{
+  if (this->Fallback)
+    {
+    this->Fallback->DataChanged();
+    }
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVDelegatingDataArray::ClearLookup()
+{
+  if (this->Fallback)
+    {
+    this->Fallback->ClearLookup();
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkPVDelegatingDataArray::LookupValue(vtkVariant value)
+{
+  return this->GetFallback()->LookupValue(value);
+}
+
+//----------------------------------------------------------------------------
+void vtkPVDelegatingDataArray::LookupValue(vtkVariant value, vtkIdList* ids)
+{
+  this->GetFallback()->LookupValue(value, ids);
+}
+
+//----------------------------------------------------------------------------
+void vtkPVDelegatingDataArray::SetVariantValue(vtkIdType idx, vtkVariant value)
+{
+  this->GetFallback()->SetVariantValue(idx, value);
+}
+
+//----------------------------------------------------------------------------
+void vtkPVDelegatingDataArray::InsertVariantValue(vtkIdType idx, vtkVariant value)
+{
+  this->GetFallback()->InsertVariantValue(idx, value);
+  this->UpdateSizeFromFallback();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVDelegatingDataArray::DeepCopy(vtkAbstractArray* array)
+{
+  if (array == this || !array)
+    {
+    return;
+    }
+
+  // Copies own their values: mapped or computed values are copied, not the
+  // mapping or the way they are computed, since copies usually outlive the
+  // simulation's data.
+  this->Initialize();
+  this->SetNumberOfComponents(array->GetNumberOfComponents());
+  vtkDoubleArray* fallback = this->GetFallback();
+  vtkPVDelegatingDataArray* other =
+    vtkPVDelegatingDataArray::SafeDownCast(array);
+  if (other)
+    {
+    fallback->SetNumberOfTuples(other->GetNumberOfTuples());
+    other->ExportToVoidPointer(fallback->GetPointer(0));
+    }
+  else
+    {
+    fallback->DeepCopy(array);
+    }
+  this->UpdateSizeFromFallback();
+  this->SetName(array->GetName());
+  if (array->HasInformation())
+    {
+    this->CopyInformation(array->GetInformation(), /*deep=*/1);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkPVDelegatingDataArray::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Fallback: ";
+  if (this->Fallback)
+    {
+    os << endl;
+    this->Fallback->PrintSelf(os, indent.GetNextIndent());
+    }
+  else
+    {
+    os << "(none)" << endl;
+    }
+}
@@ -0,0 +1,146 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVDelegatingDataArray.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkPVDelegatingDataArray - abstract double array that delegates to
+// a vtkDoubleArray holding a copy of its values.
+// .SECTION Description
+// vtkPVDelegatingDataArray is the superclass of double arrays whose values
+// are not stored as in a vtkDoubleArray, e.g. because they are mapped from
+// simulation memory or computed on demand. The first time a method needs
+// the values as a vtkDoubleArray, GetFallback() creates one with the number
+// of components and tuples of the array and calls FillFallback() to fill
+// it. Every method declared here then delegates to that array until
+// Initialize() is called.
+//
+// Note that GetVoidPointer(), GetPointer(), iterators, lookups and all the
+// methods that modify the array need the fallback: for a large array, the
+// first call copies all the values. Subclasses override the read methods
+// (GetTuple(), GetComponent(), ExportToVoidPointer()) they can answer
+// without it.
+//
+// Arrays created with NewInstance() behave like a vtkDoubleArray.
+// .SECTION See Also
+// vtkSOADataArray
+
+#ifndef __vtkPVDelegatingDataArray_h
+#define __vtkPVDelegatingDataArray_h
+
+#include "vtkDataArray.h"
+#include "vtkPVVTKExtensionsCoreModule.h" // needed for export macro
+
+class vtkDoubleArray;
+
+class VTKPVVTKEXTENSIONSCORE_EXPORT vtkPVDelegatingDataArray :
+  public vtkDataArray
+{
+public:
+  vtkTypeMacro(vtkPVDelegatingDataArray, vtkDataArray);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Release the fallback array. Subclasses also release their own storage.
+  virtual void Initialize();
+
+  // Description:
+  // Get the data type.
+  int GetDataType() { return VTK_DOUBLE; }
+  int GetDataTypeSize() { return static_cast<int>(sizeof(double)); }
+  virtual int GetElementComponentSize() { return this->GetDataTypeSize(); }
+
+  // Description:
+  // Set the number of components. Calls Initialize() when it changes.
+  virtual void SetNumberOfComponents(int number);
+
+  // Description:
+  // Read access to the values.
+  virtual void GetTuple(vtkIdType i, double* tuple);
+  virtual double* GetTuple(vtkIdType i);
+  virtual double GetComponent(vtkIdType i, int j);
+  virtual void ExportToVoidPointer(void* out_ptr);
+
+  // Description:
+  // Methods that delegate to the fallback array.
+  void* GetVoidPointer(vtkIdType id);
+  double* GetPointer(vtkIdType id);
+  void* WriteVoidPointer(vtkIdType id, vtkIdType number);
+  void SetVoidArray(void* array, vtkIdType size, int save);
+  vtkArrayIterator* NewIterator();
+  int Allocate(vtkIdType sz, vtkIdType ext=1000);
+  void SetNumberOfTuples(vtkIdType number);
+  void SetTuple(vtkIdType i, vtkIdType j, vtkAbstractArray* source);
+  void SetTuple(vtkIdType i, const float* tuple);
+  void SetTuple(vtkIdType i, const double* tuple);
+  void InsertTuple(vtkIdType i, vtkIdType j, vtkAbstractArray* source);
+  void InsertTuple(vtkIdType i, const float* tuple);
+  void InsertTuple(vtkIdType i, const double* tuple);
+  void InsertTuples(vtkIdList* dstIds, vtkIdList* srcIds,
+    vtkAbstractArray* source);
+  vtkIdType InsertNextTuple(vtkIdType j, vtkAbstractArray* source);
+  vtkIdType InsertNextTuple(const float* tuple);
+  vtkIdType InsertNextTuple(const double* tuple);
+  void InterpolateTuple(vtkIdType i, vtkIdList* ptIndices,
+    vtkAbstractArray* source, double* weights);
+  void InterpolateTuple(vtkIdType i, vtkIdType id1, vtkAbstractArray* source1,
+    vtkIdType id2, vtkAbstractArray* source2, double t);
+  void RemoveTuple(vtkIdType id);
+  void RemoveFirstTuple();
+  void RemoveLastTuple();
+  void Squeeze();
+  int Resize(vtkIdType numTuples);
+  void DataChanged();
+  void ClearLookup();
+  //BTX
+  vtkIdType LookupValue(vtkVariant value);
+  void LookupValue(vtkVariant value, vtkIdList* ids);
+  void SetVariantValue(vtkIdType idx, vtkVariant value);
+  void InsertVariantValue(vtkIdType idx, vtkVariant value);
+  //ETX
+
+  // Description:
+  // Copies the values of the given array to the fallback. The values of a
+  // vtkPVDelegatingDataArray are copied with its ExportToVoidPointer(), so
+  // that, unlike GetVoidPointer(), this does not make it create a fallback
+  // of its own.
+  void DeepCopy(vtkAbstractArray* array);
+  void DeepCopy(vtkDataArray* array)
+    { this->DeepCopy(static_cast<vtkAbstractArray*>(array)); }
+
+protected:
+  vtkPVDelegatingDataArray();
+  ~vtkPVDelegatingDataArray();
+
+  // Description:
+  // Creates and fills the fallback array, unless done already, and returns
+  // it.
+  vtkDoubleArray* GetFallback();
+
+  // Description:
+  // Called by GetFallback() to fill the given array, which has the number
+  // of components and tuples of this array. Fallback is still NULL at this
+  // point.
+  virtual void FillFallback(vtkDoubleArray* fallback) = 0;
+
+  // Description:
+  // Updates Size and MaxId after Fallback was resized.
+  void UpdateSizeFromFallback();
+
+  // Array to which everything is delegated once it is created.
+  vtkDoubleArray* Fallback;
+
+private:
+  vtkPVDelegatingDataArray(const vtkPVDelegatingDataArray&); // Not implemented
+  void operator=(const vtkPVDelegatingDataArray&); // Not implemented
+};
+
+#endif
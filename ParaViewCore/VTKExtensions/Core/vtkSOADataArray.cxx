@@ -0,0 +1,157 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkSOADataArray.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkSOADataArray.h"
+
+#include "vtkDoubleArray.h"
+#include "vtkObjectFactory.h"
+
+vtkStandardNewMacro(vtkSOADataArray);
+//----------------------------------------------------------------------------
+vtkSOADataArray::vtkSOADataArray()
+{
+  this->ComponentArrays = new double*[1];
+  this->ComponentArrays[0] = NULL;
+  this->Tuple = new double[1];
+}
+
+//----------------------------------------------------------------------------
+vtkSOADataArray::~vtkSOADataArray()
+{
+  delete [] this->ComponentArrays;
+  delete [] this->Tuple;
+}
+
+//----------------------------------------------------------------------------
+void vtkSOADataArray::Initialize()
+{
+  // The number of components may have changed.
+  delete [] this->ComponentArrays;
+  delete [] this->Tuple;
+  this->ComponentArrays = new double*[this->NumberOfComponents];
+  this->Tuple = new double[this->NumberOfComponents];
+  for (int cc=0; cc < this->NumberOfComponents; cc++)
+    {
+    this->ComponentArrays[cc] = NULL;
+    }
+  this->Superclass::Initialize();
+}
+
+//----------------------------------------------------------------------------
+void vtkSOADataArray::SetComponentArray(int comp, double* array,
+  vtkIdType numTuples)
+{
+  if (comp < 0 || comp >= this->NumberOfComponents)
+    {
+    vtkErrorMacro("Invalid component " << comp);
+    return;
+    }
+  if (this->Fallback)
+    {
+    this->Initialize();
+    }
+  this->ComponentArrays[comp] = array;
+  this->Size = numTuples * this->NumberOfComponents;
+  this->MaxId = this->Size - 1;
+  this->DataChanged();
+}
+
+//----------------------------------------------------------------------------
+void vtkSOADataArray::SetComponentArrays(double* array, vtkIdType numTuples,
+  vtkIdType componentStride)
+{
+  for (int cc=0; cc < this->NumberOfComponents; cc++)
+    {
+    this->SetComponentArray(cc, array + cc * componentStride, numTuples);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkSOADataArray::FillFallback(vtkDoubleArray* fallback)
+{
+  this->ExportToVoidPointer(fallback->GetPointer(0));
+  for (int cc=0; cc < this->NumberOfComponents; cc++)
+    {
+    this->ComponentArrays[cc] = NULL;
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkSOADataArray::GetTuple(vtkIdType i, double* tuple)
+{
+  if (this->Fallback)
+    {
+    this->Fallback->GetTuple(i, tuple);
+    return;
+    }
+  for (int cc=0; cc < this->NumberOfComponents; cc++)
+    {
+    tuple[cc] = this->ComponentArrays[cc][i];
+    }
+}
+
+//----------------------------------------------------------------------------
+double* vtkSOADataArray::GetTuple(vtkIdType i)
+{
+  this->GetTuple(i, this->Tuple);
+  return this->Tuple;
+}
+
+//----------------------------------------------------------------------------
+double vtkSOADataArray::GetComponent(vtkIdType i, int j)
+{
+  return this->Fallback?
+    this->Fallback->GetValue(i * this->NumberOfComponents + j) :
+    this->ComponentArrays[j][i];
+}
+
+//----------------------------------------------------------------------------
+void vtkSOADataArray::ExportToVoidPointer(void* out_ptr)
+{
+  if (this->Fallback)
+    {
+    this->Fallback->ExportToVoidPointer(out_ptr);
+    return;
+    }
+  if (!out_ptr)
+    {
+    return;
+    }
+  double* out = static_cast<double*>(out_ptr);
+  int numComps = this->NumberOfComponents;
+  vtkIdType numTuples = this->GetNumberOfTuples();
+  for (int cc=0; cc < numComps; cc++)
+    {
+    const double* in = this->ComponentArrays[cc];
+    for (vtkIdType i=0; i < numTuples; i++)
+      {
+      out[i * numComps + cc] = in[i];
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkSOADataArray::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Mapped: " << this->IsMapped() << endl;
+  if (!this->Fallback)
+    {
+    for (int cc=0; cc < this->NumberOfComponents; cc++)
+      {
+      os << indent << "ComponentArray " << cc << ": "
+         << this->ComponentArrays[cc] << endl;
+      }
+    }
+}
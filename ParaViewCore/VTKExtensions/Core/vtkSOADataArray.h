@@ -0,0 +1,122 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkSOADataArray.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkSOADataArray - double array that wraps one separate array per
+// component without copying them.
+// .SECTION Description
+// Simulation codes often store multi-component fields as a structure of
+// arrays, e.g. velocity as three arrays of x, y and z values, while
+// vtkDataArrayTemplate stores the components of each tuple contiguously.
+// vtkSOADataArray maps the component arrays given to SetComponentArray()
+// without copying them, which lets Catalyst adaptors pass such fields (and
+// point coordinates) to the coprocessing pipeline at no cost.
+//
+// The values can be read with GetTuple(), GetComponent(),
+// ExportToVoidPointer() and GetTypedComponent(), and filters that know
+// about this class can read the component arrays directly with
+// GetComponentArray(); vtkPVArrayCalculator does. Everything else, i.e.
+// GetVoidPointer(), iterators, lookups and all the methods that modify the
+// array, first copies the values to the fallback vtkDoubleArray of
+// vtkPVDelegatingDataArray, to which the array then delegates until
+// component arrays are set again. In particular, most filters read arrays
+// through GetVoidPointer(): for them, the first access copies all the
+// values, i.e. costs as much as building a vtkDoubleArray in the adaptor.
+//
+// The component arrays are never deleted by this class: they must remain
+// valid as long as they are mapped. Call Modified() when their values change.
+
+#ifndef __vtkSOADataArray_h
+#define __vtkSOADataArray_h
+
+#include "vtkPVDelegatingDataArray.h"
+#include "vtkPVVTKExtensionsCoreModule.h" // needed for export macro
+
+class VTKPVVTKEXTENSIONSCORE_EXPORT vtkSOADataArray :
+  public vtkPVDelegatingDataArray
+{
+public:
+  static vtkSOADataArray* New();
+  vtkTypeMacro(vtkSOADataArray, vtkPVDelegatingDataArray);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Set the array holding the numTuples values of the given component. The
+  // number of components must be set first, and all component arrays must
+  // have the same number of tuples. The array is not copied.
+  void SetComponentArray(int comp, double* array, vtkIdType numTuples);
+
+  // Description:
+  // Convenience method mapping component comp to
+  // array + comp * componentStride for all the components, e.g. for a
+  // Fortran array of dimension (componentStride, numberOfComponents).
+  void SetComponentArrays(double* array, vtkIdType numTuples,
+    vtkIdType componentStride);
+
+  // Description:
+  // Returns the array of the given component, or NULL if the values were
+  // copied to the fallback array.
+  double* GetComponentArray(int comp)
+    { return this->Fallback? NULL : this->ComponentArrays[comp]; }
+
+  // Description:
+  // Returns 1 if the values are read from the component arrays and 0 if
+  // they were copied to the fallback array.
+  int IsMapped() { return this->Fallback? 0 : 1; }
+
+  // Description:
+  // Fast, non virtual access to the value of a component of a tuple. Does
+  // no bounds checking.
+  inline double GetTypedComponent(vtkIdType tupleIdx, int comp);
+
+  // Description:
+  // Release the component arrays and the fallback array.
+  void Initialize();
+
+  // Description:
+  // Read access to the values, which does not copy them.
+  void GetTuple(vtkIdType i, double* tuple);
+  double* GetTuple(vtkIdType i);
+  double GetComponent(vtkIdType i, int j);
+
+  // Description:
+  // Copy the values to out_ptr, with the components of each tuple stored
+  // contiguously.
+  void ExportToVoidPointer(void* out_ptr);
+
+protected:
+  vtkSOADataArray();
+  ~vtkSOADataArray();
+
+  // Description:
+  // Copies the values of the component arrays, which are then released.
+  virtual void FillFallback(vtkDoubleArray* fallback);
+
+  // One array per component. Not used when Fallback is set.
+  double** ComponentArrays;
+  // Returned by GetTuple(vtkIdType).
+  double* Tuple;
+
+private:
+  vtkSOADataArray(const vtkSOADataArray&); // Not implemented
+  void operator=(const vtkSOADataArray&); // Not implemented
+};
+
+//----------------------------------------------------------------------------
+inline double vtkSOADataArray::GetTypedComponent(vtkIdType tupleIdx, int comp)
+{
+  return this->Fallback?
+    this->GetComponent(tupleIdx, comp) : this->ComponentArrays[comp][tupleIdx];
+}
+
+#endif
@@ -66,6 +66,15 @@ public:
     return false;
     }
 
+  // Description:
+  // Returns the approximate number of bytes used by this element to save the
+  // state it needs to undo/redo the operation. vtkUndoStack uses it to keep
+  // the stack within its memory limit. Default implementation returns 0.
+  virtual unsigned long GetMemorySize()
+    {
+    return 0;
+    }
+
   // Set the working context if run inside a UndoSet context, so object
   // that are cross referenced can leave long enought to be associated
   // to another object. Otherwise the undo of a Delete will create the object
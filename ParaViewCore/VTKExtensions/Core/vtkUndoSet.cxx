@@ -81,6 +81,23 @@ int vtkUndoSet::GetNumberOfElements()
   return this->Collection->GetNumberOfItems();
 }
 
+//-----------------------------------------------------------------------------
+unsigned long vtkUndoSet::GetMemorySize()
+{
+  unsigned long size = 0;
+  int max = this->Collection->GetNumberOfItems();
+  for (int cc=0; cc < max; cc++)
+    {
+    vtkUndoElement* elem = vtkUndoElement::SafeDownCast(
+      this->Collection->GetItemAsObject(cc));
+    if (elem)
+      {
+      size += elem->GetMemorySize();
+      }
+    }
+  return size;
+}
+
 //-----------------------------------------------------------------------------
 int vtkUndoSet::Redo()
 {
@@ -76,6 +76,11 @@ public:
   // Get number of elements in the set.
   int GetNumberOfElements();
 
+  // Description:
+  // Returns the number of bytes used by all the elements in the set, as
+  // reported by vtkUndoElement::GetMemorySize().
+  unsigned long GetMemorySize();
+
 protected:
   vtkUndoSet();
   ~vtkUndoSet();
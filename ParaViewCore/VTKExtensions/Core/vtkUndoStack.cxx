@@ -16,6 +16,8 @@
 
 #include "vtkCommand.h"
 #include "vtkObjectFactory.h"
+#include "vtkTimerLog.h"
+#include "vtkUndoElement.h"
 #include "vtkUndoStackInternal.h"
 
 
@@ -27,6 +29,8 @@ vtkUndoStack::vtkUndoStack()
   this->InUndo = false;
   this->InRedo = false;
   this->StackDepth = 10;
+  this->MaximumMemorySize = 65536;
+  this->CoalescingInterval = 0.0;
 }
 
 //-----------------------------------------------------------------------------
@@ -47,6 +51,13 @@ void vtkUndoStack::Clear()
 //-----------------------------------------------------------------------------
 void vtkUndoStack::Push(const char* label, vtkUndoSet* changeSet)
 {
+  double now = vtkTimerLog::GetUniversalTime();
+  if (this->Coalesce(label, changeSet, now))
+    {
+    this->Modified();
+    return;
+    }
+
   this->Internal->RedoStack.clear();
 
   while (this->Internal->UndoStack.size() >= 
@@ -57,9 +68,81 @@ void vtkUndoStack::Push(const char* label, vtkUndoSet* changeSet)
     }
   this->Internal->UndoStack.push_back(
     vtkUndoStackInternal::Element(label, changeSet));
+  this->Internal->UndoStack.back().PushTime = now;
+
+  if (this->MaximumMemorySize > 0)
+    {
+    // The redo stack is empty at this point.
+    double limit = 1024.0 * this->MaximumMemorySize;
+    double size = 0.0;
+    vtkUndoStackInternal::VectorOfElements::iterator iter;
+    for (iter = this->Internal->UndoStack.begin();
+      iter != this->Internal->UndoStack.end(); ++iter)
+      {
+      size += iter->MemorySize;
+      }
+    while (size > limit && this->Internal->UndoStack.size() > 1)
+      {
+      size -= this->Internal->UndoStack.front().MemorySize;
+      this->Internal->UndoStack.erase(this->Internal->UndoStack.begin());
+      this->InvokeEvent(vtkUndoStack::UndoSetRemovedEvent);
+      }
+    }
   this->Modified();
 }
 
+//-----------------------------------------------------------------------------
+bool vtkUndoStack::Coalesce(const char* label, vtkUndoSet* changeSet,
+  double now)
+{
+  // Changes made after an undo are never coalesced with the undone ones.
+  if (this->CoalescingInterval <= 0.0 || this->Internal->UndoStack.empty() ||
+    !this->Internal->RedoStack.empty() ||
+    changeSet->GetNumberOfElements() != 1)
+    {
+    return false;
+    }
+
+  vtkUndoStackInternal::Element& top = this->Internal->UndoStack.back();
+  if (top.Label != label || now - top.PushTime > this->CoalescingInterval ||
+    top.UndoSet->GetNumberOfElements() != 1)
+    {
+    return false;
+    }
+
+  // The elements are merged here whether or not they are Mergeable:
+  // Mergeable elements are also merged by vtkUndoSet::AddElement(), for
+  // every change, while these only are within the interval.
+  vtkUndoElement* prev = top.UndoSet->GetElement(0);
+  vtkUndoElement* elem = changeSet->GetElement(0);
+  if (!prev || !elem || !prev->Merge(elem))
+    {
+    return false;
+    }
+
+  top.PushTime = now;
+  top.MemorySize = top.UndoSet->GetMemorySize();
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+unsigned long vtkUndoStack::GetActualMemorySize()
+{
+  double size = 0.0;
+  vtkUndoStackInternal::VectorOfElements::iterator iter;
+  for (iter = this->Internal->UndoStack.begin();
+    iter != this->Internal->UndoStack.end(); ++iter)
+    {
+    size += iter->MemorySize;
+    }
+  for (iter = this->Internal->RedoStack.begin();
+    iter != this->Internal->RedoStack.end(); ++iter)
+    {
+    size += iter->MemorySize;
+    }
+  return static_cast<unsigned long>((size + 1023.0) / 1024.0);
+}
+
 //-----------------------------------------------------------------------------
 unsigned int vtkUndoStack::GetNumberOfUndoSets()
 {
@@ -185,4 +268,6 @@ void vtkUndoStack::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "InUndo: " << this->InUndo << endl;
   os << indent << "InRedo: " << this->InRedo << endl;
   os << indent << "StackDepth: " << this->StackDepth << endl;
+  os << indent << "MaximumMemorySize: " << this->MaximumMemorySize << endl;
+  os << indent << "CoalescingInterval: " << this->CoalescingInterval << endl;
 }
@@ -28,6 +28,12 @@
 // Each undo set are assigned user-readable labels providing information about
 // the operation(s) that will be undone/redone.
 //
+// The size of the stack is limited both by StackDepth and by
+// MaximumMemorySize: when a set is pushed, the oldest sets are removed until
+// both limits are satisfied. Optionally, sets pushed in rapid succession with
+// the same label can be coalesced into a single entry (see
+// CoalescingInterval).
+//
 // vtkUndoElement, vtkUndoSet and vtkUndoStack form the undo/redo framework core.
 // .SECTION See Also
 // vtkUndoSet vtkUndoElement
@@ -154,12 +160,44 @@ public:
   // Default is 10.
   vtkSetClampMacro(StackDepth, int, 1, 100);
   vtkGetMacro(StackDepth, int);
+
+  // Description:
+  // Get/Set the maximum memory, in kibibytes, used by the sets on the stack
+  // (as reported by vtkUndoSet::GetMemorySize()). As more entries are pushed
+  // on the stack, if its size exceeds this limit then old entries will be
+  // removed. The most recently pushed entry is always kept. 0 means no limit.
+  // Default is 65536 (64 MiB).
+  vtkSetMacro(MaximumMemorySize, unsigned long);
+  vtkGetMacro(MaximumMemorySize, unsigned long);
+
+  // Description:
+  // Returns the memory, in kibibytes, used by the sets on the undo and redo
+  // stacks.
+  unsigned long GetActualMemorySize();
+
+  // Description:
+  // Get/Set the time interval, in seconds, used to coalesce rapid consecutive
+  // changes (e.g. while dragging a slider). When a set is pushed with the
+  // same label as the set on the top of the undo stack, less than this
+  // interval after it, and both sets are made of a single element that can be
+  // merged with the other (see vtkUndoElement::Merge), the new change is
+  // merged into the existing entry instead of being pushed as a new one.
+  // 0 disables coalescing. Default is 0.
+  vtkSetClampMacro(CoalescingInterval, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(CoalescingInterval, double);
 protected:
   vtkUndoStack();
   ~vtkUndoStack();
 
+  // Description:
+  // Called by Push() to try to merge the change set into the set on the top
+  // of the undo stack. Returns true on success.
+  bool Coalesce(const char* label, vtkUndoSet* changeSet, double now);
+
   vtkUndoStackInternal* Internal;
   int StackDepth;
+  unsigned long MaximumMemorySize;
+  double CoalescingInterval;
 
 private:
   vtkUndoStack(const vtkUndoStack&); // Not implemented.
@@ -25,6 +25,8 @@ public:
     {
     std::string Label;
     vtkSmartPointer<vtkUndoSet> UndoSet;
+    unsigned long MemorySize; // in bytes
+    double PushTime;
     Element(const char* label, vtkUndoSet* set)
       {
       this->Label = label;
@@ -33,6 +35,8 @@ public:
         {
         this->UndoSet->AddElement(set->GetElement(i));
         }
+      this->MemorySize = this->UndoSet->GetMemorySize();
+      this->PushTime = 0.0;
       }
     };
   typedef std::vector<Element> VectorOfElements;
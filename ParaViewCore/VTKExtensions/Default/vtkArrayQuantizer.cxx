@@ -0,0 +1,668 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkArrayQuantizer.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkArrayQuantizer.h"
+
+#include "vtkCellData.h"
+#include "vtkCompositeDataIterator.h"
+#include "vtkCompositeDataSet.h"
+#include "vtkDataObject.h"
+#include "vtkDataSet.h"
+#include "vtkDoubleArray.h"
+#include "vtkFieldData.h"
+#include "vtkFloatArray.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkMath.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkSmartPointer.h"
+#include "vtkUnsignedShortArray.h"
+
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace
+{
+  // Components of the tuples of the "_Quantization" field data arrays.
+  enum
+    {
+    ASSOCIATION = 0,
+    MODE,
+    NUMBER_OF_BITS,
+    OFFSET,
+    SCALE,
+    ERROR_BOUND,
+    NAN_INDEX,
+    NUMBER_OF_COMPONENTS
+    };
+
+  const char* QuantizationSuffix = "_Quantization";
+
+  // Rounds value to the nearest half precision number and returns its bits.
+  // Values larger than 65504 are clamped to it.
+  vtkTypeUInt16 vtkArrayQuantizerFloatToHalf(float value)
+    {
+    union { float Float; vtkTypeUInt32 Bits; } converter;
+    converter.Float = value;
+    vtkTypeUInt32 sign = (converter.Bits >> 16) & 0x8000;
+    vtkTypeUInt32 magnitude = converter.Bits & 0x7fffffff;
+    if (magnitude > 0x7f800000)
+      {
+      // NaN
+      return static_cast<vtkTypeUInt16>(sign | 0x7e00);
+      }
+    if (magnitude > 0x477fe000)
+      {
+      return static_cast<vtkTypeUInt16>(sign | 0x7bff);
+      }
+    if (magnitude < 0x33000000)
+      {
+      return static_cast<vtkTypeUInt16>(sign);
+      }
+    vtkTypeUInt32 half;
+    vtkTypeUInt32 remainder;
+    vtkTypeUInt32 halfway;
+    if (magnitude < 0x38800000)
+      {
+      // subnormal half precision numbers, in units of 2^-24.
+      vtkTypeUInt32 exponent = magnitude >> 23;
+      vtkTypeUInt32 mantissa = (magnitude & 0x7fffff) | 0x800000;
+      vtkTypeUInt32 shift = 126 - exponent;
+      half = mantissa >> shift;
+      remainder = mantissa & ((1u << shift) - 1);
+      halfway = 1u << (shift - 1);
+      }
+    else
+      {
+      half = (magnitude - 0x38000000) >> 13;
+      remainder = magnitude & 0x1fff;
+      halfway = 0x1000;
+      }
+    // round to nearest, ties to even.
+    if (remainder > halfway || (remainder == halfway && (half & 1)))
+      {
+      half++;
+      }
+    return static_cast<vtkTypeUInt16>(sign | half);
+    }
+
+  float vtkArrayQuantizerHalfToFloat(vtkTypeUInt16 half)
+    {
+    vtkTypeUInt32 sign = static_cast<vtkTypeUInt32>(half & 0x8000) << 16;
+    vtkTypeUInt32 exponent = (half >> 10) & 0x1f;
+    vtkTypeUInt32 mantissa = half & 0x3ff;
+    if (exponent == 0)
+      {
+      float value = static_cast<float>(ldexp(static_cast<double>(mantissa), -24));
+      return sign? -value : value;
+      }
+    union { float Float; vtkTypeUInt32 Bits; } converter;
+    if (exponent == 31)
+      {
+      converter.Bits = sign | 0x7f800000 | (mantissa << 13);
+      }
+    else
+      {
+      converter.Bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+      }
+    return converter.Float;
+    }
+
+  // Computes the range of all the components of values, ignoring NaNs,
+  // and whether there are NaNs.
+  template <class T>
+  void vtkArrayQuantizerRange(const T* values, vtkIdType numberOfValues,
+    double range[2], bool& hasNaN)
+    {
+    range[0] = VTK_DOUBLE_MAX;
+    range[1] = VTK_DOUBLE_MIN;
+    hasNaN = false;
+    for (vtkIdType cc=0; cc < numberOfValues; cc++)
+      {
+      double value = static_cast<double>(values[cc]);
+      if (value == value)
+        {
+        range[0] = value < range[0]? value : range[0];
+        range[1] = value > range[1]? value : range[1];
+        }
+      else
+        {
+        hasNaN = true;
+        }
+      }
+    if (range[0] > range[1])
+      {
+      range[0] = range[1] = 0;
+      }
+    }
+
+  // NaNs are stored as nanIndex.
+  template <class T, class Q>
+  void vtkArrayQuantizerQuantize(const T* values, vtkIdType numberOfValues,
+    double offset, double scale, double maximumIndex, double nanIndex,
+    Q* indices)
+    {
+    double inverseScale = scale > 0? 1.0 / scale : 0;
+    for (vtkIdType cc=0; cc < numberOfValues; cc++)
+      {
+      double value = static_cast<double>(values[cc]);
+      if (value != value)
+        {
+        indices[cc] = static_cast<Q>(nanIndex);
+        continue;
+        }
+      double index = floor((value - offset) * inverseScale + 0.5);
+      index = index >= 0? index : 0;
+      indices[cc] = static_cast<Q>(index < maximumIndex? index : maximumIndex);
+      }
+    }
+
+  // Stores the indices of values in indices, an unsigned char, short or int
+  // array.
+  template <class T>
+  void vtkArrayQuantizerQuantize(const T* values, vtkIdType numberOfValues,
+    double offset, double scale, double maximumIndex, double nanIndex,
+    vtkDataArray* indices)
+    {
+    void* pointer = indices->GetVoidPointer(0);
+    switch (indices->GetDataType())
+      {
+      case VTK_UNSIGNED_CHAR:
+        vtkArrayQuantizerQuantize(values, numberOfValues, offset, scale,
+          maximumIndex, nanIndex, static_cast<unsigned char*>(pointer));
+        break;
+      case VTK_UNSIGNED_SHORT:
+        vtkArrayQuantizerQuantize(values, numberOfValues, offset, scale,
+          maximumIndex, nanIndex, static_cast<unsigned short*>(pointer));
+        break;
+      default:
+        vtkArrayQuantizerQuantize(values, numberOfValues, offset, scale,
+          maximumIndex, nanIndex, static_cast<unsigned int*>(pointer));
+      }
+    }
+
+  // Converts values to half precision numbers and returns the largest
+  // absolute error.
+  template <class T>
+  double vtkArrayQuantizerToHalf(const T* values, vtkIdType numberOfValues,
+    vtkTypeUInt16* halves)
+    {
+    double errorBound = 0;
+    for (vtkIdType cc=0; cc < numberOfValues; cc++)
+      {
+      double value = static_cast<double>(values[cc]);
+      halves[cc] = vtkArrayQuantizerFloatToHalf(static_cast<float>(value));
+      double error = fabs(
+        value - static_cast<double>(vtkArrayQuantizerHalfToFloat(halves[cc])));
+      errorBound = error > errorBound? error : errorBound;
+      }
+    return errorBound;
+    }
+
+  // Indices equal to nanIndex are decoded as NaNs. nanIndex is -1 when
+  // there were no NaNs.
+  template <class Q>
+  void vtkArrayQuantizerDequantize(const Q* indices, vtkIdType numberOfValues,
+    double offset, double scale, double nanIndex, double* values)
+    {
+    for (vtkIdType cc=0; cc < numberOfValues; cc++)
+      {
+      double index = static_cast<double>(indices[cc]);
+      values[cc] = index == nanIndex? vtkMath::Nan() : offset + index * scale;
+      }
+    }
+
+  vtkFieldData* vtkArrayQuantizerGetAttributes(vtkDataSet* dataSet,
+    int association)
+    {
+    if (association == vtkDataObject::FIELD_ASSOCIATION_POINTS)
+      {
+      return dataSet->GetPointData();
+      }
+    return dataSet->GetCellData();
+    }
+
+  // Replaces array by newArray in attributes, keeping it as the active
+  // attribute it was.
+  void vtkArrayQuantizerReplace(vtkFieldData* fieldData, vtkDataArray* array,
+    vtkDataArray* newArray)
+    {
+    newArray->SetName(array->GetName());
+    vtkDataSetAttributes* attributes =
+      vtkDataSetAttributes::SafeDownCast(fieldData);
+    int attributeType = -1;
+    if (attributes)
+      {
+      for (int cc=0; cc < attributes->GetNumberOfArrays(); cc++)
+        {
+        if (attributes->GetAbstractArray(cc) == array)
+          {
+          attributeType = attributes->IsArrayAnAttribute(cc);
+          break;
+          }
+        }
+      }
+    fieldData->AddArray(newArray);
+    if (attributeType >= 0)
+      {
+      attributes->SetActiveAttribute(newArray->GetName(), attributeType);
+      }
+    }
+}
+
+class vtkArrayQuantizer::vtkInternals
+{
+public:
+  struct Setting
+    {
+    int Mode;
+    int NumberOfBits;
+    double ErrorBound;
+    };
+  typedef std::map<std::string, Setting> SettingsType;
+  SettingsType Settings;
+};
+
+vtkStandardNewMacro(vtkArrayQuantizer);
+//----------------------------------------------------------------------------
+vtkArrayQuantizer::vtkArrayQuantizer()
+{
+  this->Decode = 0;
+  this->Internals = new vtkInternals;
+}
+
+//----------------------------------------------------------------------------
+vtkArrayQuantizer::~vtkArrayQuantizer()
+{
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+void vtkArrayQuantizer::SetArrayNumberOfBits(const char* name,
+  int numberOfBits)
+{
+  if (!name || numberOfBits < 1 || numberOfBits > 32)
+    {
+    vtkErrorMacro("The number of bits must be between 1 and 32.");
+    return;
+    }
+  vtkInternals::Setting& setting = this->Internals->Settings[name];
+  setting.Mode = QUANTIZE;
+  setting.NumberOfBits = numberOfBits;
+  setting.ErrorBound = -1;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkArrayQuantizer::SetArrayErrorBound(const char* name,
+  double errorBound)
+{
+  if (!name || errorBound < 0)
+    {
+    vtkErrorMacro("The error bound must be positive.");
+    return;
+    }
+  vtkInternals::Setting& setting = this->Internals->Settings[name];
+  setting.Mode = QUANTIZE;
+  setting.NumberOfBits = 0;
+  setting.ErrorBound = errorBound;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkArrayQuantizer::SetArrayFloat16(const char* name)
+{
+  if (!name)
+    {
+    return;
+    }
+  vtkInternals::Setting& setting = this->Internals->Settings[name];
+  setting.Mode = FLOAT16;
+  setting.NumberOfBits = 16;
+  setting.ErrorBound = -1;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkArrayQuantizer::RemoveAllArrays()
+{
+  if (!this->Internals->Settings.empty())
+    {
+    this->Internals->Settings.clear();
+    this->Modified();
+    }
+}
+
+//----------------------------------------------------------------------------
+double vtkArrayQuantizer::GetErrorBound(vtkDataSet* dataSet,
+  int association, const char* name)
+{
+  if (!dataSet || !name || !dataSet->GetFieldData())
+    {
+    return -1;
+    }
+  std::string quantizationName = std::string(name) + QuantizationSuffix;
+  vtkDataArray* quantization =
+    dataSet->GetFieldData()->GetArray(quantizationName.c_str());
+  if (!quantization ||
+    quantization->GetNumberOfComponents() != NUMBER_OF_COMPONENTS)
+    {
+    return -1;
+    }
+  for (vtkIdType cc=0; cc < quantization->GetNumberOfTuples(); cc++)
+    {
+    if (static_cast<int>(quantization->GetComponent(cc, ASSOCIATION)) ==
+      association)
+      {
+      return quantization->GetComponent(cc, ERROR_BOUND);
+      }
+    }
+  return -1;
+}
+
+//----------------------------------------------------------------------------
+int vtkArrayQuantizer::FillInputPortInformation(int port, vtkInformation* info)
+{
+  if (!this->Superclass::FillInputPortInformation(port, info))
+    {
+    return 0;
+    }
+  info->Set(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkDataSet");
+  info->Append(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkCompositeDataSet");
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkArrayQuantizer::RequestData(vtkInformation*,
+  vtkInformationVector** inputVector, vtkInformationVector* outputVector)
+{
+  vtkDataObject* input = vtkDataObject::GetData(inputVector[0], 0);
+  vtkDataObject* output = vtkDataObject::GetData(outputVector, 0);
+
+  vtkCompositeDataSet* compositeInput = vtkCompositeDataSet::SafeDownCast(input);
+  vtkCompositeDataSet* compositeOutput =
+    vtkCompositeDataSet::SafeDownCast(output);
+  if (compositeInput && compositeOutput)
+    {
+    compositeOutput->CopyStructure(compositeInput);
+    vtkCompositeDataIterator* iter = compositeInput->NewIterator();
+    for (iter->InitTraversal(); !iter->IsDoneWithTraversal();
+      iter->GoToNextItem())
+      {
+      vtkDataSet* block =
+        vtkDataSet::SafeDownCast(iter->GetCurrentDataObject());
+      if (block)
+        {
+        vtkDataSet* outputBlock = block->NewInstance();
+        outputBlock->ShallowCopy(block);
+        this->Process(outputBlock);
+        compositeOutput->SetDataSet(iter, outputBlock);
+        outputBlock->Delete();
+        }
+      }
+    iter->Delete();
+    return 1;
+    }
+
+  vtkDataSet* outputDataSet = vtkDataSet::SafeDownCast(output);
+  if (!outputDataSet)
+    {
+    vtkErrorMacro("Unsupported output type.");
+    return 0;
+    }
+  outputDataSet->ShallowCopy(input);
+  this->Process(outputDataSet);
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkArrayQuantizer::Process(vtkDataSet* output)
+{
+  if (this->Decode)
+    {
+    this->DecodeArrays(output);
+    }
+  else if (!this->Internals->Settings.empty())
+    {
+    this->Quantize(output, vtkDataObject::FIELD_ASSOCIATION_POINTS);
+    this->Quantize(output, vtkDataObject::FIELD_ASSOCIATION_CELLS);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkArrayQuantizer::Quantize(vtkDataSet* output, int association)
+{
+  vtkFieldData* attributes = vtkArrayQuantizerGetAttributes(output, association);
+  std::vector<vtkDataArray*> arrays;
+  for (int cc=0; cc < attributes->GetNumberOfArrays(); cc++)
+    {
+    vtkDataArray* array = attributes->GetArray(cc);
+    if (array && array->GetName() && array->GetDataType() != VTK_BIT &&
+      this->Internals->Settings.find(array->GetName()) !=
+      this->Internals->Settings.end())
+      {
+      arrays.push_back(array);
+      }
+    }
+
+  for (size_t cc=0; cc < arrays.size(); cc++)
+    {
+    vtkDataArray* array = arrays[cc];
+    const vtkInternals::Setting& setting =
+      this->Internals->Settings[array->GetName()];
+    vtkIdType numberOfValues =
+      array->GetNumberOfTuples() * array->GetNumberOfComponents();
+    void* values = array->GetVoidPointer(0);
+
+    double parameters[NUMBER_OF_COMPONENTS];
+    parameters[ASSOCIATION] = association;
+    parameters[MODE] = setting.Mode;
+    parameters[OFFSET] = 0;
+    parameters[SCALE] = 1;
+    parameters[NAN_INDEX] = -1;
+    vtkSmartPointer<vtkDataArray> quantized;
+    if (setting.Mode == FLOAT16)
+      {
+      vtkUnsignedShortArray* halves = vtkUnsignedShortArray::New();
+      halves->SetNumberOfComponents(array->GetNumberOfComponents());
+      halves->SetNumberOfTuples(array->GetNumberOfTuples());
+      double errorBound = 0;
+      switch (array->GetDataType())
+        {
+        vtkTemplateMacro(errorBound = vtkArrayQuantizerToHalf(
+            static_cast<VTK_TT*>(values), numberOfValues,
+            halves->GetPointer(0)));
+        }
+      parameters[NUMBER_OF_BITS] = 16;
+      parameters[ERROR_BOUND] = errorBound;
+      quantized.TakeReference(halves);
+      }
+    else
+      {
+      double range[2] = {0, 0};
+      bool hasNaN = false;
+      switch (array->GetDataType())
+        {
+        vtkTemplateMacro(vtkArrayQuantizerRange(
+            static_cast<VTK_TT*>(values), numberOfValues, range, hasNaN));
+        }
+      // the largest index is reserved for the NaNs, if any: at least 2 bits
+      // are then needed.
+      int reserved = hasNaN? 1 : 0;
+      double width = range[1] - range[0];
+      int numberOfBits = setting.NumberOfBits;
+      if (numberOfBits == 0)
+        {
+        // the fewest bits for which half a step is within the error bound.
+        numberOfBits = 1 + reserved;
+        while (numberOfBits < 32 && (setting.ErrorBound <= 0 ||
+            ldexp(1.0, numberOfBits) - 1 - reserved <
+            width / (2 * setting.ErrorBound)))
+          {
+          numberOfBits++;
+          }
+        }
+      else if (numberOfBits == 1 && hasNaN)
+        {
+        numberOfBits = 2;
+        }
+      double maximumIndex = ldexp(1.0, numberOfBits) - 1 - reserved;
+      double nanIndex = hasNaN? maximumIndex + 1 : -1;
+      double scale = width / maximumIndex;
+      int dataType = numberOfBits <= 8? VTK_UNSIGNED_CHAR :
+        (numberOfBits <= 16? VTK_UNSIGNED_SHORT : VTK_UNSIGNED_INT);
+      quantized.TakeReference(vtkDataArray::CreateDataArray(dataType));
+      quantized->SetNumberOfComponents(array->GetNumberOfComponents());
+      quantized->SetNumberOfTuples(array->GetNumberOfTuples());
+      switch (array->GetDataType())
+        {
+        vtkTemplateMacro(vtkArrayQuantizerQuantize(
+            static_cast<VTK_TT*>(values), numberOfValues, range[0], scale,
+            maximumIndex, nanIndex, quantized));
+        }
+      parameters[NUMBER_OF_BITS] = numberOfBits;
+      parameters[OFFSET] = range[0];
+      parameters[SCALE] = scale;
+      parameters[ERROR_BOUND] = 0.5 * scale;
+      parameters[NAN_INDEX] = nanIndex;
+      }
+
+    // the parameters replace the ones of a previous quantization of the
+    // array with the same association.
+    std::string quantizationName =
+      std::string(array->GetName()) + QuantizationSuffix;
+    vtkDataArray* previous =
+      output->GetFieldData()->GetArray(quantizationName.c_str());
+    vtkSmartPointer<vtkDoubleArray> quantization =
+      vtkSmartPointer<vtkDoubleArray>::New();
+    quantization->SetName(quantizationName.c_str());
+    quantization->SetNumberOfComponents(NUMBER_OF_COMPONENTS);
+    if (previous && previous->GetNumberOfComponents() == NUMBER_OF_COMPONENTS)
+      {
+      for (vtkIdType tuple=0; tuple < previous->GetNumberOfTuples(); tuple++)
+        {
+        if (static_cast<int>(previous->GetComponent(tuple, ASSOCIATION)) !=
+          association)
+          {
+          quantization->InsertNextTuple(previous->GetTuple(tuple));
+          }
+        }
+      }
+    quantization->InsertNextTuple(parameters);
+    output->GetFieldData()->AddArray(quantization);
+
+    vtkArrayQuantizerReplace(attributes, array, quantized);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkArrayQuantizer::DecodeArrays(vtkDataSet* output)
+{
+  vtkFieldData* fieldData = output->GetFieldData();
+  size_t suffixLength = strlen(QuantizationSuffix);
+  for (int cc=0; cc < fieldData->GetNumberOfArrays(); cc++)
+    {
+    vtkDataArray* quantization = fieldData->GetArray(cc);
+    std::string name =
+      (quantization && quantization->GetName())? quantization->GetName() : "";
+    if (name.size() <= suffixLength ||
+      name.compare(name.size() - suffixLength, suffixLength,
+        QuantizationSuffix) != 0 ||
+      quantization->GetNumberOfComponents() != NUMBER_OF_COMPONENTS)
+      {
+      continue;
+      }
+    name.resize(name.size() - suffixLength);
+    for (vtkIdType tuple=0; tuple < quantization->GetNumberOfTuples(); tuple++)
+      {
+      double parameters[NUMBER_OF_COMPONENTS];
+      quantization->GetTuple(tuple, parameters);
+      vtkFieldData* attributes = vtkArrayQuantizerGetAttributes(
+        output, static_cast<int>(parameters[ASSOCIATION]));
+      vtkDataArray* array = attributes->GetArray(name.c_str());
+      if (!array)
+        {
+        continue;
+        }
+      // arrays that are not made of indices were decoded already.
+      int dataType = array->GetDataType();
+      vtkIdType numberOfValues =
+        array->GetNumberOfTuples() * array->GetNumberOfComponents();
+      vtkSmartPointer<vtkDataArray> decoded;
+      if (static_cast<int>(parameters[MODE]) == FLOAT16 &&
+        dataType == VTK_UNSIGNED_SHORT)
+        {
+        vtkFloatArray* values = vtkFloatArray::New();
+        values->SetNumberOfComponents(array->GetNumberOfComponents());
+        values->SetNumberOfTuples(array->GetNumberOfTuples());
+        vtkTypeUInt16* halves =
+          static_cast<vtkTypeUInt16*>(array->GetVoidPointer(0));
+        for (vtkIdType value=0; value < numberOfValues; value++)
+          {
+          values->SetValue(value, vtkArrayQuantizerHalfToFloat(halves[value]));
+          }
+        decoded.TakeReference(values);
+        }
+      else if (static_cast<int>(parameters[MODE]) == QUANTIZE &&
+        (dataType == VTK_UNSIGNED_CHAR || dataType == VTK_UNSIGNED_SHORT ||
+         dataType == VTK_UNSIGNED_INT))
+        {
+        vtkDoubleArray* values = vtkDoubleArray::New();
+        values->SetNumberOfComponents(array->GetNumberOfComponents());
+        values->SetNumberOfTuples(array->GetNumberOfTuples());
+        switch (dataType)
+          {
+          vtkTemplateMacro(vtkArrayQuantizerDequantize(
+              static_cast<VTK_TT*>(array->GetVoidPointer(0)), numberOfValues,
+              parameters[OFFSET], parameters[SCALE], parameters[NAN_INDEX],
+              values->GetPointer(0)));
+          }
+        decoded.TakeReference(values);
+        }
+      if (decoded)
+        {
+        vtkArrayQuantizerReplace(attributes, array, decoded);
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkArrayQuantizer::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Decode: " << this->Decode << endl;
+  vtkInternals::SettingsType::iterator iter;
+  for (iter = this->Internals->Settings.begin();
+    iter != this->Internals->Settings.end(); ++iter)
+    {
+    os << indent << "Array " << iter->first << ": ";
+    if (iter->second.Mode == FLOAT16)
+      {
+      os << "float16" << endl;
+      }
+    else if (iter->second.NumberOfBits > 0)
+      {
+      os << iter->second.NumberOfBits << " bits" << endl;
+      }
+    else
+      {
+      os << "error bound " << iter->second.ErrorBound << endl;
+      }
+    }
+}
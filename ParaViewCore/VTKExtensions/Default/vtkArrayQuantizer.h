@@ -0,0 +1,129 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkArrayQuantizer.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkArrayQuantizer - reduces the precision of point and cell arrays.
+// .SECTION Description
+// vtkArrayQuantizer replaces the point and cell arrays selected by name with
+// arrays of reduced precision, to make the files written from them smaller.
+// An array can be quantized to a number of bits, in which case each value
+// is stored as the index of the closest of 2^bits values evenly spaced over
+// the range of the array, in an unsigned char, short or int array. When the
+// array has NaNs, the largest index is reserved for them, so that 2^bits-1
+// values are used for the others and at least 2 bits are used. It can
+// also be converted to half precision floating point numbers, stored as
+// their 16 bits in an unsigned short array.
+//
+// The parameters of the conversion and the largest absolute error it causes
+// are stored in the field data, in a double array named after the quantized
+// array followed by "_Quantization". It has one tuple per quantized array
+// of that name with the components: association
+// (vtkDataObject::FIELD_ASSOCIATION_POINTS or CELLS), mode (QUANTIZE or
+// FLOAT16), number of bits, offset, scale, error bound and the index of the
+// NaNs, or -1 if there are none. The value of a quantized index q is
+// offset + q * scale. The error bound does not apply to the NaNs, which are
+// decoded as NaNs.
+//
+// When Decode is on, the filter does the opposite: it replaces the arrays
+// it quantized before with double (QUANTIZE) or float (FLOAT16) arrays,
+// e.g. after reading them from a file. The field data is kept so that
+// GetErrorBound() can report the precision of the decoded values. In
+// ParaView, the output of the reader of such files is decoded with the
+// "Decode Quantized Arrays" filter, a vtkArrayQuantizer with Decode on.
+//
+// Composite datasets are processed block by block, each with its own
+// range.
+
+#ifndef __vtkArrayQuantizer_h
+#define __vtkArrayQuantizer_h
+
+#include "vtkPVVTKExtensionsDefaultModule.h" //needed for exports
+#include "vtkPassInputTypeAlgorithm.h"
+
+class vtkDataSet;
+
+class VTKPVVTKEXTENSIONSDEFAULT_EXPORT vtkArrayQuantizer : public vtkPassInputTypeAlgorithm
+{
+public:
+  static vtkArrayQuantizer* New();
+  vtkTypeMacro(vtkArrayQuantizer, vtkPassInputTypeAlgorithm);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  enum
+    {
+    QUANTIZE = 0,
+    FLOAT16 = 1
+    };
+
+  // Description:
+  // Quantize the point and cell arrays with the given name to numberOfBits
+  // bits, between 1 and 32.
+  void SetArrayNumberOfBits(const char* name, int numberOfBits);
+
+  // Description:
+  // Quantize the point and cell arrays with the given name to the smallest
+  // number of bits for which the absolute error is at most errorBound.
+  void SetArrayErrorBound(const char* name, double errorBound);
+
+  // Description:
+  // Convert the point and cell arrays with the given name to half
+  // precision floating point numbers. Values larger than the largest half
+  // precision number, 65504, are clamped.
+  void SetArrayFloat16(const char* name);
+
+  // Description:
+  // Remove the settings of all the arrays. The arrays are then passed
+  // unchanged.
+  void RemoveAllArrays();
+
+  // Description:
+  // When on, the arrays quantized before are decoded instead, whatever
+  // the arrays set. Off by default.
+  vtkSetMacro(Decode, int);
+  vtkGetMacro(Decode, int);
+  vtkBooleanMacro(Decode, int);
+
+  // Description:
+  // Returns the largest absolute error of the values of the array with the
+  // given association and name of dataSet, or -1 if it was not quantized.
+  static double GetErrorBound(vtkDataSet* dataSet, int association,
+    const char* name);
+
+//BTX
+protected:
+  vtkArrayQuantizer();
+  ~vtkArrayQuantizer();
+
+  virtual int FillInputPortInformation(int port, vtkInformation* info);
+  virtual int RequestData(vtkInformation* request,
+                          vtkInformationVector** inputVector,
+                          vtkInformationVector* outputVector);
+
+  // Description:
+  // Quantizes or decodes the arrays of output, a shallow copy of the input.
+  void Process(vtkDataSet* output);
+  void Quantize(vtkDataSet* output, int association);
+  void DecodeArrays(vtkDataSet* output);
+
+  int Decode;
+
+private:
+  vtkArrayQuantizer(const vtkArrayQuantizer&); // Not implemented
+  void operator=(const vtkArrayQuantizer&); // Not implemented
+
+  class vtkInternals;
+  vtkInternals* Internals;
+//ETX
+};
+
+#endif
@@ -15,11 +15,13 @@
 #include "vtkPPhastaReader.h"
 
 #include "vtkCellData.h"
+#include "vtkExecutive.h"
 #include "vtkFieldData.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMultiBlockDataSet.h"
 #include "vtkMultiPieceDataSet.h"
+#include "vtkMultiProcessController.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPVXMLElement.h"
@@ -27,11 +29,13 @@
 #include "vtkPhastaReader.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTimerLog.h"
 #include "vtkUnstructuredGrid.h"
 
 #include <vtksys/SystemTools.hxx>
 
 #include <map>
+#include <string>
 #include <vtksys/ios/sstream>
 
 struct vtkPPhastaReaderInternal
@@ -52,10 +56,33 @@ struct vtkPPhastaReaderInternal
   typedef std::map<int, vtkSmartPointer<vtkUnstructuredGrid> >
   CachedGridsMapType;
   CachedGridsMapType CachedGrids;
+
+  // File name patterns of the current request.
+  std::string GeometryPattern;
+  int GeomHasPiece;
+  int GeomHasTime;
+  std::string FieldPattern;
+  int FieldHasPiece;
+  int FieldHasTime;
 };
 
+namespace
+{
+  const int VTK_PHASTA_PIECE_TAG = 983475;
+
+  // Returns the first rank of the given group when numProcs ranks are split
+  // in numGroups contiguous groups.
+  int vtkPPhastaReaderFirstRankOfGroup(int group, int numGroups, int numProcs)
+    {
+    vtkTypeInt64 rank = (static_cast<vtkTypeInt64>(group) * numProcs +
+      numGroups - 1) / numGroups;
+    return rank < numProcs? static_cast<int>(rank) : numProcs;
+    }
+}
+
 //----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkPPhastaReader);
+vtkCxxSetObjectMacro(vtkPPhastaReader, Controller, vtkMultiProcessController);
 
 //----------------------------------------------------------------------------
 vtkPPhastaReader::vtkPPhastaReader()
@@ -75,6 +102,11 @@ vtkPPhastaReader::vtkPPhastaReader()
 
   this->TimeStepRange[0] = 0;
   this->TimeStepRange[1] = 0;
+
+  this->NumberOfAggregators = 0;
+  this->IOTime = 0.0;
+  this->Controller = 0;
+  this->SetController(vtkMultiProcessController::GetGlobalController());
 }
 
 //----------------------------------------------------------------------------
@@ -89,6 +121,7 @@ vtkPPhastaReader::~vtkPPhastaReader()
     }
 
   delete this->Internal;
+  this->SetController(0);
 }
 
 //----------------------------------------------------------------------------
@@ -212,118 +245,236 @@ int vtkPPhastaReader::RequestData(vtkInformation*,
     return 0;
     }
 
-  char* geom_name = new char [ strlen(geometryPattern) + 60 ];
-  char* field_name = new char [ strlen(fieldPattern) + 60 ];
-
-  // now loop over all of the files that I should load
-  for(int loadingPiece=piece;loadingPiece<numPieces;loadingPiece+=numProcPieces)
+  this->Internal->GeometryPattern = geometryPattern;
+  this->Internal->GeomHasPiece = geomHasPiece;
+  this->Internal->GeomHasTime = geomHasTime;
+  this->Internal->FieldPattern = fieldPattern;
+  this->Internal->FieldHasPiece = fieldHasPiece;
+  this->Internal->FieldHasTime = fieldHasTime;
+
+  int numProcs = this->Controller?
+    this->Controller->GetNumberOfProcesses() : 1;
+  int myId = this->Controller? this->Controller->GetLocalProcessId() : 0;
+  int numAggregators = this->NumberOfAggregators < numProcs?
+    this->NumberOfAggregators : numProcs;
+
+  // Aggregation requires that every process requests the piece matching its
+  // rank. All processes must agree on it.
+  int aggregate = 0;
+  if (numAggregators > 0 && numProcs > 1)
     {
-    if (geomHasTime && geomHasPiece)
-      {
-      sprintf(geom_name,
-              geometryPattern,
-              this->Internal->TimeStepInfoMap[this->ActualTimeStep].GeomIndex,
-              loadingPiece+1);
-      }
-    else if (geomHasPiece)
-      {
-      sprintf(geom_name, geometryPattern, loadingPiece+1);
-      }
-    else if (geomHasTime)
-      {
-      sprintf(geom_name,
-              geometryPattern,
-              this->Internal->TimeStepInfoMap[this->ActualTimeStep].GeomIndex);
-      }
-    else
-      {
-      strcpy(geom_name, geometryPattern);
-      }
+    int canAggregate = (piece == myId && numProcPieces == numProcs)? 1 : 0;
+    this->Controller->AllReduce(&canAggregate, &aggregate, 1,
+                                vtkCommunicator::MIN_OP);
+    }
 
-    if (fieldHasTime && fieldHasPiece)
-      {
-      sprintf(field_name,
-              fieldPattern,
-              this->Internal->TimeStepInfoMap[this->ActualTimeStep].FieldIndex,
-              loadingPiece+1);
-      }
-    else if (fieldHasPiece)
-      {
-      sprintf(field_name, fieldPattern, loadingPiece+1);
-      }
-    else if (fieldHasTime)
-      {
-      sprintf(field_name,
-              fieldPattern,
-              this->Internal->TimeStepInfoMap[this->ActualTimeStep].FieldIndex);
-      }
-    else
+  // Pieces that cannot be read are left empty, and all the pieces are still
+  // processed, so that the processes waiting for them do not hang.
+  int success = 1;
+  vtkTimerLog::MarkStartEvent("vtkPPhastaReader::ReadPieces");
+  double startTime = vtkTimerLog::GetUniversalTime();
+  if (!aggregate)
+    {
+    // now loop over all of the files that I should load
+    for(int loadingPiece=piece;loadingPiece<numPieces;loadingPiece+=numProcPieces)
       {
-      strcpy(geom_name, fieldPattern);
+      vtkSmartPointer<vtkUnstructuredGrid> copy =
+        vtkSmartPointer<vtkUnstructuredGrid>::New();
+      if (!this->ReadPiece(loadingPiece, copy))
+        {
+        success = 0;
+        }
+      MultiPieceDataSet->SetPiece(loadingPiece, copy);
       }
-
-    vtksys_ios::ostringstream geomFName;
-    std::string gpath = vtksys::SystemTools::GetFilenamePath(geom_name);
-    if (gpath.empty() || !vtksys::SystemTools::FileIsFullPath(gpath.c_str()))
+    }
+  else
+    {
+    int group = static_cast<int>(
+      static_cast<vtkTypeInt64>(myId) * numAggregators / numProcs);
+    int aggregator = vtkPPhastaReaderFirstRankOfGroup(group, numAggregators,
+                                                      numProcs);
+    if (myId == aggregator)
       {
-      std::string path = vtksys::SystemTools::GetFilenamePath(this->FileName);
-      if (!path.empty())
+      // Read the pieces of all the processes of the group, in the order
+      // in which they are expecting them.
+      int groupEnd = vtkPPhastaReaderFirstRankOfGroup(group+1,
+                                                      numAggregators,
+                                                      numProcs);
+      for (int consumer=myId; consumer<groupEnd; consumer++)
         {
-        geomFName << path.c_str() << "/";
+        for (int loadingPiece=consumer; loadingPiece<numPieces;
+             loadingPiece+=numProcs)
+          {
+          vtkSmartPointer<vtkUnstructuredGrid> copy =
+            vtkSmartPointer<vtkUnstructuredGrid>::New();
+          // On failure, an empty grid is sent so that the consumer does not
+          // wait forever, after the status telling it that the read failed.
+          int status = this->ReadPiece(loadingPiece, copy);
+          if (!status)
+            {
+            success = 0;
+            }
+          if (consumer == myId)
+            {
+            MultiPieceDataSet->SetPiece(loadingPiece, copy);
+            }
+          else
+            {
+            this->Controller->Send(&status, 1, consumer, VTK_PHASTA_PIECE_TAG);
+            this->Controller->Send(copy, consumer, VTK_PHASTA_PIECE_TAG);
+            }
+          }
         }
       }
-    geomFName << geom_name << ends;
-    this->Reader->SetGeometryFileName(geomFName.str().c_str());
-
-    vtksys_ios::ostringstream fieldFName;
-    std::string fpath = vtksys::SystemTools::GetFilenamePath(field_name);
-    if (fpath.empty() || !vtksys::SystemTools::FileIsFullPath(fpath.c_str()))
+    else
       {
-      std::string path = vtksys::SystemTools::GetFilenamePath(this->FileName);
-      if (!path.empty())
+      for (int loadingPiece=myId; loadingPiece<numPieces;
+           loadingPiece+=numProcs)
         {
-        fieldFName << path.c_str() << "/";
+        vtkSmartPointer<vtkUnstructuredGrid> copy =
+          vtkSmartPointer<vtkUnstructuredGrid>::New();
+        int status = 0;
+        this->Controller->Receive(&status, 1, aggregator, VTK_PHASTA_PIECE_TAG);
+        this->Controller->Receive(copy, aggregator, VTK_PHASTA_PIECE_TAG);
+        if (!status)
+          {
+          vtkErrorMacro("Process " << aggregator << " failed to read piece "
+                        << loadingPiece);
+          success = 0;
+          }
+        MultiPieceDataSet->SetPiece(loadingPiece, copy);
         }
       }
-    fieldFName << field_name << ends;
-    this->Reader->SetFieldFileName(fieldFName.str().c_str());
+    }
+  this->IOTime = vtkTimerLog::GetUniversalTime() - startTime;
+  vtkTimerLog::MarkEndEvent("vtkPPhastaReader::ReadPieces");
+  vtkDebugMacro("Process " << myId << " got its pieces in "
+                << this->IOTime << " s");
 
-    vtkPPhastaReaderInternal::CachedGridsMapType::iterator CachedCopy =
-      this->Internal->CachedGrids.find(loadingPiece);
+  if (steps)
+    {
+    output->GetInformation()->Set(vtkDataObject::DATA_TIME_STEP(),
+                                  steps[this->ActualTimeStep]);
+    }
+
+  return success;
+}
+
+//----------------------------------------------------------------------------
+int vtkPPhastaReader::ReadPiece(int loadingPiece, vtkUnstructuredGrid* output)
+{
+  const char* geometryPattern = this->Internal->GeometryPattern.c_str();
+  const char* fieldPattern = this->Internal->FieldPattern.c_str();
+  int geomHasPiece = this->Internal->GeomHasPiece;
+  int geomHasTime = this->Internal->GeomHasTime;
+  int fieldHasPiece = this->Internal->FieldHasPiece;
+  int fieldHasTime = this->Internal->FieldHasTime;
+
+  char* geom_name = new char [ strlen(geometryPattern) + 60 ];
+  char* field_name = new char [ strlen(fieldPattern) + 60 ];
+
+  if (geomHasTime && geomHasPiece)
+    {
+    sprintf(geom_name,
+            geometryPattern,
+            this->Internal->TimeStepInfoMap[this->ActualTimeStep].GeomIndex,
+            loadingPiece+1);
+    }
+  else if (geomHasPiece)
+    {
+    sprintf(geom_name, geometryPattern, loadingPiece+1);
+    }
+  else if (geomHasTime)
+    {
+    sprintf(geom_name,
+            geometryPattern,
+            this->Internal->TimeStepInfoMap[this->ActualTimeStep].GeomIndex);
+    }
+  else
+    {
+    strcpy(geom_name, geometryPattern);
+    }
+
+  if (fieldHasTime && fieldHasPiece)
+    {
+    sprintf(field_name,
+            fieldPattern,
+            this->Internal->TimeStepInfoMap[this->ActualTimeStep].FieldIndex,
+            loadingPiece+1);
+    }
+  else if (fieldHasPiece)
+    {
+    sprintf(field_name, fieldPattern, loadingPiece+1);
+    }
+  else if (fieldHasTime)
+    {
+    sprintf(field_name,
+            fieldPattern,
+            this->Internal->TimeStepInfoMap[this->ActualTimeStep].FieldIndex);
+    }
+  else
+    {
+    strcpy(field_name, fieldPattern);
+    }
 
-    // if there is a cached copy, use that
-    if(CachedCopy != this->Internal->CachedGrids.end())
+  vtksys_ios::ostringstream geomFName;
+  std::string gpath = vtksys::SystemTools::GetFilenamePath(geom_name);
+  if (gpath.empty() || !vtksys::SystemTools::FileIsFullPath(gpath.c_str()))
+    {
+    std::string path = vtksys::SystemTools::GetFilenamePath(this->FileName);
+    if (!path.empty())
       {
-      this->Reader->SetCachedGrid(CachedCopy->second);
+      geomFName << path.c_str() << "/";
       }
+    }
+  geomFName << geom_name << ends;
+  this->Reader->SetGeometryFileName(geomFName.str().c_str());
 
-    this->Reader->Update();
-
-    if(CachedCopy == this->Internal->CachedGrids.end())
+  vtksys_ios::ostringstream fieldFName;
+  std::string fpath = vtksys::SystemTools::GetFilenamePath(field_name);
+  if (fpath.empty() || !vtksys::SystemTools::FileIsFullPath(fpath.c_str()))
+    {
+    std::string path = vtksys::SystemTools::GetFilenamePath(this->FileName);
+    if (!path.empty())
       {
-      vtkSmartPointer<vtkUnstructuredGrid> cached =
-        vtkSmartPointer<vtkUnstructuredGrid>::New();
-      cached->ShallowCopy(this->Reader->GetOutput());
-      cached->GetPointData()->Initialize();
-      cached->GetCellData()->Initialize();
-      cached->GetFieldData()->Initialize();
-      this->Internal->CachedGrids[loadingPiece] = cached;
+      fieldFName << path.c_str() << "/";
       }
-    vtkSmartPointer<vtkUnstructuredGrid> copy =
-      vtkSmartPointer<vtkUnstructuredGrid>::New();
-    copy->ShallowCopy(this->Reader->GetOutput());
-    MultiPieceDataSet->SetPiece(loadingPiece, copy);
     }
+  fieldFName << field_name << ends;
+  this->Reader->SetFieldFileName(fieldFName.str().c_str());
 
   delete [] geom_name;
   delete [] field_name;
 
-  if (steps)
+  vtkPPhastaReaderInternal::CachedGridsMapType::iterator CachedCopy =
+    this->Internal->CachedGrids.find(loadingPiece);
+
+  // if there is a cached copy, use that
+  if(CachedCopy != this->Internal->CachedGrids.end())
     {
-    output->GetInformation()->Set(vtkDataObject::DATA_TIME_STEP(),
-                                  steps[this->ActualTimeStep]);
+    this->Reader->SetCachedGrid(CachedCopy->second);
+    }
+
+  if (!this->Reader->GetExecutive()->Update())
+    {
+    vtkErrorMacro("Failed to read piece " << loadingPiece << " from "
+                  << this->Reader->GetGeometryFileName() << " and "
+                  << this->Reader->GetFieldFileName());
+    output->Initialize();
+    return 0;
     }
 
+  if(CachedCopy == this->Internal->CachedGrids.end())
+    {
+    vtkSmartPointer<vtkUnstructuredGrid> cached =
+      vtkSmartPointer<vtkUnstructuredGrid>::New();
+    cached->ShallowCopy(this->Reader->GetOutput());
+    cached->GetPointData()->Initialize();
+    cached->GetCellData()->Initialize();
+    cached->GetFieldData()->Initialize();
+    this->Internal->CachedGrids[loadingPiece] = cached;
+    }
+  output->ShallowCopy(this->Reader->GetOutput());
   return 1;
 }
 
@@ -621,5 +772,9 @@ void vtkPPhastaReader::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "TimeStepRange: "
      << this->TimeStepRange[0] << " " << this->TimeStepRange[1]
      << endl;
+  os << indent << "NumberOfAggregators: " << this->NumberOfAggregators
+     << endl;
+  os << indent << "IOTime: " << this->IOTime << endl;
+  os << indent << "Controller: " << this->Controller << endl;
 }
 
@@ -110,6 +110,14 @@
 // velocity (index 1-3 under solution)
 // temperature (index 4 under soltuion)     
 //
+//
+// By default every process reads the files of its own pieces. On large
+// numbers of processes, this can overwhelm the file system with metadata
+// requests. Reads can be aggregated with SetNumberOfAggregators(): the
+// processes are then split in groups and one process per group reads the
+// pieces of the whole group and sends the resulting grids to the other
+// processes of the group.
+//
 // .SECTION See Also
 // vtkPhastaReader
 
@@ -119,8 +127,10 @@
 #include "vtkPVVTKExtensionsDefaultModule.h" //needed for exports
 #include "vtkMultiBlockDataSetAlgorithm.h"
 
+class vtkMultiProcessController;
 class vtkPVXMLParser;
 class vtkPhastaReader;
+class vtkUnstructuredGrid;
 
 //BTX
 struct vtkPPhastaReaderInternal;
@@ -149,6 +159,28 @@ public:
 
   static int CanReadFile(const char *filename);
 
+  // Description:
+  // Set/Get the number of processes reading the Phasta files. When it is
+  // not 0, the processes are split in NumberOfAggregators contiguous groups
+  // and the first process of each group reads the pieces of all the
+  // processes of its group, then sends them the parsed grids. 0 (the
+  // default) means that every process reads its own pieces. Aggregation is
+  // only used when each process requests the piece matching its rank.
+  vtkSetClampMacro(NumberOfAggregators, int, 0, VTK_INT_MAX);
+  vtkGetMacro(NumberOfAggregators, int);
+
+  // Description:
+  // Get the time, in seconds, spent by this process to get its pieces
+  // during the last update, i.e. reading the files or waiting for its
+  // aggregator. The reading of each piece is also logged with vtkTimerLog.
+  vtkGetMacro(IOTime, double);
+
+  // Description:
+  // Set/Get the controller used to aggregate the reads. It is initialized
+  // with the global controller.
+  virtual void SetController(vtkMultiProcessController*);
+  vtkGetObjectMacro(Controller, vtkMultiProcessController);
+
 protected:
   vtkPPhastaReader();
   ~vtkPPhastaReader();
@@ -160,6 +192,11 @@ protected:
                           vtkInformationVector** inputVector,
                           vtkInformationVector* outputVector);
 
+  // Description:
+  // Read the given piece with the Phasta reader and shallow copy it in
+  // output. On failure, output is emptied and 0 is returned.
+  int ReadPiece(int piece, vtkUnstructuredGrid* output);
+
   char* FileName;
 
   int TimeStepIndex;
@@ -173,6 +210,10 @@ protected:
 
   int ActualTimeStep;
 
+  int NumberOfAggregators;
+  double IOTime;
+  vtkMultiProcessController* Controller;
+
 private:
   vtkPPhastaReaderInternal* Internal;
   
@@ -15,20 +15,31 @@
 #include "vtkPVArrayCalculator.h"
 
 #include "vtkCellData.h"
+#include "vtkDataArray.h"
 #include "vtkDataObject.h"
 #include "vtkDataSet.h"
 #include "vtkFunctionParser.h"
 #include "vtkGraph.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMultiThreader.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPVPostFilter.h"
+#include "vtkSmartPointer.h"
+#include "vtkSOADataArray.h"
+#include "vtkTimerLog.h"
 
 #include <algorithm>
 #include <assert.h>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
 #include <set>
 #include <string>
+#include <vector>
 #include <vtksys/ios/sstream>
 
 namespace
@@ -55,12 +66,1011 @@ namespace
       this->Calc->AddScalarVariable(name.c_str(), this->ArrayName, this->Component);
       }
     };
+
+  // The coordinate variables registered by UpdateArrayAndVariableNames().
+  const char* const vtkCoordinateScalarNames[3] =
+    { "coordsX", "coordsY", "coordsZ" };
+  const char* const vtkCoordinateVectorName = "coords";
+
+  // Number of tuples evaluated at once by each instruction.
+  const vtkIdType vtkCalculatorChunkSize = 1024;
+
+  // Number of tuples compared with vtkFunctionParser.
+  const vtkIdType vtkCalculatorNumberOfSamples = 32;
+
+  enum vtkCalculatorOpCode
+    {
+    VTK_CALCULATOR_LOAD,
+    VTK_CALCULATOR_CONSTANT,
+    VTK_CALCULATOR_NEGATE,
+    VTK_CALCULATOR_ADD,
+    VTK_CALCULATOR_SUBTRACT,
+    VTK_CALCULATOR_MULTIPLY,
+    VTK_CALCULATOR_DIVIDE,
+    VTK_CALCULATOR_POWER,
+    VTK_CALCULATOR_ABS,
+    VTK_CALCULATOR_EXP,
+    VTK_CALCULATOR_CEIL,
+    VTK_CALCULATOR_FLOOR,
+    VTK_CALCULATOR_LN,
+    VTK_CALCULATOR_LOG10,
+    VTK_CALCULATOR_SQRT,
+    VTK_CALCULATOR_SIN,
+    VTK_CALCULATOR_COS,
+    VTK_CALCULATOR_TAN,
+    VTK_CALCULATOR_ASIN,
+    VTK_CALCULATOR_ACOS,
+    VTK_CALCULATOR_ATAN,
+    VTK_CALCULATOR_SINH,
+    VTK_CALCULATOR_COSH,
+    VTK_CALCULATOR_TANH,
+    VTK_CALCULATOR_MAG,
+    VTK_CALCULATOR_NORM
+    };
+
+  // Functions of vtkFunctionParser supported by the compiled evaluation.
+  // mag and norm are expanded into several instructions.
+  struct vtkCalculatorFunction
+    {
+    const char* Name;
+    int OpCode;
+    };
+  const vtkCalculatorFunction vtkCalculatorFunctions[] =
+    {
+      { "abs", VTK_CALCULATOR_ABS },
+      { "exp", VTK_CALCULATOR_EXP },
+      { "ceil", VTK_CALCULATOR_CEIL },
+      { "floor", VTK_CALCULATOR_FLOOR },
+      { "ln", VTK_CALCULATOR_LN },
+      { "log10", VTK_CALCULATOR_LOG10 },
+      { "sqrt", VTK_CALCULATOR_SQRT },
+      { "sin", VTK_CALCULATOR_SIN },
+      { "cos", VTK_CALCULATOR_COS },
+      { "tan", VTK_CALCULATOR_TAN },
+      { "asin", VTK_CALCULATOR_ASIN },
+      { "acos", VTK_CALCULATOR_ACOS },
+      { "atan", VTK_CALCULATOR_ATAN },
+      { "sinh", VTK_CALCULATOR_SINH },
+      { "cosh", VTK_CALCULATOR_COSH },
+      { "tanh", VTK_CALCULATOR_TANH },
+      { "mag", VTK_CALCULATOR_MAG },
+      { "norm", VTK_CALCULATOR_NORM },
+      { NULL, 0 }
+    };
+
+  // An instruction computes one component (slot) for a chunk of tuples.
+  // Vector operations are expanded into one instruction per component, in
+  // the order in which vtkFunctionParser computes them, so both give the
+  // same bits. Each instruction has its own result slot.
+  struct vtkCalculatorInstruction
+    {
+    int OpCode;
+    int Result;
+    int A; // input index for VTK_CALCULATOR_LOAD, slot otherwise.
+    int B;
+    double Value; // for VTK_CALCULATOR_CONSTANT.
+    };
+
+  // A scalar uses one slot, a vector three.
+  struct vtkCalculatorValue
+    {
+    bool IsVector;
+    int Slots[3];
+    };
+
+  // A component of an input array, or of the point coordinates when Array
+  // is NULL. Values is the component array of vtkSOADataArray inputs, which
+  // are read without copying them to an array of tuples.
+  struct vtkCalculatorInput
+    {
+    vtkDataArray* Array;
+    const double* Values;
+    int Component;
+    int Slot; // -1 until loaded.
+    };
+
+  struct vtkCalculatorVariable
+    {
+    std::string Name;
+    std::string Token; // Name without spaces, as found in the function.
+    bool IsVector;
+    int Inputs[3];
+    bool Used;
+    };
+
+  template <class T>
+  bool vtkIsSupportedDataType(T*)
+    {
+    return true;
+    }
+
+  // Returns true for the types of vtkTemplateMacro.
+  bool vtkIsSupportedDataType(int dataType)
+    {
+    switch (dataType)
+      {
+      vtkTemplateMacro(return vtkIsSupportedDataType(static_cast<VTK_TT*>(NULL)));
+      }
+    return false;
+    }
+
+  template <class T>
+  void vtkCalculatorGather(const T* data, int numComps, int comp,
+    vtkIdType begin, vtkIdType n, double* out)
+    {
+    const T* in = data + begin * numComps + comp;
+    for (vtkIdType i = 0; i < n; i++)
+      {
+      out[i] = static_cast<double>(in[i * numComps]);
+      }
+    }
+
+  template <class T>
+  void vtkCalculatorScatter(const double* const* in, int numComps,
+    vtkIdType begin, vtkIdType n, T* data)
+    {
+    T* out = data + begin * numComps;
+    for (int k = 0; k < numComps; k++)
+      {
+      const double* component = in[k];
+      for (vtkIdType i = 0; i < n; i++)
+        {
+        out[i * numComps + k] = static_cast<T>(component[i]);
+        }
+      }
+    }
+
+  double vtkCalculatorReadInput(vtkDataSet* input,
+    const vtkCalculatorInput& in, vtkIdType id)
+    {
+    if (in.Array)
+      {
+      return in.Array->GetComponent(id, in.Component);
+      }
+    double x[3];
+    input->GetPoint(id, x);
+    return x[in.Component];
+    }
+
+  // The function compiled into instructions.
+  class vtkCalculatorProgram
+  {
+  public:
+    vtkCalculatorProgram() : NumberOfSlots(0), Position(0)
+      {
+      this->Result.IsVector = false;
+      }
+
+    // Registers the variables of the calculator. Returns false if any of
+    // them refers to an array that cannot be read directly, in which case
+    // the superclass takes care of the error (if any).
+    bool AddVariables(vtkArrayCalculator* calc, vtkDataSetAttributes* attrs,
+      bool usePointData);
+
+    // Returns false if the function uses anything the compiled evaluation
+    // does not support.
+    bool Compile(const char* function);
+
+    bool IsVectorResult() const
+      { return this->Result.IsVector; }
+
+    int GetNumberOfSlots() const
+      { return this->NumberOfSlots; }
+
+    // Evaluates tuples [begin, begin+n) into output, using slots as scratch
+    // space for GetNumberOfSlots() * vtkCalculatorChunkSize values. Returns
+    // false on invalid values, e.g. division by zero or square root of a
+    // negative number, that vtkFunctionParser may replace.
+    bool Evaluate(vtkDataSet* input, vtkIdType begin, vtkIdType n,
+      double* slots, vtkDataArray* output) const;
+
+    // Compares a few tuples of output with the results of vtkFunctionParser.
+    bool Verify(vtkArrayCalculator* calc, vtkDataSet* input,
+      vtkDataArray* output) const;
+
+  private:
+    int AddInput(vtkDataArray* array, int component);
+    int Emit(int opCode, int a, int b = -1, double value = 0.0);
+    int MatchVariable() const;
+    int MatchFunction() const;
+
+    bool ParseExpression(vtkCalculatorValue& value);
+    bool ParseTerm(vtkCalculatorValue& value);
+    bool ParseFactor(vtkCalculatorValue& value);
+    bool ParsePower(vtkCalculatorValue& value, bool& hasPower);
+    bool ParsePrimary(vtkCalculatorValue& value);
+    bool Combine(char op, const vtkCalculatorValue& a,
+      const vtkCalculatorValue& b, vtkCalculatorValue& result);
+    int EmitMagnitude(const vtkCalculatorValue& a);
+
+    std::vector<vtkCalculatorVariable> Variables;
+    std::vector<vtkCalculatorInput> Inputs;
+    std::vector<vtkCalculatorInstruction> Instructions;
+    vtkCalculatorValue Result;
+    int NumberOfSlots;
+
+    std::string Function;
+    size_t Position;
+  };
+
+  //----------------------------------------------------------------------------
+  int vtkCalculatorProgram::AddInput(vtkDataArray* array, int component)
+    {
+    for (size_t cc = 0; cc < this->Inputs.size(); cc++)
+      {
+      if (this->Inputs[cc].Array == array &&
+        this->Inputs[cc].Component == component)
+        {
+        return static_cast<int>(cc);
+        }
+      }
+    vtkCalculatorInput in;
+    in.Array = array;
+    in.Values = NULL;
+    in.Component = component;
+    // Resolved here rather than by the threads evaluating the program since
+    // GetVoidPointer() copies the values of vtkSOADataArray.
+    if (vtkSOADataArray* soa = vtkSOADataArray::SafeDownCast(array))
+      {
+      in.Values = soa->GetComponentArray(component);
+      }
+    if (array && !in.Values)
+      {
+      array->GetVoidPointer(0);
+      }
+    in.Slot = -1;
+    this->Inputs.push_back(in);
+    return static_cast<int>(this->Inputs.size()) - 1;
+    }
+
+  //----------------------------------------------------------------------------
+  bool vtkCalculatorProgram::AddVariables(vtkArrayCalculator* calc,
+    vtkDataSetAttributes* attrs, bool usePointData)
+    {
+    vtkCalculatorVariable variable;
+    variable.Used = false;
+
+    variable.IsVector = false;
+    for (int cc = 0; cc < calc->GetNumberOfScalarArrays(); cc++)
+      {
+      vtkAbstractArray* array =
+        attrs->GetAbstractArray(calc->GetScalarArrayName(cc));
+      vtkDataArray* dataArray = vtkDataArray::SafeDownCast(array);
+      int component = calc->GetSelectedScalarComponent(cc);
+      if (!dataArray || !vtkIsSupportedDataType(dataArray->GetDataType()) ||
+        component < 0 || component >= dataArray->GetNumberOfComponents())
+        {
+        return false;
+        }
+      variable.Name = calc->GetScalarVariableName(cc);
+      variable.Inputs[0] = this->AddInput(dataArray, component);
+      this->Variables.push_back(variable);
+      }
+
+    variable.IsVector = true;
+    for (int cc = 0; cc < calc->GetNumberOfVectorArrays(); cc++)
+      {
+      vtkAbstractArray* array =
+        attrs->GetAbstractArray(calc->GetVectorArrayName(cc));
+      vtkDataArray* dataArray = vtkDataArray::SafeDownCast(array);
+      int* components = calc->GetSelectedVectorComponents(cc);
+      if (!dataArray || !vtkIsSupportedDataType(dataArray->GetDataType()))
+        {
+        return false;
+        }
+      variable.Name = calc->GetVectorVariableName(cc);
+      for (int k = 0; k < 3; k++)
+        {
+        if (components[k] < 0 ||
+          components[k] >= dataArray->GetNumberOfComponents())
+          {
+          return false;
+          }
+        variable.Inputs[k] = this->AddInput(dataArray, components[k]);
+        }
+      this->Variables.push_back(variable);
+      }
+
+    // Coordinates are only available for point data.
+    if (usePointData)
+      {
+      variable.IsVector = false;
+      for (int k = 0; k < 3; k++)
+        {
+        variable.Name = vtkCoordinateScalarNames[k];
+        variable.Inputs[0] = this->AddInput(NULL, k);
+        this->Variables.push_back(variable);
+        }
+      variable.IsVector = true;
+      variable.Name = vtkCoordinateVectorName;
+      for (int k = 0; k < 3; k++)
+        {
+        variable.Inputs[k] = this->AddInput(NULL, k);
+        }
+      this->Variables.push_back(variable);
+      }
+
+    // vtkFunctionParser ignores spaces, in the function as in variable names.
+    for (size_t cc = 0; cc < this->Variables.size(); cc++)
+      {
+      std::string& token = this->Variables[cc].Token;
+      token = this->Variables[cc].Name;
+      token.erase(std::remove(token.begin(), token.end(), ' '), token.end());
+      }
+    return true;
+    }
+
+  //----------------------------------------------------------------------------
+  bool vtkCalculatorProgram::Compile(const char* function)
+    {
+    this->Function = function? function : "";
+    this->Function.erase(std::remove(this->Function.begin(),
+        this->Function.end(), ' '), this->Function.end());
+    this->Position = 0;
+    return !this->Function.empty() &&
+      this->ParseExpression(this->Result) &&
+      this->Position == this->Function.size();
+    }
+
+  //----------------------------------------------------------------------------
+  int vtkCalculatorProgram::Emit(int opCode, int a, int b, double value)
+    {
+    vtkCalculatorInstruction instruction;
+    instruction.OpCode = opCode;
+    instruction.Result = this->NumberOfSlots++;
+    instruction.A = a;
+    instruction.B = b;
+    instruction.Value = value;
+    this->Instructions.push_back(instruction);
+    return instruction.Result;
+    }
+
+  //----------------------------------------------------------------------------
+  // Returns the variable with the longest name at Position, or -1.
+  int vtkCalculatorProgram::MatchVariable() const
+    {
+    int match = -1;
+    size_t length = 0;
+    for (size_t cc = 0; cc < this->Variables.size(); cc++)
+      {
+      const std::string& token = this->Variables[cc].Token;
+      if (token.size() > length &&
+        this->Function.compare(this->Position, token.size(), token) == 0)
+        {
+        match = static_cast<int>(cc);
+        length = token.size();
+        }
+      }
+    return match;
+    }
+
+  //----------------------------------------------------------------------------
+  // Returns the function called at Position, or -1.
+  int vtkCalculatorProgram::MatchFunction() const
+    {
+    for (int cc = 0; vtkCalculatorFunctions[cc].Name; cc++)
+      {
+      size_t length = strlen(vtkCalculatorFunctions[cc].Name);
+      if (this->Function.compare(this->Position, length,
+          vtkCalculatorFunctions[cc].Name) == 0 &&
+        this->Position + length < this->Function.size() &&
+        this->Function[this->Position + length] == '(')
+        {
+        return cc;
+        }
+      }
+    return -1;
+    }
+
+  //----------------------------------------------------------------------------
+  bool vtkCalculatorProgram::ParseExpression(vtkCalculatorValue& value)
+    {
+    if (!this->ParseTerm(value))
+      {
+      return false;
+      }
+    while (this->Position < this->Function.size() &&
+      (this->Function[this->Position] == '+' ||
+       this->Function[this->Position] == '-'))
+      {
+      char op = this->Function[this->Position++];
+      vtkCalculatorValue right;
+      if (!this->ParseTerm(right) || !this->Combine(op, value, right, value))
+        {
+        return false;
+        }
+      }
+    return true;
+    }
+
+  //----------------------------------------------------------------------------
+  bool vtkCalculatorProgram::ParseTerm(vtkCalculatorValue& value)
+    {
+    if (!this->ParseFactor(value))
+      {
+      return false;
+      }
+    int numberOfFactors = 1;
+    bool hasDot = false;
+    while (this->Position < this->Function.size() &&
+      strchr("*/.", this->Function[this->Position]))
+      {
+      char op = this->Function[this->Position++];
+      hasDot = hasDot || op == '.';
+      numberOfFactors++;
+      // The precedence of the dot product relative to * and / is not
+      // obvious, leave such terms to vtkFunctionParser.
+      if (hasDot && numberOfFactors > 2)
+        {
+        return false;
+        }
+      vtkCalculatorValue right;
+      if (!this->ParseFactor(right) || !this->Combine(op, value, right, value))
+        {
+        return false;
+        }
+      }
+    return true;
+    }
+
+  //----------------------------------------------------------------------------
+  bool vtkCalculatorProgram::ParseFactor(vtkCalculatorValue& value)
+    {
+    if (this->Position < this->Function.size() &&
+      this->Function[this->Position] == '-')
+      {
+      this->Position++;
+      if (this->Position < this->Function.size() &&
+        this->Function[this->Position] == '-')
+        {
+        if (!this->ParseFactor(value))
+          {
+          return false;
+          }
+        }
+      else
+        {
+        // -a^b is ambiguous, leave it to vtkFunctionParser.
+        bool hasPower = false;
+        if (!this->ParsePower(value, hasPower) || hasPower)
+          {
+          return false;
+          }
+        }
+      int numberOfComponents = value.IsVector? 3 : 1;
+      for (int k = 0; k < numberOfComponents; k++)
+        {
+        value.Slots[k] = this->Emit(VTK_CALCULATOR_NEGATE, value.Slots[k]);
+        }
+      return true;
+      }
+    bool hasPower = false;
+    return this->ParsePower(value, hasPower);
+    }
+
+  //----------------------------------------------------------------------------
+  bool vtkCalculatorProgram::ParsePower(vtkCalculatorValue& value,
+    bool& hasPower)
+    {
+    if (!this->ParsePrimary(value))
+      {
+      return false;
+      }
+    hasPower = false;
+    if (this->Position < this->Function.size() &&
+      this->Function[this->Position] == '^')
+      {
+      this->Position++;
+      hasPower = true;
+      vtkCalculatorValue exponent;
+      if (!this->ParsePrimary(exponent) ||
+        !this->Combine('^', value, exponent, value))
+        {
+        return false;
+        }
+      // a^b^c is ambiguous as well.
+      if (this->Position < this->Function.size() &&
+        this->Function[this->Position] == '^')
+        {
+        return false;
+        }
+      }
+    return true;
+    }
+
+  //----------------------------------------------------------------------------
+  bool vtkCalculatorProgram::ParsePrimary(vtkCalculatorValue& value)
+    {
+    if (this->Position >= this->Function.size())
+      {
+      return false;
+      }
+    const char* start = this->Function.c_str() + this->Position;
+    if (isdigit(start[0]) || (start[0] == '.' && isdigit(start[1])))
+      {
+      char* end;
+      double constant = strtod(start, &end);
+      this->Position += end - start;
+      value.IsVector = false;
+      value.Slots[0] = this->Emit(VTK_CALCULATOR_CONSTANT, -1, -1, constant);
+      return true;
+      }
+
+    if (start[0] == '(')
+      {
+      this->Position++;
+      if (!this->ParseExpression(value) ||
+        this->Position >= this->Function.size() ||
+        this->Function[this->Position] != ')')
+        {
+        return false;
+        }
+      this->Position++;
+      return true;
+      }
+
+    // A function call takes precedence over a variable whose name starts
+    // with the function name, unless the variable name is longer. Names that
+    // could be read either way are left to vtkFunctionParser.
+    int variable = this->MatchVariable();
+    int function = this->MatchFunction();
+    bool unitVector = (start[0] == 'i' || start[0] == 'j' ||
+      start[0] == 'k') && strncmp(start + 1, "Hat", 3) == 0;
+    if (function >= 0 && variable >= 0)
+      {
+      if (this->Variables[variable].Token.size() >
+        strlen(vtkCalculatorFunctions[function].Name))
+        {
+        return false;
+        }
+      variable = -1;
+      }
+    if (unitVector && variable >= 0)
+      {
+      return false;
+      }
+    if (variable < 0 && function < 0 && !unitVector)
+      {
+      return false;
+      }
+
+    if (variable >= 0)
+      {
+      vtkCalculatorVariable& var = this->Variables[variable];
+      var.Used = true;
+      value.IsVector = var.IsVector;
+      int numberOfComponents = var.IsVector? 3 : 1;
+      for (int k = 0; k < numberOfComponents; k++)
+        {
+        vtkCalculatorInput& in = this->Inputs[var.Inputs[k]];
+        if (in.Slot < 0)
+          {
+          in.Slot = this->Emit(VTK_CALCULATOR_LOAD, var.Inputs[k]);
+          }
+        value.Slots[k] = in.Slot;
+        }
+      this->Position += var.Token.size();
+      return true;
+      }
+
+    if (unitVector)
+      {
+      value.IsVector = true;
+      for (int k = 0; k < 3; k++)
+        {
+        value.Slots[k] = this->Emit(VTK_CALCULATOR_CONSTANT, -1, -1,
+          k == start[0] - 'i'? 1.0 : 0.0);
+        }
+      this->Position += 4;
+      return true;
+      }
+
+    // function(argument); Position is moved on the parenthesis.
+    this->Position += strlen(vtkCalculatorFunctions[function].Name);
+    vtkCalculatorValue argument;
+    if (!this->ParsePrimary(argument))
+      {
+      return false;
+      }
+    int opCode = vtkCalculatorFunctions[function].OpCode;
+    if (opCode == VTK_CALCULATOR_MAG || opCode == VTK_CALCULATOR_NORM)
+      {
+      if (!argument.IsVector)
+        {
+        return false;
+        }
+      int magnitude = this->EmitMagnitude(argument);
+      if (opCode == VTK_CALCULATOR_MAG)
+        {
+        value.IsVector = false;
+        value.Slots[0] = magnitude;
+        return true;
+        }
+      value.IsVector = true;
+      for (int k = 0; k < 3; k++)
+        {
+        value.Slots[k] = this->Emit(VTK_CALCULATOR_DIVIDE,
+          argument.Slots[k], magnitude);
+        }
+      return true;
+      }
+    if (argument.IsVector)
+      {
+      return false;
+      }
+    value.IsVector = false;
+    value.Slots[0] = this->Emit(opCode, argument.Slots[0]);
+    return true;
+    }
+
+  //----------------------------------------------------------------------------
+  // sqrt(x*x + y*y + z*z), as vtkMath::Norm().
+  int vtkCalculatorProgram::EmitMagnitude(const vtkCalculatorValue& a)
+    {
+    int xx = this->Emit(VTK_CALCULATOR_MULTIPLY, a.Slots[0], a.Slots[0]);
+    int yy = this->Emit(VTK_CALCULATOR_MULTIPLY, a.Slots[1], a.Slots[1]);
+    int sum = this->Emit(VTK_CALCULATOR_ADD, xx, yy);
+    int zz = this->Emit(VTK_CALCULATOR_MULTIPLY, a.Slots[2], a.Slots[2]);
+    sum = this->Emit(VTK_CALCULATOR_ADD, sum, zz);
+    return this->Emit(VTK_CALCULATOR_SQRT, sum);
+    }
+
+  //----------------------------------------------------------------------------
+  bool vtkCalculatorProgram::Combine(char op, const vtkCalculatorValue& a,
+    const vtkCalculatorValue& b, vtkCalculatorValue& result)
+    {
+    vtkCalculatorValue value;
+    switch (op)
+      {
+      case '+':
+      case '-':
+        if (a.IsVector != b.IsVector)
+          {
+          return false;
+          }
+        value.IsVector = a.IsVector;
+        for (int k = 0; k < (a.IsVector? 3 : 1); k++)
+          {
+          value.Slots[k] = this->Emit(op == '+'?
+            VTK_CALCULATOR_ADD : VTK_CALCULATOR_SUBTRACT,
+            a.Slots[k], b.Slots[k]);
+          }
+        break;
+
+      case '*':
+        if (a.IsVector && b.IsVector)
+          {
+          return false;
+          }
+        value.IsVector = a.IsVector || b.IsVector;
+        for (int k = 0; k < (value.IsVector? 3 : 1); k++)
+          {
+          value.Slots[k] = this->Emit(VTK_CALCULATOR_MULTIPLY,
+            a.Slots[a.IsVector? k : 0], b.Slots[b.IsVector? k : 0]);
+          }
+        break;
+
+      case '/':
+        if (b.IsVector)
+          {
+          return false;
+          }
+        value.IsVector = a.IsVector;
+        for (int k = 0; k < (a.IsVector? 3 : 1); k++)
+          {
+          value.Slots[k] = this->Emit(VTK_CALCULATOR_DIVIDE,
+            a.Slots[k], b.Slots[0]);
+          }
+        break;
+
+      case '.':
+        {
+        if (!a.IsVector || !b.IsVector)
+          {
+          return false;
+          }
+        // x0*y0 + x1*y1 + x2*y2, as vtkMath::Dot().
+        int xy0 = this->Emit(VTK_CALCULATOR_MULTIPLY, a.Slots[0], b.Slots[0]);
+        int xy1 = this->Emit(VTK_CALCULATOR_MULTIPLY, a.Slots[1], b.Slots[1]);
+        int sum = this->Emit(VTK_CALCULATOR_ADD, xy0, xy1);
+        int xy2 = this->Emit(VTK_CALCULATOR_MULTIPLY, a.Slots[2], b.Slots[2]);
+        value.IsVector = false;
+        value.Slots[0] = this->Emit(VTK_CALCULATOR_ADD, sum, xy2);
+        }
+        break;
+
+      case '^':
+        if (a.IsVector || b.IsVector)
+          {
+          return false;
+          }
+        value.IsVector = false;
+        value.Slots[0] = this->Emit(VTK_CALCULATOR_POWER,
+          a.Slots[0], b.Slots[0]);
+        break;
+
+      default:
+        return false;
+      }
+    result = value;
+    return true;
+    }
+
+#define vtkCalculatorUnaryCase(opCode, expression) \
+  case opCode: \
+    for (vtkIdType i = 0; i < n; i++) \
+      { \
+      r[i] = expression; \
+      } \
+    break;
+
+#define vtkCalculatorBinaryCase(opCode, op) \
+  case opCode: \
+    for (vtkIdType i = 0; i < n; i++) \
+      { \
+      r[i] = a[i] op b[i]; \
+      } \
+    break;
+
+  //----------------------------------------------------------------------------
+  bool vtkCalculatorProgram::Evaluate(vtkDataSet* input, vtkIdType begin,
+    vtkIdType n, double* slots, vtkDataArray* output) const
+    {
+    for (size_t cc = 0; cc < this->Instructions.size(); cc++)
+      {
+      const vtkCalculatorInstruction& instruction = this->Instructions[cc];
+      double* r = slots + instruction.Result * vtkCalculatorChunkSize;
+      const double* a = instruction.A < 0? NULL :
+        slots + instruction.A * vtkCalculatorChunkSize;
+      const double* b = instruction.B < 0? NULL :
+        slots + instruction.B * vtkCalculatorChunkSize;
+
+      // Invalid values are detected before computing anything, so that the
+      // loops below stay simple enough to be vectorized.
+      bool invalid = false;
+      switch (instruction.OpCode)
+        {
+        case VTK_CALCULATOR_DIVIDE:
+          for (vtkIdType i = 0; i < n; i++)
+            {
+            invalid |= (b[i] == 0.0);
+            }
+          break;
+        case VTK_CALCULATOR_POWER:
+          // negative base with a fractional exponent.
+          for (vtkIdType i = 0; i < n; i++)
+            {
+            invalid |= (a[i] < 0.0 && b[i] != floor(b[i]));
+            }
+          break;
+        case VTK_CALCULATOR_LN:
+        case VTK_CALCULATOR_LOG10:
+          for (vtkIdType i = 0; i < n; i++)
+            {
+            invalid |= (a[i] <= 0.0);
+            }
+          break;
+        case VTK_CALCULATOR_SQRT:
+          for (vtkIdType i = 0; i < n; i++)
+            {
+            invalid |= (a[i] < 0.0);
+            }
+          break;
+        case VTK_CALCULATOR_ASIN:
+        case VTK_CALCULATOR_ACOS:
+          for (vtkIdType i = 0; i < n; i++)
+            {
+            invalid |= (a[i] < -1.0 || a[i] > 1.0);
+            }
+          break;
+        }
+      if (invalid)
+        {
+        return false;
+        }
+
+      switch (instruction.OpCode)
+        {
+        case VTK_CALCULATOR_LOAD:
+          {
+          const vtkCalculatorInput& in = this->Inputs[instruction.A];
+          if (in.Values)
+            {
+            std::copy(in.Values + begin, in.Values + begin + n, r);
+            }
+          else if (in.Array)
+            {
+            switch (in.Array->GetDataType())
+              {
+              vtkTemplateMacro(vtkCalculatorGather(
+                  static_cast<VTK_TT*>(in.Array->GetVoidPointer(0)),
+                  in.Array->GetNumberOfComponents(), in.Component,
+                  begin, n, r));
+              }
+            }
+          else
+            {
+            for (vtkIdType i = 0; i < n; i++)
+              {
+              double x[3];
+              input->GetPoint(begin + i, x);
+              r[i] = x[in.Component];
+              }
+            }
+          }
+          break;
+        case VTK_CALCULATOR_CONSTANT:
+          std::fill(r, r + n, instruction.Value);
+          break;
+        vtkCalculatorUnaryCase(VTK_CALCULATOR_NEGATE, -a[i]);
+        vtkCalculatorBinaryCase(VTK_CALCULATOR_ADD, +);
+        vtkCalculatorBinaryCase(VTK_CALCULATOR_SUBTRACT, -);
+        vtkCalculatorBinaryCase(VTK_CALCULATOR_MULTIPLY, *);
+        vtkCalculatorBinaryCase(VTK_CALCULATOR_DIVIDE, /);
+        vtkCalculatorUnaryCase(VTK_CALCULATOR_POWER, pow(a[i], b[i]));
+        vtkCalculatorUnaryCase(VTK_CALCULATOR_ABS, fabs(a[i]));
+        vtkCalculatorUnaryCase(VTK_CALCULATOR_EXP, exp(a[i]));
+        vtkCalculatorUnaryCase(VTK_CALCULATOR_CEIL, ceil(a[i]));
+        vtkCalculatorUnaryCase(VTK_CALCULATOR_FLOOR, floor(a[i]));
+        vtkCalculatorUnaryCase(VTK_CALCULATOR_LN, log(a[i]));
+        vtkCalculatorUnaryCase(VTK_CALCULATOR_LOG10, log10(a[i]));
+        vtkCalculatorUnaryCase(VTK_CALCULATOR_SQRT, sqrt(a[i]));
+        vtkCalculatorUnaryCase(VTK_CALCULATOR_SIN, sin(a[i]));
+        vtkCalculatorUnaryCase(VTK_CALCULATOR_COS, cos(a[i]));
+        vtkCalculatorUnaryCase(VTK_CALCULATOR_TAN, tan(a[i]));
+        vtkCalculatorUnaryCase(VTK_CALCULATOR_ASIN, asin(a[i]));
+        vtkCalculatorUnaryCase(VTK_CALCULATOR_ACOS, acos(a[i]));
+        vtkCalculatorUnaryCase(VTK_CALCULATOR_ATAN, atan(a[i]));
+        vtkCalculatorUnaryCase(VTK_CALCULATOR_SINH, sinh(a[i]));
+        vtkCalculatorUnaryCase(VTK_CALCULATOR_COSH, cosh(a[i]));
+        vtkCalculatorUnaryCase(VTK_CALCULATOR_TANH, tanh(a[i]));
+        default:
+          return false;
+        }
+      }
+
+    const double* results[3];
+    int numComps = output->GetNumberOfComponents();
+    for (int k = 0; k < numComps; k++)
+      {
+      results[k] = slots + this->Result.Slots[k] * vtkCalculatorChunkSize;
+      }
+    switch (output->GetDataType())
+      {
+      vtkTemplateMacro(vtkCalculatorScatter(results, numComps, begin, n,
+          static_cast<VTK_TT*>(output->GetVoidPointer(0))));
+      default:
+        return false;
+      }
+    return true;
+    }
+
+#undef vtkCalculatorUnaryCase
+#undef vtkCalculatorBinaryCase
+
+  //----------------------------------------------------------------------------
+  bool vtkCalculatorProgram::Verify(vtkArrayCalculator* calc,
+    vtkDataSet* input, vtkDataArray* output) const
+    {
+    vtkNew<vtkFunctionParser> parser;
+    parser->SetFunction(calc->GetFunction());
+    parser->SetReplaceInvalidValues(calc->GetReplaceInvalidValues());
+    parser->SetReplacementValue(calc->GetReplacementValue());
+
+    // The expected results are stored in an array of the output type, so
+    // that they are converted the same way.
+    int numComps = output->GetNumberOfComponents();
+    vtkSmartPointer<vtkDataArray> expected;
+    expected.TakeReference(
+      vtkDataArray::CreateDataArray(output->GetDataType()));
+    expected->SetNumberOfComponents(numComps);
+    expected->SetNumberOfTuples(1);
+
+    vtkIdType numTuples = output->GetNumberOfTuples();
+    vtkIdType numSamples = std::min(numTuples, vtkCalculatorNumberOfSamples);
+    for (vtkIdType sample = 0; sample < numSamples; sample++)
+      {
+      vtkIdType id = numSamples > 1?
+        sample * (numTuples - 1) / (numSamples - 1) : 0;
+      for (size_t cc = 0; cc < this->Variables.size(); cc++)
+        {
+        const vtkCalculatorVariable& var = this->Variables[cc];
+        if (!var.Used)
+          {
+          continue;
+          }
+        double v[3];
+        for (int k = 0; k < (var.IsVector? 3 : 1); k++)
+          {
+          v[k] = vtkCalculatorReadInput(input, this->Inputs[var.Inputs[k]], id);
+          }
+        if (var.IsVector)
+          {
+          parser->SetVectorVariableValue(var.Name.c_str(), v[0], v[1], v[2]);
+          }
+        else
+          {
+          parser->SetScalarVariableValue(var.Name.c_str(), v[0]);
+          }
+        }
+
+      if (this->Result.IsVector)
+        {
+        if (!parser->IsVectorResult())
+          {
+          return false;
+          }
+        expected->SetTuple(0, parser->GetVectorResult());
+        }
+      else
+        {
+        if (!parser->IsScalarResult())
+          {
+          return false;
+          }
+        expected->SetTuple1(0, parser->GetScalarResult());
+        }
+
+      double expectedTuple[3];
+      double tuple[3];
+      expected->GetTuple(0, expectedTuple);
+      output->GetTuple(id, tuple);
+      if (memcmp(expectedTuple, tuple, numComps * sizeof(double)) != 0)
+        {
+        return false;
+        }
+      }
+    return true;
+    }
+
+  //----------------------------------------------------------------------------
+  struct vtkCalculatorWork
+    {
+    const vtkCalculatorProgram* Program;
+    vtkDataSet* Input;
+    vtkDataArray* Output;
+    vtkIdType NumberOfTuples;
+    std::vector<int> Valid; // per thread.
+    };
+
+  // Evaluates every NumberOfThreads-th chunk, starting at chunk ThreadID.
+  void vtkCalculatorEvaluateChunks(vtkCalculatorWork* work, int threadId,
+    int numberOfThreads)
+    {
+    std::vector<double> slots(
+      work->Program->GetNumberOfSlots() * vtkCalculatorChunkSize);
+    for (vtkIdType begin = threadId * vtkCalculatorChunkSize;
+      begin < work->NumberOfTuples;
+      begin += numberOfThreads * vtkCalculatorChunkSize)
+      {
+      vtkIdType n = std::min(vtkCalculatorChunkSize,
+        work->NumberOfTuples - begin);
+      if (!work->Program->Evaluate(work->Input, begin, n, &slots[0],
+          work->Output))
+        {
+        work->Valid[threadId] = 0;
+        return;
+        }
+      }
+    }
+
+  VTK_THREAD_RETURN_TYPE vtkCalculatorThread(void* arg)
+    {
+    vtkMultiThreader::ThreadInfo* threadInfo =
+      static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+    vtkCalculatorEvaluateChunks(
+      static_cast<vtkCalculatorWork*>(threadInfo->UserData),
+      threadInfo->ThreadID, threadInfo->NumberOfThreads);
+    return VTK_THREAD_RETURN_VALUE;
+    }
 }
 
 vtkStandardNewMacro( vtkPVArrayCalculator );
 // ----------------------------------------------------------------------------
 vtkPVArrayCalculator::vtkPVArrayCalculator()
 {
+  this->UseCompiledExpression = 1;
+  this->UsedCompiledExpression = 0;
 }
 
 // ----------------------------------------------------------------------------
@@ -84,10 +1094,10 @@ void vtkPVArrayCalculator::UpdateArrayAndVariableNames
   this->RemoveAllVariables();
   
   // Add coordinate scalar and vector variables
-  this->AddCoordinateScalarVariable( "coordsX", 0 );
-  this->AddCoordinateScalarVariable( "coordsY", 1 );
-  this->AddCoordinateScalarVariable( "coordsZ", 2 );
-  this->AddCoordinateVectorVariable( "coords",  0, 1, 2 );
+  this->AddCoordinateScalarVariable( vtkCoordinateScalarNames[0], 0 );
+  this->AddCoordinateScalarVariable( vtkCoordinateScalarNames[1], 1 );
+  this->AddCoordinateScalarVariable( vtkCoordinateScalarNames[2], 2 );
+  this->AddCoordinateVectorVariable( vtkCoordinateVectorName,  0, 1, 2 );
   
   // add non-coordinate scalar and vector variables
   int numberArays = inDataAttrs->GetNumberOfArrays(); // the input
@@ -149,6 +1159,7 @@ int vtkPVArrayCalculator::RequestData
   vtkGraph   * graphInput = vtkGraph::SafeDownCast( input );
   vtkDataSet * dsInput    = vtkDataSet::SafeDownCast( input );
   vtkDataSetAttributes *  dataAttrs = NULL;
+  this->UsedCompiledExpression = 0;
  
   if ( dsInput )
     {
@@ -188,6 +1199,17 @@ int vtkPVArrayCalculator::RequestData
     // put is the input of a (some) subsequent calculator(s) or the user changes
     // the input of a downstream calculator.
     this->UpdateArrayAndVariableNames( input, dataAttrs );
+
+    vtkDataSet * dsOutput = vtkDataSet::SafeDownCast(
+      outputVector->GetInformationObject( 0 )
+      ->Get( vtkDataObject::DATA_OBJECT() ) );
+    if ( this->UseCompiledExpression && dsInput && dsOutput &&
+         this->ExecuteCompiledExpression( dsInput, dsOutput, dataAttrs,
+                                          numTuples ) )
+      {
+      this->UsedCompiledExpression = 1;
+      return 1;
+      }
     }
   
   input      = NULL;
@@ -198,8 +1220,95 @@ int vtkPVArrayCalculator::RequestData
   return this->Superclass::RequestData( request, inputVector, outputVector );
 }
 
+// ----------------------------------------------------------------------------
+int vtkPVArrayCalculator::ExecuteCompiledExpression
+  ( vtkDataSet * input, vtkDataSet * output, vtkDataSetAttributes * inDataAttrs,
+    vtkIdType numTuples )
+{
+  // Results used as point coordinates are left to the superclass.
+  if ( this->CoordinateResults ||
+       !vtkIsSupportedDataType( this->ResultArrayType ) )
+    {
+    return 0;
+    }
+
+  bool usePointData = ( inDataAttrs == input->GetPointData() );
+  vtkCalculatorProgram program;
+  if ( !program.AddVariables( this, inDataAttrs, usePointData ) ||
+       !program.Compile( this->Function ) )
+    {
+    return 0;
+    }
+
+  vtkSmartPointer<vtkDataArray> resultArray;
+  resultArray.TakeReference(
+    vtkDataArray::CreateDataArray( this->ResultArrayType ) );
+  resultArray->SetNumberOfComponents( program.IsVectorResult()? 3 : 1 );
+  resultArray->SetNumberOfTuples( numTuples );
+  resultArray->SetName( this->ResultArrayName );
+
+  vtkTimerLog::MarkStartEvent( "Evaluate compiled expression" );
+  vtkCalculatorWork work;
+  work.Program = &program;
+  work.Input = input;
+  work.Output = resultArray;
+  work.NumberOfTuples = numTuples;
+
+  vtkIdType numChunks =
+    ( numTuples + vtkCalculatorChunkSize - 1 ) / vtkCalculatorChunkSize;
+  int numberOfThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  numberOfThreads = static_cast<int>(
+    std::min( static_cast<vtkIdType>( numberOfThreads ), numChunks ) );
+  work.Valid.resize( numberOfThreads, 1 );
+  if ( numberOfThreads > 1 )
+    {
+    vtkNew<vtkMultiThreader> threader;
+    threader->SetNumberOfThreads( numberOfThreads );
+    threader->SetSingleMethod( vtkCalculatorThread, &work );
+    threader->SingleMethodExecute();
+    }
+  else
+    {
+    vtkCalculatorEvaluateChunks( &work, 0, 1 );
+    }
+
+  bool valid = std::count( work.Valid.begin(), work.Valid.end(), 0 ) == 0 &&
+    program.Verify( this, input, resultArray );
+  vtkTimerLog::MarkEndEvent( "Evaluate compiled expression" );
+  if ( !valid )
+    {
+    vtkDebugMacro( "Falling back to vtkFunctionParser for " << this->Function );
+    return 0;
+    }
+
+  output->ShallowCopy( input );
+  vtkDataSetAttributes * outDataAttrs = usePointData?
+    static_cast<vtkDataSetAttributes *>( output->GetPointData() ) :
+    static_cast<vtkDataSetAttributes *>( output->GetCellData() );
+  // The result is set as the superclass does.
+  if ( program.IsVectorResult() && this->ResultNormals )
+    {
+    outDataAttrs->SetNormals( resultArray );
+    }
+  else if ( this->ResultTCoords )
+    {
+    outDataAttrs->SetTCoords( resultArray );
+    }
+  else
+    {
+    int idx = outDataAttrs->AddArray( resultArray );
+    outDataAttrs->SetActiveAttribute( idx, program.IsVectorResult()?
+      vtkDataSetAttributes::VECTORS : vtkDataSetAttributes::SCALARS );
+    }
+  return 1;
+}
+
 // ----------------------------------------------------------------------------
 void vtkPVArrayCalculator::PrintSelf( ostream & os, vtkIndent indent )
 {
   this->Superclass::PrintSelf( os, indent );
+  os << indent << "UseCompiledExpression: " << this->UseCompiledExpression
+     << endl;
+  os << indent << "UsedCompiledExpression: " << this->UsedCompiledExpression
+     << endl;
 }
@@ -22,6 +22,13 @@
 //  their mapping with the input fields. We extend vtkArrayCalculator to
 //  automatically add scalar/vector fields mapping using the array available in
 //  the input.
+//
+//  Unless UseCompiledExpression is off, the function is compiled into a
+//  sequence of instructions that are evaluated over chunks of tuples, on
+//  multiple threads. Functions (or inputs) that the compiled evaluation does
+//  not support, invalid values (e.g. division by zero) and results that
+//  differ from those of vtkFunctionParser make the filter fall back to the
+//  superclass implementation.
 // .SECTION See Also
 //  vtkArrayCalculator vtkFunctionParser
 
@@ -32,6 +39,7 @@
 #include "vtkArrayCalculator.h"
 
 class vtkDataObject;
+class vtkDataSet;
 class vtkDataSetAttributes;
 
 class VTKPVVTKEXTENSIONSDEFAULT_EXPORT vtkPVArrayCalculator : public vtkArrayCalculator
@@ -42,6 +50,19 @@ public:
 
   static vtkPVArrayCalculator * New();
 
+  // Description:
+  // When on, the function is compiled and evaluated over whole arrays instead
+  // of being evaluated tuple by tuple by vtkFunctionParser. The results are
+  // identical. Default is on.
+  vtkSetMacro(UseCompiledExpression, int);
+  vtkGetMacro(UseCompiledExpression, int);
+  vtkBooleanMacro(UseCompiledExpression, int);
+
+  // Description:
+  // Returns 1 if the last execution used the compiled function, 0 if it
+  // fell back to vtkFunctionParser.
+  vtkGetMacro(UsedCompiledExpression, int);
+
 protected:
   vtkPVArrayCalculator();
   ~vtkPVArrayCalculator();
@@ -59,6 +80,21 @@ protected:
   // RequestData() only.
   void    UpdateArrayAndVariableNames( vtkDataObject        * theInputObj, 
                                        vtkDataSetAttributes * inDataAttrs );
+
+  // Description:
+  // Computes the result array with the compiled function and adds it to
+  // output. Returns 0 without changing output if the function cannot be
+  // compiled or evaluated that way, in which case the superclass must be
+  // used. This function should be called by RequestData() only, after
+  // UpdateArrayAndVariableNames().
+  int     ExecuteCompiledExpression( vtkDataSet           * input,
+                                     vtkDataSet           * output,
+                                     vtkDataSetAttributes * inDataAttrs,
+                                     vtkIdType              numTuples );
+
+  int UseCompiledExpression;
+  int UsedCompiledExpression;
+
 private:
   vtkPVArrayCalculator( const vtkPVArrayCalculator & ); // Not implemented.
   void operator = ( const vtkPVArrayCalculator & );     // Not implemented.
@@ -297,6 +297,12 @@ void vtkPhastaReader::openfile( const char filename[],
   if ( cscompare( "read", imode ) ) 
     {
     file = fopen(fname, "rb" );
+    // The headers and data blocks are read with many small freads, use a
+    // large buffer so that the file system sees large contiguous reads.
+    if ( file )
+      {
+      setvbuf( file, NULL, _IOFBF, 4*1024*1024 );
+      }
     }
   else if( cscompare( "write", imode ) ) 
     {
@@ -552,22 +558,32 @@ int vtkPhastaReader::RequestData(vtkInformation*,
     vtkDebugMacro(<< "Field File : " << this->FieldFileName);
     
     fvn = firstVertexNo;
-    this->ReadGeomFile(this->GeometryFileName, firstVertexNo, points, noOfNodes, noOfCells);
+    int geomRead = this->ReadGeomFile(this->GeometryFileName, firstVertexNo,
+                                      points, noOfNodes, noOfCells);
     /* set the points over here, this is because vtkUnStructuredGrid 
        only insert points once, next insertion overwrites the previous one */
     // acbauer is not sure why the above comment is about...
     output->SetPoints(points);
     points->Delete();    
+    if (!geomRead)
+      {
+      return 0;
+      }
     }
 
+  int fieldRead;
   if (!this->Internal->FieldInfoMap.size())
     {
     vtkDataSetAttributes* field = output->GetPointData();
-    this->ReadFieldFile(this->FieldFileName, fvn, field, noOfNodes);
+    fieldRead = this->ReadFieldFile(this->FieldFileName, fvn, field, noOfNodes);
     }
   else
     {
-    this->ReadFieldFile(this->FieldFileName, fvn, output, noOfDatas);
+    fieldRead = this->ReadFieldFile(this->FieldFileName, fvn, output, noOfDatas);
+    }
+  if (!fieldRead)
+    {
+    return 0;
     }
 
   // if there exists point arrays called coordsX, coordsY and coordsZ,
@@ -606,7 +622,7 @@ int vtkPhastaReader::RequestData(vtkInformation*,
    them into one, ReadGeomfile can then be called repeatedly from Execute with 
    firstVertexNo forming consecutive series of vertex numbers */
 
-void vtkPhastaReader::ReadGeomFile(char* geomFileName,
+int vtkPhastaReader::ReadGeomFile(char* geomFileName,
                                    int &firstVertexNo,
                                    vtkPoints *points,
                                    int &num_nodes,
@@ -643,7 +659,7 @@ void vtkPhastaReader::ReadGeomFile(char* geomFileName,
   if(!geomfile)
     {
     vtkErrorMacro(<<"Cannot open file " << geomFileName);
-    return;
+    return 0;
     }
 
   int expect;
@@ -687,7 +703,7 @@ void vtkPhastaReader::ReadGeomFile(char* geomFileName,
   if(num_nodes !=array[0])
     {
     vtkErrorMacro(<<"Ambigous information in geom.data file, number of nodes does not match the co-ordinates size. Nodes: " << num_nodes << " Coordinates: " << array[0]);
-    return;
+    return 0;
     }
   dim = array[1];
 
@@ -698,14 +714,14 @@ void vtkPhastaReader::ReadGeomFile(char* geomFileName,
   if(coordinates == NULL)
     {
     vtkErrorMacro(<<"Unable to allocate memory for nodal info");
-    return;
+    return 0;
     }
 
   pos = new double [num_nodes*dim];
   if(pos == NULL)
     {
     vtkErrorMacro(<<"Unable to allocate memory for nodal info");
-    return;
+    return 0;
     }
   
   item = num_nodes*dim;
@@ -730,7 +746,7 @@ void vtkPhastaReader::ReadGeomFile(char* geomFileName,
         break;
       default:
         vtkErrorMacro(<<"Unrecognized dimension in "<< geomFileName)
-          return;
+          return 0;
       }
     }
 
@@ -755,7 +771,7 @@ void vtkPhastaReader::ReadGeomFile(char* geomFileName,
     if(connectivity == NULL)
       {
       vtkErrorMacro(<<"Unable to allocate memory for connectivity info");
-      return;
+      return 0;
       }
 
     item = num_elems*num_per_line;
@@ -798,7 +814,7 @@ void vtkPhastaReader::ReadGeomFile(char* geomFileName,
           break;
         default:
           vtkErrorMacro(<<"Unrecognized CELL_TYPE in "<< geomFileName)
-            return;
+            return 0;
         }
 
       /* insert the element */
@@ -814,11 +830,10 @@ void vtkPhastaReader::ReadGeomFile(char* geomFileName,
   delete [] coordinates; 
   delete [] pos;
   delete [] connectivity;
-
-
+  return 1;
 }
 
-void vtkPhastaReader::ReadFieldFile(char* fieldFileName, 
+int vtkPhastaReader::ReadFieldFile(char* fieldFileName, 
                                     int, 
                                     vtkDataSetAttributes *field, 
                                     int &noOfNodes)
@@ -835,7 +850,7 @@ void vtkPhastaReader::ReadFieldFile(char* fieldFileName,
   if(!fieldfile)
     {
     vtkErrorMacro(<<"Cannot open file " << FieldFileName)
-      return;
+      return 0;
     }
   int array[10], expect;
 
@@ -863,7 +878,7 @@ void vtkPhastaReader::ReadFieldFile(char* fieldFileName,
   if(data == NULL)
     {
     vtkErrorMacro(<<"Unable to allocate memory for field info");
-    return;
+    return 0;
     }
 
   readdatablock(&fieldfile,"solution",data,&item,"double","binary");
@@ -914,11 +929,11 @@ void vtkPhastaReader::ReadFieldFile(char* fieldFileName,
   // clean up    
   closefile(&fieldfile,"read"); 
   delete [] data;
-
+  return 1;
 } //closes ReadFieldFile
 
 
-void vtkPhastaReader::ReadFieldFile(char* fieldFileName, 
+int vtkPhastaReader::ReadFieldFile(char* fieldFileName, 
                                     int, 
                                     vtkUnstructuredGrid *output, 
                                     int &noOfDatas)
@@ -934,7 +949,7 @@ void vtkPhastaReader::ReadFieldFile(char* fieldFileName,
   if(!fieldfile)
     {
     vtkErrorMacro(<<"Cannot open file " << FieldFileName)
-      return;
+      return 0;
     }
   int array[10], expect;
 
@@ -1216,7 +1231,7 @@ void vtkPhastaReader::ReadFieldFile(char* fieldFileName,
 
   // close up
   closefile(&fieldfile,"read"); 
-
+  return 1;
 }//closes ReadFieldFile
 
 void vtkPhastaReader::PrintSelf(ostream& os, vtkIndent indent)
@@ -72,16 +72,18 @@ protected:
                           vtkInformationVector** inputVector,
                           vtkInformationVector* outputVector);
 
-  void ReadGeomFile(char *GeomFileName, 
+  // Description:
+  // Read the geometry and the fields. Return 0 on failure.
+  int ReadGeomFile(char *GeomFileName, 
                     int &firstVertexNo,
                     vtkPoints *points, 
                     int &noOfNodes,
                     int &noOfCells);
-  void ReadFieldFile(char *fieldFileName , 
+  int ReadFieldFile(char *fieldFileName , 
                      int firstVertexNo, 
                      vtkDataSetAttributes *field, 
                      int &noOfNodes);
-  void ReadFieldFile(char *fieldFileName,
+  int ReadFieldFile(char *fieldFileName,
                      int firstVertexNo,
                      vtkUnstructuredGrid *output,
                      int &noOfDatas);
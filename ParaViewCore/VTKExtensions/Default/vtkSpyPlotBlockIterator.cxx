@@ -1,4 +1,6 @@
 #include "vtkSpyPlotBlockIterator.h"
+#include "vtkMultiProcessController.h"
+#include "vtkSpyPlotBlock.h"
 #include "vtkSpyPlotReader.h"
 #include <assert.h>
 
@@ -271,3 +273,206 @@ void vtkSpyPlotFileDistributionBlockIterator::FindFirstBlockOfCurrentOrNextFile(
     
     }
 }
+
+vtkSpyPlotCostDistributionBlockIterator::
+vtkSpyPlotCostDistributionBlockIterator()
+{
+  this->NumberOfBlocksToProcess = 0;
+}
+
+void vtkSpyPlotCostDistributionBlockIterator::Init(int numberOfProcessors,
+                                                   int processorId,
+                                                   vtkSpyPlotReader *parent,
+                                                   vtkSpyPlotReaderMap *fileMap,
+                                                   int currentTimeStep)
+{
+  vtkSpyPlotBlockIterator::Init(numberOfProcessors,processorId,parent,fileMap,
+                                currentTimeStep);
+
+  // Estimate the cost of every block. Each process only reads the block
+  // headers of every NumberOfProcessors-th file, then the costs are
+  // exchanged. For each file read, the local record has the file index, its
+  // number of blocks and the cost of each block.
+  std::vector<double> localCosts;
+  vtkSpyPlotReaderMap::MapOfStringToSPCTH::iterator fileIterator;
+  int fileIndex = 0;
+  int progressInterval = this->NumberOfFiles/20 + 1;
+  std::vector<int> dims;
+  for ( fileIterator = this->FileMap->Files.begin();
+        fileIterator != this->FileMap->Files.end();
+        fileIterator++, fileIndex++)
+    {
+    if (fileIndex % this->NumberOfProcessors != this->ProcessorId)
+      {
+      continue;
+      }
+    if ( !((fileIndex+1) % progressInterval) )
+      {
+      this->Parent->UpdateProgress(
+        0.2 * (fileIndex+1.0)/this->NumberOfFiles);
+      }
+    vtkSpyPlotUniReader* reader = this->FileMap->GetReader(fileIterator,
+                                                           this->Parent);
+    reader->SetFileName(fileIterator->first.c_str());
+    reader->ReadInformation();
+    int numBlocks = 0;
+    if (reader->SetCurrentTimeStep(this->CurrentTimeStep))
+      {
+      numBlocks = reader->GetNumberOfDataBlocks();
+      dims.assign(3*numBlocks, 0);
+      if (numBlocks > 0 && !reader->ReadBlockDimensions(&dims[0]))
+        {
+        // The blocks are still assigned, with the default cost.
+        dims.assign(3*numBlocks, 1);
+        }
+      }
+    // else this reader does not have that time step, it has no blocks.
+    localCosts.push_back(fileIndex);
+    localCosts.push_back(numBlocks);
+    int numFields = reader->GetNumberOfCellFields();
+    for (int block=0; block < numBlocks; block++)
+      {
+      double cost = (numFields > 1)? numFields : 1.0;
+      for (int q=0; q<3; ++q)
+        {
+        cost *= (dims[3*block+q] > 1)? dims[3*block+q] : 1;
+        }
+      localCosts.push_back(cost);
+      }
+    }
+
+  std::vector<double> allCosts;
+  vtkMultiProcessController* controller =
+    this->Parent->GetGlobalController();
+  if (controller && this->NumberOfProcessors > 1)
+    {
+    vtkIdType localLength = static_cast<vtkIdType>(localCosts.size());
+    std::vector<vtkIdType> lengths(this->NumberOfProcessors, 0);
+    std::vector<vtkIdType> offsets(this->NumberOfProcessors, 0);
+    controller->AllGather(&localLength, &lengths[0], 1);
+    vtkIdType totalLength = 0;
+    for (int proc=0; proc < this->NumberOfProcessors; proc++)
+      {
+      offsets[proc] = totalLength;
+      totalLength += lengths[proc];
+      }
+    allCosts.resize(totalLength);
+    if (totalLength > 0)
+      {
+      // Keeps the send buffer valid on processes without files. The extra
+      // value is not sent.
+      localCosts.push_back(0.0);
+      controller->AllGatherV(&localCosts[0], &allCosts[0], localLength,
+                             &lengths[0], &offsets[0]);
+      }
+    }
+  else
+    {
+    allCosts.swap(localCosts);
+    }
+
+  // Put the costs in file order.
+  std::vector<int> fileNumberOfBlocks(this->NumberOfFiles, 0);
+  std::vector<size_t> fileRecords(this->NumberOfFiles, 0);
+  size_t totalBlocks = 0;
+  for (size_t pos=0; pos+1 < allCosts.size();
+       pos += 2 + static_cast<size_t>(allCosts[pos+1]))
+    {
+    fileIndex = static_cast<int>(allCosts[pos]);
+    fileNumberOfBlocks[fileIndex] = static_cast<int>(allCosts[pos+1]);
+    fileRecords[fileIndex] = pos + 2;
+    totalBlocks += fileNumberOfBlocks[fileIndex];
+    }
+  std::vector<double> costs;
+  costs.reserve(totalBlocks);
+  double totalCost = 0.0;
+  for (fileIndex = 0; fileIndex < this->NumberOfFiles; fileIndex++)
+    {
+    for (int block=0; block < fileNumberOfBlocks[fileIndex]; block++)
+      {
+      double cost = allCosts[fileRecords[fileIndex] + block];
+      costs.push_back(cost);
+      totalCost += cost;
+      }
+    }
+
+  // Split the sequence of blocks in NumberOfProcessors contiguous ranges of
+  // about the same cost: a block goes to the processor whose share of the
+  // total cost contains the middle of the block.
+  this->FirstBlocks.assign(this->NumberOfFiles, 0);
+  this->LastBlocks.assign(this->NumberOfFiles, -1);
+  this->NumberOfBlocksToProcess = 0;
+  double prefix = 0.0;
+  size_t globalBlock = 0;
+  for (fileIndex = 0; fileIndex < this->NumberOfFiles; fileIndex++)
+    {
+    for (int block=0; block < fileNumberOfBlocks[fileIndex];
+         block++, globalBlock++)
+      {
+      double cost = costs[globalBlock];
+      int owner;
+      if (totalCost > 0.0)
+        {
+        owner = static_cast<int>(
+          (prefix + 0.5*cost) * this->NumberOfProcessors / totalCost);
+        }
+      else
+        {
+        owner = static_cast<int>(
+          globalBlock * this->NumberOfProcessors / totalBlocks);
+        }
+      if (owner >= this->NumberOfProcessors)
+        {
+        owner = this->NumberOfProcessors - 1;
+        }
+      prefix += cost;
+
+      if (owner == this->ProcessorId)
+        {
+        if (this->FirstBlocks[fileIndex] > this->LastBlocks[fileIndex])
+          {
+          this->FirstBlocks[fileIndex] = block;
+          }
+        this->LastBlocks[fileIndex] = block;
+        ++this->NumberOfBlocksToProcess;
+        }
+      }
+    }
+}
+
+void vtkSpyPlotCostDistributionBlockIterator::Start()
+{
+  this->FileIterator=this->FileMap->Files.begin();
+  this->FileIndex=0;
+  this->FindFirstBlockOfCurrentOrNextFile();
+}
+
+int vtkSpyPlotCostDistributionBlockIterator::GetNumberOfBlocksToProcess()
+{
+  return this->NumberOfBlocksToProcess;
+}
+
+void vtkSpyPlotCostDistributionBlockIterator::
+FindFirstBlockOfCurrentOrNextFile()
+{
+  this->Active=this->FileIndex<this->NumberOfFiles;
+  while(this->Active)
+    {
+    if (this->FirstBlocks[this->FileIndex]<=this->LastBlocks[this->FileIndex])
+      {
+      // Init() only read the information of some of the files.
+      this->UniReader=this->FileMap->GetReader(this->FileIterator,
+                                               this->Parent);
+      this->UniReader->SetFileName(this->FileIterator->first.c_str());
+      this->UniReader->ReadInformation();
+      this->UniReader->SetCurrentTimeStep(this->CurrentTimeStep);
+      this->NumberOfFields=this->UniReader->GetNumberOfCellFields();
+      this->Block=this->FirstBlocks[this->FileIndex];
+      this->BlockEnd=this->LastBlocks[this->FileIndex];
+      break; // Done
+      }
+    ++this->FileIterator;
+    ++this->FileIndex;
+    this->Active = this->FileIndex<this->NumberOfFiles;
+    }
+}
@@ -5,6 +5,7 @@
 #include "vtkSpyPlotUniReader.h"
 #include "vtkSpyPlotReaderMap.h"
 #include "assert.h"
+#include <vector> // for std::vector
 
 class vtkSpyBlock;
 class vtkSpyPlotReaderMap;
@@ -131,6 +132,39 @@ protected:
 };
 
 
+// Distributes the blocks of all the files so that each processor gets about
+// the same estimated cost, the cost of a block being its number of cells
+// times the number of cell fields of its file. The blocks are taken in file
+// order and each processor gets a contiguous range of them, which keeps the
+// number of files opened by each processor low.
+// The costs are computed from the block headers only: each processor reads
+// the headers of a share of the files, and the costs are exchanged through
+// the global controller of the reader. Init() is therefore collective.
+class VTKPVVTKEXTENSIONSDEFAULT_EXPORT vtkSpyPlotCostDistributionBlockIterator
+  : public vtkSpyPlotBlockIterator
+{
+public:
+  vtkSpyPlotCostDistributionBlockIterator();
+  virtual ~vtkSpyPlotCostDistributionBlockIterator() {}
+  virtual void Init(int numberOfProcessors,
+                    int processorId,
+                    vtkSpyPlotReader *parent,
+                    vtkSpyPlotReaderMap *fileMap,
+                    int currentTimeStep);
+  virtual void Start();
+  virtual int GetNumberOfBlocksToProcess();
+
+protected:
+  virtual void FindFirstBlockOfCurrentOrNextFile();
+
+  // First and last block of each file assigned to this processor.
+  // FirstBlocks[i] > LastBlocks[i] when there is none.
+  std::vector<int> FirstBlocks;
+  std::vector<int> LastBlocks;
+  int NumberOfBlocksToProcess;
+};
+
+
 
 inline void vtkSpyPlotBlockIterator::Next()
 {
@@ -48,6 +48,7 @@ PURPOSE.  See the above copyright notice for more information.
 #include "vtkSpyPlotBlockIterator.h"
 #include "vtkSpyPlotIStream.h"
 
+#include <algorithm>
 #include <map>
 #include <set>
 #include <vector>
@@ -74,6 +75,18 @@ static void createSpyPlotLevelArray(vtkCellData *cd, int size, int level);
 
 class vtkSpyPlotReader::VectorOfDoubles : public std::vector<double> {};
 
+// Global meta data of a time step, as computed by SetGlobalMetaData().
+struct vtkSpyPlotMetaData
+{
+  bool HasBounds;
+  double Bounds[6];
+  int BoxSize[3];
+  int MinLevel;
+  double MinLevelSpacing[3];
+};
+class vtkSpyPlotReader::MetaDataCache :
+  public std::map<int, vtkSpyPlotMetaData> {};
+
 //-----------------------------------------------------------------------------
 vtkSpyPlotReader::vtkSpyPlotReader()
 {
@@ -101,6 +114,8 @@ vtkSpyPlotReader::vtkSpyPlotReader()
   this->SetGlobalController(vtkMultiProcessController::GetGlobalController());
 
   this->DistributeFiles=0; // by default, distribute blocks, not files.
+  this->DistributeBlocksByCost=0; // by default, same number of blocks.
+  this->DecodedArrayCacheSize=256;
   this->GenerateLevelArray=0; // by default, do not generate level array.
   this->GenerateBlockIdArray=0; // by default, do not generate block id array.
   this->GenerateActiveBlockArray = 0; // by default do not generate active array
@@ -109,6 +124,7 @@ vtkSpyPlotReader::vtkSpyPlotReader()
   this->IsAMR = 1;
   this->FileNameChanged = true;
   this->TimeSteps = new vtkSpyPlotReader::VectorOfDoubles();
+  this->GlobalMetaData = new vtkSpyPlotReader::MetaDataCache();
   this->TimeRequestedFromPipeline = false;
 }
 
@@ -123,6 +139,7 @@ vtkSpyPlotReader::~vtkSpyPlotReader()
   this->Map = 0;
   this->SetGlobalController(0);
   delete this->TimeSteps;
+  delete this->GlobalMetaData;
 }
 
 
@@ -279,6 +296,9 @@ int vtkSpyPlotReader::UpdateFile (vtkInformation* request,
     this->GlobalController->GetNumberOfProcesses() : 1;
   //cout << procId << " : " << __LINE__ << endl;
 
+  // The files changed, the cached global meta data is no longer valid.
+  this->GlobalMetaData->clear();
+
   // When running in parallel, we need to ensure that all testing and meta-data
   // loading only happens on the root node. (BUG #12720).
   // We fill up the "Map" on root node, and then share the filename with all
@@ -653,6 +673,11 @@ int vtkSpyPlotReader::RequestData(
     vtkDebugMacro("Distribute files");
     blockIterator=new vtkSpyPlotFileDistributionBlockIterator;
     }
+  else if(this->DistributeBlocksByCost)
+    {
+    vtkDebugMacro("Distribute blocks by cost");
+    blockIterator=new vtkSpyPlotCostDistributionBlockIterator;
+    }
   else
     {
     vtkDebugMacro("Distribute blocks");
@@ -670,27 +695,17 @@ int vtkSpyPlotReader::RequestData(
 
   int nBlocks = blockIterator->GetNumberOfBlocksToProcess();
   int progressInterval = nBlocks / 10 + 1;
-  int rightHasBounds = 0;
-  int leftHasBounds = 0;
 
   vtkNonOverlappingAMR *hbds
         = vtkNonOverlappingAMR::SafeDownCast(cds);
 
-  // TODO The following three calls compute meta data
-  // this could be done in a single pass, and the meta data
-  // should be vtkInformationKeys defined in vtkNonOverlappingAMR
-  // rather than placed in the field data as it is here.
-
-  // Note that in the process of getting the bounds
-  // all of the readers will get updated appropriately
-  this->SetGlobalBounds(blockIterator, nBlocks,
-                        progressInterval, &rightHasBounds,
-                        &leftHasBounds);
-  // Determine if the box size is constant
-  this->SetGlobalBoxSize( blockIterator );
-  // Determine the minimum level in use
-  // and its grid spacing
-  this->SetGlobalMinLevelAndSpacing( blockIterator );
+  // TODO The meta data should be vtkInformationKeys defined in
+  // vtkNonOverlappingAMR rather than placed in the field data as it is here.
+
+  // Get the global bounds, determine if the box size is constant and
+  // the minimum level in use with its grid spacing. Note that in the
+  // process all of the readers will get updated appropriately
+  this->SetGlobalMetaData(blockIterator, nBlocks, progressInterval);
   // export global bounds, minimum level, spacing, and box size
   // in field data arrays for use by downstream filters
   if ( hbds != NULL )
@@ -1423,6 +1438,18 @@ void vtkSpyPlotReader::PrintSelf(ostream& os, vtkIndent indent)
     os << "false"<<endl;
     }
 
+  os << "DistributeBlocksByCost: ";
+  if(this->DistributeBlocksByCost)
+    {
+    os << "true"<<endl;
+    }
+  else
+    {
+    os << "false"<<endl;
+    }
+
+  os << "DecodedArrayCacheSize: " << this->DecodedArrayCacheSize << endl;
+
   os << "DownConvertVolumeFraction: ";
   if(this->DownConvertVolumeFraction)
     {
@@ -1486,323 +1513,174 @@ void vtkSpyPlotReader::PrintSelf(ostream& os, vtkIndent indent)
     this->GlobalController->PrintSelf(os, indent.GetNextIndent());
     }
 }
-// Get the minimum level that actuall has data and
-// its grid spacing. If this process has no blocks
-// then we return spacing and min level close to infinity.
-void vtkSpyPlotReader::GetLocalMinLevelAndSpacing(
-                              vtkSpyPlotBlockIterator *biter,
-                              int *localMinLevel,
-                              double spacing[3]) const
-{
-  biter->Start();
-  // If there are no blocks locally we set
-  // the spacing and min level close to infinity
-  // and return
-  if (!biter->IsActive())
-    {
-    localMinLevel[0]=VTK_INT_MAX;
-    spacing[0]=spacing[1]=spacing[2]=VTK_DOUBLE_MAX;
-    return;
-    }
-  // get first block's level
-  biter->GetUniReader()->MakeCurrent();
-  vtkSpyPlotBlock *thisBlock= biter->GetBlock();
-  *localMinLevel = thisBlock->GetLevel();
+//-----------------------------------------------------------------------------
+// Number of values exchanged per process by SetGlobalMetaData():
+// bounds (6), has bounds, has blocks, box size is constant, box size (3),
+// min level and its spacing (3).
+#define VTK_SPY_PLOT_META_DATA_SIZE 16
 
-  vtkSpyPlotBlock *minLevelBlock=thisBlock;
+void vtkSpyPlotReader::SetGlobalMetaData(vtkSpyPlotBlockIterator *biter,
+                                         int nBlocks, int progressInterval)
+{
+  vtkSpyPlotReader::MetaDataCache::iterator cached =
+    this->GlobalMetaData->find(this->CurrentTimeStep);
+  bool useCache = (cached != this->GlobalMetaData->end());
+
+  // Single pass over the local blocks. This also makes sure that all of the
+  // readers are up to date, which is needed even when the meta data comes
+  // from the cache.
+  vtkBoundingBox localBounds;
+  bool hasBlocks = false;
+  bool isBoxSizeConstant = true;
+  int localBoxSize[3] = {VTK_INT_MAX, VTK_INT_MAX, VTK_INT_MAX};
+  int localMinLevel = VTK_INT_MAX;
+  double localSpacing[3] = {VTK_DOUBLE_MAX, VTK_DOUBLE_MAX, VTK_DOUBLE_MAX};
 
-  // compare to all others
-  for ( biter->Next(); biter->IsActive(); biter->Next())
+  double bounds[6];
+  int dims[3];
+  double progressFactor = 0.4 / static_cast<double>(nBlocks);
+  biter->Start();
+  for (int i = 0; biter->IsActive(); i++, biter->Next())
     {
-    thisBlock = biter->GetBlock();
-    int thisMinLevel=thisBlock->GetLevel();
-    if (thisMinLevel < *localMinLevel)
+    // See if we need to update progress
+    if (i && !(i % progressInterval))
       {
-      minLevelBlock=thisBlock;
-      *localMinLevel=thisMinLevel;
+      this->UpdateProgress(
+        static_cast<double>(1.2 + i) * progressFactor);
       }
-    }
-  // now that we have the block with minimum
-  // level, we can get the spacing from him.
-  minLevelBlock->GetSpacing(spacing);
-
-  return;
-}
-//
-void vtkSpyPlotReader::SetGlobalMinLevelAndSpacing(
-                            vtkSpyPlotBlockIterator *biter)
-{
-  // get the local min level and its spacing
-  // if there are no blocks locally these will be
-  // close to infinity.
-  int localMinLevel;
-  double localMinLevelSpacing[3];
-  this->GetLocalMinLevelAndSpacing(biter,&localMinLevel,localMinLevelSpacing);
-
-  // If we are not running in parallel then the local
-  // min level and spacing is the global min level and spacing
-  if (!this->GlobalController)
-    {
-    this->MinLevel=localMinLevel;
-    for (int q=0; q<3; ++q)
+    // Make sure that the block is up to date
+    biter->GetUniReader()->MakeCurrent();
+    if (useCache)
       {
-      this->MinLevelSpacing[q]=localMinLevelSpacing[q];
+      continue;
       }
-    return;
-    }
+    vtkSpyPlotBlock *block = biter->GetBlock();
+    block->GetRealBounds(bounds);
+    localBounds.AddBounds(bounds);
 
-  // package the level and its spacing because
-  // we want to reduce min level but also need
-  // its associated spacing to go along for the ride.
-  double sendBuf[4]={(double)localMinLevel,
-                     localMinLevelSpacing[0],
-                     localMinLevelSpacing[1],
-                     localMinLevelSpacing[2]};
-  // collect the information on proc 0
-  int numProcs=this->GlobalController->GetNumberOfProcesses();
-  int myRank=this->GlobalController->GetLocalProcessId();
-
-  // proc 0 gets a bigger buffer to collect all the data
-  double *recvBuf = myRank==0 ? new double[4*numProcs] : 0;
-  this->GlobalController->Gather( sendBuf, recvBuf, 4, 0);
-
-  // reduce min level while preserving its
-  // associated spacing
-  if (myRank==0)
-    {
-    // sendBuf will hold the result of the reduction
-    // it is already initialized with min level and
-    // spacing from proc 0, we start looking in data
-    // gathered from proc 1...n
-    for (int i=0,j=4; i<numProcs-1; ++i, j+=4)
+    block->GetDimensions(dims);
+    if (!hasBlocks)
       {
-      if (sendBuf[0]>recvBuf[j])
-        {
-        // copy
-        for (int q=0; q<4; ++q)
-          {
-          sendBuf[q]=recvBuf[j+q];
-          }
-        }
+      localBoxSize[0] = dims[0];
+      localBoxSize[1] = dims[1];
+      localBoxSize[2] = dims[2];
+      }
+    else if (dims[0] != localBoxSize[0] || dims[1] != localBoxSize[1] ||
+             dims[2] != localBoxSize[2])
+      {
+      isBoxSizeConstant = false;
       }
-    delete [] recvBuf;
-    }
-  // proc 0 knows the min level and spacing
-  // share this with everyone else
-  this->GlobalController->Broadcast(sendBuf,4,0);
-
-  // now everyone has the min level and associated grid spacing
-  this->MinLevel=(int)sendBuf[0];
-  for (int q=0; q<3; ++q)
-    {
-    this->MinLevelSpacing[q]=sendBuf[1+q];
-    }
-}
-
 
-// Determine the local box size if the box size is constant.
-// If the box size varies over the local tree then size will be
-// -1,-1,-1.
-// The case where there are no blocks is treated as if the block size
-// is constant and the size will be
-// inf, inf, inf
-//
-// returns true if the box size is constant and false if the box size varies
-bool vtkSpyPlotReader::GetLocalBoxSize(vtkSpyPlotBlockIterator *biter,
-                                       int localBoxSize[3]) const
-{
-  vtkSpyPlotBlock *block;
-  biter->Start();
-  // see if there are any blocks on this process
-  // if not then, we'll call block size constant
-  // and set the size close to infinite
-  if (!biter->IsActive())
-    {
-    localBoxSize[0]=localBoxSize[1]=localBoxSize[2]=VTK_INT_MAX;
-    return true;
-    }
-  // get first box's size
-  biter->GetUniReader()->MakeCurrent();
-  block = biter->GetBlock();
-  int thisBoxSize[3];
-  block->GetDimensions(localBoxSize);
-  // compare to all others
-  for ( biter->Next(); biter->IsActive(); biter->Next())
-    {
-    block = biter->GetBlock();
-    biter->GetUniReader()->MakeCurrent();
-    block->GetDimensions(thisBoxSize);
-    for (int q=0;q<3;++q)
+    if (block->GetLevel() < localMinLevel)
       {
-      // if the size changes stop
-      if (thisBoxSize[q]!=localBoxSize[q])
-        {
-        localBoxSize[0] = -1;
-        localBoxSize[1] = -1;
-        localBoxSize[2] = -1;
-        return false;
-        }
+      localMinLevel = block->GetLevel();
+      block->GetSpacing(localSpacing);
       }
+    hasBlocks = true;
     }
-  // box size is a constant locally
-  return true;
-}
-
-// Determines if the box size is a constant over the entire data set
-// if so sets this->GlobalBoxSize to that size, otehrwise sets
-// it to -1,-1,-1
-void vtkSpyPlotReader::SetGlobalBoxSize(vtkSpyPlotBlockIterator *biter)
-{
-  // Get the local box size
-  int localBoxSize[3] = {0,0,0};
-  bool isConstantLocally
-      = this->GetLocalBoxSize(biter, localBoxSize);
 
-  // If we are not running in parallel then the local
-  // size is the global size
-  if (!this->GlobalController)
+  if (!useCache)
     {
-    if (isConstantLocally)
-      {
-      for (int q=0; q<3; ++q)
-        {
-        this->BoxSize[q]=localBoxSize[q];
-        }
-      }
-    else
+    double localData[VTK_SPY_PLOT_META_DATA_SIZE];
+    localBounds.GetBounds(localData);
+    localData[6] = localBounds.IsValid()? 1.0 : 0.0;
+    localData[7] = hasBlocks? 1.0 : 0.0;
+    localData[8] = isBoxSizeConstant? 1.0 : 0.0;
+    localData[12] = localMinLevel;
+    for (int q=0; q<3; ++q)
       {
-      for (int q=0; q<3; ++q)
-        {
-        this->BoxSize[q]=-1;
-        }
+      localData[9+q] = localBoxSize[q];
+      localData[13+q] = localSpacing[q];
       }
-    return;
-    }
 
-  // To decide weather or not box size is constant...
-  // 1) get the smallest box size across procs
-  int globalBoxSize[3] = {-1,-1,-1};
-  this->GlobalController->AllReduce(localBoxSize, globalBoxSize, 3, vtkCommunicator::MIN_OP);
-
-  // 2) check if box size we have is the same as the
-  // box size that the other procs have.
-  bool isConstantGlobally=true;
-  for (int q=0; q<3; ++q)
-    {
-    // if we have no blocks then we have to
-    // get the true size from other procs, and pretend
-    // that size is constant locally
-    if (localBoxSize[q]==VTK_INT_MAX )
+    // Exchange everything at once. Every process then does the same
+    // reduction, in rank order.
+    int numProcs = this->GlobalController?
+      this->GlobalController->GetNumberOfProcesses() : 1;
+    std::vector<double> allData(VTK_SPY_PLOT_META_DATA_SIZE*numProcs);
+    if (numProcs > 1)
       {
-      localBoxSize[q]=globalBoxSize[q];
+      this->GlobalController->AllGather(localData, &allData[0],
+                                        VTK_SPY_PLOT_META_DATA_SIZE);
       }
-    // if we have blocks the n we just check to see if
-    // what we have is the same as what the others
-    // have.
-    else if (localBoxSize[q]!=globalBoxSize[q])
+    else
       {
-      isConstantGlobally=false;
+      std::copy(localData, localData+VTK_SPY_PLOT_META_DATA_SIZE,
+                allData.begin());
       }
-    }
-  // 3) send a flag indicating change/no change occured
-  int lFlag=!isConstantLocally||!isConstantGlobally ? -1 : 1;
-  int gFlag=0;
-  this->GlobalController->AllReduce(&lFlag,&gFlag,1, vtkCommunicator::MIN_OP);
 
-  // set the global box size acordingly
-  switch( gFlag )
-    {
-    // box size varies
-    case -1:
-      for (int q=0; q<3; ++q)
+    vtkSpyPlotMetaData result;
+    vtkBoundingBox globalBounds;
+    bool anyBlocks = false;
+    bool isConstant = true;
+    result.BoxSize[0] = result.BoxSize[1] = result.BoxSize[2] = VTK_INT_MAX;
+    result.MinLevel = VTK_INT_MAX;
+    result.MinLevelSpacing[0] = result.MinLevelSpacing[1] =
+      result.MinLevelSpacing[2] = VTK_DOUBLE_MAX;
+    for (int p=0; p<numProcs; ++p)
+      {
+      const double *data = &allData[VTK_SPY_PLOT_META_DATA_SIZE*p];
+      if (data[6] != 0.0)
         {
-        this->BoxSize[q]=-1;
+        globalBounds.AddBounds(data);
         }
-      break;
-    // box size is constant
-    case 1:
-      for (int q=0; q<3; ++q)
+      if (data[7] == 0.0)
         {
-        this->BoxSize[q]=localBoxSize[q];
+        // processes without blocks don't constrain the box size nor the
+        // min level.
+        continue;
         }
-        break;
-    default:
-      vtkErrorMacro("Invalid flag value verifying that box size is constant.");
-    }
- return;
-}
-
-// This functions return 1 if the bounds have been set
-void vtkSpyPlotReader::GetLocalBounds(vtkSpyPlotBlockIterator *biter,
-                                      int nBlocks, int progressInterval)
-{
-  int i;
-  double bounds[6];
-  double progressFactor = 0.4 / static_cast<double>(nBlocks);
-  vtkSpyPlotBlock *block;
-
-  // every one has bounds, the procs with no blocks
-  // have canonical empty bounds.
-//   double *pt;
-//   pt=const_cast<double *>(this->Bounds->GetMinPoint());
-//   pt[0]=pt[1]=pt[2]= VTK_DOUBLE_MAX;
-//   pt=const_cast<double *>(this->Bounds->GetMaxPoint());
-//   pt[0]=pt[1]=pt[2]=-VTK_DOUBLE_MAX;
-
-  biter->Start();
-  for (i = 0; biter->IsActive(); i++, biter->Next())
-    {
-    // See if we need to update progress
-    if (i && !(i % progressInterval))
+      if (data[8] == 0.0)
+        {
+        isConstant = false;
+        }
+      else if (!anyBlocks)
+        {
+        for (int q=0; q<3; ++q)
+          {
+          result.BoxSize[q] = static_cast<int>(data[9+q]);
+          }
+        }
+      else if (result.BoxSize[0] != static_cast<int>(data[9]) ||
+               result.BoxSize[1] != static_cast<int>(data[10]) ||
+               result.BoxSize[2] != static_cast<int>(data[11]))
+        {
+        isConstant = false;
+        }
+      // ties are resolved in favor of the lowest rank.
+      if (data[12] < result.MinLevel)
+        {
+        result.MinLevel = static_cast<int>(data[12]);
+        for (int q=0; q<3; ++q)
+          {
+          result.MinLevelSpacing[q] = data[13+q];
+          }
+        }
+      anyBlocks = true;
+      }
+    if (anyBlocks && !isConstant)
       {
-      this->UpdateProgress(
-        static_cast<double>(1.2 + i) * progressFactor);
+      result.BoxSize[0] = result.BoxSize[1] = result.BoxSize[2] = -1;
       }
-    // Make sure that the block is up to date
-    biter->GetUniReader()->MakeCurrent();
-    block = biter->GetBlock();
-    block->GetRealBounds(bounds);
-    this->Bounds->AddBounds(bounds);
-    }
-}
+    result.HasBounds = globalBounds.IsValid();
+    globalBounds.GetBounds(result.Bounds);
 
-// Returns 1 if the bounds are valid else 0
-void vtkSpyPlotReader::SetGlobalBounds(vtkSpyPlotBlockIterator *biter,
-                                       int total_num_of_blocks,
-                                       int progressInterval,
-                                       int *rightHasBounds,
-                                       int *leftHasBounds)
-{
-  // Get the local bounds of this reader
-  this->GetLocalBounds(biter, total_num_of_blocks,
-                       progressInterval);
-
-  // If we are not running in parallel then the local
-  // bounds are the global bounds
-  if (!this->GlobalController)
-    {
-    return;
+    cached = this->GlobalMetaData->insert(
+      vtkSpyPlotReader::MetaDataCache::value_type(
+        this->CurrentTimeStep, result)).first;
     }
-  vtkCommunicator *comm = this->GlobalController->GetCommunicator();
-  if (!comm)
+
+  const vtkSpyPlotMetaData &metaData = cached->second;
+  if (metaData.HasBounds)
     {
-    return;
+    this->Bounds->AddBounds(metaData.Bounds);
     }
-
-  int processNumber=this->GlobalController->GetLocalProcessId();
-  int numProcessors=this->GlobalController->GetNumberOfProcesses();
-
-  if (!comm->ComputeGlobalBounds(processNumber, numProcessors,
-                                 this->Bounds, rightHasBounds,
-                                 leftHasBounds,
-                                 VTK_MSG_SPY_READER_HAS_BOUNDS,
-                                 VTK_MSG_SPY_READER_LOCAL_BOUNDS,
-                                 VTK_MSG_SPY_READER_GLOBAL_BOUNDS))
+  this->MinLevel = metaData.MinLevel;
+  for (int q=0; q<3; ++q)
     {
-    vtkErrorMacro("Problem occurred getting the global bounds");
+    this->BoxSize[q] = metaData.BoxSize[q];
+    this->MinLevelSpacing[q] = metaData.MinLevelSpacing[q];
     }
-
- return;
 }
 
 int vtkSpyPlotReader::PrepareAMRData(vtkNonOverlappingAMR *hb,
@@ -37,6 +37,8 @@ PURPOSE.  See the above copyright notice for more information.
 // there is only one file.
 // - or by distributing files: a file is read entirely by one processor. If
 // there is only one file, all the other processors are not used at all.
+// When distributing blocks, the blocks can also be assigned according to
+// their estimated cost (see SetDistributeBlocksByCost()).
 //
 // .SECTION Implementation Details
 // - All processors read the first binary file listed in the case file to get
@@ -98,6 +100,26 @@ public:
   vtkGetMacro(DistributeFiles,int);
   vtkBooleanMacro(DistributeFiles,int);
 
+  // Description:
+  // When distributing blocks, if true, the blocks of all the files are split
+  // in contiguous ranges of about the same estimated cost (number of cells
+  // times number of cell arrays) instead of giving each processor the same
+  // number of blocks of each file. This requires all processors to read the
+  // block headers of all the files. False by default.
+  vtkSetMacro(DistributeBlocksByCost,int);
+  vtkGetMacro(DistributeBlocksByCost,int);
+  vtkBooleanMacro(DistributeBlocksByCost,int);
+
+  // Description:
+  // Set/Get the maximum size, in mebibytes, of the decoded cell arrays that
+  // are kept in memory when they are not used anymore (i.e. after they are
+  // unselected or when reading another time step), so that selecting them
+  // again or going back to a time step does not read and decode them again.
+  // The size is shared by all the files. 0 disables the cache. Default is
+  // 256.
+  vtkSetMacro(DecodedArrayCacheSize,int);
+  vtkGetMacro(DecodedArrayCacheSize,int);
+
   // Description:
   // If true, the reader generate a cell array in each block that
   // stores the level in the hierarchy, starting from 0.
@@ -179,6 +201,7 @@ public:
   // The "global controller" has all processes while the
   // "controller" has only those who have blocks.
   void SetGlobalController(vtkMultiProcessController* controller);
+  vtkGetObjectMacro(GlobalController, vtkMultiProcessController);
 
   // Description:
   // Determine if the file can be readed with this reader.
@@ -188,36 +211,13 @@ protected:
   vtkSpyPlotReader();
   ~vtkSpyPlotReader();
 
-  // Determine the bounds of just this reader
-  void GetLocalBounds(vtkSpyPlotBlockIterator *biter,
-                      int nBlocks, int progressInterval);
-
-  // Set the global bounds of all readers
-  void SetGlobalBounds(vtkSpyPlotBlockIterator *biter,
-                      int total_num_of_block,
-                      int progressInterval,
-                      int *rightHasBounds,
-                      int *leftHasBounds);
-
-  // Determine the box size on just this reader
-  // returns true if box size is a constant on this reader
-  // false if not.
-  bool GetLocalBoxSize(vtkSpyPlotBlockIterator *biter,
-                       int *localBoxSize) const;
-
-  // Determine box size if it is a constant across the data set
-  // If not then this is set to -1,-1,-1.
-  void SetGlobalBoxSize(vtkSpyPlotBlockIterator *biter);
-
-  // Determine the minimum level that is used on just this level
-  // and get the spacing there
-  void GetLocalMinLevelAndSpacing(vtkSpyPlotBlockIterator *biter,
-                                  int *localMinLevel,
-                                  double spacing[3]) const;
-
-  // Set the minimum level that is used
-  // and get the spacing there
-  void SetGlobalMinLevelAndSpacing(vtkSpyPlotBlockIterator *biter);
+  // Set the global bounds of all readers, the box size if it is a constant
+  // across the data set (-1,-1,-1 otherwise), and the minimum level that is
+  // used with its spacing. All of them are computed in a single pass over
+  // the local blocks followed by a single collective operation, and cached
+  // for the current time step. The pass also makes the readers current.
+  void SetGlobalMetaData(vtkSpyPlotBlockIterator *biter,
+                         int nBlocks, int progressInterval);
 
   // Set things up to process an AMR Block
   int PrepareAMRData(vtkNonOverlappingAMR *hb,
@@ -351,6 +351,8 @@ protected:
   vtkSpyPlotReaderMap *Map;
 
   int DistributeFiles;
+  int DistributeBlocksByCost;
+  int DecodedArrayCacheSize;
 
   vtkBoundingBox *Bounds; //bounds of the hierarchy without the bad ghostcells.
   int BoxSize[3];         // size of boxes if they are all the same, else -1,-1,-1
@@ -377,8 +379,10 @@ private:
   void operator=(const vtkSpyPlotReader&);  // Not implemented.
 
   class VectorOfDoubles;
+  class MetaDataCache;
 
   VectorOfDoubles* TimeSteps;
+  MetaDataCache* GlobalMetaData;
   void SetTimeStepsInternal(const VectorOfDoubles&);
 };
 
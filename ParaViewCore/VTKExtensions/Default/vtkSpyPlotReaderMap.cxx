@@ -136,11 +136,21 @@ vtkSpyPlotReaderMap::GetReader(MapOfStringToSPCTH::iterator& it,
 //-----------------------------------------------------------------------------
 void vtkSpyPlotReaderMap::TellReadersToCheck(vtkSpyPlotReader *parent)
 {
+  // The decoded array cache size is shared by all the files.
+  unsigned long cacheSize = 0;
+  if (parent->GetDecodedArrayCacheSize() > 0 && this->Files.size() > 0)
+    {
+    cacheSize = static_cast<unsigned long>(
+      parent->GetDecodedArrayCacheSize()) * 1024 / this->Files.size();
+    }
+
   MapOfStringToSPCTH::iterator it;
   MapOfStringToSPCTH::iterator end=this->Files.end();
   for (it=this->Files.begin();it!=end; ++it)
     {
-    this->GetReader(it, parent)->SetNeedToCheck(1);
+    vtkSpyPlotUniReader* reader = this->GetReader(it, parent);
+    reader->SetNeedToCheck(1);
+    reader->SetDecodedArrayCacheSize(cacheSize);
     }
 }
 
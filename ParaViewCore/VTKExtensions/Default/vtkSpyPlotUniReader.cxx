@@ -8,6 +8,10 @@
 #include "vtkIntArray.h"
 #include "vtkUnsignedCharArray.h"
 #include "vtkByteSwap.h"
+#include "vtkMultiThreader.h"
+#include "vtkNew.h"
+#include <algorithm>
+#include <list>
 #include <vector>
 #include <vtksys/ios/sstream>
 #include <vtksys/RegularExpression.hxx>
@@ -34,6 +38,73 @@ inline ostream& operator<< (ostream& os, const vtkSpyPlotWriteString& c)
   return os;
 }
 
+//-----------------------------------------------------------------------------
+// Decoded data blocks of variables that are not in use anymore, most recently
+// cached first.
+class vtkSpyPlotUniReader::vtkDecodedArrayCache
+{
+public:
+  struct Entry
+    {
+    int Dump;
+    int Field;
+    int NumberOfBlocks;
+    vtkDataArray** DataBlocks;
+    int* GhostCellsFixed;
+    unsigned long Size; // in kibibytes
+    };
+  typedef std::list<Entry> ListOfEntries;
+
+  ListOfEntries Entries;
+  unsigned long Size;
+
+  vtkDecodedArrayCache() : Size(0) {}
+  ~vtkDecodedArrayCache() { this->Clear(); }
+
+  ListOfEntries::iterator Find(int dump, int field)
+    {
+    ListOfEntries::iterator iter;
+    for (iter = this->Entries.begin(); iter != this->Entries.end(); ++iter)
+      {
+      if (iter->Dump == dump && iter->Field == field)
+        {
+        break;
+        }
+      }
+    return iter;
+    }
+
+  // Releases the least recently cached entries until the cache size is at
+  // most maxSize.
+  void Shrink(unsigned long maxSize)
+    {
+    while (this->Size > maxSize && !this->Entries.empty())
+      {
+      this->Size -= this->Entries.back().Size;
+      vtkDecodedArrayCache::Release(this->Entries.back());
+      this->Entries.pop_back();
+      }
+    }
+
+  void Clear()
+    {
+    this->Shrink(0);
+    }
+
+  static void Release(Entry& entry)
+    {
+    for (int cc = 0; cc < entry.NumberOfBlocks; ++cc)
+      {
+      if (entry.DataBlocks[cc])
+        {
+        entry.DataBlocks[cc]->Delete();
+        }
+      }
+    delete [] entry.DataBlocks;
+    delete [] entry.GhostCellsFixed;
+    }
+};
+
 
 
 //-----------------------------------------------------------------------------
@@ -83,6 +154,9 @@ vtkSpyPlotUniReader::vtkSpyPlotUniReader()
 
   this->MarkersOn = 0;
   this->GenerateMarkers = 1;
+
+  this->DecodedArrayCacheSize = 65536;
+  this->DecodedArrays = new vtkDecodedArrayCache;
 }
 
 //-----------------------------------------------------------------------------
@@ -95,6 +169,7 @@ vtkSpyPlotUniReader::~vtkSpyPlotUniReader()
   delete [] this->DumpTime;
   delete [] this->DumpDT;
   delete [] this->DumpOffset;
+  delete this->DecodedArrays;
 
   int dump;
   for ( dump = 0; dump < this->NumberOfDataDumps; ++ dump )
@@ -287,6 +362,13 @@ int vtkSpyPlotUniReader::MakeCurrent()
 
   this->NeedToCheck = 0;
 
+  // The type of the volume fraction arrays changed, the cached arrays
+  // cannot be used anymore.
+  if ( this->DataTypeChanged )
+    {
+    this->DecodedArrays->Clear();
+    }
+
   for ( dump = 0; dump < this->NumberOfDataDumps; ++ dump )
     {
     if ( dump != this->CurrentTimeStep )
@@ -298,20 +380,15 @@ int vtkSpyPlotUniReader::MakeCurrent()
         vtkSpyPlotUniReader::Variable *cv = dp->Variables + var;
         if ( cv->DataBlocks )
           {
-          int ca;
-          for ( ca = 0; ca < dp->ActualNumberOfBlocks; ++ ca )
+          vtkDebugMacro( "* Cache Data blocks for variable: " << cv->Name );
+          if ( this->DataTypeChanged && this->IsVolumeFraction(cv) )
             {
-            if ( cv->DataBlocks[ca] )
-              {
-              cv->DataBlocks[ca]->Delete();
-              cv->DataBlocks[ca] = 0;
-              }
+            this->ReleaseDataBlocks(dp, cv);
+            }
+          else
+            {
+            this->CacheDataBlocks(dump, var, cv);
             }
-          vtkDebugMacro( "* Delete Data blocks for variable: " << cv->Name );
-          delete [] cv->DataBlocks;
-          cv->DataBlocks = 0;
-          delete [] cv->GhostCellsFixed;
-          cv->GhostCellsFixed = 0;
           }
         }
       }
@@ -342,18 +419,16 @@ int vtkSpyPlotUniReader::MakeCurrent()
         {
         vtkDebugMacro( " ** Variable " << var->Name 
                        << " was unselected, so remove" );
-        int dataBlock;
-        for ( dataBlock = 0; 
-              dataBlock < dp->ActualNumberOfBlocks; ++ dataBlock )
+        if ( this->DataTypeChanged && this->IsVolumeFraction(var) )
           {
-          var->DataBlocks[dataBlock]->Delete();
-          var->DataBlocks[dataBlock] = 0;
+          this->ReleaseDataBlocks(dp, var);
+          vtkDebugMacro( "* Delete Data blocks for variable: " << var->Name );
+          }
+        else
+          {
+          this->CacheDataBlocks(dump, fieldCnt, var);
+          vtkDebugMacro( "* Cache Data blocks for variable: " << var->Name );
           }
-        delete [] var->DataBlocks;
-        var->DataBlocks = 0;
-        delete [] var->GhostCellsFixed;
-        var->GhostCellsFixed = 0;
-        vtkDebugMacro( "* Delete Data blocks for variable: " << var->Name );
         }
       vtkDebugMacro( " *** Ignore variable: " << var->Name );
       if ( !this->CellArraySelection->ArrayIsEnabled(var->Name) )
@@ -362,6 +437,14 @@ int vtkSpyPlotUniReader::MakeCurrent()
         }
       }
 
+    if ( this->CellArraySelection->ArrayIsEnabled(var->Name) &&
+         !var->DataBlocks && this->RestoreDataBlocks(dump, fieldCnt, var) )
+      {
+      vtkDebugMacro( << var << " Reuse cached blocks of variable: "
+                     << var->Name << " / " << this->FileName );
+      continue;
+      }
+
     if ( (needMarkers || this->CellArraySelection->ArrayIsEnabled(var->Name)) && 
          !var->DataBlocks )
       {
@@ -387,88 +470,9 @@ int vtkSpyPlotUniReader::MakeCurrent()
     // << " [" << var->Name << "]" );
     //vtkDebugMacro( "    Jump to: " << dp->SavedVariableOffsets[fieldCnt] );
     spis.Seek(dp->SavedVariableOffsets[fieldCnt]);
-    int numBytes;
-    int block;
-    int actualBlockId = 0;
-    for ( block = 0; block < dp->NumberOfBlocks; ++ block )
+    if ( !this->ReadCellFieldBlocks(&spis, dp, var) )
       {
-      vtkSpyPlotBlock* bk = this->Blocks+block;
-      if ( bk->IsAllocated() )
-        {
-        vtkFloatArray* floatArray = 0;
-        vtkUnsignedCharArray* unsignedCharArray = 0;
-        vtkDataArray* dataArray = 0;
-        if ( this->CellArraySelection->ArrayIsEnabled(var->Name) && 
-              !var->DataBlocks[actualBlockId] )
-          {
-          if ( this->DownConvertVolumeFraction && this->IsVolumeFraction(var) )
-            {
-            unsignedCharArray = vtkUnsignedCharArray::New();
-            dataArray = unsignedCharArray;
-            }
-          else
-            {
-            floatArray = vtkFloatArray::New();
-            dataArray = floatArray;
-            }
-          dataArray->SetNumberOfComponents(1);
-          dataArray->SetNumberOfTuples(bk->GetDimension(0) * 
-                                       bk->GetDimension(1) * 
-                                       bk->GetDimension(2));
-          dataArray->SetName(var->Name);
-          //vtkDebugMacro( "*** Create data array: " 
-          // << dataArray->GetNumberOfTuples() );
-          }
-        int zax;
-        int bdims[3];
-        bk->GetDimensions(bdims);
-        for ( zax = 0; zax < bdims[2]; ++ zax )
-          { 
-          int planeSize = bdims[0] * bdims[1];
-          if ( !spis.ReadInt32s(&numBytes, 1) )
-            {
-            vtkErrorMacro( "Problem reading the number of bytes" );
-            return 0;
-            }
-          if ( static_cast<int>(arrayBuffer.size()) < numBytes )
-            {
-            arrayBuffer.resize(numBytes);
-            }
-          if ( !spis.ReadString(&*arrayBuffer.begin(), numBytes) )
-            {
-            vtkErrorMacro( "Problem reading the bytes" );
-            return 0;
-            }
-          if ( floatArray )
-            {
-            float* ptr = floatArray->GetPointer(zax * planeSize);
-            if ( !this->RunLengthDataDecode(&*arrayBuffer.begin(), 
-                                            numBytes, ptr, planeSize) )
-              {
-              vtkErrorMacro( "Problem RLD decoding float data array" );
-              return 0;
-              }
-            }
-          if ( unsignedCharArray )
-            {
-            unsigned char* ptr = unsignedCharArray->GetPointer(zax * planeSize);
-            if ( !this->RunLengthDataDecode(&*arrayBuffer.begin(), numBytes,
-                                            ptr, planeSize) )
-              {
-              vtkErrorMacro( "Problem RLD decoding unsigned char data array" );
-              return 0;
-              }
-            }
-          }
-        if ( dataArray )
-          {
-          var->DataBlocks[actualBlockId] = dataArray;
-          var->GhostCellsFixed[actualBlockId] = 0;
-          vtkDebugMacro( " " << dataArray << " initialized: " 
-                         << dataArray->GetName() );
-          actualBlockId++;
-          }
-        }
+      return 0;
       }
     }
 
@@ -684,11 +688,10 @@ void vtkSpyPlotUniReader::PrintInformation()
 
 
 //-----------------------------------------------------------------------------
+// Returns 0 if the decoded data does not fit in outSize values.
 template<class t>
-int vtkSpyPlotUniReaderRunLengthDataDecode(vtkSpyPlotUniReader* self, 
-                                           const unsigned char* in, 
-                                           int inSize, t* out, 
-                                           int outSize, t scale=1)
+int vtkSpyPlotRunLengthDecode(const unsigned char* in, int inSize,
+                              t* out, int outSize, t scale=1)
 {
   int outIndex = 0, inIndex = 0;
 
@@ -702,38 +705,30 @@ int vtkSpyPlotUniReaderRunLengthDataDecode(vtkSpyPlotUniReader* self,
     ptmp ++;
     if (runLength < 128)
       {
+      if ( outIndex + runLength > outSize )
+        {
+        return 0;
+        }
       float val;
       memcpy(&val, ptmp, sizeof(float));
       vtkByteSwap::SwapBE(&val);
       ptmp += 4;
       // Now populate the out data
-      int k;
-      for (k=0; k<runLength; ++k)
-        {
-        if ( outIndex >= outSize )
-          {
-          vtkErrorWithObjectMacro(self, "Problem doing RLD decode. "
-                                  << "Too much data generated. Excpected: " 
-                                  << outSize );
-          return 0;
-          }
-        out[outIndex] = static_cast<t>(val*scale);
-        outIndex++;
-        }
+      std::fill(out + outIndex, out + outIndex + runLength,
+                static_cast<t>(val*scale));
+      outIndex += runLength;
       inIndex += 5;
       }
     else  // runLength >= 128
       {
+      int numValues = runLength - 128;
+      if ( outIndex + numValues > outSize )
+        {
+        return 0;
+        }
       int k;
-      for (k=0; k<runLength-128; ++k)
+      for (k=0; k<numValues; ++k)
         {
-        if ( outIndex >= outSize )
-          {
-          vtkErrorWithObjectMacro(self, "Problem doing RLD decode. "
-                                  << "Too much data generated. Excpected: " 
-                                  << outSize );
-          return 0;
-          }
         float val;
         memcpy(&val, ptmp, sizeof(float));
         vtkByteSwap::SwapBE(&val);
@@ -741,13 +736,84 @@ int vtkSpyPlotUniReaderRunLengthDataDecode(vtkSpyPlotUniReader* self,
         outIndex++;
         ptmp += 4;
         }
-      inIndex += 4*(runLength-128)+1;
+      inIndex += 4*numValues+1;
       }
     } // while
 
   return 1;
 }
 
+//-----------------------------------------------------------------------------
+template<class t>
+int vtkSpyPlotUniReaderRunLengthDataDecode(vtkSpyPlotUniReader* self, 
+                                           const unsigned char* in, 
+                                           int inSize, t* out, 
+                                           int outSize, t scale=1)
+{
+  if ( !vtkSpyPlotRunLengthDecode(in, inSize, out, outSize, scale) )
+    {
+    vtkErrorWithObjectMacro(self, "Problem doing RLD decode. "
+                            << "Too much data generated. Excpected: " 
+                            << outSize );
+    return 0;
+    }
+  return 1;
+}
+
+//-----------------------------------------------------------------------------
+namespace
+{
+  // A compressed plane of a cell array and where to decode it.
+  struct vtkSpyPlotRLDPlane
+    {
+    size_t Offset;
+    int Size;
+    float* FloatOut;
+    unsigned char* UnsignedCharOut;
+    int OutSize;
+    };
+
+  struct vtkSpyPlotRLDWork
+    {
+    std::vector<unsigned char> Buffer;
+    std::vector<vtkSpyPlotRLDPlane> Planes;
+    std::vector<int> Status;
+    };
+
+  void vtkSpyPlotDecodePlane(vtkSpyPlotRLDWork* work, size_t index)
+    {
+    const vtkSpyPlotRLDPlane& plane = work->Planes[index];
+    const unsigned char* in = plane.Size > 0?
+      &work->Buffer[plane.Offset] : NULL;
+    if ( plane.FloatOut )
+      {
+      work->Status[index] = vtkSpyPlotRunLengthDecode(in, plane.Size,
+        plane.FloatOut, plane.OutSize);
+      }
+    else
+      {
+      work->Status[index] = vtkSpyPlotRunLengthDecode(in, plane.Size,
+        plane.UnsignedCharOut, plane.OutSize,
+        static_cast<unsigned char>(255));
+      }
+    }
+
+  VTK_THREAD_RETURN_TYPE vtkSpyPlotDecodeThread(void* arg)
+    {
+    vtkMultiThreader::ThreadInfo* threadInfo =
+      static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+    vtkSpyPlotRLDWork* work =
+      static_cast<vtkSpyPlotRLDWork*>(threadInfo->UserData);
+    size_t count = work->Planes.size();
+    for (size_t cc = threadInfo->ThreadID; cc < count;
+      cc += threadInfo->NumberOfThreads)
+      {
+      vtkSpyPlotDecodePlane(work, cc);
+      }
+    return VTK_THREAD_RETURN_VALUE;
+    }
+}
+
 //-----------------------------------------------------------------------------
 int vtkSpyPlotUniReader::RunLengthDataDecode(const unsigned char* in, 
                                              int inSize, float* out, 
@@ -776,6 +842,204 @@ int vtkSpyPlotUniReader::RunLengthDataDecode(const unsigned char* in,
                                                   static_cast<unsigned char>(255));
 }
 
+//-----------------------------------------------------------------------------
+int vtkSpyPlotUniReader::ReadCellFieldBlocks(vtkSpyPlotIStream *spis,
+                                             DataDump* dp, Variable* var)
+{
+  // Read the compressed planes of all the blocks first, so that the file is
+  // still read sequentially, and then decode them in parallel.
+  vtkSpyPlotRLDWork work;
+  vtkIdType numValues = 0;
+  int numBytes;
+  int block;
+  int actualBlockId = 0;
+  for ( block = 0; block < dp->NumberOfBlocks; ++ block )
+    {
+    vtkSpyPlotBlock* bk = this->Blocks+block;
+    if ( bk->IsAllocated() )
+      {
+      vtkFloatArray* floatArray = 0;
+      vtkUnsignedCharArray* unsignedCharArray = 0;
+      vtkDataArray* dataArray = 0;
+      if ( this->CellArraySelection->ArrayIsEnabled(var->Name) && 
+            !var->DataBlocks[actualBlockId] )
+        {
+        if ( this->DownConvertVolumeFraction && this->IsVolumeFraction(var) )
+          {
+          unsignedCharArray = vtkUnsignedCharArray::New();
+          dataArray = unsignedCharArray;
+          }
+        else
+          {
+          floatArray = vtkFloatArray::New();
+          dataArray = floatArray;
+          }
+        dataArray->SetNumberOfComponents(1);
+        dataArray->SetNumberOfTuples(bk->GetDimension(0) * 
+                                     bk->GetDimension(1) * 
+                                     bk->GetDimension(2));
+        dataArray->SetName(var->Name);
+        //vtkDebugMacro( "*** Create data array: " 
+        // << dataArray->GetNumberOfTuples() );
+        }
+      int zax;
+      int bdims[3];
+      bk->GetDimensions(bdims);
+      for ( zax = 0; zax < bdims[2]; ++ zax )
+        { 
+        int planeSize = bdims[0] * bdims[1];
+        if ( !spis->ReadInt32s(&numBytes, 1) )
+          {
+          vtkErrorMacro( "Problem reading the number of bytes" );
+          return 0;
+          }
+        size_t offset = work.Buffer.size();
+        if ( numBytes > 0 )
+          {
+          work.Buffer.resize(offset + numBytes);
+          if ( !spis->ReadString(&work.Buffer[offset], numBytes) )
+            {
+            vtkErrorMacro( "Problem reading the bytes" );
+            return 0;
+            }
+          }
+        if ( dataArray )
+          {
+          vtkSpyPlotRLDPlane plane;
+          plane.Offset = offset;
+          plane.Size = numBytes;
+          plane.FloatOut = floatArray?
+            floatArray->GetPointer(zax * planeSize) : NULL;
+          plane.UnsignedCharOut = unsignedCharArray?
+            unsignedCharArray->GetPointer(zax * planeSize) : NULL;
+          plane.OutSize = planeSize;
+          work.Planes.push_back(plane);
+          numValues += planeSize;
+          }
+        }
+      if ( dataArray )
+        {
+        var->DataBlocks[actualBlockId] = dataArray;
+        var->GhostCellsFixed[actualBlockId] = 0;
+        vtkDebugMacro( " " << dataArray << " initialized: " 
+                       << dataArray->GetName() );
+        actualBlockId++;
+        }
+      }
+    }
+
+  work.Status.resize(work.Planes.size(), 1);
+  int numberOfThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  int maxThreads = static_cast<int>(work.Planes.size());
+  numberOfThreads = numberOfThreads < maxThreads? numberOfThreads : maxThreads;
+  // Starting threads is not worth it for small arrays.
+  if ( numberOfThreads > 1 && numValues >= 65536 )
+    {
+    vtkNew<vtkMultiThreader> threader;
+    threader->SetNumberOfThreads(numberOfThreads);
+    threader->SetSingleMethod(vtkSpyPlotDecodeThread, &work);
+    threader->SingleMethodExecute();
+    }
+  else
+    {
+    for (size_t cc=0; cc < work.Planes.size(); cc++)
+      {
+      vtkSpyPlotDecodePlane(&work, cc);
+      }
+    }
+
+  if ( std::find(work.Status.begin(), work.Status.end(), 0) !=
+       work.Status.end() )
+    {
+    vtkErrorMacro( "Problem RLD decoding data array " << var->Name
+                   << ". Too much data generated." );
+    return 0;
+    }
+  return 1;
+}
+
+//-----------------------------------------------------------------------------
+void vtkSpyPlotUniReader::ReleaseDataBlocks(DataDump* dp, Variable* var)
+{
+  int ca;
+  for ( ca = 0; ca < dp->ActualNumberOfBlocks; ++ ca )
+    {
+    if ( var->DataBlocks[ca] )
+      {
+      var->DataBlocks[ca]->Delete();
+      var->DataBlocks[ca] = 0;
+      }
+    }
+  delete [] var->DataBlocks;
+  var->DataBlocks = 0;
+  delete [] var->GhostCellsFixed;
+  var->GhostCellsFixed = 0;
+}
+
+//-----------------------------------------------------------------------------
+void vtkSpyPlotUniReader::CacheDataBlocks(int dump, int field, Variable* var)
+{
+  vtkSpyPlotUniReader::DataDump* dp = this->DataDumps+dump;
+  unsigned long size = 0;
+  int ca;
+  for ( ca = 0; ca < dp->ActualNumberOfBlocks; ++ ca )
+    {
+    // Only cache variables that were read entirely.
+    if ( !var->DataBlocks[ca] )
+      {
+      this->ReleaseDataBlocks(dp, var);
+      return;
+      }
+    size += var->DataBlocks[ca]->GetActualMemorySize();
+    }
+  if ( size > this->DecodedArrayCacheSize )
+    {
+    this->ReleaseDataBlocks(dp, var);
+    return;
+    }
+
+  vtkDecodedArrayCache::Entry entry;
+  entry.Dump = dump;
+  entry.Field = field;
+  entry.NumberOfBlocks = dp->ActualNumberOfBlocks;
+  entry.DataBlocks = var->DataBlocks;
+  entry.GhostCellsFixed = var->GhostCellsFixed;
+  entry.Size = size;
+  this->DecodedArrays->Entries.push_front(entry);
+  this->DecodedArrays->Size += size;
+  var->DataBlocks = 0;
+  var->GhostCellsFixed = 0;
+  this->DecodedArrays->Shrink(this->DecodedArrayCacheSize);
+}
+
+//-----------------------------------------------------------------------------
+int vtkSpyPlotUniReader::RestoreDataBlocks(int dump, int field, Variable* var)
+{
+  vtkDecodedArrayCache::ListOfEntries::iterator iter =
+    this->DecodedArrays->Find(dump, field);
+  if ( iter == this->DecodedArrays->Entries.end() )
+    {
+    return 0;
+    }
+  var->DataBlocks = iter->DataBlocks;
+  var->GhostCellsFixed = iter->GhostCellsFixed;
+  this->DecodedArrays->Size -= iter->Size;
+  this->DecodedArrays->Entries.erase(iter);
+  return 1;
+}
+
+//-----------------------------------------------------------------------------
+void vtkSpyPlotUniReader::SetDecodedArrayCacheSize(unsigned long size)
+{
+  if ( this->DecodedArrayCacheSize == size )
+    {
+    return;
+    }
+  this->DecodedArrayCacheSize = size;
+  this->DecodedArrays->Shrink(size);
+  this->Modified();
+}
+
 //-----------------------------------------------------------------------------
 int vtkSpyPlotUniReader::SetCurrentTime(double time)
 {
@@ -918,6 +1182,37 @@ vtkSpyPlotBlock* vtkSpyPlotUniReader::GetBlock(int block)
   return 0;
 }
 
+//-----------------------------------------------------------------------------
+int vtkSpyPlotUniReader::ReadBlockDimensions(int* dims)
+{
+  if ( !this->HaveInformation && !this->ReadInformation() )
+    {
+    return 0;
+    }
+
+  ifstream ifs(this->FileName, ios::binary|ios::in);
+  vtkSpyPlotIStream spis;
+  spis.SetStream(&ifs);
+  vtkSpyPlotUniReader::DataDump* dp = this->DataDumps+this->CurrentTimeStep;
+  spis.Seek(dp->BlocksOffset);
+  vtkSpyPlotBlock block;
+  int cb = 0;
+  for ( int blockId = 0; blockId < dp->NumberOfBlocks; ++ blockId )
+    {
+    if ( !block.Read(this->IsAMR(), this->FileVersion, &spis) )
+      {
+      vtkErrorMacro( "Problem reading the block information" );
+      return 0;
+      }
+    if ( block.IsAllocated() && cb < dp->ActualNumberOfBlocks )
+      {
+      block.GetDimensions(dims + 3*cb);
+      cb ++;
+      }
+    }
+  return 1;
+}
+
 //-----------------------------------------------------------------------------
 vtkSpyPlotUniReader::Variable* vtkSpyPlotUniReader::GetCellField(int field)
 {
@@ -1390,6 +1685,8 @@ void vtkSpyPlotUniReader::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "DataTypeChanged: " << this->DataTypeChanged << endl;
   os << indent << "NumberOfCellFields: " << this->NumberOfCellFields << endl;
   os << indent << "NeedToCheck: " << this->NeedToCheck << endl;
+  os << indent << "DecodedArrayCacheSize: " << this->DecodedArrayCacheSize
+     << endl;
 }
 
 
@@ -136,6 +136,13 @@ public:
   // Return the ith block (i.e. grid) in the reader
   vtkSpyPlotBlock *GetBlock(int i);
 
+  // Description:
+  // Reads the dimensions of the blocks of the current time step from their
+  // headers only, without reading their geometry or the cell fields as
+  // MakeCurrent() does. dims must hold 3*GetNumberOfDataBlocks() values, in
+  // the order of GetBlock(). Returns 0 on failure.
+  int ReadBlockDimensions(int* dims);
+
   // Returns the number of materials
   int GetNumberOfMaterials( ) const { return NumberOfMaterials; }
 
@@ -210,6 +217,15 @@ public:
   vtkSetMacro(DataTypeChanged, int);
   void SetDownConvertVolumeFraction(int vf);
 
+  // Description:
+  // Set/Get the maximum size, in kibibytes, of the decoded cell arrays kept
+  // once they are no longer needed (the array was unselected or another time
+  // step was read), so that they don't have to be read and decoded again
+  // when they are needed anew. The least recently cached arrays are released
+  // first. 0 disables the cache. Default is 64 MiB.
+  void SetDecodedArrayCacheSize(unsigned long size);
+  vtkGetMacro(DecodedArrayCacheSize, unsigned long);
+
 protected:
   vtkSpyPlotUniReader();
   ~vtkSpyPlotUniReader();
@@ -233,6 +249,18 @@ private:
 
   vtkDataArray* GetMaterialField(const int& block, const int& materialIndex, const char* Id);
 
+  // Read the data blocks of the given variable from the stream positioned
+  // at the start of the variable. The blocks are read sequentially and
+  // decoded in parallel.
+  int ReadCellFieldBlocks(vtkSpyPlotIStream *spis, DataDump* dp,
+                          Variable* var);
+
+  // Move the data blocks of the variable to the decoded array cache, or
+  // back from the cache. RestoreDataBlocks() returns 0 on a cache miss.
+  void CacheDataBlocks(int dump, int field, Variable* var);
+  int RestoreDataBlocks(int dump, int field, Variable* var);
+  void ReleaseDataBlocks(DataDump* dp, Variable* var);
+
   // Header information
   char FileDescription[128];
   int FileVersion;
@@ -294,6 +322,10 @@ private:
   
   vtkDataArraySelection* CellArraySelection;
 
+  unsigned long DecodedArrayCacheSize;
+  class vtkDecodedArrayCache;
+  vtkDecodedArrayCache* DecodedArrays;
+
   Variable* GetCellField(int field);
   int IsVolumeFraction(Variable* var);
 
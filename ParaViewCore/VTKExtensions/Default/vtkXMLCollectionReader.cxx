@@ -16,11 +16,15 @@
 
 #include "vtkCallbackCommand.h"
 #include "vtkCharArray.h"
+#include "vtkDataArray.h"
 #include "vtkDataSet.h"
 #include "vtkFieldData.h"
+#include "vtkPVCompositeDataPipeline.h"
 #include "vtkPVInstantiator.h"
 #include "vtkMultiBlockDataSet.h"
 #include "vtkObjectFactory.h"
+#include "vtkSelection.h"
+#include "vtkSelectionNode.h"
 #include "vtkSmartPointer.h"
 #include "vtkXMLDataElement.h"
 #include "vtkInformation.h"
@@ -30,10 +34,57 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <set>
 #include <algorithm>
 
 vtkStandardNewMacro(vtkXMLCollectionReader);
 
+//----------------------------------------------------------------------------
+// Collects the composite indices selected by the selection of interest.
+// Returns false if the selection is not limited to some blocks, in which
+// case all the blocks are read.
+static bool vtkXMLCollectionReaderGetSelectedBlocks(vtkSelection* selection,
+  std::set<unsigned int>& indices)
+{
+  if (!selection || selection->GetNumberOfNodes() == 0)
+    {
+    return false;
+    }
+  for (unsigned int cc=0; cc < selection->GetNumberOfNodes(); cc++)
+    {
+    vtkSelectionNode* node = selection->GetNode(cc);
+    vtkInformation* properties = node->GetProperties();
+    if (properties->Has(vtkSelectionNode::INVERSE()) &&
+      properties->Get(vtkSelectionNode::INVERSE()) != 0)
+      {
+      return false;
+      }
+    if (node->GetContentType() == vtkSelectionNode::BLOCKS)
+      {
+      vtkDataArray* blocks =
+        vtkDataArray::SafeDownCast(node->GetSelectionList());
+      if (!blocks)
+        {
+        return false;
+        }
+      for (vtkIdType kk=0; kk < blocks->GetNumberOfTuples(); kk++)
+        {
+        indices.insert(static_cast<unsigned int>(blocks->GetTuple1(kk)));
+        }
+      }
+    else if (properties->Has(vtkSelectionNode::COMPOSITE_INDEX()))
+      {
+      indices.insert(static_cast<unsigned int>(
+          properties->Get(vtkSelectionNode::COMPOSITE_INDEX())));
+      }
+    else
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
 //----------------------------------------------------------------------------
 
 struct vtkXMLCollectionReaderEntry
@@ -511,6 +562,8 @@ void vtkXMLCollectionReader::ReadXMLDataImpl()
                     "unless the output is forced to be multi-block");
       return;
       }
+    output->GetInformation()->Remove(
+      vtkPVCompositeDataPipeline::SELECTION_OF_INTEREST());
     this->CurrentOutput = 0;
     this->ReadAFile(0,
                     updatePiece,
@@ -521,10 +574,30 @@ void vtkXMLCollectionReader::ReadXMLDataImpl()
   else
     {
     vtkMultiBlockDataSet* output = vtkMultiBlockDataSet::GetData(outInfo);
-  
+
+    // When the selection of interest only covers some blocks, the files of
+    // the other blocks are not read.
+    vtkSelection* selection = vtkSelection::SafeDownCast(
+      outInfo->Get(vtkPVCompositeDataPipeline::SELECTION_OF_INTEREST()));
+    std::set<unsigned int> selectedIndices;
+    bool restricted = vtkXMLCollectionReaderGetSelectedBlocks(selection,
+      selectedIndices) && selectedIndices.count(0) == 0;
+    if (restricted)
+      {
+      output->GetInformation()->Set(
+        vtkPVCompositeDataPipeline::SELECTION_OF_INTEREST(), selection);
+      }
+    else
+      {
+      output->GetInformation()->Remove(
+        vtkPVCompositeDataPipeline::SELECTION_OF_INTEREST());
+      }
+
     unsigned int nBlocks = static_cast<unsigned int>(
       this->Internal->Readers.size());
     output->SetNumberOfBlocks(nBlocks);
+    // composite index of the current block; its pieces follow it.
+    unsigned int blockIndex = 1;
     for(unsigned int i=0; i < nBlocks; ++i)
       {
       vtkMultiBlockDataSet* block = vtkMultiBlockDataSet::SafeDownCast(
@@ -536,6 +609,22 @@ void vtkXMLCollectionReader::ReadXMLDataImpl()
         block->Delete();
         }
 
+      bool selected = !restricted;
+      std::set<unsigned int>::iterator iter =
+        selectedIndices.lower_bound(blockIndex);
+      if (iter != selectedIndices.end() &&
+        *iter <= blockIndex + static_cast<unsigned int>(updateNumPieces))
+        {
+        selected = true;
+        }
+      blockIndex += 1 + static_cast<unsigned int>(updateNumPieces);
+      if (!selected)
+        {
+        block->SetNumberOfBlocks(updateNumPieces);
+        block->SetBlock(updatePiece, NULL);
+        continue;
+        }
+
       this->CurrentOutput = i;
       vtkDataObject* actualOutput = this->SetupOutput(filePath.c_str(), i);
       this->ReadAFile(i, 
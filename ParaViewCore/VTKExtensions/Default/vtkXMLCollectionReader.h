@@ -22,6 +22,12 @@
 // the file matching the restrictions will be read.  Each matching
 // data set becomes an output of this reader in the order in which
 // they appear in the file.
+//
+// When the output is a multi-block dataset and the
+// vtkPVCompositeDataPipeline::SELECTION_OF_INTEREST() requested downstream
+// only selects some blocks (vtkSelectionNode::BLOCKS selections, or
+// selections with a vtkSelectionNode::COMPOSITE_INDEX()), only the files
+// of these blocks are read. The pieces of the other blocks are left empty.
 
 #ifndef __vtkXMLCollectionReader_h
 #define __vtkXMLCollectionReader_h
@@ -0,0 +1,177 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    BenchmarkArrayCalculator.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Evaluates a few functions with vtkPVArrayCalculator on an image of
+// --dimension^3 points, with and without UseCompiledExpression, and reports
+// the time taken by each. Fails if the results are not bit-identical, or if
+// the compiled function was not used. Also checks that ResultNormals and
+// ResultTCoords are honoured by both.
+//
+// Usage:
+//  BenchmarkArrayCalculator [--dimension N]
+
+#include "vtkDataArray.h"
+#include "vtkFloatArray.h"
+#include "vtkImageData.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPVArrayCalculator.h"
+#include "vtkTimerLog.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+  // How the result array is set on the output.
+  enum ResultMode
+    {
+    RESULT_ARRAY,
+    RESULT_NORMALS,
+    RESULT_TCOORDS
+    };
+
+  // Runs the calculator and returns the time it took. result is set to the
+  // values of the result array, taken from the attribute given by mode, and
+  // usedCompiled to whether the compiled function was used.
+  double Evaluate(vtkImageData* image, const char* function, bool compiled,
+    ResultMode mode, std::vector<double>& result, bool& usedCompiled)
+    {
+    vtkNew<vtkPVArrayCalculator> calculator;
+    calculator->SetInputData(image);
+    calculator->SetAttributeModeToUsePointData();
+    calculator->SetResultArrayName("Result");
+    calculator->SetFunction(function);
+    calculator->SetUseCompiledExpression(compiled);
+    calculator->SetResultNormals(mode == RESULT_NORMALS);
+    calculator->SetResultTCoords(mode == RESULT_TCOORDS);
+
+    vtkNew<vtkTimerLog> timer;
+    timer->StartTimer();
+    calculator->Update();
+    timer->StopTimer();
+    usedCompiled = calculator->GetUsedCompiledExpression() != 0;
+
+    result.clear();
+    vtkPointData* pd = calculator->GetOutput()->GetPointData();
+    vtkDataArray* array = pd->GetArray("Result");
+    if ((mode == RESULT_NORMALS && pd->GetNormals() != array) ||
+      (mode == RESULT_TCOORDS && pd->GetTCoords() != array))
+      {
+      array = NULL;
+      }
+    if (array)
+      {
+      int numComps = array->GetNumberOfComponents();
+      result.resize(array->GetNumberOfTuples() * numComps);
+      for (vtkIdType cc=0; cc < array->GetNumberOfTuples(); cc++)
+        {
+        array->GetTuple(cc, &result[cc * numComps]);
+        }
+      }
+    return timer->GetElapsedTime();
+    }
+}
+
+//----------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+  int dimension = 100;
+  for (int cc=1; cc < argc; cc++)
+    {
+    if (strcmp(argv[cc], "--dimension") == 0 && cc+1 < argc)
+      {
+      dimension = atoi(argv[++cc]);
+      }
+    }
+
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(dimension, dimension, dimension);
+  image->SetSpacing(0.1, 0.1, 0.1);
+  vtkIdType numPoints = image->GetNumberOfPoints();
+
+  vtkNew<vtkFloatArray> rho;
+  rho->SetName("rho");
+  rho->SetNumberOfTuples(numPoints);
+  vtkNew<vtkFloatArray> velocity;
+  velocity->SetName("V");
+  velocity->SetNumberOfComponents(3);
+  velocity->SetNumberOfTuples(numPoints);
+  for (vtkIdType cc=0; cc < numPoints; cc++)
+    {
+    double x[3];
+    image->GetPoint(cc, x);
+    rho->SetValue(cc, static_cast<float>(1.0 + x[0] * x[1] + x[2]));
+    velocity->SetTuple3(cc, sin(x[0]), cos(x[1]), x[2] - x[0]);
+    }
+  image->GetPointData()->AddArray(rho.GetPointer());
+  image->GetPointData()->AddArray(velocity.GetPointer());
+
+  const char* functions[] =
+    {
+    "mag(V)*rho",
+    "V*rho+coords",
+    "sqrt(rho)*sin(V_X)+exp(-abs(V_Z))",
+    "norm(V).iHat-ln(rho)/2",
+    "norm(V)",
+    "V*rho",
+    NULL
+    };
+  const ResultMode modes[] =
+    {
+    RESULT_ARRAY,
+    RESULT_ARRAY,
+    RESULT_ARRAY,
+    RESULT_ARRAY,
+    RESULT_NORMALS,
+    RESULT_TCOORDS
+    };
+
+  int return_value = EXIT_SUCCESS;
+  cout << "Points: " << numPoints << endl;
+  for (int cc=0; functions[cc]; cc++)
+    {
+    std::vector<double> parsed;
+    std::vector<double> compiled;
+    bool usedCompiled;
+    double parserTime = Evaluate(image.GetPointer(), functions[cc], false,
+      modes[cc], parsed, usedCompiled);
+    if (usedCompiled)
+      {
+      cerr << "ERROR: compiled function used while disabled for "
+           << functions[cc] << endl;
+      return_value = EXIT_FAILURE;
+      }
+    double compiledTime = Evaluate(image.GetPointer(), functions[cc], true,
+      modes[cc], compiled, usedCompiled);
+    cout << functions[cc] << endl
+         << "  vtkFunctionParser: " << parserTime << " s" << endl
+         << "  Compiled: " << compiledTime << " s" << endl;
+    if (!usedCompiled)
+      {
+      cerr << "ERROR: compiled function not used for " << functions[cc]
+           << endl;
+      return_value = EXIT_FAILURE;
+      }
+    if (parsed.empty() || parsed.size() != compiled.size() ||
+      memcmp(&parsed[0], &compiled[0], parsed.size() * sizeof(double)) != 0)
+      {
+      cerr << "ERROR: results differ for " << functions[cc] << endl;
+      return_value = EXIT_FAILURE;
+      }
+    }
+  return return_value;
+}
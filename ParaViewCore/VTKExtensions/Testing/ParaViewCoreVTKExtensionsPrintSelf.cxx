@@ -20,6 +20,7 @@
 #include "vtkAnimationPlayer.h"
 #include "vtkAppendArcLength.h"
 #include "vtkAppendRectilinearGrid.h"
+#include "vtkArrayQuantizer.h"
 #include "vtkAttributeDataReductionFilter.h"
 #include "vtkAttributeDataToTableFilter.h"
 #include "vtkBlockDeliveryPreprocessor.h"
@@ -161,6 +162,7 @@
 #include "vtkSelectionConverter.h"
 #include "vtkSelectionSerializer.h"
 #include "vtkSequenceAnimationPlayer.h"
+#include "vtkSOADataArray.h"
 #include "vtkSortedTableStreamer.h"
 #include "vtkSpyPlotBlock.h"
 #include "vtkSpyPlotBlockIterator.h"
@@ -224,6 +226,7 @@ int main(int , char *[])
   PRINT_SELF(vtkAnimationPlayer);
   PRINT_SELF(vtkAppendArcLength);
   PRINT_SELF(vtkAppendRectilinearGrid);
+  PRINT_SELF(vtkArrayQuantizer);
   PRINT_SELF(vtkAttributeDataReductionFilter);
   PRINT_SELF(vtkAttributeDataToTableFilter);
   PRINT_SELF(vtkBlockDeliveryPreprocessor);
@@ -364,6 +367,7 @@ int main(int , char *[])
   PRINT_SELF(vtkSelectionConverter);
   PRINT_SELF(vtkSelectionSerializer);
   PRINT_SELF(vtkSequenceAnimationPlayer);
+  PRINT_SELF(vtkSOADataArray);
   PRINT_SELF(vtkSortedTableStreamer);
   //PRINT_SELF(vtkSpyPlotBlock);
   //PRINT_SELF(vtkSpyPlotBlockIterator);
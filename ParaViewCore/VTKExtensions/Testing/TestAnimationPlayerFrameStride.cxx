@@ -0,0 +1,114 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestAnimationPlayerFrameStride.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Tests that players with a FrameStride, as used by the time compartments of
+// pvbatch, tick every frame exactly once between them, and that each of them
+// ends the scene and its cues, including those not owning the last frame.
+
+#include "vtkAnimationCue.h"
+#include "vtkCommand.h"
+#include "vtkNew.h"
+#include "vtkPVAnimationScene.h"
+#include "vtkSequenceAnimationPlayer.h"
+
+#include <cstdlib>
+#include <vector>
+
+#define TEST_ASSERT(condition) \
+  if (!(condition)) \
+    { \
+    cerr << "ERROR: failed at line " << __LINE__ << ": " #condition << endl; \
+    return EXIT_FAILURE; \
+    }
+
+namespace
+{
+  // Records the events of a cue.
+  class CueObserver
+    {
+  public:
+    CueObserver() : Starts(0), Ends(0) {}
+
+    void Start(vtkObject*, unsigned long, void*)
+      {
+      this->Starts++;
+      }
+    void Tick(vtkObject*, unsigned long, void* calldata)
+      {
+      vtkAnimationCue::AnimationCueInfo* info =
+        reinterpret_cast<vtkAnimationCue::AnimationCueInfo*>(calldata);
+      this->Times.push_back(info->AnimationTime);
+      }
+    void End(vtkObject*, unsigned long, void*)
+      {
+      this->Ends++;
+      }
+
+    int Starts;
+    int Ends;
+    std::vector<double> Times;
+    };
+}
+
+//----------------------------------------------------------------------------
+int main(int, char**)
+{
+  const int numberOfFrames = 5;
+  const int stride = 2;
+  std::vector<int> ticks(numberOfFrames, 0);
+  for (int offset=0; offset < stride; offset++)
+    {
+    vtkNew<vtkPVAnimationScene> scene;
+    scene->SetStartTime(0);
+    scene->SetEndTime(1);
+    vtkNew<vtkAnimationCue> cue;
+    cue->SetStartTime(0);
+    cue->SetEndTime(1);
+    scene->AddCue(cue.GetPointer());
+
+    CueObserver observer;
+    cue->AddObserver(vtkCommand::StartAnimationCueEvent,
+      &observer, &CueObserver::Start);
+    cue->AddObserver(vtkCommand::AnimationCueTickEvent,
+      &observer, &CueObserver::Tick);
+    cue->AddObserver(vtkCommand::EndAnimationCueEvent,
+      &observer, &CueObserver::End);
+
+    vtkNew<vtkSequenceAnimationPlayer> player;
+    player->SetAnimationScene(scene.GetPointer());
+    player->SetNumberOfFrames(numberOfFrames);
+    player->SetFrameStride(stride);
+    player->SetFrameOffset(offset);
+    player->Play();
+
+    // the last frame belongs to offset 0: offset 1 ends the cue without
+    // ticking it at the end time.
+    TEST_ASSERT(observer.Starts == 1);
+    TEST_ASSERT(observer.Ends == 1);
+    TEST_ASSERT(static_cast<int>(observer.Times.size()) ==
+      (offset == 0? 3 : 2));
+    for (size_t cc=0; cc < observer.Times.size(); cc++)
+      {
+      int frame = static_cast<int>(
+        observer.Times[cc] * (numberOfFrames - 1) + 0.5);
+      TEST_ASSERT(frame % stride == offset);
+      ticks[frame]++;
+      }
+    }
+  for (int frame=0; frame < numberOfFrames; frame++)
+    {
+    TEST_ASSERT(ticks[frame] == 1);
+    }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,250 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestArrayQuantizer.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Tests that vtkArrayQuantizer stores the selected arrays with fewer bits,
+// that the error bounds it records hold for the decoded values, that NaNs
+// are decoded as NaNs, and that the blocks of composite datasets are
+// quantized separately.
+
+#include "vtkArrayQuantizer.h"
+#include "vtkCellData.h"
+#include "vtkDataArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkFieldData.h"
+#include "vtkFloatArray.h"
+#include "vtkImageData.h"
+#include "vtkMath.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkSmartPointer.h"
+
+#include <cmath>
+#include <cstdlib>
+
+#define TEST_ASSERT(condition) \
+  if (!(condition)) \
+    { \
+    cerr << "ERROR: failed at line " << __LINE__ << ": " #condition << endl; \
+    return EXIT_FAILURE; \
+    }
+
+namespace
+{
+  // Returns an image with the point arrays Pressure and Velocity and the
+  // cell array Density.
+  vtkSmartPointer<vtkImageData> NewImage(double factor)
+    {
+    vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+    image->SetDimensions(20, 20, 20);
+
+    vtkNew<vtkDoubleArray> pressure;
+    pressure->SetName("Pressure");
+    pressure->SetNumberOfTuples(image->GetNumberOfPoints());
+    vtkNew<vtkFloatArray> velocity;
+    velocity->SetName("Velocity");
+    velocity->SetNumberOfComponents(3);
+    velocity->SetNumberOfTuples(image->GetNumberOfPoints());
+    for (vtkIdType cc=0; cc < image->GetNumberOfPoints(); cc++)
+      {
+      double point[3];
+      image->GetPoint(cc, point);
+      pressure->SetValue(cc, factor * (1000 + sin(point[0]) * point[1]));
+      velocity->SetTuple3(cc, point[0] * 0.013, -point[1] * 3.7, 1e-6 * cc);
+      }
+    image->GetPointData()->SetScalars(pressure.GetPointer());
+    image->GetPointData()->AddArray(velocity.GetPointer());
+
+    vtkNew<vtkDoubleArray> density;
+    density->SetName("Density");
+    density->SetNumberOfTuples(image->GetNumberOfCells());
+    for (vtkIdType cc=0; cc < image->GetNumberOfCells(); cc++)
+      {
+      density->SetValue(cc, factor * cos(0.01 * cc));
+      }
+    image->GetCellData()->AddArray(density.GetPointer());
+    return image;
+    }
+
+  // Returns the largest difference between the values of two arrays, or
+  // infinity if they do not have NaNs at the same places.
+  double MaximumError(vtkDataArray* array, vtkDataArray* decoded)
+    {
+    double error = 0;
+    for (vtkIdType cc=0; cc < array->GetNumberOfTuples(); cc++)
+      {
+      for (int comp=0; comp < array->GetNumberOfComponents(); comp++)
+        {
+        double value = array->GetComponent(cc, comp);
+        double decodedValue = decoded->GetComponent(cc, comp);
+        if (vtkMath::IsNan(value) || vtkMath::IsNan(decodedValue))
+          {
+          if (vtkMath::IsNan(value) != vtkMath::IsNan(decodedValue))
+            {
+            return vtkMath::Inf();
+            }
+          continue;
+          }
+        double difference = fabs(value - decodedValue);
+        error = difference > error? difference : error;
+        }
+      }
+    return error;
+    }
+}
+
+//----------------------------------------------------------------------------
+int main(int, char**)
+{
+  const int points = vtkDataObject::FIELD_ASSOCIATION_POINTS;
+  const int cells = vtkDataObject::FIELD_ASSOCIATION_CELLS;
+  vtkSmartPointer<vtkImageData> image = NewImage(1);
+
+  vtkNew<vtkArrayQuantizer> quantizer;
+  quantizer->SetInputData(image);
+  quantizer->SetArrayNumberOfBits("Pressure", 12);
+  quantizer->SetArrayFloat16("Velocity");
+  quantizer->SetArrayErrorBound("Density", 1e-3);
+  quantizer->Update();
+  vtkImageData* quantized = vtkImageData::SafeDownCast(quantizer->GetOutput());
+  TEST_ASSERT(quantized != NULL);
+
+  // The quantized arrays use the smallest type for their bits and remain
+  // the active attributes they were.
+  vtkDataArray* pressure = quantized->GetPointData()->GetArray("Pressure");
+  vtkDataArray* velocity = quantized->GetPointData()->GetArray("Velocity");
+  vtkDataArray* density = quantized->GetCellData()->GetArray("Density");
+  TEST_ASSERT(pressure && pressure->GetDataType() == VTK_UNSIGNED_SHORT);
+  TEST_ASSERT(pressure->GetRange()[1] == 4095);
+  TEST_ASSERT(quantized->GetPointData()->GetScalars() == pressure);
+  TEST_ASSERT(velocity && velocity->GetDataType() == VTK_UNSIGNED_SHORT);
+  TEST_ASSERT(velocity->GetNumberOfComponents() == 3);
+  // the density varies between -1 and 1: 10 bits are needed for 1e-3.
+  TEST_ASSERT(density && density->GetDataType() == VTK_UNSIGNED_SHORT);
+  TEST_ASSERT(density->GetRange()[1] == 1023);
+
+  // The input is not modified.
+  TEST_ASSERT(image->GetPointData()->GetArray("Pressure")->GetDataType() ==
+    VTK_DOUBLE);
+
+  double pressureBound =
+    vtkArrayQuantizer::GetErrorBound(quantized, points, "Pressure");
+  double velocityBound =
+    vtkArrayQuantizer::GetErrorBound(quantized, points, "Velocity");
+  double densityBound =
+    vtkArrayQuantizer::GetErrorBound(quantized, cells, "Density");
+  double range[2];
+  image->GetPointData()->GetArray("Pressure")->GetRange(range);
+  TEST_ASSERT(fabs(pressureBound - 0.5 * (range[1] - range[0]) / 4095) < 1e-12);
+  TEST_ASSERT(velocityBound > 0 && velocityBound < 0.1);
+  TEST_ASSERT(densityBound > 0 && densityBound <= 1e-3);
+  TEST_ASSERT(vtkArrayQuantizer::GetErrorBound(quantized, cells, "Pressure") == -1);
+  TEST_ASSERT(vtkArrayQuantizer::GetErrorBound(quantized, points, "Other") == -1);
+
+  // Decoding gives the values within the error bounds.
+  vtkNew<vtkArrayQuantizer> decoder;
+  decoder->SetInputConnection(quantizer->GetOutputPort());
+  decoder->DecodeOn();
+  decoder->Update();
+  vtkImageData* decoded = vtkImageData::SafeDownCast(decoder->GetOutput());
+  vtkDataArray* decodedPressure = decoded->GetPointData()->GetArray("Pressure");
+  vtkDataArray* decodedVelocity = decoded->GetPointData()->GetArray("Velocity");
+  vtkDataArray* decodedDensity = decoded->GetCellData()->GetArray("Density");
+  TEST_ASSERT(decodedPressure->GetDataType() == VTK_DOUBLE);
+  TEST_ASSERT(decodedVelocity->GetDataType() == VTK_FLOAT);
+  TEST_ASSERT(decoded->GetPointData()->GetScalars() == decodedPressure);
+  TEST_ASSERT(MaximumError(image->GetPointData()->GetArray("Pressure"),
+      decodedPressure) <= pressureBound * (1 + 1e-9));
+  TEST_ASSERT(MaximumError(image->GetPointData()->GetArray("Velocity"),
+      decodedVelocity) <= velocityBound);
+  TEST_ASSERT(MaximumError(image->GetCellData()->GetArray("Density"),
+      decodedDensity) <= densityBound * (1 + 1e-9));
+  TEST_ASSERT(vtkArrayQuantizer::GetErrorBound(decoded, points, "Pressure") ==
+    pressureBound);
+
+  // NaNs get the largest index and the other values the ones below it, also
+  // with 1 bit.
+  vtkSmartPointer<vtkImageData> nanImage = NewImage(1);
+  vtkDataArray* nanPressure = nanImage->GetPointData()->GetArray("Pressure");
+  nanPressure->SetComponent(0, 0, vtkMath::Nan());
+  nanPressure->SetComponent(77, 0, vtkMath::Nan());
+  nanImage->GetCellData()->GetArray("Density")->SetComponent(5, 0,
+    vtkMath::Nan());
+  quantizer->SetInputData(nanImage);
+  quantizer->RemoveAllArrays();
+  quantizer->SetArrayNumberOfBits("Pressure", 8);
+  quantizer->SetArrayErrorBound("Density", 1e-3);
+  quantizer->SetArrayNumberOfBits("Velocity", 1);
+  nanImage->GetPointData()->GetArray("Velocity")->SetComponent(3, 1,
+    vtkMath::Nan());
+  quantizer->Update();
+  quantized = vtkImageData::SafeDownCast(quantizer->GetOutput());
+  pressure = quantized->GetPointData()->GetArray("Pressure");
+  TEST_ASSERT(pressure->GetComponent(0, 0) == 255);
+  TEST_ASSERT(pressure->GetComponent(77, 0) == 255);
+  TEST_ASSERT(pressure->GetComponent(1, 0) < 255);
+  // the density still needs 10 bits, with 1023 values for the numbers.
+  density = quantized->GetCellData()->GetArray("Density");
+  TEST_ASSERT(density->GetComponent(5, 0) == 1023);
+  TEST_ASSERT(quantized->GetPointData()->GetArray("Velocity")->GetRange(1)[1]
+    == 3);
+  decoder->Update();
+  decoded = vtkImageData::SafeDownCast(decoder->GetOutput());
+  TEST_ASSERT(MaximumError(nanPressure,
+      decoded->GetPointData()->GetArray("Pressure")) <=
+    vtkArrayQuantizer::GetErrorBound(quantized, points, "Pressure") *
+    (1 + 1e-9));
+  TEST_ASSERT(MaximumError(nanImage->GetCellData()->GetArray("Density"),
+      decoded->GetCellData()->GetArray("Density")) <=
+    vtkArrayQuantizer::GetErrorBound(quantized, cells, "Density") *
+    (1 + 1e-9));
+  TEST_ASSERT(vtkArrayQuantizer::GetErrorBound(quantized, cells, "Density") <=
+    1e-3);
+  TEST_ASSERT(MaximumError(nanImage->GetPointData()->GetArray("Velocity"),
+      decoded->GetPointData()->GetArray("Velocity")) <=
+    vtkArrayQuantizer::GetErrorBound(quantized, points, "Velocity") *
+    (1 + 1e-9));
+
+  // Each block has its own range.
+  vtkSmartPointer<vtkImageData> image2 = NewImage(10);
+  vtkNew<vtkMultiBlockDataSet> multiBlock;
+  multiBlock->SetNumberOfBlocks(2);
+  multiBlock->SetBlock(0, image);
+  multiBlock->SetBlock(1, image2);
+  quantizer->SetInputData(multiBlock.GetPointer());
+  quantizer->RemoveAllArrays();
+  quantizer->SetArrayNumberOfBits("Pressure", 8);
+  decoder->Update();
+  vtkMultiBlockDataSet* decodedBlocks =
+    vtkMultiBlockDataSet::SafeDownCast(decoder->GetOutputDataObject(0));
+  TEST_ASSERT(decodedBlocks && decodedBlocks->GetNumberOfBlocks() == 2);
+  for (unsigned int block=0; block < 2; block++)
+    {
+    vtkDataSet* input = vtkDataSet::SafeDownCast(multiBlock->GetBlock(block));
+    vtkDataSet* output =
+      vtkDataSet::SafeDownCast(decodedBlocks->GetBlock(block));
+    TEST_ASSERT(output != NULL);
+    input->GetPointData()->GetArray("Pressure")->GetRange(range);
+    double bound =
+      vtkArrayQuantizer::GetErrorBound(output, points, "Pressure");
+    TEST_ASSERT(fabs(bound - 0.5 * (range[1] - range[0]) / 255) < 1e-9);
+    TEST_ASSERT(MaximumError(input->GetPointData()->GetArray("Pressure"),
+        output->GetPointData()->GetArray("Pressure")) <= bound * (1 + 1e-9));
+    // the arrays that are not quantized are passed.
+    TEST_ASSERT(output->GetPointData()->GetArray("Velocity") ==
+      input->GetPointData()->GetArray("Velocity"));
+    TEST_ASSERT(vtkArrayQuantizer::GetErrorBound(output, points, "Velocity") == -1);
+    }
+  return EXIT_SUCCESS;
+}
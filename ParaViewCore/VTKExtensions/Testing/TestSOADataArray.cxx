@@ -0,0 +1,153 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestSOADataArray.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Tests that vtkSOADataArray reads the component arrays without copying
+// them, that it behaves as a vtkDoubleArray once copied, and that
+// vtkPVArrayCalculator gives the same results for it as for a vtkDoubleArray.
+
+#include "vtkDataArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkImageData.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPVArrayCalculator.h"
+#include "vtkSmartPointer.h"
+#include "vtkSOADataArray.h"
+
+#include <cstdlib>
+#include <vector>
+
+#define TEST_ASSERT(condition) \
+  if (!(condition)) \
+    { \
+    cerr << "ERROR: failed at line " << __LINE__ << ": " #condition << endl; \
+    return EXIT_FAILURE; \
+    }
+
+namespace
+{
+  // Returns the values of the "Result" array computed for image.
+  std::vector<double> Calculate(vtkImageData* image, bool compiled)
+    {
+    vtkNew<vtkPVArrayCalculator> calculator;
+    calculator->SetInputData(image);
+    calculator->SetAttributeModeToUsePointData();
+    calculator->SetResultArrayName("Result");
+    calculator->SetFunction("mag(V)*V_Y+V.iHat");
+    calculator->SetUseCompiledExpression(compiled);
+    calculator->Update();
+
+    std::vector<double> result;
+    vtkDataArray* array =
+      calculator->GetOutput()->GetPointData()->GetArray("Result");
+    for (vtkIdType cc=0; array && cc < array->GetNumberOfTuples(); cc++)
+      {
+      result.push_back(array->GetComponent(cc, 0));
+      }
+    return result;
+    }
+}
+
+//----------------------------------------------------------------------------
+int main(int, char**)
+{
+  const int dimension = 20;
+  const vtkIdType numTuples = dimension * dimension * dimension;
+
+  // Three components stored one after the other, as a Fortran array.
+  std::vector<double> values(3 * numTuples);
+  for (vtkIdType cc=0; cc < 3 * numTuples; cc++)
+    {
+    values[cc] = 0.25 * static_cast<double>(cc % 97) - 7.0;
+    }
+
+  vtkNew<vtkSOADataArray> soa;
+  soa->SetName("V");
+  soa->SetNumberOfComponents(3);
+  soa->SetComponentArrays(&values[0], numTuples, numTuples);
+  TEST_ASSERT(soa->IsMapped() == 1);
+  TEST_ASSERT(soa->GetNumberOfTuples() == numTuples);
+  TEST_ASSERT(soa->GetComponentArray(1) == &values[numTuples]);
+  TEST_ASSERT(soa->GetTypedComponent(5, 2) == values[2 * numTuples + 5]);
+  double tuple[3];
+  soa->GetTuple(7, tuple);
+  TEST_ASSERT(tuple[1] == values[numTuples + 7]);
+
+  vtkNew<vtkDoubleArray> aos;
+  aos->SetName("V");
+  aos->SetNumberOfComponents(3);
+  aos->SetNumberOfTuples(numTuples);
+  for (vtkIdType cc=0; cc < numTuples; cc++)
+    {
+    aos->SetTuple3(cc, values[cc], values[numTuples + cc],
+      values[2 * numTuples + cc]);
+    }
+
+  // The calculator must give the same results for both layouts, with or
+  // without the compiled expression, and must not copy the mapped values.
+  vtkNew<vtkImageData> soaImage;
+  soaImage->SetDimensions(dimension, dimension, dimension);
+  soaImage->GetPointData()->AddArray(soa.GetPointer());
+  vtkNew<vtkImageData> aosImage;
+  aosImage->SetDimensions(dimension, dimension, dimension);
+  aosImage->GetPointData()->AddArray(aos.GetPointer());
+  std::vector<double> expected = Calculate(aosImage.GetPointer(), false);
+  TEST_ASSERT(expected.size() == static_cast<size_t>(numTuples));
+  TEST_ASSERT(Calculate(soaImage.GetPointer(), true) == expected);
+  TEST_ASSERT(soa->IsMapped() == 1);
+  TEST_ASSERT(Calculate(soaImage.GetPointer(), false) == expected);
+
+  // GetVoidPointer() copies the values with the components of each tuple
+  // next to each other, after which the array can be modified.
+  double* pointer = static_cast<double*>(soa->GetVoidPointer(0));
+  TEST_ASSERT(soa->IsMapped() == 0);
+  TEST_ASSERT(soa->GetComponentArray(0) == NULL);
+  for (vtkIdType cc=0; cc < 3 * numTuples; cc++)
+    {
+    TEST_ASSERT(pointer[cc] == aos->GetValue(cc));
+    }
+  soa->SetComponent(3, 1, 42.0);
+  TEST_ASSERT(soa->GetTypedComponent(3, 1) == 42.0);
+  TEST_ASSERT(values[numTuples + 3] != 42.0);
+  soa->InsertNextTuple3(1.0, 2.0, 3.0);
+  TEST_ASSERT(soa->GetNumberOfTuples() == numTuples + 1);
+  TEST_ASSERT(soa->GetComponent(numTuples, 2) == 3.0);
+
+  // Setting the component arrays again maps them again.
+  soa->SetComponentArrays(&values[0], numTuples, numTuples);
+  TEST_ASSERT(soa->IsMapped() == 1);
+  TEST_ASSERT(soa->GetNumberOfTuples() == numTuples);
+  TEST_ASSERT(soa->GetComponent(3, 1) == values[numTuples + 3]);
+
+  // Copies own their values, and copying does not copy the values of the
+  // source to its own fallback array.
+  vtkNew<vtkSOADataArray> copy;
+  copy->DeepCopy(soa.GetPointer());
+  TEST_ASSERT(soa->IsMapped() == 1);
+  TEST_ASSERT(copy->IsMapped() == 0);
+  TEST_ASSERT(copy->GetNumberOfComponents() == 3);
+  TEST_ASSERT(copy->GetNumberOfTuples() == numTuples);
+  TEST_ASSERT(copy->GetComponent(11, 2) == values[2 * numTuples + 11]);
+
+  // New instances, as created by filters for their output, behave as a
+  // vtkDoubleArray.
+  vtkSmartPointer<vtkDataArray> instance;
+  instance.TakeReference(soa->NewInstance());
+  instance->SetNumberOfComponents(3);
+  instance->Allocate(30);
+  instance->InsertTuple(2, 5, soa.GetPointer());
+  TEST_ASSERT(instance->GetNumberOfTuples() == 3);
+  TEST_ASSERT(instance->GetComponent(2, 0) == values[5]);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,170 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestXMLCollectionReaderSelectionOfInterest.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Tests that vtkXMLCollectionReader only reads the files of the blocks
+// selected by vtkPVCompositeDataPipeline::SELECTION_OF_INTEREST(). The
+// files of the other blocks are removed before the selected read, and
+// restored before the selection is removed and everything is read again.
+
+#include "vtkInformation.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkPolyData.h"
+#include "vtkPVCompositeDataPipeline.h"
+#include "vtkSelection.h"
+#include "vtkSelectionNode.h"
+#include "vtkSphereSource.h"
+#include "vtkUnsignedIntArray.h"
+#include "vtkXMLCollectionReader.h"
+#include "vtkXMLPolyDataWriter.h"
+
+#include <cstdlib>
+#include <vtksys/ios/fstream>
+#include <vtksys/ios/sstream>
+#include <vtksys/SystemTools.hxx>
+
+#define TEST_ASSERT(condition) \
+  if (!(condition)) \
+    { \
+    cerr << "ERROR: failed at line " << __LINE__ << ": " #condition << endl; \
+    return EXIT_FAILURE; \
+    }
+
+namespace
+{
+  const int NUMBER_OF_BLOCKS = 3;
+  const char* PREFIX = "TestXMLCollectionReaderSelectionOfInterest";
+
+  std::string GetFileName(int block)
+    {
+    vtksys_ios::ostringstream name;
+    name << PREFIX << "_" << block << ".vtp";
+    return name.str();
+    }
+
+  // Sphere with a resolution depending on the block, to tell them apart.
+  int GetNumberOfPoints(int block)
+    {
+    int resolution = 8 + 4 * block;
+    return (resolution - 2) * resolution + 2;
+    }
+
+  bool WriteBlock(int block)
+    {
+    vtkNew<vtkSphereSource> sphere;
+    sphere->SetThetaResolution(8 + 4 * block);
+    sphere->SetPhiResolution(8 + 4 * block);
+    sphere->SetCenter(2 * block, 0, 0);
+    vtkNew<vtkXMLPolyDataWriter> writer;
+    writer->SetInputConnection(sphere->GetOutputPort());
+    writer->SetFileName(GetFileName(block).c_str());
+    return writer->Write() != 0;
+    }
+
+  // Returns the number of points of the piece of the block, or -1 if the
+  // piece was not read.
+  int GetBlockPoints(vtkMultiBlockDataSet* output, int block)
+    {
+    vtkMultiBlockDataSet* pieces = output?
+      vtkMultiBlockDataSet::SafeDownCast(output->GetBlock(block)) : NULL;
+    vtkPolyData* piece = pieces && pieces->GetNumberOfBlocks() == 1?
+      vtkPolyData::SafeDownCast(pieces->GetBlock(0)) : NULL;
+    return piece? static_cast<int>(piece->GetNumberOfPoints()) : -1;
+    }
+}
+
+//----------------------------------------------------------------------------
+int main(int, char**)
+{
+  vtkNew<vtkPVCompositeDataPipeline> prototype;
+  vtkAlgorithm::SetDefaultExecutivePrototype(prototype.GetPointer());
+
+  std::string collection = std::string(PREFIX) + ".pvd";
+  vtksys_ios::ofstream file(collection.c_str());
+  file << "<?xml version=\"1.0\"?>" << endl
+       << "<VTKFile type=\"Collection\" version=\"0.1\">" << endl
+       << "  <Collection>" << endl;
+  for (int block=0; block < NUMBER_OF_BLOCKS; block++)
+    {
+    TEST_ASSERT(WriteBlock(block));
+    file << "    <DataSet part=\"" << block << "\" file=\""
+         << GetFileName(block) << "\"/>" << endl;
+    }
+  file << "  </Collection>" << endl
+       << "</VTKFile>" << endl;
+  file.close();
+
+  // Select the piece of the second block: the composite indices are 0 for
+  // the root, then 1 for the first block and 2 for its piece, 3 and 4 for
+  // the second block, etc.
+  vtkNew<vtkSelection> selection;
+  vtkNew<vtkSelectionNode> node;
+  node->SetContentType(vtkSelectionNode::BLOCKS);
+  vtkNew<vtkUnsignedIntArray> blocks;
+  blocks->InsertNextValue(4);
+  node->SetSelectionList(blocks.GetPointer());
+  selection->AddNode(node.GetPointer());
+
+  // The files of the other blocks cannot be read.
+  vtksys::SystemTools::RemoveFile(GetFileName(0).c_str());
+  vtksys::SystemTools::RemoveFile(GetFileName(2).c_str());
+
+  vtkNew<vtkXMLCollectionReader> reader;
+  reader->SetFileName(collection.c_str());
+  vtkInformation* outInfo = reader->GetOutputInformation(0);
+  outInfo->Set(vtkPVCompositeDataPipeline::SELECTION_OF_INTEREST(),
+    selection.GetPointer());
+  reader->Update();
+  vtkMultiBlockDataSet* output =
+    vtkMultiBlockDataSet::SafeDownCast(reader->GetOutputDataObject(0));
+  TEST_ASSERT(output &&
+    output->GetNumberOfBlocks() == static_cast<unsigned int>(NUMBER_OF_BLOCKS));
+  TEST_ASSERT(GetBlockPoints(output, 0) == -1);
+  TEST_ASSERT(GetBlockPoints(output, 1) == GetNumberOfPoints(1));
+  TEST_ASSERT(GetBlockPoints(output, 2) == -1);
+  TEST_ASSERT(output->GetInformation()->Get(
+      vtkPVCompositeDataPipeline::SELECTION_OF_INTEREST()) ==
+    selection.GetPointer());
+
+  // Selecting the first block itself reads its file.
+  TEST_ASSERT(WriteBlock(0));
+  blocks->SetValue(0, 1);
+  blocks->Modified();
+  node->Modified();
+  reader->Update();
+  output = vtkMultiBlockDataSet::SafeDownCast(reader->GetOutputDataObject(0));
+  TEST_ASSERT(GetBlockPoints(output, 0) == GetNumberOfPoints(0));
+  TEST_ASSERT(GetBlockPoints(output, 1) == -1);
+  TEST_ASSERT(GetBlockPoints(output, 2) == -1);
+
+  // Without the selection, everything is read again.
+  TEST_ASSERT(WriteBlock(2));
+  outInfo->Remove(vtkPVCompositeDataPipeline::SELECTION_OF_INTEREST());
+  reader->Update();
+  output = vtkMultiBlockDataSet::SafeDownCast(reader->GetOutputDataObject(0));
+  for (int block=0; block < NUMBER_OF_BLOCKS; block++)
+    {
+    TEST_ASSERT(GetBlockPoints(output, block) == GetNumberOfPoints(block));
+    }
+  TEST_ASSERT(!output->GetInformation()->Has(
+      vtkPVCompositeDataPipeline::SELECTION_OF_INTEREST()));
+
+  for (int block=0; block < NUMBER_OF_BLOCKS; block++)
+    {
+    vtksys::SystemTools::RemoveFile(GetFileName(block).c_str());
+    }
+  vtksys::SystemTools::RemoveFile(collection.c_str());
+  vtkAlgorithm::SetDefaultExecutivePrototype(NULL);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,182 @@
+/*=========================================================================
+
+   Program: ParaView
+   Module:    BenchmarkServerManagerModel.cxx
+
+   Copyright (c) 2005-2008 Sandia Corporation, Kitware Inc.
+   All rights reserved.
+
+   ParaView is a free software; you can redistribute it and/or modify it
+   under the terms of the ParaView license version 1.2.
+
+   See License_v1.2.txt for the full ParaView license.
+   A copy of this license can be obtained by contacting
+   Kitware Inc.
+   28 Corporate Drive
+   Clifton Park, NY 12065
+   USA
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR
+CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+========================================================================*/
+// Registers a number of source proxies with the proxy manager (without any
+// GUI) and reports the time taken by pqServerManagerModel to create the
+// pqProxy items, to look them up by proxy, by global id and by type, and to
+// remove them.
+//
+// Usage:
+//  BenchmarkServerManagerModel [--proxies N]
+
+#include <QApplication>
+#include <QList>
+#include <QString>
+
+#include "pqApplicationCore.h"
+#include "pqObjectBuilder.h"
+#include "pqPipelineSource.h"
+#include "pqServer.h"
+#include "pqServerManagerModel.h"
+#include "pqServerResource.h"
+#include "vtkSmartPointer.h"
+#include "vtkSMProxy.h"
+#include "vtkSMSessionProxyManager.h"
+#include "vtkTimerLog.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+int main(int argc, char** argv)
+{
+  int numberOfProxies = 2000;
+  for (int cc=1; cc < argc; cc++)
+    {
+    if (strcmp(argv[cc], "--proxies") == 0 && cc+1 < argc)
+      {
+      numberOfProxies = atoi(argv[++cc]);
+      }
+    }
+
+  // No display is needed.
+  QApplication app(argc, argv, false);
+  pqApplicationCore core(argc, argv);
+  pqServer* server = core.getObjectBuilder()->createServer(
+    pqServerResource("builtin:"));
+  if (!server)
+    {
+    cerr << "ERROR: failed to create builtin server." << endl;
+    return EXIT_FAILURE;
+    }
+
+  pqServerManagerModel* smmodel = core.getServerManagerModel();
+  vtkSMSessionProxyManager* pxm = server->proxyManager();
+
+  std::vector<vtkSmartPointer<vtkSMProxy> > proxies;
+  for (int cc=0; cc < numberOfProxies; cc++)
+    {
+    vtkSmartPointer<vtkSMProxy> proxy;
+    proxy.TakeReference(pxm->NewProxy("sources", "SphereSource"));
+    proxies.push_back(proxy);
+    }
+
+  vtkTimerLog* timer = vtkTimerLog::New();
+  timer->StartTimer();
+  for (int cc=0; cc < numberOfProxies; cc++)
+    {
+    pxm->RegisterProxy("sources",
+      QString("Sphere%1").arg(cc).toAscii().data(), proxies[cc]);
+    }
+  timer->StopTimer();
+  double registrationTime = timer->GetElapsedTime();
+
+  int failures = 0;
+  timer->StartTimer();
+  for (int cc=0; cc < numberOfProxies; cc++)
+    {
+    if (smmodel->findItem<pqPipelineSource*>(proxies[cc]) == NULL)
+      {
+      failures++;
+      }
+    }
+  timer->StopTimer();
+  double proxyLookupTime = timer->GetElapsedTime();
+
+  timer->StartTimer();
+  for (int cc=0; cc < numberOfProxies; cc++)
+    {
+    if (smmodel->findItem<pqPipelineSource*>(
+        proxies[cc]->GetGlobalID()) == NULL)
+      {
+      failures++;
+      }
+    }
+  timer->StopTimer();
+  double idLookupTime = timer->GetElapsedTime();
+
+  timer->StartTimer();
+  const int numberOfListings = 100;
+  for (int cc=0; cc < numberOfListings; cc++)
+    {
+    if (smmodel->findItems<pqPipelineSource*>().size() != numberOfProxies ||
+      smmodel->getNumberOfItems<pqPipelineSource*>() != numberOfProxies)
+      {
+      failures++;
+      }
+    }
+  timer->StopTimer();
+  double listingTime = timer->GetElapsedTime();
+
+  // Items must still be returned in the order in which they were added.
+  QList<pqPipelineSource*> sources = smmodel->findItems<pqPipelineSource*>();
+  for (int cc=0; cc < sources.size() && cc < numberOfProxies; cc++)
+    {
+    if (sources[cc]->getProxy() != proxies[cc])
+      {
+      failures++;
+      break;
+      }
+    }
+
+  timer->StartTimer();
+  for (int cc=numberOfProxies-1; cc >= 0; cc--)
+    {
+    pxm->UnRegisterProxy("sources",
+      QString("Sphere%1").arg(cc).toAscii().data(), proxies[cc]);
+    }
+  timer->StopTimer();
+  double unregistrationTime = timer->GetElapsedTime();
+  timer->Delete();
+
+  if (smmodel->getNumberOfItems<pqPipelineSource*>() != 0)
+    {
+    failures++;
+    }
+
+  cout << "Proxies: " << numberOfProxies << endl
+       << "Registration: " << registrationTime << " s" << endl
+       << "Lookup by proxy: " << proxyLookupTime << " s" << endl
+       << "Lookup by global id: " << idLookupTime << " s" << endl
+       << "Listing by type (x" << numberOfListings << "): "
+       << listingTime << " s" << endl
+       << "Unregistration: " << unregistrationTime << " s" << endl;
+
+  proxies.clear();
+  core.getObjectBuilder()->removeServer(server);
+
+  if (failures > 0)
+    {
+    cerr << "ERROR: " << failures << " lookups failed." << endl;
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+}
@@ -53,10 +53,13 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 // Qt Includes.
 #include <QPointer>
+#include <QHash>
 #include <QList>
 #include <QString>
 #include <QStringList>
 #include <QMap>
+#include <QPair>
+#include <QtAlgorithms>
 #include <QtDebug>
 
 //-----------------------------------------------------------------------------
@@ -66,15 +69,68 @@ public:
   typedef QMap<vtkIdType, QPointer<pqServer> > ServerMap;
   ServerMap Servers;
 
-  typedef QMap<vtkSMProxy*, QPointer<pqProxy> > ProxyMap;
+  typedef QHash<vtkSMProxy*, QPointer<pqProxy> > ProxyMap;
   ProxyMap Proxies;
 
+  typedef QHash<vtkTypeUInt32, QPointer<pqProxy> > GlobalIDMap;
+  GlobalIDMap ProxiesByGlobalID;
+
   typedef QMap<vtkSMOutputPort*, QPointer<pqOutputPort> > OutputPortMap;
   OutputPortMap OutputPorts;
 
-  QList<QPointer<pqServerManagerModelItem> > ItemList;
+  // Items are bucketed by their most derived type. Each item is given a
+  // serial number when added, used to return items in the order in which
+  // they were added.
+  typedef QMap<quint64, QPointer<pqServerManagerModelItem> > ItemsMap;
+  typedef QHash<const QMetaObject*, ItemsMap> ItemsByTypeMap;
+  ItemsByTypeMap ItemsByType;
+  QHash<pqServerManagerModelItem*, quint64> ItemSerials;
+  quint64 NextSerial;
 
   pqServerResource ActiveResource;
+
+  pqInternal() : NextSerial(0) { }
+
+  void addItem(pqServerManagerModelItem* item)
+    {
+    quint64 serial = this->NextSerial++;
+    this->ItemSerials[item] = serial;
+    this->ItemsByType[item->metaObject()][serial] = item;
+    }
+
+  void removeItem(pqServerManagerModelItem* item)
+    {
+    QHash<pqServerManagerModelItem*, quint64>::iterator iter =
+      this->ItemSerials.find(item);
+    if (iter == this->ItemSerials.end())
+      {
+      return;
+      }
+    ItemsByTypeMap::iterator bucket =
+      this->ItemsByType.find(item->metaObject());
+    if (bucket != this->ItemsByType.end())
+      {
+      bucket.value().remove(iter.value());
+      if (bucket.value().isEmpty())
+        {
+        this->ItemsByType.erase(bucket);
+        }
+      }
+    this->ItemSerials.erase(iter);
+    }
+
+  // Returns true if items of the given type are instances of mo.
+  static bool inherits(const QMetaObject* type, const QMetaObject& mo)
+    {
+    for (; type != NULL; type = type->superClass())
+      {
+      if (type == &mo)
+        {
+        return true;
+        }
+      }
+    return false;
+    }
 };
 
 //-----------------------------------------------------------------------------
@@ -188,15 +244,14 @@ pqServerManagerModelItem* pqServerManagerModel::findItemHelper(
   const pqServerManagerModel* const model,
   const QMetaObject& mo, vtkTypeUInt32 id)
 {
-  foreach (pqServerManagerModelItem* item, model->Internal->ItemList)
+  pqInternal::GlobalIDMap::const_iterator iter =
+    model->Internal->ProxiesByGlobalID.find(id);
+  if (iter != model->Internal->ProxiesByGlobalID.end())
     {
-    if (item && mo.cast(item))
+    pqProxy* proxy = iter.value();
+    if (proxy && mo.cast(proxy) && proxy->getProxy()->GetGlobalID() == id)
       {
-      pqProxy* proxy = qobject_cast<pqProxy*>(item);
-      if (proxy && proxy->getProxy()->GetGlobalID() == id)
-        {
-        return proxy;
-        }
+      return proxy;
       }
     }
 
@@ -208,21 +263,38 @@ pqServerManagerModelItem* pqServerManagerModel::findItemHelper(
   const pqServerManagerModel* const model, const QMetaObject& mo, 
   const QString& name)
 {
-  foreach (pqServerManagerModelItem* item, model->Internal->ItemList)
+  QList<pqServerManagerModelItem*> items;
+  pqServerManagerModel::findItemsHelper(model, mo,
+    reinterpret_cast<QList<void*>*>(&items));
+  foreach (pqServerManagerModelItem* item, items)
     {
-    if (item && mo.cast(item))
+    pqProxy* proxy = qobject_cast<pqProxy*>(item);
+    if (proxy && proxy->getSMName() == name)
       {
-      pqProxy* proxy = qobject_cast<pqProxy*>(item);
-      if (proxy && proxy->getSMName() == name)
-        {
-        return proxy;
-        }
+      return proxy;
       }
     }
 
   return 0;
 }
 
+//-----------------------------------------------------------------------------
+int pqServerManagerModel::getNumberOfItemsHelper(
+  const pqServerManagerModel* const model, const QMetaObject& mo)
+{
+  int count = 0;
+  pqInternal::ItemsByTypeMap::const_iterator bucket;
+  for (bucket = model->Internal->ItemsByType.constBegin();
+    bucket != model->Internal->ItemsByType.constEnd(); ++bucket)
+    {
+    if (pqInternal::inherits(bucket.key(), mo))
+      {
+      count += bucket.value().size();
+      }
+    }
+  return count;
+}
+
 //-----------------------------------------------------------------------------
 void pqServerManagerModel::findItemsHelper(const pqServerManagerModel *const model, 
   const QMetaObject &mo, QList<void *> *list, pqServer* server/*=0*/)
@@ -232,10 +304,29 @@ void pqServerManagerModel::findItemsHelper(const pqServerManagerModel *const mod
     return;
     }
 
-  foreach (pqServerManagerModelItem* item, model->Internal->ItemList)
+  // Collect the items from all the buckets for types deriving from mo, then
+  // restore the order in which they were added.
+  typedef QPair<quint64, pqServerManagerModelItem*> SerialAndItem;
+  QList<SerialAndItem> items;
+  int numberOfBuckets = 0;
+  pqInternal::ItemsByTypeMap::const_iterator bucket;
+  for (bucket = model->Internal->ItemsByType.constBegin();
+    bucket != model->Internal->ItemsByType.constEnd(); ++bucket)
     {
-    if (item && mo.cast(item))
+    if (!pqInternal::inherits(bucket.key(), mo))
+      {
+      continue;
+      }
+    numberOfBuckets++;
+    pqInternal::ItemsMap::const_iterator iter;
+    for (iter = bucket.value().constBegin();
+      iter != bucket.value().constEnd(); ++iter)
       {
+      pqServerManagerModelItem* item = iter.value();
+      if (!item)
+        {
+        continue;
+        }
       if (server)
         {
         pqProxy* pitem = qobject_cast<pqProxy*>(item);
@@ -244,9 +335,18 @@ void pqServerManagerModel::findItemsHelper(const pqServerManagerModel *const mod
           continue;
           }
         }
-      list->push_back(item);
+      items.push_back(SerialAndItem(iter.key(), item));
       }
     }
+
+  if (numberOfBuckets > 1)
+    {
+    qSort(items);
+    }
+  foreach (const SerialAndItem& item, items)
+    {
+    list->push_back(item.second);
+    }
 }
 
 //-----------------------------------------------------------------------------
@@ -359,7 +459,8 @@ void pqServerManagerModel::onProxyRegistered(const QString& group,
     }
 
   this->Internal->Proxies[proxy] = item;
-  this->Internal->ItemList.push_back(item);
+  this->Internal->ProxiesByGlobalID[proxy->GetGlobalID()] = item;
+  this->Internal->addItem(item);
 
   emit this->itemAdded(item);
   emit this->proxyAdded(item);
@@ -435,8 +536,15 @@ void pqServerManagerModel::onProxyUnRegistered(const QString& group,
   emit this->preItemRemoved(item);
 
   QObject::disconnect(item, 0, this, 0);
-  this->Internal->ItemList.removeAll(item);
+  this->Internal->removeItem(item);
   this->Internal->Proxies.remove(item->getProxy());
+  pqInternal::GlobalIDMap::iterator idIter =
+    this->Internal->ProxiesByGlobalID.find(item->getProxy()->GetGlobalID());
+  if (idIter != this->Internal->ProxiesByGlobalID.end() &&
+    idIter.value() == item)
+    {
+    this->Internal->ProxiesByGlobalID.erase(idIter);
+    }
 
   if (view)
     {
@@ -487,7 +595,7 @@ void pqServerManagerModel::onConnectionCreated(vtkIdType id)
   emit this->preServerAdded(server);
 
   this->Internal->Servers[id] = server;
-  this->Internal->ItemList.push_back(server);
+  this->Internal->addItem(server);
 
   // Lets the world know when the server name changes.
   this->connect(server, SIGNAL(nameChanged(pqServerManagerModelItem*)), 
@@ -513,7 +621,7 @@ void pqServerManagerModel::onConnectionClosed(vtkIdType id)
   emit this->preItemRemoved(server);
 
   this->Internal->Servers.remove(server->GetConnectionID());
-  this->Internal->ItemList.removeAll(server);
+  this->Internal->removeItem(server);
 
   emit this->serverRemoved(server);
   emit this->itemRemoved(server);
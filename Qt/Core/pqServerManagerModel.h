@@ -76,6 +76,9 @@ template <class T> inline T pqGetItemAtIndex(
 /// This class collects that. This is merely representation of all the
 /// information available in the Server Manager in a more GUI friendly 
 /// way. Simplicity is the key here.
+///
+/// Items are indexed by proxy and by global id, and are bucketed by type, so
+/// looking up an item does not depend on the number of items in the model.
 class PQCORE_EXPORT pqServerManagerModel : public QObject
 {
   Q_OBJECT
@@ -184,6 +187,10 @@ public:
   static pqServerManagerModelItem* findItemHelper(const pqServerManagerModel* const model, 
     const QMetaObject& mo, const QString& name);
 
+  /// Internal method.
+  static int getNumberOfItemsHelper(const pqServerManagerModel* const model,
+    const QMetaObject& mo);
+
 signals:
   /// Siganls emitted when a new pqServer object is created.
   void preServerAdded(pqServer*);
@@ -340,7 +347,8 @@ inline T pqFindItem(const pqServerManagerModel* const model,
 template <class T> 
 inline int pqGetNumberOfItems(const pqServerManagerModel* const model)
 {
-  return pqFindItems<T>(model).size();
+  return pqServerManagerModel::getNumberOfItemsHelper(model,
+    ((T)0)->staticMetaObject);
 }
 
 //-----------------------------------------------------------------------------
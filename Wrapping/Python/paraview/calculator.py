@@ -0,0 +1,227 @@
+#==============================================================================
+#
+#  Program:   ParaView
+#  Module:    calculator.py
+#
+#  Copyright (c) Kitware, Inc.
+#  All rights reserved.
+#  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+#
+#     This software is distributed WITHOUT ANY WARRANTY; without even
+#     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+#     PURPOSE.  See the above copyright notice for more information.
+#
+#==============================================================================
+r"""
+This module is used by vtkPythonCalculator.
+
+Expressions are compiled once. The blocks of composite datasets are all
+processed by a single call to execute(): when the expression only combines
+arrays element-wise, the arrays it uses are concatenated over the blocks,
+the expression is evaluated once and each block receives a slice of the
+result, without copying it. Other expressions are evaluated for each block.
+"""
+import ast
+import paraview
+from paraview import vtk
+from paraview.vtk import dataset_adapter
+from numpy import *
+from paraview.vtk.algorithms import *
+
+# Functions of paraview.vtk.algorithms that compute each element of their
+# result from the same elements of their arguments. Others, such as max() or
+# gradient(), depend on the whole array or on the mesh.
+_elementwise_functions = set(['abs', 'cross', 'dot', 'ln', 'log', 'log10',
+    'mag', 'norm', 'trace'])
+
+_compiled_expressions = {}
+
+def _compile(expression):
+    """Returns the code of expression, which is only compiled once."""
+    code = _compiled_expressions.get(expression)
+    if code is None:
+        if len(_compiled_expressions) > 100:
+            _compiled_expressions.clear()
+        code = compile(expression.strip(), '<expression>', 'eval')
+        _compiled_expressions[expression] = code
+    return code
+
+def _is_array_lookup(node):
+    """Returns True if the subscript node is arrays['name']."""
+    index = node.slice
+    if isinstance(index, getattr(ast, 'Index', ())):
+        index = index.value
+    return isinstance(node.value, ast.Name) and node.value.id == 'arrays' \
+        and isinstance(getattr(index, 's', getattr(index, 'value', None)), str)
+
+def _is_elementwise(expression, code, variables):
+    """Returns True if all the names used by code are variables, numpy
+    ufuncs or element-wise functions, and expression has no subscripts
+    other than arrays['name']: a subscript such as Normals[0] selects
+    elements along the first axis, which differ once the arrays of the
+    blocks are concatenated."""
+    namespace = globals()
+    for name in code.co_names:
+        if name in variables or name in _elementwise_functions or \
+            name in ('pi', 'e'):
+            continue
+        if not isinstance(namespace.get(name), ufunc):
+            return False
+    for node in ast.walk(ast.parse(expression.strip(), '<expression>', 'eval')):
+        if isinstance(node, ast.Subscript) and not _is_array_lookup(node):
+            return False
+    return True
+
+def _get_attributes(dataset, association):
+    if association == vtk.vtkDataObject.FIELD_ASSOCIATION_POINTS:
+        return dataset.PointData
+    return dataset.CellData
+
+def _get_number_of_elements(dataset, association):
+    if association == vtk.vtkDataObject.FIELD_ASSOCIATION_POINTS:
+        return dataset.GetNumberOfPoints()
+    return dataset.GetNumberOfCells()
+
+def _get_variables(self, inputs, association):
+    """Returns the variables available to the expression for inputs: the
+    arrays, under their name made valid, the arrays dictionary, the points
+    (if any), inputs and self."""
+    variables = {}
+    arrays = {}
+    attributes = _get_attributes(inputs[0], association)
+    for name in attributes.keys():
+        array = attributes[name]
+        arrays[name] = array
+        validName = paraview.make_name_valid(name)
+        if validName:
+            variables[validName] = array
+    variables['arrays'] = arrays
+    try:
+        variables['points'] = inputs[0].Points
+    except AttributeError:
+        pass
+    variables['inputs'] = inputs
+    variables['self'] = self
+    return variables
+
+def _evaluate(self, code, inputs, association):
+    """Evaluates code for inputs and returns an array with one value per
+    point or cell of the first input."""
+    retVal = eval(code, globals(), _get_variables(self, inputs, association))
+    if not isinstance(retVal, ndarray):
+        retVal = retVal * ones(
+            (_get_number_of_elements(inputs[0], association), 1))
+    return retVal
+
+def _concatenate(self, code, blocks, association):
+    """Returns the variables used by code with the arrays of all the blocks
+    concatenated, or None if the arrays of the blocks do not match."""
+    names = set(code.co_names)
+    allArrays = 'arrays' in names
+    variables = {}
+    arrays = {}
+    first = _get_variables(self, blocks[0][0], association)
+    for name, array in first['arrays'].items():
+        validName = paraview.make_name_valid(name)
+        if not allArrays and validName not in names:
+            continue
+        parts = []
+        for inputs, output in blocks:
+            part = _get_attributes(inputs[0], association)[name]
+            if not isinstance(part, ndarray) or part.shape[1:] != array.shape[1:]:
+                return None
+            parts.append(asarray(part))
+        concatenated = dataset_adapter.VTKArray(concatenate(parts))
+        concatenated.Association = array.Association
+        arrays[name] = concatenated
+        if validName:
+            variables[validName] = concatenated
+    variables['arrays'] = arrays
+    if 'points' in names and 'points' in first:
+        parts = []
+        for inputs, output in blocks:
+            try:
+                parts.append(asarray(inputs[0].Points))
+            except AttributeError:
+                return None
+        variables['points'] = dataset_adapter.VTKArray(concatenate(parts))
+    return variables
+
+def _execute_blocks(self, expression, code, blocks, association, arrayName):
+    """Evaluates expression, compiled as code, for the given list of
+    (inputs, output) blocks of composite datasets."""
+    counts = [_get_number_of_elements(inputs[0], association)
+        for inputs, output in blocks]
+    variables = None
+    if len(blocks) > 1 and _is_elementwise(expression, code,
+        ['arrays', 'points'] +
+        [paraview.make_name_valid(name) for name in
+            _get_attributes(blocks[0][0][0], association).keys()]):
+        variables = _concatenate(self, code, blocks, association)
+    retVal = None
+    if variables is not None:
+        try:
+            retVal = eval(code, globals(), variables)
+        except Exception:
+            # Evaluated again for each block below, to report the error
+            # with the block that causes it.
+            retVal = None
+
+    if retVal is not None and not isinstance(retVal, ndarray):
+        for (inputs, output), count in zip(blocks, counts):
+            _get_attributes(output, association).append(
+                retVal * ones((count, 1)), arrayName)
+    elif retVal is not None and len(retVal.shape) > 0 and \
+        retVal.shape[0] == sum(counts):
+        # Slices share the memory of the result, which the arrays of the
+        # blocks keep alive.
+        offset = 0
+        for (inputs, output), count in zip(blocks, counts):
+            _get_attributes(output, association).append(
+                retVal[offset:offset + count], arrayName)
+            offset += count
+    else:
+        for inputs, output in blocks:
+            _get_attributes(output, association).append(
+                _evaluate(self, code, inputs, association), arrayName)
+
+def execute(address, expression, association, arrayName):
+    """Evaluates expression for the inputs of the vtkPythonCalculator at
+    address, and adds the result to its output as arrayName."""
+    if not expression or not expression.strip():
+        return
+    code = _compile(expression)
+
+    self = vtk.vtkProgrammableFilter(address)
+    inputs = [dataset_adapter.WrapDataObject(self.GetInputDataObject(0, index))
+        for index in range(self.GetNumberOfInputConnections(0))]
+    output = dataset_adapter.WrapDataObject(self.GetOutputDataObject(0))
+
+    if not isinstance(inputs[0], dataset_adapter.CompositeDataSet):
+        _get_attributes(output, association).append(
+            _evaluate(self, code, inputs, association), arrayName)
+        return
+
+    # The blocks of the other inputs are the ones at the same position as
+    # the blocks of the first input.
+    blocks = []
+    iterator = inputs[0].NewIterator()
+    iterator.UnRegister(None)
+    iterator.SkipEmptyNodesOn()
+    iterator.GoToFirstItem()
+    while not iterator.IsDoneWithTraversal():
+        blockInputs = []
+        for input in inputs:
+            if isinstance(input, dataset_adapter.CompositeDataSet):
+                block = input.GetDataSet(iterator)
+            else:
+                block = input.VTKObject
+            if block:
+                blockInputs.append(dataset_adapter.WrapDataObject(block))
+        block = output.GetDataSet(iterator)
+        if len(blockInputs) == len(inputs) and block:
+            blocks.append((blockInputs, dataset_adapter.WrapDataObject(block)))
+        iterator.GoToNextItem()
+    if blocks:
+        _execute_blocks(self, expression, code, blocks, association,
+            arrayName)
@@ -36,9 +36,11 @@ class CoProcessor(object):
         self.__PipelineCreated = False
         self.__ProducersMap = {}
         self.__WritersList = []
+        self.__ExtractWritersList = []
         self.__ViewsList = []
         self.__EnableLiveVisualization = False
         self.__LiveVisualizationLink = None
+        self.__Frequencies = None
         pass
 
     def SetUpdateFrequencies(self, frequencies):
@@ -53,6 +55,11 @@ class CoProcessor(object):
                  "Incorrect argument type: %s, must be a dict" % type(frequencies)
         self.__Frequencies = frequencies
 
+    def GetUpdateFrequencies(self):
+        """Returns the frequencies set using SetUpdateFrequencies(), or None if
+           they were not set."""
+        return self.__Frequencies
+
 
     def EnableLiveVisualization(self, enable):
         """Call this method to enable live-visualization. When enabled,
@@ -118,6 +125,26 @@ class CoProcessor(object):
                     datadescription.GetForceOutput() == True:
                 writer.FileName = writer.cpFileName.replace("%t", str(timestep))
                 writer.UpdatePipeline(datadescription.GetTime())
+        for writer in self.__ExtractWritersList:
+            if (timestep % writer.cpFrequency) == 0 or \
+                    datadescription.GetForceOutput() == True:
+                writer.cpInput.UpdatePipeline(datadescription.GetTime())
+                writer.Write(
+                    writer.cpInput.GetClientSideObject().GetOutputDataObject(0),
+                    timestep)
+
+    def WriteTemporalCache(self, datadescription, writer):
+        """Writes the time steps kept in the temporal cache of the
+           vtkCPProcessor with writer, a writer created with
+           CreateExtractWriter(), e.g. when an event of interest is detected.
+           It must be called on all the ranks. Returns False if there is no
+           cache."""
+        cache = datadescription.GetTemporalCache()
+        if not cache:
+            return False
+        for cc in range(cache.GetNumberOfCachedTimeSteps()):
+            writer.Write(cache.GetCachedGrid(cc), cache.GetCachedTimeStep(cc))
+        return True
 
     def WriteImages(self, datadescription, rescale_lookuptable=False):
         """This method will update all views, if present and write output
@@ -215,6 +242,20 @@ class CoProcessor(object):
         self.__WritersList.append(writer)
         return writer
 
+    def CreateExtractWriter(self, input, filename, freq):
+        """Creates a vtkCPExtractWriter, which writes the output of the input
+           proxy with reduced precision and compression, in the background.
+           The arrays to quantize are set on the returned writer, e.g. with
+           SetArrayErrorBound(). Like the writers created with
+           CreateWriter(), it writes in WriteData() every freq time steps."""
+        import vtkPVCatalystPython
+        writer = vtkPVCatalystPython.vtkCPExtractWriter()
+        writer.SetFileName(filename)
+        writer.cpInput = input
+        writer.cpFrequency = freq
+        self.__ExtractWritersList.append(writer)
+        return writer
+
     def CreateView(self, proxy_ctor, filename, freq, fittoscreen, magnification, width, height):
         """Create a CoProcessing view for image capture with extra meta-data
            such as magnification, size and frequency."""
@@ -53,6 +53,15 @@ def RequestDataDescription(datadescription):
     # pipeline.
     coprocessor.LoadRequestedData(datadescription)
 
+# vtkCPPythonScriptPipeline calls GetUpdateFrequencies() once and then only
+# calls RequestDataDescription() for the timesteps where one of the inputs is
+# needed. Remove it when customizing RequestDataDescription() to request data
+# at other timesteps.
+def GetUpdateFrequencies():
+    "Callback to declare the update frequencies of the inputs"
+    global coprocessor
+    return coprocessor.GetUpdateFrequencies()
+
 # ------------------------ Processing method ------------------------
 
 def DoCoProcessing(datadescription):